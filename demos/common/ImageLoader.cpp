@@ -163,49 +163,6 @@ load_image_to_array(const std::string &pfilename,
   return R;
 }
 
-void
-create_mipmap_level(fastuidraw::ivec2 sz,
-                    fastuidraw::c_array<const fastuidraw::u8vec4> in_data,
-                    std::vector<fastuidraw::u8vec4> &out_data)
-{
-  int w, h;
-
-  w = fastuidraw::t_max(1, sz.x() / 2);
-  h = fastuidraw::t_max(1, sz.y() / 2);
-  out_data.resize(w * h);
-
-  for (int dst_y = 0; dst_y < h; ++dst_y)
-    {
-      int sy0, sy1;
-
-      sy0 = fastuidraw::t_min(2 * dst_y, sz.y() - 1);
-      sy1 = fastuidraw::t_min(2 * dst_y + 1, sz.y() - 1);
-      for (int dst_x = 0; dst_x < w; ++dst_x)
-        {
-          int sx0, sx1;
-          fastuidraw::vec4 p00, p01, p10, p11, p;
-
-          sx0 = fastuidraw::t_min(2 * dst_x, sz.x() - 1);
-          sx1 = fastuidraw::t_min(2 * dst_x + 1, sz.x() - 1);
-
-          p00 = fastuidraw::vec4(in_data[sx0 + sy0 * sz.x()]);
-          p01 = fastuidraw::vec4(in_data[sx0 + sy1 * sz.x()]);
-          p10 = fastuidraw::vec4(in_data[sx1 + sy0 * sz.x()]);
-          p11 = fastuidraw::vec4(in_data[sx1 + sy1 * sz.x()]);
-
-          p = 0.25f * (p00 + p01 + p10 + p11);
-
-          for (unsigned int c = 0; c < 4; ++c)
-            {
-              float q;
-              q = fastuidraw::t_min(p[c], 255.0f);
-              q = fastuidraw::t_max(q, 0.0f);
-              out_data[dst_x + dst_y * w][c] = static_cast<unsigned int>(q);
-            }
-        }
-    }
-}
-
 ImageLoaderData::
 ImageLoaderData(const std::string &pfilename, bool flip):
   m_dimensions(0, 0)
@@ -220,21 +177,26 @@ ImageLoaderData(const std::string &pfilename, bool flip):
     }
 
   m_dimensions = fastuidraw::uvec2(dims);
-  m_mipmap_levels.push_back(std::vector<fastuidraw::u8vec4>());
-  m_mipmap_levels.back().swap(data);
 
-  while(dims.x() >= 2 && dims.y() >= 2)
+  /* Let FastUIDraw generate the (alpha-weighted) mipmap chain;
+   * ImageSourceCArray takes level n as size dims >> n, so stop
+   * before the smaller dimension reaches zero.
+   */
+  unsigned int num_levels;
+  fastuidraw::c_array<const fastuidraw::u8vec4> level0(cast_c_array(data));
+  fastuidraw::c_array<const fastuidraw::c_array<const fastuidraw::u8vec4> > levels(&level0, 1);
+  fastuidraw::ImageSourceCArray src(m_dimensions, levels, fastuidraw::Image::rgba_format);
+
+  num_levels = 1u + fastuidraw::uint32_log2(fastuidraw::t_min(m_dimensions.x(), m_dimensions.y()));
+  fastuidraw::ImageSourceMipmapChain chain(m_dimensions, src,
+                                           fastuidraw::ImageSourceMipmapChain::box_filter,
+                                           num_levels);
+
+  m_mipmap_levels.resize(chain.number_levels());
+  for (unsigned int i = 0; i < m_mipmap_levels.size(); ++i)
     {
-      fastuidraw::ivec2 wh;
-
-      wh.x() = fastuidraw::t_max(dims.x(), 1);
-      wh.y() = fastuidraw::t_max(dims.y(), 1);
-      create_mipmap_level(wh,
-                          cast_c_array(m_mipmap_levels.back()),
-                          data);
-      m_mipmap_levels.push_back(std::vector<fastuidraw::u8vec4>());
-      m_mipmap_levels.back().swap(data);
-      dims /= 2;
+      fastuidraw::c_array<const fastuidraw::u8vec4> texels(chain.level_texels(i));
+      m_mipmap_levels[i].assign(texels.begin(), texels.end());
     }
 
   m_data_as_arrays.resize(m_mipmap_levels.size());
@@ -20,11 +20,6 @@ load_image_to_array(const std::string &pfilename,
                     std::vector<fastuidraw::u8vec4> &out_bytes,
                     bool flip = false);
 
-void
-create_mipmap_level(fastuidraw::ivec2 sz,
-                    fastuidraw::c_array<const fastuidraw::u8vec4> in_data,
-                    std::vector<fastuidraw::u8vec4> &out_data);
-
 class ImageLoaderData
 {
 public:
@@ -421,6 +421,10 @@ sdl_painter_demo(const std::string &about_text,
   m_support_dual_src_blend_shaders(m_painter_params.support_dual_src_blend_shaders(),
                                    "painter_support_dual_src_blending",
                                    "If true allow the painter to support dual src blend shaders", *this),
+  m_use_multi_draw_indirect(m_painter_params.use_multi_draw_indirect(),
+                            "painter_use_multi_draw_indirect",
+                            "If true, issue the draws of each PainterDraw with "
+                            "glMultiDrawElementsIndirect from a buffer of draw commands", *this),
   m_preferred_blend_type(m_painter_params.preferred_blend_type(),
                          enumerated_string_type<shader_blend_type>()
                          .add_entry("single_src",
@@ -643,6 +647,7 @@ init_gl(int w, int h)
   APPLY_PARAM(fbf_blending_type, m_fbf_blending_type);
   APPLY_PARAM(support_dual_src_blend_shaders, m_support_dual_src_blend_shaders);
   APPLY_PARAM(use_uber_item_shader, m_use_uber_item_shader);
+  APPLY_PARAM(use_multi_draw_indirect, m_use_multi_draw_indirect);
 
 #undef APPLY_PARAM
 
@@ -746,6 +751,7 @@ init_gl(int w, int h)
       LAZY_PARAM_ENUM(preferred_blend_type, m_preferred_blend_type);
       LAZY_PARAM_ENUM(fbf_blending_type, m_fbf_blending_type);
       LAZY_PARAM_ENUM(support_dual_src_blend_shaders, m_support_dual_src_blend_shaders);
+      LAZY_PARAM_ENUM(use_multi_draw_indirect, m_use_multi_draw_indirect);
       std::cout << std::setw(40) << "geometry_backing_store_type:"
                 << std::setw(8) << m_painter_params.glyph_atlas_params().glyph_data_backing_store_type()
                 << "\n";
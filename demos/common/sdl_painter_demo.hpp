@@ -163,6 +163,7 @@ private:
   command_line_argument_value<bool> m_assign_layout_to_varyings;
   command_line_argument_value<bool> m_assign_binding_points;
   command_line_argument_value<bool> m_support_dual_src_blend_shaders;
+  command_line_argument_value<bool> m_use_multi_draw_indirect;
   enumerated_command_line_argument_value<shader_blend_type> m_preferred_blend_type;
   enumerated_command_line_argument_value<fbf_blending_type_t> m_fbf_blending_type;
   enumerated_command_line_argument_value<enum painter_optimal_t> m_painter_optimal;
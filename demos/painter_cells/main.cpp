@@ -137,6 +137,8 @@ painter_cells(void):
   m_renderer(adaptive_rendering,
              enumerated_string_type<enum glyph_type>()
              .add_entry("distance_field", distance_field_glyph, "Distance field rendering")
+             .add_entry("multi_channel_distance_field", multi_channel_distance_field_glyph,
+                        "Multi-channel distance field rendering")
              .add_entry("restricted_rays", restricted_rays_glyph, "Restricted Rays rendering")
              .add_entry("adaptive", adaptive_rendering, "Adaptive rendering"),
              "glyph_render",
@@ -48,6 +48,10 @@ operator<<(std::ostream &str, GlyphRenderer R)
           str << "BandedRays";
           break;
 
+        case multi_channel_distance_field_glyph:
+          str << "MultiChannelDistance";
+          break;
+
         default:
           str << "Unknown";
         }
@@ -171,6 +175,7 @@ private:
       draw_glyph_distance,
       draw_glyph_restricted_rays,
       draw_glyph_banded_rays,
+      draw_glyph_multi_channel_distance,
 
       draw_glyph_auto
     };
@@ -755,6 +760,7 @@ ready_glyph_data(int w, int h)
   m_draws[draw_glyph_distance] = GlyphRenderer(distance_field_glyph);
   m_draws[draw_glyph_restricted_rays] = GlyphRenderer(restricted_rays_glyph);
   m_draws[draw_glyph_banded_rays] = GlyphRenderer(banded_rays_glyph);
+  m_draws[draw_glyph_multi_channel_distance] = GlyphRenderer(multi_channel_distance_field_glyph);
   m_draws[draw_glyph_coverage] = GlyphRenderer(m_coverage_pixel_size.value());
 
   if (m_draw_glyph_set.value())
@@ -22,6 +22,7 @@
 #include <fastuidraw/util/util.hpp>
 #include <fastuidraw/util/vecN.hpp>
 #include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/reference_counted.hpp>
 
 namespace fastuidraw
 {
@@ -150,5 +151,54 @@ namespace fastuidraw
     void *m_d;
   };
 
+  /*!
+   * \brief
+   * A ColorStopArray is an immutable copy of a sequence of ColorStop
+   * values that a PainterBrush packs directly into its data; the
+   * shader then searches the color stops for each pixel.
+   *
+   * In contrast to a ColorStopSequenceOnAtlas, the color stops are
+   * not discretized, so a hard color stop (two consecutive ColorStop
+   * values with the same ColorStop::m_place) is realized exactly.
+   * In addition, no room on a ColorStopAtlas is allocated, which makes
+   * creating and releasing a ColorStopArray cheap. The price is that
+   * the shader search costs O(log N) reads of the data store per pixel
+   * where N is the number of color stops, so a ColorStopArray is best
+   * for gradients that are short-lived or have few color stops.
+   */
+  class ColorStopArray:
+    public reference_counted<ColorStopArray>::concurrent
+  {
+  public:
+    /*!
+     * Ctor.
+     * \param color_stops source color stops to copy, must
+     *                    have at least one ColorStop.
+     */
+    explicit
+    ColorStopArray(const ColorStopSequence &color_stops);
+
+    /*!
+     * Ctor.
+     * \param color_stops source color stops to copy, must have at
+     *                    least one ColorStop; the values need not
+     *                    be sorted. Values with the same ColorStop::m_place
+     *                    retain their order.
+     */
+    explicit
+    ColorStopArray(c_array<const ColorStop> color_stops);
+
+    ~ColorStopArray();
+
+    /*!
+     * Returns the color stops sorted by ColorStop::m_place.
+     */
+    c_array<const ColorStop>
+    values(void) const;
+
+  private:
+    void *m_d;
+  };
+
 /*! @} */
 }
@@ -0,0 +1,253 @@
+/*!
+ * \file painter_engine_cpu.hpp
+ * \brief file painter_engine_cpu.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <fastuidraw/painter/backend/painter_engine.hpp>
+
+namespace fastuidraw
+{
+  namespace cpu
+  {
+/*!\addtogroup CPUBackend
+ * @{
+ */
+    /*!
+     * \brief
+     * A PainterEngineCPU implements \ref PainterEngine by
+     * rasterizing the contents of each \ref PainterDraw on
+     * the CPU. The surface is split into tiles; the triangles
+     * of a \ref PainterDraw are binned to the tiles they touch
+     * and the tiles are rasterized in parallel by a pool of
+     * threads owned by each \ref PainterBackend created by the
+     * PainterEngineCPU. No GPU or 3D API is required.
+     *
+     * The CPU backend evaluates the same attribute, index and
+     * data store streams as the GL backend. The following are
+     * not supported: arc-strokes (a \ref Path is stroked with
+     * linear stroking instead and a \ref StrokedPath with arcs
+     * is not drawn) and custom brushes other than that of
+     * PainterShaderSet::blur_brush_shader() (items drawn with
+     * one are not drawn); both print a warning to std::cerr when
+     * encountered. All blend modes of \ref PainterEnums::blend_mode_t
+     * are supported, the W3C blend modes other than \ref
+     * PainterEnums::blend_w3c_screen by reading the surface. A
+     * single external texture, the \ref Image of the brush, is
+     * bound at a time. Images are sampled from mipmap level 0
+     * only and cubic filtering falls back to linear filtering.
+     */
+    class PainterEngineCPU:public PainterEngine
+    {
+    public:
+      /*!
+       * \brief
+       * A ConfigurationCPU gives parameters how to contruct
+       * a PainterEngineCPU.
+       */
+      class ConfigurationCPU
+      {
+      public:
+        /*!
+         * Ctor.
+         */
+        ConfigurationCPU(void);
+
+        /*!
+         * Copy ctor.
+         * \param obj value from which to copy
+         */
+        ConfigurationCPU(const ConfigurationCPU &obj);
+
+        ~ConfigurationCPU();
+
+        /*!
+         * Assignment operator
+         * \param rhs value from which to copy
+         */
+        ConfigurationCPU&
+        operator=(const ConfigurationCPU &rhs);
+
+        /*!
+         * Swap operation
+         * \param obj object with which to swap
+         */
+        void
+        swap(ConfigurationCPU &obj);
+
+        /*!
+         * The number of threads each \ref PainterBackend uses
+         * to rasterize. A value of 0 indicates to use the value
+         * of std::thread::hardware_concurrency(). Default value
+         * is 0.
+         */
+        unsigned int
+        number_threads(void) const;
+
+        /*!
+         * Set the value returned by number_threads(void) const.
+         */
+        ConfigurationCPU&
+        number_threads(unsigned int);
+
+        /*!
+         * The width and height of the tiles into which the
+         * triangles are binned; each tile is rasterized by
+         * a single thread. Default value is 64.
+         */
+        unsigned int
+        tile_size(void) const;
+
+        /*!
+         * Set the value returned by tile_size(void) const.
+         */
+        ConfigurationCPU&
+        tile_size(unsigned int);
+
+        /*!
+         * Returns the number of \ref PainterAttribute values
+         * each \ref PainterDraw holds. Default value is 512 * 512.
+         */
+        unsigned int
+        attributes_per_buffer(void) const;
+
+        /*!
+         * Set the value returned by attributes_per_buffer(void) const.
+         */
+        ConfigurationCPU&
+        attributes_per_buffer(unsigned int);
+
+        /*!
+         * Returns the number of \ref PainterIndex values each
+         * \ref PainterDraw holds. Default value is 1.5 times
+         * the default value of attributes_per_buffer().
+         */
+        unsigned int
+        indices_per_buffer(void) const;
+
+        /*!
+         * Set the value returned by indices_per_buffer(void) const.
+         */
+        ConfigurationCPU&
+        indices_per_buffer(unsigned int);
+
+        /*!
+         * Returns the number of blocks of 4 \ref generic_data
+         * each \ref PainterDraw holds in its data store.
+         * Default value is 1024 * 64.
+         */
+        unsigned int
+        data_blocks_per_store_buffer(void) const;
+
+        /*!
+         * Set the value returned by data_blocks_per_store_buffer(void) const.
+         */
+        ConfigurationCPU&
+        data_blocks_per_store_buffer(unsigned int);
+
+        /*!
+         * The initial number of \ref generic_data values
+         * of the \ref GlyphAtlas; the store grows as needed.
+         * Default value is 1024 * 1024.
+         */
+        unsigned int
+        glyph_atlas_size(void) const;
+
+        /*!
+         * Set the value returned by glyph_atlas_size(void) const.
+         */
+        ConfigurationCPU&
+        glyph_atlas_size(unsigned int);
+
+        /*!
+         * The log2 of the width and height of the color
+         * tiles of the \ref ImageAtlas. Default value is 5.
+         */
+        int
+        log2_color_tile_size(void) const;
+
+        /*!
+         * Set the value returned by log2_color_tile_size(void) const.
+         */
+        ConfigurationCPU&
+        log2_color_tile_size(int);
+
+        /*!
+         * The log2 of the width and height of the index
+         * tiles of the \ref ImageAtlas. Default value is 2.
+         */
+        int
+        log2_index_tile_size(void) const;
+
+        /*!
+         * Set the value returned by log2_index_tile_size(void) const.
+         */
+        ConfigurationCPU&
+        log2_index_tile_size(int);
+
+        /*!
+         * The width of each layer of the \ref ColorStopAtlas.
+         * Default value is 1024.
+         */
+        int
+        colorstop_atlas_width(void) const;
+
+        /*!
+         * Set the value returned by colorstop_atlas_width(void) const.
+         */
+        ConfigurationCPU&
+        colorstop_atlas_width(int);
+
+      private:
+        void *m_d;
+      };
+
+      ~PainterEngineCPU();
+
+      /*!
+       * Create a PainterEngineCPU, the atlases it uses
+       * and its default shaders.
+       * \param config ConfigurationCPU providing configuration parameters
+       */
+      static
+      reference_counted_ptr<PainterEngineCPU>
+      create(const ConfigurationCPU &config = ConfigurationCPU());
+
+      /*!
+       * Returns the ConfigurationCPU passed to create().
+       */
+      const ConfigurationCPU&
+      configuration_cpu(void) const;
+
+      virtual
+      reference_counted_ptr<PainterBackend>
+      create_backend(void) const override final;
+
+      virtual
+      reference_counted_ptr<PainterSurface>
+      create_surface(ivec2 dims,
+                     enum PainterSurface::render_type_t render_type) override final;
+
+    private:
+      PainterEngineCPU(const ConfigurationCPU &config,
+                       const PainterShaderSet &shaders);
+
+      void *m_d;
+    };
+/*! @} */
+  }
+}
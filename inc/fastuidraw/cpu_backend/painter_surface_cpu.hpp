@@ -0,0 +1,123 @@
+/*!
+ * \file painter_surface_cpu.hpp
+ * \brief file painter_surface_cpu.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/painter/backend/painter_surface.hpp>
+
+namespace fastuidraw
+{
+  namespace cpu
+  {
+/*!\addtogroup CPUBackend
+ * @{
+ */
+
+    /*!
+     * A PainterSurfaceCPU is the implementation of \ref PainterSurface
+     * for the CPU backend. The pixels are held in system memory as
+     * RGBA8 values with the RGB channels pre-multiplied by alpha.
+     * Row 0 of the pixels is the bottom row, i.e. the row with the
+     * most negative normalized device y-coordinate, matching the
+     * layout that glReadPixels gives for a \ref PainterSurface of
+     * the GL backend.
+     */
+    class PainterSurfaceCPU:public PainterSurface
+    {
+    public:
+      /*!
+       * Ctor. The viewport() is initialized to be exactly
+       * the entire surface.
+       * \param dims the width and height of the PainterSurfaceCPU
+       * \param render_type the render type of the surface (i.e.
+       *                    is it a color buffer or deferred
+       *                    coverage buffer)
+       */
+      explicit
+      PainterSurfaceCPU(ivec2 dims,
+                        enum render_type_t render_type = color_buffer_type);
+
+      ~PainterSurfaceCPU();
+
+      /*!
+       * Returns the pixels of the surface; pixel (x, y) is
+       * at index x + y * dimensions().x(). For a surface
+       * whose render_type() is \ref deferred_coverage_buffer_type
+       * the coverage value is stored in the red channel. The
+       * values must not be read while a \ref PainterBackend is
+       * drawing to the surface.
+       */
+      c_array<const u8vec4>
+      pixels(void) const;
+
+      /*!
+       * Copies the pixels of the surface to a buffer whose
+       * rows are ordered top to bottom, i.e. the layout
+       * expected by most image file writers.
+       * \param dst location to which to write the pixels,
+       *            must have size at least dimensions().x()
+       *            times dimensions().y()
+       */
+      void
+      read_pixels_top_down(c_array<u8vec4> dst) const;
+
+      /*!
+       * Used internally by the CPU backend; do not touch
+       * the data behind the void pointer.
+       */
+      void*
+      opaque_data(void) const
+      {
+        return m_d;
+      }
+
+      virtual
+      reference_counted_ptr<const Image>
+      image(ImageAtlas &atlas) const override final;
+
+      virtual
+      const Viewport&
+      viewport(void) const override final;
+
+      virtual
+      void
+      viewport(const Viewport &vwp) override final;
+
+      virtual
+      const vec4&
+      clear_color(void) const override final;
+
+      virtual
+      void
+      clear_color(const vec4&) override final;
+
+      virtual
+      ivec2
+      dimensions(void) const override final;
+
+      virtual
+      enum render_type_t
+      render_type(void) const override final;
+
+    private:
+      void *m_d;
+    };
+/*! @} */
+  }
+}
@@ -70,6 +70,48 @@ namespace fastuidraw
           number_program_types
         };
 
+      /*!
+       * \brief
+       * An UploadContext represents a GL context in the share group
+       * of the GL context used by a \ref PainterEngineGL. When a \ref
+       * ConfigurationGL is given an UploadContext, the atlases it
+       * creates own a worker thread that makes the UploadContext
+       * current and performs the uploads and resizes of the GL
+       * textures backing the atlases, and deletes the GL objects
+       * of the atlases. The rendering thread has the GL server wait
+       * on a fence for the uploads before it uses the textures, so
+       * it does not perform the uploads itself. Because the library
+       * does not create GL contexts, the application implements
+       * this interface, typically over EGL, GLX or WGL.
+       */
+      class UploadContext:
+        public reference_counted<UploadContext>::concurrent
+      {
+      public:
+        virtual
+        ~UploadContext()
+        {}
+
+        /*!
+         * To be implemented by a derived class to make the GL
+         * context current to the calling thread. Called once
+         * from the worker thread before it issues any GL calls.
+         */
+        virtual
+        void
+        make_current(void) = 0;
+
+        /*!
+         * To be implemented by a derived class to make the GL
+         * context not current to the calling thread. Called
+         * once from the worker thread after it issues its last
+         * GL call.
+         */
+        virtual
+        void
+        release_current(void) = 0;
+      };
+
       /*!
        * \brief
        * Class to hold the construction parameters for creating
@@ -145,7 +187,11 @@ namespace fastuidraw
         optimal_color_sizes(int log2_color_tile_size);
 
         /*!
-         * The initial number of color layers, initial value is 1
+         * The initial number of color layers, initial value is 1.
+         * The atlas adds layers as needed; if the GL context supports
+         * GL_ARB_sparse_texture, adding layers commits memory for
+         * just the new layers instead of copying the existing layers
+         * to a larger texture.
          */
         int
         num_color_layers(void) const;
@@ -489,6 +535,27 @@ namespace fastuidraw
         const reference_counted_ptr<GlyphAtlas>&
         glyph_atlas(void) const;
 
+        /*!
+         * The \ref UploadContext with which the atlases perform
+         * their uploads, resizes and deletion of GL objects from
+         * a worker thread. If nullptr, these are performed on the
+         * thread that renders with the atlases. When non-null,
+         * ImageAtlas::flush(), GlyphAtlas::flush() and
+         * ColorStopAtlas::flush() do not require a GL context to
+         * be current and start the uploads of the atlas data added
+         * since the last flush. Default value is nullptr.
+         */
+        const reference_counted_ptr<UploadContext>&
+        upload_context(void) const;
+
+        /*!
+         * Set the value for upload_context(void) const. Changing
+         * the value makes the next calls to image_atlas(),
+         * glyph_atlas() and colorstop_atlas() create new atlases.
+         */
+        ConfigurationGL&
+        upload_context(const reference_counted_ptr<UploadContext> &v);
+
         /*!
          * Specifies the maximum number of attributes
          * a PainterDraw returned by
@@ -672,6 +739,25 @@ namespace fastuidraw
         ConfigurationGL&
         use_uber_item_shader(bool);
 
+        /*!
+         * If true, the draws of each PainterDraw are written to
+         * a GL buffer as indirect draw commands and issued with
+         * glMultiDrawElementsIndirect, rather than passing arrays
+         * of counts and offsets to glMultiDrawElements. Requires
+         * GL 4.3 (or GL_ARB_multi_draw_indirect) or GLES 3.1 with
+         * GL_EXT_multi_draw_indirect; adjust_for_context() sets
+         * this to false if the context does not support it. Default
+         * value is true.
+         */
+        bool
+        use_multi_draw_indirect(void) const;
+
+        /*!
+         * Set the value for use_multi_draw_indirect(void) const
+         */
+        ConfigurationGL&
+        use_multi_draw_indirect(bool);
+
         /*!
          * If true, the vertex shader inputs should be qualified
          * with a layout(location=) specifier. Default value is
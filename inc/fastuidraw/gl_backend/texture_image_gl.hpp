@@ -92,7 +92,11 @@ namespace gl
 
     /*!
      * Create a GL texture and use it to back a TextureImage; the
-     * created TextureImage will own the GL texture.
+     * created TextureImage will own the GL texture. If the
+     * ImageSourceBase::compression() of image_data is supported
+     * by the GL context, the texture uses that compression and is
+     * initialized from ImageSourceBase::compressed_blocks() without
+     * decompressing the data.
      * \param w width of the image to create
      * \param h height of the image to create
      * \param patlas the ImageAtlas that the created image is part of
@@ -132,6 +136,14 @@ namespace gl
     texture(void) const;
 
   private:
+    static
+    reference_counted_ptr<TextureImage>
+    create_compressed(ImageAtlas &patlas, int w, int h,
+                      const ImageSourceBase &image_data,
+                      GLenum compressed_format,
+                      GLenum tex_magnification, GLenum tex_minification,
+                      bool allow_bindless);
+
     TextureImage(ImageAtlas &patlas, int w, int h, unsigned int m,
                  bool object_owns_texture, GLuint texture,
                  enum format_t fmt);
@@ -73,6 +73,8 @@ namespace fastuidraw
      * Available to both the vertex and fragment shader are the following:
      *  - sampler2DArray fastuidraw_imageAtlasLinear the color texels (AtlasColorBackingStoreBase) for images unfiltered
      *  - sampler2DArray fastuidraw_imageAtlasLinearFiltered the color texels (AtlasColorBackingStoreBase) for images bilinearly filtered
+     *  - sampler2DArray fastuidraw_imageAtlasR8 the color texels (AtlasColorBackingStoreBase) of images with one channel
+     *  - sampler2DArray fastuidraw_imageAtlasRG8 the color texels (AtlasColorBackingStoreBase) of images with two channels
      *  - usampler2DArray fastuidraw_imageIndexAtlas the texels of the index atlas (AtlasIndexBackingStoreBase) for images
      *  - the macro fastuidraw_fetch_data(B) to fetch the B'th block from the data store buffer
      *    (PainterDraw::m_store), return as uvec4. To get floating point data use, the GLSL
@@ -272,6 +274,8 @@ namespace fastuidraw
      * Available to both the vertex and fragment shader are the following:
      *  - sampler2DArray fastuidraw_imageAtlasLinear the color texels (AtlasColorBackingStoreBase) for images unfiltered
      *  - sampler2DArray fastuidraw_imageAtlasLinearFiltered the color texels (AtlasColorBackingStoreBase) for images bilinearly filtered
+     *  - sampler2DArray fastuidraw_imageAtlasR8 the color texels (AtlasColorBackingStoreBase) of images with one channel
+     *  - sampler2DArray fastuidraw_imageAtlasRG8 the color texels (AtlasColorBackingStoreBase) of images with two channels
      *  - usampler2DArray fastuidraw_imageIndexAtlas the texels of the index atlas (AtlasIndexBackingStoreBase) for images
      *  - the macro fastuidraw_fetch_data(B) to fetch the B'th block from the data store buffer
      *    (PainterDraw::m_store), return as uvec4. To get floating point data use, the GLSL
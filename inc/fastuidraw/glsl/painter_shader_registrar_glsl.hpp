@@ -565,6 +565,24 @@ namespace fastuidraw
         int
         image_atlas_color_tiles_linear_binding(void) const;
 
+        /*!
+         * Returns the binding point for the sampler2DArray
+         * derived from the current value of this UberShaderParams
+         * with linear filtering backed by ImageAtlas::color_store()
+         * of ImageAtlas::r8_color_store.
+         */
+        int
+        image_atlas_color_tiles_r8_binding(void) const;
+
+        /*!
+         * Returns the binding point for the sampler2DArray
+         * derived from the current value of this UberShaderParams
+         * with linear filtering backed by ImageAtlas::color_store()
+         * of ImageAtlas::rg8_color_store.
+         */
+        int
+        image_atlas_color_tiles_rg8_binding(void) const;
+
         /*!
          * Returns the binding point for the usampler2DArray
          * derived from the current value of this UberShaderParams
@@ -61,6 +61,39 @@ class ImageAtlas;
          * pre-multiplied by the alpha channel.
          */
         premultipied_rgba_format,
+
+        /*!
+         * Image holds only an alpha channel, taken from
+         * the .w channel of the texels of the source; the
+         * RGB channels of the image are all 1.0. Images
+         * on an \ref ImageAtlas of this format take one
+         * byte per texel. Images backed by a texture of
+         * this format have the alpha in the red channel.
+         */
+        alpha_format,
+
+        /*!
+         * Image holds only a luminance channel, taken from
+         * the .x channel of the texels of the source; the
+         * RGB channels of the image are all the luminance
+         * and the alpha channel is 1.0. Images on an \ref
+         * ImageAtlas of this format take one byte per texel.
+         * Images backed by a texture of this format have the
+         * luminance in the red channel.
+         */
+        luminance_format,
+
+        /*!
+         * Image holds a luminance channel and a (non-
+         * pre-multiplied) alpha channel, taken from the .x
+         * and .w channels of the texels of the source; the
+         * RGB channels of the image are all the luminance.
+         * Images on an \ref ImageAtlas of this format take
+         * two bytes per texel. Images backed by a texture of
+         * this format have the luminance in the red channel
+         * and the alpha in the green channel.
+         */
+        luminance_alpha_format,
       };
 
     /*!
@@ -234,10 +267,63 @@ class ImageAtlas;
   class ImageSourceBase
   {
   public:
+    /*!
+     * \brief
+     * Enumeration to specify the GPU block compression
+     * of the texel data of an ImageSourceBase. Each of
+     * the compressions encode 4x4 blocks of texels.
+     */
+    enum compression_t
+      {
+        /*!
+         * Texel data is not compressed.
+         */
+        uncompressed,
+
+        /*!
+         * BC1 (also called DXT1, i.e. GL_COMPRESSED_RGBA_S3TC_DXT1_EXT)
+         * with 8 bytes per block.
+         */
+        bc1_compression,
+
+        /*!
+         * BC2 (also called DXT3, i.e. GL_COMPRESSED_RGBA_S3TC_DXT3_EXT)
+         * with 16 bytes per block.
+         */
+        bc2_compression,
+
+        /*!
+         * BC3 (also called DXT5, i.e. GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+         * with 16 bytes per block.
+         */
+        bc3_compression,
+
+        /*!
+         * ETC2 RGB (i.e. GL_COMPRESSED_RGB8_ETC2) with 8 bytes per
+         * block; the alpha channel is always 1.0.
+         */
+        etc2_rgb8_compression,
+
+        /*!
+         * ETC2 RGBA with EAC alpha (i.e. GL_COMPRESSED_RGBA8_ETC2_EAC)
+         * with 16 bytes per block.
+         */
+        etc2_rgba8_compression,
+      };
+
     virtual
     ~ImageSourceBase()
     {}
 
+    /*!
+     * Returns the number of bytes of a single 4x4 block
+     * of a compression; returns 0 for \ref uncompressed.
+     * \param compression compression to query
+     */
+    static
+    unsigned int
+    compressed_block_size(enum compression_t compression);
+
     /*!
      * To be implemented by a derived class to return true
      * if a region (across all mipmap levels) has a constant
@@ -294,6 +380,70 @@ class ImageAtlas;
     virtual
     enum Image::format_t
     format(void) const = 0;
+
+    /*!
+     * Returns the format with the fewest channels among
+     * \ref Image::alpha_format, \ref Image::luminance_format
+     * and \ref Image::luminance_alpha_format that represents
+     * exactly the texels (across all mipmap levels) of the
+     * image data. If none does or if format() is already
+     * one of those formats, returns format(). Examines
+     * every texel, so the cost is linear in the size of
+     * the image data.
+     * \param dimensions the width and height of LOD 0
+     *                   of the image data
+     */
+    enum Image::format_t
+    compact_format(ivec2 dimensions) const;
+
+    /*!
+     * To be optionally implemented by a derived class to
+     * return the block compression of the data returned
+     * by compressed_blocks(). If the value is not \ref
+     * uncompressed, a backend able to sample from the
+     * compression uploads the blocks without decompressing
+     * them and the texels of fetch_texels() are used only
+     * when it cannot. Default implementation is to return
+     * \ref uncompressed.
+     */
+    virtual
+    enum compression_t
+    compression(void) const
+    {
+      return uncompressed;
+    }
+
+    /*!
+     * To be implemented by a derived class whose compression()
+     * is not \ref uncompressed to return the compressed blocks
+     * of a mipmap level. The blocks are packed row by row with
+     * each row holding (w + 3) / 4 blocks and the level holding
+     * (h + 3) / 4 rows where (w, h) is the size of the level.
+     * Default implementation is to return an empty array.
+     * \param level LOD of data, 0 <= level < number_levels()
+     */
+    virtual
+    c_array<const uint8_t>
+    compressed_blocks(unsigned int level) const
+    {
+      FASTUIDRAWunused(level);
+      return c_array<const uint8_t>();
+    }
+
+    /*!
+     * To be optionally implemented by a derived class to return
+     * true if fetch_texels() and all_same_color() are safe to
+     * call concurrently from several threads; in that case
+     * \ref ImageAtlas fetches the tiles of an \ref Image from
+     * several threads when creating the \ref Image. Default
+     * implementation is to return false.
+     */
+    virtual
+    bool
+    thread_safe(void) const
+    {
+      return false;
+    }
   };
 
   /*!
@@ -335,12 +485,182 @@ class ImageAtlas;
     enum Image::format_t
     format(void) const;
 
+    virtual
+    bool
+    thread_safe(void) const;
+
   private:
     uvec2 m_dimensions;
     c_array<const c_array<const u8vec4> > m_data;
     enum Image::format_t m_format;
   };
 
+  /*!
+   * \brief
+   * An implementation of \ref ImageSourceBase that generates
+   * the full mipmap chain of an image from its LOD level 0.
+   * The generated levels are held in CPU memory and are computed
+   * at construction; texels of an \ref Image::rgba_format or
+   * \ref Image::luminance_alpha_format image are filtered with
+   * the color weighted by alpha so that transparent texels do
+   * not bleed their color into the lower resolution levels.
+   */
+  class ImageSourceMipmapChain:
+    public ImageSourceBase,
+    public noncopyable
+  {
+  public:
+    /*!
+     * \brief
+     * Enumeration to specify the filter used to compute
+     * each LOD level from the level before it.
+     */
+    enum filter_t
+      {
+        /*!
+         * Each texel is the average of the 2x2 texels
+         * of the previous level; this is the cheapest
+         * filter.
+         */
+        box_filter,
+
+        /*!
+         * Each texel is computed with a separable 6x6
+         * Kaiser-windowed sinc filter of the previous
+         * level; this gives sharper lower resolution
+         * levels with less aliasing than \ref box_filter.
+         */
+        kaiser_filter,
+      };
+
+    /*!
+     * Ctor.
+     * \param dimensions width and height of the LOD level 0; the
+     *                   LOD level n is of size (max(1, dimensions.x() >> n),
+     *                   max(1, dimensions.y() >> n))
+     * \param level0 source of the LOD level 0 texel data, only
+     *               level 0 of level0 is read and it is read
+     *               only during the ctor
+     * \param filter filter used to generate each level
+     * \param max_levels if non-zero, the maximum number of LOD levels,
+     *                   including level 0, to generate. A value
+     *                   of 0 indicates to generate all levels down
+     *                   to 1x1.
+     */
+    ImageSourceMipmapChain(uvec2 dimensions,
+                           const ImageSourceBase &level0,
+                           enum filter_t filter = box_filter,
+                           unsigned int max_levels = 0u);
+
+    ~ImageSourceMipmapChain();
+
+    /*!
+     * Returns the texels of an LOD level. The
+     * texels are packed row by row.
+     * \param level which LOD level
+     */
+    c_array<const u8vec4>
+    level_texels(unsigned int level) const;
+
+    /*!
+     * Returns the dimensions of an LOD level.
+     * \param level which LOD level
+     */
+    uvec2
+    level_dimensions(unsigned int level) const;
+
+    virtual
+    bool
+    all_same_color(ivec2 location, int square_size, u8vec4 *dst) const;
+
+    virtual
+    unsigned int
+    number_levels(void) const;
+
+    virtual
+    void
+    fetch_texels(unsigned int mimpap_level, ivec2 location,
+                 unsigned int w, unsigned int h,
+                 c_array<u8vec4> dst) const;
+
+    virtual
+    enum Image::format_t
+    format(void) const;
+
+    virtual
+    bool
+    thread_safe(void) const;
+
+  private:
+    void *m_d;
+  };
+
+  /*!
+   * \brief
+   * An implementation of \ref ImageSourceBase where the data is
+   * GPU block compressed and backed by c_array<const uint8_t>
+   * data. The texels of fetch_texels() are decoded on the CPU
+   * on demand.
+   */
+  class ImageSourceCompressedCArray:public ImageSourceBase
+  {
+  public:
+    /*!
+     * Ctor.
+     * \param dimensions width and height of the LOD level 0 mipmap;
+     *                   the LOD level n is then assumed to be size
+     *                   (dimensions.x() >> n, dimensions.y() >> n)
+     * \param pdata the compressed blocks of each LOD, packed as
+     *              described by ImageSourceBase::compressed_blocks();
+     *              the data is NOT copied, thus the contents backing
+     *              the data must not be freed until the
+     *              ImageSourceCompressedCArray goes out of scope.
+     * \param compression the compression of the data, must not be
+     *                    \ref uncompressed
+     * \param fmt the format of the image data
+     */
+    ImageSourceCompressedCArray(uvec2 dimensions,
+                                c_array<const c_array<const uint8_t> > pdata,
+                                enum compression_t compression,
+                                enum Image::format_t fmt = Image::rgba_format);
+
+    virtual
+    bool
+    all_same_color(ivec2 location, int square_size, u8vec4 *dst) const;
+
+    virtual
+    unsigned int
+    number_levels(void) const;
+
+    virtual
+    void
+    fetch_texels(unsigned int mimpap_level, ivec2 location,
+                 unsigned int w, unsigned int h,
+                 c_array<u8vec4> dst) const;
+
+    virtual
+    enum Image::format_t
+    format(void) const;
+
+    virtual
+    bool
+    thread_safe(void) const;
+
+    virtual
+    enum compression_t
+    compression(void) const;
+
+    virtual
+    c_array<const uint8_t>
+    compressed_blocks(unsigned int level) const;
+
+  private:
+    uvec2 m_dimensions;
+    c_array<const c_array<const uint8_t> > m_data;
+    enum compression_t m_compression;
+    enum Image::format_t m_format;
+  };
+
 /*! @} */
 
 } //namespace
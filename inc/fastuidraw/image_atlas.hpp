@@ -39,7 +39,9 @@ namespace fastuidraw
    * For example in GL, this can be a GL_TEXTURE_2D_ARRAY. An implementation
    * of the class does NOT need to be thread safe because the user of the
    * backing store (ImageAtlas) performs calls to the backing store behind
-   * its own mutex.
+   * its own mutex. A backing store that holds fewer than four channels
+   * per texel (see \ref ImageAtlas::color_store_t) stores only the
+   * leading channels of the texel values given to set_data().
    */
   class AtlasColorBackingStoreBase:
     public reference_counted<AtlasColorBackingStoreBase>::concurrent
@@ -253,6 +255,47 @@ namespace fastuidraw
     public reference_counted<ImageAtlas>::concurrent
   {
   public:
+    /*!
+     * Enumeration to name the color backing stores of an
+     * ImageAtlas. An Image whose Image::type() is \ref
+     * Image::on_atlas has its color tiles in the color
+     * store given by color_store_for_format() of its
+     * Image::format().
+     */
+    enum color_store_t
+      {
+        /*!
+         * Color store holding four channels of 8-bits per texel,
+         * used by images of format \ref Image::rgba_format and
+         * \ref Image::premultipied_rgba_format.
+         */
+        rgba8_color_store,
+
+        /*!
+         * Color store holding one channel of 8-bits per texel,
+         * used by images of format \ref Image::alpha_format
+         * and \ref Image::luminance_format.
+         */
+        r8_color_store,
+
+        /*!
+         * Color store holding two channels of 8-bits per texel,
+         * used by images of format \ref Image::luminance_alpha_format.
+         */
+        rg8_color_store,
+
+        number_color_stores
+      };
+
+    /*!
+     * Returns the color store in which the tiles of an
+     * Image of the named format are placed.
+     * \param fmt Image format
+     */
+    static
+    enum color_store_t
+    color_store_for_format(enum Image::format_t fmt);
+
     virtual
     ~ImageAtlas();
 
@@ -265,11 +308,27 @@ namespace fastuidraw
      *             returned \ref Image \ref Image::bindless_texture2d
      *             will fallback to \ref Image::on_atlas and \ref
      *             Image::on_atlas will fallback to \ref
-     *             Image::context_texture2d
+     *             Image::context_texture2d. If ImageSourceBase::compression()
+     *             of image_data is not \ref ImageSourceBase::uncompressed,
+     *             an image backed by a texture is preferred so that the
+     *             texels stay compressed, with \ref Image::on_atlas
+     *             (holding decoded texels) as the fallback.
+     * \param detect_compact_format if true, the returned \ref Image
+     *                              takes the format given by
+     *                              ImageSourceBase::compact_format()
+     *                              instead of ImageSourceBase::format()
+     *                              so that an image whose texels need
+     *                              only one or two channels uses a
+     *                              color store with fewer channels.
+     *                              Formats can also be selected by the
+     *                              image_data returning one of those
+     *                              formats from ImageSourceBase::format().
+     *                              Ignored for compressed image_data.
      */
     reference_counted_ptr<Image>
     create(int w, int h, const ImageSourceBase &image_data,
-           enum Image::type_t type = Image::bindless_texture2d);
+           enum Image::type_t type = Image::bindless_texture2d,
+           bool detect_compact_format = false);
 
     /*!
      * Construct an \ref Image whose \ref Image::type() is NOT
@@ -300,17 +359,33 @@ namespace fastuidraw
      * Calls AtlasIndexBackingStoreBase::flush() on
      * the index backing store (see index_store())
      * and AtlasColorBackingStoreBase::flush() on
-     * the color backing store (see color_store()).
+     * each of the color backing stores (see color_store()).
      */
     void
     flush(void) const;
 
     /*!
-     * Returns a handle to the backing store for the image data.
+     * Returns a handle to the backing store for the image data;
+     * provided as a conveniance, equivalent to
+     * \code
+     * color_store(rgba8_color_store)
+     * \endcode
      */
     const reference_counted_ptr<const AtlasColorBackingStoreBase>&
     color_store(void) const;
 
+    /*!
+     * Returns a handle to the named backing store for the image
+     * data; a handle to the \ref r8_color_store or \ref
+     * rg8_color_store may be nullptr in which case the tiles of
+     * images of the formats that would use it are placed in the
+     * \ref rgba8_color_store instead and those images report
+     * \ref Image::rgba_format as their Image::format().
+     * \param C which color store
+     */
+    const reference_counted_ptr<const AtlasColorBackingStoreBase>&
+    color_store(enum color_store_t C) const;
+
     /*!
      * Returns a handle to the backing store for the index data.
      */
@@ -389,7 +464,23 @@ namespace fastuidraw
      * \param image_data image data to which to set the tile
      */
     ivec3
-    add_color_tile(ivec2 src_xy, const ImageSourceBase &image_data);
+    add_color_tile(ivec2 src_xy, const ImageSourceBase &image_data)
+    {
+      return add_color_tile(rgba8_color_store, src_xy, image_data);
+    }
+
+    /*!
+     * Adds a tile to the named color store of the atlas returning
+     * the location (in pixels) of the tile in that backing store.
+     * The named color store stores only its leading channels of
+     * the texels of image_data.
+     * \param C which color store, that color store must not be nullptr
+     * \param src_xy location from ImageSourceBase to take data
+     * \param image_data image data to which to set the tile
+     */
+    ivec3
+    add_color_tile(enum color_store_t C, ivec2 src_xy,
+                   const ImageSourceBase &image_data);
 
     /*!
      * Adds a tile of a constant color to the atlas returning
@@ -399,14 +490,40 @@ namespace fastuidraw
      *                   the tile
      */
     ivec3
-    add_color_tile(u8vec4 color_data);
+    add_color_tile(u8vec4 color_data)
+    {
+      return add_color_tile(rgba8_color_store, color_data);
+    }
+
+    /*!
+     * Adds a tile of a constant color to the named color store
+     * of the atlas returning the location (in pixels) of the tile
+     * in that backing store.
+     * \param C which color store, that color store must not be nullptr
+     * \param color_data color value to which to set all pixels of
+     *                   the tile
+     */
+    ivec3
+    add_color_tile(enum color_store_t C, u8vec4 color_data);
 
     /*!
      * Mark a tile as free in the atlas
      * \param tile tile to free as returned by add_color_tile().
      */
     void
-    delete_color_tile(ivec3 tile);
+    delete_color_tile(ivec3 tile)
+    {
+      delete_color_tile(rgba8_color_store, tile);
+    }
+
+    /*!
+     * Mark a tile of the named color store as free in the atlas
+     * \param C which color store
+     * \param tile tile to free as returned by add_color_tile()
+     *             with the same value for C.
+     */
+    void
+    delete_color_tile(enum color_store_t C, ivec3 tile);
 
     /*!
      * Returns the number of free color tiles that are available
@@ -414,7 +531,18 @@ namespace fastuidraw
      * of the ImageAtlas.
      */
     int
-    number_free_color_tiles(void) const;
+    number_free_color_tiles(void) const
+    {
+      return number_free_color_tiles(rgba8_color_store);
+    }
+
+    /*!
+     * Returns the number of free color tiles that are available
+     * in the named color store without resizing it.
+     * \param C which color store
+     */
+    int
+    number_free_color_tiles(enum color_store_t C) const;
 
     /*!
      * Resize the color and image backing stores so that
@@ -425,7 +553,21 @@ namespace fastuidraw
      * \param num_index_tiles number of index tiles
      */
     void
-    resize_to_fit(int num_color_tiles, int num_index_tiles);
+    resize_to_fit(int num_color_tiles, int num_index_tiles)
+    {
+      resize_to_fit(rgba8_color_store, num_color_tiles, num_index_tiles);
+    }
+
+    /*!
+     * Resize the named color store and the index backing store
+     * so that the given number of color and index tiles can also
+     * be added to the atlas without needing to free any tiles.
+     * \param C which color store
+     * \param num_color_tiles number of color tiles
+     * \param num_index_tiles number of index tiles
+     */
+    void
+    resize_to_fit(enum color_store_t C, int num_color_tiles, int num_index_tiles);
 
     /*!
      * Queue a ResourceReleaseAction to be executed when resources are
@@ -452,6 +594,31 @@ namespace fastuidraw
                reference_counted_ptr<AtlasColorBackingStoreBase> pcolor_store,
                reference_counted_ptr<AtlasIndexBackingStoreBase> pindex_store);
 
+    /*!
+     * Ctor.
+     * \param pcolor_tile_size size of each color tile, a value of 0 indicates
+     *                         that atlased Images are not allowed.
+     * \param pindex_tile_size size of each index tile, a value of 0 indicates
+     *                         that atlased Images are not allowed.
+     * \param pcolor_store color data backing store for atlas, the width and
+     *                     height of the backing store must be divisible by
+     *                     pcolor_tile_size.
+     * \param pindex_store index backing store for atlas, the width and
+     *                     height of the backing store must be divisible by
+     *                     pindex_tile_size.
+     * \param pr8_color_store backing store for \ref r8_color_store, may
+     *                        be nullptr; the width and height of the backing
+     *                        store must be divisible by pcolor_tile_size.
+     * \param prg8_color_store backing store for \ref rg8_color_store, may
+     *                         be nullptr; the width and height of the backing
+     *                         store must be divisible by pcolor_tile_size.
+     */
+    ImageAtlas(int pcolor_tile_size, int pindex_tile_size,
+               reference_counted_ptr<AtlasColorBackingStoreBase> pcolor_store,
+               reference_counted_ptr<AtlasIndexBackingStoreBase> pindex_store,
+               reference_counted_ptr<AtlasColorBackingStoreBase> pr8_color_store,
+               reference_counted_ptr<AtlasColorBackingStoreBase> prg8_color_store);
+
   private:
     /*!
      * Construct an \ref Image backed by an \ref ImageAtlas. If there is
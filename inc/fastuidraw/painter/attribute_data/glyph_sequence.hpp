@@ -164,6 +164,68 @@ namespace fastuidraw
       add_glyphs(glyph_sources, positions);
     }
 
+    /*!
+     * Insert \ref GlyphSource values and positions before the
+     * glyph at a given index; values are -copied-. The glyphs
+     * at and after the index have their index (as reported by
+     * added_glyph() and Subset::glyphs()) increased by the number
+     * of glyphs inserted. Only the \ref Subset values that
+     * receive the inserted glyphs need to regenerate their
+     * attribute and index data.
+     * \param I index at which to insert, must be that
+     *          0 <= I <= number_glyphs()
+     * \param glyph_sources specifies what glyphs to insert
+     * \param positions specifies the positions of each glyph inserted
+     */
+    void
+    insert_glyphs(unsigned int I,
+                  c_array<const GlyphSource> glyph_sources,
+                  c_array<const vec2> positions);
+
+    /*!
+     * Remove a range of glyphs. The glyphs after the range have
+     * their index (as reported by added_glyph() and Subset::glyphs())
+     * decreased by the number of glyphs removed. Only the \ref
+     * Subset values that held the removed glyphs need to regenerate
+     * their attribute and index data.
+     * \param begin index of the first glyph to remove
+     * \param count number of glyphs to remove; the range is
+     *              clamped to [0, number_glyphs())
+     */
+    void
+    remove_glyphs(unsigned int begin, unsigned int count);
+
+    /*!
+     * Replace a range of glyphs, i.e. the glyph at index
+     * begin + i is replaced by glyph_sources[i] at positions[i].
+     * The indices of glyphs are not changed. Only the \ref Subset
+     * values that held the replaced glyphs or that receive the
+     * new glyphs need to regenerate their attribute and index data.
+     * \param begin index of the first glyph to replace, must be
+     *              that begin + glyph_sources.size() <= number_glyphs()
+     * \param glyph_sources specifies the replacing glyphs
+     * \param positions specifies the positions of the replacing glyphs
+     */
+    void
+    replace_glyphs(unsigned int begin,
+                   c_array<const GlyphSource> glyph_sources,
+                   c_array<const vec2> positions);
+
+    /*!
+     * Translate the position of a range of glyphs, for example
+     * to scroll lines of text. The indices of glyphs are not
+     * changed. Only the \ref Subset values that held the moved
+     * glyphs or that receive them need to regenerate their
+     * attribute and index data.
+     * \param begin index of the first glyph to translate
+     * \param count number of glyphs to translate; the range is
+     *              clamped to [0, number_glyphs())
+     * \param delta amount by which to translate the glyphs
+     */
+    void
+    translate_glyphs(unsigned int begin, unsigned int count,
+                     const vec2 &delta);
+
     /*!
      * Returns the number of \ref GlyphSource values added via
      * add_glyph() and add_glyphs().
@@ -47,6 +47,12 @@ class PainterAttributeData;
  * to use from these objects is computed by the member function
  * compute_chunks(); the PainterAttributeData chunking for joins
  * and caps is the same regardless of the cap and join type.
+ *
+ * The \ref PainterAttributeData of each join and cap type is only
+ * generated the first time it is requested; generation is thread
+ * safe, i.e. different threads may request data from the same
+ * StrokedCapsJoins. The data of those join and cap types that
+ * are no longer used can be released with release_unused_data().
  */
 class StrokedCapsJoins:noncopyable
 {
@@ -333,6 +339,21 @@ public:
   const PainterAttributeData&
   arc_rounded_caps(void) const;
 
+  /*!
+   * Release the \ref PainterAttributeData of each join and
+   * cap type that has not been requested since the previous
+   * call to release_unused_data() (or since construction for
+   * the first call). Released data is regenerated on demand
+   * by the next request for it. A caller must make sure that
+   * no reference returned by an earlier request for released
+   * data is still in use, i.e. it is illegal to call
+   * release_unused_data() while a different thread is drawing
+   * with data from this StrokedCapsJoins. Returns the number
+   * of join and cap types whose data was released.
+   */
+  unsigned int
+  release_unused_data(void) const;
+
 private:
   void *m_d;
 };
@@ -25,6 +25,7 @@
 #include <fastuidraw/util/c_array.hpp>
 #include <fastuidraw/util/reference_counted.hpp>
 #include <fastuidraw/painter/attribute_data/stroked_caps_joins.hpp>
+#include <fastuidraw/painter/painter_dashed_stroke_params.hpp>
 
 namespace fastuidraw  {
 
@@ -109,6 +110,49 @@ public:
     void *m_d;
   };
 
+  /*!
+   * \brief
+   * A DashedEdges holds the attribute data of the edges of
+   * the Subset objects of a StrokedPath split on the CPU so
+   * that only the portions covered by a dash pattern remain,
+   * see StrokedPath::dashed_edges(). Like a Subset, a
+   * DashedEdges is invalid once the StrokedPath from which
+   * it comes goes out of scope.
+   */
+  class DashedEdges:
+    public reference_counted<DashedEdges>::concurrent
+  {
+  public:
+    ~DashedEdges();
+
+    /*!
+     * Returns the attribute data of the edges of a Subset
+     * split by the dash pattern; a cap is added at each end
+     * of a dash that falls within the Subset. The returned
+     * data is packed with StrokedPoint::pack_point(), is to
+     * be drawn with the non-dashed PainterStrokeShader and
+     * has a single chunk, 0, with the same z-range as the
+     * Subset's painter_data(). The values are computed on
+     * first request and the returned pointer is valid for
+     * the lifetime of this DashedEdges. Returns nullptr if
+     * the edge data of the Subset is not laid out as the
+     * CPU dashing expects, in which case the caller should
+     * dash in the shader instead.
+     * \param subset_id ID of the Subset, i.e. a value as
+     *                  written by select_subsets()
+     */
+    const PainterAttributeData*
+    subset_data(unsigned int subset_id) const;
+
+  private:
+    friend class StrokedPath;
+
+    explicit
+    DashedEdges(void *d);
+
+    void *m_d;
+  };
+
   /*!
    * Ctor. Construct a StrokedPath from the data
    * of a TessellatedPath.
@@ -207,6 +251,41 @@ public:
   const StrokedCapsJoins&
   caps_joins(void) const;
 
+  /*!
+   * Enumeration of constants for dashed_edges().
+   */
+  enum dashed_edges_constants_t
+    {
+      /*!
+       * Maximum number of distinct dash patterns for which
+       * the StrokedPath caches the values of dashed_edges();
+       * once exceeded, the least recently used is evicted.
+       */
+      max_number_cached_dash_patterns = 8
+    };
+
+  /*!
+   * Returns the DashedEdges of a dash pattern. The values
+   * are cached per dash pattern, see \ref
+   * max_number_cached_dash_patterns; an evicted DashedEdges
+   * stays valid for as long as a reference to it is held,
+   * so a caller should hold the returned value for as long
+   * as it uses the data of DashedEdges::subset_data(). This
+   * method may be called from several threads. It is an
+   * error to call this if has_arcs() returns true.
+   * \param dash_pattern dash pattern, see PainterDashedStrokeParams::dash_pattern()
+   * \param dash_offset dash offset, see PainterDashedStrokeParams::dash_offset()
+   * \param cp cap style to give to each dash; values other than
+   *           Painter::square_caps and Painter::rounded_caps
+   *           are treated as Painter::flat_caps
+   * \param thresh threshhold to decide the number of points
+   *               for the triangulation of rounded caps
+   */
+  reference_counted_ptr<const DashedEdges>
+  dashed_edges(c_array<const PainterDashedStrokeParams::DashPatternElement> dash_pattern,
+               float dash_offset, enum PainterEnums::cap_style cp,
+               float thresh) const;
+
 private:
   void *m_d;
 };
@@ -165,6 +165,33 @@ namespace fastuidraw
     virtual
     unsigned int
     on_painter_begin(void) = 0;
+
+    /*!
+     * To be optionally implemented by a derived class to report
+     * how many calls to change graphics API state it made and how
+     * many it skipped because they would not have changed the state,
+     * since the last call to on_painter_begin(). The values are
+     * reported as PainterEnums::num_backend_state_changes and
+     * PainterEnums::num_backend_state_changes_elided. Default
+     * implementation reports zero for both.
+     *
+     * NOTE: this virtual method was appended to PainterBackend
+     * after the other virtual methods; adding it changes the
+     * vtable layout of PainterBackend, so a class derived from
+     * PainterBackend must be recompiled against this header.
+     * \param out_issued location to which to write the number of
+     *                   state changes made
+     * \param out_elided location to which to write the number of
+     *                   state changes skipped
+     */
+    virtual
+    void
+    state_change_counts(unsigned int *out_issued,
+                        unsigned int *out_elided) const
+    {
+      *out_issued = 0u;
+      *out_elided = 0u;
+    }
   };
 /*! @} */
 
@@ -0,0 +1,221 @@
+/*!
+ * \file painter_blur_brush_shader_data.hpp
+ * \brief file painter_blur_brush_shader_data.hpp
+ *
+ * Copyright 2019 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/image.hpp>
+#include <fastuidraw/painter/painter_custom_brush_shader_data.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Painter
+ * @{
+ */
+
+  /*!
+   * \brief
+   * A PainterBlurBrushShaderData holds the values of one pass
+   * of a separable blur as read by the custom brush shader
+   * PainterShaderSet::blur_brush_shader(); the data is packed
+   * as according to \ref blur_data_offset_t followed by the
+   * taps of the pass.
+   *
+   * The brush shader maps a brush position p to q = S * p + t
+   * where S scales the x-coordinate by transformation_scale().x()
+   * and the y-coordinate by transformation_scale().y() and t is
+   * transformation_translate(). The color of the brush at p
+   * is the sum, computed in floating point, over the taps T of
+   * T.y() * C(q + T.x() * axis()) where C(r) is the value of the
+   * image() at r with linear filtering and r clamped to the
+   * window [clamp_min(), clamp_max()]. A tap thus reads (and
+   * weights) two texels at once when its offset is between
+   * them. Finally the result is mixed towards a silhouette of
+   * the RGB channels of shadow_color() by the alpha channel of
+   * shadow_color().
+   */
+  class PainterBlurBrushShaderData:public PainterCustomBrushShaderData
+  {
+  public:
+    /*!
+     * \brief
+     * Enumeration that provides offsets for the values of
+     * the blur pass. The taps are packed starting at
+     * \ref taps_offset, a tap as two floats: the offset
+     * along axis() followed by the weight.
+     */
+    enum blur_data_offset_t
+      {
+        transformation_scale_x_offset, /*!< offset to transformation_scale().x() (packed as float) */
+        transformation_scale_y_offset, /*!< offset to transformation_scale().y() (packed as float) */
+        transformation_translate_x_offset, /*!< offset to transformation_translate().x() (packed as float) */
+        transformation_translate_y_offset, /*!< offset to transformation_translate().y() (packed as float) */
+
+        axis_x_offset, /*!< offset to axis().x() (packed as float) */
+        axis_y_offset, /*!< offset to axis().y() (packed as float) */
+
+        /*!
+         * offset to the low 32-bits of the bindless handle of
+         * image() (packed as uint); both the low and high bits
+         * are zero if image() is not of type \ref
+         * Image::bindless_texture2d in which case the image is
+         * sampled from the external texture of slot 0.
+         */
+        image_bindless_handle_low_offset,
+        image_bindless_handle_hi_offset, /*!< offset to the high 32-bits of the bindless handle of image() (packed as uint) */
+
+        clamp_min_x_offset, /*!< offset to clamp_min().x() (packed as float) */
+        clamp_min_y_offset, /*!< offset to clamp_min().y() (packed as float) */
+        clamp_max_x_offset, /*!< offset to clamp_max().x() (packed as float) */
+        clamp_max_y_offset, /*!< offset to clamp_max().y() (packed as float) */
+
+        shadow_color_red_offset, /*!< offset to shadow_color().x() (packed as float) */
+        shadow_color_green_offset, /*!< offset to shadow_color().y() (packed as float) */
+        shadow_color_blue_offset, /*!< offset to shadow_color().z() (packed as float) */
+        shadow_color_alpha_offset, /*!< offset to shadow_color().w() (packed as float) */
+
+        number_taps_offset, /*!< offset to number of taps (packed as uint) */
+
+        taps_offset = number_taps_offset + 4, /*!< offset at which the taps are packed */
+      };
+
+    /*!
+     * Ctor.
+     */
+    PainterBlurBrushShaderData(void);
+
+    /*!
+     * The image to blur; the image must have Image::type()
+     * as value \ref Image::bindless_texture2d or \ref
+     * Image::context_texture2d. Default value is nullptr.
+     */
+    const reference_counted_ptr<const Image>&
+    image(void) const;
+
+    /*!
+     * Set the value of image(void) const.
+     */
+    PainterBlurBrushShaderData&
+    image(const reference_counted_ptr<const Image> &v);
+
+    /*!
+     * The scaling factors applied to the x and y coordinates
+     * of the brush position. A pass that reduces resolution
+     * should only scale along its axis() so that the blur of
+     * the pass filters the samples it skips. Default value
+     * is (1, 1).
+     */
+    const vec2&
+    transformation_scale(void) const;
+
+    /*!
+     * Set the value of transformation_scale(void) const.
+     */
+    PainterBlurBrushShaderData&
+    transformation_scale(const vec2 &v);
+
+    /*!
+     * The translation applied to the brush position after
+     * the scaling. Default value is (0, 0).
+     */
+    const vec2&
+    transformation_translate(void) const;
+
+    /*!
+     * Set the value of transformation_translate(void) const.
+     */
+    PainterBlurBrushShaderData&
+    transformation_translate(const vec2 &v);
+
+    /*!
+     * The direction, in texels of image(), along which the
+     * taps are placed. Default value is (1, 0).
+     */
+    const vec2&
+    axis(void) const;
+
+    /*!
+     * Set the value of axis(void) const.
+     */
+    PainterBlurBrushShaderData&
+    axis(const vec2 &v);
+
+    /*!
+     * The min-corner, in texel coordinates of image(), of
+     * the window to which sample points are clamped.
+     * Default value is (0, 0).
+     */
+    const vec2&
+    clamp_min(void) const;
+
+    /*!
+     * Set the value of clamp_min(void) const.
+     */
+    PainterBlurBrushShaderData&
+    clamp_min(const vec2 &v);
+
+    /*!
+     * The max-corner, in texel coordinates of image(), of
+     * the window to which sample points are clamped.
+     * Default value is (0, 0).
+     */
+    const vec2&
+    clamp_max(void) const;
+
+    /*!
+     * Set the value of clamp_max(void) const.
+     */
+    PainterBlurBrushShaderData&
+    clamp_max(const vec2 &v);
+
+    /*!
+     * The RGB channels give the color of the silhouette and
+     * the alpha channel how much the blurred color is replaced
+     * by the silhouette; a value of 1 gives (w * r, w * g, w * b, w)
+     * where w is the alpha of the blurred color. Default value
+     * is (0, 0, 0, 0), i.e. no silhouette.
+     */
+    const vec4&
+    shadow_color(void) const;
+
+    /*!
+     * Set the value of shadow_color(void) const.
+     */
+    PainterBlurBrushShaderData&
+    shadow_color(const vec4 &v);
+
+    /*!
+     * The taps of the pass, the x-coordinate of a tap is
+     * its offset along axis() and the y-coordinate is its
+     * weight. Default value is a single tap of offset 0
+     * and weight 1.
+     */
+    c_array<const vec2>
+    taps(void) const;
+
+    /*!
+     * Set the value of taps(void) const.
+     */
+    PainterBlurBrushShaderData&
+    taps(c_array<const vec2> v);
+  };
+
+/*! @} */
+}
@@ -27,6 +27,8 @@
 
 namespace fastuidraw
 {
+  class Painter;
+
 /*!\addtogroup Painter
  * @{
  */
@@ -63,6 +65,35 @@ namespace fastuidraw
     PainterData::brush_value
     brush(const reference_counted_ptr<const Image> &image,
 	  const Rect &brush_rect) = 0;
+
+    /*!
+     * Issue the drawing commands of the pass. The transformation
+     * of the passed 
+ef Painter is set so that drawing the rect
+     * brush_rect covers exactly the region of the layer in the
+     * destination and the brush coordinates of a point are the
+     * same as its coordinates; the blend shader and blend mode
+     * are set to what is required for the pass. The Painter state
+     * is saved before and restored after draw() is called, thus
+     * an implementation may freely change the transformation,
+     * blend shader or clipping. The default implementation is
+     * \code
+     * painter.fill_rect(PainterData(brush(image, brush_rect)), brush_rect, false);
+     * \endcode
+     * A derived class reimplements draw() to change how a pass
+     * draws, for example to draw only part of the destination to
+     * write a reduced resolution result to be read by the next
+     * pass.
+     * \param painter Painter to which to draw
+     * \param image the image to which the effect is applied
+     * \param brush_rect the brush coordinates of the rect
+     *                   drawn
+     */
+    virtual
+    void
+    draw(Painter &painter,
+         const reference_counted_ptr<const Image> &image,
+         const Rect &brush_rect);
   };
 
   /*!
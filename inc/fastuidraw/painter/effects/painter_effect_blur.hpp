@@ -0,0 +1,132 @@
+/*!
+ * \file painter_effect_blur.hpp
+ * \brief file painter_effect_blur.hpp
+ *
+ * Copyright 2019 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/painter/effects/painter_effect.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Painter
+ * @{
+ */
+
+  /*!
+   * \brief
+   * A PainterEffectBlur represents applying a Gaussian blur
+   * to a layer. The blur is realized as a horizontal pass that
+   * also reduces the horizontal resolution by downsample(), a
+   * vertical pass that also reduces the vertical resolution and
+   * a final pass that scales the result back up; each pass only
+   * reduces resolution along the axis it blurs so that no texel
+   * is skipped unfiltered. Each blur pass is a single
+   * draw with PainterShaderSet::blur_brush_shader() which sums
+   * the taps in floating point, where each tap uses linear
+   * filtering to read two texels at once.
+   *
+   * The blur of content near the boundary of the layer is
+   * clipped by the layer, i.e. the clipping region at
+   * Painter::begin_layer() needs to include the region the
+   * blurred content reaches.
+   *
+   * With shadow() true, the result is a silhouette: the
+   * color of each pixel is color() and its coverage is
+   * the blurred alpha times the alpha of color(); together
+   * with offset() this gives a drop shadow over which the
+   * content is then drawn.
+   */
+  class PainterEffectBlur:public PainterEffect
+  {
+  public:
+    PainterEffectBlur(void);
+
+    /*!
+     * Set the standard deviation, in pixels, of the blur.
+     * Default value is 4.0.
+     */
+    void
+    sigma(float v);
+
+    /*!
+     * Returns the standard deviation, in pixels, of the blur.
+     */
+    float
+    sigma(void) const;
+
+    /*!
+     * Set the factor by which the resolution is reduced when
+     * computing the blur. A value of 0 indicates to choose the
+     * factor from sigma(void) const. Default value is 0.
+     */
+    void
+    downsample(unsigned int v);
+
+    /*!
+     * Returns the value set by downsample(unsigned int).
+     */
+    unsigned int
+    downsample(void) const;
+
+    /*!
+     * Set the color by which to modulate the blurred image,
+     * or the color of the silhouette if shadow() is true.
+     * Default value is (1, 1, 1, 1).
+     */
+    void
+    color(const vec4 &v);
+
+    /*!
+     * Return the color by which to modulate the blurred image.
+     */
+    const vec4&
+    color(void) const;
+
+    /*!
+     * Set the translation, in pixels of the surface (with y
+     * increasing upwards), applied to the blurred image.
+     * Default value is (0, 0).
+     */
+    void
+    offset(const vec2 &v);
+
+    /*!
+     * Returns the translation applied to the blurred image.
+     */
+    const vec2&
+    offset(void) const;
+
+    /*!
+     * Set if the blurred image is made a silhouette of
+     * color(). Default value is false.
+     */
+    void
+    shadow(bool v);
+
+    /*!
+     * Returns the value set by shadow(bool).
+     */
+    bool
+    shadow(void) const;
+
+    virtual
+    reference_counted_ptr<PainterEffect>
+    copy(void) const override;
+  };
+/*! @} */
+};
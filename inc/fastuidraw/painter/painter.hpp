@@ -584,6 +584,55 @@ namespace fastuidraw
     void
     clip_in_path(const FilledPath &path, const CustomFillRuleBase &fill_rule);
 
+    /*!
+     * If true, draws that are known to be opaque are packed into
+     * a separate stream whose draws are submitted before all other
+     * draws and in reverse order, i.e. front to back, so that depth
+     * testing rejects the fragments they hide before those fragments
+     * are shaded. Each such draw is given its own z-value, which
+     * consumes the z-range faster. A draw is known to be opaque if
+     * it uses the item shader of the default fill shader, the blend
+     * mode is \ref blend_porter_duff_src_over or \ref blend_porter_duff_src
+     * (of the default blend shaders), the brush is a constant color
+     * with alpha 1.0 and no clip_out_path() or similar occluder
+     * is active. Default value is false.
+     */
+    bool
+    front_to_back_opaque(void) const;
+
+    /*!
+     * Set the value returned by front_to_back_opaque(void) const.
+     */
+    void
+    front_to_back_opaque(bool v);
+
+    /*!
+     * Returns the maximum number of occluders of clip_out_path()
+     * and clip_in_path() taking a Path and a \ref fill_rule_t fill
+     * rule that are cached. An occluder is cached by the FilledPath
+     * of the Path, fill rule, transformation and current clipping,
+     * and a later clip with the same values reuses the path geometry
+     * selected for it instead of selecting it again; the cache holds
+     * a reference to the FilledPath. The overloads taking a FilledPath
+     * directly are not cached. When exceeded, the least
+     * recently used are dropped at begin(). A value of 0 disables
+     * the caching. Default value is 64.
+     */
+    unsigned int
+    max_cached_clip_paths(void) const;
+
+    /*!
+     * Set the value returned by max_cached_clip_paths(void) const.
+     */
+    void
+    max_cached_clip_paths(unsigned int v);
+
+    /*!
+     * Drop all cached occluders, see max_cached_clip_paths().
+     */
+    void
+    invalidate_clip_path_cache(void);
+
     /*!
      * Clipout by a rect
      * \param rect clip-out rectangle
@@ -689,6 +738,23 @@ namespace fastuidraw
     float
     curve_flatness(void);
 
+    /*!
+     * Set if the CPU time spent in the different portions of
+     * painting (selecting subsets, clipping, packing, fetching
+     * glyphs and the backend's pre- and post-draw) is measured.
+     * The times are reported by query_stats() in the time_xxx_us
+     * values of \ref query_stats_t. Measuring adds a small
+     * overhead and is off by default.
+     */
+    void
+    profiling(bool v);
+
+    /*!
+     * Returns the value set by profiling(bool).
+     */
+    bool
+    profiling(void) const;
+
     /*!
      * Save the current state of this Painter onto the save state stack.
      * The state is restored (and the stack popped) by called restore().
@@ -782,6 +848,86 @@ namespace fastuidraw
     void
     end_layer(void);
 
+    /*!
+     * Begin an FX layer whose content is retained across frames.
+     * The layer content is rendered to an offscreen surface owned by
+     * the Painter and identified by content_key. If an earlier layer
+     * with the same content_key was rendered with the same clipping
+     * region, transformation and viewport size, the retained content
+     * is blitted with the passed FX and the method returns false;
+     * in that case the caller should not issue the drawing commands
+     * of the layer, and any that are issued are culled. Otherwise
+     * the method returns true and the caller issues the drawing
+     * commands of the layer which are then retained. In either case
+     * the layer is ended with end_layer(). The same rules regarding
+     * save() and restore() as begin_layer() apply. When effect has
+     * multiple passes, only the content before the first pass is
+     * retained. It is the caller's responsibility to use a new
+     * content_key or to call invalidate_layer_cache(uint64_t) when
+     * the content changes.
+     * \param content_key caller chosen value identifying the content
+     * \param effect FX to apply
+     */
+    bool
+    begin_cached_layer(uint64_t content_key,
+                       const reference_counted_ptr<PainterEffect> &effect);
+
+    /*!
+     * Begin a transparency layer whose content is retained across
+     * frames, see begin_cached_layer(uint64_t, const reference_counted_ptr<PainterEffect>&).
+     * \param content_key caller chosen value identifying the content
+     * \param color_modulate color value by which to modulate
+     *                       the layer when it is to be blitted
+     */
+    bool
+    begin_cached_layer(uint64_t content_key, const vec4 &color_modulate);
+
+    /*!
+     * Provided as a conveniance, equivalent to
+     * \code
+     * begin_cached_layer(content_key, vec4(1.0f, 1.0f, 1.0f, alpha));
+     * \endcode
+     * \param content_key caller chosen value identifying the content
+     * \param alpha alpha value for color modulation.
+     */
+    bool
+    begin_cached_layer(uint64_t content_key, float alpha)
+    {
+      return begin_cached_layer(content_key, vec4(1.0f, 1.0f, 1.0f, alpha));
+    }
+
+    /*!
+     * Drop the retained content of the layer with the named
+     * content key, see begin_cached_layer(). May not be called
+     * within a begin()/end() pair.
+     * \param content_key key of the layer to drop
+     */
+    void
+    invalidate_layer_cache(uint64_t content_key);
+
+    /*!
+     * Drop the retained content of all layers, see
+     * begin_cached_layer(). May not be called within a
+     * begin()/end() pair.
+     */
+    void
+    invalidate_layer_cache(void);
+
+    /*!
+     * Returns the maximum number of layers whose content
+     * is retained by begin_cached_layer(); when exceeded the
+     * least recently used are dropped at begin(). Default
+     * value is 16.
+     */
+    unsigned int
+    max_cached_layers(void) const;
+
+    /*!
+     * Set the value returned by max_cached_layers(void) const.
+     */
+    void
+    max_cached_layers(unsigned int v);
+
     /*!
      * Begin a deferred coverage buffer layer. A deferred
      * coverage buffer is needed for those \ref PainterItemShader
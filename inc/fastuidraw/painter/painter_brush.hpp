@@ -225,9 +225,12 @@ namespace fastuidraw
 
         /*!
          * Number of bits needed to encode the value of
-         * Image::format().
+         * Image::format(). The value also determines the
+         * ImageAtlas::color_store_t from which the texels
+         * of an Image on an ImageAtlas are fetched, see
+         * ImageAtlas::color_store_for_format().
          */
-        image_format_num_bits = 1,
+        image_format_num_bits = 3,
 
         /*!
          * Number of bits used to encode number of mipmap
@@ -302,11 +305,19 @@ namespace fastuidraw
          */
         image_format_bit0 = image_type_bit0 + image_type_num_bits,
 
+        /*!
+         * Bit up if the color stops of the gradient are from a
+         * ColorStopArray packed into the brush data (see \ref
+         * gradient_color_stops_packing) instead of from a
+         * ColorStopSequenceOnAtlas.
+         */
+        gradient_packed_color_stops_bit = image_format_bit0 + image_format_num_bits,
+
         /*!
          * Must be last enum, gives number of bits needed to hold shader bits
          * of a PainterBrush.
          */
-        number_shader_bits = image_format_bit0 + image_format_num_bits,
+        number_shader_bits,
       };
 
     /*!
@@ -381,6 +392,17 @@ namespace fastuidraw
          * mask generated from \ref image_format_bit0 and \ref image_format_num_bits
          */
         image_format_mask = FASTUIDRAW_MASK(image_format_bit0, image_format_num_bits),
+
+        /*!
+         * mask generated from \ref gradient_packed_color_stops_bit
+         */
+        gradient_packed_color_stops_mask = FASTUIDRAW_MASK(gradient_packed_color_stops_bit, 1),
+
+        /*!
+         * mask of \ref gradient_type_mask, \ref gradient_spread_type_mask
+         * and \ref gradient_packed_color_stops_mask bitwise or'd together
+         */
+        gradient_mask = gradient_type_mask | gradient_spread_type_mask | gradient_packed_color_stops_mask,
       };
 
     /*!
@@ -430,6 +452,19 @@ namespace fastuidraw
          * offsets of the individual fields
          */
         transformation_matrix_packing,
+
+        /*!
+         * color stops of a gradient, only present if the gradient
+         * sources its color stops from a ColorStopArray. Let N be
+         * the number of color stops and M be N rounded up to a
+         * multiple of 4. The first M values are the ColorStop::m_place
+         * values (packed as float) padded by repeating the last
+         * place. The next M values are the ColorStop::m_color values
+         * (packed as uint32 according to \ref
+         * packed_color_stop_color_encoding) padded by repeating the
+         * last color.
+         */
+        gradient_color_stops_packing,
       };
 
     /*!
@@ -558,6 +593,21 @@ namespace fastuidraw
         gradient_color_stop_y_bit0 = gradient_color_stop_x_num_bits /*!< where ColorStopSequenceOnAtlas::texel_location().y() is encoded */
       };
 
+    /*!
+     * \brief
+     * Bit encoding for packing the ColorStop::m_color values
+     * of a ColorStopArray, see \ref gradient_color_stops_packing
+     */
+    enum packed_color_stop_color_encoding
+      {
+        packed_color_stop_channel_num_bits = 8, /*!< number bits to encode each channel of ColorStop::m_color */
+
+        packed_color_stop_red_bit0 = 0, /*!< where ColorStop::m_color.x() is encoded */
+        packed_color_stop_green_bit0 = packed_color_stop_red_bit0 + packed_color_stop_channel_num_bits, /*!< where ColorStop::m_color.y() is encoded */
+        packed_color_stop_blue_bit0 = packed_color_stop_green_bit0 + packed_color_stop_channel_num_bits, /*!< where ColorStop::m_color.z() is encoded */
+        packed_color_stop_alpha_bit0 = packed_color_stop_blue_bit0 + packed_color_stop_channel_num_bits, /*!< where ColorStop::m_color.w() is encoded */
+      };
+
     /*!
      * \brief
      * Enumeration that provides offset from the start of
@@ -592,13 +642,17 @@ namespace fastuidraw
         /*!
          * Offset to the x and y-location of the color stops.
          * The offset is stored as a uint32 packed as according
-         * in the enumeration \ref gradient_color_stop_xy_encoding
+         * in the enumeration \ref gradient_color_stop_xy_encoding.
+         * If the color stops are from a ColorStopArray, the
+         * value is 0.
          */
         gradient_color_stop_xy_offset,
 
         /*!
          * Offset to the length of the color stop in -texels-, i.e.
-         * ColorStopSequenceOnAtlas::width(), packed as a uint32
+         * ColorStopSequenceOnAtlas::width(), packed as a uint32.
+         * If the color stops are from a ColorStopArray, the value
+         * is instead the number of color stops.
          */
         gradient_color_stop_length_offset,
 
@@ -807,13 +861,14 @@ namespace fastuidraw
       uint32_t gradient_bits;
 
       m_data.m_cs = cs;
+      m_data.m_cs_array = nullptr;
       m_data.m_grad_start = start_p;
       m_data.m_grad_end = end_p;
       gradient_bits = cs ?
         pack_bits(gradient_type_bit0, gradient_type_num_bits, linear_gradient_type)
         | pack_bits(gradient_spread_type_bit0, spread_type_num_bits, spread) :
         0u;
-      m_data.m_shader_raw &= ~(gradient_type_mask | gradient_spread_type_mask);
+      m_data.m_shader_raw &= ~gradient_mask;
       m_data.m_shader_raw |= gradient_bits;
       return *this;
     }
@@ -837,6 +892,7 @@ namespace fastuidraw
       uint32_t gradient_bits;
 
       m_data.m_cs = cs;
+      m_data.m_cs_array = nullptr;
       m_data.m_grad_start = start_p;
       m_data.m_grad_start_r = start_r;
       m_data.m_grad_end = end_p;
@@ -845,7 +901,7 @@ namespace fastuidraw
         pack_bits(gradient_type_bit0, gradient_type_num_bits, radial_gradient_type)
         | pack_bits(gradient_spread_type_bit0, spread_type_num_bits, spread) :
         0u;
-      m_data.m_shader_raw &= ~(gradient_type_mask | gradient_spread_type_mask);
+      m_data.m_shader_raw &= ~gradient_mask;
       m_data.m_shader_raw |= gradient_bits;
       return *this;
     }
@@ -889,13 +945,14 @@ namespace fastuidraw
       uint32_t gradient_bits;
 
       m_data.m_cs = cs;
+      m_data.m_cs_array = nullptr;
       m_data.m_grad_start = p;
       m_data.m_grad_end = vec2(theta, F);
       gradient_bits = cs ?
         pack_bits(gradient_type_bit0, gradient_type_num_bits, sweep_gradient_type)
         | pack_bits(gradient_spread_type_bit0, spread_type_num_bits, spread) :
         0u;
-      m_data.m_shader_raw &= ~(gradient_type_mask | gradient_spread_type_mask);
+      m_data.m_shader_raw &= ~gradient_mask;
       m_data.m_shader_raw |= gradient_bits;
       return *this;
     }
@@ -957,6 +1014,160 @@ namespace fastuidraw
       return sweep_gradient(cs, p, theta, orientation, rotation_orientation, 1.0f, spread);
     }
 
+    /*!
+     * Sets the brush to have a linear gradient whose color stops
+     * are packed into the brush data.
+     * \param cs color stops for gradient. If handle is invalid,
+     *           then sets brush to not have a gradient.
+     * \param start_p start position of gradient
+     * \param end_p end position of gradient.
+     * \param spread specifies the gradient spread type
+     */
+    PainterBrush&
+    linear_gradient(const reference_counted_ptr<const ColorStopArray> &cs,
+                    const vec2 &start_p, const vec2 &end_p,
+                    enum spread_type_t spread)
+    {
+      m_data.m_cs = nullptr;
+      m_data.m_cs_array = cs;
+      m_data.m_grad_start = start_p;
+      m_data.m_grad_end = end_p;
+      set_packed_gradient_bits(linear_gradient_type, spread);
+      return *this;
+    }
+
+    /*!
+     * Sets the brush to have a radial gradient whose color stops
+     * are packed into the brush data.
+     * \param cs color stops for gradient. If handle is invalid,
+     *           then sets brush to not have a gradient.
+     * \param start_p start position of gradient
+     * \param start_r starting radius of radial gradient
+     * \param end_p end position of gradient.
+     * \param end_r ending radius of radial gradient
+     * \param spread specifies the gradient spread type
+     */
+    PainterBrush&
+    radial_gradient(const reference_counted_ptr<const ColorStopArray> &cs,
+                    const vec2 &start_p, float start_r,
+                    const vec2 &end_p, float end_r,
+                    enum spread_type_t spread)
+    {
+      m_data.m_cs = nullptr;
+      m_data.m_cs_array = cs;
+      m_data.m_grad_start = start_p;
+      m_data.m_grad_start_r = start_r;
+      m_data.m_grad_end = end_p;
+      m_data.m_grad_end_r = end_r;
+      set_packed_gradient_bits(radial_gradient_type, spread);
+      return *this;
+    }
+
+    /*!
+     * Sets the brush to have a radial gradient whose color stops
+     * are packed into the brush data. Provided as a conveniance,
+     * equivalent to
+     * \code
+     * radial_gradient(cs, p, 0.0f, p, r, repeat);
+     * \endcode
+     * \param cs color stops for gradient. If handle is invalid,
+     *           then sets brush to not have a gradient.
+     * \param p start and end position of gradient
+     * \param r ending radius of radial gradient
+     * \param spread specifies the gradient spread type
+     */
+    PainterBrush&
+    radial_gradient(const reference_counted_ptr<const ColorStopArray> &cs,
+                    const vec2 &p, float r, enum spread_type_t spread)
+    {
+      return radial_gradient(cs, p, 0.0f, p, r, spread);
+    }
+
+    /*!
+     * Sets the brush to have a sweep gradient (directly) whose
+     * color stops are packed into the brush data.
+     * \param cs color stops for gradient. If handle is invalid,
+     *           then sets brush to not have a gradient.
+     * \param p position of gradient
+     * \param theta start angle of the sweep gradient, this value
+     *              should be in the range [-PI, PI]
+     * \param F the repeat factor applied to the interpolate, the
+     *          sign of F is used to determine the sign of the
+     *          sweep gradient.
+     * \param spread specifies the gradient spread type
+     */
+    PainterBrush&
+    sweep_gradient(const reference_counted_ptr<const ColorStopArray> &cs,
+                   const vec2 &p, float theta, float F,
+                   enum spread_type_t spread)
+    {
+      m_data.m_cs = nullptr;
+      m_data.m_cs_array = cs;
+      m_data.m_grad_start = p;
+      m_data.m_grad_end = vec2(theta, F);
+      set_packed_gradient_bits(sweep_gradient_type, spread);
+      return *this;
+    }
+
+    /*!
+     * Sets the brush to have a sweep gradient whose color stops
+     * are packed into the brush data where the sign is determined
+     * by a PainterEnums::screen_orientation and a
+     * PainterEnums::rotation_orientation_t.
+     * \param cs color stops for gradient. If handle is invalid,
+     *           then sets brush to not have a gradient.
+     * \param p position of gradient
+     * \param theta angle of the sweep gradient, this value
+     *              should be in the range [-PI, PI]
+     * \param F the repeat factor applied to the interpolate,
+     *          a negative reverses the orientation of the sweep.
+     * \param orientation orientation of the screen
+     * \param rotation_orientation orientation of the sweep
+     * \param spread specifies the gradient spread type
+     */
+    PainterBrush&
+    sweep_gradient(const reference_counted_ptr<const ColorStopArray> &cs,
+                   const vec2 &p, float theta,
+                   enum PainterEnums::screen_orientation orientation,
+                   enum PainterEnums::rotation_orientation_t rotation_orientation,
+                   float F, enum spread_type_t spread)
+    {
+      float S;
+      bool b1(orientation == PainterEnums::y_increases_upwards);
+      bool b2(rotation_orientation == PainterEnums::counter_clockwise);
+
+      S = (b1 == b2) ? 1.0f : -1.0f;
+      return sweep_gradient(cs, p, theta, S * F, spread);
+    }
+
+    /*!
+     * Sets the brush to have a sweep gradient whose color stops
+     * are packed into the brush data with a repeat factor of 1.0
+     * and where the sign is determined by a
+     * PainterEnums::screen_orientation and a
+     * PainterEnums::rotation_orientation_t. Equivalent to
+     * \code
+     * sweep_gradient(cs, p, theta, orientation, rotation_orientation, 1.0f, repeat);
+     * \endcode
+     * \param cs color stops for gradient. If handle is invalid,
+     *           then sets brush to not have a gradient.
+     * \param p position of gradient
+     * \param theta angle of the sweep gradient, this value
+     *              should be in the range [-PI, PI]
+     * \param orientation orientation of the screen
+     * \param rotation_orientation orientation of the sweep
+     * \param spread specifies the gradient spread type
+     */
+    PainterBrush&
+    sweep_gradient(const reference_counted_ptr<const ColorStopArray> &cs,
+                   const vec2 &p, float theta,
+                   enum PainterEnums::screen_orientation orientation,
+                   enum PainterEnums::rotation_orientation_t rotation_orientation,
+                   enum spread_type_t spread)
+    {
+      return sweep_gradient(cs, p, theta, orientation, rotation_orientation, 1.0f, spread);
+    }
+
     /*!
      * Sets the brush to not have a gradient.
      */
@@ -964,7 +1175,8 @@ namespace fastuidraw
     no_gradient(void)
     {
       m_data.m_cs = reference_counted_ptr<const ColorStopSequenceOnAtlas>();
-      m_data.m_shader_raw &= ~(gradient_type_mask | gradient_spread_type_mask);
+      m_data.m_cs_array = reference_counted_ptr<const ColorStopArray>();
+      m_data.m_shader_raw &= ~gradient_mask;
       return *this;
     }
 
@@ -1270,6 +1482,9 @@ namespace fastuidraw
      *   translation is applied to the brush.
      * - If shader() & \ref transformation_matrix_mask is non-zero, then a
      *   2x2 matrix is applied to the brush.
+     * - If shader() & \ref gradient_packed_color_stops_mask is non-zero,
+     *   then the color stops of the gradient are packed into the brush
+     *   data, see \ref gradient_color_stops_packing.
      */
     uint32_t
     shader(void) const;
@@ -1323,7 +1538,31 @@ namespace fastuidraw
       return m_data.m_cs;
     }
 
+    /*!
+     * Returns the value of the handle to the
+     * ColorStopArray that the brush is set to
+     * use.
+     */
+    const reference_counted_ptr<const ColorStopArray>&
+    color_stop_array(void) const
+    {
+      return m_data.m_cs_array;
+    }
+
   private:
+    void
+    set_packed_gradient_bits(enum gradient_type_t tp, enum spread_type_t spread)
+    {
+      uint32_t gradient_bits;
+
+      gradient_bits = m_data.m_cs_array ?
+        pack_bits(gradient_type_bit0, gradient_type_num_bits, tp)
+        | pack_bits(gradient_spread_type_bit0, spread_type_num_bits, spread)
+        | gradient_packed_color_stops_mask :
+        0u;
+      m_data.m_shader_raw &= ~gradient_mask;
+      m_data.m_shader_raw |= gradient_bits;
+    }
 
     class brush_data
     {
@@ -1348,6 +1587,7 @@ namespace fastuidraw
       reference_counted_ptr<const Image> m_image;
       uvec2 m_image_size, m_image_start;
       reference_counted_ptr<const ColorStopSequenceOnAtlas> m_cs;
+      reference_counted_ptr<const ColorStopArray> m_cs_array;
       vec2 m_grad_start, m_grad_end;
       float m_grad_start_r, m_grad_end_r;
       vec2 m_window_position, m_window_size;
@@ -194,6 +194,25 @@ namespace fastuidraw
     static
     reference_counted_ptr<const StrokingDataSelectorBase>
     stroking_data_selector(bool pixel_arc_stroking_possible);
+
+    /*!
+     * If the passed PainterShaderData::DataBase was made from a
+     * PainterDashedStrokeParams, fetch its dash pattern and dash
+     * offset. This allows one to recover the dash pattern from
+     * the value held by a PainterData, which may have been packed
+     * into a PainterPackedValue. Returns false if the data is
+     * not from a PainterDashedStrokeParams.
+     * \param data data from which to fetch the values
+     * \param out_dash_offset location to which to write the dash offset
+     * \param out_dash_pattern location to which to write the dash pattern;
+     *                         the array remains valid for as long as
+     *                         the data remains alive and unmodified.
+     */
+    static
+    bool
+    dash_pattern_from_data(const PainterShaderData::DataBase *data,
+                           float *out_dash_offset,
+                           c_array<const DashPatternElement> *out_dash_pattern);
   };
 /*! @} */
 
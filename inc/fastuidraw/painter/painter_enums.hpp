@@ -683,6 +683,114 @@ namespace fastuidraw
          * Number of begin_coverage_buffer()/end_coverage_buffer() pairs called
          */
         num_deferred_coverages,
+
+        /*!
+         * Number of times a new PainterDraw was started because
+         * the attribute, index or data store room of the current
+         * PainterDraw was exhausted.
+         */
+        num_draw_breaks_buffer_full,
+
+        /*!
+         * Number of draw breaks added by the PainterBackend
+         * because the item or brush shader group changed.
+         */
+        num_draw_breaks_shader_change,
+
+        /*!
+         * Number of draw breaks added by the PainterBackend
+         * because the blend mode, blend shader group or blend
+         * shader type changed.
+         */
+        num_draw_breaks_blend_change,
+
+        /*!
+         * Number of draw breaks added to execute a
+         * PainterDrawBreakAction, i.e. from Painter::queue_action(),
+         * binding of context images or changing the coverage
+         * buffer read source.
+         */
+        num_draw_breaks_action,
+
+        /*!
+         * CPU time, in microseconds, spent selecting the subsets
+         * and chunks of filled paths, stroked paths and glyph
+         * sequences against the current clipping. Only recorded
+         * if Painter::profiling() is true.
+         */
+        time_select_subsets_us,
+
+        /*!
+         * CPU time, in microseconds, spent in the clip_in_xxx()
+         * and clip_out_xxx() methods of Painter; this includes the
+         * time to pack the occluders of clip-out. Only recorded if
+         * Painter::profiling() is true.
+         */
+        time_clipping_us,
+
+        /*!
+         * CPU time, in microseconds, spent packing attribute, index
+         * and state data into PainterDraw objects. Only recorded if
+         * Painter::profiling() is true.
+         */
+        time_packing_us,
+
+        /*!
+         * CPU time, in microseconds, spent fetching glyph attribute
+         * data of GlyphSequence and GlyphRun objects; this includes
+         * generating glyphs and uploading them to the GlyphAtlas
+         * when they are not yet realized. Only recorded if
+         * Painter::profiling() is true.
+         */
+        time_glyph_fetch_us,
+
+        /*!
+         * CPU time, in microseconds, spent in PainterBackend::on_pre_draw()
+         * and in issuing the PainterDraw objects to the backend; this is
+         * where a backend flushes pending atlas uploads. Only recorded
+         * if Painter::profiling() is true.
+         */
+        time_backend_pre_draw_us,
+
+        /*!
+         * CPU time, in microseconds, spent in PainterBackend::on_post_draw().
+         * Only recorded if Painter::profiling() is true.
+         */
+        time_backend_post_draw_us,
+
+        /*!
+         * Number of Painter::begin_cached_layer() calls that
+         * used content retained from an earlier frame.
+         */
+        num_cached_layer_hits,
+
+        /*!
+         * Number of Painter::clip_out_path() and Painter::clip_in_path()
+         * calls whose occluder was drawn from the chunks cached by
+         * an identical earlier clip, see Painter::max_cached_clip_paths().
+         */
+        num_clip_path_cache_hits,
+
+        /*!
+         * Number of draws sent to the front-to-back opaque
+         * stream, see Painter::front_to_back_opaque().
+         */
+        num_opaque_draws,
+
+        /*!
+         * Number of calls the PainterBackend made to change
+         * graphics API state (binding programs, textures and
+         * buffers, setting blend and other fixed function state)
+         * while issuing draws.
+         */
+        num_backend_state_changes,
+
+        /*!
+         * Number of calls to change graphics API state that
+         * the PainterBackend skipped because the state was
+         * already as requested.
+         */
+        num_backend_state_changes_elided,
       };
 
     /*!
@@ -85,6 +85,26 @@ namespace fastuidraw
     PainterDashedStrokeShaderSet&
     shader(enum PainterEnums::cap_style st, const PainterStrokeShader &sh);
 
+    /*!
+     * Non-dashed stroke shader with which Painter draws the
+     * edges of a path that were split against the dash pattern
+     * on the CPU (see StrokingStyle::m_cpu_dash_segmentation).
+     * The shader is given the PainterDashedStrokeParams data of
+     * the draw, so its stroking_data_selector() and item shaders
+     * must read the stroking parameters from that data. If the
+     * shader has no item shaders, Painter does not split the
+     * edges on the CPU and draws with shader(enum PainterEnums::cap_style) const.
+     */
+    const PainterStrokeShader&
+    cpu_dash_edge_shader(void) const;
+
+    /*!
+     * Set the value returned by cpu_dash_edge_shader(void) const.
+     * \param sh value to use
+     */
+    PainterDashedStrokeShaderSet&
+    cpu_dash_edge_shader(const PainterStrokeShader &sh);
+
   private:
     void *m_d;
   };
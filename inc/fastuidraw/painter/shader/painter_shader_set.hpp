@@ -25,6 +25,7 @@
 #include <fastuidraw/painter/shader/painter_glyph_shader.hpp>
 #include <fastuidraw/painter/shader/painter_blend_shader_set.hpp>
 #include <fastuidraw/painter/shader/painter_dashed_stroke_shader_set.hpp>
+#include <fastuidraw/painter/shader/painter_custom_brush_shader.hpp>
 
 namespace fastuidraw
 {
@@ -140,6 +141,22 @@ namespace fastuidraw
     PainterShaderSet&
     blend_shaders(const PainterBlendShaderSet &sh);
 
+    /*!
+     * Custom brush shader that sums the taps of one pass of a
+     * separable blur, its data is given by a \ref
+     * PainterBlurBrushShaderData value. Used by \ref
+     * PainterEffectBlur to perform each pass in a single draw.
+     */
+    const reference_counted_ptr<PainterCustomBrushShader>&
+    blur_brush_shader(void) const;
+
+    /*!
+     * Set the value returned by blur_brush_shader(void) const.
+     * \param sh value to use
+     */
+    PainterShaderSet&
+    blur_brush_shader(const reference_counted_ptr<PainterCustomBrushShader> &sh);
+
   private:
     void *m_d;
   };
@@ -208,7 +208,11 @@ namespace fastuidraw
 
     /*!
      * Returns the \ref PainterItemShader for a given pass of a given
-     * type of stroking.
+     * type of stroking. A backend that cannot stroke arcs leaves
+     * the shaders for \ref PainterEnums::stroking_method_arc as
+     * nullptr; \ref Painter then strokes a \ref Path with the
+     * linear shaders and does not draw a \ref StrokedPath that
+     * has arcs.
      * \param tp specify to return a shader for arc or linear stroking
      * \param sh spcify which shader to return
      */
@@ -37,7 +37,8 @@ namespace fastuidraw
   public:
     StrokingStyle(void):
       m_cap_style(PainterEnums::square_caps),
-      m_join_style(PainterEnums::miter_clip_joins)
+      m_join_style(PainterEnums::miter_clip_joins),
+      m_cpu_dash_segmentation(false)
     {}
 
     /*!
@@ -61,6 +62,17 @@ namespace fastuidraw
       return *this;
     }
 
+    /*!
+     * Set \ref m_cpu_dash_segmentation to the specified value.
+     * Default value is false.
+     */
+    StrokingStyle&
+    cpu_dash_segmentation(bool v)
+    {
+      m_cpu_dash_segmentation = v;
+      return *this;
+    }
+
     /*!
      * Specifies the what cap-style to use when stroking
      * the path. Default value is PainterEnums::square_caps.
@@ -72,6 +84,21 @@ namespace fastuidraw
      * path. Default value is PainterEnums::miter_clip_joins
      */
     enum PainterEnums::join_style m_join_style;
+
+    /*!
+     * Only affects dashed stroking. If true, instead of having the
+     * dashed stroke shader search the dash pattern per fragment, the
+     * edges of the StrokedPath are split on the CPU into the portions
+     * covered by the dash pattern (see StrokedPath::dashed_edges())
+     * and drawn with PainterDashedStrokeShaderSet::cpu_dash_edge_shader();
+     * joins and the caps of the contours are still drawn with the
+     * dashed shader. This is a good trade-off for long dash patterns.
+     * The value is ignored if the StrokedPath has arcs, if the
+     * shader set has no cpu_dash_edge_shader() or if the item shader
+     * data is not from a PainterDashedStrokeParams. Default value is
+     * false.
+     */
+    bool m_cpu_dash_segmentation;
   };
 /*! @} */
 }
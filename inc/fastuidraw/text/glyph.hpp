@@ -214,6 +214,23 @@ namespace fastuidraw
                enum fastuidraw::PainterEnums::screen_orientation orientation,
                enum fastuidraw::PainterEnums::glyph_layout_type layout) const;
 
+    /*!
+     * Repack only the fields PainterAttribute::m_attrib1 and
+     * PainterAttribute::m_attrib2 of the 4 attributes packed by
+     * pack_glyph(), i.e. the fields that come from attributes().
+     * The values of attributes() change when the Glyph is uploaded
+     * again to the GlyphAtlas, for example after the GlyphAtlas
+     * was cleared by GlyphCache::clear_atlas(); this updates
+     * data packed by pack_glyph() from this same Glyph without
+     * recomputing the positions or the index data.
+     * \param attrib_loc index into dst_attrib to which the data
+     *                   was written by pack_glyph()
+     * \param dst_attrib location of the attributes packed
+     */
+    void
+    repack_glyph_attributes(unsigned int attrib_loc,
+                            c_array<PainterAttribute> dst_attrib) const;
+
     /*!
      * Pack a single glyph into attribute and index data. A
      * single glyph takes exactly 4 attributes and 6 indices.
@@ -185,6 +185,20 @@ namespace fastuidraw
                  c_array<Glyph> out_glyphs,
                  bool upload_to_atlas = true);
 
+    /*!
+     * Upload a sequence of glyphs to the GlyphAtlas, i.e. the
+     * same as calling Glyph::upload_to_atlas() on each of the
+     * glyphs, but the locking of this GlyphCache is done once
+     * for the entire sequence. Glyphs already uploaded are
+     * skipped. Intended to re-upload the glyphs used by derived
+     * data after clear_atlas(), see also Glyph::repack_glyph_attributes().
+     * \param glyphs glyphs to upload; invalid values are ignored
+     * \return routine_fail if a valid Glyph of the sequence is not
+     *         of this GlyphCache or failed to upload
+     */
+    enum return_code
+    upload_to_atlas(c_array<const Glyph> glyphs);
+
     /*!
      * Add a Glyph created with Glyph::create_glyph() to
      * this GlyphCache. Will fail if a Glyph with the
@@ -252,6 +266,93 @@ namespace fastuidraw
     void
     deallocate_data(AllocationHandle h);
 
+    /*!
+     * Set the budget, in number of \ref generic_data values
+     * of the GlyphAtlas, of the glyph data of the glyphs of
+     * this GlyphCache. When the budget is exceeded, begin_frame()
+     * evicts the least recently used glyphs that are not pinned
+     * (see pin_glyphs()) until the usage is within budget. A
+     * value of 0 indicates no budget. Default value is 0.
+     */
+    void
+    atlas_budget(unsigned int v);
+
+    /*!
+     * Returns the value set by atlas_budget(unsigned int).
+     */
+    unsigned int
+    atlas_budget(void) const;
+
+    /*!
+     * Set the budget, in bytes, of the memory on the host
+     * used by the glyphs of this GlyphCache; the memory
+     * use of a glyph is an estimate that includes its
+     * Path. When the budget is exceeded, begin_frame() evicts
+     * the least recently used glyphs that are not pinned
+     * (see pin_glyphs()) until the usage is within budget.
+     * A value of 0 indicates no budget. Default value is 0.
+     */
+    void
+    host_budget(unsigned int v);
+
+    /*!
+     * Returns the value set by host_budget(unsigned int).
+     */
+    unsigned int
+    host_budget(void) const;
+
+    /*!
+     * Returns the number of \ref generic_data values of
+     * the GlyphAtlas used by the glyphs of this GlyphCache.
+     */
+    unsigned int
+    atlas_usage(void) const;
+
+    /*!
+     * Returns the estimate, in bytes, of the memory on the
+     * host used by the glyphs of this GlyphCache.
+     */
+    unsigned int
+    host_usage(void) const;
+
+    /*!
+     * Marks the start of a frame. A Glyph is touched in a frame
+     * when it is fetched or uploaded; if a budget is set (see
+     * atlas_budget() and host_budget()) and it is exceeded, the
+     * glyphs that are not pinned and were not touched in the
+     * frame that just ended are evicted, least recently touched
+     * first, until the usage is within budget. An evicted glyph
+     * is removed as if by delete_glyph(), thus any Glyph value
+     * of an evicted glyph that is not pinned should be discarded.
+     * Note that GlyphMetrics values are never evicted. This is
+     * called by Painter::begin().
+     */
+    void
+    begin_frame(void);
+
+    /*!
+     * Pin glyphs so that they are not evicted by begin_frame();
+     * a glyph is pinned until unpin_glyphs() is called on it as
+     * many times as pin_glyphs() was. \ref GlyphSequence and \ref
+     * GlyphRun pin the glyphs of the attribute data they hold.
+     * A pinned glyph removed by delete_glyph() or clear_cache()
+     * is no longer valid, but its Glyph value is still to be
+     * passed to unpin_glyphs() to release its pins; until then
+     * the storage of the glyph is not reused by the GlyphCache.
+     * \param glyphs glyphs to pin; invalid values and glyphs
+     *               not of this GlyphCache are ignored.
+     */
+    void
+    pin_glyphs(c_array<const Glyph> glyphs);
+
+    /*!
+     * Release a pin of glyphs pinned by pin_glyphs().
+     * \param glyphs glyphs to unpin; invalid values and glyphs
+     *               not of this GlyphCache are ignored.
+     */
+    void
+    unpin_glyphs(c_array<const Glyph> glyphs);
+
   private:
     void *m_d;
   };
@@ -68,6 +68,25 @@ namespace fastuidraw
     enum return_code
     distance_field_max_distance(float v);
 
+    /*!
+     * Pixel size at which to generate multi-channel distance
+     * field scalable glyphs (see \ref GlyphRenderDataMultiChannelDistanceField).
+     * The distances stored are normalized by the value of
+     * distance_field_max_distance(void) const.
+     */
+    unsigned int
+    multi_channel_distance_field_pixel_size(void);
+
+    /*!
+     * Set the value returned by
+     * multi_channel_distance_field_pixel_size(void) const,
+     * initial value is 24. Return \ref routine_success if
+     * value is successfully changed.
+     * \param v value
+     */
+    enum return_code
+    multi_channel_distance_field_pixel_size(unsigned int v);
+
     /*!
      * When generating restricted rays glyph data see (\ref
      * GlyphRenderDataRestrictedRays), specifies the expected
@@ -0,0 +1,124 @@
+/*!
+ * \file glyph_render_data_multi_channel_distance_field.hpp
+ * \brief file glyph_render_data_multi_channel_distance_field.hpp
+ *
+ * Copyright 2019 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#pragma once
+
+#include <fastuidraw/text/glyph_render_data.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Text
+ * @{
+ */
+
+  /*!
+   * \brief
+   * A GlyphRenderDataMultiChannelDistanceField holds the texel
+   * data of a multi-channel distance field glyph. Each texel
+   * has three channels where each channel is a signed distance
+   * to a subset of the curves of the glyph; the subsets are
+   * chosen so that the curves meeting at a corner are not all
+   * in the same channel. The median of the three channels gives
+   * the distance value to use; unlike a single channel distance
+   * field, corners of the glyph stay sharp when the glyph is
+   * rendered magnified, thus a lower resolution suffices.
+   */
+  class GlyphRenderDataMultiChannelDistanceField:public GlyphRenderData
+  {
+  public:
+    /*!
+     * This enumeration describes the meaning of the
+     * attributes.
+     */
+    enum attribute_values_t
+      {
+        /*!
+         * Dimensions of the glyph as packed by
+         * \ref GlyphAttribute::rect_glyph_layout
+         */
+        glyph_size_xy,
+
+        /*!
+         * Location of the texel data within the
+         * \ref GlyphAtlas
+         */
+        glyph_texel_data_offset,
+      };
+
+    /*!
+     * Ctor, initialized the resolution as (0,0).
+     */
+    GlyphRenderDataMultiChannelDistanceField(void);
+
+    ~GlyphRenderDataMultiChannelDistanceField();
+
+    /*!
+     * Returns the resolution of the glyph.
+     */
+    ivec2
+    resolution(void) const;
+
+    /*!
+     * Returns the texel data for rendering.
+     * The texel (x,y) is located at I where I is
+     * given by I = x + y * resolution().x(). Each
+     * channel is an 8-bit value where 0 represents
+     * the distance -max_distance (outside), 255
+     * represents +max_distance (inside) and the
+     * boundary is at the middle.
+     */
+    c_array<const u8vec3>
+    texel_data(void) const;
+
+    /*!
+     * Returns the texel data for rendering.
+     * The texel (x,y) is located at I where I is
+     * given by I = x + y * resolution().x().
+     */
+    c_array<u8vec3>
+    texel_data(void);
+
+    /*!
+     * Change the resolution
+     * \param sz new resolution
+     */
+    void
+    resize(ivec2 sz);
+
+    virtual
+    c_array<const c_string>
+    render_info_labels(void) const;
+
+    /*!
+     * The texel data is packed so that texel (x, y) is
+     * the 32-bit value at offset x + y * resolution().x()
+     * from the location of the data with the channels in
+     * bits [0, 8), [8, 16) and [16, 24).
+     */
+    virtual
+    enum fastuidraw::return_code
+    upload_to_atlas(GlyphAtlasProxy &atlas_proxy,
+                    GlyphAttribute::Array &attributes,
+                    c_array<float> render_costs) const;
+
+  private:
+    void *m_d;
+  };
+/*! @} */
+}
@@ -58,6 +58,13 @@ namespace fastuidraw
        */
       banded_rays_glyph,
 
+      /*!
+       * Glyph is a multi-channel distance field glyph,
+       * generated from a GlyphRenderDataMultiChannelDistanceField.
+       * Glyph is scalable.
+       */
+      multi_channel_distance_field_glyph,
+
       /*!
        * Tag to indicate invalid glyph type; the value is much
        * larger than the last glyph type to allow for later ABI
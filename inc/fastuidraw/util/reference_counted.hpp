@@ -19,7 +19,7 @@
 
 #pragma once
 
-
+#include <type_traits>
 #include <fastuidraw/util/util.hpp>
 #include <fastuidraw/util/fastuidraw_memory.hpp>
 
@@ -99,10 +99,13 @@ namespace fastuidraw
     /*!
      * Ctor from a reference_counted_ptr<U> where U* is
      * implicitely convertible to a T*.
+     * The ctor only participates in overload resolution if
+     * U* is implicitely convertible to a T*.
      * \tparam U type where U* is implicitely convertible to a T*.
      * \param obj value from which to initialize
      */
-    template<typename U>
+    template<typename U,
+             typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
     reference_counted_ptr(const reference_counted_ptr<U> &obj):
       m_p(obj.get())
     {
@@ -0,0 +1,115 @@
+/*!
+ * \file trace_events.hpp
+ * \brief file trace_events.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <ostream>
+#include <fastuidraw/util/util.hpp>
+
+namespace fastuidraw
+{
+/*!\addtogroup Utility
+ * @{
+ */
+
+  /*!
+   * \brief
+   * TraceEvents records timed, named events from the internals
+   * of FastUIDraw (Painter, PainterPacker, GlyphCache, ImageAtlas
+   * and the GL backend) so that a frame's timeline can be
+   * inspected with chrome://tracing or Perfetto.
+   *
+   * Each thread that emits events writes them to its own fixed
+   * size ring buffer; recording an event never takes a lock.
+   * When a ring buffer is full, the oldest events of that thread
+   * are overwritten. Recording is off by default; when off, a
+   * \ref Scope costs a single relaxed atomic load.
+   */
+  class TraceEvents
+  {
+  public:
+    enum
+      {
+        /*!
+         * Number of events each thread's ring buffer holds.
+         */
+        events_per_thread = 16384
+      };
+
+    /*!
+     * \brief
+     * A Scope records an event whose duration is the
+     * lifetime of the Scope.
+     */
+    class Scope:noncopyable
+    {
+    public:
+      /*!
+       * Ctor.
+       * \param category category of the event, the string must
+       *                 remain valid until the events are cleared
+       *                 (typically a string literal)
+       * \param name name of the event, the string must remain
+       *             valid until the events are cleared (typically
+       *             a string literal)
+       */
+      Scope(c_string category, c_string name);
+
+      ~Scope();
+
+    private:
+      c_string m_category, m_name;
+      uint64_t m_start;
+      bool m_active;
+    };
+
+    /*!
+     * Set if events are recorded. Default value is false.
+     */
+    static
+    void
+    enabled(bool v);
+
+    /*!
+     * Returns true if events are recorded.
+     */
+    static
+    bool
+    enabled(void);
+
+    /*!
+     * Discard all events recorded so far. Should only be called
+     * when no other thread is recording events.
+     */
+    static
+    void
+    clear(void);
+
+    /*!
+     * Write the recorded events as a JSON object in the Chrome
+     * trace event format. Events that are overwritten by their
+     * thread while writing are skipped.
+     * \param dst stream to which to write
+     */
+    static
+    void
+    write_chrome_trace(std::ostream &dst);
+  };
+
+/*! @} */
+}
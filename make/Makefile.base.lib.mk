@@ -1,5 +1,5 @@
-FASTUIDRAW_DEPS_LIBS += $(shell pkg-config freetype2 --libs)
-FASTUIDRAW_DEPS_STATIC_LIBS += $(shell pkg-config freetype2 --static --libs)
+FASTUIDRAW_DEPS_LIBS += $(shell pkg-config freetype2 --libs) -lpthread
+FASTUIDRAW_DEPS_STATIC_LIBS += $(shell pkg-config freetype2 --static --libs) -lpthread
 
 FASTUIDRAW_BASE_CFLAGS = -std=c++11
 FASTUIDRAW_debug_BASE_CFLAGS = $(FASTUIDRAW_BASE_CFLAGS) -DFASTUIDRAW_DEBUG
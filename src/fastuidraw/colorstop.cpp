@@ -42,6 +42,20 @@ namespace
     std::vector<fastuidraw::ColorStop> m_values;
     bool m_dirty;
   };
+
+  class ColorStopArrayPrivate
+  {
+  public:
+    explicit
+    ColorStopArrayPrivate(fastuidraw::c_array<const fastuidraw::ColorStop> values):
+      m_values(values.begin(), values.end())
+    {
+      FASTUIDRAWassert(!m_values.empty());
+      std::stable_sort(m_values.begin(), m_values.end());
+    }
+
+    std::vector<fastuidraw::ColorStop> m_values;
+  };
 }
 
 
@@ -98,3 +112,33 @@ values(void) const
     }
   return make_c_array(d->m_values);
 }
+
+///////////////////////////////////////
+// fastuidraw::ColorStopArray methods
+fastuidraw::ColorStopArray::
+ColorStopArray(const ColorStopSequence &color_stops):
+  m_d(FASTUIDRAWnew ColorStopArrayPrivate(color_stops.values()))
+{}
+
+fastuidraw::ColorStopArray::
+ColorStopArray(c_array<const ColorStop> color_stops):
+  m_d(FASTUIDRAWnew ColorStopArrayPrivate(color_stops))
+{}
+
+fastuidraw::ColorStopArray::
+~ColorStopArray()
+{
+  ColorStopArrayPrivate *d;
+  d = static_cast<ColorStopArrayPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+fastuidraw::c_array<const fastuidraw::ColorStop>
+fastuidraw::ColorStopArray::
+values(void) const
+{
+  ColorStopArrayPrivate *d;
+  d = static_cast<ColorStopArrayPrivate*>(m_d);
+  return make_c_array(d->m_values);
+}
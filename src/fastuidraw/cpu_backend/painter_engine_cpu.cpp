@@ -0,0 +1,171 @@
+/*!
+ * \file painter_engine_cpu.cpp
+ * \brief file painter_engine_cpu.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <fastuidraw/cpu_backend/painter_engine_cpu.hpp>
+#include <fastuidraw/cpu_backend/painter_surface_cpu.hpp>
+
+#include <private/util_private.hpp>
+#include <private/cpu_backend/atlases_cpu.hpp>
+#include <private/cpu_backend/backend_shaders_cpu.hpp>
+#include <private/cpu_backend/painter_backend_cpu.hpp>
+#include <private/cpu_backend/painter_shader_registrar_cpu.hpp>
+
+namespace
+{
+  class ConfigurationCPUPrivate
+  {
+  public:
+    ConfigurationCPUPrivate(void):
+      m_number_threads(0),
+      m_tile_size(64),
+      m_attributes_per_buffer(512 * 512),
+      m_indices_per_buffer((m_attributes_per_buffer * 6) / 4),
+      m_data_blocks_per_store_buffer(1024 * 64),
+      m_glyph_atlas_size(1024 * 1024),
+      m_log2_color_tile_size(5),
+      m_log2_index_tile_size(2),
+      m_colorstop_atlas_width(1024)
+    {}
+
+    unsigned int m_number_threads;
+    unsigned int m_tile_size;
+    unsigned int m_attributes_per_buffer;
+    unsigned int m_indices_per_buffer;
+    unsigned int m_data_blocks_per_store_buffer;
+    unsigned int m_glyph_atlas_size;
+    int m_log2_color_tile_size;
+    int m_log2_index_tile_size;
+    int m_colorstop_atlas_width;
+  };
+
+  class PainterEngineCPUPrivate
+  {
+  public:
+    explicit
+    PainterEngineCPUPrivate(const fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU &config):
+      m_config(config)
+    {}
+
+    fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU m_config;
+  };
+}
+
+//////////////////////////////////////////////////
+// fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU methods
+fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU::
+ConfigurationCPU(void)
+{
+  m_d = FASTUIDRAWnew ConfigurationCPUPrivate();
+}
+
+fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU::
+ConfigurationCPU(const ConfigurationCPU &obj)
+{
+  ConfigurationCPUPrivate *d;
+  d = static_cast<ConfigurationCPUPrivate*>(obj.m_d);
+  m_d = FASTUIDRAWnew ConfigurationCPUPrivate(*d);
+}
+
+fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU::
+~ConfigurationCPU()
+{
+  ConfigurationCPUPrivate *d;
+  d = static_cast<ConfigurationCPUPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+assign_swap_implement(fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU)
+setget_implement(fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU, ConfigurationCPUPrivate,
+                 unsigned int, number_threads)
+setget_implement(fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU, ConfigurationCPUPrivate,
+                 unsigned int, tile_size)
+setget_implement(fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU, ConfigurationCPUPrivate,
+                 unsigned int, attributes_per_buffer)
+setget_implement(fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU, ConfigurationCPUPrivate,
+                 unsigned int, indices_per_buffer)
+setget_implement(fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU, ConfigurationCPUPrivate,
+                 unsigned int, data_blocks_per_store_buffer)
+setget_implement(fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU, ConfigurationCPUPrivate,
+                 unsigned int, glyph_atlas_size)
+setget_implement(fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU, ConfigurationCPUPrivate,
+                 int, log2_color_tile_size)
+setget_implement(fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU, ConfigurationCPUPrivate,
+                 int, log2_index_tile_size)
+setget_implement(fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU, ConfigurationCPUPrivate,
+                 int, colorstop_atlas_width)
+
+///////////////////////////////////////////////////
+// fastuidraw::cpu::PainterEngineCPU methods
+fastuidraw::reference_counted_ptr<fastuidraw::cpu::PainterEngineCPU>
+fastuidraw::cpu::PainterEngineCPU::
+create(const ConfigurationCPU &config)
+{
+  PainterShaderSet shaders;
+
+  shaders = detail::ShaderSetCreator().create_shader_set();
+  return FASTUIDRAWnew PainterEngineCPU(config, shaders);
+}
+
+fastuidraw::cpu::PainterEngineCPU::
+PainterEngineCPU(const ConfigurationCPU &config,
+                 const PainterShaderSet &shaders):
+  PainterEngine(FASTUIDRAWnew detail::GlyphAtlasCPU(config.glyph_atlas_size()),
+                FASTUIDRAWnew detail::ImageAtlasCPU(config),
+                FASTUIDRAWnew detail::ColorStopAtlasCPU(config.colorstop_atlas_width()),
+                FASTUIDRAWnew detail::PainterShaderRegistrarCPU(),
+                ConfigurationBase()
+                .supports_bindless_texturing(true),
+                shaders)
+{
+  m_d = FASTUIDRAWnew PainterEngineCPUPrivate(config);
+}
+
+fastuidraw::cpu::PainterEngineCPU::
+~PainterEngineCPU()
+{
+  PainterEngineCPUPrivate *d;
+  d = static_cast<PainterEngineCPUPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+}
+
+const fastuidraw::cpu::PainterEngineCPU::ConfigurationCPU&
+fastuidraw::cpu::PainterEngineCPU::
+configuration_cpu(void) const
+{
+  PainterEngineCPUPrivate *d;
+  d = static_cast<PainterEngineCPUPrivate*>(m_d);
+  return d->m_config;
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::PainterBackend>
+fastuidraw::cpu::PainterEngineCPU::
+create_backend(void) const
+{
+  return FASTUIDRAWnew detail::PainterBackendCPU(this);
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::PainterSurface>
+fastuidraw::cpu::PainterEngineCPU::
+create_surface(ivec2 dims,
+               enum PainterSurface::render_type_t render_type)
+{
+  reference_counted_ptr<PainterSurface> S;
+  S = FASTUIDRAWnew PainterSurfaceCPU(dims, render_type);
+  return S;
+}
@@ -0,0 +1,107 @@
+/*!
+ * \file painter_surface_cpu.cpp
+ * \brief file painter_surface_cpu.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <algorithm>
+#include <fastuidraw/cpu_backend/painter_surface_cpu.hpp>
+#include <private/util_private.hpp>
+#include <private/cpu_backend/painter_surface_cpu_private.hpp>
+
+///////////////////////////////////////////////
+// fastuidraw::cpu::PainterSurfaceCPU methods
+fastuidraw::cpu::PainterSurfaceCPU::
+PainterSurfaceCPU(ivec2 dims, enum render_type_t render_type)
+{
+  m_d = FASTUIDRAWnew detail::PainterSurfaceCPUPrivate(render_type, dims);
+}
+
+fastuidraw::cpu::PainterSurfaceCPU::
+~PainterSurfaceCPU()
+{
+  detail::PainterSurfaceCPUPrivate *d;
+  d = static_cast<detail::PainterSurfaceCPUPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+}
+
+fastuidraw::c_array<const fastuidraw::u8vec4>
+fastuidraw::cpu::PainterSurfaceCPU::
+pixels(void) const
+{
+  detail::PainterSurfaceCPUPrivate *d;
+  d = static_cast<detail::PainterSurfaceCPUPrivate*>(m_d);
+  return make_c_array(d->m_color->m_texels);
+}
+
+void
+fastuidraw::cpu::PainterSurfaceCPU::
+read_pixels_top_down(c_array<u8vec4> dst) const
+{
+  detail::PainterSurfaceCPUPrivate *d;
+  d = static_cast<detail::PainterSurfaceCPUPrivate*>(m_d);
+
+  int w(d->m_dimensions.x()), h(d->m_dimensions.y());
+  FASTUIDRAWassert(dst.size() >= static_cast<unsigned int>(w * h));
+  for (int y = 0; y < h; ++y)
+    {
+      std::copy(d->m_color->m_texels.begin() + y * w,
+                d->m_color->m_texels.begin() + (y + 1) * w,
+                dst.begin() + (h - 1 - y) * w);
+    }
+}
+
+fastuidraw::reference_counted_ptr<const fastuidraw::Image>
+fastuidraw::cpu::PainterSurfaceCPU::
+image(ImageAtlas &atlas) const
+{
+  detail::PainterSurfaceCPUPrivate *d;
+  d = static_cast<detail::PainterSurfaceCPUPrivate*>(m_d);
+  return d->image(atlas);
+}
+
+void
+fastuidraw::cpu::PainterSurfaceCPU::
+viewport(const Viewport &vwp)
+{
+  detail::PainterSurfaceCPUPrivate *d;
+  d = static_cast<detail::PainterSurfaceCPUPrivate*>(m_d);
+  d->m_viewport = vwp;
+}
+
+void
+fastuidraw::cpu::PainterSurfaceCPU::
+clear_color(const vec4 &c)
+{
+  detail::PainterSurfaceCPUPrivate *d;
+  d = static_cast<detail::PainterSurfaceCPUPrivate*>(m_d);
+  d->m_clear_color = c;
+}
+
+get_implement(fastuidraw::cpu::PainterSurfaceCPU,
+              fastuidraw::cpu::detail::PainterSurfaceCPUPrivate,
+              fastuidraw::ivec2, dimensions)
+
+get_implement(fastuidraw::cpu::PainterSurfaceCPU,
+              fastuidraw::cpu::detail::PainterSurfaceCPUPrivate,
+              const fastuidraw::PainterSurface::Viewport&, viewport)
+
+get_implement(fastuidraw::cpu::PainterSurfaceCPU,
+              fastuidraw::cpu::detail::PainterSurfaceCPUPrivate,
+              const fastuidraw::vec4&, clear_color)
+
+get_implement(fastuidraw::cpu::PainterSurfaceCPU,
+              fastuidraw::cpu::detail::PainterSurfaceCPUPrivate,
+              enum fastuidraw::PainterSurface::render_type_t, render_type)
@@ -36,6 +36,7 @@
 #include <private/gl_backend/painter_surface_gl_private.hpp>
 #include <private/gl_backend/painter_shader_registrar_gl.hpp>
 #include <private/gl_backend/binding_points.hpp>
+#include <private/gl_backend/context_worker_gl.hpp>
 
 namespace
 {
@@ -114,9 +115,23 @@ namespace
       m_fbf_blending_type(fastuidraw::glsl::PainterShaderRegistrarGLSL::fbf_blending_not_supported),
       m_allow_bindless_texture_from_surface(true),
       m_support_dual_src_blend_shaders(true),
-      m_use_uber_item_shader(true)
+      m_use_uber_item_shader(true),
+      m_use_multi_draw_indirect(true)
     {}
 
+    /* the worker shared by the atlases, created on
+     * demand if there is an upload context.
+     */
+    const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL>&
+    worker(void)
+    {
+      if (!m_worker && m_upload_context)
+        {
+          m_worker = FASTUIDRAWnew fastuidraw::gl::detail::ContextWorkerGL(m_upload_context);
+        }
+      return m_worker;
+    }
+
     unsigned int m_attributes_per_buffer;
     unsigned int m_indices_per_buffer;
     unsigned int m_data_blocks_per_store_buffer;
@@ -137,6 +152,7 @@ namespace
     bool m_allow_bindless_texture_from_surface;
     bool m_support_dual_src_blend_shaders;
     bool m_use_uber_item_shader;
+    bool m_use_multi_draw_indirect;
 
     std::string m_glsl_version_override;
     fastuidraw::gl::PainterEngineGL::ImageAtlasParams m_image_atlas_params;
@@ -146,6 +162,9 @@ namespace
     fastuidraw::reference_counted_ptr<fastuidraw::ImageAtlas> m_image_atlas;
     fastuidraw::reference_counted_ptr<fastuidraw::ColorStopAtlas> m_colorstop_atlas;
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlas> m_glyph_atlas;
+
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::PainterEngineGL::UploadContext> m_upload_context;
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> m_worker;
   };
 
   class PainterEngineGLPrivate
@@ -164,6 +183,8 @@ namespace
       m_binding_points.m_colorstop_atlas_binding = m_reg_gl->uber_shader_builder_params().colorstop_atlas_binding();
       m_binding_points.m_image_atlas_color_tiles_nearest_binding = m_reg_gl->uber_shader_builder_params().image_atlas_color_tiles_nearest_binding();
       m_binding_points.m_image_atlas_color_tiles_linear_binding = m_reg_gl->uber_shader_builder_params().image_atlas_color_tiles_linear_binding();
+      m_binding_points.m_image_atlas_color_tiles_r8_binding = m_reg_gl->uber_shader_builder_params().image_atlas_color_tiles_r8_binding();
+      m_binding_points.m_image_atlas_color_tiles_rg8_binding = m_reg_gl->uber_shader_builder_params().image_atlas_color_tiles_rg8_binding();
       m_binding_points.m_image_atlas_index_tiles_binding = m_reg_gl->uber_shader_builder_params().image_atlas_index_tiles_binding();
       m_binding_points.m_glyph_atlas_store_binding = m_reg_gl->uber_shader_builder_params().glyph_atlas_store_binding();
       m_binding_points.m_glyph_atlas_store_binding_fp16 = m_reg_gl->uber_shader_builder_params().glyph_atlas_store_binding_fp16x2();
@@ -670,6 +691,12 @@ configure_from_context(bool choose_optimal_rendering_quality,
    */
   d->m_separate_program_for_discard = true;
 
+  /* Let the driver read the draw lists from a buffer
+   * whenever the context can; adjust_for_context()
+   * turns it off if it cannot.
+   */
+  d->m_use_multi_draw_indirect = true;
+
   /* Adjust blending type from GL context properties */
   d->m_fbf_blending_type =
     compute_fbf_blending_type(interlock_type, fbf_blending_framebuffer_fetch, ctx);
@@ -886,6 +913,10 @@ adjust_for_context(const ContextProperties &ctx)
            */
           d->m_assign_binding_points = false;
         }
+
+      d->m_use_multi_draw_indirect = d->m_use_multi_draw_indirect
+        && ctx.version() >= ivec2(3, 1)
+        && ctx.has_extension("GL_EXT_multi_draw_indirect");
     }
   #else
     {
@@ -897,6 +928,12 @@ adjust_for_context(const ContextProperties &ctx)
           d->m_assign_binding_points = d->m_assign_binding_points
             && ctx.has_extension("GL_ARB_shading_language_420pack");
         }
+
+      if (ctx.version() < ivec2(4, 3))
+        {
+          d->m_use_multi_draw_indirect = d->m_use_multi_draw_indirect
+            && ctx.has_extension("GL_ARB_multi_draw_indirect");
+        }
     }
   #endif
 
@@ -912,12 +949,14 @@ adjust_for_context(const ContextProperties &ctx)
    *   - colorStopAtlas
    *   - imageAtlasLinear
    *   - imageAtlasNearest
+   *   - imageAtlasR8
+   *   - imageAtlasRG8
    *   - imageAtlasIndex
    *   - deferredCoverageBuffer
    *   - glyphAtlas
    *   - glyphAtlasFP16x2
    */
-  num_textures_used += 7;
+  num_textures_used += 9;
 
   /* adjust m_number_external_textures taking
    * into account the number of used texture
@@ -983,7 +1022,7 @@ image_atlas(void) const
 
   if (!d->m_image_atlas)
     {
-      d->m_image_atlas = FASTUIDRAWnew detail::ImageAtlasGL(d->m_image_atlas_params);
+      d->m_image_atlas = FASTUIDRAWnew detail::ImageAtlasGL(d->m_image_atlas_params, d->worker());
     }
   return d->m_image_atlas;
 }
@@ -997,7 +1036,7 @@ glyph_atlas(void) const
 
   if (!d->m_glyph_atlas)
     {
-      d->m_glyph_atlas = FASTUIDRAWnew detail::GlyphAtlasGL(d->m_glyph_atlas_params);
+      d->m_glyph_atlas = FASTUIDRAWnew detail::GlyphAtlasGL(d->m_glyph_atlas_params, d->worker());
     }
   return d->m_glyph_atlas;
 }
@@ -1011,12 +1050,39 @@ colorstop_atlas(void) const
 
   if (!d->m_colorstop_atlas)
     {
-      d->m_colorstop_atlas = FASTUIDRAWnew detail::ColorStopAtlasGL(d->m_colorstop_atlas_params);
+      d->m_colorstop_atlas = FASTUIDRAWnew detail::ColorStopAtlasGL(d->m_colorstop_atlas_params, d->worker());
     }
 
   return d->m_colorstop_atlas;
 }
 
+const fastuidraw::reference_counted_ptr<fastuidraw::gl::PainterEngineGL::UploadContext>&
+fastuidraw::gl::PainterEngineGL::ConfigurationGL::
+upload_context(void) const
+{
+  ConfigurationGLPrivate *d;
+  d = static_cast<ConfigurationGLPrivate*>(m_d);
+  return d->m_upload_context;
+}
+
+fastuidraw::gl::PainterEngineGL::ConfigurationGL&
+fastuidraw::gl::PainterEngineGL::ConfigurationGL::
+upload_context(const reference_counted_ptr<UploadContext> &v)
+{
+  ConfigurationGLPrivate *d;
+  d = static_cast<ConfigurationGLPrivate*>(m_d);
+
+  if (d->m_upload_context != v)
+    {
+      d->m_upload_context = v;
+      d->m_worker = nullptr;
+      d->m_image_atlas = nullptr;
+      d->m_glyph_atlas = nullptr;
+      d->m_colorstop_atlas = nullptr;
+    }
+  return *this;
+}
+
 assign_swap_implement(fastuidraw::gl::PainterEngineGL::ConfigurationGL)
 
 setget_implement(fastuidraw::gl::PainterEngineGL::ConfigurationGL, ConfigurationGLPrivate,
@@ -1059,6 +1125,8 @@ setget_implement(fastuidraw::gl::PainterEngineGL::ConfigurationGL, Configuration
                  bool, support_dual_src_blend_shaders)
 setget_implement(fastuidraw::gl::PainterEngineGL::ConfigurationGL, ConfigurationGLPrivate,
                  bool, use_uber_item_shader)
+setget_implement(fastuidraw::gl::PainterEngineGL::ConfigurationGL, ConfigurationGLPrivate,
+                 bool, use_multi_draw_indirect)
 get_implement(fastuidraw::gl::PainterEngineGL::ConfigurationGL, ConfigurationGLPrivate,
               const fastuidraw::gl::PainterEngineGL::ImageAtlasParams&, image_atlas_params)
 get_implement(fastuidraw::gl::PainterEngineGL::ConfigurationGL, ConfigurationGLPrivate,
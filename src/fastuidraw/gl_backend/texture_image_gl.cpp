@@ -20,12 +20,28 @@
 
 #include <fastuidraw/gl_backend/ngl_header.hpp>
 #include <fastuidraw/gl_backend/gl_get.hpp>
+#include <fastuidraw/gl_backend/gl_context_properties.hpp>
 #include <fastuidraw/gl_backend/texture_image_gl.hpp>
 
 #include <private/gl_backend/texture_gl.hpp>
 #include <private/gl_backend/bindless.hpp>
 #include <private/util_private.hpp>
 
+/* the S3TC formats are from an extension whose
+ * tokens the core GL headers do not define.
+ */
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#endif
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 namespace
 {
   class TextureImagePrivate
@@ -100,6 +116,120 @@ namespace
 
     GLuint64 m_handle;
   };
+
+  /* Images of the one and two channel formats are stored
+   * in GL_R8 and GL_RG8 textures holding the channels that
+   * the fastuidraw::Image::format_t takes from the texels
+   * of the source.
+   */
+  class TextureFormat
+  {
+  public:
+    explicit
+    TextureFormat(enum fastuidraw::Image::format_t fmt):
+      m_channels(0, 0)
+    {
+      switch (fmt)
+        {
+        case fastuidraw::Image::alpha_format:
+          m_internal_format = GL_R8;
+          m_external_format = GL_RED;
+          m_channels[0] = 3;
+          m_num_channels = 1;
+          break;
+
+        case fastuidraw::Image::luminance_format:
+          m_internal_format = GL_R8;
+          m_external_format = GL_RED;
+          m_channels[0] = 0;
+          m_num_channels = 1;
+          break;
+
+        case fastuidraw::Image::luminance_alpha_format:
+          m_internal_format = GL_RG8;
+          m_external_format = GL_RG;
+          m_channels[0] = 0;
+          m_channels[1] = 3;
+          m_num_channels = 2;
+          break;
+
+        default:
+          m_internal_format = GL_RGBA8;
+          m_external_format = GL_RGBA;
+          m_num_channels = 4;
+        }
+    }
+
+    /* packs the texels in place to the channels of the texture */
+    const void*
+    pack(fastuidraw::c_array<fastuidraw::u8vec4> texels) const
+    {
+      if (m_num_channels != 4)
+        {
+          fastuidraw::c_array<uint8_t> dst;
+
+          dst = texels.reinterpret_pointer<uint8_t>();
+          for (unsigned int i = 0, d = 0; i < texels.size(); ++i)
+            {
+              fastuidraw::u8vec4 v(texels[i]);
+              for (unsigned int c = 0; c < m_num_channels; ++c, ++d)
+                {
+                  dst[d] = v[m_channels[c]];
+                }
+            }
+        }
+      return texels.c_ptr();
+    }
+
+    GLenum m_internal_format, m_external_format;
+
+  private:
+    fastuidraw::uvec2 m_channels;
+    unsigned int m_num_channels;
+  };
+
+  /* Gives the GL internal format for each of the
+   * fastuidraw::ImageSourceBase::compression_t values
+   * that the GL context can sample from; unsupported
+   * compressions have the value 0.
+   */
+  class CompressedFormats
+  {
+  public:
+    CompressedFormats(void):
+      m_formats(0)
+    {
+      fastuidraw::gl::ContextProperties ctx;
+      bool s3tc, etc2;
+
+      s3tc = ctx.has_extension("GL_EXT_texture_compression_s3tc");
+      etc2 = (ctx.is_es()) ?
+        ctx.version() >= fastuidraw::ivec2(3, 0) :
+        ctx.version() >= fastuidraw::ivec2(4, 3) || ctx.has_extension("GL_ARB_ES3_compatibility");
+
+      if (s3tc)
+        {
+          m_formats[fastuidraw::ImageSourceBase::bc1_compression] = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+          m_formats[fastuidraw::ImageSourceBase::bc2_compression] = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+          m_formats[fastuidraw::ImageSourceBase::bc3_compression] = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        }
+
+      if (etc2)
+        {
+          m_formats[fastuidraw::ImageSourceBase::etc2_rgb8_compression] = GL_COMPRESSED_RGB8_ETC2;
+          m_formats[fastuidraw::ImageSourceBase::etc2_rgba8_compression] = GL_COMPRESSED_RGBA8_ETC2_EAC;
+        }
+    }
+
+    GLenum
+    internal_format(enum fastuidraw::ImageSourceBase::compression_t c) const
+    {
+      return (c < m_formats.size()) ? m_formats[c] : 0;
+    }
+
+  private:
+    fastuidraw::vecN<GLenum, fastuidraw::ImageSourceBase::etc2_rgba8_compression + 1> m_formats;
+  };
 }
 
 //////////////////////////////////////////////////////
@@ -163,8 +293,10 @@ create(ImageAtlas &patlas, int pw, int ph,
        bool allow_bindless)
 {
   static detail::UseTexStorage use_tex_storage;
+  static CompressedFormats compressed_formats;
   GLuint tex(0);
   int m(image_data.number_levels()), w(pw), h(ph);
+  GLenum compressed_format;
 
   if (w <= 0 || h <= 0 || m <= 0)
     {
@@ -172,8 +304,17 @@ create(ImageAtlas &patlas, int pw, int ph,
       return nullptr;
     }
 
+  compressed_format = compressed_formats.internal_format(image_data.compression());
+  if (compressed_format != 0)
+    {
+      return create_compressed(patlas, pw, ph, image_data, compressed_format,
+                               tex_magnification, tex_minification,
+                               allow_bindless);
+    }
+
   std::vector<fastuidraw::u8vec4> data_storage(w * h);
   fastuidraw::c_array<fastuidraw::u8vec4> data(make_c_array(data_storage));
+  TextureFormat texture_format(image_data.format());
 
   /* SIGHS. We first upload the texture data then allow for the potential
    * creation of the bindless handle. We do this because some GL drivers
@@ -186,32 +327,88 @@ create(ImageAtlas &patlas, int pw, int ph,
   fastuidraw_glGenTextures(1, &tex);
   FASTUIDRAWassert(tex != 0u);
   fastuidraw_glBindTexture(GL_TEXTURE_2D, tex);
-  detail::tex_storage<GL_TEXTURE_2D>(use_tex_storage, GL_RGBA8, ivec2(w, h), m);
+  detail::tex_storage<GL_TEXTURE_2D>(use_tex_storage, texture_format.m_internal_format, ivec2(w, h), m);
   fastuidraw_glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, tex_magnification);
   fastuidraw_glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, tex_minification);
   fastuidraw_glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m - 1);
 
   fastuidraw_glBindTexture(GL_TEXTURE_2D, tex);
+  fastuidraw_glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
   for (int l = 0; l < m && w > 0 && h > 0; ++l, w /= 2, h /= 2)
     {
+      fastuidraw::c_array<fastuidraw::u8vec4> level_data;
+
+      level_data = data.sub_array(0, fastuidraw::t_max(w, 1) * fastuidraw::t_max(h, 1));
       image_data.fetch_texels(l,
                               fastuidraw::ivec2(0, 0),
                               fastuidraw::t_max(w, 1),
                               fastuidraw::t_max(h, 1),
-                              data);
+                              level_data);
 
       fastuidraw_glTexSubImage2D(GL_TEXTURE_2D, l,
                                  0, 0,
                                  fastuidraw::t_max(w, 1),
                                  fastuidraw::t_max(h, 1),
-                                 GL_RGBA, GL_UNSIGNED_BYTE,
-                                 data.c_ptr());
+                                 texture_format.m_external_format, GL_UNSIGNED_BYTE,
+                                 texture_format.pack(level_data));
     }
   fastuidraw_glBindTexture(GL_TEXTURE_2D, 0);
 
   return create(patlas, pw, ph, m, tex, true, image_data.format(), allow_bindless);
 }
 
+fastuidraw::reference_counted_ptr<fastuidraw::gl::TextureImage>
+fastuidraw::gl::TextureImage::
+create_compressed(ImageAtlas &patlas, int w, int h,
+                  const ImageSourceBase &image_data,
+                  GLenum compressed_format,
+                  GLenum tex_magnification, GLenum tex_minification,
+                  bool allow_bindless)
+{
+  static detail::UseTexStorage use_tex_storage;
+  GLuint tex(0);
+  int m(image_data.number_levels());
+  unsigned int block_size;
+
+  block_size = ImageSourceBase::compressed_block_size(image_data.compression());
+  fastuidraw_glGenTextures(1, &tex);
+  FASTUIDRAWassert(tex != 0u);
+  fastuidraw_glBindTexture(GL_TEXTURE_2D, tex);
+  if (use_tex_storage)
+    {
+      fastuidraw_glTexStorage2D(GL_TEXTURE_2D, m, compressed_format, w, h);
+    }
+  fastuidraw_glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, tex_magnification);
+  fastuidraw_glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, tex_minification);
+  fastuidraw_glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m - 1);
+
+  /* the blocks go to GL as they are, the texels are
+   * never decompressed.
+   */
+  for (int l = 0; l < m; ++l)
+    {
+      int lw(t_max(1, w >> l)), lh(t_max(1, h >> l));
+      c_array<const uint8_t> blocks(image_data.compressed_blocks(l));
+      GLsizei sz;
+
+      sz = block_size * ((lw + 3) / 4) * ((lh + 3) / 4);
+      FASTUIDRAWassert(blocks.size() >= unsigned(sz));
+      if (use_tex_storage)
+        {
+          fastuidraw_glCompressedTexSubImage2D(GL_TEXTURE_2D, l, 0, 0, lw, lh,
+                                               compressed_format, sz, blocks.c_ptr());
+        }
+      else
+        {
+          fastuidraw_glCompressedTexImage2D(GL_TEXTURE_2D, l, compressed_format,
+                                            lw, lh, 0, sz, blocks.c_ptr());
+        }
+    }
+  fastuidraw_glBindTexture(GL_TEXTURE_2D, 0);
+
+  return create(patlas, w, h, m, tex, true, image_data.format(), allow_bindless);
+}
+
 fastuidraw::gl::TextureImage::
 TextureImage(ImageAtlas &patlas, int w, int h, unsigned int m,
              bool object_owns_texture, GLuint texture,
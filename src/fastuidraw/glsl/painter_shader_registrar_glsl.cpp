@@ -21,6 +21,7 @@
 #include <algorithm>
 
 #include <fastuidraw/glsl/painter_shader_registrar_glsl.hpp>
+#include <fastuidraw/image_atlas.hpp>
 #include <fastuidraw/painter/painter_brush.hpp>
 #include <fastuidraw/painter/painter_shader_data.hpp>
 #include <fastuidraw/painter/painter_dashed_stroke_params.hpp>
@@ -102,6 +103,8 @@ namespace
       m_colorstop_atlas_binding(-1),
       m_image_atlas_color_tiles_nearest_binding(-1),
       m_image_atlas_color_tiles_linear_binding(-1),
+      m_image_atlas_color_tiles_r8_binding(-1),
+      m_image_atlas_color_tiles_rg8_binding(-1),
       m_image_atlas_index_tiles_binding(-1),
       m_glyph_atlas_store_binding(-1),
       m_glyph_atlas_store_binding_fp16x2(-1),
@@ -140,6 +143,8 @@ namespace
     int m_colorstop_atlas_binding;
     int m_image_atlas_color_tiles_nearest_binding;
     int m_image_atlas_color_tiles_linear_binding;
+    int m_image_atlas_color_tiles_r8_binding;
+    int m_image_atlas_color_tiles_rg8_binding;
     int m_image_atlas_index_tiles_binding;
     int m_glyph_atlas_store_binding;
     int m_glyph_atlas_store_binding_fp16x2;
@@ -484,6 +489,14 @@ ready_brush_varyings(void)
     .add_alias("fastuidraw_brush_gradient_p0_y", "fastuidraw_brush_gradient_sweep_point_y")
     .add_alias("fastuidraw_brush_gradient_p1_x", "fastuidraw_brush_gradient_sweep_angle")
     .add_alias("fastuidraw_brush_gradient_p1_y", "fastuidraw_brush_gradient_sweep_sign_factor")
+
+    /* The varyings for color stops on an atlas are recycled for
+     * color stops packed in the data store; the location (in
+     * blocks) and count are exact as floats because the data
+     * store is far smaller than 2^24 blocks.
+     */
+    .add_alias("fastuidraw_brush_color_stop_x", "fastuidraw_brush_packed_color_stops_location")
+    .add_alias("fastuidraw_brush_color_stop_length", "fastuidraw_brush_packed_color_stops_count")
     ;
 
   m_custom_brush_shaders.update_varying_size(m_fixed_function_brush_varyings);
@@ -518,7 +531,10 @@ add_backend_constants(const fastuidraw::glsl::PainterShaderRegistrarGLSLTypes::B
         .add_macro("fastuidraw_imageAtlasLinear_size_reciprocal_x", "(1.0 / float(fastuidraw_imageAtlasLinear_size_x) )")
         .add_macro("fastuidraw_imageAtlasLinear_size_reciprocal_y", "(1.0 / float(fastuidraw_imageAtlasLinear_size_y) )")
         .add_macro("fastuidraw_imageAtlasLinear_size_reciprocal",
-                   "vec2(fastuidraw_imageAtlasLinear_size_reciprocal_x, fastuidraw_imageAtlasLinear_size_reciprocal_y)");
+                   "vec2(fastuidraw_imageAtlasLinear_size_reciprocal_x, fastuidraw_imageAtlasLinear_size_reciprocal_y)")
+        .add_macro_u32("FASTUIDRAW_IMAGE_ATLAS_RGBA8_COLOR_STORE", ImageAtlas::rgba8_color_store)
+        .add_macro_u32("FASTUIDRAW_IMAGE_ATLAS_R8_COLOR_STORE", ImageAtlas::r8_color_store)
+        .add_macro_u32("FASTUIDRAW_IMAGE_ATLAS_RG8_COLOR_STORE", ImageAtlas::rg8_color_store);
     }
 
   src
@@ -592,6 +608,9 @@ ready_constants(void)
     .add_macro_u32("fastuidraw_brush_image_format_num_bits", PainterBrush::image_format_num_bits)
     .add_macro_u32("fastuidraw_brush_image_format_rgba", Image::rgba_format)
     .add_macro_u32("fastuidraw_brush_image_format_premultipied_rgba", Image::premultipied_rgba_format)
+    .add_macro_u32("fastuidraw_brush_image_format_alpha", Image::alpha_format)
+    .add_macro_u32("fastuidraw_brush_image_format_luminance", Image::luminance_format)
+    .add_macro_u32("fastuidraw_brush_image_format_luminance_alpha", Image::luminance_alpha_format)
 
     .add_macro_u32("fastuidraw_brush_image_mipmap_mask", PainterBrush::image_mipmap_mask)
     .add_macro_u32("fastuidraw_brush_image_mipmap_bit0", PainterBrush::image_mipmap_bit0)
@@ -605,6 +624,12 @@ ready_constants(void)
     .add_macro_u32("fastuidraw_brush_sweep_gradient_type", PainterBrush::sweep_gradient_type)
 
     .add_macro_u32("fastuidraw_brush_gradient_spread_type_bit0", PainterBrush::gradient_spread_type_bit0)
+    .add_macro_u32("fastuidraw_brush_gradient_packed_color_stops_mask", PainterBrush::gradient_packed_color_stops_mask)
+    .add_macro_u32("fastuidraw_brush_packed_color_stop_channel_num_bits", PainterBrush::packed_color_stop_channel_num_bits)
+    .add_macro_u32("fastuidraw_brush_packed_color_stop_red_bit0", PainterBrush::packed_color_stop_red_bit0)
+    .add_macro_u32("fastuidraw_brush_packed_color_stop_green_bit0", PainterBrush::packed_color_stop_green_bit0)
+    .add_macro_u32("fastuidraw_brush_packed_color_stop_blue_bit0", PainterBrush::packed_color_stop_blue_bit0)
+    .add_macro_u32("fastuidraw_brush_packed_color_stop_alpha_bit0", PainterBrush::packed_color_stop_alpha_bit0)
 
     .add_macro_u32("fastuidraw_brush_spread_type_num_bits", PainterBrush::spread_type_num_bits)
     .add_macro_u32("fastuidraw_brush_spread_clamp", PainterBrush::spread_clamp)
@@ -1145,6 +1170,8 @@ construct_shader_common(enum fastuidraw::PainterBlendShader::shader_type blend_t
     .add_macro("FASTUIDRAW_COLORSTOP_ATLAS_BINDING", params.colorstop_atlas_binding())
     .add_macro("FASTUIDRAW_COLOR_TILE_LINEAR_BINDING", params.image_atlas_color_tiles_linear_binding())
     .add_macro("FASTUIDRAW_COLOR_TILE_NEAREST_BINDING", params.image_atlas_color_tiles_nearest_binding())
+    .add_macro("FASTUIDRAW_COLOR_TILE_R8_BINDING", params.image_atlas_color_tiles_r8_binding())
+    .add_macro("FASTUIDRAW_COLOR_TILE_RG8_BINDING", params.image_atlas_color_tiles_rg8_binding())
     .add_macro("FASTUIDRAW_INDEX_TILE_BINDING", params.image_atlas_index_tiles_binding())
     .add_macro("FASTUIDRAW_GLYPH_DATA_STORE_BINDING", params.glyph_atlas_store_binding())
     .add_macro("FASTUIDRAW_GLYPH_DATA_STORE_FP16X2_BINDING", params.glyph_atlas_store_binding_fp16x2())
@@ -1205,6 +1232,8 @@ construct_shader_common(enum fastuidraw::PainterBlendShader::shader_type blend_t
     .add_macro("FASTUIDRAW_COLORSTOP_ATLAS_BINDING", params.colorstop_atlas_binding())
     .add_macro("FASTUIDRAW_COLOR_TILE_LINEAR_BINDING", params.image_atlas_color_tiles_linear_binding())
     .add_macro("FASTUIDRAW_COLOR_TILE_NEAREST_BINDING", params.image_atlas_color_tiles_nearest_binding())
+    .add_macro("FASTUIDRAW_COLOR_TILE_R8_BINDING", params.image_atlas_color_tiles_r8_binding())
+    .add_macro("FASTUIDRAW_COLOR_TILE_RG8_BINDING", params.image_atlas_color_tiles_rg8_binding())
     .add_macro("FASTUIDRAW_INDEX_TILE_BINDING", params.image_atlas_index_tiles_binding())
     .add_macro("FASTUIDRAW_GLYPH_DATA_STORE_BINDING", params.glyph_atlas_store_binding())
     .add_macro("FASTUIDRAW_GLYPH_DATA_STORE_FP16X2_BINDING", params.glyph_atlas_store_binding_fp16x2())
@@ -1530,6 +1559,8 @@ recompute_binding_points(void)
   m_colorstop_atlas_binding = m_num_texture_units++;
   m_image_atlas_color_tiles_nearest_binding = m_num_texture_units++;
   m_image_atlas_color_tiles_linear_binding = m_num_texture_units++;
+  m_image_atlas_color_tiles_r8_binding = m_num_texture_units++;
+  m_image_atlas_color_tiles_rg8_binding = m_num_texture_units++;
   m_image_atlas_index_tiles_binding = m_num_texture_units++;
   m_coverage_buffer_texture_binding = m_num_texture_units++;
 
@@ -1701,6 +1732,8 @@ uber_shader_params_setget_implement_dirty(unsigned int, number_external_textures
 uber_shader_params_get_dirty(colorstop_atlas_binding)
 uber_shader_params_get_dirty(image_atlas_color_tiles_nearest_binding)
 uber_shader_params_get_dirty(image_atlas_color_tiles_linear_binding)
+uber_shader_params_get_dirty(image_atlas_color_tiles_r8_binding)
+uber_shader_params_get_dirty(image_atlas_color_tiles_rg8_binding)
 uber_shader_params_get_dirty(image_atlas_index_tiles_binding)
 uber_shader_params_get_dirty(glyph_atlas_store_binding)
 uber_shader_params_get_dirty(glyph_atlas_store_binding_fp16x2)
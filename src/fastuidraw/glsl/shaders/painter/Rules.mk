@@ -38,7 +38,9 @@ FASTUIDRAW_RESOURCE_STRING += $(call filelist, \
 	fastuidraw_painter_fill_aa_fuzz.vert.glsl.resource_string \
 	fastuidraw_painter_fill_aa_fuzz.frag.glsl.resource_string \
 	fastuidraw_painter_brush.vert.glsl.resource_string \
-	fastuidraw_painter_brush.frag.glsl.resource_string)
+	fastuidraw_painter_brush.frag.glsl.resource_string \
+	fastuidraw_painter_blur_brush.vert.glsl.resource_string \
+	fastuidraw_painter_blur_brush.frag.glsl.resource_string)
 
 # Begin standard footer
 d		:= $(dirstack_$(sp))
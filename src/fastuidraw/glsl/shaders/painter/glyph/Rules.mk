@@ -8,6 +8,7 @@ FASTUIDRAW_RESOURCE_STRING += $(call filelist, \
 	fastuidraw_painter_glyph_coverage_distance_field.vert.glsl.resource_string \
 	fastuidraw_painter_glyph_coverage.frag.glsl.resource_string \
 	fastuidraw_painter_glyph_distance_field.frag.glsl.resource_string \
+	fastuidraw_painter_glyph_multi_channel_distance_field.frag.glsl.resource_string \
 	fastuidraw_painter_glyph_restricted_rays.vert.glsl.resource_string \
 	fastuidraw_painter_glyph_restricted_rays.frag.glsl.resource_string \
 	fastuidraw_painter_glyph_banded_rays.vert.glsl.resource_string \
@@ -18,12 +18,18 @@
 
 
 #include <list>
+#include <cstring>
 #include <map>
+#include <vector>
 #include <mutex>
 #include <fastuidraw/image.hpp>
 #include <fastuidraw/image_atlas.hpp>
+#include <fastuidraw/util/trace_events.hpp>
 #include <private/array3d.hpp>
 #include <private/util_private.hpp>
+#include <private/texture_block_decode.hpp>
+#include <private/downsample_texels.hpp>
+#include <private/thread_pool.hpp>
 
 namespace
 {
@@ -113,6 +119,32 @@ namespace
       }
   }
 
+  /*
+   * Returns true if each of the texels [begin, end) has the
+   * value v. The texels are compared as 32-bit words that are
+   * or'd together without an early exit, so that the compiler
+   * is free to vectorize the loop.
+   */
+  bool
+  all_texels_equal(const fastuidraw::u8vec4 *begin,
+                   const fastuidraw::u8vec4 *end,
+                   fastuidraw::u8vec4 v)
+  {
+    FASTUIDRAWstatic_assert(sizeof(fastuidraw::u8vec4) == sizeof(uint32_t));
+
+    uint32_t ref, diff(0u);
+
+    std::memcpy(&ref, &v, sizeof(ref));
+    for (; begin != end; ++begin)
+      {
+        uint32_t w;
+
+        std::memcpy(&w, begin, sizeof(w));
+        diff |= (w ^ ref);
+      }
+    return diff == 0u;
+  }
+
   fastuidraw::ivec2
   divide_up(fastuidraw::ivec2 numerator, int denominator)
   {
@@ -149,6 +181,7 @@ namespace
   bool
   enough_room_in_atlas(fastuidraw::ivec2 number_color_tiles,
                        fastuidraw::ImageAtlas *C,
+                       enum fastuidraw::ImageAtlas::color_store_t color_store,
                        int &total_index)
   {
     int total_color;
@@ -156,13 +189,272 @@ namespace
     total_color = number_color_tiles.x() * number_color_tiles.y();
     total_index = number_index_tiles_needed(number_color_tiles, C->index_tile_size());
 
-    //std::cout << "Need " << total_color << " have: " << C->number_free_color_tiles() << "\n"
+    //std::cout << "Need " << total_color << " have: " << C->number_free_color_tiles(color_store) << "\n"
     //        << "Need " << total_index << " have: " << C->number_free_index_tiles() << "\n";
 
-    return total_color <= C->number_free_color_tiles()
+    return total_color <= C->number_free_color_tiles(color_store)
       && total_index <= C->number_free_index_tiles();
   }
 
+  /* Returns the color store of the atlas in which the tiles
+   * of an image of the named format are placed; if the atlas
+   * does not have the color store of the format, the tiles
+   * are placed in the rgba8_color_store.
+   */
+  enum fastuidraw::ImageAtlas::color_store_t
+  atlas_color_store(const fastuidraw::ImageAtlas &atlas,
+                    enum fastuidraw::Image::format_t fmt)
+  {
+    enum fastuidraw::ImageAtlas::color_store_t C;
+
+    C = fastuidraw::ImageAtlas::color_store_for_format(fmt);
+    return (atlas.color_store(C)) ? C : fastuidraw::ImageAtlas::rgba8_color_store;
+  }
+
+  /* An ImageSourceBase whose texels are those of another
+   * ImageSourceBase as they are to be placed in a color
+   * store of an ImageAtlas: for the stores with fewer than
+   * four channels, the channels that the format keeps are
+   * moved to the leading channels; for the rgba8 store, the
+   * texels of a format with fewer channels are expanded to
+   * RGBA.
+   */
+  class AtlasTexelSource:public fastuidraw::ImageSourceBase
+  {
+  public:
+    AtlasTexelSource(const fastuidraw::ImageSourceBase &src,
+                     enum fastuidraw::ImageAtlas::color_store_t color_store):
+      m_src(src),
+      m_src_format(src.format()),
+      m_color_store(color_store),
+      m_convert(fastuidraw::ImageAtlas::color_store_for_format(m_src_format)
+                != fastuidraw::ImageAtlas::rgba8_color_store)
+    {}
+
+    fastuidraw::u8vec4
+    convert(fastuidraw::u8vec4 v) const
+    {
+      using namespace fastuidraw;
+
+      switch (m_src_format)
+        {
+        case Image::alpha_format:
+          return (m_color_store == ImageAtlas::rgba8_color_store) ?
+            u8vec4(255u, 255u, 255u, v.w()) :
+            u8vec4(v.w(), 0u, 0u, 0u);
+
+        case Image::luminance_format:
+          return (m_color_store == ImageAtlas::rgba8_color_store) ?
+            u8vec4(v.x(), v.x(), v.x(), 255u) :
+            u8vec4(v.x(), 0u, 0u, 0u);
+
+        case Image::luminance_alpha_format:
+          return (m_color_store == ImageAtlas::rgba8_color_store) ?
+            u8vec4(v.x(), v.x(), v.x(), v.w()) :
+            u8vec4(v.x(), v.w(), 0u, 0u);
+
+        default:
+          return v;
+        }
+    }
+
+    virtual
+    bool
+    all_same_color(fastuidraw::ivec2 location, int square_size,
+                   fastuidraw::u8vec4 *dst) const
+    {
+      bool return_value;
+
+      return_value = m_src.all_same_color(location, square_size, dst);
+      *dst = convert(*dst);
+      return return_value;
+    }
+
+    virtual
+    unsigned int
+    number_levels(void) const
+    {
+      return m_src.number_levels();
+    }
+
+    virtual
+    void
+    fetch_texels(unsigned int level, fastuidraw::ivec2 location,
+                 unsigned int w, unsigned int h,
+                 fastuidraw::c_array<fastuidraw::u8vec4> dst) const
+    {
+      m_src.fetch_texels(level, location, w, h, dst);
+      if (m_convert)
+        {
+          for (fastuidraw::u8vec4 &v : dst)
+            {
+              v = convert(v);
+            }
+        }
+    }
+
+    virtual
+    enum fastuidraw::Image::format_t
+    format(void) const
+    {
+      using namespace fastuidraw;
+
+      return (m_convert && m_color_store == ImageAtlas::rgba8_color_store) ?
+        Image::rgba_format :
+        m_src_format;
+    }
+
+    virtual
+    bool
+    thread_safe(void) const
+    {
+      return m_src.thread_safe();
+    }
+
+  private:
+    const fastuidraw::ImageSourceBase &m_src;
+    enum fastuidraw::Image::format_t m_src_format;
+    enum fastuidraw::ImageAtlas::color_store_t m_color_store;
+    bool m_convert;
+  };
+
+  /* An ImageSourceBase that returns the LOD level 0 texels of
+   * one color tile from texels already fetched from another
+   * ImageSourceBase, and forwards all other requests to it.
+   */
+  class PrefetchedTileSource:public fastuidraw::ImageSourceBase
+  {
+  public:
+    PrefetchedTileSource(const fastuidraw::ImageSourceBase &src,
+                         fastuidraw::ivec2 location, int size,
+                         fastuidraw::c_array<const fastuidraw::u8vec4> texels):
+      m_src(src),
+      m_location(location),
+      m_size(size),
+      m_texels(texels)
+    {}
+
+    virtual
+    bool
+    all_same_color(fastuidraw::ivec2 location, int square_size,
+                   fastuidraw::u8vec4 *dst) const
+    {
+      return m_src.all_same_color(location, square_size, dst);
+    }
+
+    virtual
+    unsigned int
+    number_levels(void) const
+    {
+      return m_src.number_levels();
+    }
+
+    virtual
+    void
+    fetch_texels(unsigned int level, fastuidraw::ivec2 location,
+                 unsigned int w, unsigned int h,
+                 fastuidraw::c_array<fastuidraw::u8vec4> dst) const
+    {
+      if (level == 0 && location == m_location
+          && w == unsigned(m_size) && h == unsigned(m_size))
+        {
+          std::copy(m_texels.begin(), m_texels.end(), dst.begin());
+        }
+      else
+        {
+          m_src.fetch_texels(level, location, w, h, dst);
+        }
+    }
+
+    virtual
+    enum fastuidraw::Image::format_t
+    format(void) const
+    {
+      return m_src.format();
+    }
+
+    virtual
+    bool
+    thread_safe(void) const
+    {
+      return m_src.thread_safe();
+    }
+
+  private:
+    const fastuidraw::ImageSourceBase &m_src;
+    fastuidraw::ivec2 m_location;
+    int m_size;
+    fastuidraw::c_array<const fastuidraw::u8vec4> m_texels;
+  };
+
+  /* An ImageSourceBase that has the texels of another
+   * ImageSourceBase with a different format.
+   */
+  class ImageSourceWithFormat:public fastuidraw::ImageSourceBase
+  {
+  public:
+    ImageSourceWithFormat(const fastuidraw::ImageSourceBase &src,
+                          enum fastuidraw::Image::format_t fmt):
+      m_src(src),
+      m_format(fmt)
+    {}
+
+    virtual
+    bool
+    all_same_color(fastuidraw::ivec2 location, int square_size,
+                   fastuidraw::u8vec4 *dst) const
+    {
+      return m_src.all_same_color(location, square_size, dst);
+    }
+
+    virtual
+    unsigned int
+    number_levels(void) const
+    {
+      return m_src.number_levels();
+    }
+
+    virtual
+    void
+    fetch_texels(unsigned int level, fastuidraw::ivec2 location,
+                 unsigned int w, unsigned int h,
+                 fastuidraw::c_array<fastuidraw::u8vec4> dst) const
+    {
+      m_src.fetch_texels(level, location, w, h, dst);
+    }
+
+    virtual
+    enum fastuidraw::Image::format_t
+    format(void) const
+    {
+      return m_format;
+    }
+
+    virtual
+    bool
+    thread_safe(void) const
+    {
+      return m_src.thread_safe();
+    }
+
+  private:
+    const fastuidraw::ImageSourceBase &m_src;
+    enum fastuidraw::Image::format_t m_format;
+  };
+
+  class MipmapChainPrivate
+  {
+  public:
+    MipmapChainPrivate(fastuidraw::uvec2 dimensions,
+                       const fastuidraw::ImageSourceBase &level0,
+                       enum fastuidraw::ImageSourceMipmapChain::filter_t filter,
+                       unsigned int max_levels);
+
+    enum fastuidraw::Image::format_t m_format;
+    std::vector<fastuidraw::uvec2> m_dimensions;
+    std::vector<std::vector<fastuidraw::u8vec4> > m_texels;
+  };
+
   class BackingStorePrivate
   {
   public:
@@ -308,22 +600,35 @@ namespace
   public:
     ImageAtlasPrivate(int pcolor_tile_size, int pindex_tile_size,
                       const fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase> &pcolor_store,
-                      const fastuidraw::reference_counted_ptr<fastuidraw::AtlasIndexBackingStoreBase> &pindex_store):
-      m_color_store(pcolor_store),
-      m_color_store_constant(m_color_store),
-      m_color_tiles(pcolor_tile_size, dimensions_of_store(pcolor_store)),
+                      const fastuidraw::reference_counted_ptr<fastuidraw::AtlasIndexBackingStoreBase> &pindex_store,
+                      const fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase> &pr8_color_store,
+                      const fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase> &prg8_color_store):
       m_index_store(pindex_store),
       m_index_store_constant(m_index_store),
-      m_index_tiles(pindex_tile_size, dimensions_of_store(pindex_store)),
-      m_resizeable(m_color_store && m_color_store->resizeable() && m_index_store && m_index_store->resizeable())
-    {}
+      m_index_tiles(pindex_tile_size, dimensions_of_store(pindex_store))
+    {
+      m_color_stores[fastuidraw::ImageAtlas::rgba8_color_store] = pcolor_store;
+      m_color_stores[fastuidraw::ImageAtlas::r8_color_store] = pr8_color_store;
+      m_color_stores[fastuidraw::ImageAtlas::rg8_color_store] = prg8_color_store;
+
+      m_resizeable = m_index_store && m_index_store->resizeable() && pcolor_store;
+      m_color_tiles.reserve(fastuidraw::ImageAtlas::number_color_stores);
+      for (unsigned int i = 0; i < fastuidraw::ImageAtlas::number_color_stores; ++i)
+        {
+          m_color_stores_constant[i] = m_color_stores[i];
+          m_color_tiles.emplace_back(pcolor_tile_size, dimensions_of_store(m_color_stores[i]));
+          m_resizeable = m_resizeable && (!m_color_stores[i] || m_color_stores[i]->resizeable());
+        }
+    }
 
     std::mutex m_mutex;
     ResourceReleaseActionList m_delete_actions;
 
-    fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase> m_color_store;
-    fastuidraw::reference_counted_ptr<const fastuidraw::AtlasColorBackingStoreBase> m_color_store_constant;
-    tile_allocator m_color_tiles;
+    fastuidraw::vecN<fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase>,
+                     fastuidraw::ImageAtlas::number_color_stores> m_color_stores;
+    fastuidraw::vecN<fastuidraw::reference_counted_ptr<const fastuidraw::AtlasColorBackingStoreBase>,
+                     fastuidraw::ImageAtlas::number_color_stores> m_color_stores_constant;
+    std::vector<tile_allocator> m_color_tiles;
 
     fastuidraw::reference_counted_ptr<fastuidraw::AtlasIndexBackingStoreBase> m_index_store;
     fastuidraw::reference_counted_ptr<const fastuidraw::AtlasIndexBackingStoreBase> m_index_store_constant;
@@ -364,6 +669,7 @@ namespace
       m_number_levels(m),
       m_type(t),
       m_format(fmt),
+      m_color_store(fastuidraw::ImageAtlas::rgba8_color_store),
       m_num_color_tiles(-1, -1),
       m_master_index_tile(-1, -1, -1),
       m_master_index_tile_dims(-1.0f, -1.0f),
@@ -396,6 +702,7 @@ namespace
     enum fastuidraw::Image::format_t m_format;
 
     /* Data for when the image has type on_atlas */
+    enum fastuidraw::ImageAtlas::color_store_t m_color_store;
     fastuidraw::ivec2 m_num_color_tiles;
     std::map<fastuidraw::u8vec4, fastuidraw::ivec3> m_repeated_tiles;
     std::vector<per_color_tile> m_color_tiles;
@@ -419,7 +726,7 @@ ImagePrivate(fastuidraw::ImageAtlas &patlas, int w, int h,
   m_dimensions(w, h),
   m_number_levels(image_data.number_levels()),
   m_type(fastuidraw::Image::on_atlas),
-  m_format(image_data.format()),
+  m_color_store(atlas_color_store(patlas, image_data.format())),
   m_bindless_handle(-1)
 {
   using namespace fastuidraw;
@@ -428,7 +735,10 @@ ImagePrivate(fastuidraw::ImageAtlas &patlas, int w, int h,
   FASTUIDRAWassert(m_dimensions.y() > 0);
   FASTUIDRAWassert(m_atlas);
 
-  create_color_tiles(image_data);
+  AtlasTexelSource texels(image_data, m_color_store);
+
+  m_format = texels.format();
+  create_color_tiles(texels);
   create_index_tiles();
 
   /* Mipmap filtering cannot go beyond the tile size or the
@@ -446,13 +756,13 @@ ImagePrivate::
     {
       if (C.m_non_repeat_color)
         {
-          m_atlas->delete_color_tile(C.m_tile);
+          m_atlas->delete_color_tile(m_color_store, C.m_tile);
         }
     }
 
   for(const auto &C : m_repeated_tiles)
     {
-      m_atlas->delete_color_tile(C.second);
+      m_atlas->delete_color_tile(m_color_store, C.second);
     }
 
   for(const auto &tile_array: m_index_tiles)
@@ -482,45 +792,76 @@ create_color_tiles(const fastuidraw::ImageSourceBase &image_data)
   m_master_index_tile_dims = fastuidraw::vec2(m_dimensions) / static_cast<float>(tile_interior_size);
   m_dimensions_index_divisor = static_cast<float>(tile_interior_size);
 
+  /* The texels of LOD 0 of each tile are fetched into a tile
+   * sized buffer of the job and checked for being a single color;
+   * a tile of a single color is confirmed with all_same_color()
+   * because that considers all mipmap levels. A non-uniform tile
+   * is added to the atlas (which locks its own mutex) directly
+   * with its level 0 texels coming from the buffer instead of
+   * fetching them again. If the ImageSourceBase is thread safe,
+   * the tiles are processed by several threads. The uniform
+   * tiles are then added in order so that tiles of the same
+   * color share a single tile of the atlas.
+   */
+  const int tile_area(color_tile_size * color_tile_size);
+  const int num_tiles(m_num_color_tiles.x() * m_num_color_tiles.y());
+  std::vector<fastuidraw::ivec3> tiles(num_tiles);
+  std::vector<fastuidraw::u8vec4> colors(num_tiles);
+  std::vector<uint8_t> same_color(num_tiles);
   unsigned int savings(0);
-  for(int ty = 0, source_y = 0;
-      ty < m_num_color_tiles.y();
-      ++ty, source_y += tile_interior_size)
+  auto process_tiles = [&](unsigned int begin, unsigned int end)
     {
-      for(int tx = 0, source_x = 0;
-          tx < m_num_color_tiles.x();
-          ++tx, source_x += tile_interior_size)
+      std::vector<fastuidraw::u8vec4> tile_texels(tile_area);
+      fastuidraw::c_array<fastuidraw::u8vec4> texels(fastuidraw::make_c_array(tile_texels));
+
+      for (unsigned int t = begin; t < end; ++t)
         {
-          fastuidraw::ivec3 new_tile;
-          fastuidraw::ivec2 src_xy(source_x, source_y);
-          bool all_same_color;
-          fastuidraw::u8vec4 same_color_value;
+          fastuidraw::ivec2 src_xy;
 
-          all_same_color = image_data.all_same_color(src_xy, color_tile_size, &same_color_value);
+          src_xy.x() = (t % m_num_color_tiles.x()) * tile_interior_size;
+          src_xy.y() = (t / m_num_color_tiles.x()) * tile_interior_size;
 
-          if (all_same_color)
+          image_data.fetch_texels(0, src_xy, color_tile_size, color_tile_size, texels);
+          same_color[t] = all_texels_equal(texels.begin(), texels.end(), texels[0])
+            && image_data.all_same_color(src_xy, color_tile_size, &colors[t]);
+          if (!same_color[t])
             {
-              std::map<fastuidraw::u8vec4, fastuidraw::ivec3>::iterator iter;
+              PrefetchedTileSource tile_data(image_data, src_xy, color_tile_size, texels);
+              tiles[t] = m_atlas->add_color_tile(m_color_store, src_xy, tile_data);
+            }
+        }
+    };
 
-              iter = m_repeated_tiles.find(same_color_value);
-              if (iter != m_repeated_tiles.end())
-                {
-                  new_tile = iter->second;
-                  ++savings;
-                }
-              else
-                {
-                  new_tile = m_atlas->add_color_tile(same_color_value);
-                  m_repeated_tiles[same_color_value] = new_tile;
-                }
+  if (image_data.thread_safe())
+    {
+      fastuidraw::detail::SharedThreadPool::get().parallel_for(num_tiles, m_num_color_tiles.x(),
+                                                               process_tiles);
+    }
+  else
+    {
+      process_tiles(0, num_tiles);
+    }
+
+  m_color_tiles.reserve(num_tiles);
+  for (int t = 0; t < num_tiles; ++t)
+    {
+      if (same_color[t])
+        {
+          std::map<fastuidraw::u8vec4, fastuidraw::ivec3>::iterator iter;
+
+          iter = m_repeated_tiles.find(colors[t]);
+          if (iter != m_repeated_tiles.end())
+            {
+              tiles[t] = iter->second;
+              ++savings;
             }
           else
             {
-              new_tile = m_atlas->add_color_tile(src_xy, image_data);
+              tiles[t] = m_atlas->add_color_tile(m_color_store, colors[t]);
+              m_repeated_tiles[colors[t]] = tiles[t];
             }
-
-          m_color_tiles.push_back(per_color_tile(new_tile, !all_same_color) );
         }
+      m_color_tiles.push_back(per_color_tile(tiles[t], !same_color[t]));
     }
 
   FASTUIDRAWunused(savings);
@@ -764,6 +1105,129 @@ resize_to_fit(int num_tiles)
 }
 
 
+//////////////////////////////////////
+// MipmapChainPrivate methods
+MipmapChainPrivate::
+MipmapChainPrivate(fastuidraw::uvec2 dimensions,
+                   const fastuidraw::ImageSourceBase &level0,
+                   enum fastuidraw::ImageSourceMipmapChain::filter_t filter,
+                   unsigned int max_levels):
+  m_format(level0.format())
+{
+  using namespace fastuidraw;
+
+  unsigned int num_levels;
+
+  FASTUIDRAWassert(dimensions.x() > 0u && dimensions.y() > 0u);
+  num_levels = 1u + uint32_log2(t_max(dimensions.x(), dimensions.y()));
+  if (max_levels != 0u)
+    {
+      num_levels = t_min(num_levels, max_levels);
+    }
+
+  m_dimensions.resize(num_levels);
+  m_texels.resize(num_levels);
+
+  m_dimensions[0] = dimensions;
+  m_texels[0].resize(dimensions.x() * dimensions.y());
+  level0.fetch_texels(0, ivec2(0, 0), dimensions.x(), dimensions.y(),
+                      make_c_array(m_texels[0]));
+
+  /* each level is computed from the level before it; the
+   * work within a level is spread across threads.
+   */
+  for (unsigned int L = 1; L < num_levels; ++L)
+    {
+      m_dimensions[L] = detail::downsample_dimensions(m_dimensions[L - 1]);
+      m_texels[L].resize(m_dimensions[L].x() * m_dimensions[L].y());
+      detail::downsample_texels(filter, m_format, m_dimensions[L - 1],
+                                make_c_array(m_texels[L - 1]),
+                                make_c_array(m_texels[L]));
+    }
+}
+
+
+////////////////////////////////////////
+// fastuidraw::ImageSourceBase methods
+unsigned int
+fastuidraw::ImageSourceBase::
+compressed_block_size(enum compression_t compression)
+{
+  switch (compression)
+    {
+    case bc1_compression:
+    case etc2_rgb8_compression:
+      return 8;
+
+    case bc2_compression:
+    case bc3_compression:
+    case etc2_rgba8_compression:
+      return 16;
+
+    default:
+      return 0;
+    }
+}
+
+enum fastuidraw::Image::format_t
+fastuidraw::ImageSourceBase::
+compact_format(ivec2 dimensions) const
+{
+  enum Image::format_t fmt(format());
+  bool premultiplied, can_alpha, can_luminance, can_luminance_alpha;
+  std::vector<u8vec4> row;
+
+  if (fmt != Image::rgba_format && fmt != Image::premultipied_rgba_format)
+    {
+      return fmt;
+    }
+
+  /* For pre-multiplied alpha, only an alpha mask of white
+   * or opaque gray can be represented exactly because the
+   * compact formats are not pre-multiplied.
+   */
+  premultiplied = (fmt == Image::premultipied_rgba_format);
+  can_alpha = can_luminance = true;
+  can_luminance_alpha = !premultiplied;
+
+  for (unsigned int level = 0, end_level = number_levels();
+       level < end_level && (can_alpha || can_luminance || can_luminance_alpha);
+       ++level)
+    {
+      int w, h;
+
+      w = t_max(1, dimensions.x() >> level);
+      h = t_max(1, dimensions.y() >> level);
+      row.resize(w);
+      for (int y = 0; y < h && (can_alpha || can_luminance || can_luminance_alpha); ++y)
+        {
+          fetch_texels(level, ivec2(0, y), w, 1, make_c_array(row));
+          for (const u8vec4 &v : row)
+            {
+              bool gray;
+
+              gray = (v.x() == v.y() && v.x() == v.z());
+              can_alpha = can_alpha && gray && v.x() == (premultiplied ? v.w() : 255u);
+              can_luminance = can_luminance && gray && v.w() == 255u;
+              can_luminance_alpha = can_luminance_alpha && gray;
+            }
+        }
+    }
+
+  if (can_alpha)
+    {
+      return Image::alpha_format;
+    }
+  else if (can_luminance)
+    {
+      return Image::luminance_format;
+    }
+  else if (can_luminance_alpha)
+    {
+      return Image::luminance_alpha_format;
+    }
+  return fmt;
+}
 
 ////////////////////////////////////////
 // fastuidraw::ImageSourceCArray methods
@@ -792,12 +1256,12 @@ all_same_color(ivec2 location, int square_size, u8vec4 *dst) const
   *dst = m_data[0][location.x() + location.y() * m_dimensions.x()];
   for (int y = 0, sy = location.y(); y < square_size; ++y, ++sy)
     {
-      for (int x = 0, sx = location.x(); x < square_size; ++x, ++sx)
+      const u8vec4 *row;
+
+      row = m_data[0].c_ptr() + location.x() + sy * m_dimensions.x();
+      if (!all_texels_equal(row, row + square_size, *dst))
         {
-          if (*dst != m_data[0][sx + sy * m_dimensions.x()])
-            {
-              return false;
-            }
+          return false;
         }
     }
   return true;
@@ -837,6 +1301,277 @@ format(void) const
   return m_format;
 }
 
+bool
+fastuidraw::ImageSourceCArray::
+thread_safe(void) const
+{
+  return true;
+}
+
+////////////////////////////////////////////////
+// fastuidraw::ImageSourceCompressedCArray methods
+fastuidraw::ImageSourceCompressedCArray::
+ImageSourceCompressedCArray(uvec2 dimensions,
+                            c_array<const c_array<const uint8_t> > pdata,
+                            enum compression_t compression,
+                            enum Image::format_t fmt):
+  m_dimensions(dimensions),
+  m_data(pdata),
+  m_compression(compression),
+  m_format(fmt)
+{
+  FASTUIDRAWassert(m_compression != uncompressed);
+}
+
+bool
+fastuidraw::ImageSourceCompressedCArray::
+all_same_color(ivec2 location, int square_size, u8vec4 *dst) const
+{
+  std::vector<u8vec4> texels;
+
+  location.x() = t_max(location.x(), 0);
+  location.y() = t_max(location.y(), 0);
+
+  location.x() = t_min(int(m_dimensions.x()) - 1, location.x());
+  location.y() = t_min(int(m_dimensions.y()) - 1, location.y());
+
+  square_size = t_min(int(m_dimensions.x()) - location.x(), square_size);
+  square_size = t_min(int(m_dimensions.y()) - location.y(), square_size);
+
+  texels.resize(square_size * square_size);
+  fetch_texels(0, location, square_size, square_size, make_c_array(texels));
+
+  *dst = texels[0];
+  return all_texels_equal(texels.data(), texels.data() + texels.size(), *dst);
+}
+
+unsigned int
+fastuidraw::ImageSourceCompressedCArray::
+number_levels(void) const
+{
+  return m_data.size();
+}
+
+void
+fastuidraw::ImageSourceCompressedCArray::
+fetch_texels(unsigned int mipmap_level, ivec2 location,
+             unsigned int w, unsigned int h,
+             c_array<u8vec4> dst) const
+{
+  if (mipmap_level >= m_data.size())
+    {
+      std::fill(dst.begin(), dst.end(), u8vec4(255u, 255u, 0u, 255u));
+      return;
+    }
+
+  /* decode only the blocks that the region, clamped to
+   * the level, touches; the decoded texels are then
+   * copied to dst with the same boundary duplication as
+   * ImageSourceCArray.
+   */
+  ivec2 level_dims, min_xy, max_xy, block_min, block_max, decoded_dims;
+  unsigned int block_size, blocks_per_row;
+  std::vector<u8vec4> decoded;
+  vecN<u8vec4, 16> block_texels;
+  c_array<const uint8_t> blocks(m_data[mipmap_level]);
+
+  level_dims.x() = t_max(1, int(m_dimensions.x() >> mipmap_level));
+  level_dims.y() = t_max(1, int(m_dimensions.y() >> mipmap_level));
+  for (int i = 0; i < 2; ++i)
+    {
+      int sz(i == 0 ? w : h);
+
+      min_xy[i] = t_max(0, t_min(level_dims[i] - 1, location[i]));
+      max_xy[i] = t_max(0, t_min(level_dims[i] - 1, location[i] + sz - 1));
+      block_min[i] = min_xy[i] / 4;
+      block_max[i] = max_xy[i] / 4;
+      decoded_dims[i] = t_min(level_dims[i], 4 * (block_max[i] + 1)) - 4 * block_min[i];
+    }
+
+  block_size = compressed_block_size(m_compression);
+  blocks_per_row = (level_dims.x() + 3) / 4;
+  FASTUIDRAWassert(blocks.size() >= block_size * blocks_per_row * ((level_dims.y() + 3) / 4));
+
+  decoded.resize(decoded_dims.x() * decoded_dims.y());
+  for (int by = block_min.y(); by <= block_max.y(); ++by)
+    {
+      for (int bx = block_min.x(); bx <= block_max.x(); ++bx)
+        {
+          int x0(4 * (bx - block_min.x())), y0(4 * (by - block_min.y()));
+
+          detail::decode_compressed_block(m_compression,
+                                          blocks.c_ptr() + block_size * (bx + by * blocks_per_row),
+                                          block_texels);
+          for (int y = 0; y < 4 && y0 + y < decoded_dims.y(); ++y)
+            {
+              for (int x = 0; x < 4 && x0 + x < decoded_dims.x(); ++x)
+                {
+                  decoded[(x0 + x) + (y0 + y) * decoded_dims.x()] = block_texels[x + 4 * y];
+                }
+            }
+        }
+    }
+
+  copy_sub_data<u8vec4, u8vec4>(dst, w, h,
+                                make_c_array(decoded),
+                                location.x() - 4 * block_min.x(),
+                                location.y() - 4 * block_min.y(),
+                                decoded_dims);
+}
+
+enum fastuidraw::Image::format_t
+fastuidraw::ImageSourceCompressedCArray::
+format(void) const
+{
+  return m_format;
+}
+
+bool
+fastuidraw::ImageSourceCompressedCArray::
+thread_safe(void) const
+{
+  return true;
+}
+
+enum fastuidraw::ImageSourceBase::compression_t
+fastuidraw::ImageSourceCompressedCArray::
+compression(void) const
+{
+  return m_compression;
+}
+
+fastuidraw::c_array<const uint8_t>
+fastuidraw::ImageSourceCompressedCArray::
+compressed_blocks(unsigned int level) const
+{
+  return (level < m_data.size()) ?
+    m_data[level] :
+    c_array<const uint8_t>();
+}
+
+/////////////////////////////////////////////
+// fastuidraw::ImageSourceMipmapChain methods
+fastuidraw::ImageSourceMipmapChain::
+ImageSourceMipmapChain(uvec2 dimensions,
+                       const ImageSourceBase &level0,
+                       enum filter_t filter,
+                       unsigned int max_levels)
+{
+  TraceEvents::Scope trace("ImageSourceMipmapChain", "generate");
+  m_d = FASTUIDRAWnew MipmapChainPrivate(dimensions, level0, filter, max_levels);
+}
+
+fastuidraw::ImageSourceMipmapChain::
+~ImageSourceMipmapChain()
+{
+  MipmapChainPrivate *d;
+  d = static_cast<MipmapChainPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+fastuidraw::c_array<const fastuidraw::u8vec4>
+fastuidraw::ImageSourceMipmapChain::
+level_texels(unsigned int level) const
+{
+  const MipmapChainPrivate *d;
+  d = static_cast<const MipmapChainPrivate*>(m_d);
+  return (level < d->m_texels.size()) ?
+    make_c_array(d->m_texels[level]) :
+    c_array<const u8vec4>();
+}
+
+fastuidraw::uvec2
+fastuidraw::ImageSourceMipmapChain::
+level_dimensions(unsigned int level) const
+{
+  MipmapChainPrivate *d;
+  d = static_cast<MipmapChainPrivate*>(m_d);
+  return (level < d->m_dimensions.size()) ?
+    d->m_dimensions[level] :
+    uvec2(0, 0);
+}
+
+bool
+fastuidraw::ImageSourceMipmapChain::
+all_same_color(ivec2 location, int square_size, u8vec4 *dst) const
+{
+  MipmapChainPrivate *d;
+  d = static_cast<MipmapChainPrivate*>(m_d);
+
+  ivec2 dims(d->m_dimensions[0]);
+  c_array<const u8vec4> texels(make_c_array(d->m_texels[0]));
+
+  location.x() = t_max(location.x(), 0);
+  location.y() = t_max(location.y(), 0);
+
+  location.x() = t_min(dims.x() - 1, location.x());
+  location.y() = t_min(dims.y() - 1, location.y());
+
+  square_size = t_min(dims.x() - location.x(), square_size);
+  square_size = t_min(dims.y() - location.y(), square_size);
+
+  *dst = texels[location.x() + location.y() * dims.x()];
+  for (int y = 0, sy = location.y(); y < square_size; ++y, ++sy)
+    {
+      const u8vec4 *row;
+
+      row = texels.c_ptr() + location.x() + sy * dims.x();
+      if (!all_texels_equal(row, row + square_size, *dst))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+unsigned int
+fastuidraw::ImageSourceMipmapChain::
+number_levels(void) const
+{
+  MipmapChainPrivate *d;
+  d = static_cast<MipmapChainPrivate*>(m_d);
+  return d->m_texels.size();
+}
+
+void
+fastuidraw::ImageSourceMipmapChain::
+fetch_texels(unsigned int mipmap_level, ivec2 location,
+             unsigned int w, unsigned int h,
+             c_array<u8vec4> dst) const
+{
+  MipmapChainPrivate *d;
+  d = static_cast<MipmapChainPrivate*>(m_d);
+
+  if (mipmap_level >= d->m_texels.size())
+    {
+      std::fill(dst.begin(), dst.end(), u8vec4(255u, 255u, 0u, 255u));
+    }
+  else
+    {
+      copy_sub_data<u8vec4, u8vec4>(dst, w, h,
+                                    make_c_array(d->m_texels[mipmap_level]),
+                                    location.x(), location.y(),
+                                    ivec2(d->m_dimensions[mipmap_level]));
+    }
+}
+
+enum fastuidraw::Image::format_t
+fastuidraw::ImageSourceMipmapChain::
+format(void) const
+{
+  MipmapChainPrivate *d;
+  d = static_cast<MipmapChainPrivate*>(m_d);
+  return d->m_format;
+}
+
+bool
+fastuidraw::ImageSourceMipmapChain::
+thread_safe(void) const
+{
+  return true;
+}
+
 //////////////////////////////////////////////////
 // fastuidraw::AtlasColorBackingStoreBase methods
 fastuidraw::AtlasColorBackingStoreBase::
@@ -883,6 +1618,7 @@ fastuidraw::AtlasColorBackingStoreBase::
 resize(int new_num_layers)
 {
   BackingStorePrivate *d;
+  TraceEvents::Scope trace("ImageAtlas", "resize_color_store");
 
   d = static_cast<BackingStorePrivate*>(m_d);
   FASTUIDRAWassert(d->m_resizeable);
@@ -937,6 +1673,7 @@ fastuidraw::AtlasIndexBackingStoreBase::
 resize(int new_num_layers)
 {
   BackingStorePrivate *d;
+  TraceEvents::Scope trace("ImageAtlas", "resize_index_store");
 
   d = static_cast<BackingStorePrivate*>(m_d);
   FASTUIDRAWassert(d->m_resizeable);
@@ -955,7 +1692,20 @@ ImageAtlas(int pcolor_tile_size, int pindex_tile_size,
            fastuidraw::reference_counted_ptr<AtlasIndexBackingStoreBase> pindex_store)
 {
   m_d = FASTUIDRAWnew ImageAtlasPrivate(pcolor_tile_size, pindex_tile_size,
-                                       pcolor_store, pindex_store);
+                                       pcolor_store, pindex_store,
+                                       nullptr, nullptr);
+}
+
+fastuidraw::ImageAtlas::
+ImageAtlas(int pcolor_tile_size, int pindex_tile_size,
+           fastuidraw::reference_counted_ptr<AtlasColorBackingStoreBase> pcolor_store,
+           fastuidraw::reference_counted_ptr<AtlasIndexBackingStoreBase> pindex_store,
+           fastuidraw::reference_counted_ptr<AtlasColorBackingStoreBase> pr8_color_store,
+           fastuidraw::reference_counted_ptr<AtlasColorBackingStoreBase> prg8_color_store)
+{
+  m_d = FASTUIDRAWnew ImageAtlasPrivate(pcolor_tile_size, pindex_tile_size,
+                                       pcolor_store, pindex_store,
+                                       pr8_color_store, prg8_color_store);
 }
 
 fastuidraw::ImageAtlas::
@@ -975,7 +1725,10 @@ lock_resources(void)
   d = static_cast<ImageAtlasPrivate*>(m_d);
 
   std::lock_guard<std::mutex> M(d->m_mutex);
-  d->m_color_tiles.lock_resources();
+  for (tile_allocator &tiles : d->m_color_tiles)
+    {
+      tiles.lock_resources();
+    }
   d->m_index_tiles.lock_resources();
   d->m_delete_actions.lock_resources();
 }
@@ -988,7 +1741,10 @@ unlock_resources(void)
   d = static_cast<ImageAtlasPrivate*>(m_d);
 
   std::lock_guard<std::mutex> M(d->m_mutex);
-  d->m_color_tiles.unlock_resources();
+  for (tile_allocator &tiles : d->m_color_tiles)
+    {
+      tiles.unlock_resources();
+    }
   d->m_index_tiles.unlock_resources();
   d->m_delete_actions.unlock_resources();
 }
@@ -1008,7 +1764,7 @@ color_tile_size(void) const
 {
   ImageAtlasPrivate *d;
   d = static_cast<ImageAtlasPrivate*>(m_d);
-  return d->m_color_tiles.tile_size();
+  return d->m_color_tiles[rgba8_color_store].tile_size();
 }
 
 int
@@ -1057,37 +1813,39 @@ delete_index_tile(fastuidraw::ivec3 tile)
 
 int
 fastuidraw::ImageAtlas::
-number_free_color_tiles(void) const
+number_free_color_tiles(enum color_store_t C) const
 {
   ImageAtlasPrivate *d;
   d = static_cast<ImageAtlasPrivate*>(m_d);
   std::lock_guard<std::mutex> M(d->m_mutex);
-  return d->m_color_tiles.number_free();
+  return d->m_color_tiles[C].number_free();
 }
 
 fastuidraw::ivec3
 fastuidraw::ImageAtlas::
-add_color_tile(u8vec4 color_data)
+add_color_tile(enum color_store_t C, u8vec4 color_data)
 {
   ImageAtlasPrivate *d;
   d = static_cast<ImageAtlasPrivate*>(m_d);
 
   ivec3 return_value;
   std::lock_guard<std::mutex> M(d->m_mutex);
+  tile_allocator &tiles(d->m_color_tiles[C]);
   ivec2 dst_xy;
   int sz;
 
-  return_value = d->m_color_tiles.allocate_tile();
+  FASTUIDRAWassert(d->m_color_stores[C]);
+  return_value = tiles.allocate_tile();
   if (return_value != ivec3(-1, -1, -1))
     {
-      dst_xy.x() = return_value.x() * d->m_color_tiles.tile_size();
-      dst_xy.y() = return_value.y() * d->m_color_tiles.tile_size();
-      sz = d->m_color_tiles.tile_size();
+      dst_xy.x() = return_value.x() * tiles.tile_size();
+      dst_xy.y() = return_value.y() * tiles.tile_size();
+      sz = tiles.tile_size();
 
       for (int level = 0; sz > 0; ++level, sz /= 2, dst_xy /= 2)
         {
-          d->m_color_store->set_data(level, dst_xy, return_value.z(),
-                                     sz, color_data);
+          d->m_color_stores[C]->set_data(level, dst_xy, return_value.z(),
+                                         sz, color_data);
         }
     }
 
@@ -1096,32 +1854,34 @@ add_color_tile(u8vec4 color_data)
 
 fastuidraw::ivec3
 fastuidraw::ImageAtlas::
-add_color_tile(ivec2 src_xy, const ImageSourceBase &image_data)
+add_color_tile(enum color_store_t C, ivec2 src_xy, const ImageSourceBase &image_data)
 {
   ImageAtlasPrivate *d;
   d = static_cast<ImageAtlasPrivate*>(m_d);
   ivec3 return_value;
   std::lock_guard<std::mutex> M(d->m_mutex);
+  tile_allocator &tiles(d->m_color_tiles[C]);
   ivec2 dst_xy;
   int sz, level, end_level;
 
-  return_value = d->m_color_tiles.allocate_tile();
+  FASTUIDRAWassert(d->m_color_stores[C]);
+  return_value = tiles.allocate_tile();
   if (return_value != ivec3(-1, -1, -1))
     {
-      dst_xy.x() = return_value.x() * d->m_color_tiles.tile_size();
-      dst_xy.y() = return_value.y() * d->m_color_tiles.tile_size();
-      sz = d->m_color_tiles.tile_size();
+      dst_xy.x() = return_value.x() * tiles.tile_size();
+      dst_xy.y() = return_value.y() * tiles.tile_size();
+      sz = tiles.tile_size();
       end_level = image_data.number_levels();
 
       for (level = 0; level < end_level && sz > 0; ++level, sz /= 2, dst_xy /= 2, src_xy /= 2)
         {
-          d->m_color_store->set_data(level, dst_xy, return_value.z(), src_xy, sz, image_data);
+          d->m_color_stores[C]->set_data(level, dst_xy, return_value.z(), src_xy, sz, image_data);
         }
 
       for (; sz > 0; ++level, sz /= 2, dst_xy /= 2, src_xy /= 2, sz /= 2)
         {
-          d->m_color_store->set_data(level, dst_xy, return_value.z(), sz,
-                                     u8vec4(255u, 255u, 0u, 255u));
+          d->m_color_stores[C]->set_data(level, dst_xy, return_value.z(), sz,
+                                         u8vec4(255u, 255u, 0u, 255u));
         }
     }
 
@@ -1130,12 +1890,12 @@ add_color_tile(ivec2 src_xy, const ImageSourceBase &image_data)
 
 void
 fastuidraw::ImageAtlas::
-delete_color_tile(fastuidraw::ivec3 tile)
+delete_color_tile(enum color_store_t C, fastuidraw::ivec3 tile)
 {
   ImageAtlasPrivate *d;
   d = static_cast<ImageAtlasPrivate*>(m_d);
   std::lock_guard<std::mutex> M(d->m_mutex);
-  d->m_color_tiles.delete_tile(tile);
+  d->m_color_tiles[C].delete_tile(tile);
 }
 
 void
@@ -1144,6 +1904,7 @@ flush(void) const
 {
   ImageAtlasPrivate *d;
   d = static_cast<ImageAtlasPrivate*>(m_d);
+  TraceEvents::Scope trace("ImageAtlas", "flush");
   std::lock_guard<std::mutex> M(d->m_mutex);
 
   if (d->m_index_store)
@@ -1151,19 +1912,47 @@ flush(void) const
       d->m_index_store->flush();
     }
 
-  if (d->m_color_store)
+  for (const auto &color_store : d->m_color_stores)
     {
-      d->m_color_store->flush();
+      if (color_store)
+        {
+          color_store->flush();
+        }
     }
 }
 
 const fastuidraw::reference_counted_ptr<const fastuidraw::AtlasColorBackingStoreBase>&
 fastuidraw::ImageAtlas::
 color_store(void) const
+{
+  return color_store(rgba8_color_store);
+}
+
+const fastuidraw::reference_counted_ptr<const fastuidraw::AtlasColorBackingStoreBase>&
+fastuidraw::ImageAtlas::
+color_store(enum color_store_t C) const
 {
   ImageAtlasPrivate *d;
   d = static_cast<ImageAtlasPrivate*>(m_d);
-  return d->m_color_store_constant;
+  return d->m_color_stores_constant[C];
+}
+
+enum fastuidraw::ImageAtlas::color_store_t
+fastuidraw::ImageAtlas::
+color_store_for_format(enum Image::format_t fmt)
+{
+  switch (fmt)
+    {
+    case Image::alpha_format:
+    case Image::luminance_format:
+      return r8_color_store;
+
+    case Image::luminance_alpha_format:
+      return rg8_color_store;
+
+    default:
+      return rgba8_color_store;
+    }
 }
 
 const fastuidraw::reference_counted_ptr<const fastuidraw::AtlasIndexBackingStoreBase>&
@@ -1186,16 +1975,17 @@ resizeable(void) const
 
 void
 fastuidraw::ImageAtlas::
-resize_to_fit(int num_color_tiles, int num_index_tiles)
+resize_to_fit(enum color_store_t C, int num_color_tiles, int num_index_tiles)
 {
   ImageAtlasPrivate *d;
   d = static_cast<ImageAtlasPrivate*>(m_d);
 
   std::lock_guard<std::mutex> M(d->m_mutex);
   FASTUIDRAWassert(d->m_resizeable);
-  if (d->m_color_tiles.resize_to_fit(num_color_tiles))
+  FASTUIDRAWassert(d->m_color_stores[C]);
+  if (d->m_color_tiles[C].resize_to_fit(num_color_tiles))
     {
-      d->m_color_store->resize(d->m_color_tiles.num_tiles().z());
+      d->m_color_stores[C]->resize(d->m_color_tiles[C].num_tiles().z());
     }
   if (d->m_index_tiles.resize_to_fit(num_index_tiles))
     {
@@ -1224,10 +2014,12 @@ create_image_on_atlas(int w, int h, const ImageSourceBase &image_data)
   int tile_interior_size;
   ivec2 num_color_tiles;
   int index_tiles;
+  enum color_store_t C;
   ImageAtlasPrivate *d;
+  TraceEvents::Scope trace("ImageAtlas", "create_image_on_atlas");
 
   d = static_cast<ImageAtlasPrivate*>(m_d);
-  if (w <= 0 || h <= 0 || !d->m_color_store || !d->m_index_store)
+  if (w <= 0 || h <= 0 || !d->m_color_stores[rgba8_color_store] || !d->m_index_store)
     {
       return reference_counted_ptr<Image>();
     }
@@ -1238,8 +2030,9 @@ create_image_on_atlas(int w, int h, const ImageSourceBase &image_data)
       return reference_counted_ptr<Image>();
     }
 
+  C = atlas_color_store(*this, image_data.format());
   num_color_tiles = divide_up(ivec2(w, h), tile_interior_size);
-  if (!enough_room_in_atlas(num_color_tiles, this, index_tiles))
+  if (!enough_room_in_atlas(num_color_tiles, this, C, index_tiles))
     {
       /* TODO:
        * there actually might be enough room if we take into account
@@ -1249,7 +2042,7 @@ create_image_on_atlas(int w, int h, const ImageSourceBase &image_data)
        */
       if (resizeable())
         {
-          resize_to_fit(num_color_tiles.x() * num_color_tiles.y(), index_tiles);
+          resize_to_fit(C, num_color_tiles.x() * num_color_tiles.y(), index_tiles);
         }
       else
         {
@@ -1277,10 +2070,37 @@ create_non_atlas(int w, int h, const ImageSourceBase &image_data)
 fastuidraw::reference_counted_ptr<fastuidraw::Image>
 fastuidraw::ImageAtlas::
 create(int w, int h, const ImageSourceBase &image_data,
-       enum Image::type_t type)
+       enum Image::type_t type, bool detect_compact_format)
 {
   reference_counted_ptr<Image> return_value;
 
+  /* a compressed source is only kept compressed by images
+   * backed by a texture; the atlas holds decoded texels and
+   * is thus used only if no texture backed image is made.
+   */
+  if (image_data.compression() != ImageSourceBase::uncompressed)
+    {
+      return_value = (type == Image::context_texture2d) ?
+        create_image_context_texture2d(w, h, image_data) :
+        create_non_atlas(w, h, image_data);
+      if (return_value)
+        {
+          return return_value;
+        }
+      return create_image_on_atlas(w, h, image_data);
+    }
+
+  if (detect_compact_format)
+    {
+      enum Image::format_t fmt;
+
+      fmt = image_data.compact_format(ivec2(w, h));
+      if (fmt != image_data.format())
+        {
+          return create(w, h, ImageSourceWithFormat(image_data, fmt), type, false);
+        }
+    }
+
   if (type == Image::bindless_texture2d)
     {
       return_value = create_image_bindless(w, h, image_data);
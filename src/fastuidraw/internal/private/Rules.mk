@@ -13,12 +13,17 @@ include $(dir)/Rules.mk
 dir := $(d)/gl_backend
 include $(dir)/Rules.mk
 
+dir := $(d)/cpu_backend
+include $(dir)/Rules.mk
+
 FASTUIDRAW_PRIVATE_SOURCES += $(call filelist, \
 	interval_allocator.cpp \
 	path_util_private.cpp \
 	clip.cpp int_path.cpp \
 	util_private_math.cpp \
-	pack_texels.cpp rect_atlas.cpp)
+	pack_texels.cpp rect_atlas.cpp \
+	thread_pool.cpp texture_block_decode.cpp \
+	downsample_texels.cpp)
 
 # Begin standard footer
 d		:= $(dirstack_$(sp))
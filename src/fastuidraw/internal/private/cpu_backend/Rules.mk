@@ -0,0 +1,15 @@
+# Begin standard header
+sp 		:= $(sp).x
+dirstack_$(sp)	:= $(d)
+d		:= $(dir)
+# End standard header
+
+FASTUIDRAW_PRIVATE_SOURCES += $(call filelist, \
+	atlases_cpu.cpp painter_shader_registrar_cpu.cpp \
+	backend_shaders_cpu.cpp item_shaders_cpu.cpp brush_cpu.cpp \
+	rasterizer_cpu.cpp painter_backend_cpu.cpp)
+
+# Begin standard footer
+d		:= $(dirstack_$(sp))
+sp		:= $(basename $(sp))
+# End standard footer
@@ -0,0 +1,381 @@
+/*!
+ * \file atlases_cpu.cpp
+ * \brief file atlases_cpu.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <vector>
+#include <algorithm>
+#include <private/util_private.hpp>
+#include <private/cpu_backend/image_cpu.hpp>
+#include <private/cpu_backend/atlases_cpu.hpp>
+
+namespace
+{
+  /* Number of tiles per row and column of a layer
+   * of the color and index stores of ImageAtlasCPU.
+   */
+  enum
+    {
+      log2_num_color_tiles_per_row_per_col = 5,
+      log2_num_index_tiles_per_row_per_col = 6,
+      initial_num_color_layers = 1,
+      initial_num_index_layers = 1,
+    };
+
+  class GlyphStoreCPU:public fastuidraw::GlyphAtlasBackingStoreBase
+  {
+  public:
+    explicit
+    GlyphStoreCPU(unsigned int number):
+      fastuidraw::GlyphAtlasBackingStoreBase(number, true),
+      m_data(number)
+    {}
+
+    virtual
+    void
+    set_values(unsigned int location,
+               fastuidraw::c_array<const fastuidraw::generic_data> pdata)
+    {
+      FASTUIDRAWassert(location + pdata.size() <= m_data.size());
+      std::copy(pdata.begin(), pdata.end(), m_data.begin() + location);
+    }
+
+    virtual
+    void
+    flush(void)
+    {}
+
+    std::vector<fastuidraw::generic_data> m_data;
+
+  protected:
+    virtual
+    void
+    resize_implement(unsigned int new_size)
+    {
+      m_data.resize(new_size);
+    }
+  };
+
+  class ColorStopStoreCPU:public fastuidraw::ColorStopBackingStore
+  {
+  public:
+    explicit
+    ColorStopStoreCPU(int w, int l):
+      fastuidraw::ColorStopBackingStore(w, l, true),
+      m_texels(w * l)
+    {}
+
+    virtual
+    void
+    set_data(int x, int l, int w,
+             fastuidraw::c_array<const fastuidraw::u8vec4> data)
+    {
+      FASTUIDRAWassert(w == static_cast<int>(data.size()));
+      std::copy(data.begin(), data.begin() + w,
+                m_texels.begin() + x + l * dimensions().x());
+    }
+
+    std::vector<fastuidraw::u8vec4> m_texels;
+
+  protected:
+    virtual
+    void
+    resize_implement(int new_num_layers)
+    {
+      m_texels.resize(new_num_layers * dimensions().x());
+    }
+  };
+
+  /* The layers are allocated seperately so that resizing
+   * does not copy the texels.
+   */
+  class ColorBackingStoreCPU:public fastuidraw::AtlasColorBackingStoreBase
+  {
+  public:
+    ColorBackingStoreCPU(int log2_tile_size, int number_layers):
+      fastuidraw::AtlasColorBackingStoreBase(store_size(log2_tile_size, number_layers), true)
+    {
+      resize_implement(number_layers);
+    }
+
+    virtual
+    void
+    set_data(int mipmap_level, fastuidraw::ivec2 dst_xy, int dst_l, fastuidraw::ivec2 src_xy,
+             unsigned int size, const fastuidraw::ImageSourceBase &image_data)
+    {
+      /* only the highest level of detail is sampled */
+      if (mipmap_level != 0)
+        {
+          return;
+        }
+
+      m_scratch.resize(size * size);
+      image_data.fetch_texels(0, src_xy, size, size,
+                              fastuidraw::make_c_array(m_scratch));
+      for (unsigned int y = 0; y < size; ++y)
+        {
+          std::copy(m_scratch.begin() + y * size,
+                    m_scratch.begin() + (y + 1) * size,
+                    texel_ptr(dst_xy.x(), dst_xy.y() + y, dst_l));
+        }
+    }
+
+    virtual
+    void
+    set_data(int mipmap_level, fastuidraw::ivec2 dst_xy, int dst_l,
+             unsigned int size, fastuidraw::u8vec4 color_value)
+    {
+      if (mipmap_level != 0)
+        {
+          return;
+        }
+
+      for (unsigned int y = 0; y < size; ++y)
+        {
+          fastuidraw::u8vec4 *p(texel_ptr(dst_xy.x(), dst_xy.y() + y, dst_l));
+          std::fill(p, p + size, color_value);
+        }
+    }
+
+    virtual
+    void
+    flush(void)
+    {}
+
+    fastuidraw::u8vec4*
+    texel_ptr(int x, int y, int l)
+    {
+      return &m_layers[l][x + y * dimensions().x()];
+    }
+
+    fastuidraw::u8vec4
+    texel(int x, int y, int l) const
+    {
+      return m_layers[l][x + y * dimensions().x()];
+    }
+
+  protected:
+    virtual
+    void
+    resize_implement(int new_num_layers)
+    {
+      int w(dimensions().x());
+
+      m_layers.resize(new_num_layers);
+      for (std::vector<fastuidraw::u8vec4> &L : m_layers)
+        {
+          L.resize(w * w);
+        }
+    }
+
+  private:
+    static
+    fastuidraw::ivec3
+    store_size(int log2_tile_size, int num_layers)
+    {
+      int v(1 << (log2_num_color_tiles_per_row_per_col + log2_tile_size));
+      return fastuidraw::ivec3(v, v, num_layers);
+    }
+
+    std::vector<std::vector<fastuidraw::u8vec4> > m_layers;
+    std::vector<fastuidraw::u8vec4> m_scratch;
+  };
+
+  class IndexBackingStoreCPU:public fastuidraw::AtlasIndexBackingStoreBase
+  {
+  public:
+    IndexBackingStoreCPU(int log2_tile_size, int number_layers):
+      fastuidraw::AtlasIndexBackingStoreBase(store_size(log2_tile_size, number_layers), true)
+    {
+      resize_implement(number_layers);
+    }
+
+    virtual
+    void
+    set_data(int x, int y, int l, int w, int h,
+             fastuidraw::c_array<const fastuidraw::ivec3> data)
+    {
+      for (int b = 0; b < h; ++b)
+        {
+          std::copy(data.begin() + b * w, data.begin() + (b + 1) * w,
+                    m_layers[l].begin() + x + (y + b) * dimensions().x());
+        }
+    }
+
+    virtual
+    void
+    flush(void)
+    {}
+
+    fastuidraw::ivec3
+    texel(int x, int y, int l) const
+    {
+      return m_layers[l][x + y * dimensions().x()];
+    }
+
+  protected:
+    virtual
+    void
+    resize_implement(int new_num_layers)
+    {
+      int w(dimensions().x());
+
+      m_layers.resize(new_num_layers);
+      for (std::vector<fastuidraw::ivec3> &L : m_layers)
+        {
+          L.resize(w * w);
+        }
+    }
+
+  private:
+    static
+    fastuidraw::ivec3
+    store_size(int log2_tile_size, int num_layers)
+    {
+      int v(1 << (log2_num_index_tiles_per_row_per_col + log2_tile_size));
+      return fastuidraw::ivec3(v, v, num_layers);
+    }
+
+    std::vector<std::vector<fastuidraw::ivec3> > m_layers;
+  };
+}
+
+///////////////////////////////////////////////
+// fastuidraw::cpu::detail::GlyphAtlasCPU methods
+fastuidraw::cpu::detail::GlyphAtlasCPU::
+GlyphAtlasCPU(unsigned int initial_size):
+  GlyphAtlas(FASTUIDRAWnew GlyphStoreCPU(initial_size))
+{
+}
+
+fastuidraw::c_array<const fastuidraw::generic_data>
+fastuidraw::cpu::detail::GlyphAtlasCPU::
+data(void) const
+{
+  const GlyphStoreCPU *p;
+
+  FASTUIDRAWassert(dynamic_cast<const GlyphStoreCPU*>(store().get()));
+  p = static_cast<const GlyphStoreCPU*>(store().get());
+  return make_c_array(p->m_data);
+}
+
+///////////////////////////////////////////////
+// fastuidraw::cpu::detail::ColorStopAtlasCPU methods
+fastuidraw::cpu::detail::ColorStopAtlasCPU::
+ColorStopAtlasCPU(int width):
+  ColorStopAtlas(FASTUIDRAWnew ColorStopStoreCPU(width, 1))
+{
+}
+
+fastuidraw::c_array<const fastuidraw::u8vec4>
+fastuidraw::cpu::detail::ColorStopAtlasCPU::
+texels(void) const
+{
+  const ColorStopStoreCPU *p;
+
+  FASTUIDRAWassert(dynamic_cast<const ColorStopStoreCPU*>(backing_store().get()));
+  p = static_cast<const ColorStopStoreCPU*>(backing_store().get());
+  return make_c_array(p->m_texels);
+}
+
+int
+fastuidraw::cpu::detail::ColorStopAtlasCPU::
+width(void) const
+{
+  return backing_store()->dimensions().x();
+}
+
+///////////////////////////////////////////////
+// fastuidraw::cpu::detail::ImageAtlasCPU methods
+fastuidraw::cpu::detail::ImageAtlasCPU::
+ImageAtlasCPU(const PainterEngineCPU::ConfigurationCPU &config):
+  ImageAtlas(1 << config.log2_color_tile_size(),
+             1 << config.log2_index_tile_size(),
+             FASTUIDRAWnew ColorBackingStoreCPU(config.log2_color_tile_size(),
+                                                initial_num_color_layers),
+             FASTUIDRAWnew IndexBackingStoreCPU(config.log2_index_tile_size(),
+                                                initial_num_index_layers))
+{
+}
+
+fastuidraw::u8vec4
+fastuidraw::cpu::detail::ImageAtlasCPU::
+color_texel(int x, int y, int layer) const
+{
+  const ColorBackingStoreCPU *p;
+  p = static_cast<const ColorBackingStoreCPU*>(color_store().get());
+  return p->texel(x, y, layer);
+}
+
+fastuidraw::ivec3
+fastuidraw::cpu::detail::ImageAtlasCPU::
+index_texel(int x, int y, int layer) const
+{
+  const IndexBackingStoreCPU *p;
+  p = static_cast<const IndexBackingStoreCPU*>(index_store().get());
+  return p->texel(x, y, layer);
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::Image>
+fastuidraw::cpu::detail::ImageAtlasCPU::
+create_image_bindless(int w, int h, const ImageSourceBase &image_data)
+{
+  return ImageCPU::create(*this, w, h, image_data, Image::bindless_texture2d);
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::Image>
+fastuidraw::cpu::detail::ImageAtlasCPU::
+create_image_context_texture2d(int w, int h, const ImageSourceBase &image_data)
+{
+  return ImageCPU::create(*this, w, h, image_data, Image::context_texture2d);
+}
+
+///////////////////////////////////////////////
+// fastuidraw::cpu::detail::ImageCPU methods
+fastuidraw::cpu::detail::ImageCPU::
+ImageCPU(ImageAtlas &atlas,
+         const reference_counted_ptr<TexelStore> &texels,
+         enum type_t type, enum format_t fmt):
+  Image(atlas, texels->m_dimensions.x(), texels->m_dimensions.y(), 1, type,
+        static_cast<uint64_t>(reinterpret_cast<uintptr_t>(texels.get())),
+        fmt),
+  m_texels(texels)
+{
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::Image>
+fastuidraw::cpu::detail::ImageCPU::
+create(ImageAtlas &atlas, int w, int h,
+       const ImageSourceBase &image_data,
+       enum type_t type)
+{
+  reference_counted_ptr<TexelStore> texels;
+
+  texels = FASTUIDRAWnew TexelStore(ivec2(w, h));
+  image_data.fetch_texels(0, ivec2(0, 0), texels->m_dimensions.x(),
+                          texels->m_dimensions.y(),
+                          make_c_array(texels->m_texels));
+  return FASTUIDRAWnew ImageCPU(atlas, texels, type, image_data.format());
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::Image>
+fastuidraw::cpu::detail::ImageCPU::
+create(ImageAtlas &atlas,
+       const reference_counted_ptr<TexelStore> &texels,
+       enum format_t fmt)
+{
+  return FASTUIDRAWnew ImageCPU(atlas, texels, Image::bindless_texture2d, fmt);
+}
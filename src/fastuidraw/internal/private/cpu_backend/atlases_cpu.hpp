@@ -0,0 +1,94 @@
+/*!
+ * \file atlases_cpu.hpp
+ * \brief file atlases_cpu.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include <fastuidraw/image_atlas.hpp>
+#include <fastuidraw/colorstop_atlas.hpp>
+#include <fastuidraw/text/glyph_atlas.hpp>
+#include <fastuidraw/cpu_backend/painter_engine_cpu.hpp>
+
+namespace fastuidraw { namespace cpu { namespace detail {
+
+/* GlyphAtlasCPU is a GlyphAtlas backed by an array in
+ * system memory.
+ */
+class GlyphAtlasCPU:public GlyphAtlas
+{
+public:
+  explicit
+  GlyphAtlasCPU(unsigned int initial_size);
+
+  /* The values of the backing store. The returned array
+   * is invalidated when the store is resized.
+   */
+  c_array<const generic_data>
+  data(void) const;
+};
+
+/* ColorStopAtlasCPU is a ColorStopAtlas backed by an
+ * array in system memory; the texels of layer L start
+ * at L * width.
+ */
+class ColorStopAtlasCPU:public ColorStopAtlas
+{
+public:
+  explicit
+  ColorStopAtlasCPU(int width);
+
+  c_array<const u8vec4>
+  texels(void) const;
+
+  int
+  width(void) const;
+};
+
+/* ImageAtlasCPU is an ImageAtlas whose color and index
+ * stores are held in system memory; images that are not
+ * on the atlas are realized as ImageCPU objects.
+ */
+class ImageAtlasCPU:public ImageAtlas
+{
+public:
+  explicit
+  ImageAtlasCPU(const PainterEngineCPU::ConfigurationCPU &config);
+
+  /* Returns the texel at location (x, y) of the given layer
+   * of the color store.
+   */
+  u8vec4
+  color_texel(int x, int y, int layer) const;
+
+  /* Returns the index tile value at location (x, y) of the
+   * given layer of the index store.
+   */
+  ivec3
+  index_texel(int x, int y, int layer) const;
+
+private:
+  virtual
+  reference_counted_ptr<Image>
+  create_image_bindless(int w, int h, const ImageSourceBase &image_data);
+
+  virtual
+  reference_counted_ptr<Image>
+  create_image_context_texture2d(int w, int h, const ImageSourceBase &image_data);
+};
+
+}}}
@@ -0,0 +1,228 @@
+/*!
+ * \file backend_shaders_cpu.cpp
+ * \brief file backend_shaders_cpu.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <fastuidraw/painter/painter_stroke_params.hpp>
+#include <fastuidraw/painter/painter_dashed_stroke_params.hpp>
+#include <private/cpu_backend/backend_shaders_cpu.hpp>
+
+namespace fastuidraw { namespace cpu { namespace detail {
+
+///////////////////////////////////////
+// ShaderSetCreator methods
+ShaderSetCreator::
+ShaderSetCreator(void)
+{
+  unsigned int num_sub_shaders(PainterEnums::number_cap_styles + 1u);
+
+  m_stroke_coverage_shader = FASTUIDRAWnew ItemCoverageShaderCPU(stroke_coverage_shader, num_sub_shaders);
+  m_stroke_aa_shader = FASTUIDRAWnew ItemShaderCPU(stroke_aa_shader, num_sub_shaders);
+  m_stroke_non_aa_shader = FASTUIDRAWnew ItemShaderCPU(stroke_non_aa_shader, num_sub_shaders);
+
+  m_fall_through_shader = FASTUIDRAWnew PainterBlendShader(PainterBlendShader::single_src);
+}
+
+PainterBlendShaderSet
+ShaderSetCreator::
+create_blend_shaders(void)
+{
+  /* The blend modes realizable by BlendMode alone match the
+   * single source blending of the GLSL backend; the other W3C
+   * blend modes are realized by the rasterizer reading the
+   * color buffer, as the framebuffer fetch blending of the
+   * GLSL backend does.
+   */
+  const enum PainterEnums::blend_mode_t w3c_modes[] =
+    {
+      PainterEnums::blend_w3c_overlay,
+      PainterEnums::blend_w3c_darken,
+      PainterEnums::blend_w3c_lighten,
+      PainterEnums::blend_w3c_color_dodge,
+      PainterEnums::blend_w3c_color_burn,
+      PainterEnums::blend_w3c_hardlight,
+      PainterEnums::blend_w3c_softlight,
+      PainterEnums::blend_w3c_difference,
+      PainterEnums::blend_w3c_exclusion,
+      PainterEnums::blend_w3c_multiply,
+      PainterEnums::blend_w3c_hue,
+      PainterEnums::blend_w3c_saturation,
+      PainterEnums::blend_w3c_color,
+      PainterEnums::blend_w3c_luminosity,
+    };
+  PainterBlendShaderSet shaders;
+
+  shaders
+    .shader(PainterEnums::blend_porter_duff_src_over,
+            BlendMode().func(BlendMode::ONE, BlendMode::ONE_MINUS_SRC_ALPHA),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_dst_over,
+            BlendMode().func(BlendMode::ONE_MINUS_DST_ALPHA, BlendMode::ONE),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_clear,
+            BlendMode().func(BlendMode::ZERO, BlendMode::ZERO),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_src,
+            BlendMode().func(BlendMode::ONE, BlendMode::ZERO),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_dst,
+            BlendMode().func(BlendMode::ZERO, BlendMode::ONE),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_src_in,
+            BlendMode().func(BlendMode::DST_ALPHA, BlendMode::ZERO),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_dst_in,
+            BlendMode().func(BlendMode::ZERO, BlendMode::SRC_ALPHA),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_src_out,
+            BlendMode().func(BlendMode::ONE_MINUS_DST_ALPHA, BlendMode::ZERO),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_dst_out,
+            BlendMode().func(BlendMode::ZERO, BlendMode::ONE_MINUS_SRC_ALPHA),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_src_atop,
+            BlendMode().func(BlendMode::DST_ALPHA, BlendMode::ONE_MINUS_SRC_ALPHA),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_dst_atop,
+            BlendMode().func(BlendMode::ONE_MINUS_DST_ALPHA, BlendMode::SRC_ALPHA),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_xor,
+            BlendMode().func(BlendMode::ONE_MINUS_DST_ALPHA, BlendMode::ONE_MINUS_SRC_ALPHA),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_plus,
+            BlendMode().func(BlendMode::ONE, BlendMode::ONE),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_porter_duff_modulate,
+            BlendMode()
+            .func_src_rgb(BlendMode::DST_COLOR)
+            .func_src_alpha(BlendMode::DST_ALPHA)
+            .func_dst(BlendMode::ZERO),
+            m_fall_through_shader)
+    .shader(PainterEnums::blend_w3c_screen,
+            BlendMode()
+            .func_src(BlendMode::ONE)
+            .func_dst_rgb(BlendMode::ONE_MINUS_SRC_COLOR)
+            .func_dst_alpha(BlendMode::ONE_MINUS_SRC_ALPHA),
+            m_fall_through_shader);
+
+  for (enum PainterEnums::blend_mode_t md : w3c_modes)
+    {
+      shaders.shader(md, BlendMode().blending_on(false),
+                     FASTUIDRAWnew BlendShaderCPU(md));
+    }
+
+  return shaders;
+}
+
+PainterGlyphShader
+ShaderSetCreator::
+create_glyph_shader(void)
+{
+  PainterGlyphShader return_value;
+
+  return_value
+    .shader(coverage_glyph,
+            FASTUIDRAWnew ItemShaderCPU(glyph_coverage_shader, 1))
+    .shader(restricted_rays_glyph,
+            FASTUIDRAWnew ItemShaderCPU(glyph_restricted_rays_shader, 1))
+    .shader(distance_field_glyph,
+            FASTUIDRAWnew ItemShaderCPU(glyph_distance_field_shader, 1))
+    .shader(banded_rays_glyph,
+            FASTUIDRAWnew ItemShaderCPU(glyph_banded_rays_shader, 1))
+    .shader(multi_channel_distance_field_glyph,
+            FASTUIDRAWnew ItemShaderCPU(glyph_multi_channel_distance_field_shader, 1));
+
+  return return_value;
+}
+
+PainterStrokeShader
+ShaderSetCreator::
+create_stroke_shader(enum PainterEnums::cap_style cap_style,
+                     const reference_counted_ptr<const StrokingDataSelectorBase> &stroke_data_selector)
+{
+  PainterStrokeShader return_value;
+  reference_counted_ptr<PainterItemCoverageShader> cvg;
+  reference_counted_ptr<PainterItemShader> non_aa, aa;
+  uint32_t sub(sub_shader(cap_style));
+
+  cvg = FASTUIDRAWnew PainterItemCoverageShader(m_stroke_coverage_shader, sub);
+  aa = FASTUIDRAWnew PainterItemShader(m_stroke_aa_shader, sub, cvg);
+  non_aa = FASTUIDRAWnew PainterItemShader(m_stroke_non_aa_shader, sub);
+
+  /* arc-stroking is not implemented by the CPU backend, the
+   * arc shaders are left as nullptr so that Painter strokes
+   * a Path with the linear shaders instead.
+   */
+  return_value
+    .stroking_data_selector(stroke_data_selector)
+    .shader(PainterEnums::stroking_method_linear, PainterStrokeShader::non_aa_shader, non_aa)
+    .shader(PainterEnums::stroking_method_linear, PainterStrokeShader::aa_shader, aa)
+    .fastest_non_anti_aliased_stroking_method(PainterEnums::stroking_method_linear)
+    .fastest_anti_aliased_stroking_method(PainterEnums::stroking_method_linear);
+
+  return return_value;
+}
+
+PainterDashedStrokeShaderSet
+ShaderSetCreator::
+create_dashed_stroke_shader_set(void)
+{
+  PainterDashedStrokeShaderSet return_value;
+  reference_counted_ptr<const StrokingDataSelectorBase> se;
+
+  se = PainterDashedStrokeParams::stroking_data_selector(false);
+  return_value
+    .shader(PainterEnums::flat_caps, create_stroke_shader(PainterEnums::flat_caps, se))
+    .shader(PainterEnums::rounded_caps, create_stroke_shader(PainterEnums::rounded_caps, se))
+    .shader(PainterEnums::square_caps, create_stroke_shader(PainterEnums::square_caps, se))
+    .cpu_dash_edge_shader(create_stroke_shader(PainterEnums::number_cap_styles, se));
+  return return_value;
+}
+
+PainterFillShader
+ShaderSetCreator::
+create_fill_shader(void)
+{
+  PainterFillShader return_value;
+  reference_counted_ptr<PainterItemCoverageShader> aa_fuzz_coverage;
+
+  aa_fuzz_coverage = FASTUIDRAWnew ItemCoverageShaderCPU(fill_aa_fuzz_coverage_shader, 1);
+  return_value
+    .item_shader(FASTUIDRAWnew ItemShaderCPU(fill_shader, 1))
+    .aa_fuzz_shader(FASTUIDRAWnew ItemShaderCPU(fill_aa_fuzz_shader, 1, aa_fuzz_coverage));
+
+  return return_value;
+}
+
+PainterShaderSet
+ShaderSetCreator::
+create_shader_set(void)
+{
+  PainterShaderSet return_value;
+  reference_counted_ptr<const StrokingDataSelectorBase> se;
+
+  se = PainterStrokeParams::stroking_data_selector(false);
+  return_value
+    .glyph_shader(create_glyph_shader())
+    .stroke_shader(create_stroke_shader(PainterEnums::number_cap_styles, se))
+    .dashed_stroke_shader(create_dashed_stroke_shader_set())
+    .fill_shader(create_fill_shader())
+    .blend_shaders(create_blend_shaders())
+    .blur_brush_shader(FASTUIDRAWnew CustomBrushShaderCPU(blur_brush_shader));
+  return return_value;
+}
+
+}}}
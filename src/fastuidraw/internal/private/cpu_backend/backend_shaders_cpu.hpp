@@ -0,0 +1,74 @@
+/*!
+ * \file backend_shaders_cpu.hpp
+ * \brief file backend_shaders_cpu.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <fastuidraw/painter/shader/painter_shader_set.hpp>
+#include <private/cpu_backend/painter_shader_registrar_cpu.hpp>
+
+namespace fastuidraw { namespace cpu { namespace detail {
+
+/* ShaderSetCreator creates the default shaders of the CPU
+ * backend following the same conventions as the GLSL
+ * backend's ShaderSetCreator so that the Painter packs
+ * the same data for either backend.
+ */
+class ShaderSetCreator
+{
+public:
+  ShaderSetCreator(void);
+
+  PainterShaderSet
+  create_shader_set(void);
+
+  /* Returns the sub-shader value used by the stroking
+   * shaders to encode the dash cap style.
+   */
+  static
+  uint32_t
+  sub_shader(enum PainterEnums::cap_style stroke_dash_style)
+  {
+    return (stroke_dash_style == PainterEnums::number_cap_styles) ?
+      0u :
+      1u + uint32_t(stroke_dash_style);
+  }
+
+private:
+  PainterBlendShaderSet
+  create_blend_shaders(void);
+
+  PainterGlyphShader
+  create_glyph_shader(void);
+
+  PainterStrokeShader
+  create_stroke_shader(enum PainterEnums::cap_style cap_style,
+                       const reference_counted_ptr<const StrokingDataSelectorBase> &stroke_data_selector);
+
+  PainterDashedStrokeShaderSet
+  create_dashed_stroke_shader_set(void);
+
+  PainterFillShader
+  create_fill_shader(void);
+
+  reference_counted_ptr<PainterItemShader> m_stroke_non_aa_shader;
+  reference_counted_ptr<PainterItemShader> m_stroke_aa_shader;
+  reference_counted_ptr<PainterItemCoverageShader> m_stroke_coverage_shader;
+  reference_counted_ptr<PainterBlendShader> m_fall_through_shader;
+};
+
+}}}
@@ -0,0 +1,699 @@
+/*!
+ * \file brush_cpu.cpp
+ * \brief file brush_cpu.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <fastuidraw/util/math.hpp>
+#include <fastuidraw/painter/effects/painter_blur_brush_shader_data.hpp>
+#include <private/cpu_backend/brush_cpu.hpp>
+
+namespace
+{
+  inline
+  float
+  glsl_mod(float x, float y)
+  {
+    return x - y * std::floor(x / y);
+  }
+
+  inline
+  float
+  glsl_fract(float x)
+  {
+    return x - std::floor(x);
+  }
+
+  inline
+  float
+  clamp_range(float t, float lo, float hi)
+  {
+    return fastuidraw::t_max(lo, fastuidraw::t_min(hi, t));
+  }
+
+  inline
+  fastuidraw::vec4
+  normalize_texel(fastuidraw::u8vec4 v)
+  {
+    const float recip = 1.0f / 255.0f;
+    return fastuidraw::vec4(recip * float(v.x()), recip * float(v.y()),
+                            recip * float(v.z()), recip * float(v.w()));
+  }
+
+  inline
+  fastuidraw::vec4
+  mix(const fastuidraw::vec4 &a, const fastuidraw::vec4 &b, float t)
+  {
+    return a + t * (b - a);
+  }
+
+  /* decode a value packed as according to
+   * PainterBrush::packed_color_stop_color_encoding
+   */
+  inline
+  fastuidraw::vec4
+  unpack_packed_color(uint32_t v)
+  {
+    using namespace fastuidraw;
+
+    u8vec4 c;
+    c.x() = unpack_bits(PainterBrush::packed_color_stop_red_bit0,
+                        PainterBrush::packed_color_stop_channel_num_bits, v);
+    c.y() = unpack_bits(PainterBrush::packed_color_stop_green_bit0,
+                        PainterBrush::packed_color_stop_channel_num_bits, v);
+    c.z() = unpack_bits(PainterBrush::packed_color_stop_blue_bit0,
+                        PainterBrush::packed_color_stop_channel_num_bits, v);
+    c.w() = unpack_bits(PainterBrush::packed_color_stop_alpha_bit0,
+                        PainterBrush::packed_color_stop_channel_num_bits, v);
+    return normalize_texel(c);
+  }
+
+  /* fastuidraw_brush_apply_spread */
+  float
+  apply_spread(float t, float range, uint32_t spread_type)
+  {
+    switch (spread_type)
+      {
+      case fastuidraw::PainterBrush::spread_mirror:
+        return clamp_range(fastuidraw::t_abs(t), 0.0f, range);
+
+      case fastuidraw::PainterBrush::spread_repeat:
+        return glsl_mod(t, range);
+
+      case fastuidraw::PainterBrush::spread_mirror_repeat:
+        return range - fastuidraw::t_abs(glsl_mod(t, 2.0f * range) - range);
+
+      default:
+        return clamp_range(t, 0.0f, range);
+      }
+  }
+
+  /* the spread pattern on [0, 1] of the gradient */
+  float
+  apply_gradient_spread(float t, uint32_t spread_type)
+  {
+    switch (spread_type)
+      {
+      case fastuidraw::PainterBrush::spread_mirror:
+        return clamp_range(fastuidraw::t_abs(t), 0.0f, 1.0f);
+
+      case fastuidraw::PainterBrush::spread_repeat:
+        return glsl_fract(t);
+
+      case fastuidraw::PainterBrush::spread_mirror_repeat:
+        return 1.0f - fastuidraw::t_abs(glsl_mod(t, 2.0f) - 1.0f);
+
+      default:
+        return clamp_range(t, 0.0f, 1.0f);
+      }
+  }
+}
+
+////////////////////////////////////////////
+// fastuidraw::cpu::detail::BrushState methods
+void
+fastuidraw::cpu::detail::BrushState::
+unpack(const BrushContext &ctx,
+       c_array<const generic_data> store,
+       uint32_t brush_shader,
+       uint32_t brush_shader_data_location)
+{
+  unsigned int current(4u * brush_shader_data_location);
+  uint32_t gradient_type;
+
+  m_shader = brush_shader;
+  m_blur = false;
+
+  m_color.x() = store[current + PainterBrush::color_red_offset].f;
+  m_color.y() = store[current + PainterBrush::color_green_offset].f;
+  m_color.z() = store[current + PainterBrush::color_blue_offset].f;
+  m_color.w() = store[current + PainterBrush::color_alpha_offset].f;
+  current += FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(PainterBrush::color_data_size);
+
+  m_image_type = Image::on_atlas;
+  m_bindless_texels = nullptr;
+  m_image_size = uvec2(1u, 1u);
+  m_image_start = uvec2(0u, 0u);
+  if (m_shader & PainterBrush::image_mask)
+    {
+      uint32_t size_xy, start_xy;
+
+      m_image_type = static_cast<enum Image::type_t>(unpack_bits(PainterBrush::image_type_bit0,
+                                                                 PainterBrush::image_type_num_bits,
+                                                                 m_shader));
+      size_xy = store[current + PainterBrush::image_size_xy_offset].u;
+      start_xy = store[current + PainterBrush::image_start_xy_offset].u;
+
+      m_image_size.x() = unpack_bits(PainterBrush::image_size_x_bit0, PainterBrush::image_size_x_num_bits, size_xy);
+      m_image_size.y() = unpack_bits(PainterBrush::image_size_y_bit0, PainterBrush::image_size_y_num_bits, size_xy);
+      m_image_start.x() = unpack_bits(PainterBrush::image_size_x_bit0, PainterBrush::image_size_x_num_bits, start_xy);
+      m_image_start.y() = unpack_bits(PainterBrush::image_size_y_bit0, PainterBrush::image_size_y_num_bits, start_xy);
+
+      if (m_image_type == Image::on_atlas)
+        {
+          uint32_t loc, index_tile_size;
+          float index_pows;
+
+          loc = store[current + PainterBrush::image_atlas_location_xyz_offset].u;
+          m_number_index_lookups = store[current + PainterBrush::image_number_lookups_offset].u;
+          index_tile_size = ctx.m_image_atlas->index_tile_size();
+
+          /* fastuidraw_compute_image_info */
+          if (m_number_index_lookups >= 1u)
+            {
+              index_pows = std::pow(float(index_tile_size), float(m_number_index_lookups - 1u));
+              m_image_texel_size_on_master_index_tile =
+                1.0f / (float(ctx.m_image_atlas->color_tile_size()) * index_pows);
+            }
+          else
+            {
+              m_image_texel_size_on_master_index_tile = 1.0f;
+            }
+
+          m_master_index_tile_xy.x() =
+            float(index_tile_size * unpack_bits(PainterBrush::image_atlas_location_x_bit0,
+                                                PainterBrush::image_atlas_location_x_num_bits, loc));
+          m_master_index_tile_xy.y() =
+            float(index_tile_size * unpack_bits(PainterBrush::image_atlas_location_y_bit0,
+                                                PainterBrush::image_atlas_location_y_num_bits, loc));
+          m_master_index_tile_xy += vec2(m_image_start) * m_image_texel_size_on_master_index_tile;
+          m_master_index_tile_layer = unpack_bits(PainterBrush::image_atlas_location_z_bit0,
+                                                  PainterBrush::image_atlas_location_z_num_bits, loc);
+        }
+      else if (m_image_type == Image::bindless_texture2d)
+        {
+          uint64_t hi, low;
+
+          hi = store[current + PainterBrush::image_bindless_handle_hi_offset].u;
+          low = store[current + PainterBrush::image_bindless_handle_low_offset].u;
+          m_bindless_texels = ImageCPU::texels_from_bindless_handle((hi << 32u) | low);
+        }
+      else
+        {
+          m_bindless_texels = ctx.m_external_texture;
+        }
+      current += FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(PainterBrush::image_data_size);
+    }
+
+  gradient_type = unpack_bits(PainterBrush::gradient_type_bit0,
+                              PainterBrush::gradient_type_num_bits,
+                              m_shader);
+  if (gradient_type != PainterBrush::no_gradient_type)
+    {
+      uint32_t xy;
+
+      m_gradient_p0.x() = store[current + PainterBrush::gradient_p0_x_offset].f;
+      m_gradient_p0.y() = store[current + PainterBrush::gradient_p0_y_offset].f;
+      m_gradient_p1.x() = store[current + PainterBrush::gradient_p1_x_offset].f;
+      m_gradient_p1.y() = store[current + PainterBrush::gradient_p1_y_offset].f;
+
+      xy = store[current + PainterBrush::gradient_color_stop_xy_offset].u;
+      m_color_stop_x = unpack_bits(PainterBrush::gradient_color_stop_x_bit0,
+                                   PainterBrush::gradient_color_stop_x_num_bits, xy);
+      m_color_stop_y = unpack_bits(PainterBrush::gradient_color_stop_y_bit0,
+                                   PainterBrush::gradient_color_stop_y_num_bits, xy);
+      m_color_stop_length = float(store[current + PainterBrush::gradient_color_stop_length_offset].u);
+
+      if (gradient_type == PainterBrush::radial_gradient_type)
+        {
+          m_gradient_r0 = store[current + PainterBrush::gradient_start_radius_offset].f;
+          m_gradient_r1 = store[current + PainterBrush::gradient_end_radius_offset].f;
+          current += FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(PainterBrush::radial_gradient_data_size);
+        }
+      else
+        {
+          m_gradient_r0 = 0.0f;
+          m_gradient_r1 = 1.0f;
+          current += (gradient_type == PainterBrush::linear_gradient_type) ?
+            FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(PainterBrush::linear_gradient_data_size) :
+            FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(PainterBrush::sweep_gradient_data_size);
+        }
+    }
+
+  if (m_shader & PainterBrush::repeat_window_mask)
+    {
+      m_repeat_window_xy.x() = store[current + PainterBrush::repeat_window_x_offset].f;
+      m_repeat_window_xy.y() = store[current + PainterBrush::repeat_window_y_offset].f;
+      m_repeat_window_wh.x() = store[current + PainterBrush::repeat_window_width_offset].f;
+      m_repeat_window_wh.y() = store[current + PainterBrush::repeat_window_height_offset].f;
+      current += FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(PainterBrush::repeat_window_data_size);
+    }
+
+  if (m_shader & PainterBrush::transformation_matrix_mask)
+    {
+      m_transformation_matrix[0] = store[current + PainterBrush::transformation_matrix_row0_col0_offset].f;
+      m_transformation_matrix[1] = store[current + PainterBrush::transformation_matrix_row0_col1_offset].f;
+      m_transformation_matrix[2] = store[current + PainterBrush::transformation_matrix_row1_col0_offset].f;
+      m_transformation_matrix[3] = store[current + PainterBrush::transformation_matrix_row1_col1_offset].f;
+      current += FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(PainterBrush::transformation_matrix_data_size);
+    }
+  else
+    {
+      m_transformation_matrix = vecN<float, 4>(1.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+  if (m_shader & PainterBrush::transformation_translation_mask)
+    {
+      m_transformation_translation.x() = store[current + PainterBrush::transformation_translation_x_offset].f;
+      m_transformation_translation.y() = store[current + PainterBrush::transformation_translation_y_offset].f;
+      current += FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(PainterBrush::transformation_translation_data_size);
+    }
+  else
+    {
+      m_transformation_translation = vec2(0.0f, 0.0f);
+    }
+
+  if (m_shader & PainterBrush::gradient_packed_color_stops_mask)
+    {
+      m_packed_color_stops_count = static_cast<unsigned int>(m_color_stop_length);
+      m_packed_color_stops = store.sub_array(current, 2u * FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(m_packed_color_stops_count));
+    }
+  else
+    {
+      m_packed_color_stops_count = 0u;
+      m_packed_color_stops = c_array<const generic_data>();
+    }
+}
+
+void
+fastuidraw::cpu::detail::BrushState::
+unpack_blur(const BrushContext &ctx,
+            c_array<const generic_data> store,
+            uint32_t brush_shader_data_location)
+{
+  typedef PainterBlurBrushShaderData B;
+  unsigned int current(4u * brush_shader_data_location);
+  uint64_t hi, low;
+  vec2 sc;
+
+  m_shader = 0u;
+  m_blur = true;
+
+  sc.x() = store[current + B::transformation_scale_x_offset].f;
+  sc.y() = store[current + B::transformation_scale_y_offset].f;
+  m_transformation_matrix = vecN<float, 4>(sc.x(), 0.0f, 0.0f, sc.y());
+  m_transformation_translation.x() = store[current + B::transformation_translate_x_offset].f;
+  m_transformation_translation.y() = store[current + B::transformation_translate_y_offset].f;
+
+  m_blur_number_taps = store[current + B::number_taps_offset].u;
+  m_blur_axis.x() = store[current + B::axis_x_offset].f;
+  m_blur_axis.y() = store[current + B::axis_y_offset].f;
+  m_blur_clamp_min.x() = store[current + B::clamp_min_x_offset].f;
+  m_blur_clamp_min.y() = store[current + B::clamp_min_y_offset].f;
+  m_blur_clamp_max.x() = store[current + B::clamp_max_x_offset].f;
+  m_blur_clamp_max.y() = store[current + B::clamp_max_y_offset].f;
+  m_blur_shadow_color.x() = store[current + B::shadow_color_red_offset].f;
+  m_blur_shadow_color.y() = store[current + B::shadow_color_green_offset].f;
+  m_blur_shadow_color.z() = store[current + B::shadow_color_blue_offset].f;
+  m_blur_shadow_color.w() = store[current + B::shadow_color_alpha_offset].f;
+  m_blur_taps = store.sub_array(current + B::taps_offset, 2u * m_blur_number_taps);
+
+  /* a zero handle indicates the image is bound to slot 0 */
+  hi = store[current + B::image_bindless_handle_hi_offset].u;
+  low = store[current + B::image_bindless_handle_low_offset].u;
+  m_image_start = uvec2(0u, 0u);
+  if (hi != 0u || low != 0u)
+    {
+      m_image_type = Image::bindless_texture2d;
+      m_bindless_texels = ImageCPU::texels_from_bindless_handle((hi << 32u) | low);
+    }
+  else
+    {
+      m_image_type = Image::context_texture2d;
+      m_bindless_texels = ctx.m_external_texture;
+    }
+}
+
+fastuidraw::vec2
+fastuidraw::cpu::detail::BrushState::
+apply_transformation(vec2 p) const
+{
+  vec2 q;
+
+  q.x() = m_transformation_matrix[0] * p.x() + m_transformation_matrix[1] * p.y();
+  q.y() = m_transformation_matrix[2] * p.x() + m_transformation_matrix[3] * p.y();
+  return q + m_transformation_translation;
+}
+
+float
+fastuidraw::cpu::detail::BrushState::
+compute_gradient_interpolate(vec2 p, float *good) const
+{
+  uint32_t gradient_type;
+
+  gradient_type = unpack_bits(PainterBrush::gradient_type_bit0,
+                              PainterBrush::gradient_type_num_bits,
+                              m_shader);
+  *good = 1.0f;
+  if (gradient_type == PainterBrush::radial_gradient_type)
+    {
+      vec2 q, delta_p;
+      float delta_r, a, b, c, desc, t0, t1, recip_two_a;
+      bool g0, g1;
+
+      q = p - m_gradient_p0;
+      delta_p = m_gradient_p1 - m_gradient_p0;
+      delta_r = m_gradient_r1 - m_gradient_r0;
+
+      c = dot(q, q) - m_gradient_r0 * m_gradient_r0;
+      b = 2.0f * (dot(q, delta_p) - m_gradient_r0 * delta_r);
+      a = dot(delta_p, delta_p) - delta_r * delta_r;
+      desc = b * b - 4.0f * a * c;
+      if (desc < 0.0f)
+        {
+          *good = 0.0f;
+          return 0.0f;
+        }
+
+      desc = t_sqrt(t_abs(desc));
+      recip_two_a = 0.5f / a;
+      t0 = (-b + desc) * recip_two_a;
+      t1 = (-b - desc) * recip_two_a;
+      g0 = (t0 >= 0.0f && t0 <= 1.0f);
+      g1 = (t1 >= 0.0f && t1 <= 1.0f);
+      if (g0 == g1)
+        {
+          return t_max(t0, t1);
+        }
+      return (g0) ? t0 : t1;
+    }
+  else if (gradient_type == PainterBrush::linear_gradient_type)
+    {
+      vec2 v, d;
+
+      v = m_gradient_p1 - m_gradient_p0;
+      d = p - m_gradient_p0;
+      return dot(v, d) / dot(v, v);
+    }
+  else
+    {
+      const float two_pi = 6.28318530718f;
+      float angle, sweep_angle, signed_factor, t;
+      vec2 d;
+
+      /* the sweep gradient stores its values in the fields
+       * of the linear gradient, see PainterBrush
+       */
+      sweep_angle = m_gradient_p1.x();
+      signed_factor = m_gradient_p1.y();
+      d = p - m_gradient_p0;
+      angle = std::atan2(d.y(), d.x());
+      if (angle < sweep_angle)
+        {
+          angle += two_pi;
+        }
+      t = (angle - sweep_angle) / two_pi;
+      if (signed_factor < 0.0f)
+        {
+          t = 1.0f - t;
+        }
+      return t * t_abs(signed_factor);
+    }
+}
+
+fastuidraw::vec4
+fastuidraw::cpu::detail::BrushState::
+colorstop_fetch(const BrushContext &ctx, float t) const
+{
+  c_array<const u8vec4> texels(ctx.m_colorstop_atlas->texels());
+  int width(ctx.m_colorstop_atlas->width());
+  float s, f;
+  int i0, i1, base;
+
+  /* linear filtering with clamp to edge, as done by the
+   * sampler of the GL backend's color stop atlas.
+   */
+  s = float(m_color_stop_x) + t * m_color_stop_length - 0.5f;
+  i0 = static_cast<int>(std::floor(s));
+  f = s - float(i0);
+  i1 = t_min(width - 1, t_max(0, i0 + 1));
+  i0 = t_min(width - 1, t_max(0, i0));
+  base = m_color_stop_y * width;
+  if (base + width > static_cast<int>(texels.size()))
+    {
+      return vec4(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+  return mix(normalize_texel(texels[base + i0]),
+             normalize_texel(texels[base + i1]),
+             f);
+}
+
+fastuidraw::vec4
+fastuidraw::cpu::detail::BrushState::
+packed_colorstop_fetch(float t) const
+{
+  unsigned int padded_count(FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(m_packed_color_stops_count));
+  const generic_data *places(m_packed_color_stops.c_ptr());
+  const generic_data *colors(places + padded_count);
+  const generic_data *iter;
+  unsigned int s;
+  float place_s, place_t;
+  vec4 color_s, color_t;
+
+  FASTUIDRAWassert(m_packed_color_stops_count > 0u);
+
+  /* same search result as fastuidraw_brush_packed_color_stop_fetch():
+   * find the last stop S with S.place <= t.
+   */
+  iter = std::upper_bound(places, places + m_packed_color_stops_count, t,
+                          [](float v, const generic_data &p)
+                          {
+                            return v < p.f;
+                          });
+  if (iter == places)
+    {
+      return unpack_packed_color(colors[0].u);
+    }
+
+  s = (iter - places) - 1u;
+  color_s = unpack_packed_color(colors[s].u);
+  if (s + 1u == m_packed_color_stops_count)
+    {
+      return color_s;
+    }
+
+  place_s = places[s].f;
+  place_t = places[s + 1u].f;
+  color_t = unpack_packed_color(colors[s + 1u].u);
+  return mix(color_s, color_t, (t - place_s) / (place_t - place_s));
+}
+
+fastuidraw::vec4
+fastuidraw::cpu::detail::BrushState::
+image_texel(const BrushContext &ctx, int x, int y) const
+{
+  if (m_image_type == Image::on_atlas)
+    {
+      int color_tile_size(ctx.m_image_atlas->color_tile_size());
+      float index_tile_size(ctx.m_image_atlas->index_tile_size());
+      vec2 master;
+      ivec3 tile;
+      int layer;
+
+      x = t_max(0, t_min(x, int(m_image_size.x()) - 1));
+      y = t_max(0, t_min(y, int(m_image_size.y()) - 1));
+
+      /* realizes fastuidraw_compute_image_atlas_coord() */
+      master = vec2(float(x) + 0.5f, float(y) + 0.5f) * m_image_texel_size_on_master_index_tile
+        + m_master_index_tile_xy;
+      tile = ctx.m_image_atlas->index_texel(int(std::floor(master.x())),
+                                             int(std::floor(master.y())),
+                                             m_master_index_tile_layer);
+      layer = tile.z();
+
+      for (unsigned int i = 1; i < m_number_index_lookups; ++i)
+        {
+          master.x() = glsl_fract(master.x()) * index_tile_size + float(tile.x()) * index_tile_size;
+          master.y() = glsl_fract(master.y()) * index_tile_size + float(tile.y()) * index_tile_size;
+          tile = ctx.m_image_atlas->index_texel(int(std::floor(master.x())),
+                                                 int(std::floor(master.y())),
+                                                 layer);
+          layer = tile.z();
+        }
+
+      return normalize_texel(ctx.m_image_atlas->color_texel(int(glsl_fract(master.x()) * float(color_tile_size))
+                                                            + tile.x() * color_tile_size,
+                                                            int(glsl_fract(master.y()) * float(color_tile_size))
+                                                            + tile.y() * color_tile_size,
+                                                            layer));
+    }
+  else if (m_bindless_texels)
+    {
+      return normalize_texel(m_bindless_texels->fetch(x + int(m_image_start.x()),
+                                                      y + int(m_image_start.y())));
+    }
+  else
+    {
+      return vec4(1.0f, 1.0f, 1.0f, 1.0f);
+    }
+}
+
+fastuidraw::vec4
+fastuidraw::cpu::detail::BrushState::
+sample_image(const BrushContext &ctx, vec2 q) const
+{
+  uint32_t image_filter;
+
+  image_filter = unpack_bits(PainterBrush::image_filter_bit0,
+                             PainterBrush::image_filter_num_bits,
+                             m_shader);
+
+  if (image_filter == PainterBrush::image_filter_nearest)
+    {
+      return image_texel(ctx, int(q.x()), int(q.y()));
+    }
+  else
+    {
+      /* cubic filtering falls back to linear filtering */
+      return sample_image_linear(ctx, q);
+    }
+}
+
+fastuidraw::vec4
+fastuidraw::cpu::detail::BrushState::
+sample_image_linear(const BrushContext &ctx, vec2 q) const
+{
+  vec2 s(q - vec2(0.5f, 0.5f)), f;
+  int x0, y0;
+
+  x0 = static_cast<int>(std::floor(s.x()));
+  y0 = static_cast<int>(std::floor(s.y()));
+  f = s - vec2(float(x0), float(y0));
+
+  return mix(mix(image_texel(ctx, x0, y0), image_texel(ctx, x0 + 1, y0), f.x()),
+             mix(image_texel(ctx, x0, y0 + 1), image_texel(ctx, x0 + 1, y0 + 1), f.x()),
+             f.y());
+}
+
+fastuidraw::vec4
+fastuidraw::cpu::detail::BrushState::
+compute_blur_color(const BrushContext &ctx, vec2 p) const
+{
+  vec4 sum(0.0f, 0.0f, 0.0f, 0.0f), silhouette;
+
+  /* fastuidraw_gl_frag_brush_main() of the blur brush */
+  for (unsigned int i = 0; i < m_blur_number_taps; ++i)
+    {
+      vec2 q(p + m_blur_taps[2u * i].f * m_blur_axis);
+
+      q.x() = clamp_range(q.x(), m_blur_clamp_min.x(), m_blur_clamp_max.x());
+      q.y() = clamp_range(q.y(), m_blur_clamp_min.y(), m_blur_clamp_max.y());
+      sum += m_blur_taps[2u * i + 1u].f * sample_image_linear(ctx, q);
+    }
+
+  silhouette = vec4(m_blur_shadow_color.x() * sum.w(),
+                    m_blur_shadow_color.y() * sum.w(),
+                    m_blur_shadow_color.z() * sum.w(),
+                    sum.w());
+  return mix(sum, silhouette, m_blur_shadow_color.w());
+}
+
+fastuidraw::vec4
+fastuidraw::cpu::detail::BrushState::
+compute_color(const BrushContext &ctx, vec2 p) const
+{
+  vec4 return_value(m_color);
+  uint32_t gradient_type;
+
+  if (m_blur)
+    {
+      return compute_blur_color(ctx, p);
+    }
+
+  if (m_shader & PainterBrush::repeat_window_mask)
+    {
+      uint32_t x_spread, y_spread;
+
+      x_spread = unpack_bits(PainterBrush::repeat_window_x_spread_type_bit0,
+                             PainterBrush::spread_type_num_bits, m_shader);
+      y_spread = unpack_bits(PainterBrush::repeat_window_y_spread_type_bit0,
+                             PainterBrush::spread_type_num_bits, m_shader);
+
+      p -= m_repeat_window_xy;
+      p.x() = apply_spread(p.x(), m_repeat_window_wh.x(), x_spread);
+      p.y() = apply_spread(p.y(), m_repeat_window_wh.y(), y_spread);
+      p += m_repeat_window_xy;
+    }
+
+  gradient_type = unpack_bits(PainterBrush::gradient_type_bit0,
+                              PainterBrush::gradient_type_num_bits,
+                              m_shader);
+  if (gradient_type != PainterBrush::no_gradient_type)
+    {
+      float t, good;
+      uint32_t spread_type;
+
+      t = compute_gradient_interpolate(p, &good);
+      spread_type = unpack_bits(PainterBrush::gradient_spread_type_bit0,
+                                PainterBrush::spread_type_num_bits, m_shader);
+      t = apply_gradient_spread(t, spread_type);
+      if (m_shader & PainterBrush::gradient_packed_color_stops_mask)
+        {
+          return_value *= good * packed_colorstop_fetch(t);
+        }
+      else
+        {
+          return_value *= good * colorstop_fetch(ctx, t);
+        }
+    }
+
+  /* apply alpha before doing image because image will
+   * multiply pre-multiplied alpha value
+   */
+  return_value.x() *= return_value.w();
+  return_value.y() *= return_value.w();
+  return_value.z() *= return_value.w();
+
+  if (m_shader & PainterBrush::image_mask)
+    {
+      vec2 q;
+      vec4 image_color;
+      uint32_t image_format;
+
+      q.x() = clamp_range(p.x(), 0.0f, float(m_image_size.x()) - 1.0f);
+      q.y() = clamp_range(p.y(), 0.0f, float(m_image_size.y()) - 1.0f);
+      image_color = sample_image(ctx, q);
+      image_format = unpack_bits(PainterBrush::image_format_bit0,
+                                 PainterBrush::image_format_num_bits, m_shader);
+
+      /* the one and two channel formats hold their values
+       * in the leading channels, expand them to RGBA.
+       */
+      if (image_format == Image::alpha_format)
+        {
+          image_color = vec4(1.0f, 1.0f, 1.0f, image_color.x());
+        }
+      else if (image_format == Image::luminance_format)
+        {
+          image_color = vec4(image_color.x(), image_color.x(), image_color.x(), 1.0f);
+        }
+      else if (image_format == Image::luminance_alpha_format)
+        {
+          image_color = vec4(image_color.x(), image_color.x(), image_color.x(), image_color.y());
+        }
+
+      if (image_format != Image::premultipied_rgba_format)
+        {
+          image_color.x() *= image_color.w();
+          image_color.y() *= image_color.w();
+          image_color.z() *= image_color.w();
+        }
+      return_value *= image_color;
+    }
+
+  return return_value;
+}
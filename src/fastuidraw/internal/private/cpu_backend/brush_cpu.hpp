@@ -0,0 +1,152 @@
+/*!
+ * \file brush_cpu.hpp
+ * \brief file brush_cpu.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/painter/painter_brush.hpp>
+#include <private/cpu_backend/image_cpu.hpp>
+#include <private/cpu_backend/atlases_cpu.hpp>
+
+namespace fastuidraw { namespace cpu { namespace detail {
+
+/* Values constant across all items of a draw that the
+ * fixed function brush reads.
+ */
+class BrushContext
+{
+public:
+  const ImageAtlasCPU *m_image_atlas;
+  const ColorStopAtlasCPU *m_colorstop_atlas;
+
+  /* the TexelStore bound to external texture slot 0,
+   * may be nullptr.
+   */
+  const TexelStore *m_external_texture;
+};
+
+/* A BrushState holds the values of the fixed function brush
+ * unpacked from the data store; it is the analogue of the
+ * flat varyings of the GLSL fixed function brush and is
+ * unpacked once per primitive.
+ */
+class BrushState
+{
+public:
+  BrushState(void):
+    m_shader(0u),
+    m_blur(false)
+  {}
+
+  /* Unpack the brush; the packing is that of
+   * PainterBrush::pack_data().
+   */
+  void
+  unpack(const BrushContext &ctx,
+         c_array<const generic_data> store,
+         uint32_t brush_shader,
+         uint32_t brush_shader_data_location);
+
+  /* Unpack the custom brush that sums the taps of a blur
+   * pass; the packing is that of PainterBlurBrushShaderData.
+   */
+  void
+  unpack_blur(const BrushContext &ctx,
+              c_array<const generic_data> store,
+              uint32_t brush_shader_data_location);
+
+  /* Apply the brush transformation, i.e. the vertex
+   * stage of the fixed function brush.
+   */
+  vec2
+  apply_transformation(vec2 p) const;
+
+  /* Compute the brush color at the brush coordinate p
+   * (as returned by apply_transformation()); the returned
+   * value is pre-multiplied by alpha.
+   */
+  vec4
+  compute_color(const BrushContext &ctx, vec2 p) const;
+
+private:
+  vec4
+  image_texel(const BrushContext &ctx, int x, int y) const;
+
+  vec4
+  sample_image(const BrushContext &ctx, vec2 q) const;
+
+  vec4
+  sample_image_linear(const BrushContext &ctx, vec2 q) const;
+
+  vec4
+  compute_blur_color(const BrushContext &ctx, vec2 p) const;
+
+  float
+  compute_gradient_interpolate(vec2 p, float *good) const;
+
+  vec4
+  colorstop_fetch(const BrushContext &ctx, float t) const;
+
+  vec4
+  packed_colorstop_fetch(float t) const;
+
+  uint32_t m_shader;
+  vec4 m_color;
+
+  /* image values */
+  enum Image::type_t m_image_type;
+  uvec2 m_image_size;
+  uvec2 m_image_start;
+  vec2 m_master_index_tile_xy;
+  int m_master_index_tile_layer;
+  unsigned int m_number_index_lookups;
+  float m_image_texel_size_on_master_index_tile;
+  const TexelStore *m_bindless_texels;
+
+  /* gradient values */
+  vec2 m_gradient_p0, m_gradient_p1;
+  float m_gradient_r0, m_gradient_r1;
+  int m_color_stop_x, m_color_stop_y;
+  float m_color_stop_length;
+
+  /* color stops packed in the data store (only valid if
+   * PainterBrush::gradient_packed_color_stops_mask is up),
+   * the values of PainterBrush::gradient_color_stops_packing.
+   */
+  unsigned int m_packed_color_stops_count;
+  c_array<const generic_data> m_packed_color_stops;
+
+  /* repeat window values */
+  vec2 m_repeat_window_xy, m_repeat_window_wh;
+
+  /* transformation values */
+  vecN<float, 4> m_transformation_matrix;
+  vec2 m_transformation_translation;
+
+  /* blur brush values, the taps are (offset, weight)
+   * pairs read from the data store.
+   */
+  bool m_blur;
+  unsigned int m_blur_number_taps;
+  c_array<const generic_data> m_blur_taps;
+  vec2 m_blur_axis, m_blur_clamp_min, m_blur_clamp_max;
+  vec4 m_blur_shadow_color;
+};
+
+}}}
@@ -0,0 +1,97 @@
+/*!
+ * \file image_cpu.hpp
+ * \brief file image_cpu.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include <fastuidraw/image.hpp>
+#include <fastuidraw/image_atlas.hpp>
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
+
+namespace fastuidraw { namespace cpu { namespace detail {
+
+/* A TexelStore is a 2D array of RGBA8 texels; it backs the
+ * color buffer of a PainterSurfaceCPU and the Image objects
+ * that are not on the ImageAtlas.
+ */
+class TexelStore:public reference_counted<TexelStore>::concurrent
+{
+public:
+  explicit
+  TexelStore(ivec2 dims):
+    m_dimensions(t_max(dims.x(), 1), t_max(dims.y(), 1)),
+    m_texels(m_dimensions.x() * m_dimensions.y(), u8vec4(0, 0, 0, 0))
+  {}
+
+  /* fetch with clamp-to-edge behavior */
+  u8vec4
+  fetch(int x, int y) const
+  {
+    x = t_max(0, t_min(x, m_dimensions.x() - 1));
+    y = t_max(0, t_min(y, m_dimensions.y() - 1));
+    return m_texels[x + y * m_dimensions.x()];
+  }
+
+  ivec2 m_dimensions;
+  std::vector<u8vec4> m_texels;
+};
+
+/* An ImageCPU is an Image whose texels are held in a TexelStore;
+ * when the type is Image::bindless_texture2d, the bindless handle
+ * is the address of the TexelStore so that the brush can sample
+ * from the image directly without a draw break.
+ */
+class ImageCPU:public Image
+{
+public:
+  static
+  reference_counted_ptr<Image>
+  create(ImageAtlas &atlas, int w, int h,
+         const ImageSourceBase &image_data,
+         enum type_t type);
+
+  static
+  reference_counted_ptr<Image>
+  create(ImageAtlas &atlas,
+         const reference_counted_ptr<TexelStore> &texels,
+         enum format_t fmt);
+
+  const reference_counted_ptr<TexelStore>&
+  texels(void) const
+  {
+    return m_texels;
+  }
+
+  static
+  const TexelStore*
+  texels_from_bindless_handle(uint64_t handle)
+  {
+    return reinterpret_cast<const TexelStore*>(static_cast<uintptr_t>(handle));
+  }
+
+private:
+  ImageCPU(ImageAtlas &atlas,
+           const reference_counted_ptr<TexelStore> &texels,
+           enum type_t type, enum format_t fmt);
+
+  reference_counted_ptr<TexelStore> m_texels;
+};
+
+}}}
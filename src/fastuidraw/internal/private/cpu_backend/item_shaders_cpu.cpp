@@ -0,0 +1,2202 @@
+/*!
+ * \file item_shaders_cpu.cpp
+ * \brief file item_shaders_cpu.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <cmath>
+#include <fastuidraw/util/math.hpp>
+#include <fastuidraw/painter/painter_stroke_params.hpp>
+#include <fastuidraw/painter/painter_dashed_stroke_params.hpp>
+#include <fastuidraw/painter/attribute_data/stroked_point.hpp>
+#include <fastuidraw/painter/attribute_data/filled_path.hpp>
+#include <fastuidraw/text/glyph_attribute.hpp>
+#include <fastuidraw/text/glyph_render_data_restricted_rays.hpp>
+#include <fastuidraw/text/glyph_render_data_banded_rays.hpp>
+#include <private/cpu_backend/backend_shaders_cpu.hpp>
+#include <private/cpu_backend/item_shaders_cpu.hpp>
+
+namespace
+{
+  using namespace fastuidraw;
+  using namespace fastuidraw::cpu::detail;
+
+  /* The varyings and flats of each of the shaders; the order
+   * matches the order of the varyings of the GLSL shaders.
+   */
+  enum
+    {
+      aa_fuzz_varying = 0,
+      number_aa_fuzz_varyings
+    };
+
+  enum
+    {
+      stroking_on_boundary_varying = 0,
+      stroking_distance_varying,
+      stroking_distance_sub_edge_start_varying,
+      stroking_distance_sub_edge_end_varying,
+      number_stroking_varyings,
+
+      stroking_dash_bits_flat = 0
+    };
+
+  enum
+    {
+      glyph_coord_x_varying = 0,
+      glyph_coord_y_varying,
+      glyph_width_varying,
+      glyph_height_varying,
+      number_glyph_texel_varyings,
+      number_glyph_rays_varyings = glyph_width_varying,
+
+      glyph_data_location_flat = 0,
+      glyph_num_vertical_bands_flat,
+      glyph_num_horizontal_bands_flat
+    };
+
+  /* values of fastuidraw_painter_stroke_util.constants.glsl */
+  enum
+    {
+      stroke_gauranteed_to_be_covered_mask = 1u,
+      stroke_skip_dash_interval_lookup_mask = 2u,
+      stroke_distance_constant = 4u
+    };
+
+  inline
+  float
+  as_float(uint32_t v)
+  {
+    generic_data d;
+    d.u = v;
+    return d.f;
+  }
+
+  /* GLSL's sign(), i.e. sign(0) is 0 */
+  inline
+  float
+  glsl_sign(float v)
+  {
+    return (v > 0.0f) ? 1.0f : ((v < 0.0f) ? -1.0f : 0.0f);
+  }
+
+  inline
+  float
+  glsl_fract(float v)
+  {
+    return v - std::floor(v);
+  }
+
+  inline
+  float
+  clamp01(float v)
+  {
+    return t_max(0.0f, t_min(1.0f, v));
+  }
+
+  inline
+  vec2
+  unpack_half2x16(uint32_t v)
+  {
+    vecN<uint16_t, 2> h;
+    vec2 return_value;
+
+    h[0] = static_cast<uint16_t>(v & 0xFFFFu);
+    h[1] = static_cast<uint16_t>(v >> 16u);
+    convert_to_fp32(c_array<const uint16_t>(h.c_ptr(), 2),
+                    c_array<float>(return_value.c_ptr(), 2));
+    return return_value;
+  }
+
+  /* Returns the value at the named offset of the named block
+   * of the data store, i.e. fastuidraw_fetch_data()
+   */
+  inline
+  const generic_data&
+  fetch_data(const ItemShaderContext &ctx, uint32_t block, uint32_t offset)
+  {
+    return ctx.m_store[4u * block + offset];
+  }
+
+  inline
+  uint32_t
+  fetch_glyph_data(const ItemShaderContext &ctx, uint32_t loc)
+  {
+    return (loc < ctx.m_glyph_data.size()) ? ctx.m_glyph_data[loc].u : 0u;
+  }
+
+  /* A 2x2 matrix held as columns, matching the mat2 of
+   * fastuidraw_align.vert.glsl
+   */
+  class ColumnMatrix2
+  {
+  public:
+    vec2
+    operator*(const vec2 &v) const
+    {
+      return m_c0 * v.x() + m_c1 * v.y();
+    }
+
+    vec2 m_c0, m_c1;
+  };
+
+  class ItemVertexHelper
+  {
+  public:
+    ItemVertexHelper(const ItemShaderContext &ctx, const float3x3 &m):
+      m_matrix(m),
+      m_viewport_pixels(ctx.m_viewport_pixels),
+      m_viewport_recip_pixels(1.0f / ctx.m_viewport_pixels.x(),
+                              1.0f / ctx.m_viewport_pixels.y())
+    {}
+
+    vec3
+    apply(vec2 p, float w) const
+    {
+      return m_matrix * vec3(p.x(), p.y(), w);
+    }
+
+    vec3
+    apply(vec2 p) const
+    {
+      return apply(p, 1.0f);
+    }
+
+    vec3
+    apply_direction(vec2 v) const
+    {
+      return apply(v, 0.0f);
+    }
+
+    /* fastuidraw_align_compute_Q_adjoint_Q */
+    void
+    compute_Q_adjoint_Q(const vec3 &pclip_p, ColumnMatrix2 *Q, ColumnMatrix2 *adjQ) const
+    {
+      vec3 clip;
+
+      clip = vec3(m_viewport_pixels.x(), m_viewport_pixels.y(), 1.0f) * pclip_p;
+      Q->m_c0.x() = clip.z() * m_matrix(0, 0) - clip.x() * m_matrix(2, 0);
+      Q->m_c0.y() = clip.z() * m_matrix(1, 0) - clip.y() * m_matrix(2, 0);
+      Q->m_c1.x() = clip.z() * m_matrix(0, 1) - clip.x() * m_matrix(2, 1);
+      Q->m_c1.y() = clip.z() * m_matrix(1, 1) - clip.y() * m_matrix(2, 1);
+
+      adjQ->m_c0 = vec2(Q->m_c1.y(), -Q->m_c0.y());
+      adjQ->m_c1 = vec2(-Q->m_c1.x(), Q->m_c0.x());
+    }
+
+    /* fastuidraw_align_normal_to_screen */
+    vec2
+    align_normal_to_screen(const vec3 &clip_p, const vec2 &n) const
+    {
+      ColumnMatrix2 Q, adjQ;
+      vec2 n_screen, t_screen, t;
+
+      compute_Q_adjoint_Q(clip_p, &Q, &adjQ);
+      t = vec2(-n.y(), n.x());
+      t_screen = m_viewport_pixels * (Q * t);
+      n_screen = vec2(t_screen.y(), -t_screen.x());
+      return adjQ * (m_viewport_recip_pixels * n_screen);
+    }
+
+    /* fastuidraw_local_distance_from_pixel_distance */
+    float
+    local_distance_from_pixel_distance(float pixel_distance,
+                                       const vec3 &clip_p,
+                                       const vec3 &clip_direction) const
+    {
+      vec2 zeta;
+      vec3 p, v, hv;
+
+      hv = vec3(0.5f * m_viewport_pixels.x(), 0.5f * m_viewport_pixels.y(), 1.0f);
+      p = hv * clip_p;
+      v = hv * clip_direction;
+      zeta = vec2(v.x() * p.z() - v.z() * p.x(),
+                  v.y() * p.z() - v.z() * p.y());
+      return pixel_distance * p.z() * p.z()
+        / (-pixel_distance * t_abs(p.z() * v.z()) + zeta.magnitude());
+    }
+
+    const float3x3 &m_matrix;
+    vec2 m_viewport_pixels, m_viewport_recip_pixels;
+  };
+
+  /* fastuidraw_unpack_unit_vector */
+  vec2
+  unpack_unit_vector(float x, uint32_t b)
+  {
+    vec2 return_value;
+
+    return_value.x() = x;
+    return_value.y() = t_sqrt(t_max(0.0f, 1.0f - x * x));
+    if (b != 0u)
+      {
+        return_value.y() = -return_value.y();
+      }
+    return return_value;
+  }
+
+  /* fastuidraw_circular_interpolate */
+  vec2
+  circular_interpolate(const vec2 &v0, const vec2 &v1, float d, float interpolate)
+  {
+    float angle, c, s;
+
+    angle = std::acos(t_max(-1.0f, t_min(1.0f, d)));
+    c = t_cos(angle * interpolate);
+    s = t_sin(angle * interpolate) * glsl_sign(v0.x() * v1.y() - v1.x() * v0.y());
+    return vec2(c * v0.x() - s * v0.y(),
+                s * v0.x() + c * v0.y());
+  }
+
+  ////////////////////////////////////////
+  // fill shaders
+  void
+  fill_vertex_shader(const ItemShaderContext &ctx,
+                     const ItemVertexInput &in,
+                     ItemVertexOutput *out)
+  {
+    ItemVertexHelper helper(ctx, in.m_item_matrix);
+    vec2 p;
+
+    p = vec2(as_float(in.m_attribute->m_attrib0.x()),
+             as_float(in.m_attribute->m_attrib0.y()));
+    out->m_add_z = 0;
+    out->m_clip_p = helper.apply(p);
+    out->m_brush_p = p;
+  }
+
+  float
+  aa_fuzz_compute_dist(const ItemVertexHelper &helper,
+                       const vec3 &clip_p, const vec3 &clip_direction)
+  {
+    const float two_minus_sqrt2 = 2.0f - 1.41421356237f;
+    float hv, r;
+    vec2 normalized_direction;
+
+    normalized_direction = vec2(clip_direction.x(), clip_direction.y());
+    normalized_direction.normalize();
+    hv = t_min(t_abs(normalized_direction.x()),
+               t_abs(normalized_direction.y()));
+    r = 1.0f + hv * two_minus_sqrt2;
+    return helper.local_distance_from_pixel_distance(r, clip_p, clip_direction);
+  }
+
+  void
+  aa_fuzz_vertex_shader(const ItemShaderContext &ctx,
+                        const ItemVertexInput &in,
+                        ItemVertexOutput *out)
+  {
+    const float miter_limit = 1.0f;
+    ItemVertexHelper helper(ctx, in.m_item_matrix);
+    const PainterAttribute &attr(*in.m_attribute);
+    vec2 position, p, n0, n1;
+    vec3 clip_direction, clip_p;
+    uint32_t type;
+
+    position = vec2(as_float(attr.m_attrib0.x()), as_float(attr.m_attrib0.y()));
+    type = attr.m_attrib0.z();
+    n0 = vec2(as_float(attr.m_attrib1.x()), as_float(attr.m_attrib1.y()));
+    n1 = vec2(as_float(attr.m_attrib1.z()), as_float(attr.m_attrib1.w()));
+
+    if (type == FilledPath::Subset::aa_fuzz_type_on_path)
+      {
+        p = position;
+      }
+    else if (type == FilledPath::Subset::aa_fuzz_type_on_boundary)
+      {
+        float dist;
+
+        clip_p = helper.apply(position);
+        n0 = helper.align_normal_to_screen(clip_p, n0);
+        clip_direction = helper.apply_direction(n0);
+        dist = aa_fuzz_compute_dist(helper, clip_p, clip_direction);
+        p = position + dist * n0;
+      }
+    else
+      {
+        float r, r0, r1, det;
+        vec2 v0(n0.y(), -n0.x()), v1(n1.y(), -n1.x());
+        vec2 d0, d1, delta_d;
+
+        clip_p = helper.apply(position);
+
+        n0 = helper.align_normal_to_screen(clip_p, n0);
+        clip_direction = helper.apply_direction(n0);
+        r0 = aa_fuzz_compute_dist(helper, clip_p, clip_direction);
+        d0 = r0 * n0;
+
+        n1 = helper.align_normal_to_screen(clip_p, n1);
+        clip_direction = helper.apply_direction(n1);
+        r1 = aa_fuzz_compute_dist(helper, clip_p, clip_direction);
+        d1 = r1 * n1;
+
+        delta_d = d1 - d0;
+        det = v0.x() * v1.y() - v0.y() * v1.x();
+        r = (v1.y() * delta_d.x() - v1.x() * delta_d.y()) / det;
+        r = t_max(-miter_limit, t_min(miter_limit, r));
+        p = position + d0 + r * v0;
+      }
+
+    out->m_varyings[aa_fuzz_varying] = (type == 0u) ? 0.0f : 1.0f;
+    out->m_clip_p = helper.apply(p);
+    out->m_brush_p = p;
+    out->m_add_z = static_cast<int>(attr.m_attrib0.w());
+  }
+
+  float
+  aa_fuzz_coverage_fragment_shader(const ItemFragmentInput &in)
+  {
+    float q, dd, fw;
+
+    q = 1.0f - in.m_varyings[aa_fuzz_varying];
+    fw = t_abs(in.m_varyings_dx[aa_fuzz_varying]) + t_abs(in.m_varyings_dy[aa_fuzz_varying]);
+    dd = t_max(q, fw);
+    return (dd > 0.0f) ? q / dd : 0.0f;
+  }
+
+  ////////////////////////////////////////
+  // stroke shaders
+  class DashedStrokeParams
+  {
+  public:
+    DashedStrokeParams(const ItemShaderContext &ctx, uint32_t loc)
+    {
+      const generic_data *p(&ctx.m_store[4u * loc]);
+
+      m_radius = p[PainterDashedStrokeParams::stroke_radius_offset].f;
+      m_miter_limit = p[PainterDashedStrokeParams::stroke_miter_limit_offset].f;
+      m_dash_offset = p[PainterDashedStrokeParams::stroke_dash_offset_offset].f;
+      m_total_length = p[PainterDashedStrokeParams::stroke_total_length_offset].f;
+      m_first_interval_start = p[PainterDashedStrokeParams::stroke_first_interval_start_offset].f;
+      m_first_interval_start_on_looping = p[PainterDashedStrokeParams::stroke_first_interval_start_on_looping_offset].f;
+      m_number_intervals = p[PainterDashedStrokeParams::stroke_number_intervals_offset].u;
+    }
+
+    static
+    uint32_t
+    num_blocks(void)
+    {
+      return FASTUIDRAW_NUMBER_BLOCK4_NEEDED(PainterDashedStrokeParams::stroke_static_data_size);
+    }
+
+    float m_radius, m_miter_limit, m_dash_offset, m_total_length;
+    float m_first_interval_start, m_first_interval_start_on_looping;
+    uint32_t m_number_intervals;
+  };
+
+  /* fastuidraw_compute_interval */
+  float
+  compute_interval(const ItemShaderContext &ctx,
+                   uint32_t intervals_location, float total_distance,
+                   float first_interval_start, float in_distance,
+                   uint32_t number_intervals,
+                   int *interval_ID, float *interval_begin, float *interval_end)
+  {
+    uint32_t loc;
+    float d, lastd, ff, fd;
+
+    fd = std::floor(in_distance / total_distance);
+    ff = total_distance * fd;
+    d = in_distance - ff;
+    lastd = first_interval_start;
+    loc = 0;
+    *interval_begin = 0.0f;
+    *interval_end = 0.0f;
+    *interval_ID = -1;
+
+    do
+      {
+        const generic_data *fV;
+        int base_id;
+
+        if (4u * (loc + intervals_location) + 3u >= ctx.m_store.size())
+          {
+            break;
+          }
+
+        fV = &ctx.m_store[4u * (loc + intervals_location)];
+        base_id = 4 * static_cast<int>(loc) + static_cast<int>(fd) * static_cast<int>(number_intervals);
+        if (d < fV[0].f)
+          {
+            *interval_begin = ff + lastd;
+            *interval_end = ff + fV[0].f;
+            *interval_ID = base_id;
+            return 1.0f;
+          }
+        else if (d < fV[1].f)
+          {
+            *interval_begin = ff + fV[0].f;
+            *interval_end = ff + fV[1].f;
+            *interval_ID = base_id + 1;
+            return -1.0f;
+          }
+        else if (d < fV[2].f)
+          {
+            *interval_begin = ff + fV[1].f;
+            *interval_end = ff + fV[2].f;
+            *interval_ID = base_id + 2;
+            return 1.0f;
+          }
+        else if (d < fV[3].f)
+          {
+            *interval_begin = ff + fV[2].f;
+            *interval_end = ff + fV[3].f;
+            *interval_ID = base_id + 3;
+            return -1.0f;
+          }
+        lastd = fV[3].f;
+        ++loc;
+      }
+    while (lastd < total_distance);
+
+    return -1.0f;
+  }
+
+  class DashedBase
+  {
+  public:
+    DashedBase(const ItemShaderContext &ctx, float d,
+               uint32_t shader_data_offset,
+               const DashedStrokeParams &params):
+      m_d(d),
+      m_dash_pattern_at(shader_data_offset + DashedStrokeParams::num_blocks())
+    {
+      m_s = compute_interval(ctx, m_dash_pattern_at, params.m_total_length,
+                             params.m_first_interval_start, m_d,
+                             params.m_number_intervals, &m_interval_id,
+                             &m_interval_begin, &m_interval_end);
+    }
+
+    float m_d, m_s;
+    int m_interval_id;
+    float m_interval_begin, m_interval_end;
+    uint32_t m_dash_pattern_at;
+  };
+
+  class DashedEdgeExtend
+  {
+  public:
+    /* fastuidraw_dashed_helper_vert_extend_edge */
+    DashedEdgeExtend(const ItemShaderContext &ctx,
+                     const DashedStrokeParams &params,
+                     float stroke_radius, bool is_edge_end,
+                     float edge_length, bool has_caps,
+                     const DashedBase &base):
+      m_extend_edge(false),
+      m_collapse(false)
+    {
+      float d2, s2, interval_begin2, interval_end2;
+      int interval_id2;
+
+      d2 = (is_edge_end) ? base.m_d - edge_length : base.m_d + edge_length;
+      s2 = compute_interval(ctx, base.m_dash_pattern_at, params.m_total_length,
+                            params.m_first_interval_start, d2,
+                            params.m_number_intervals, &interval_id2,
+                            &interval_begin2, &interval_end2);
+
+      if (interval_id2 == base.m_interval_id && base.m_interval_id != -1)
+        {
+          m_stroking_bits = stroke_gauranteed_to_be_covered_mask;
+          m_stroking_distance = 0.0f;
+          m_collapse = (s2 < 0.0f);
+          if (!is_edge_end)
+            {
+              m_edge_distance_start = base.m_d;
+              m_edge_distance_end = d2;
+            }
+          else
+            {
+              m_edge_distance_start = d2;
+              m_edge_distance_end = base.m_d;
+            }
+        }
+      else
+        {
+          m_stroking_bits = 0u;
+          if (!is_edge_end)
+            {
+              m_edge_distance_start = (base.m_s < 0.0f) ? base.m_interval_end : base.m_d;
+              m_edge_distance_end = (s2 < 0.0f) ? interval_begin2 : d2;
+              if (base.m_s < 0.0f && has_caps)
+                {
+                  m_stroking_distance = base.m_d - stroke_radius;
+                  m_extend_edge = true;
+                }
+              else
+                {
+                  m_stroking_distance = base.m_d;
+                }
+            }
+          else
+            {
+              m_edge_distance_start = (s2 < 0.0f) ? interval_end2 : d2;
+              m_edge_distance_end = (base.m_s < 0.0f) ? base.m_interval_begin : base.m_d;
+              if (base.m_s < 0.0f && has_caps)
+                {
+                  m_stroking_distance = base.m_d + stroke_radius;
+                  m_extend_edge = true;
+                }
+              else
+                {
+                  m_stroking_distance = base.m_d;
+                }
+            }
+        }
+    }
+
+    uint32_t m_stroking_bits;
+    float m_stroking_distance;
+    float m_edge_distance_start, m_edge_distance_end;
+    bool m_extend_edge, m_collapse;
+  };
+
+  vec2
+  stroke_compute_offset_miter_clip(uint32_t point_packed_data,
+                                   const vec2 &pre_offset, const vec2 &auxiliary_offset,
+                                   float miter_limit)
+  {
+    vec2 n0(pre_offset), Jn0(n0.y(), -n0.x());
+    vec2 n1(auxiliary_offset), Jn1(n1.y(), -n1.x());
+    float r, det, lambda;
+
+    det = dot(Jn1, n0);
+    lambda = -glsl_sign(det);
+    r = (det != 0.0f) ? (dot(n0, n1) - 1.0f) / det : 0.0f;
+    if ((StrokedPoint::lambda_negated_mask & point_packed_data) != 0u)
+      {
+        lambda = -lambda;
+      }
+
+    if (miter_limit >= 0.0f)
+      {
+        float mm;
+
+        mm = miter_limit * t_abs(r) / t_sqrt(1.0f + r * r);
+        r = t_max(-mm, t_min(mm, r));
+      }
+    return lambda * (n0 + r * Jn0);
+  }
+
+  vec2
+  stroke_compute_offset_miter(uint32_t offset_type,
+                              const vec2 &pre_offset, const vec2 &auxiliary_offset,
+                              float miter_limit)
+  {
+    vec2 n0(pre_offset), Jn0(n0.y(), -n0.x());
+    vec2 n1(auxiliary_offset);
+    vec2 n0_plus_n1(n0 + n1);
+    float r, lambda, den;
+
+    lambda = glsl_sign(dot(Jn0, n1));
+    den = 1.0f + dot(n0, n1);
+    r = (den != 0.0f) ? 1.0f / den : 0.0f;
+
+    if (miter_limit >= 0.0f)
+      {
+        float d, den_m;
+
+        d = dot(n0_plus_n1, n0_plus_n1);
+        den_m = miter_limit * den;
+        if (d >= den_m * den_m)
+          {
+            if (offset_type == StrokedPoint::offset_miter_bevel_join)
+              {
+                r = 0.5f;
+              }
+            else
+              {
+                r = miter_limit / t_sqrt(d);
+              }
+          }
+      }
+    r = t_max(r, 0.5f) * lambda;
+    return r * n0_plus_n1;
+  }
+
+  /* FASTUIDRAW_LOCAL(compute_offset) of fastuidraw_painter_stroke_compute_offset.vert.glsl */
+  vec2
+  stroke_compute_offset(uint32_t point_packed_data, uint32_t offset_type,
+                        const vec2 &pre_offset, const vec2 &auxiliary_offset,
+                        float miter_limit)
+  {
+    switch (offset_type)
+      {
+      case StrokedPoint::offset_miter_clip_join:
+        return stroke_compute_offset_miter_clip(point_packed_data, pre_offset,
+                                                auxiliary_offset, miter_limit);
+
+      case StrokedPoint::offset_miter_join:
+      case StrokedPoint::offset_miter_bevel_join:
+        return stroke_compute_offset_miter(offset_type, pre_offset,
+                                           auxiliary_offset, miter_limit);
+
+      case StrokedPoint::offset_rounded_join:
+        return unpack_unit_vector(auxiliary_offset.y(),
+                                  StrokedPoint::sin_sign_mask & point_packed_data);
+
+      case StrokedPoint::offset_square_cap:
+        return pre_offset + auxiliary_offset;
+
+      case StrokedPoint::offset_rounded_cap:
+        {
+          vec2 n(pre_offset), v(n.y(), -n.x());
+          return auxiliary_offset.x() * v + auxiliary_offset.y() * pre_offset;
+        }
+
+      default:
+        return pre_offset;
+      }
+  }
+
+  vec2
+  stroke_compute_offset_pixels_default(const ItemVertexHelper &helper,
+                                       uint32_t point_packed_data, const vec2 &position,
+                                       const vec2 &pre_offset, const vec2 &auxiliary_offset,
+                                       float *stroke_radius)
+  {
+    vec3 clip_direction, clip_p;
+    vec2 n;
+
+    if ((point_packed_data & StrokedPoint::end_sub_edge_mask) != 0u)
+      {
+        clip_p = helper.apply(position + auxiliary_offset);
+      }
+    else
+      {
+        clip_p = helper.apply(position);
+      }
+
+    n = helper.align_normal_to_screen(clip_p, pre_offset);
+    clip_direction = helper.apply_direction(n);
+    *stroke_radius = helper.local_distance_from_pixel_distance(*stroke_radius, clip_p, clip_direction);
+    return n;
+  }
+
+  vec2
+  stroke_compute_offset_pixels_miter_clip(const ItemVertexHelper &helper,
+                                          uint32_t point_packed_data, const vec2 &position,
+                                          const vec2 &pre_offset, const vec2 &auxiliary_offset,
+                                          float miter_limit, float *stroke_radius)
+  {
+    vec2 n0(pre_offset), v0(n0.y(), -n0.x());
+    vec2 n1(auxiliary_offset), v1(n1.y(), -n1.x());
+    vec2 delta_d, d0, d1;
+    vec3 clip_p, clip_direction;
+    float det, r, r0, r1, lambda;
+
+    lambda = -glsl_sign(dot(v1, n0));
+    if ((StrokedPoint::lambda_negated_mask & point_packed_data) != 0u)
+      {
+        lambda = -lambda;
+      }
+
+    clip_p = helper.apply(position);
+    n0 = lambda * helper.align_normal_to_screen(clip_p, n0);
+    n1 = lambda * helper.align_normal_to_screen(clip_p, n1);
+
+    clip_direction = helper.apply_direction(n0);
+    r0 = helper.local_distance_from_pixel_distance(*stroke_radius, clip_p, clip_direction);
+    d0 = r0 * n0;
+
+    clip_direction = helper.apply_direction(n1);
+    r1 = helper.local_distance_from_pixel_distance(*stroke_radius, clip_p, clip_direction);
+    d1 = r1 * n1;
+
+    delta_d = d1 - d0;
+    det = v0.x() * v1.y() - v0.y() * v1.x();
+    r = (det != 0.0f) ? (v1.y() * delta_d.x() - v1.x() * delta_d.y()) / det : 0.0f;
+
+    if (miter_limit >= 0.0f)
+      {
+        float m, mm;
+
+        m = miter_limit * d0.magnitude();
+        mm = m * t_abs(r) / (d0 + r * v0).magnitude();
+        r = t_max(-mm, t_min(mm, r));
+      }
+
+    *stroke_radius = 1.0f;
+    return d0 + r * v0;
+  }
+
+  vec2
+  stroke_compute_offset_pixels_miter(const ItemVertexHelper &helper,
+                                     uint32_t offset_type, const vec2 &position,
+                                     const vec2 &pre_offset, const vec2 &auxiliary_offset,
+                                     float miter_limit, float *stroke_radius)
+  {
+    vec2 n0(pre_offset), v0(n0.y(), -n0.x());
+    vec2 n1(auxiliary_offset), v1(n1.y(), -n1.x());
+    vec2 delta_d, d0, d1, offset;
+    vec3 clip_p, clip_direction;
+    float det, r0, r1, lambda;
+
+    lambda = -glsl_sign(dot(v1, n0));
+    clip_p = helper.apply(position);
+    n0 = lambda * helper.align_normal_to_screen(clip_p, n0);
+    n0.normalize();
+    n1 = lambda * helper.align_normal_to_screen(clip_p, n1);
+    n1.normalize();
+
+    clip_direction = helper.apply_direction(n0);
+    r0 = helper.local_distance_from_pixel_distance(*stroke_radius, clip_p, clip_direction);
+    d0 = r0 * n0;
+
+    clip_direction = helper.apply_direction(n1);
+    r1 = helper.local_distance_from_pixel_distance(*stroke_radius, clip_p, clip_direction);
+    d1 = r1 * n1;
+
+    delta_d = d1 - d0;
+    det = v0.x() * v1.y() - v0.y() * v1.x();
+    if (det != 0.0f)
+      {
+        float r;
+
+        r = (v1.y() * delta_d.x() - v1.x() * delta_d.y()) / det;
+        offset = d0 + r * v0;
+        if (miter_limit >= 0.0f)
+          {
+            float m, l;
+
+            m = miter_limit * t_max(r0, r1);
+            l = offset.magnitude();
+            if (l > m)
+              {
+                if (offset_type == StrokedPoint::offset_miter_bevel_join)
+                  {
+                    offset = 0.5f * (d0 + d1);
+                  }
+                else
+                  {
+                    float k;
+
+                    k = 0.5f * (d0 + d1).magnitude();
+                    offset *= t_max(m, k) / l;
+                  }
+              }
+          }
+      }
+    else
+      {
+        offset = 0.5f * (d0 + d1);
+      }
+
+    *stroke_radius = 1.0f;
+    return offset;
+  }
+
+  vec2
+  stroke_compute_offset_pixels_rounded_join(const ItemVertexHelper &helper,
+                                            uint32_t point_packed_data, const vec2 &position,
+                                            const vec2 &pre_offset, const vec2 &auxiliary_offset,
+                                            float *stroke_radius)
+  {
+    vec2 n0, n1, t0, t1, screen_t0, screen_t1, screen_t, screen_n, offset;
+    vec3 clip_p, clip_direction;
+    ColumnMatrix2 Q, adjQ;
+    float d, interpolate;
+
+    n0 = unpack_unit_vector(pre_offset.x(), StrokedPoint::normal0_y_sign_mask & point_packed_data);
+    n1 = unpack_unit_vector(pre_offset.y(), StrokedPoint::normal1_y_sign_mask & point_packed_data);
+    interpolate = auxiliary_offset.x();
+
+    clip_p = helper.apply(position);
+    helper.compute_Q_adjoint_Q(clip_p, &Q, &adjQ);
+
+    t0 = vec2(-n0.y(), n0.x());
+    t1 = vec2(-n1.y(), n1.x());
+    screen_t0 = helper.m_viewport_pixels * (Q * t0);
+    screen_t0.normalize();
+    screen_t1 = helper.m_viewport_pixels * (Q * t1);
+    screen_t1.normalize();
+
+    d = dot(screen_t0, screen_t1);
+    if (d > 0.0f)
+      {
+        screen_t = screen_t0 + interpolate * (screen_t1 - screen_t0);
+      }
+    else
+      {
+        screen_t = circular_interpolate(screen_t0, screen_t1, d, interpolate);
+      }
+
+    screen_n = vec2(screen_t.y(), -screen_t.x());
+    offset = adjQ * (helper.m_viewport_recip_pixels * screen_n);
+    clip_direction = helper.apply_direction(offset);
+    *stroke_radius = helper.local_distance_from_pixel_distance(*stroke_radius, clip_p, clip_direction);
+    return offset;
+  }
+
+  vec2
+  stroke_compute_offset_pixels_square_cap(const ItemVertexHelper &helper,
+                                          const vec2 &position,
+                                          const vec2 &pre_offset, const vec2 &auxiliary_offset,
+                                          float *stroke_radius)
+  {
+    vec3 clip_direction0, clip_direction1, clip_p;
+    float s0, s1;
+    vec2 n;
+
+    clip_p = helper.apply(position);
+    clip_direction0 = helper.apply_direction(auxiliary_offset);
+    s0 = helper.local_distance_from_pixel_distance(*stroke_radius, clip_p, clip_direction0);
+
+    clip_p = helper.apply(position + s0 * auxiliary_offset);
+    n = helper.align_normal_to_screen(clip_p, pre_offset);
+    clip_direction1 = helper.apply_direction(n);
+    s1 = helper.local_distance_from_pixel_distance(*stroke_radius, clip_p, clip_direction1);
+
+    *stroke_radius = 1.0f;
+    return s0 * auxiliary_offset + s1 * n;
+  }
+
+  vec2
+  stroke_compute_offset_pixels_rounded_cap(const ItemVertexHelper &helper,
+                                           const vec2 &position,
+                                           const vec2 &pre_offset, const vec2 &auxiliary_offset,
+                                           float *stroke_radius)
+  {
+    vec2 n(pre_offset), v(n.y(), -n.x());
+    vec3 clip_n, clip_v, clip_p;
+    vec2 tn(auxiliary_offset);
+
+    clip_p = helper.apply(position);
+    n = helper.align_normal_to_screen(clip_p, n);
+
+    clip_v = helper.apply_direction(v);
+    tn.x() = helper.local_distance_from_pixel_distance(tn.x() * (*stroke_radius), clip_p, clip_v);
+
+    clip_n = helper.apply_direction(n);
+    tn.y() = helper.local_distance_from_pixel_distance(tn.y() * (*stroke_radius), clip_p, clip_n);
+
+    *stroke_radius = 1.0f;
+    return tn.x() * v + tn.y() * n;
+  }
+
+  /* FASTUIDRAW_LOCAL(compute_offset_pixels) */
+  vec2
+  stroke_compute_offset_pixels(const ItemVertexHelper &helper,
+                               uint32_t point_packed_data, uint32_t offset_type,
+                               const vec2 &position,
+                               const vec2 &pre_offset, const vec2 &auxiliary_offset,
+                               float miter_limit, float *stroke_radius)
+  {
+    switch (offset_type)
+      {
+      case StrokedPoint::offset_miter_clip_join:
+        return stroke_compute_offset_pixels_miter_clip(helper, point_packed_data, position,
+                                                       pre_offset, auxiliary_offset,
+                                                       miter_limit, stroke_radius);
+
+      case StrokedPoint::offset_miter_join:
+      case StrokedPoint::offset_miter_bevel_join:
+        return stroke_compute_offset_pixels_miter(helper, offset_type, position,
+                                                  pre_offset, auxiliary_offset,
+                                                  miter_limit, stroke_radius);
+
+      case StrokedPoint::offset_rounded_join:
+        return stroke_compute_offset_pixels_rounded_join(helper, point_packed_data, position,
+                                                         pre_offset, auxiliary_offset,
+                                                         stroke_radius);
+
+      case StrokedPoint::offset_square_cap:
+        return stroke_compute_offset_pixels_square_cap(helper, position,
+                                                       pre_offset, auxiliary_offset,
+                                                       stroke_radius);
+
+      case StrokedPoint::offset_rounded_cap:
+        return stroke_compute_offset_pixels_rounded_cap(helper, position,
+                                                        pre_offset, auxiliary_offset,
+                                                        stroke_radius);
+
+      default:
+        return stroke_compute_offset_pixels_default(helper, point_packed_data, position,
+                                                    pre_offset, auxiliary_offset,
+                                                    stroke_radius);
+      }
+  }
+
+  void
+  stroke_vertex_shader(const ItemShaderContext &ctx,
+                       const ItemVertexInput &in,
+                       ItemVertexOutput *out)
+  {
+    const uint32_t not_dashed(ShaderSetCreator::sub_shader(PainterEnums::number_cap_styles));
+    const uint32_t dashed_flat_caps(ShaderSetCreator::sub_shader(PainterEnums::flat_caps));
+    ItemVertexHelper helper(ctx, in.m_item_matrix);
+    StrokedPoint pt;
+    bool stroke_width_pixels;
+    float miter_limit, stroke_radius;
+    uint32_t on_boundary, offset_type, point_packed_data, dash_style;
+    uint32_t dash_bits(0u);
+    float stroking_distance(0.0f);
+    float distance_sub_edge_start(0.0f), distance_sub_edge_end(0.0f);
+    vec2 position, auxiliary_offset, p;
+
+    dash_style = in.m_sub_shader;
+    StrokedPoint::unpack_point(&pt, *in.m_attribute);
+
+    if (dash_style != not_dashed)
+      {
+        DashedStrokeParams params(ctx, in.m_shader_data_location);
+
+        stroke_width_pixels = (params.m_radius < 0.0f);
+        stroke_radius = t_abs(params.m_radius);
+        miter_limit = params.m_miter_limit;
+      }
+    else
+      {
+        const generic_data *params(&ctx.m_store[4u * in.m_shader_data_location]);
+
+        stroke_width_pixels = (params[PainterStrokeParams::stroke_radius_offset].f < 0.0f);
+        stroke_radius = t_abs(params[PainterStrokeParams::stroke_radius_offset].f);
+        miter_limit = params[PainterStrokeParams::stroke_miter_limit_offset].f;
+      }
+
+    point_packed_data = pt.m_packed_data;
+    position = pt.m_position;
+    auxiliary_offset = pt.m_auxiliary_offset;
+    offset_type = StrokedPoint::offset_type(point_packed_data);
+    on_boundary = unpack_bits(StrokedPoint::boundary_bit, 1u, point_packed_data);
+
+    if (dash_style != not_dashed)
+      {
+        DashedStrokeParams params(ctx, in.m_shader_data_location);
+        DashedBase base(ctx, pt.m_distance_from_contour_start + params.m_dash_offset,
+                        in.m_shader_data_location, params);
+
+        if (offset_type == StrokedPoint::offset_sub_edge)
+          {
+            if ((point_packed_data & StrokedPoint::bevel_edge_mask) != 0u)
+              {
+                dash_bits = stroke_gauranteed_to_be_covered_mask;
+                stroking_distance = 0.0f;
+                if (base.m_s < 0.0f)
+                  {
+                    on_boundary = 0u;
+                  }
+              }
+            else
+              {
+                float delta_mag(auxiliary_offset.magnitude());
+                DashedEdgeExtend extend_edge(ctx, params, stroke_radius,
+                                             (point_packed_data & StrokedPoint::end_sub_edge_mask) != 0u,
+                                             delta_mag, dash_style != dashed_flat_caps,
+                                             base);
+
+                distance_sub_edge_start = extend_edge.m_edge_distance_start;
+                distance_sub_edge_end = extend_edge.m_edge_distance_end;
+                dash_bits = extend_edge.m_stroking_bits;
+                stroking_distance = extend_edge.m_stroking_distance;
+                if (extend_edge.m_collapse)
+                  {
+                    on_boundary = 0u;
+                  }
+
+                if (extend_edge.m_extend_edge)
+                  {
+                    position -= auxiliary_offset * (stroke_radius / delta_mag);
+                  }
+              }
+          }
+        else if (offset_type == StrokedPoint::offset_adjustable_cap)
+          {
+            if (base.m_s > 0.0f)
+              {
+                if ((point_packed_data & StrokedPoint::adjustable_cap_ending_mask) != 0u)
+                  {
+                    position += stroke_radius * auxiliary_offset;
+                    stroking_distance = -stroke_radius;
+                  }
+                else
+                  {
+                    stroking_distance = 0.0f;
+                  }
+              }
+            else
+              {
+                on_boundary = 0u;
+                stroking_distance = 0.0f;
+              }
+            auxiliary_offset = vec2(0.0f, 0.0f);
+            dash_bits = stroke_skip_dash_interval_lookup_mask;
+            offset_type = StrokedPoint::offset_shared_with_edge;
+          }
+        else if ((point_packed_data & StrokedPoint::join_mask) != 0u)
+          {
+            dash_bits = stroke_gauranteed_to_be_covered_mask;
+            stroking_distance = 0.0f;
+            if (base.m_s < 0.0f)
+              {
+                on_boundary = 0u;
+              }
+          }
+      }
+
+    if (on_boundary != 0u)
+      {
+        vec2 offset;
+
+        if (stroke_width_pixels)
+          {
+            offset = stroke_compute_offset_pixels(helper, point_packed_data, offset_type,
+                                                  position, pt.m_pre_offset, auxiliary_offset,
+                                                  miter_limit, &stroke_radius);
+          }
+        else
+          {
+            offset = stroke_compute_offset(point_packed_data, offset_type,
+                                           pt.m_pre_offset, auxiliary_offset,
+                                           miter_limit);
+          }
+        p = position + stroke_radius * offset;
+      }
+    else
+      {
+        p = position;
+      }
+
+    out->m_varyings[stroking_on_boundary_varying] = static_cast<float>(on_boundary);
+    out->m_varyings[stroking_distance_varying] = stroking_distance;
+    out->m_varyings[stroking_distance_sub_edge_start_varying] = distance_sub_edge_start;
+    out->m_varyings[stroking_distance_sub_edge_end_varying] = distance_sub_edge_end;
+    out->m_flats[stroking_dash_bits_flat] = dash_bits;
+
+    out->m_brush_p = p;
+    out->m_add_z = static_cast<int>(unpack_bits(StrokedPoint::depth_bit0,
+                                                StrokedPoint::depth_num_bits,
+                                                point_packed_data));
+    out->m_clip_p = helper.apply(p);
+  }
+
+  /* fastuidraw_stroke_compute_dash_interval */
+  float
+  stroke_compute_dash_interval(const ItemShaderContext &ctx,
+                               uint32_t dashed_stroking_data_location,
+                               float total_distance, float first_interval_start,
+                               float in_distance, float start, float end,
+                               uint32_t number_intervals)
+  {
+    if (in_distance <= start)
+      {
+        return in_distance - start;
+      }
+    else if (in_distance >= end)
+      {
+        return end - in_distance;
+      }
+    else
+      {
+        int interval_id;
+        float interval_begin, interval_end, s;
+
+        s = compute_interval(ctx, dashed_stroking_data_location, total_distance,
+                             first_interval_start, in_distance, number_intervals,
+                             &interval_id, &interval_begin, &interval_end);
+        return s * t_min(in_distance - interval_begin, interval_end - in_distance);
+      }
+  }
+
+  /* fastuidraw_stroke_compute_dash_coverage */
+  float
+  stroke_compute_dash_coverage(const ItemShaderContext &ctx,
+                               bool add_rounded_caps, bool add_square_caps,
+                               uint32_t shader_data_offset,
+                               float distance_value, float fwidth_distance_value,
+                               float stroking_on_boundary, float fwidth_stroking_on_boundary,
+                               float distance_sub_edge_start, float distance_sub_edge_end,
+                               bool skip_interval_lookup,
+                               bool distance_value_constant_on_primitive)
+  {
+    DashedStrokeParams params(ctx, shader_data_offset);
+    float q, r, y, qq_yy, fwidth_qq_yy, fw;
+
+    if (skip_interval_lookup)
+      {
+        q = distance_value;
+      }
+    else
+      {
+        float f;
+
+        f = distance_value > params.m_total_length ?
+          params.m_first_interval_start_on_looping :
+          params.m_first_interval_start;
+
+        q = stroke_compute_dash_interval(ctx, shader_data_offset + DashedStrokeParams::num_blocks(),
+                                         params.m_total_length, f, distance_value,
+                                         distance_sub_edge_start, distance_sub_edge_end,
+                                         params.m_number_intervals);
+      }
+
+    r = t_abs(params.m_radius);
+    y = r * stroking_on_boundary;
+    qq_yy = q * q + y * y;
+    fw = fwidth_distance_value;
+    fwidth_qq_yy = 2.0f * t_abs(q) * fw + 2.0f * t_abs(y) * r * fwidth_stroking_on_boundary;
+
+    if (add_rounded_caps)
+      {
+        if (q < fw && q > -fw - r)
+          {
+            float sq;
+
+            sq = t_sqrt(qq_yy);
+            q = r - sq;
+            fw = (sq > 0.0f) ? 0.5f * fwidth_qq_yy / sq : fw;
+          }
+      }
+    else if (add_square_caps)
+      {
+        q += r;
+      }
+
+    if (!distance_value_constant_on_primitive)
+      {
+        float d;
+
+        d = t_max(t_abs(q), fw);
+        return (d > 0.0f) ? t_max(0.0f, q / d) : 0.0f;
+      }
+    else
+      {
+        return q > 0.0f ? 1.0f : 0.0f;
+      }
+  }
+
+  float
+  stroke_fragment_shader(const ItemShaderContext &ctx,
+                         const ItemFragmentInput &in,
+                         bool use_deferred_coverage)
+  {
+    const uint32_t not_dashed(ShaderSetCreator::sub_shader(PainterEnums::number_cap_styles));
+    const uint32_t dashed_rounded_caps(ShaderSetCreator::sub_shader(PainterEnums::rounded_caps));
+    const uint32_t dashed_square_caps(ShaderSetCreator::sub_shader(PainterEnums::square_caps));
+    uint32_t dash_style(in.m_sub_shader);
+    uint32_t dash_bits(in.m_flats[stroking_dash_bits_flat]);
+    float alpha(1.0f), fwidth_on_boundary;
+
+    fwidth_on_boundary = t_abs(in.m_varyings_dx[stroking_on_boundary_varying])
+      + t_abs(in.m_varyings_dy[stroking_on_boundary_varying]);
+
+    if (dash_style != not_dashed
+        && (dash_bits & stroke_gauranteed_to_be_covered_mask) == 0u)
+      {
+        float fwidth_distance;
+
+        fwidth_distance = t_abs(in.m_varyings_dx[stroking_distance_varying])
+          + t_abs(in.m_varyings_dy[stroking_distance_varying]);
+        alpha = stroke_compute_dash_coverage(ctx,
+                                             dash_style == dashed_rounded_caps,
+                                             dash_style == dashed_square_caps,
+                                             in.m_shader_data_location,
+                                             in.m_varyings[stroking_distance_varying],
+                                             fwidth_distance,
+                                             in.m_varyings[stroking_on_boundary_varying],
+                                             fwidth_on_boundary,
+                                             in.m_varyings[stroking_distance_sub_edge_start_varying],
+                                             in.m_varyings[stroking_distance_sub_edge_end_varying],
+                                             (dash_bits & stroke_skip_dash_interval_lookup_mask) != 0u,
+                                             (dash_bits & stroke_distance_constant) != 0u);
+      }
+
+    if (!use_deferred_coverage)
+      {
+        if (alpha < 1.0f - 1.0f / 255.0f)
+          {
+            return -1.0f;
+          }
+        alpha = 1.0f;
+      }
+    else
+      {
+        float dd, q;
+
+        q = 1.0f - in.m_varyings[stroking_on_boundary_varying];
+        dd = t_max(q, fwidth_on_boundary);
+        alpha *= (dd > 0.0f) ? q / dd : 0.0f;
+      }
+    return alpha;
+  }
+
+  ////////////////////////////////////////
+  // glyph shaders
+  void
+  glyph_texel_vertex_shader(const ItemShaderContext &ctx,
+                            const ItemVertexInput &in,
+                            ItemVertexOutput *out)
+  {
+    ItemVertexHelper helper(ctx, in.m_item_matrix);
+    const PainterAttribute &attr(*in.m_attribute);
+    uint32_t v(attr.m_attrib1.x());
+    vec2 p;
+
+    p = vec2(as_float(attr.m_attrib0.x()), as_float(attr.m_attrib0.y()));
+    out->m_varyings[glyph_coord_x_varying] =
+      static_cast<float>(unpack_bits(GlyphAttribute::rect_x_bit0, GlyphAttribute::rect_x_num_bits, v));
+    out->m_varyings[glyph_coord_y_varying] =
+      static_cast<float>(unpack_bits(GlyphAttribute::rect_y_bit0, GlyphAttribute::rect_y_num_bits, v));
+    out->m_varyings[glyph_width_varying] =
+      static_cast<float>(unpack_bits(GlyphAttribute::rect_width_bit0, GlyphAttribute::rect_width_num_bits, v));
+    out->m_varyings[glyph_height_varying] =
+      static_cast<float>(unpack_bits(GlyphAttribute::rect_height_bit0, GlyphAttribute::rect_height_num_bits, v));
+    out->m_flats[glyph_data_location_flat] = attr.m_attrib1.y();
+
+    out->m_add_z = 0;
+    out->m_clip_p = helper.apply(p);
+    out->m_brush_p = p;
+  }
+
+  /* shared by the restricted and banded rays vertex shaders */
+  void
+  glyph_rays_vertex_shader(const ItemShaderContext &ctx,
+                           const ItemVertexInput &in,
+                           float glyph_coord_value,
+                           ItemVertexOutput *out)
+  {
+    const float num_pixels = 2.0f;
+    ItemVertexHelper helper(ctx, in.m_item_matrix);
+    const PainterAttribute &attr(*in.m_attribute);
+    vec2 p, q, push, wh, p0, sign_wh;
+    bool is_min_side_x, is_min_side_y;
+    float glyph_min, glyph_size, r;
+    vec3 clip_p, clip_direction;
+
+    p = vec2(as_float(attr.m_attrib0.x()), as_float(attr.m_attrib0.y()));
+    wh = vec2(as_float(attr.m_attrib0.z()), as_float(attr.m_attrib0.w()));
+    glyph_size = 2.0f * glyph_coord_value;
+    glyph_min = -glyph_coord_value;
+
+    is_min_side_x = (attr.m_attrib1.x() == 0u);
+    is_min_side_y = (attr.m_attrib1.y() == 0u);
+    sign_wh = vec2(glsl_sign(wh.x()), glsl_sign(wh.y()));
+    push.x() = (is_min_side_x) ? -sign_wh.x() : sign_wh.x();
+    push.y() = (is_min_side_y) ? -sign_wh.y() : sign_wh.y();
+
+    clip_p = helper.apply(p);
+    clip_direction = helper.apply_direction(push);
+    r = helper.local_distance_from_pixel_distance(num_pixels, clip_p, clip_direction);
+    q = p + r * push;
+
+    p0.x() = (is_min_side_x) ? p.x() : p.x() - wh.x();
+    p0.y() = (is_min_side_y) ? p.y() : p.y() - wh.y();
+
+    out->m_varyings[glyph_coord_x_varying] = glyph_min + glyph_size * (q.x() - p0.x()) / wh.x();
+    out->m_varyings[glyph_coord_y_varying] = glyph_min + glyph_size * (q.y() - p0.y()) / wh.y();
+    out->m_add_z = 0;
+    out->m_clip_p = helper.apply(q);
+    out->m_brush_p = q;
+  }
+
+  /* fastuidraw_read_texel_from_data */
+  uint32_t
+  read_texel_from_data(const ItemShaderContext &ctx, int cx, int cy,
+                       uint32_t dims_x, uint32_t dims_y, uint32_t location)
+  {
+    uint32_t x, y, block;
+
+    if (cx < 0 || cy < 0)
+      {
+        return 0u;
+      }
+
+    x = static_cast<uint32_t>(cx);
+    y = static_cast<uint32_t>(cy);
+    if (x >= dims_x || y >= dims_y)
+      {
+        return 0u;
+      }
+
+    block = fetch_glyph_data(ctx, location + (x >> 1u) + (y >> 1u) * ((dims_x + 1u) >> 1u));
+    return unpack_bits(((x & 1u) != 0u ? 8u : 0u) + ((y & 1u) != 0u ? 16u : 0u), 8u, block);
+  }
+
+  /* Computes the bilinear filtered texel value of the coverage
+   * and distance field glyphs, normalized to [0, 1]; also gives
+   * the derivative of the texel value with respect to the glyph
+   * coordinate.
+   */
+  float
+  glyph_texel_filtered(const ItemShaderContext &ctx,
+                       const ItemFragmentInput &in,
+                       vec2 *texel_gradient)
+  {
+    uint32_t dims_x, dims_y, loc;
+    vec2 tau_plus_half, mixer;
+    int x00, y00;
+    float f00, f01, f10, f11, f0, f1;
+
+    dims_x = static_cast<uint32_t>(in.m_varyings[glyph_width_varying]);
+    dims_y = static_cast<uint32_t>(in.m_varyings[glyph_height_varying]);
+    loc = in.m_flats[glyph_data_location_flat];
+    tau_plus_half = vec2(in.m_varyings[glyph_coord_x_varying] + 0.5f,
+                         in.m_varyings[glyph_coord_y_varying] + 0.5f);
+
+    x00 = static_cast<int>(tau_plus_half.x()) - 1;
+    y00 = static_cast<int>(tau_plus_half.y()) - 1;
+    mixer = tau_plus_half - vec2(static_cast<float>(x00 + 1), static_cast<float>(y00 + 1));
+
+    f00 = static_cast<float>(read_texel_from_data(ctx, x00, y00, dims_x, dims_y, loc));
+    f01 = static_cast<float>(read_texel_from_data(ctx, x00, y00 + 1, dims_x, dims_y, loc));
+    f10 = static_cast<float>(read_texel_from_data(ctx, x00 + 1, y00, dims_x, dims_y, loc));
+    f11 = static_cast<float>(read_texel_from_data(ctx, x00 + 1, y00 + 1, dims_x, dims_y, loc));
+
+    f0 = f00 + mixer.y() * (f01 - f00);
+    f1 = f10 + mixer.y() * (f11 - f10);
+
+    if (texel_gradient)
+      {
+        texel_gradient->x() = (f1 - f0) / 255.0f;
+        texel_gradient->y() = ((1.0f - mixer.x()) * (f01 - f00) + mixer.x() * (f11 - f10)) / 255.0f;
+      }
+    return (f0 + mixer.x() * (f1 - f0)) / 255.0f;
+  }
+
+  float
+  glyph_coverage_fragment_shader(const ItemShaderContext &ctx,
+                                 const ItemFragmentInput &in)
+  {
+    return glyph_texel_filtered(ctx, in, nullptr);
+  }
+
+  float
+  glyph_distance_field_fragment_shader(const ItemShaderContext &ctx,
+                                       const ItemFragmentInput &in)
+  {
+    float texel, dist, dx, dy, mag_sq;
+    vec2 grad;
+
+    texel = glyph_texel_filtered(ctx, in, &grad);
+    dist = 2.0f * texel - 1.0f;
+
+    /* the derivatives of dist are computed by the chain
+     * rule from the derivatives of the glyph coordinate
+     * instead of by finite differences across a quad.
+     */
+    dx = 2.0f * (grad.x() * in.m_varyings_dx[glyph_coord_x_varying]
+                 + grad.y() * in.m_varyings_dx[glyph_coord_y_varying]);
+    dy = 2.0f * (grad.x() * in.m_varyings_dy[glyph_coord_x_varying]
+                 + grad.y() * in.m_varyings_dy[glyph_coord_y_varying]);
+
+    /* fastuidraw_anisotropic_coverage */
+    mag_sq = dx * dx + dy * dy;
+    if (mag_sq <= 0.0f)
+      {
+        return (dist > 0.0f) ? 1.0f : 0.0f;
+      }
+    return clamp01(0.5f + dist / t_sqrt(mag_sq));
+  }
+
+  /* fastuidraw_read_multi_channel_texel_from_data */
+  vec3
+  read_multi_channel_texel_from_data(const ItemShaderContext &ctx, int cx, int cy,
+                                     uint32_t dims_x, uint32_t dims_y, uint32_t location)
+  {
+    uint32_t x, y, texel;
+
+    if (cx < 0 || cy < 0)
+      {
+        return vec3(0.0f);
+      }
+
+    x = static_cast<uint32_t>(cx);
+    y = static_cast<uint32_t>(cy);
+    if (x >= dims_x || y >= dims_y)
+      {
+        return vec3(0.0f);
+      }
+
+    texel = fetch_glyph_data(ctx, location + x + y * dims_x);
+    return vec3(static_cast<float>(unpack_bits(0u, 8u, texel)),
+                static_cast<float>(unpack_bits(8u, 8u, texel)),
+                static_cast<float>(unpack_bits(16u, 8u, texel)));
+  }
+
+  float
+  glyph_multi_channel_distance_field_fragment_shader(const ItemShaderContext &ctx,
+                                                     const ItemFragmentInput &in)
+  {
+    uint32_t dims_x, dims_y, loc;
+    vec2 tau_plus_half, mixer, grad;
+    int x00, y00;
+    vec3 f00, f01, f10, f11, f0, f1, texel;
+    float dist, dx, dy, mag_sq;
+    unsigned int median;
+
+    dims_x = static_cast<uint32_t>(in.m_varyings[glyph_width_varying]);
+    dims_y = static_cast<uint32_t>(in.m_varyings[glyph_height_varying]);
+    loc = in.m_flats[glyph_data_location_flat];
+    tau_plus_half = vec2(in.m_varyings[glyph_coord_x_varying] + 0.5f,
+                         in.m_varyings[glyph_coord_y_varying] + 0.5f);
+
+    x00 = static_cast<int>(tau_plus_half.x()) - 1;
+    y00 = static_cast<int>(tau_plus_half.y()) - 1;
+    mixer = tau_plus_half - vec2(static_cast<float>(x00 + 1), static_cast<float>(y00 + 1));
+
+    f00 = read_multi_channel_texel_from_data(ctx, x00, y00, dims_x, dims_y, loc);
+    f01 = read_multi_channel_texel_from_data(ctx, x00, y00 + 1, dims_x, dims_y, loc);
+    f10 = read_multi_channel_texel_from_data(ctx, x00 + 1, y00, dims_x, dims_y, loc);
+    f11 = read_multi_channel_texel_from_data(ctx, x00 + 1, y00 + 1, dims_x, dims_y, loc);
+
+    f0 = f00 + mixer.y() * (f01 - f00);
+    f1 = f10 + mixer.y() * (f11 - f10);
+    texel = f0 + mixer.x() * (f1 - f0);
+
+    /* the channel giving the median of the three; ties
+     * between channels are common so the tests are not strict.
+     */
+    if ((texel[0] <= texel[1] && texel[1] <= texel[2])
+        || (texel[2] <= texel[1] && texel[1] <= texel[0]))
+      {
+        median = 1;
+      }
+    else if ((texel[1] <= texel[0] && texel[0] <= texel[2])
+             || (texel[2] <= texel[0] && texel[0] <= texel[1]))
+      {
+        median = 0;
+      }
+    else
+      {
+        median = 2;
+      }
+
+    dist = 2.0f * texel[median] / 255.0f - 1.0f;
+    grad.x() = (f1[median] - f0[median]) / 255.0f;
+    grad.y() = ((1.0f - mixer.x()) * (f01[median] - f00[median])
+                + mixer.x() * (f11[median] - f10[median])) / 255.0f;
+
+    /* as in glyph_distance_field_fragment_shader() */
+    dx = 2.0f * (grad.x() * in.m_varyings_dx[glyph_coord_x_varying]
+                 + grad.y() * in.m_varyings_dx[glyph_coord_y_varying]);
+    dy = 2.0f * (grad.x() * in.m_varyings_dy[glyph_coord_x_varying]
+                 + grad.y() * in.m_varyings_dy[glyph_coord_y_varying]);
+
+    mag_sq = dx * dx + dy * dy;
+    if (mag_sq <= 0.0f)
+      {
+        return (dist > 0.0f) ? 1.0f : 0.0f;
+      }
+    return clamp01(0.5f + dist / t_sqrt(mag_sq));
+  }
+
+  ////////////////////////////////////////
+  // restricted rays, port of fastuidraw_restricted_rays.glsl
+  class RestrictedRaysTransformation
+  {
+  public:
+    vec2
+    apply(const vec2 &in_p) const
+    {
+      vec2 p(in_p - m_translation);
+      return vec2(dot(m_t_vector, p), dot(m_jq_vector, p));
+    }
+
+    vec2 m_translation;
+    vec2 m_t_vector, m_jq_vector;
+    float m_reference_location;
+  };
+
+  class RestrictedRaysDistance
+  {
+  public:
+    RestrictedRaysDistance(void):
+      m_distance_increment(120.0f),
+      m_distance_decrement(120.0f)
+    {}
+
+    void
+    update(float dist, bool is_increment)
+    {
+      if (is_increment)
+        {
+          m_distance_increment = t_min(m_distance_increment, dist);
+        }
+      else
+        {
+          m_distance_decrement = t_min(m_distance_decrement, dist);
+        }
+    }
+
+    float m_distance_increment;
+    float m_distance_decrement;
+  };
+
+  class RestrictedRaysBox
+  {
+  public:
+    vec2 m_min_point, m_max_point, m_size;
+  };
+
+  uint32_t
+  restricted_rays_compute_box(const ItemShaderContext &ctx,
+                              const vec2 &p, uint32_t data_location,
+                              RestrictedRaysBox *box,
+                              uint32_t *curve_list, uint32_t *num_curves)
+  {
+    typedef GlyphRenderDataRestrictedRays R;
+    const float G(static_cast<float>(R::glyph_coord_value));
+    uint32_t v, offset;
+
+    box->m_min_point = vec2(-G, -G);
+    box->m_max_point = vec2(G, G);
+
+    offset = data_location;
+    v = fetch_glyph_data(ctx, offset);
+    while ((v & FASTUIDRAW_MASK(R::hierarchy_is_node_bit, 1u)) != 0u)
+      {
+        uint32_t c, bit0;
+        float split_pt;
+        bool take_max_choice;
+
+        c = unpack_bits(R::hierarchy_splitting_coordinate_bit, 1u, v);
+        split_pt = 0.5f * (box->m_min_point[c] + box->m_max_point[c]);
+        take_max_choice = (p[c] > split_pt);
+        if (take_max_choice)
+          {
+            box->m_min_point[c] = split_pt;
+          }
+        else
+          {
+            box->m_max_point[c] = split_pt;
+          }
+
+        bit0 = (take_max_choice) ?
+          R::hierarchy_child1_offset_bit0 :
+          R::hierarchy_child0_offset_bit0;
+        offset = unpack_bits(bit0, R::hierarchy_child_offset_numbits, v);
+        offset += data_location;
+        v = fetch_glyph_data(ctx, offset);
+      }
+
+    box->m_size = box->m_max_point - box->m_min_point;
+    *curve_list = unpack_bits(R::hierarchy_leaf_curve_list_bit0,
+                              R::hierarchy_leaf_curve_list_numbits, v);
+    *num_curves = unpack_bits(R::hierarchy_leaf_curve_list_size_bit0,
+                              R::hierarchy_leaf_curve_list_size_numbits, v);
+    return offset + 1u;
+  }
+
+  void
+  restricted_rays_compute_transformation(const vec2 &frag_point,
+                                         const vec2 &frag_point_dx,
+                                         const vec2 &frag_point_dy,
+                                         const vec2 &reference_point,
+                                         RestrictedRaysTransformation *tr)
+  {
+    const float min_em = 1e-7f;
+    vec2 q, top_row, bottom_row, em;
+    float a, b, c, d, det;
+
+    tr->m_translation = frag_point;
+    q = reference_point - frag_point;
+    tr->m_jq_vector = vec2(-q.y(), q.x());
+
+    a = frag_point_dx.x();
+    b = frag_point_dy.x();
+    c = frag_point_dx.y();
+    d = frag_point_dy.y();
+
+    top_row.x() = -(c * c + d * d);
+    top_row.y() = bottom_row.x() = (a * c + b * d);
+    bottom_row.y() = -(a * a + b * b);
+
+    tr->m_t_vector.x() = dot(top_row, q);
+    tr->m_t_vector.y() = dot(bottom_row, q);
+
+    em.x() = t_abs(dot(tr->m_t_vector, frag_point_dx)) + t_abs(dot(tr->m_t_vector, frag_point_dy));
+    em.y() = t_abs(dot(tr->m_jq_vector, frag_point_dx)) + t_abs(dot(tr->m_jq_vector, frag_point_dy));
+    em.x() = t_max(em.x(), min_em);
+    em.y() = t_max(em.y(), min_em);
+
+    tr->m_t_vector /= em.x();
+    tr->m_jq_vector /= em.y();
+
+    tr->m_reference_location = dot(tr->m_t_vector, q);
+    if (tr->m_reference_location < 0.0f)
+      {
+        tr->m_t_vector = -tr->m_t_vector;
+        tr->m_reference_location = -tr->m_reference_location;
+      }
+
+    det = tr->m_t_vector.x() * tr->m_jq_vector.y() - tr->m_t_vector.y() * tr->m_jq_vector.x();
+    if (det < 0.0f)
+      {
+        tr->m_jq_vector = -tr->m_jq_vector;
+      }
+  }
+
+  inline
+  uint32_t
+  rays_compute_code(float y1, float y2, float y3)
+  {
+    uint32_t code;
+
+    code = (y1 > 0.0f ? 2u : 0u)
+      + (y2 > 0.0f ? 4u : 0u)
+      + (y3 > 0.0f ? 8u : 0u);
+    return (0x2E74u >> code) & 0x3u;
+  }
+
+  int
+  restricted_rays_compute_winding_contribution(vec2 p1, vec2 p2, vec2 p3,
+                                               bool is_quadratic,
+                                               const RestrictedRaysTransformation &tr,
+                                               RestrictedRaysDistance *dst)
+  {
+    const float quad_tol = 0.0001f;
+    vec2 A, B, C;
+    uint32_t code_x, code_y;
+    int R(0);
+
+    p1 = tr.apply(p1);
+    p2 = tr.apply(p2);
+    p3 = tr.apply(p3);
+
+    A = p1 - 2.0f * p2 + p3;
+    B = p1 - p2;
+    C = p1;
+
+    code_x = rays_compute_code(p1.x(), p2.x(), p3.x());
+    code_y = rays_compute_code(p1.y(), p2.y(), p3.y());
+
+    if (code_y != 0u)
+      {
+        float t1, t2, x1, x2;
+
+        if (is_quadratic && t_abs(A.y()) > quad_tol)
+          {
+            float D, rA = 1.0f / A.y();
+
+            D = B.y() * B.y() - A.y() * C.y();
+            if (D < 0.0f)
+              {
+                code_y = 0u;
+                D = 0.0f;
+              }
+            D = t_sqrt(D);
+            t1 = (B.y() - D) * rA;
+            t2 = (B.y() + D) * rA;
+          }
+        else
+          {
+            t1 = t2 = 0.5f * C.y() / B.y();
+          }
+
+        x1 = (A.x() * t1 - B.x() * 2.0f) * t1 + C.x();
+        x2 = (A.x() * t2 - B.x() * 2.0f) * t2 + C.x();
+
+        if ((code_y & 1u) != 0u)
+          {
+            if (x1 <= tr.m_reference_location && x1 >= 0.0f)
+              {
+                R += 1;
+              }
+            dst->update(t_abs(x1), x1 < 0.0f);
+          }
+
+        if (code_y > 1u)
+          {
+            if (x2 <= tr.m_reference_location && x2 >= 0.0f)
+              {
+                R -= 1;
+              }
+            dst->update(t_abs(x2), x2 > 0.0f);
+          }
+      }
+
+    if (code_x != 0u)
+      {
+        float t1, t2, y1, y2;
+
+        if (is_quadratic && t_abs(A.x()) > quad_tol)
+          {
+            float D, rA = 1.0f / A.x();
+
+            D = B.x() * B.x() - A.x() * C.x();
+            if (D < 0.0f)
+              {
+                code_x = 0u;
+                D = 0.0f;
+              }
+            D = t_sqrt(D);
+            t1 = (B.x() - D) * rA;
+            t2 = (B.x() + D) * rA;
+          }
+        else
+          {
+            t1 = t2 = 0.5f * C.x() / B.x();
+          }
+
+        y1 = (A.y() * t1 - B.y() * 2.0f) * t1 + C.y();
+        y2 = (A.y() * t2 - B.y() * 2.0f) * t2 + C.y();
+
+        if ((code_x & 1u) != 0u)
+          {
+            dst->update(t_abs(y1), y1 > 0.0f);
+          }
+
+        if (code_x > 1u)
+          {
+            dst->update(t_abs(y2), y2 < 0.0f);
+          }
+      }
+
+    return R;
+  }
+
+  int
+  restricted_rays_load_and_process_curve(const ItemShaderContext &ctx,
+                                         uint32_t raw, uint32_t glyph_data_location,
+                                         const RestrictedRaysTransformation &tr,
+                                         RestrictedRaysDistance *nv)
+  {
+    typedef GlyphRenderDataRestrictedRays R;
+    uint32_t curve_src;
+    bool is_quadratic;
+    vec2 p1, p2, p3;
+
+    curve_src = glyph_data_location + unpack_bits(R::curve_location_bit0, R::curve_location_numbits, raw);
+    is_quadratic = (raw & FASTUIDRAW_MASK(R::curve_is_quadratic_bit, 1u)) != 0u;
+    p1 = unpack_half2x16(fetch_glyph_data(ctx, curve_src));
+    p2 = unpack_half2x16(fetch_glyph_data(ctx, curve_src + 1u));
+    if (is_quadratic)
+      {
+        p3 = unpack_half2x16(fetch_glyph_data(ctx, curve_src + 2u));
+      }
+    else
+      {
+        p3 = p2;
+        p2 = 0.5f * (p1 + p3);
+      }
+
+    return restricted_rays_compute_winding_contribution(p1, p2, p3, is_quadratic, tr, nv);
+  }
+
+  float
+  restricted_rays_compute_coverage(const ItemShaderContext &ctx,
+                                   uint32_t glyph_data_location,
+                                   const vec2 &glyph_coord,
+                                   const vec2 &glyph_coord_dx,
+                                   const vec2 &glyph_coord_dy,
+                                   bool use_odd_even_rule)
+  {
+    typedef GlyphRenderDataRestrictedRays R;
+    uint32_t src, curve_list, num_curves, winding_sample_data_location, texel;
+    RestrictedRaysTransformation tr;
+    RestrictedRaysDistance nv;
+    RestrictedRaysBox texel_box;
+    int winding_number;
+    vec2 reference_position, delta;
+    float distance;
+
+    winding_sample_data_location =
+      restricted_rays_compute_box(ctx, glyph_coord, glyph_data_location,
+                                  &texel_box, &curve_list, &num_curves);
+
+    /* fastuidraw_restricted_rays_load_winding_reference */
+    texel = fetch_glyph_data(ctx, winding_sample_data_location);
+    delta = vec2(static_cast<float>(unpack_bits(R::delta_x_bit0, R::delta_numbits, texel)),
+                 static_cast<float>(unpack_bits(R::delta_y_bit0, R::delta_numbits, texel)));
+    delta *= texel_box.m_size;
+    delta /= static_cast<float>(R::delta_div_factor);
+    reference_position = texel_box.m_min_point + delta;
+    winding_number = static_cast<int>(unpack_bits(R::winding_value_bit0, R::winding_value_numbits, texel))
+      - static_cast<int>(R::winding_bias);
+
+    restricted_rays_compute_transformation(glyph_coord, glyph_coord_dx, glyph_coord_dy,
+                                           reference_position, &tr);
+
+    src = curve_list + glyph_data_location;
+    for (uint32_t c = 0u; c < num_curves; c += 2u, ++src)
+      {
+        uint32_t curve_pair;
+
+        curve_pair = fetch_glyph_data(ctx, src);
+        winding_number +=
+          restricted_rays_load_and_process_curve(ctx,
+                                                 unpack_bits(R::curve_entry0_bit0, R::curve_numbits, curve_pair),
+                                                 glyph_data_location, tr, &nv);
+        if (c + 1u < num_curves)
+          {
+            winding_number +=
+              restricted_rays_load_and_process_curve(ctx,
+                                                     unpack_bits(R::curve_entry1_bit0, R::curve_numbits, curve_pair),
+                                                     glyph_data_location, tr, &nv);
+          }
+      }
+
+    if (winding_number == 0 || use_odd_even_rule)
+      {
+        distance = t_min(nv.m_distance_increment, nv.m_distance_decrement);
+      }
+    else if (winding_number == -1)
+      {
+        distance = nv.m_distance_increment;
+      }
+    else if (winding_number == 1)
+      {
+        distance = nv.m_distance_decrement;
+      }
+    else
+      {
+        distance = 0.5f;
+      }
+
+    distance = t_min(distance, 0.5f);
+    winding_number = (use_odd_even_rule && (winding_number & 1) == 0) ? 0 : winding_number;
+    return (winding_number != 0) ? (0.5f + distance) : (0.5f - distance);
+  }
+
+  ////////////////////////////////////////
+  // banded rays, port of fastuidraw_banded_rays.glsl
+  void
+  banded_rays_compute_coverage_from_band(const ItemShaderContext &ctx,
+                                         uint32_t curve_offset, uint32_t num_curves,
+                                         const vec2 &glyph_coord, float em, float s,
+                                         float *out_coverage,
+                                         float *out_nearest_curve_distance)
+  {
+    const float tiny = 0.0001f;
+    float coverage(0.0f), nearest_curve_distance(0.5f);
+
+    for (uint32_t c = 0u, curve_src = curve_offset; c < num_curves; curve_src += 3u, ++c)
+      {
+        vec2 p0, p1, p2;
+        uint32_t code;
+
+        p0 = unpack_half2x16(fetch_glyph_data(ctx, curve_src)) - glyph_coord;
+        p1 = unpack_half2x16(fetch_glyph_data(ctx, curve_src + 1u)) - glyph_coord;
+        p2 = unpack_half2x16(fetch_glyph_data(ctx, curve_src + 2u)) - glyph_coord;
+
+        if (s > 0.0f && t_max(p0.x(), t_max(p1.x(), p2.x())) * em < -0.5f)
+          {
+            break;
+          }
+
+        if (s < 0.0f && t_min(p0.x(), t_min(p1.x(), p2.x())) * em > 0.5f)
+          {
+            break;
+          }
+
+        code = rays_compute_code(p0.y(), p1.y(), p2.y());
+        if (code != 0u)
+          {
+            float rA, D, t1, t2, x1, x2;
+            vec2 A, B, C;
+
+            /* fastuidraw_banded_rays_intersect_y_equals_0 */
+            A = p0 - 2.0f * p1 + p2;
+            B = p0 - p1;
+            C = p0;
+            if (t_abs(A.y()) < tiny)
+              {
+                t1 = t2 = 0.5f * C.y() / B.y();
+              }
+            else
+              {
+                rA = 1.0f / A.y();
+                D = t_sqrt(t_max(B.y() * B.y() - A.y() * C.y(), 0.0f));
+                t1 = (B.y() - D) * rA;
+                t2 = (B.y() + D) * rA;
+              }
+            x1 = em * ((A.x() * t1 - B.x() * 2.0f) * t1 + C.x());
+            x2 = em * ((A.x() * t2 - B.x() * 2.0f) * t2 + C.x());
+
+            if ((code & 1u) != 0u)
+              {
+                coverage += clamp01(0.5f + x1 * s);
+                nearest_curve_distance = t_min(nearest_curve_distance, t_abs(x1));
+              }
+
+            if (code > 1u)
+              {
+                coverage -= clamp01(0.5f + x2 * s);
+                nearest_curve_distance = t_min(nearest_curve_distance, t_abs(x2));
+              }
+          }
+      }
+
+    *out_coverage = t_abs(coverage);
+    *out_nearest_curve_distance = nearest_curve_distance;
+  }
+
+  float
+  banded_rays_compute_coverage(const ItemShaderContext &ctx,
+                               uint32_t glyph_data_location,
+                               const vec2 &glyph_coord,
+                               const vec2 &glyph_coord_fwidth,
+                               uint32_t num_vertical_bands,
+                               uint32_t num_horizontal_bands,
+                               bool use_odd_even_rule)
+  {
+    typedef GlyphRenderDataBandedRays R;
+    const float G(static_cast<float>(R::glyph_coord_value));
+    const float tiny = 0.001f;
+    uint32_t horiz_band_offset, vert_band_offset, horiz_band, vert_band;
+    uint32_t horiz_raw, vert_raw;
+    vec2 em, band_factor, coverage, nearest_curve_distance, weight;
+    float sx, sy, weight_sum;
+
+    if (num_vertical_bands == 0u || num_horizontal_bands == 0u)
+      {
+        return 0.0f;
+      }
+
+    em = vec2(1.0f / glyph_coord_fwidth.x(), 1.0f / glyph_coord_fwidth.y());
+    band_factor = (0.5f / G) * vec2(static_cast<float>(num_vertical_bands),
+                                     static_cast<float>(num_horizontal_bands));
+
+    vert_band = t_min(num_vertical_bands - 1u,
+                      static_cast<uint32_t>(t_max(0.0f, band_factor.x() * (glyph_coord.x() + G))));
+    horiz_band = t_min(num_horizontal_bands - 1u,
+                       static_cast<uint32_t>(t_max(0.0f, band_factor.y() * (glyph_coord.y() + G))));
+
+    horiz_band_offset = horiz_band;
+    if (glyph_coord.x() < 0.0f)
+      {
+        horiz_band_offset += num_horizontal_bands;
+        sx = -1.0f;
+      }
+    else
+      {
+        sx = 1.0f;
+      }
+
+    vert_band_offset = vert_band + 2u * num_horizontal_bands;
+    if (glyph_coord.y() < 0.0f)
+      {
+        vert_band_offset += num_vertical_bands;
+        sy = -1.0f;
+      }
+    else
+      {
+        sy = 1.0f;
+      }
+
+    horiz_raw = fetch_glyph_data(ctx, glyph_data_location + horiz_band_offset);
+    vert_raw = fetch_glyph_data(ctx, glyph_data_location + vert_band_offset);
+
+    banded_rays_compute_coverage_from_band(ctx,
+                                           glyph_data_location
+                                           + unpack_bits(R::band_curveoffset_bit0, R::band_curveoffset_numbits, horiz_raw),
+                                           unpack_bits(R::band_numcurves_bit0, R::band_numcurves_numbits, horiz_raw),
+                                           glyph_coord, em.x(), sx,
+                                           &coverage.x(), &nearest_curve_distance.x());
+
+    banded_rays_compute_coverage_from_band(ctx,
+                                           glyph_data_location
+                                           + unpack_bits(R::band_curveoffset_bit0, R::band_curveoffset_numbits, vert_raw),
+                                           unpack_bits(R::band_numcurves_bit0, R::band_numcurves_numbits, vert_raw),
+                                           vec2(glyph_coord.y(), glyph_coord.x()), em.y(), sy,
+                                           &coverage.y(), &nearest_curve_distance.y());
+
+    if (use_odd_even_rule)
+      {
+        coverage.x() = 2.0f * glsl_fract(0.5f * coverage.x());
+        coverage.y() = 2.0f * glsl_fract(0.5f * coverage.y());
+      }
+
+    weight.x() = 1.0f - 2.0f * t_min(t_abs(nearest_curve_distance.x()), 0.5f);
+    weight.y() = 1.0f - 2.0f * t_min(t_abs(nearest_curve_distance.y()), 0.5f);
+    weight_sum = weight.x() + weight.y();
+
+    return (weight_sum > tiny) ?
+      dot(coverage, weight) / weight_sum :
+      0.5f * (coverage.x() + coverage.y());
+  }
+
+  float
+  glyph_rays_fragment_shader(const ItemShaderContext &ctx,
+                             const ItemFragmentInput &in,
+                             bool banded)
+  {
+    const uint32_t bit31 = 0x80000000u;
+    const uint32_t bit30 = 0x40000000u;
+    uint32_t raw_location, data_location;
+    bool is_odd_even_fill_rule;
+    vec2 glyph_coord, glyph_coord_dx, glyph_coord_dy;
+    float cvg;
+
+    raw_location = in.m_flats[glyph_data_location_flat];
+    is_odd_even_fill_rule = (raw_location & bit31) != 0u;
+    data_location = raw_location & ~(bit31 | bit30);
+
+    glyph_coord = vec2(in.m_varyings[glyph_coord_x_varying],
+                       in.m_varyings[glyph_coord_y_varying]);
+    glyph_coord_dx = vec2(in.m_varyings_dx[glyph_coord_x_varying],
+                          in.m_varyings_dx[glyph_coord_y_varying]);
+    glyph_coord_dy = vec2(in.m_varyings_dy[glyph_coord_x_varying],
+                          in.m_varyings_dy[glyph_coord_y_varying]);
+
+    if (banded)
+      {
+        vec2 glyph_coord_fwidth;
+
+        glyph_coord_fwidth = vec2(t_abs(glyph_coord_dx.x()) + t_abs(glyph_coord_dy.x()),
+                                  t_abs(glyph_coord_dx.y()) + t_abs(glyph_coord_dy.y()));
+        cvg = banded_rays_compute_coverage(ctx, data_location, glyph_coord, glyph_coord_fwidth,
+                                           in.m_flats[glyph_num_vertical_bands_flat],
+                                           in.m_flats[glyph_num_horizontal_bands_flat],
+                                           is_odd_even_fill_rule);
+      }
+    else
+      {
+        cvg = restricted_rays_compute_coverage(ctx, data_location, glyph_coord,
+                                               glyph_coord_dx, glyph_coord_dy,
+                                               is_odd_even_fill_rule);
+      }
+
+    if ((raw_location & bit30) != 0u)
+      {
+        cvg = 1.0f - cvg;
+      }
+    return cvg;
+  }
+}
+
+unsigned int
+fastuidraw::cpu::detail::
+item_number_varyings(enum shader_type_t tp)
+{
+  switch (tp)
+    {
+    case fill_aa_fuzz_shader:
+    case fill_aa_fuzz_coverage_shader:
+      return number_aa_fuzz_varyings;
+
+    case stroke_non_aa_shader:
+    case stroke_coverage_shader:
+      return number_stroking_varyings;
+
+    case glyph_coverage_shader:
+    case glyph_distance_field_shader:
+    case glyph_multi_channel_distance_field_shader:
+      return number_glyph_texel_varyings;
+
+    case glyph_restricted_rays_shader:
+    case glyph_banded_rays_shader:
+      return number_glyph_rays_varyings;
+
+    default:
+      return 0;
+    }
+}
+
+bool
+fastuidraw::cpu::detail::
+item_uses_deferred_coverage(enum shader_type_t tp)
+{
+  return tp == fill_aa_fuzz_shader || tp == stroke_aa_shader;
+}
+
+bool
+fastuidraw::cpu::detail::
+item_is_coverage_shader(enum shader_type_t tp)
+{
+  return tp == fill_aa_fuzz_coverage_shader || tp == stroke_coverage_shader;
+}
+
+void
+fastuidraw::cpu::detail::
+item_vertex_shader(enum shader_type_t tp,
+                   const ItemShaderContext &ctx,
+                   const ItemVertexInput &in,
+                   ItemVertexOutput *out)
+{
+  switch (tp)
+    {
+    case fill_shader:
+      fill_vertex_shader(ctx, in, out);
+      break;
+
+    case fill_aa_fuzz_shader:
+    case fill_aa_fuzz_coverage_shader:
+      aa_fuzz_vertex_shader(ctx, in, out);
+      break;
+
+    case stroke_non_aa_shader:
+    case stroke_aa_shader:
+    case stroke_coverage_shader:
+      stroke_vertex_shader(ctx, in, out);
+      break;
+
+    case glyph_coverage_shader:
+    case glyph_distance_field_shader:
+    case glyph_multi_channel_distance_field_shader:
+      glyph_texel_vertex_shader(ctx, in, out);
+      break;
+
+    case glyph_restricted_rays_shader:
+      glyph_rays_vertex_shader(ctx, in, GlyphRenderDataRestrictedRays::glyph_coord_value, out);
+      out->m_flats[glyph_data_location_flat] = in.m_attribute->m_attrib1.z();
+      break;
+
+    case glyph_banded_rays_shader:
+      glyph_rays_vertex_shader(ctx, in, GlyphRenderDataBandedRays::glyph_coord_value, out);
+      out->m_flats[glyph_num_vertical_bands_flat] = in.m_attribute->m_attrib1.z();
+      out->m_flats[glyph_num_horizontal_bands_flat] = in.m_attribute->m_attrib1.w();
+      out->m_flats[glyph_data_location_flat] = in.m_attribute->m_attrib2.x();
+      break;
+
+    default:
+      out->m_clip_p = vec3(0.0f, 0.0f, 0.0f);
+      out->m_brush_p = vec2(0.0f, 0.0f);
+      out->m_add_z = 0;
+    }
+}
+
+float
+fastuidraw::cpu::detail::
+item_fragment_shader(enum shader_type_t tp,
+                     const ItemShaderContext &ctx,
+                     const ItemFragmentInput &in)
+{
+  switch (tp)
+    {
+    case fill_shader:
+      return 1.0f;
+
+    case fill_aa_fuzz_shader:
+    case stroke_aa_shader:
+      return in.m_deferred_coverage;
+
+    case fill_aa_fuzz_coverage_shader:
+      return aa_fuzz_coverage_fragment_shader(in);
+
+    case stroke_non_aa_shader:
+      return stroke_fragment_shader(ctx, in, false);
+
+    case stroke_coverage_shader:
+      return stroke_fragment_shader(ctx, in, true);
+
+    case glyph_coverage_shader:
+      return glyph_coverage_fragment_shader(ctx, in);
+
+    case glyph_distance_field_shader:
+      return glyph_distance_field_fragment_shader(ctx, in);
+
+    case glyph_restricted_rays_shader:
+      return glyph_rays_fragment_shader(ctx, in, false);
+
+    case glyph_banded_rays_shader:
+      return glyph_rays_fragment_shader(ctx, in, true);
+
+    case glyph_multi_channel_distance_field_shader:
+      return glyph_multi_channel_distance_field_fragment_shader(ctx, in);
+
+    default:
+      return -1.0f;
+    }
+}
@@ -0,0 +1,133 @@
+/*!
+ * \file item_shaders_cpu.hpp
+ * \brief file item_shaders_cpu.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/matrix.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/painter/attribute_data/painter_attribute.hpp>
+#include <private/cpu_backend/painter_shader_registrar_cpu.hpp>
+
+namespace fastuidraw { namespace cpu { namespace detail {
+
+/* The vertex and fragment stages of the item shaders of the
+ * CPU backend; each is a port of the GLSL shader of the GL
+ * backend with the same shader_type_t. The varyings of an
+ * item shader are smooth floats and the flats are uint
+ * values taken from the provoking vertex.
+ */
+enum
+  {
+    item_max_varyings = 8,
+    item_max_flats = 4
+  };
+
+/* Values constant across all items of a draw */
+class ItemShaderContext
+{
+public:
+  /* the data store of the PainterDraw */
+  c_array<const generic_data> m_store;
+
+  /* the backing store of the GlyphAtlas */
+  c_array<const generic_data> m_glyph_data;
+
+  /* the dimensions of the viewport in pixels, i.e.
+   * the value of fastuidraw_viewport_pixels
+   */
+  vec2 m_viewport_pixels;
+};
+
+class ItemVertexInput
+{
+public:
+  const PainterAttribute *m_attribute;
+  uint32_t m_shader_data_location;
+  uint32_t m_sub_shader;
+  float3x3 m_item_matrix;
+};
+
+class ItemVertexOutput
+{
+public:
+  vec3 m_clip_p;
+  vec2 m_brush_p;
+  int m_add_z;
+  vecN<float, item_max_varyings> m_varyings;
+  vecN<uint32_t, item_max_flats> m_flats;
+};
+
+class ItemFragmentInput
+{
+public:
+  /* values of the varyings and their screen space
+   * derivatives at the fragment
+   */
+  const float *m_varyings;
+  const float *m_varyings_dx;
+  const float *m_varyings_dy;
+  const uint32_t *m_flats;
+
+  uint32_t m_shader_data_location;
+  uint32_t m_sub_shader;
+
+  /* value read from the deferred coverage buffer,
+   * only meaningful if uses_deferred_coverage()
+   * is true for the shader.
+   */
+  float m_deferred_coverage;
+};
+
+/* Returns the number of varyings the named shader uses */
+unsigned int
+item_number_varyings(enum shader_type_t tp);
+
+/* Returns true if the named shader reads from
+ * the deferred coverage buffer
+ */
+bool
+item_uses_deferred_coverage(enum shader_type_t tp);
+
+/* Returns true if the named shader is run on the
+ * coverage buffer instead of the color buffer.
+ */
+bool
+item_is_coverage_shader(enum shader_type_t tp);
+
+/* Execute the vertex stage of the named item shader */
+void
+item_vertex_shader(enum shader_type_t tp,
+                   const ItemShaderContext &ctx,
+                   const ItemVertexInput &in,
+                   ItemVertexOutput *out);
+
+/* Execute the fragment stage of the named item shader;
+ * for shaders drawing to the color buffer, the return
+ * value is the value of each channel of the vec4 that
+ * the GLSL shader returns (which for all item shaders
+ * has all channels the same value) and for coverage
+ * shaders it is the coverage. A negative return value
+ * indicates that the fragment is discarded.
+ */
+float
+item_fragment_shader(enum shader_type_t tp,
+                     const ItemShaderContext &ctx,
+                     const ItemFragmentInput &in);
+
+}}}
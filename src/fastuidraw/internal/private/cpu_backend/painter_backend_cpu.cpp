@@ -0,0 +1,539 @@
+/*!
+ * \file painter_backend_cpu.cpp
+ * \brief file painter_backend_cpu.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <vector>
+#include <fastuidraw/util/trace_events.hpp>
+#include <private/util_private.hpp>
+#include <private/cpu_backend/painter_backend_cpu.hpp>
+
+class fastuidraw::cpu::detail::PainterBackendCPU::ImageBindAction:
+  public PainterDrawBreakAction
+{
+public:
+  ImageBindAction(unsigned int slot,
+                  const reference_counted_ptr<const Image> &im,
+                  PainterBackendCPU *p);
+
+  virtual
+  gpu_dirty_state
+  execute(PainterBackend*) const override final;
+
+private:
+  reference_counted_ptr<TexelStore> m_texels;
+  PainterBackendCPU *m_p;
+};
+
+class fastuidraw::cpu::detail::PainterBackendCPU::CoverageSurfaceBindAction:
+  public PainterDrawBreakAction
+{
+public:
+  CoverageSurfaceBindAction(const reference_counted_ptr<PainterSurface> &surface,
+                            PainterBackendCPU *p);
+
+  virtual
+  gpu_dirty_state
+  execute(PainterBackend*) const override final;
+
+private:
+  reference_counted_ptr<TexelStore> m_texels;
+  PainterBackendCPU *m_p;
+};
+
+class fastuidraw::cpu::detail::PainterBackendCPU::DrawEntry
+{
+public:
+  DrawEntry(const BlendState &blend):
+    m_blend(blend)
+  {}
+
+  DrawEntry(const reference_counted_ptr<const PainterDrawBreakAction> &action):
+    m_action(action)
+  {}
+
+  void
+  add_entry(unsigned int begin, unsigned int end)
+  {
+    m_ranges.push_back(range_type<unsigned int>(begin, end));
+  }
+
+  void
+  draw(PainterBackendCPU *pr, const RasterState &st,
+       c_array<const PainterIndex> indices,
+       BlendState *current_blend) const;
+
+private:
+  BlendState m_blend;
+  reference_counted_ptr<const PainterDrawBreakAction> m_action;
+  std::vector<range_type<unsigned int> > m_ranges;
+};
+
+/* The backing of the attribute, header, index and data
+ * store buffers of a DrawCommand.
+ */
+class fastuidraw::cpu::detail::PainterBackendCPU::DrawBuffers:fastuidraw::noncopyable
+{
+public:
+  explicit
+  DrawBuffers(const PainterEngineCPU::ConfigurationCPU &config):
+    m_attributes(config.attributes_per_buffer()),
+    m_header_attributes(config.attributes_per_buffer()),
+    m_indices(config.indices_per_buffer()),
+    m_store(4u * config.data_blocks_per_store_buffer())
+  {}
+
+  std::vector<PainterAttribute> m_attributes;
+  std::vector<uint32_t> m_header_attributes;
+  std::vector<PainterIndex> m_indices;
+  std::vector<generic_data> m_store;
+};
+
+/* Free list of DrawBuffers; a DrawCommand takes a DrawBuffers
+ * when it is created and returns it when it is destroyed. The
+ * DrawCommand holds a reference to the pool so that the pool
+ * outlives it even if the PainterBackendCPU does not.
+ */
+class fastuidraw::cpu::detail::PainterBackendCPU::DrawBufferPool:
+  public reference_counted<DrawBufferPool>::non_concurrent
+{
+public:
+  explicit
+  DrawBufferPool(const PainterEngineCPU::ConfigurationCPU &config):
+    m_config(config)
+  {}
+
+  ~DrawBufferPool();
+
+  DrawBuffers*
+  acquire(void);
+
+  void
+  release(DrawBuffers *p)
+  {
+    m_free.push_back(p);
+  }
+
+private:
+  PainterEngineCPU::ConfigurationCPU m_config;
+  std::vector<DrawBuffers*> m_free;
+};
+
+class fastuidraw::cpu::detail::PainterBackendCPU::DrawCommand:
+  public PainterDraw
+{
+public:
+  explicit
+  DrawCommand(PainterBackendCPU *pr);
+
+  ~DrawCommand();
+
+  virtual
+  bool
+  draw_break(enum PainterSurface::render_type_t render_type,
+             const PainterShaderGroup &old_shaders,
+             const PainterShaderGroup &new_shaders,
+             unsigned int indices_written) override final;
+
+  virtual
+  bool
+  draw_break(const reference_counted_ptr<const PainterDrawBreakAction> &action,
+             unsigned int indices_written) override final;
+
+  virtual
+  void
+  draw(void) const override final;
+
+protected:
+  virtual
+  void
+  unmap_implement(unsigned int attributes_written,
+                  unsigned int indices_written,
+                  unsigned int data_store_written) override final;
+
+private:
+  void
+  add_entry(unsigned int indices_written);
+
+  PainterBackendCPU *m_pr;
+  reference_counted_ptr<DrawBufferPool> m_pool;
+  DrawBuffers *m_buffers;
+  unsigned int m_attributes_written, m_indices_written;
+  std::vector<DrawEntry> m_draws;
+};
+
+///////////////////////////////////////////////////////////////
+// fastuidraw::cpu::detail::PainterBackendCPU::ImageBindAction methods
+fastuidraw::cpu::detail::PainterBackendCPU::ImageBindAction::
+ImageBindAction(unsigned int slot,
+                const reference_counted_ptr<const Image> &im,
+                PainterBackendCPU *p):
+  m_p(p)
+{
+  const ImageCPU *image_cpu;
+
+  /* on_painter_begin() reports a single external texture */
+  FASTUIDRAWassert(slot == 0u);
+  FASTUIDRAWunused(slot);
+
+  /* an Image not made by the CPU backend cannot be
+   * sampled; in that case the slot is bound to nothing.
+   */
+  image_cpu = dynamic_cast<const ImageCPU*>(im.get());
+  if (image_cpu)
+    {
+      m_texels = image_cpu->texels();
+    }
+}
+
+fastuidraw::gpu_dirty_state
+fastuidraw::cpu::detail::PainterBackendCPU::ImageBindAction::
+execute(PainterBackend*) const
+{
+  m_p->m_external_texture = m_texels;
+  return gpu_dirty_state();
+}
+
+/////////////////////////////////////////////////////////////////////////
+// fastuidraw::cpu::detail::PainterBackendCPU::CoverageSurfaceBindAction methods
+fastuidraw::cpu::detail::PainterBackendCPU::CoverageSurfaceBindAction::
+CoverageSurfaceBindAction(const reference_counted_ptr<PainterSurface> &surface,
+                          PainterBackendCPU *p):
+  m_texels(PainterSurfaceCPUPrivate::surface_cpu(surface)->m_color),
+  m_p(p)
+{
+}
+
+fastuidraw::gpu_dirty_state
+fastuidraw::cpu::detail::PainterBackendCPU::CoverageSurfaceBindAction::
+execute(PainterBackend*) const
+{
+  m_p->m_coverage_surface = m_texels;
+  return gpu_dirty_state();
+}
+
+///////////////////////////////////////////////////////////////
+// fastuidraw::cpu::detail::PainterBackendCPU::DrawEntry methods
+void
+fastuidraw::cpu::detail::PainterBackendCPU::DrawEntry::
+draw(PainterBackendCPU *pr, const RasterState &in_st,
+     c_array<const PainterIndex> indices,
+     BlendState *current_blend) const
+{
+  RasterState st(in_st);
+
+  if (m_action)
+    {
+      m_action->execute(pr);
+    }
+  else
+    {
+      *current_blend = m_blend;
+    }
+
+  /* the bound images are read after the action executes */
+  st.m_brush_ctx.m_external_texture = pr->m_external_texture.get();
+  st.m_coverage_surface = pr->m_coverage_surface.get();
+
+  for (const range_type<unsigned int> &R : m_ranges)
+    {
+      pr->m_rasterizer.rasterize(st, indices.sub_array(R), *current_blend);
+    }
+}
+
+///////////////////////////////////////////////////////////////
+// fastuidraw::cpu::detail::PainterBackendCPU::DrawBufferPool methods
+fastuidraw::cpu::detail::PainterBackendCPU::DrawBufferPool::
+~DrawBufferPool()
+{
+  for (DrawBuffers *p : m_free)
+    {
+      FASTUIDRAWdelete(p);
+    }
+}
+
+fastuidraw::cpu::detail::PainterBackendCPU::DrawBuffers*
+fastuidraw::cpu::detail::PainterBackendCPU::DrawBufferPool::
+acquire(void)
+{
+  DrawBuffers *p;
+
+  if (m_free.empty())
+    {
+      return FASTUIDRAWnew DrawBuffers(m_config);
+    }
+
+  p = m_free.back();
+  m_free.pop_back();
+  return p;
+}
+
+///////////////////////////////////////////////////////////////
+// fastuidraw::cpu::detail::PainterBackendCPU::DrawCommand methods
+fastuidraw::cpu::detail::PainterBackendCPU::DrawCommand::
+DrawCommand(PainterBackendCPU *pr):
+  m_pr(pr),
+  m_pool(pr->m_draw_buffer_pool),
+  m_buffers(m_pool->acquire()),
+  m_attributes_written(0),
+  m_indices_written(0)
+{
+  m_attributes = make_c_array(m_buffers->m_attributes);
+  m_header_attributes = make_c_array(m_buffers->m_header_attributes);
+  m_indices = make_c_array(m_buffers->m_indices);
+  m_store = make_c_array(m_buffers->m_store);
+}
+
+fastuidraw::cpu::detail::PainterBackendCPU::DrawCommand::
+~DrawCommand()
+{
+  m_pool->release(m_buffers);
+}
+
+bool
+fastuidraw::cpu::detail::PainterBackendCPU::DrawCommand::
+draw_break(const reference_counted_ptr<const PainterDrawBreakAction> &action,
+           unsigned int indices_written)
+{
+  bool return_value(false);
+
+  FASTUIDRAWassert(action);
+  if (!m_draws.empty())
+    {
+      return_value = true;
+      add_entry(indices_written);
+    }
+  m_draws.push_back(action);
+  return return_value;
+}
+
+bool
+fastuidraw::cpu::detail::PainterBackendCPU::DrawCommand::
+draw_break(enum PainterSurface::render_type_t,
+           const PainterShaderGroup &old_shaders,
+           const PainterShaderGroup &new_shaders,
+           unsigned int indices_written)
+{
+  /* The CPU backend selects the item shader per triangle,
+   * so only a change in the blend mode or in the W3C blend
+   * mode of a BlendShaderCPU (given by the blend group)
+   * requires a break.
+   */
+  BlendState old_blend, new_blend;
+  bool return_value(false);
+
+  old_blend.m_blend_mode = old_shaders.blend_mode();
+  old_blend.m_w3c_mode = BlendShaderCPU::mode_of_group(old_shaders.blend_group());
+  new_blend.m_blend_mode = new_shaders.blend_mode();
+  new_blend.m_w3c_mode = BlendShaderCPU::mode_of_group(new_shaders.blend_group());
+  if (old_blend.m_blend_mode != new_blend.m_blend_mode
+      || old_blend.m_w3c_mode != new_blend.m_w3c_mode)
+    {
+      if (!m_draws.empty())
+        {
+          add_entry(indices_written);
+          return_value = true;
+        }
+      m_draws.push_back(new_blend);
+      return return_value;
+    }
+  else
+    {
+      add_entry(indices_written);
+      return false;
+    }
+}
+
+void
+fastuidraw::cpu::detail::PainterBackendCPU::DrawCommand::
+draw(void) const
+{
+  TraceEvents::Scope trace("PainterBackendCPU", "draw");
+  RasterState st;
+  BlendState current_blend;
+  c_array<const PainterIndex> indices;
+
+  st.m_surface = m_pr->m_surface;
+  /* PainterDraw resets m_attributes, m_indices, etc. once
+   * unmapped, so read from the backing vectors directly.
+   */
+  st.m_item_ctx.m_store = make_c_array(m_buffers->m_store);
+  st.m_item_ctx.m_glyph_data = m_pr->m_glyph_atlas->data();
+  st.m_item_ctx.m_viewport_pixels = vec2(t_max(1, st.m_surface->m_viewport.m_dimensions.x()),
+                                         t_max(1, st.m_surface->m_viewport.m_dimensions.y()));
+  st.m_brush_ctx.m_image_atlas = m_pr->m_image_atlas.get();
+  st.m_brush_ctx.m_colorstop_atlas = m_pr->m_colorstop_atlas.get();
+  st.m_shaders = (st.m_surface->m_render_type == PainterSurface::color_buffer_type) ?
+    make_c_array(m_pr->m_item_shaders) :
+    make_c_array(m_pr->m_coverage_shaders);
+  st.m_custom_brush_shaders = make_c_array(m_pr->m_custom_brush_shaders);
+
+  m_pr->m_rasterizer.process_vertices(st,
+                                      make_c_array(m_buffers->m_attributes).sub_array(0, m_attributes_written),
+                                      make_c_array(m_buffers->m_header_attributes).sub_array(0, m_attributes_written));
+
+  indices = make_c_array(m_buffers->m_indices).sub_array(0, m_indices_written);
+  for (const DrawEntry &entry : m_draws)
+    {
+      entry.draw(m_pr, st, indices, &current_blend);
+    }
+}
+
+void
+fastuidraw::cpu::detail::PainterBackendCPU::DrawCommand::
+unmap_implement(unsigned int attributes_written,
+                unsigned int indices_written,
+                unsigned int)
+{
+  m_attributes_written = attributes_written;
+  add_entry(indices_written);
+  FASTUIDRAWassert(m_indices_written == indices_written);
+}
+
+void
+fastuidraw::cpu::detail::PainterBackendCPU::DrawCommand::
+add_entry(unsigned int indices_written)
+{
+  if (m_draws.empty())
+    {
+      m_draws.push_back(BlendState());
+    }
+  FASTUIDRAWassert(indices_written >= m_indices_written);
+  if (indices_written > m_indices_written)
+    {
+      m_draws.back().add_entry(m_indices_written, indices_written);
+    }
+  m_indices_written = indices_written;
+}
+
+///////////////////////////////////////////////
+// fastuidraw::cpu::detail::PainterBackendCPU methods
+fastuidraw::cpu::detail::PainterBackendCPU::
+PainterBackendCPU(const PainterEngineCPU *f):
+  m_config(f->configuration_cpu()),
+  m_rasterizer(f->configuration_cpu().number_threads(),
+               f->configuration_cpu().tile_size()),
+  m_surface(nullptr)
+{
+  reference_counted_ptr<PainterShaderRegistrar> reg_base(&f->painter_shader_registrar());
+
+  FASTUIDRAWassert(reg_base.dynamic_cast_ptr<PainterShaderRegistrarCPU>());
+  m_reg = reg_base.static_cast_ptr<PainterShaderRegistrarCPU>();
+
+  FASTUIDRAWassert(dynamic_cast<GlyphAtlasCPU*>(&f->glyph_atlas()));
+  m_glyph_atlas = static_cast<GlyphAtlasCPU*>(&f->glyph_atlas());
+
+  FASTUIDRAWassert(dynamic_cast<ImageAtlasCPU*>(&f->image_atlas()));
+  m_image_atlas = static_cast<ImageAtlasCPU*>(&f->image_atlas());
+
+  FASTUIDRAWassert(dynamic_cast<ColorStopAtlasCPU*>(&f->colorstop_atlas()));
+  m_colorstop_atlas = static_cast<ColorStopAtlasCPU*>(&f->colorstop_atlas());
+
+  m_draw_buffer_pool = FASTUIDRAWnew DrawBufferPool(m_config);
+}
+
+fastuidraw::cpu::detail::PainterBackendCPU::
+~PainterBackendCPU()
+{
+}
+
+unsigned int
+fastuidraw::cpu::detail::PainterBackendCPU::
+attribs_per_mapping(void) const
+{
+  return m_config.attributes_per_buffer();
+}
+
+unsigned int
+fastuidraw::cpu::detail::PainterBackendCPU::
+indices_per_mapping(void) const
+{
+  return m_config.indices_per_buffer();
+}
+
+void
+fastuidraw::cpu::detail::PainterBackendCPU::
+on_pre_draw(const reference_counted_ptr<PainterSurface> &surface,
+            bool clear_color_buffer,
+            bool begin_new_target)
+{
+  TraceEvents::Scope trace("PainterBackendCPU", "on_pre_draw");
+
+  m_surface = PainterSurfaceCPUPrivate::surface_cpu(surface);
+  m_external_texture.clear();
+  m_coverage_surface.clear();
+
+  if (begin_new_target)
+    {
+      m_surface->clear_depth_buffer();
+    }
+
+  if (clear_color_buffer)
+    {
+      m_surface->clear_color_buffer();
+    }
+}
+
+void
+fastuidraw::cpu::detail::PainterBackendCPU::
+on_post_draw(void)
+{
+  TraceEvents::Scope trace("PainterBackendCPU", "on_post_draw");
+
+  /* release the references to the images bound
+   * during the draw.
+   */
+  m_external_texture.clear();
+  m_coverage_surface.clear();
+  m_surface = nullptr;
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::PainterDrawBreakAction>
+fastuidraw::cpu::detail::PainterBackendCPU::
+bind_image(unsigned int slot,
+           const reference_counted_ptr<const Image> &im)
+{
+  return FASTUIDRAWnew ImageBindAction(slot, im, this);
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::PainterDrawBreakAction>
+fastuidraw::cpu::detail::PainterBackendCPU::
+bind_coverage_surface(const reference_counted_ptr<PainterSurface> &surface)
+{
+  return FASTUIDRAWnew CoverageSurfaceBindAction(surface, this);
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::PainterDraw>
+fastuidraw::cpu::detail::PainterBackendCPU::
+map_draw(void)
+{
+  return FASTUIDRAWnew DrawCommand(this);
+}
+
+unsigned int
+fastuidraw::cpu::detail::PainterBackendCPU::
+on_painter_begin(void)
+{
+  /* the shader tables are fetched once per Painter::begin()
+   * so that drawing does not need to lock the registrar.
+   */
+  m_reg->fetch_shader_tables(&m_item_shaders, &m_coverage_shaders, &m_custom_brush_shaders);
+
+  /* only the Image of the fixed function brush or of the
+   * blur brush, which are bound to slot 0, is sampled.
+   */
+  return 1;
+}
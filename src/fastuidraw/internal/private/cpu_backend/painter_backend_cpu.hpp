@@ -0,0 +1,109 @@
+/*!
+ * \file painter_backend_cpu.hpp
+ * \brief file painter_backend_cpu.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include <fastuidraw/painter/backend/painter_backend.hpp>
+#include <fastuidraw/cpu_backend/painter_engine_cpu.hpp>
+#include <fastuidraw/cpu_backend/painter_surface_cpu.hpp>
+
+#include <private/cpu_backend/atlases_cpu.hpp>
+#include <private/cpu_backend/painter_shader_registrar_cpu.hpp>
+#include <private/cpu_backend/painter_surface_cpu_private.hpp>
+#include <private/cpu_backend/rasterizer_cpu.hpp>
+
+namespace fastuidraw { namespace cpu { namespace detail {
+
+class PainterBackendCPU:public PainterBackend
+{
+public:
+  explicit
+  PainterBackendCPU(const PainterEngineCPU *f);
+
+  ~PainterBackendCPU();
+
+  virtual
+  unsigned int
+  attribs_per_mapping(void) const override final;
+
+  virtual
+  unsigned int
+  indices_per_mapping(void) const override final;
+
+  virtual
+  void
+  on_pre_draw(const reference_counted_ptr<PainterSurface> &surface,
+              bool clear_color_buffer, bool begin_new_target) override final;
+
+  virtual
+  void
+  on_post_draw(void) override final;
+
+  virtual
+  reference_counted_ptr<PainterDrawBreakAction>
+  bind_image(unsigned int slot,
+             const reference_counted_ptr<const Image> &im) override final;
+
+  virtual
+  reference_counted_ptr<PainterDrawBreakAction>
+  bind_coverage_surface(const reference_counted_ptr<PainterSurface> &surface) override final;
+
+  virtual
+  reference_counted_ptr<PainterDraw>
+  map_draw(void) override final;
+
+  virtual
+  unsigned int
+  on_painter_begin(void) override final;
+
+private:
+  class ImageBindAction;
+  class CoverageSurfaceBindAction;
+  class DrawEntry;
+  class DrawBuffers;
+  class DrawBufferPool;
+  class DrawCommand;
+
+  PainterEngineCPU::ConfigurationCPU m_config;
+  reference_counted_ptr<PainterShaderRegistrarCPU> m_reg;
+  reference_counted_ptr<GlyphAtlasCPU> m_glyph_atlas;
+  reference_counted_ptr<ImageAtlasCPU> m_image_atlas;
+  reference_counted_ptr<ColorStopAtlasCPU> m_colorstop_atlas;
+
+  std::vector<ShaderEntry> m_item_shaders;
+  std::vector<ShaderEntry> m_coverage_shaders;
+  std::vector<ShaderEntry> m_custom_brush_shaders;
+  Rasterizer m_rasterizer;
+
+  /* the buffers of the DrawCommand objects are recycled,
+   * in the same spirit as painter_vao_pool of the GL backend.
+   */
+  reference_counted_ptr<DrawBufferPool> m_draw_buffer_pool;
+
+  /* current surface and the bound image of the brush, as set
+   * by on_pre_draw() and the draw-break actions; the CPU
+   * backend only samples the Image of the fixed function brush
+   * or of the blur brush, both of which are bound to slot 0.
+   */
+  PainterSurfaceCPUPrivate *m_surface;
+  reference_counted_ptr<TexelStore> m_external_texture;
+  reference_counted_ptr<TexelStore> m_coverage_surface;
+};
+
+}}}
@@ -0,0 +1,182 @@
+/*!
+ * \file painter_shader_registrar_cpu.cpp
+ * \brief file painter_shader_registrar_cpu.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <fastuidraw/util/mutex.hpp>
+#include <private/util_private.hpp>
+#include <private/cpu_backend/painter_shader_registrar_cpu.hpp>
+
+//////////////////////////////////////////////////////////
+// fastuidraw::cpu::detail::PainterShaderRegistrarCPU methods
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+PainterShaderRegistrarCPU(void):
+  m_item_shaders(1),
+  m_coverage_shaders(1),
+  m_custom_brush_shaders(1),
+  m_next_blend_shader_ID(1)
+{
+  /* ID 0 is reserved to mean no shader */
+}
+
+void
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+fetch_shader_tables(std::vector<ShaderEntry> *item_shaders,
+                    std::vector<ShaderEntry> *coverage_shaders,
+                    std::vector<ShaderEntry> *custom_brush_shaders)
+{
+  Mutex::Guard m(mutex());
+  *item_shaders = m_item_shaders;
+  *coverage_shaders = m_coverage_shaders;
+  *custom_brush_shaders = m_custom_brush_shaders;
+}
+
+fastuidraw::PainterShader::Tag
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+add_entries(std::vector<ShaderEntry> &table,
+            enum shader_type_t tp,
+            unsigned int num_sub_shaders)
+{
+  PainterShader::Tag return_value;
+
+  return_value.m_ID = table.size();
+  return_value.m_group = 0;
+  for (unsigned int i = 0; i < num_sub_shaders; ++i)
+    {
+      table.push_back(ShaderEntry(tp, i));
+    }
+  return return_value;
+}
+
+bool
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+blend_type_supported(enum PainterBlendShader::shader_type tp) const
+{
+  /* blending is realized by BlendMode or, for the W3C
+   * modes BlendMode cannot realize, by BlendShaderCPU.
+   */
+  return tp == PainterBlendShader::single_src
+    || tp == PainterBlendShader::framebuffer_fetch;
+}
+
+fastuidraw::PainterShader::Tag
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+absorb_item_shader(const reference_counted_ptr<PainterItemShader> &shader)
+{
+  const ItemShaderCPU *p;
+  enum shader_type_t tp(null_shader);
+
+  p = dynamic_cast<const ItemShaderCPU*>(shader.get());
+  if (p)
+    {
+      tp = p->type();
+    }
+  return add_entries(m_item_shaders, tp, shader->number_sub_shaders());
+}
+
+uint32_t
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+compute_item_sub_shader_group(const reference_counted_ptr<PainterItemShader> &)
+{
+  return 0;
+}
+
+fastuidraw::PainterShader::Tag
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+absorb_item_coverage_shader(const reference_counted_ptr<PainterItemCoverageShader> &shader)
+{
+  const ItemCoverageShaderCPU *p;
+  enum shader_type_t tp(null_shader);
+
+  p = dynamic_cast<const ItemCoverageShaderCPU*>(shader.get());
+  if (p)
+    {
+      tp = p->type();
+    }
+  return add_entries(m_coverage_shaders, tp, shader->number_sub_shaders());
+}
+
+uint32_t
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+compute_item_coverage_sub_shader_group(const reference_counted_ptr<PainterItemCoverageShader> &)
+{
+  return 0;
+}
+
+fastuidraw::PainterShader::Tag
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+absorb_blend_shader(const reference_counted_ptr<PainterBlendShader> &shader)
+{
+  const BlendShaderCPU *p;
+  PainterShader::Tag return_value;
+
+  return_value.m_ID = m_next_blend_shader_ID;
+  return_value.m_group = 0;
+
+  p = dynamic_cast<const BlendShaderCPU*>(shader.get());
+  if (p)
+    {
+      return_value.m_group = BlendShaderCPU::group(p->mode());
+    }
+  else if (shader->type() != PainterBlendShader::single_src)
+    {
+      FASTUIDRAWwarning(!"Framebuffer fetch blend shaders other than those of the CPU backend "
+                        "are not supported; items drawn with one are blended by its BlendMode");
+    }
+  m_next_blend_shader_ID += shader->number_sub_shaders();
+  return return_value;
+}
+
+uint32_t
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+compute_blend_sub_shader_group(const reference_counted_ptr<PainterBlendShader> &shader)
+{
+  return shader->parent()->group();
+}
+
+fastuidraw::PainterShader::Tag
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+absorb_custom_brush_shader(const reference_counted_ptr<PainterCustomBrushShader> &shader)
+{
+  const CustomBrushShaderCPU *p;
+  enum shader_type_t tp(null_shader);
+
+  /* only the custom brush shaders of the PainterShaderSet
+   * of the CPU backend are supported; the ID of any other
+   * is still assigned so that the brush shader value is
+   * not confused with the fixed function brush and the
+   * items drawn with it are skipped by the rasterizer,
+   * which is reported at registration in all builds.
+   */
+  p = dynamic_cast<const CustomBrushShaderCPU*>(shader.get());
+  if (p)
+    {
+      tp = p->type();
+    }
+  else
+    {
+      FASTUIDRAWwarning(!"Custom brush shaders are not supported by the CPU backend; "
+                        "items drawn with one are not drawn");
+    }
+  return add_entries(m_custom_brush_shaders, tp, shader->number_sub_shaders());
+}
+
+uint32_t
+fastuidraw::cpu::detail::PainterShaderRegistrarCPU::
+compute_custom_brush_sub_shader_group(const reference_counted_ptr<PainterCustomBrushShader> &)
+{
+  return 0;
+}
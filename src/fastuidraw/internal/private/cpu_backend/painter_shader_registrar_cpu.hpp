@@ -0,0 +1,253 @@
+/*!
+ * \file painter_shader_registrar_cpu.hpp
+ * \brief file painter_shader_registrar_cpu.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include <fastuidraw/painter/backend/painter_shader_registrar.hpp>
+#include <fastuidraw/painter/shader/painter_item_shader.hpp>
+#include <fastuidraw/painter/shader/painter_item_coverage_shader.hpp>
+#include <fastuidraw/painter/shader/painter_custom_brush_shader.hpp>
+#include <fastuidraw/painter/shader/painter_blend_shader.hpp>
+#include <fastuidraw/painter/painter_enums.hpp>
+
+namespace fastuidraw { namespace cpu { namespace detail {
+
+/* Enumeration of the item and custom brush shaders that
+ * the CPU backend implements; a shader that the CPU backend
+ * does not implement is registered as null_shader and the
+ * items drawn with it are not rasterized.
+ */
+enum shader_type_t
+  {
+    null_shader,
+
+    /* color shaders */
+    fill_shader,
+    fill_aa_fuzz_shader, /* reads the deferred coverage buffer */
+    stroke_non_aa_shader,
+    stroke_aa_shader, /* reads the deferred coverage buffer */
+    glyph_coverage_shader,
+    glyph_distance_field_shader,
+    glyph_restricted_rays_shader,
+    glyph_banded_rays_shader,
+    glyph_multi_channel_distance_field_shader,
+
+    /* coverage shaders */
+    fill_aa_fuzz_coverage_shader,
+    stroke_coverage_shader,
+
+    /* custom brush shaders */
+    blur_brush_shader,
+
+    number_shader_types
+  };
+
+/* An ItemShaderCPU is a PainterItemShader whose vertex and
+ * fragment stages are implemented by the CPU backend; for the
+ * stroking shaders the sub-shader gives the dash cap-style,
+ * as in the GLSL backend: 0 indicates not dashed and otherwise
+ * the value is the cap-style plus one.
+ */
+class ItemShaderCPU:public PainterItemShader
+{
+public:
+  ItemShaderCPU(enum shader_type_t tp, unsigned int num_sub_shaders,
+                const reference_counted_ptr<PainterItemCoverageShader> &cvg =
+                reference_counted_ptr<PainterItemCoverageShader>()):
+    PainterItemShader(num_sub_shaders, cvg),
+    m_type(tp)
+  {}
+
+  enum shader_type_t
+  type(void) const
+  {
+    return m_type;
+  }
+
+private:
+  enum shader_type_t m_type;
+};
+
+/* An ItemCoverageShaderCPU is the PainterItemCoverageShader
+ * analogue of ItemShaderCPU.
+ */
+class ItemCoverageShaderCPU:public PainterItemCoverageShader
+{
+public:
+  ItemCoverageShaderCPU(enum shader_type_t tp, unsigned int num_sub_shaders):
+    PainterItemCoverageShader(num_sub_shaders),
+    m_type(tp)
+  {}
+
+  enum shader_type_t
+  type(void) const
+  {
+    return m_type;
+  }
+
+private:
+  enum shader_type_t m_type;
+};
+
+/* A CustomBrushShaderCPU is the PainterCustomBrushShader
+ * analogue of ItemShaderCPU; the CPU backend only supports
+ * the custom brush shaders of its PainterShaderSet.
+ */
+class CustomBrushShaderCPU:public PainterCustomBrushShader
+{
+public:
+  explicit
+  CustomBrushShaderCPU(enum shader_type_t tp):
+    m_type(tp)
+  {}
+
+  enum shader_type_t
+  type(void) const
+  {
+    return m_type;
+  }
+
+private:
+  enum shader_type_t m_type;
+};
+
+/* A BlendShaderCPU is a framebuffer fetch PainterBlendShader
+ * of the CPU backend that realizes one of the W3C blend modes
+ * a BlendMode cannot realize. PainterShaderRegistrarCPU places
+ * it in the blend group group(mode()) so that changing between
+ * such modes breaks the draw; the blend shaders realized by a
+ * BlendMode alone are in group 0.
+ */
+class BlendShaderCPU:public PainterBlendShader
+{
+public:
+  explicit
+  BlendShaderCPU(enum PainterEnums::blend_mode_t md):
+    PainterBlendShader(PainterBlendShader::framebuffer_fetch),
+    m_mode(md)
+  {}
+
+  enum PainterEnums::blend_mode_t
+  mode(void) const
+  {
+    return m_mode;
+  }
+
+  static
+  uint32_t
+  group(enum PainterEnums::blend_mode_t md)
+  {
+    return uint32_t(md) + 1u;
+  }
+
+  /* returns PainterEnums::number_blend_mode for group 0 */
+  static
+  enum PainterEnums::blend_mode_t
+  mode_of_group(uint32_t g)
+  {
+    return (g == 0u || g > uint32_t(PainterEnums::number_blend_mode)) ?
+      PainterEnums::number_blend_mode :
+      static_cast<enum PainterEnums::blend_mode_t>(g - 1u);
+  }
+
+private:
+  enum PainterEnums::blend_mode_t m_mode;
+};
+
+/* Entry of the table mapping the value of PainterShader::ID()
+ * (as packed in PainterHeader::m_item_shader) to how the CPU
+ * backend processes the item.
+ */
+class ShaderEntry
+{
+public:
+  ShaderEntry(enum shader_type_t tp = null_shader, uint32_t sub_shader = 0u):
+    m_type(tp),
+    m_sub_shader(sub_shader)
+  {}
+
+  enum shader_type_t m_type;
+  uint32_t m_sub_shader;
+};
+
+class PainterShaderRegistrarCPU:public PainterShaderRegistrar
+{
+public:
+  PainterShaderRegistrarCPU(void);
+
+  /* Copy the shader tables for item, coverage and custom
+   * brush shaders; the value at index I is for the shader
+   * whose ID is I.
+   */
+  void
+  fetch_shader_tables(std::vector<ShaderEntry> *item_shaders,
+                      std::vector<ShaderEntry> *coverage_shaders,
+                      std::vector<ShaderEntry> *custom_brush_shaders);
+
+protected:
+  virtual
+  bool
+  blend_type_supported(enum PainterBlendShader::shader_type) const override final;
+
+  virtual
+  PainterShader::Tag
+  absorb_item_shader(const reference_counted_ptr<PainterItemShader> &shader) override final;
+
+  virtual
+  uint32_t
+  compute_item_sub_shader_group(const reference_counted_ptr<PainterItemShader> &shader) override final;
+
+  virtual
+  PainterShader::Tag
+  absorb_item_coverage_shader(const reference_counted_ptr<PainterItemCoverageShader> &shader) override final;
+
+  virtual
+  uint32_t
+  compute_item_coverage_sub_shader_group(const reference_counted_ptr<PainterItemCoverageShader> &shader) override final;
+
+  virtual
+  PainterShader::Tag
+  absorb_blend_shader(const reference_counted_ptr<PainterBlendShader> &shader) override final;
+
+  virtual
+  uint32_t
+  compute_blend_sub_shader_group(const reference_counted_ptr<PainterBlendShader> &shader) override final;
+
+  virtual
+  PainterShader::Tag
+  absorb_custom_brush_shader(const reference_counted_ptr<PainterCustomBrushShader> &shader) override final;
+
+  virtual
+  uint32_t
+  compute_custom_brush_sub_shader_group(const reference_counted_ptr<PainterCustomBrushShader> &shader) override final;
+
+private:
+  static
+  PainterShader::Tag
+  add_entries(std::vector<ShaderEntry> &table,
+              enum shader_type_t tp,
+              unsigned int num_sub_shaders);
+
+  std::vector<ShaderEntry> m_item_shaders;
+  std::vector<ShaderEntry> m_coverage_shaders;
+  std::vector<ShaderEntry> m_custom_brush_shaders;
+  uint32_t m_next_blend_shader_ID;
+};
+
+}}}
@@ -0,0 +1,104 @@
+/*!
+ * \file painter_surface_cpu_private.hpp
+ * \brief file painter_surface_cpu_private.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <fastuidraw/cpu_backend/painter_surface_cpu.hpp>
+#include <private/cpu_backend/image_cpu.hpp>
+
+namespace fastuidraw { namespace cpu { namespace detail {
+
+class PainterSurfaceCPUPrivate:noncopyable
+{
+public:
+  PainterSurfaceCPUPrivate(enum PainterSurface::render_type_t type,
+                           ivec2 dimensions):
+    m_render_type(type),
+    m_viewport(0, 0, t_max(dimensions.x(), 1), t_max(dimensions.y(), 1)),
+    m_clear_color(0.0f, 0.0f, 0.0f, 0.0f),
+    m_dimensions(m_viewport.m_dimensions),
+    m_color(FASTUIDRAWnew TexelStore(m_dimensions)),
+    m_depth(m_dimensions.x() * m_dimensions.y(), 0.0f)
+  {}
+
+  static
+  PainterSurfaceCPUPrivate*
+  surface_cpu(const reference_counted_ptr<PainterSurface> &surface)
+  {
+    FASTUIDRAWassert(surface.dynamic_cast_ptr<PainterSurfaceCPU>());
+    return static_cast<PainterSurfaceCPUPrivate*>(surface.static_cast_ptr<PainterSurfaceCPU>()->opaque_data());
+  }
+
+  /* The returned Image shares the texels of the surface;
+   * it is exposed as Image::premultipied_rgba_format
+   * because the CPU backend emits pre-multiplied RGBA
+   * values, just as the GL backend does.
+   */
+  reference_counted_ptr<const Image>
+  image(ImageAtlas &atlas)
+  {
+    if (!m_image)
+      {
+        m_image = ImageCPU::create(atlas, m_color, Image::premultipied_rgba_format);
+      }
+    return m_image;
+  }
+
+  void
+  clear_color_buffer(void)
+  {
+    u8vec4 v;
+
+    for (unsigned int c = 0; c < 4; ++c)
+      {
+        float f;
+
+        f = t_max(0.0f, t_min(1.0f, m_clear_color[c]));
+        v[c] = static_cast<uint8_t>(255.0f * f + 0.5f);
+      }
+    std::fill(m_color->m_texels.begin(), m_color->m_texels.end(), v);
+  }
+
+  void
+  clear_depth_buffer(void)
+  {
+    std::fill(m_depth.begin(), m_depth.end(), 0.0f);
+  }
+
+  enum PainterSurface::render_type_t m_render_type;
+  PainterSurface::Viewport m_viewport;
+  vec4 m_clear_color;
+  ivec2 m_dimensions;
+
+  /* color buffer; for deferred coverage buffers the
+   * coverage is held in the red channel.
+   */
+  reference_counted_ptr<TexelStore> m_color;
+
+  /* depth buffer; the depth test is GEQUAL and the values
+   * are the raw z-values of the PainterHeader.
+   */
+  std::vector<float> m_depth;
+
+private:
+  reference_counted_ptr<const Image> m_image;
+};
+
+}}}
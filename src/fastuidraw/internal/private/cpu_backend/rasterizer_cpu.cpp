@@ -0,0 +1,1015 @@
+/*!
+ * \file rasterizer_cpu.cpp
+ * \brief file rasterizer_cpu.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <cmath>
+#include <fastuidraw/util/math.hpp>
+#include <fastuidraw/painter/backend/painter_header.hpp>
+#include <fastuidraw/painter/backend/painter_item_matrix.hpp>
+#include <fastuidraw/painter/backend/painter_clip_equations.hpp>
+#include <fastuidraw/painter/backend/painter_brush_adjust.hpp>
+#include <private/cpu_backend/rasterizer_cpu.hpp>
+
+namespace
+{
+  enum
+    {
+      /* number of vertices processed by a single job */
+      vertex_job_size = 1024
+    };
+
+  /* The unpacked values of a PainterHeader together with
+   * the values it references from the data store that are
+   * needed by the vertex stage.
+   */
+  class UnpackedHeader
+  {
+  public:
+    void
+    unpack(const fastuidraw::cpu::detail::RasterState &st, uint32_t location)
+    {
+      using namespace fastuidraw;
+
+      c_array<const generic_data> store(st.m_item_ctx.m_store);
+      unsigned int h(4u * location), m, c;
+
+      m_item_shader_data_location = store[h + PainterHeader::item_shader_data_location_offset].u;
+      m_brush_shader_data_location = store[h + PainterHeader::brush_shader_data_location_offset].u;
+      m_blend_shader_data_location = store[h + PainterHeader::blend_shader_data_location_offset].u;
+      m_item_shader = store[h + PainterHeader::item_shader_offset].u;
+      m_brush_shader = store[h + PainterHeader::brush_shader_offset].u;
+      m_z = store[h + PainterHeader::z_offset].i;
+      m_brush_adjust_location = store[h + PainterHeader::brush_adjust_location_offset].u;
+
+      m_entry = (m_item_shader < st.m_shaders.size()) ?
+        st.m_shaders[m_item_shader] :
+        cpu::detail::ShaderEntry();
+
+      m = 4u * store[h + PainterHeader::item_matrix_location_offset].u;
+      for (unsigned int row = 0; row < 3; ++row)
+        {
+          for (unsigned int col = 0; col < 3; ++col)
+            {
+              m_item_matrix(row, col) = store[m + PainterItemMatrix::matrix_row0_col0_offset + 3 * row + col].f;
+            }
+        }
+      m_normalized_translate.x() = store[m + PainterItemMatrix::normalized_translate_x].f;
+      m_normalized_translate.y() = store[m + PainterItemMatrix::normalized_translate_y].f;
+
+      c = 4u * store[h + PainterHeader::clip_equations_location_offset].u;
+      for (unsigned int i = 0; i < 4; ++i)
+        {
+          m_clip_equations[i].x() = store[c + PainterClipEquations::clip0_coeff_x + 3 * i].f;
+          m_clip_equations[i].y() = store[c + PainterClipEquations::clip0_coeff_y + 3 * i].f;
+          m_clip_equations[i].z() = store[c + PainterClipEquations::clip0_coeff_w + 3 * i].f;
+        }
+
+      if (m_brush_adjust_location != 0u)
+        {
+          unsigned int b(4u * m_brush_adjust_location);
+
+          m_brush_shear.x() = store[b + PainterBrushAdjust::shear_x_offset].f;
+          m_brush_shear.y() = store[b + PainterBrushAdjust::shear_y_offset].f;
+          m_brush_translate.x() = store[b + PainterBrushAdjust::translation_x_offset].f;
+          m_brush_translate.y() = store[b + PainterBrushAdjust::translation_y_offset].f;
+        }
+
+      m_custom_brush = (!fixed_function_brush() && m_brush_shader < st.m_custom_brush_shaders.size()) ?
+        st.m_custom_brush_shaders[m_brush_shader] :
+        cpu::detail::ShaderEntry();
+
+      if (st.m_surface->m_render_type == PainterSurface::color_buffer_type
+          && !drawing_occluder())
+        {
+          if (fixed_function_brush())
+            {
+              m_brush.unpack(st.m_brush_ctx, store, m_brush_shader, m_brush_shader_data_location);
+            }
+          else if (m_custom_brush.m_type == cpu::detail::blur_brush_shader)
+            {
+              m_brush.unpack_blur(st.m_brush_ctx, store, m_brush_shader_data_location);
+            }
+        }
+
+      unpack_deferred_coverage_offset(store[h + PainterHeader::offset_to_deferred_coverage_offset].u);
+    }
+
+    bool
+    drawing_occluder(void) const
+    {
+      return m_blend_shader_data_location == fastuidraw::PainterHeader::drawing_occluder;
+    }
+
+    bool
+    fixed_function_brush(void) const
+    {
+      return (m_brush_shader & fastuidraw::PainterHeader::fixed_function_brush_shader) != 0u;
+    }
+
+    bool
+    brush_supported(void) const
+    {
+      return fixed_function_brush() || m_custom_brush.m_type != fastuidraw::cpu::detail::null_shader;
+    }
+
+    uint32_t m_item_shader_data_location;
+    uint32_t m_brush_shader_data_location;
+    uint32_t m_blend_shader_data_location;
+    uint32_t m_item_shader;
+    uint32_t m_brush_shader;
+    int32_t m_z;
+    uint32_t m_brush_adjust_location;
+    fastuidraw::ivec2 m_deferred_coverage_offset;
+
+    fastuidraw::cpu::detail::ShaderEntry m_entry, m_custom_brush;
+    fastuidraw::float3x3 m_item_matrix;
+    fastuidraw::vec2 m_normalized_translate;
+    fastuidraw::vecN<fastuidraw::vec3, 4> m_clip_equations;
+    fastuidraw::vec2 m_brush_shear, m_brush_translate;
+    fastuidraw::cpu::detail::BrushState m_brush;
+
+  private:
+    void
+    unpack_deferred_coverage_offset(uint32_t packed)
+    {
+      using namespace fastuidraw;
+
+      uint32_t x, y;
+
+      x = unpack_bits(PainterHeader::offset_to_deferred_coverage_x_coord_bit0,
+                      PainterHeader::offset_to_deferred_coverage_coord_num_bits,
+                      packed);
+      y = unpack_bits(PainterHeader::offset_to_deferred_coverage_y_coord_bit0,
+                      PainterHeader::offset_to_deferred_coverage_coord_num_bits,
+                      packed);
+      m_deferred_coverage_offset.x() = int(x) - int(PainterHeader::offset_to_deferred_coverage_bias);
+      m_deferred_coverage_offset.y() = int(y) - int(PainterHeader::offset_to_deferred_coverage_bias);
+    }
+  };
+
+  /* Compute the plane equation, relative to p0, of the values
+   * q0, q1, q2 at p0, p1, p2 where recip_area2 is the reciprocal
+   * of twice the signed area of the triangle.
+   */
+  inline
+  fastuidraw::vec3
+  compute_plane(fastuidraw::vec2 d1, fastuidraw::vec2 d2, float recip_area2,
+                float q0, float q1, float q2)
+  {
+    float dq1(q1 - q0), dq2(q2 - q0);
+
+    return fastuidraw::vec3((dq1 * d2.y() - dq2 * d1.y()) * recip_area2,
+                            (dq2 * d1.x() - dq1 * d2.x()) * recip_area2,
+                            q0);
+  }
+
+  inline
+  float
+  eval_plane(const fastuidraw::vec3 &p, float x, float y)
+  {
+    return p.z() + p.x() * x + p.y() * y;
+  }
+
+  inline
+  int64_t
+  snap_coordinate(float v, int64_t one)
+  {
+    /* clamp to a guard band so that the products of the
+     * edge equations fit in 64-bit integers.
+     */
+    const float guard_band(float(1 << 21));
+
+    v = fastuidraw::t_max(-guard_band, fastuidraw::t_min(guard_band, v));
+    return static_cast<int64_t>(std::floor(v * float(one) + 0.5f));
+  }
+
+  inline
+  float
+  blend_factor(enum fastuidraw::BlendMode::func_t f, unsigned int channel,
+               const fastuidraw::vec4 &src, const fastuidraw::vec4 &dst)
+  {
+    using namespace fastuidraw;
+    switch (f)
+      {
+      case BlendMode::ZERO:
+        return 0.0f;
+      case BlendMode::ONE:
+        return 1.0f;
+      case BlendMode::SRC_COLOR:
+        return src[channel];
+      case BlendMode::ONE_MINUS_SRC_COLOR:
+        return 1.0f - src[channel];
+      case BlendMode::DST_COLOR:
+        return dst[channel];
+      case BlendMode::ONE_MINUS_DST_COLOR:
+        return 1.0f - dst[channel];
+      case BlendMode::SRC_ALPHA:
+        return src.w();
+      case BlendMode::ONE_MINUS_SRC_ALPHA:
+        return 1.0f - src.w();
+      case BlendMode::DST_ALPHA:
+        return dst.w();
+      case BlendMode::ONE_MINUS_DST_ALPHA:
+        return 1.0f - dst.w();
+      case BlendMode::SRC_ALPHA_SATURATE:
+        return (channel == 3) ? 1.0f : t_min(src.w(), 1.0f - dst.w());
+      default:
+        /* constant colors and dual-source blending are
+         * not used by the blend shaders of the CPU backend.
+         */
+        return 0.0f;
+      }
+  }
+
+  inline
+  float
+  blend_equation(enum fastuidraw::BlendMode::equation_t eq,
+                 float src, float src_factor,
+                 float dst, float dst_factor)
+  {
+    using namespace fastuidraw;
+    switch (eq)
+      {
+      case BlendMode::SUBTRACT:
+        return src * src_factor - dst * dst_factor;
+      case BlendMode::REVERSE_SUBTRACT:
+        return dst * dst_factor - src * src_factor;
+      case BlendMode::MIN:
+        return t_min(src, dst);
+      case BlendMode::MAX:
+        return t_max(src, dst);
+      default:
+        return src * src_factor + dst * dst_factor;
+      }
+  }
+
+  /* The W3C blend modes, see https://www.w3.org/TR/compositing-1/;
+   * the formulas are those of the framebuffer fetch blend shaders
+   * of the GLSL backend. The blend functions take the colors S of
+   * the source and D of the destination without pre-multiplied
+   * alpha.
+   */
+  inline
+  float
+  w3c_hardlight(float S, float D)
+  {
+    return (S <= 0.5f) ?
+      2.0f * S * D :
+      1.0f - 2.0f * (1.0f - S) * (1.0f - D);
+  }
+
+  inline
+  float
+  w3c_softlight(float S, float D)
+  {
+    float DD;
+
+    if (S <= 0.5f)
+      {
+        return D - (1.0f - 2.0f * S) * D * (1.0f - D);
+      }
+
+    DD = (D <= 0.25f) ?
+      ((16.0f * D - 12.0f) * D + 4.0f) * D :
+      std::sqrt(D);
+
+    return D + (2.0f * S - 1.0f) * (DD - D);
+  }
+
+  inline
+  float
+  w3c_separable(enum fastuidraw::PainterEnums::blend_mode_t md, float S, float D)
+  {
+    using namespace fastuidraw;
+    switch (md)
+      {
+      case PainterEnums::blend_w3c_multiply:
+        return S * D;
+      case PainterEnums::blend_w3c_screen:
+        return S + D - S * D;
+      case PainterEnums::blend_w3c_overlay:
+        return w3c_hardlight(D, S);
+      case PainterEnums::blend_w3c_darken:
+        return t_min(S, D);
+      case PainterEnums::blend_w3c_lighten:
+        return t_max(S, D);
+      case PainterEnums::blend_w3c_color_dodge:
+        if (D <= 0.0f)
+          {
+            return 0.0f;
+          }
+        return (S >= 1.0f) ? 1.0f : t_min(1.0f, D / (1.0f - S));
+      case PainterEnums::blend_w3c_color_burn:
+        if (D >= 1.0f)
+          {
+            return 1.0f;
+          }
+        return (S <= 0.0f) ? 0.0f : 1.0f - t_min(1.0f, (1.0f - D) / S);
+      case PainterEnums::blend_w3c_hardlight:
+        return w3c_hardlight(S, D);
+      case PainterEnums::blend_w3c_softlight:
+        return w3c_softlight(S, D);
+      case PainterEnums::blend_w3c_difference:
+        return t_abs(S - D);
+      case PainterEnums::blend_w3c_exclusion:
+        return S + D - 2.0f * S * D;
+      default:
+        FASTUIDRAWassert(!"Not a separable W3C blend mode");
+        return S;
+      }
+  }
+
+  inline
+  float
+  w3c_luminosity(const fastuidraw::vec3 &C)
+  {
+    return 0.3f * C.x() + 0.59f * C.y() + 0.11f * C.z();
+  }
+
+  inline
+  fastuidraw::vec3
+  w3c_set_luminosity(const fastuidraw::vec3 &C, float L)
+  {
+    using namespace fastuidraw;
+
+    vec3 R;
+    float d, l, n, x;
+
+    d = L - w3c_luminosity(C);
+    R = C + vec3(d, d, d);
+
+    /* ClipColor */
+    l = w3c_luminosity(R);
+    n = t_min(R.x(), t_min(R.y(), R.z()));
+    x = t_max(R.x(), t_max(R.y(), R.z()));
+    for (unsigned int c = 0; c < 3; ++c)
+      {
+        if (n < 0.0f && l - n > 0.0f)
+          {
+            R[c] = l + (R[c] - l) * l / (l - n);
+          }
+        if (x > 1.0f && x - l > 0.0f)
+          {
+            R[c] = l + (R[c] - l) * (1.0f - l) / (x - l);
+          }
+      }
+    return R;
+  }
+
+  inline
+  float
+  w3c_saturation(const fastuidraw::vec3 &C)
+  {
+    using namespace fastuidraw;
+    return t_max(C.x(), t_max(C.y(), C.z())) - t_min(C.x(), t_min(C.y(), C.z()));
+  }
+
+  inline
+  fastuidraw::vec3
+  w3c_set_saturation(const fastuidraw::vec3 &C, float s)
+  {
+    using namespace fastuidraw;
+
+    float mn, mx;
+    vec3 R;
+
+    mn = t_min(C.x(), t_min(C.y(), C.z()));
+    mx = t_max(C.x(), t_max(C.y(), C.z()));
+    for (unsigned int c = 0; c < 3; ++c)
+      {
+        R[c] = (mx > mn) ? (C[c] - mn) * s / (mx - mn) : 0.0f;
+      }
+    return R;
+  }
+
+  fastuidraw::vec4
+  w3c_blend(enum fastuidraw::PainterEnums::blend_mode_t md,
+            const fastuidraw::vec4 &src, const fastuidraw::vec4 &dst)
+  {
+    using namespace fastuidraw;
+
+    vec3 S, D, B;
+    vec4 r;
+
+    /* undo the pre-multiplied alpha */
+    for (unsigned int c = 0; c < 3; ++c)
+      {
+        S[c] = (src.w() > 0.0f) ? src[c] / src.w() : 0.0f;
+        D[c] = (dst.w() > 0.0f) ? dst[c] / dst.w() : 0.0f;
+      }
+
+    switch (md)
+      {
+      case PainterEnums::blend_w3c_hue:
+        B = w3c_set_luminosity(w3c_set_saturation(S, w3c_saturation(D)), w3c_luminosity(D));
+        break;
+      case PainterEnums::blend_w3c_saturation:
+        B = w3c_set_luminosity(w3c_set_saturation(D, w3c_saturation(S)), w3c_luminosity(D));
+        break;
+      case PainterEnums::blend_w3c_color:
+        B = w3c_set_luminosity(S, w3c_luminosity(D));
+        break;
+      case PainterEnums::blend_w3c_luminosity:
+        B = w3c_set_luminosity(D, w3c_luminosity(S));
+        break;
+      default:
+        for (unsigned int c = 0; c < 3; ++c)
+          {
+            B[c] = w3c_separable(md, S[c], D[c]);
+          }
+      }
+
+    for (unsigned int c = 0; c < 3; ++c)
+      {
+        r[c] = src.w() * dst.w() * B[c]
+          + src[c] * (1.0f - dst.w())
+          + dst[c] * (1.0f - src.w());
+      }
+    r.w() = src.w() + dst.w() * (1.0f - src.w());
+    return r;
+  }
+
+  inline
+  fastuidraw::u8vec4
+  blend(const fastuidraw::cpu::detail::BlendState &blend_state,
+        fastuidraw::vec4 src, fastuidraw::u8vec4 dst_u8)
+  {
+    using namespace fastuidraw;
+
+    const BlendMode &mode(blend_state.m_blend_mode);
+    vec4 dst, r;
+    u8vec4 return_value;
+
+    for (unsigned int c = 0; c < 4; ++c)
+      {
+        src[c] = t_max(0.0f, t_min(1.0f, src[c]));
+        dst[c] = float(dst_u8[c]) * (1.0f / 255.0f);
+      }
+
+    if (blend_state.m_w3c_mode != PainterEnums::number_blend_mode)
+      {
+        r = w3c_blend(blend_state.m_w3c_mode, src, dst);
+      }
+    else if (!mode.blending_on())
+      {
+        r = src;
+      }
+    else
+      {
+        for (unsigned int c = 0; c < 3; ++c)
+          {
+            r[c] = blend_equation(mode.equation_rgb(),
+                                  src[c], blend_factor(mode.func_src_rgb(), c, src, dst),
+                                  dst[c], blend_factor(mode.func_dst_rgb(), c, src, dst));
+          }
+        r[3] = blend_equation(mode.equation_alpha(),
+                              src[3], blend_factor(mode.func_src_alpha(), 3, src, dst),
+                              dst[3], blend_factor(mode.func_dst_alpha(), 3, src, dst));
+      }
+
+    for (unsigned int c = 0; c < 4; ++c)
+      {
+        float f;
+
+        f = t_max(0.0f, t_min(1.0f, r[c]));
+        return_value[c] = static_cast<uint8_t>(255.0f * f + 0.5f);
+      }
+    return return_value;
+  }
+}
+
+//////////////////////////////////////////////
+// fastuidraw::cpu::detail::Rasterizer methods
+fastuidraw::cpu::detail::Rasterizer::
+Rasterizer(unsigned int number_threads, unsigned int tile_size):
+  m_pool(number_threads),
+  m_tile_size(t_max(8u, tile_size)),
+  m_number_tiles(0, 0)
+{
+}
+
+fastuidraw::cpu::detail::Rasterizer::
+~Rasterizer()
+{
+}
+
+void
+fastuidraw::cpu::detail::Rasterizer::
+process_vertices(const RasterState &st,
+                 c_array<const PainterAttribute> attributes,
+                 c_array<const uint32_t> header_attributes)
+{
+  unsigned int num_jobs;
+
+  FASTUIDRAWassert(attributes.size() == header_attributes.size());
+  m_vertices.resize(attributes.size());
+  num_jobs = (attributes.size() + vertex_job_size - 1u) / vertex_job_size;
+  m_pool.run(num_jobs,
+             [&](unsigned int job, unsigned int)
+             {
+               unsigned int begin, end;
+
+               begin = job * vertex_job_size;
+               end = t_min(begin + vertex_job_size, static_cast<unsigned int>(attributes.size()));
+               process_vertex_range(st, attributes, header_attributes, begin, end);
+             });
+}
+
+void
+fastuidraw::cpu::detail::Rasterizer::
+process_vertex_range(const RasterState &st,
+                     c_array<const PainterAttribute> attributes,
+                     c_array<const uint32_t> header_attributes,
+                     unsigned int begin, unsigned int end)
+{
+  const PainterSurface::Viewport &vwp(st.m_surface->m_viewport);
+  bool is_color(st.m_surface->m_render_type == PainterSurface::color_buffer_type);
+  UnpackedHeader header;
+  uint32_t current_header(~0u);
+
+  for (unsigned int v = begin; v < end; ++v)
+    {
+      Vertex &dst(m_vertices[v]);
+      ItemVertexInput in;
+      ItemVertexOutput out;
+      unsigned int num_varyings;
+      vec3 clip_p;
+      vec2 brush_p;
+
+      dst.m_header_location = header_attributes[v];
+      if (dst.m_header_location != current_header)
+        {
+          /* the vertices of an item are consecutive and
+           * share their header, so the header is unpacked
+           * only when it changes.
+           */
+          current_header = dst.m_header_location;
+          header.unpack(st, current_header);
+        }
+
+      if (header.m_entry.m_type == null_shader
+          || (is_color && !header.drawing_occluder() && !header.brush_supported()))
+        {
+          /* the shader or the custom brush shader is not
+           * supported by the CPU backend.
+           */
+          dst.m_valid = false;
+          continue;
+        }
+
+      in.m_attribute = &attributes[v];
+      in.m_shader_data_location = header.m_item_shader_data_location;
+      in.m_sub_shader = header.m_entry.m_sub_shader;
+      in.m_item_matrix = header.m_item_matrix;
+
+      out.m_add_z = 0;
+      out.m_varyings = vecN<float, item_max_varyings>(0.0f);
+      out.m_flats = vecN<uint32_t, item_max_flats>(0u);
+      item_vertex_shader(header.m_entry.m_type, st.m_item_ctx, in, &out);
+
+      clip_p = out.m_clip_p;
+      brush_p = out.m_brush_p;
+      if (is_color)
+        {
+          if (header.m_brush_adjust_location != 0u)
+            {
+              brush_p = header.m_brush_shear * brush_p + header.m_brush_translate;
+            }
+
+          if (header.drawing_occluder())
+            {
+              out.m_add_z = 0;
+            }
+          else
+            {
+              brush_p = header.m_brush.apply_transformation(brush_p);
+            }
+          dst.m_depth = float(out.m_add_z + header.m_z);
+        }
+      else
+        {
+          dst.m_depth = 0.0f;
+        }
+
+      for (unsigned int i = 0; i < 4; ++i)
+        {
+          dst.m_interpolates[clip_distance_interpolate + i] = dot(header.m_clip_equations[i], clip_p);
+        }
+      dst.m_interpolates[brush_interpolate + 0] = brush_p.x();
+      dst.m_interpolates[brush_interpolate + 1] = brush_p.y();
+
+      num_varyings = item_number_varyings(header.m_entry.m_type);
+      for (unsigned int i = 0; i < num_varyings; ++i)
+        {
+          dst.m_interpolates[varying_interpolate + i] = out.m_varyings[i];
+        }
+      dst.m_flats = out.m_flats;
+
+      clip_p.x() += header.m_normalized_translate.x() * clip_p.z();
+      clip_p.y() += header.m_normalized_translate.y() * clip_p.z();
+
+      /* Triangles that cross the plane w = 0 are not clipped
+       * by the CPU backend but are instead dropped; the painter
+       * only produces such triangles for items drawn with a
+       * projection behind the eye.
+       */
+      dst.m_valid = (clip_p.z() > 0.0f);
+      if (!dst.m_valid)
+        {
+          continue;
+        }
+
+      dst.m_recip_w = 1.0f / clip_p.z();
+      dst.m_window.x() = float(vwp.m_origin.x())
+        + (0.5f * clip_p.x() * dst.m_recip_w + 0.5f) * float(vwp.m_dimensions.x());
+      dst.m_window.y() = float(vwp.m_origin.y())
+        + (0.5f * clip_p.y() * dst.m_recip_w + 0.5f) * float(vwp.m_dimensions.y());
+
+      for (unsigned int i = 0, endi = varying_interpolate + num_varyings; i < endi; ++i)
+        {
+          dst.m_interpolates[i] *= dst.m_recip_w;
+        }
+    }
+}
+
+bool
+fastuidraw::cpu::detail::Rasterizer::
+setup_triangle(const Vertex &v0, const Vertex &v1, const Vertex &v2,
+               ivec2 min_pixel, ivec2 max_pixel,
+               unsigned int number_interpolates,
+               Triangle *out_triangle)
+{
+  const int64_t one(1 << subpixel_bits), half(one / 2);
+  vecN<const Vertex*, 3> v(&v0, &v1, &v2);
+  vecN<int64_t, 3> sx, sy;
+  int64_t area, min_x, max_x, min_y, max_y;
+  vecN<vec2, 3> p;
+  vec2 d1, d2;
+  float recip_area2;
+
+  for (unsigned int i = 0; i < 3; ++i)
+    {
+      sx[i] = snap_coordinate(v[i]->m_window.x(), one);
+      sy[i] = snap_coordinate(v[i]->m_window.y(), one);
+    }
+
+  area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+  if (area == 0)
+    {
+      return false;
+    }
+
+  if (area < 0)
+    {
+      /* both windings are drawn; make the winding
+       * counter-clockwise so that the edge equations
+       * are positive inside the triangle.
+       */
+      std::swap(v[0], v[1]);
+      std::swap(sx[0], sx[1]);
+      std::swap(sy[0], sy[1]);
+      area = -area;
+    }
+
+  /* pixel bounding box, the sample of pixel (x, y) is at
+   * (x + 0.5, y + 0.5).
+   */
+  min_x = t_min(sx[0], t_min(sx[1], sx[2]));
+  max_x = t_max(sx[0], t_max(sx[1], sx[2]));
+  min_y = t_min(sy[0], t_min(sy[1], sy[2]));
+  max_y = t_max(sy[0], t_max(sy[1], sy[2]));
+
+  out_triangle->m_min_pixel.x() = t_max(min_pixel.x(), int((min_x - half) >> subpixel_bits));
+  out_triangle->m_min_pixel.y() = t_max(min_pixel.y(), int((min_y - half) >> subpixel_bits));
+  out_triangle->m_max_pixel.x() = t_min(max_pixel.x(), int(((max_x - half) >> subpixel_bits) + 1));
+  out_triangle->m_max_pixel.y() = t_min(max_pixel.y(), int(((max_y - half) >> subpixel_bits) + 1));
+  if (out_triangle->m_min_pixel.x() >= out_triangle->m_max_pixel.x()
+      || out_triangle->m_min_pixel.y() >= out_triangle->m_max_pixel.y())
+    {
+      return false;
+    }
+
+  for (unsigned int k = 0; k < 3; ++k)
+    {
+      unsigned int i(k), j((k + 1) % 3);
+      int64_t dx, dy;
+      bool top_left;
+
+      dx = sx[j] - sx[i];
+      dy = sy[j] - sy[i];
+
+      /* E(x, y) = dx * (y - sy[i]) - dy * (x - sx[i]) */
+      out_triangle->m_edge_a[k] = -dy;
+      out_triangle->m_edge_b[k] = dx;
+      out_triangle->m_edge_c[k] = dy * sx[i] - dx * sy[i];
+
+      /* an edge shared by two triangles is traversed in
+       * opposite directions by each, so exactly one of
+       * them includes the samples on the edge.
+       */
+      top_left = (dy < 0 || (dy == 0 && dx > 0));
+      out_triangle->m_edge_bias[k] = (top_left) ? 0 : -1;
+    }
+
+  /* plane equations are computed from the snapped positions */
+  for (unsigned int i = 0; i < 3; ++i)
+    {
+      p[i] = vec2(float(sx[i]), float(sy[i])) / float(one);
+    }
+  d1 = p[1] - p[0];
+  d2 = p[2] - p[0];
+  recip_area2 = float(one) * float(one) / float(area);
+
+  out_triangle->m_origin = p[0];
+  out_triangle->m_depth_plane = compute_plane(d1, d2, recip_area2,
+                                              v[0]->m_depth, v[1]->m_depth, v[2]->m_depth);
+  out_triangle->m_recip_w_plane = compute_plane(d1, d2, recip_area2,
+                                                v[0]->m_recip_w, v[1]->m_recip_w, v[2]->m_recip_w);
+  out_triangle->m_number_interpolates = number_interpolates;
+  for (unsigned int i = 0; i < number_interpolates; ++i)
+    {
+      out_triangle->m_planes[i] = compute_plane(d1, d2, recip_area2,
+                                                v[0]->m_interpolates[i],
+                                                v[1]->m_interpolates[i],
+                                                v[2]->m_interpolates[i]);
+    }
+
+  /* GL's provoking vertex is the last vertex */
+  out_triangle->m_flats = v2.m_flats;
+
+  return true;
+}
+
+void
+fastuidraw::cpu::detail::Rasterizer::
+rasterize(const RasterState &st,
+          c_array<const PainterIndex> indices,
+          const BlendState &blend)
+{
+  ivec2 min_pixel, max_pixel, dims;
+  const PainterSurface::Viewport &vwp(st.m_surface->m_viewport);
+  bool is_color(st.m_surface->m_render_type == PainterSurface::color_buffer_type);
+  uint32_t current_header(~0u);
+  UnpackedHeader header;
+  int brush(-1);
+
+  if (indices.empty())
+    {
+      return;
+    }
+
+  /* rasterization is restricted to the intersection of
+   * the viewport with the surface, i.e. what the GL backend
+   * realizes with the scissor test.
+   */
+  dims = st.m_surface->m_dimensions;
+  min_pixel.x() = t_max(0, vwp.m_origin.x());
+  min_pixel.y() = t_max(0, vwp.m_origin.y());
+  max_pixel.x() = t_min(dims.x(), vwp.m_origin.x() + vwp.m_dimensions.x());
+  max_pixel.y() = t_min(dims.y(), vwp.m_origin.y() + vwp.m_dimensions.y());
+  if (min_pixel.x() >= max_pixel.x() || min_pixel.y() >= max_pixel.y())
+    {
+      return;
+    }
+
+  m_number_tiles.x() = (dims.x() + m_tile_size - 1) / m_tile_size;
+  m_number_tiles.y() = (dims.y() + m_tile_size - 1) / m_tile_size;
+  m_bins.resize(m_number_tiles.x() * m_number_tiles.y());
+  m_triangles.clear();
+  m_brushes.clear();
+  m_active_tiles.clear();
+
+  /* setup and binning are done serially and in order so
+   * that the triangles of each bin are in draw order.
+   */
+  m_triangles.reserve(indices.size() / 3);
+  for (unsigned int i = 0; i + 2 < indices.size(); i += 3)
+    {
+      const Vertex &v0(m_vertices[indices[i]]);
+      const Vertex &v1(m_vertices[indices[i + 1]]);
+      const Vertex &v2(m_vertices[indices[i + 2]]);
+      ivec2 tile_min, tile_max;
+      unsigned int tri_index;
+
+      if (!v0.m_valid || !v1.m_valid || !v2.m_valid)
+        {
+          continue;
+        }
+
+      if (v2.m_header_location != current_header)
+        {
+          current_header = v2.m_header_location;
+          header.unpack(st, current_header);
+          if (is_color && !header.drawing_occluder())
+            {
+              brush = m_brushes.size();
+              m_brushes.push_back(header.m_brush);
+            }
+          else
+            {
+              brush = -1;
+            }
+        }
+
+      m_triangles.push_back(Triangle());
+      Triangle &T(m_triangles.back());
+      if (!setup_triangle(v0, v1, v2, min_pixel, max_pixel,
+                          varying_interpolate + item_number_varyings(header.m_entry.m_type),
+                          &T))
+        {
+          m_triangles.pop_back();
+          continue;
+        }
+
+      T.m_shader = header.m_entry.m_type;
+      T.m_sub_shader = header.m_entry.m_sub_shader;
+      T.m_item_shader_data_location = header.m_item_shader_data_location;
+      T.m_deferred_coverage_offset = header.m_deferred_coverage_offset;
+      T.m_brush = brush;
+
+      tri_index = m_triangles.size() - 1u;
+      tile_min = T.m_min_pixel / m_tile_size;
+      tile_max = (T.m_max_pixel - ivec2(1, 1)) / m_tile_size;
+      for (int ty = tile_min.y(); ty <= tile_max.y(); ++ty)
+        {
+          for (int tx = tile_min.x(); tx <= tile_max.x(); ++tx)
+            {
+              unsigned int tile(tx + ty * m_number_tiles.x());
+
+              if (m_bins[tile].empty())
+                {
+                  m_active_tiles.push_back(tile);
+                }
+              m_bins[tile].push_back(tri_index);
+            }
+        }
+    }
+
+  m_pool.run(m_active_tiles.size(),
+             [&](unsigned int job, unsigned int)
+             {
+               rasterize_tile(st, blend, m_active_tiles[job]);
+             });
+
+  for (unsigned int tile : m_active_tiles)
+    {
+      m_bins[tile].clear();
+    }
+}
+
+void
+fastuidraw::cpu::detail::Rasterizer::
+rasterize_tile(const RasterState &st, const BlendState &blend,
+               unsigned int tile) const
+{
+  ivec2 tile_xy(tile % m_number_tiles.x(), tile / m_number_tiles.x());
+  ivec2 tile_min(tile_xy * m_tile_size);
+  ivec2 tile_max(tile_min + ivec2(m_tile_size, m_tile_size));
+
+  for (unsigned int tri : m_bins[tile])
+    {
+      const Triangle &T(m_triangles[tri]);
+      ivec2 min_pixel, max_pixel;
+
+      min_pixel.x() = t_max(tile_min.x(), T.m_min_pixel.x());
+      min_pixel.y() = t_max(tile_min.y(), T.m_min_pixel.y());
+      max_pixel.x() = t_min(tile_max.x(), T.m_max_pixel.x());
+      max_pixel.y() = t_min(tile_max.y(), T.m_max_pixel.y());
+      if (min_pixel.x() < max_pixel.x() && min_pixel.y() < max_pixel.y())
+        {
+          rasterize_triangle(st, blend, T, min_pixel, max_pixel);
+        }
+    }
+}
+
+void
+fastuidraw::cpu::detail::Rasterizer::
+rasterize_triangle(const RasterState &st, const BlendState &blend_state,
+                   const Triangle &T, ivec2 min_pixel, ivec2 max_pixel) const
+{
+  const int64_t one(1 << subpixel_bits), half(one / 2);
+  vecN<float, max_interpolates> values, values_dx, values_dy;
+  std::vector<u8vec4> &color(st.m_surface->m_color->m_texels);
+  std::vector<float> &depth(st.m_surface->m_depth);
+  int width(st.m_surface->m_dimensions.x());
+  bool uses_coverage(item_uses_deferred_coverage(T.m_shader) && st.m_coverage_surface);
+  bool is_color(st.m_surface->m_render_type == PainterSurface::color_buffer_type);
+  const BrushState *brush((T.m_brush >= 0) ? &m_brushes[T.m_brush] : nullptr);
+  ItemFragmentInput in;
+
+  in.m_varyings = &values[varying_interpolate];
+  in.m_varyings_dx = &values_dx[varying_interpolate];
+  in.m_varyings_dy = &values_dy[varying_interpolate];
+  in.m_flats = T.m_flats.c_ptr();
+  in.m_shader_data_location = T.m_item_shader_data_location;
+  in.m_sub_shader = T.m_sub_shader;
+  in.m_deferred_coverage = 1.0f;
+
+  for (int y = min_pixel.y(); y < max_pixel.y(); ++y)
+    {
+      int64_t sample_y(y * one + half), sample_x(min_pixel.x() * one + half);
+      vecN<int64_t, 3> E;
+
+      for (unsigned int k = 0; k < 3; ++k)
+        {
+          E[k] = T.m_edge_a[k] * sample_x + T.m_edge_b[k] * sample_y
+            + T.m_edge_c[k] + T.m_edge_bias[k];
+        }
+
+      for (int x = min_pixel.x(); x < max_pixel.x(); ++x,
+             E[0] += T.m_edge_a[0] * one,
+             E[1] += T.m_edge_a[1] * one,
+             E[2] += T.m_edge_a[2] * one)
+        {
+          unsigned int idx(x + y * width);
+          float px, py, z, w, recip_w, item_value;
+          bool clipped(false);
+          vec4 src;
+
+          if ((E[0] | E[1] | E[2]) < 0)
+            {
+              continue;
+            }
+
+          px = float(x) + 0.5f - T.m_origin.x();
+          py = float(y) + 0.5f - T.m_origin.y();
+
+          /* the depth test is GEQUAL */
+          z = eval_plane(T.m_depth_plane, px, py);
+          if (z < depth[idx])
+            {
+              continue;
+            }
+
+          w = eval_plane(T.m_recip_w_plane, px, py);
+          recip_w = 1.0f / w;
+
+          /* perspective correct interpolation of f = N / W where
+           * N and W are affine in screen space; the derivative
+           * of f is then (dN - f * dW) / W.
+           */
+          for (unsigned int i = 0; i < T.m_number_interpolates; ++i)
+            {
+              float f;
+
+              f = eval_plane(T.m_planes[i], px, py) * recip_w;
+              values[i] = f;
+              values_dx[i] = (T.m_planes[i].x() - f * T.m_recip_w_plane.x()) * recip_w;
+              values_dy[i] = (T.m_planes[i].y() - f * T.m_recip_w_plane.y()) * recip_w;
+            }
+
+          for (unsigned int i = 0; i < 4; ++i)
+            {
+              clipped = clipped || (values[clip_distance_interpolate + i] < 0.0f);
+            }
+          if (clipped)
+            {
+              continue;
+            }
+
+          if (uses_coverage)
+            {
+              in.m_deferred_coverage = float(st.m_coverage_surface->fetch(x + T.m_deferred_coverage_offset.x(),
+                                                                          y + T.m_deferred_coverage_offset.y()).x()) / 255.0f;
+            }
+
+          item_value = item_fragment_shader(T.m_shader, st.m_item_ctx, in);
+          if (item_value < 0.0f)
+            {
+              continue;
+            }
+
+          if (brush)
+            {
+              vec2 brush_p(values[brush_interpolate], values[brush_interpolate + 1]);
+              src = item_value * brush->compute_color(st.m_brush_ctx, brush_p);
+            }
+          else if (is_color)
+            {
+              /* occluders only affect the depth buffer */
+              src = vec4(0.0f, 0.0f, 0.0f, 0.0f);
+            }
+          else
+            {
+              src = vec4(item_value, item_value, item_value, item_value);
+            }
+
+          depth[idx] = z;
+          color[idx] = blend(blend_state, src, color[idx]);
+        }
+    }
+}
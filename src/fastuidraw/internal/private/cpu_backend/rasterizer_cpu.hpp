@@ -0,0 +1,230 @@
+/*!
+ * \file rasterizer_cpu.hpp
+ * \brief file rasterizer_cpu.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/blend_mode.hpp>
+#include <fastuidraw/painter/painter_enums.hpp>
+#include <fastuidraw/painter/attribute_data/painter_attribute.hpp>
+#include <private/thread_pool.hpp>
+#include <private/cpu_backend/brush_cpu.hpp>
+#include <private/cpu_backend/item_shaders_cpu.hpp>
+#include <private/cpu_backend/painter_surface_cpu_private.hpp>
+
+namespace fastuidraw { namespace cpu { namespace detail {
+
+/* How the fragments of a call to Rasterizer::rasterize()
+ * are blended: by m_blend_mode or, if m_w3c_mode is not
+ * PainterEnums::number_blend_mode, by the formula of that
+ * W3C blend mode applied to the value of the color buffer.
+ */
+class BlendState
+{
+public:
+  BlendState(void):
+    m_w3c_mode(PainterEnums::number_blend_mode)
+  {}
+
+  BlendMode m_blend_mode;
+  enum PainterEnums::blend_mode_t m_w3c_mode;
+};
+
+/* Values that are constant across the triangles of a
+ * call to Rasterizer::rasterize().
+ */
+class RasterState
+{
+public:
+  RasterState(void):
+    m_surface(nullptr),
+    m_coverage_surface(nullptr)
+  {
+    m_brush_ctx.m_image_atlas = nullptr;
+    m_brush_ctx.m_colorstop_atlas = nullptr;
+    m_brush_ctx.m_external_texture = nullptr;
+  }
+
+  ItemShaderContext m_item_ctx;
+  BrushContext m_brush_ctx;
+
+  /* table of shaders to use, chosen by the render type
+   * of the surface, indexed by the value of
+   * PainterHeader::m_item_shader.
+   */
+  c_array<const ShaderEntry> m_shaders;
+
+  /* table of custom brush shaders, indexed by the value
+   * of PainterHeader::m_brush_shader when it is not a
+   * fixed function brush.
+   */
+  c_array<const ShaderEntry> m_custom_brush_shaders;
+
+  /* surface to which to render */
+  PainterSurfaceCPUPrivate *m_surface;
+
+  /* the color buffer of the bound deferred coverage
+   * surface, may be nullptr.
+   */
+  const TexelStore *m_coverage_surface;
+};
+
+/* A Rasterizer executes the vertex and fragment stages of
+ * the CPU backend. The vertex stage runs on the attributes
+ * of a PainterDraw split into chunks processed in parallel.
+ * Triangles are then set up and binned, in order, to the
+ * tiles they touch and the tiles are rasterized in parallel;
+ * since each tile is processed by exactly one thread, the
+ * blending of the triangles within a tile happens in the
+ * order they were issued.
+ */
+class Rasterizer:noncopyable
+{
+public:
+  Rasterizer(unsigned int number_threads, unsigned int tile_size);
+
+  ~Rasterizer();
+
+  /* Run the vertex stage on the attributes of a PainterDraw;
+   * the processed vertices are used by the following calls
+   * to rasterize().
+   */
+  void
+  process_vertices(const RasterState &st,
+                   c_array<const PainterAttribute> attributes,
+                   c_array<const uint32_t> header_attributes);
+
+  /* Rasterize the triangles given by indices, which refer
+   * to the vertices of the last call to process_vertices(),
+   * blending as according to the named BlendState.
+   */
+  void
+  rasterize(const RasterState &st,
+            c_array<const PainterIndex> indices,
+            const BlendState &blend);
+
+private:
+  enum
+    {
+      /* the interpolates of a vertex are the 4 clip distances,
+       * followed by the brush position, followed by the
+       * varyings of the item shader.
+       */
+      clip_distance_interpolate = 0,
+      brush_interpolate = 4,
+      varying_interpolate = 6,
+      max_interpolates = varying_interpolate + item_max_varyings,
+
+      /* number of bits of sub-pixel precision of the
+       * window coordinates of the vertices
+       */
+      subpixel_bits = 8,
+    };
+
+  /* An output of the vertex stage */
+  class Vertex
+  {
+  public:
+    /* position in window coordinates */
+    vec2 m_window;
+
+    /* reciprocal of the w-coordinate of the clip position */
+    float m_recip_w;
+
+    /* value for depth test */
+    float m_depth;
+
+    /* false if the vertex is to be skipped, i.e. its
+     * shader is not supported or it is behind the eye
+     */
+    bool m_valid;
+
+    /* the location of the PainterHeader in the store */
+    uint32_t m_header_location;
+
+    /* interpolates, already multiplied by m_recip_w */
+    vecN<float, max_interpolates> m_interpolates;
+    vecN<uint32_t, item_max_flats> m_flats;
+  };
+
+  /* A triangle set up for rasterization */
+  class Triangle
+  {
+  public:
+    /* Edge equations; for a sample at (x, y) in sub-pixel
+     * units, the sample is inside edge k if
+     * m_edge_a[k] * x + m_edge_b[k] * y + m_edge_c[k] + m_edge_bias[k] >= 0
+     * where m_edge_bias[k] realizes the top-left fill rule.
+     */
+    vecN<int64_t, 3> m_edge_a, m_edge_b, m_edge_c, m_edge_bias;
+
+    /* pixel bounding box, max is not included */
+    ivec2 m_min_pixel, m_max_pixel;
+
+    /* the plane equations are of the form
+     *   f(x, y) = P.z() + P.x() * (x - m_origin.x()) + P.y() * (y - m_origin.y())
+     */
+    vec2 m_origin;
+    vec3 m_depth_plane, m_recip_w_plane;
+    vecN<vec3, max_interpolates> m_planes;
+    unsigned int m_number_interpolates;
+
+    vecN<uint32_t, item_max_flats> m_flats;
+    enum shader_type_t m_shader;
+    uint32_t m_sub_shader;
+    uint32_t m_item_shader_data_location;
+    ivec2 m_deferred_coverage_offset;
+
+    /* index into m_brushes or -1 when drawing an occluder */
+    int m_brush;
+  };
+
+  void
+  rasterize_tile(const RasterState &st, const BlendState &blend,
+                 unsigned int tile) const;
+
+  void
+  rasterize_triangle(const RasterState &st, const BlendState &blend,
+                     const Triangle &tri, ivec2 min_pixel, ivec2 max_pixel) const;
+
+  void
+  process_vertex_range(const RasterState &st,
+                       c_array<const PainterAttribute> attributes,
+                       c_array<const uint32_t> header_attributes,
+                       unsigned int begin, unsigned int end);
+
+  static
+  bool
+  setup_triangle(const Vertex &v0, const Vertex &v1, const Vertex &v2,
+                 ivec2 min_pixel, ivec2 max_pixel,
+                 unsigned int number_interpolates,
+                 Triangle *out_triangle);
+
+  fastuidraw::detail::ThreadPool m_pool;
+  int m_tile_size;
+  ivec2 m_number_tiles;
+  std::vector<Vertex> m_vertices;
+  std::vector<Triangle> m_triangles;
+  std::vector<BrushState> m_brushes;
+  std::vector<std::vector<unsigned int> > m_bins;
+  std::vector<unsigned int> m_active_tiles;
+};
+
+}}}
@@ -0,0 +1,263 @@
+/*!
+ * \file downsample_texels.cpp
+ * \brief file downsample_texels.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <vector>
+#include <cmath>
+#include <fastuidraw/util/math.hpp>
+#include <private/downsample_texels.hpp>
+#include <private/thread_pool.hpp>
+#include <private/util_private.hpp>
+
+namespace
+{
+  /* The taps of a filter along one axis: the texel x of the
+   * destination is computed from the source texels
+   * [2x + m_first, 2x + m_first + m_count) with weights
+   * m_weights[0], ..., m_weights[m_count - 1].
+   */
+  class FilterTaps
+  {
+  public:
+    enum
+      {
+        max_taps = 6
+      };
+
+    explicit
+    FilterTaps(enum fastuidraw::ImageSourceMipmapChain::filter_t filter);
+
+    int m_first;
+    unsigned int m_count;
+    fastuidraw::vecN<float, max_taps> m_weights;
+
+  private:
+    static
+    float
+    bessel_i0(float x);
+  };
+
+  /* The texels of a level are filtered as floats with values in
+   * [0, 255]; filtering is done in premultiplied space when the
+   * format has non-premultiplied alpha.
+   */
+  class TexelConverter
+  {
+  public:
+    explicit
+    TexelConverter(enum fastuidraw::Image::format_t fmt):
+      m_weight_by_alpha(fmt == fastuidraw::Image::rgba_format
+                        || fmt == fastuidraw::Image::luminance_alpha_format),
+      m_clamp_to_alpha(fmt == fastuidraw::Image::premultipied_rgba_format)
+    {}
+
+    fastuidraw::vec4
+    load(fastuidraw::u8vec4 v) const
+    {
+      fastuidraw::vec4 return_value(v);
+
+      if (m_weight_by_alpha)
+        {
+          float s(return_value.w() * (1.0f / 255.0f));
+
+          return_value.x() *= s;
+          return_value.y() *= s;
+          return_value.z() *= s;
+        }
+      return return_value;
+    }
+
+    fastuidraw::u8vec4
+    store(fastuidraw::vec4 v) const
+    {
+      using namespace fastuidraw;
+
+      v.w() = t_max(0.0f, t_min(255.0f, v.w()));
+      if (m_weight_by_alpha)
+        {
+          float s;
+
+          s = (v.w() > 0.0f) ? 255.0f / v.w() : 0.0f;
+          v.x() *= s;
+          v.y() *= s;
+          v.z() *= s;
+        }
+
+      float max_color(m_clamp_to_alpha ? v.w() : 255.0f);
+      u8vec4 return_value;
+      for (unsigned int c = 0; c < 4; ++c)
+        {
+          float f;
+
+          f = (c < 3) ? t_min(max_color, v[c]) : v[c];
+          return_value[c] = static_cast<uint8_t>(t_max(0.0f, f) + 0.5f);
+        }
+      return return_value;
+    }
+
+  private:
+    bool m_weight_by_alpha, m_clamp_to_alpha;
+  };
+
+  inline
+  int
+  clamp_index(int v, int sz)
+  {
+    return fastuidraw::t_max(0, fastuidraw::t_min(sz - 1, v));
+  }
+}
+
+//////////////////////////
+// FilterTaps methods
+FilterTaps::
+FilterTaps(enum fastuidraw::ImageSourceMipmapChain::filter_t filter):
+  m_weights(0.0f)
+{
+  if (filter == fastuidraw::ImageSourceMipmapChain::box_filter)
+    {
+      m_first = 0;
+      m_count = 2;
+      m_weights[0] = m_weights[1] = 0.5f;
+    }
+  else
+    {
+      /* the center of destination texel x is at 2x + 1 in
+       * source coordinates, so the source texel 2x + m_first + k
+       * is at offset d = m_first + k - 0.5 from it. The weight
+       * is a sinc at half frequency windowed by a Kaiser window
+       * of radius 3 source texels.
+       */
+      const float alpha(4.0f), radius(3.0f);
+      float sum(0.0f), inv_i0_alpha(1.0f / bessel_i0(alpha));
+
+      m_first = -2;
+      m_count = 6;
+      for (unsigned int k = 0; k < m_count; ++k)
+        {
+          float d, t, sinc, window;
+
+          d = float(m_first + int(k)) - 0.5f;
+          t = d / radius;
+          sinc = std::sin(0.5f * float(M_PI) * d) / (0.5f * float(M_PI) * d);
+          window = bessel_i0(alpha * std::sqrt(1.0f - t * t)) * inv_i0_alpha;
+          m_weights[k] = sinc * window;
+          sum += m_weights[k];
+        }
+
+      for (unsigned int k = 0; k < m_count; ++k)
+        {
+          m_weights[k] /= sum;
+        }
+    }
+}
+
+float
+FilterTaps::
+bessel_i0(float x)
+{
+  /* power series of the zeroth order modified Bessel
+   * function of the first kind; converges quickly for
+   * the small arguments of a Kaiser window.
+   */
+  float sum(1.0f), term(1.0f), hx(0.5f * x);
+  for (unsigned int k = 1; k < 16; ++k)
+    {
+      term *= hx / float(k);
+      sum += term * term;
+    }
+  return sum;
+}
+
+///////////////////////////////////
+// fastuidraw::detail methods
+void
+fastuidraw::detail::
+downsample_texels(enum ImageSourceMipmapChain::filter_t filter,
+                  enum Image::format_t fmt, uvec2 src_dims,
+                  c_array<const u8vec4> src, c_array<u8vec4> dst)
+{
+  uvec2 dst_dims(downsample_dimensions(src_dims));
+  int src_w(src_dims.x()), src_h(src_dims.y());
+  int dst_w(dst_dims.x()), dst_h(dst_dims.y());
+  FilterTaps taps(filter);
+  TexelConverter converter(fmt);
+  std::vector<vec4> horizontal(dst_w * src_h);
+
+  FASTUIDRAWassert(src.size() == src_dims.x() * src_dims.y());
+  FASTUIDRAWassert(dst.size() == dst_dims.x() * dst_dims.y());
+
+  /* The filter is separable: first filter each row of the source
+   * horizontally into horizontal[], then filter the columns of
+   * horizontal[] vertically into dst. The inner loops operate on
+   * vec4 values so that the compiler can issue a single SIMD
+   * operation per tap.
+   */
+  SharedThreadPool::get().parallel_for(src_h, 16u,
+                                       [&](unsigned int begin, unsigned int end)
+  {
+    std::vector<vec4> row(src_w);
+    for (int y = begin; y < int(end); ++y)
+      {
+        c_array<const u8vec4> src_row(src.sub_array(y * src_w, src_w));
+        c_array<vec4> dst_row(make_c_array(horizontal).sub_array(y * dst_w, dst_w));
+
+        for (int x = 0; x < src_w; ++x)
+          {
+            row[x] = converter.load(src_row[x]);
+          }
+
+        for (int x = 0; x < dst_w; ++x)
+          {
+            vec4 sum(0.0f);
+            int sx(2 * x + taps.m_first);
+
+            for (unsigned int k = 0; k < taps.m_count; ++k, ++sx)
+              {
+                sum += taps.m_weights[k] * row[clamp_index(sx, src_w)];
+              }
+            dst_row[x] = sum;
+          }
+      }
+  });
+
+  SharedThreadPool::get().parallel_for(dst_h, 16u,
+                                       [&](unsigned int begin, unsigned int end)
+  {
+    std::vector<vec4> row(dst_w);
+    for (int y = begin; y < int(end); ++y)
+      {
+        int sy(2 * y + taps.m_first);
+
+        std::fill(row.begin(), row.end(), vec4(0.0f));
+        for (unsigned int k = 0; k < taps.m_count; ++k, ++sy)
+          {
+            const vec4 *src_row(&horizontal[clamp_index(sy, src_h) * dst_w]);
+            float wt(taps.m_weights[k]);
+
+            for (int x = 0; x < dst_w; ++x)
+              {
+                row[x] += wt * src_row[x];
+              }
+          }
+
+        for (int x = 0; x < dst_w; ++x)
+          {
+            dst[x + y * dst_w] = converter.store(row[x]);
+          }
+      }
+  });
+}
@@ -0,0 +1,59 @@
+/*!
+ * \file downsample_texels.hpp
+ * \brief file downsample_texels.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/image.hpp>
+
+namespace fastuidraw
+{
+  namespace detail
+  {
+    /*!
+     * Returns the dimensions of the mipmap level that follows
+     * a level of the given dimensions, i.e. max(1, dims >> 1).
+     */
+    inline
+    uvec2
+    downsample_dimensions(uvec2 dims)
+    {
+      return uvec2(t_max(1u, dims.x() >> 1u),
+                   t_max(1u, dims.y() >> 1u));
+    }
+
+    /*!
+     * Compute the mipmap level that follows a level of texels.
+     * The work is spread across the threads of SharedThreadPool.
+     * \param filter filter to apply
+     * \param fmt format of the texels; for Image::rgba_format and
+     *            Image::luminance_alpha_format the color channels
+     *            are weighted by alpha
+     * \param src_dims dimensions of src
+     * \param src texels of the source level, packed row by row
+     * \param dst location to which to write the texels of the
+     *            next level, must be of size downsample_dimensions(src_dims)
+     */
+    void
+    downsample_texels(enum ImageSourceMipmapChain::filter_t filter,
+                      enum Image::format_t fmt, uvec2 src_dims,
+                      c_array<const u8vec4> src, c_array<u8vec4> dst);
+  }
+}
@@ -5,7 +5,7 @@ d		:= $(dir)
 # End standard header
 
 FASTUIDRAW_PRIVATE_GL_SOURCES += $(call filelist, \
-	tex_buffer.cpp texture_gl.cpp \
+	tex_buffer.cpp texture_gl.cpp context_worker_gl.cpp \
 	image_gl.cpp colorstop_atlas_gl.cpp \
 	texture_view.cpp bindless.cpp \
 	painter_backend_gl_config.cpp \
@@ -14,6 +14,7 @@ FASTUIDRAW_PRIVATE_GL_SOURCES += $(call filelist, \
 	glyph_atlas_gl.cpp \
 	painter_backend_gl.cpp \
 	painter_vao_pool.cpp \
+	gl_state_cache.cpp \
 	scratch_renderer.cpp)
 
 
@@ -30,6 +30,8 @@ namespace fastuidraw { namespace gl { namespace detail {
     int m_colorstop_atlas_binding;
     int m_image_atlas_color_tiles_nearest_binding;
     int m_image_atlas_color_tiles_linear_binding;
+    int m_image_atlas_color_tiles_r8_binding;
+    int m_image_atlas_color_tiles_rg8_binding;
     int m_image_atlas_index_tiles_binding;
     int m_glyph_atlas_store_binding;
     int m_glyph_atlas_store_binding_fp16;
@@ -30,7 +30,8 @@ namespace
   class BackingStore:public fastuidraw::ColorStopBackingStore
   {
   public:
-    BackingStore(int w, int l);
+    BackingStore(int w, int l,
+                 const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker);
     ~BackingStore();
 
     virtual
@@ -57,10 +58,11 @@ namespace
 
     static
     fastuidraw::reference_counted_ptr<fastuidraw::ColorStopBackingStore>
-    create(int w, int l)
+    create(int w, int l,
+           const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker)
     {
       BackingStore *p;
-      p = FASTUIDRAWnew BackingStore(w, l);
+      p = FASTUIDRAWnew BackingStore(w, l, worker);
       return fastuidraw::reference_counted_ptr<fastuidraw::ColorStopBackingStore>(p);
     }
 
@@ -116,9 +118,10 @@ namespace
 //////////////////////////
 // BackingStore methods
 BackingStore::
-BackingStore(int w, int l):
+BackingStore(int w, int l,
+             const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker):
   fastuidraw::ColorStopBackingStore(w, l, true),
-  m_backing_store(dimensions_for_store(w, l), true)
+  m_backing_store(dimensions_for_store(w, l), true, 1, worker)
 {
 }
 
@@ -155,8 +158,9 @@ set_data(int x, int l,
 //////////////////////////////////////////////////////
 // fastuidraw::gl::detail::ColorStopAtlasGL methods
 fastuidraw::gl::detail::ColorStopAtlasGL::
-ColorStopAtlasGL(const PainterEngineGL::ColorStopAtlasParams &P):
-  fastuidraw::ColorStopAtlas(BackingStore::create(P.width(), P.num_layers()))
+ColorStopAtlasGL(const PainterEngineGL::ColorStopAtlasParams &P,
+                 const reference_counted_ptr<ContextWorkerGL> &worker):
+  fastuidraw::ColorStopAtlas(BackingStore::create(P.width(), P.num_layers(), worker))
 {
 }
 
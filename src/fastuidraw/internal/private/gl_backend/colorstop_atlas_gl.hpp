@@ -22,6 +22,7 @@
 #include <fastuidraw/colorstop_atlas.hpp>
 #include <fastuidraw/gl_backend/gl_program.hpp>
 #include <fastuidraw/gl_backend/painter_engine_gl.hpp>
+#include <private/gl_backend/context_worker_gl.hpp>
 
 namespace fastuidraw
 {
@@ -40,7 +41,9 @@ namespace detail
    * in GLES it is GL_TEXTURE_2D_ARRAY (because GLES does not
    * support 1D texture).
    *
-   * The method flush() must be called with a GL context current.
+   * The method flush() must be called with a GL context current
+   * unless the ColorStopAtlasGL is given a ContextWorkerGL, in
+   * which case flush() hands the uploads to the worker.
    */
   class ColorStopAtlasGL:public ColorStopAtlas
   {
@@ -48,9 +51,13 @@ namespace detail
     /*!
      * Ctor.
      * \param P parameters of construction.
+     * \param worker if non-null, worker that performs the
+     *               GL work of the backing store
      */
     explicit
-    ColorStopAtlasGL(const PainterEngineGL::ColorStopAtlasParams &P);
+    ColorStopAtlasGL(const PainterEngineGL::ColorStopAtlasParams &P,
+                     const reference_counted_ptr<ContextWorkerGL> &worker
+                     = reference_counted_ptr<ContextWorkerGL>());
 
     ~ColorStopAtlasGL();
 
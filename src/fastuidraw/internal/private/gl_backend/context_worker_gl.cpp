@@ -0,0 +1,160 @@
+/*!
+ * \file context_worker_gl.cpp
+ * \brief file context_worker_gl.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <private/gl_backend/context_worker_gl.hpp>
+
+fastuidraw::gl::detail::ContextWorkerGL::
+ContextWorkerGL(const reference_counted_ptr<PainterEngineGL::UploadContext> &ctx):
+  m_ctx(ctx),
+  m_quit(false),
+  m_added(0),
+  m_completed(0),
+  m_fence(nullptr),
+  m_server_waited(0)
+{
+  FASTUIDRAWassert(m_ctx);
+  m_thread = std::thread(&ContextWorkerGL::worker_main, this);
+}
+
+fastuidraw::gl::detail::ContextWorkerGL::
+~ContextWorkerGL()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+  }
+  m_task_condition.notify_one();
+  m_thread.join();
+}
+
+uint64_t
+fastuidraw::gl::detail::ContextWorkerGL::
+add_task(const task &f)
+{
+  uint64_t return_value;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_tasks.push_back(f);
+    return_value = ++m_added;
+  }
+  m_task_condition.notify_one();
+  return return_value;
+}
+
+void
+fastuidraw::gl::detail::ContextWorkerGL::
+delete_texture(GLuint texture)
+{
+  if (texture != 0)
+    {
+      add_task([texture]() { fastuidraw_glDeleteTextures(1, &texture); });
+    }
+}
+
+void
+fastuidraw::gl::detail::ContextWorkerGL::
+delete_buffer(GLuint buffer)
+{
+  if (buffer != 0)
+    {
+      add_task([buffer]() { fastuidraw_glDeleteBuffers(1, &buffer); });
+    }
+}
+
+void
+fastuidraw::gl::detail::ContextWorkerGL::
+finish_task(uint64_t ticket)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done_condition.wait(lock, [&]() { return m_completed >= ticket; });
+}
+
+void
+fastuidraw::gl::detail::ContextWorkerGL::
+wait_task(uint64_t ticket)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  m_done_condition.wait(lock, [&]() { return m_completed >= ticket; });
+  if (ticket > m_server_waited && m_fence)
+    {
+      /* the wait is on the GL server, so the CPU does not
+       * stall on the GPU executing the uploads; m_fence is
+       * deleted by the worker only with m_mutex locked and
+       * GL defers deleting a sync object that is waited on.
+       */
+      fastuidraw_glWaitSync(m_fence, 0, GL_TIMEOUT_IGNORED);
+      m_server_waited = m_completed;
+    }
+}
+
+void
+fastuidraw::gl::detail::ContextWorkerGL::
+worker_main(void)
+{
+  std::vector<task> tasks;
+
+  m_ctx->make_current();
+  for (;;)
+    {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_task_condition.wait(lock, [&]() { return m_quit || !m_tasks.empty(); });
+        if (m_tasks.empty())
+          {
+            break;
+          }
+        std::swap(tasks, m_tasks);
+      }
+
+      for (const task &f : tasks)
+        {
+          f();
+        }
+
+      GLsync fence;
+
+      /* the flush guarantees that the fence reaches the GL
+       * server, which is needed for a different context to
+       * wait on it.
+       */
+      fence = fastuidraw_glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      fastuidraw_glFlush();
+
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fence)
+          {
+            fastuidraw_glDeleteSync(m_fence);
+          }
+        m_fence = fence;
+        m_completed += tasks.size();
+      }
+      m_done_condition.notify_all();
+      tasks.clear();
+    }
+
+  if (m_fence)
+    {
+      fastuidraw_glDeleteSync(m_fence);
+      m_fence = nullptr;
+    }
+  fastuidraw_glFinish();
+  m_ctx->release_current();
+}
@@ -0,0 +1,114 @@
+/*!
+ * \file context_worker_gl.hpp
+ * \brief file context_worker_gl.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <condition_variable>
+#include <stdint.h>
+
+#include <fastuidraw/util/reference_counted.hpp>
+#include <fastuidraw/gl_backend/ngl_header.hpp>
+#include <fastuidraw/gl_backend/painter_engine_gl.hpp>
+
+namespace fastuidraw { namespace gl { namespace detail {
+
+/* A ContextWorkerGL owns a thread that makes current the GL context
+ * of a PainterEngineGL::UploadContext and executes tasks with it
+ * current. Tasks are executed in the order they are added. After
+ * each batch of tasks the worker issues a fence so that a context
+ * of the share group can have its GL server wait on the tasks
+ * before using the GL objects the tasks modified. A ContextWorkerGL
+ * is also where GL objects are deleted when there is no guarantee
+ * that a GL context is current on the thread that releases them.
+ */
+class ContextWorkerGL:
+  public reference_counted<ContextWorkerGL>::concurrent
+{
+public:
+  typedef std::function<void ()> task;
+
+  explicit
+  ContextWorkerGL(const reference_counted_ptr<PainterEngineGL::UploadContext> &ctx);
+
+  /* Executes all tasks added before returning. */
+  ~ContextWorkerGL();
+
+  /* Add a task to execute on the worker thread; may be called
+   * from any thread. Returns the ticket of the task, which is
+   * a value to pass to wait_task() or finish_task().
+   */
+  uint64_t
+  add_task(const task &f);
+
+  /* Add a task to delete a GL texture; may be called from any
+   * thread.
+   */
+  void
+  delete_texture(GLuint texture);
+
+  /* Add a task to delete a GL buffer object; may be called from
+   * any thread.
+   */
+  void
+  delete_buffer(GLuint buffer);
+
+  /* Blocks until the task of the named ticket has been executed
+   * and then has the GL server of the current GL context wait on
+   * the fence issued after it. The calling thread must have a GL
+   * context of the share group current.
+   */
+  void
+  wait_task(uint64_t ticket);
+
+  /* Blocks until the task of the named ticket has been executed;
+   * does not require a GL context to be current.
+   */
+  void
+  finish_task(uint64_t ticket);
+
+private:
+  void
+  worker_main(void);
+
+  reference_counted_ptr<PainterEngineGL::UploadContext> m_ctx;
+
+  std::mutex m_mutex;
+  std::condition_variable m_task_condition, m_done_condition;
+  std::vector<task> m_tasks;
+  bool m_quit;
+
+  /* number of tasks added and number of tasks executed */
+  uint64_t m_added, m_completed;
+
+  /* fence issued after the last executed task and the number
+   * of executed tasks that a server wait on it covered when
+   * wait_task() last waited on it.
+   */
+  GLsync m_fence;
+  uint64_t m_server_waited;
+
+  std::thread m_thread;
+};
+
+} //namespace detail
+} //namespace gl
+} //namespace fastuidraw
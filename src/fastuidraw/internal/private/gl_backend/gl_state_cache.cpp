@@ -0,0 +1,367 @@
+/*!
+ * \file gl_state_cache.cpp
+ * \brief file gl_state_cache.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <algorithm>
+#include <private/gl_backend/gl_state_cache.hpp>
+
+#ifdef FASTUIDRAW_GL_USE_GLES
+#define GL_CLIP_DISTANCE0 GL_CLIP_DISTANCE0_EXT
+#endif
+
+//////////////////////////////////////////
+// fastuidraw::gl::detail::GLStateCache methods
+fastuidraw::gl::detail::GLStateCache::
+GLStateCache(void):
+  m_num_calls_issued(0u),
+  m_num_calls_elided(0u)
+{
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+invalidate(gpu_dirty_state flags)
+{
+  if (flags & gpu_dirty_state::shader)
+    {
+      m_program.invalidate();
+    }
+
+  if (flags & gpu_dirty_state::vertex_index_source)
+    {
+      m_vao.invalidate();
+    }
+
+  if (flags & gpu_dirty_state::render_target)
+    {
+      m_draw_fbo.invalidate();
+    }
+
+  if (flags & gpu_dirty_state::textures)
+    {
+      m_active_texture.invalidate();
+      for (TextureUnit &unit : m_texture_units)
+        {
+          unit.invalidate();
+        }
+    }
+
+  if (flags & gpu_dirty_state::constant_buffers)
+    {
+      for (CachedValue<GLuint> &ubo : m_ubos)
+        {
+          ubo.invalidate();
+        }
+    }
+
+  if (flags & gpu_dirty_state::storage_buffers)
+    {
+      for (CachedValue<GLuint> &ssbo : m_ssbos)
+        {
+          ssbo.invalidate();
+        }
+    }
+
+  if (flags & gpu_dirty_state::blend_mode)
+    {
+      m_caps[cap_blend].invalidate();
+      m_blend_equation.invalidate();
+      m_blend_func.invalidate();
+    }
+
+  if (flags & gpu_dirty_state::depth_stencil)
+    {
+      m_caps[cap_depth_test].invalidate();
+      m_caps[cap_stencil_test].invalidate();
+      m_depth_func.invalidate();
+    }
+
+  if (flags & gpu_dirty_state::buffer_masks)
+    {
+      m_color_mask.invalidate();
+      m_depth_mask.invalidate();
+    }
+
+  if (flags & gpu_dirty_state::viewport_scissor)
+    {
+      m_caps[cap_scissor_test].invalidate();
+      m_viewport.invalidate();
+      m_scissor.invalidate();
+    }
+
+  if (flags & gpu_dirty_state::hw_clip)
+    {
+      for (int i = cap_clip_distance0; i < number_caps; ++i)
+        {
+          m_caps[i].invalidate();
+        }
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+invalidate_active_texture_unit(void)
+{
+  if (m_active_texture.known())
+    {
+      texture_unit(m_active_texture.value()).m_bindings.clear();
+    }
+  else
+    {
+      /* any of the units might be the active one */
+      for (TextureUnit &unit : m_texture_units)
+        {
+          unit.m_bindings.clear();
+        }
+    }
+}
+
+fastuidraw::gl::detail::GLStateCache::TextureUnit&
+fastuidraw::gl::detail::GLStateCache::
+texture_unit(unsigned int unit)
+{
+  if (unit >= m_texture_units.size())
+    {
+      m_texture_units.resize(unit + 1);
+    }
+  return m_texture_units[unit];
+}
+
+std::vector<fastuidraw::gl::detail::GLStateCache::CachedValue<GLuint> >&
+fastuidraw::gl::detail::GLStateCache::
+indexed_buffers(GLenum target)
+{
+  FASTUIDRAWassert(target == GL_UNIFORM_BUFFER || target == GL_SHADER_STORAGE_BUFFER);
+  return (target == GL_UNIFORM_BUFFER) ? m_ubos : m_ssbos;
+}
+
+int
+fastuidraw::gl::detail::GLStateCache::
+cap_index(GLenum cap)
+{
+  switch (cap)
+    {
+    case GL_BLEND:
+      return cap_blend;
+    case GL_DEPTH_TEST:
+      return cap_depth_test;
+    case GL_STENCIL_TEST:
+      return cap_stencil_test;
+    case GL_SCISSOR_TEST:
+      return cap_scissor_test;
+    default:
+      if (cap >= GL_CLIP_DISTANCE0 && cap < GL_CLIP_DISTANCE0 + number_caps - cap_clip_distance0)
+        {
+          return cap_clip_distance0 + (cap - GL_CLIP_DISTANCE0);
+        }
+      return -1;
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+use_program(GLuint program)
+{
+  if (record(m_program.update(program)))
+    {
+      fastuidraw_glUseProgram(program);
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+bind_vertex_array(GLuint vao)
+{
+  if (record(m_vao.update(vao)))
+    {
+      fastuidraw_glBindVertexArray(vao);
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+bind_draw_framebuffer(GLuint fbo, c_array<const GLenum> draw_buffers)
+{
+  if (record(m_draw_fbo.update(fbo)))
+    {
+      fastuidraw_glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
+      fastuidraw_glDrawBuffers(draw_buffers.size(), draw_buffers.c_ptr());
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+active_texture(unsigned int unit)
+{
+  if (record(m_active_texture.update(unit)))
+    {
+      fastuidraw_glActiveTexture(GL_TEXTURE0 + unit);
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+bind_texture(unsigned int unit, GLenum target, GLuint texture)
+{
+  std::vector<std::pair<GLenum, GLuint> > &bindings(texture_unit(unit).m_bindings);
+  std::vector<std::pair<GLenum, GLuint> >::iterator iter;
+
+  iter = std::find_if(bindings.begin(), bindings.end(),
+                      [target](const std::pair<GLenum, GLuint> &b)
+                      {
+                        return b.first == target;
+                      });
+
+  if (iter != bindings.end() && iter->second == texture)
+    {
+      record(false);
+      return;
+    }
+
+  if (iter != bindings.end())
+    {
+      iter->second = texture;
+    }
+  else
+    {
+      bindings.push_back(std::make_pair(target, texture));
+    }
+
+  active_texture(unit);
+  record(true);
+  fastuidraw_glBindTexture(target, texture);
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+bind_sampler(unsigned int unit, GLuint sampler)
+{
+  if (record(texture_unit(unit).m_sampler.update(sampler)))
+    {
+      fastuidraw_glBindSampler(unit, sampler);
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+bind_buffer_base(GLenum target, unsigned int index, GLuint buffer)
+{
+  std::vector<CachedValue<GLuint> > &buffers(indexed_buffers(target));
+
+  if (index >= buffers.size())
+    {
+      buffers.resize(index + 1);
+    }
+
+  if (record(buffers[index].update(buffer)))
+    {
+      fastuidraw_glBindBufferBase(target, index, buffer);
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+enable(GLenum cap, bool enabled)
+{
+  int idx(cap_index(cap));
+
+  if (record(idx < 0 || m_caps[idx].update(enabled)))
+    {
+      if (enabled)
+        {
+          fastuidraw_glEnable(cap);
+        }
+      else
+        {
+          fastuidraw_glDisable(cap);
+        }
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+depth_func(GLenum func)
+{
+  if (record(m_depth_func.update(func)))
+    {
+      fastuidraw_glDepthFunc(func);
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+color_mask(bool r, bool g, bool b, bool a)
+{
+  if (record(m_color_mask.update(vecN<bool, 4>(r, g, b, a))))
+    {
+      fastuidraw_glColorMask(r ? GL_TRUE : GL_FALSE,
+                             g ? GL_TRUE : GL_FALSE,
+                             b ? GL_TRUE : GL_FALSE,
+                             a ? GL_TRUE : GL_FALSE);
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+depth_mask(bool v)
+{
+  if (record(m_depth_mask.update(v)))
+    {
+      fastuidraw_glDepthMask(v ? GL_TRUE : GL_FALSE);
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+viewport(int x, int y, int w, int h)
+{
+  if (record(m_viewport.update(ivec4(x, y, w, h))))
+    {
+      fastuidraw_glViewport(x, y, w, h);
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+scissor(int x, int y, int w, int h)
+{
+  if (record(m_scissor.update(ivec4(x, y, w, h))))
+    {
+      fastuidraw_glScissor(x, y, w, h);
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+blend_equation(GLenum rgb, GLenum alpha)
+{
+  if (record(m_blend_equation.update(vecN<GLenum, 2>(rgb, alpha))))
+    {
+      fastuidraw_glBlendEquationSeparate(rgb, alpha);
+    }
+}
+
+void
+fastuidraw::gl::detail::GLStateCache::
+blend_func(GLenum src_rgb, GLenum dst_rgb,
+           GLenum src_alpha, GLenum dst_alpha)
+{
+  if (record(m_blend_func.update(vecN<GLenum, 4>(src_rgb, dst_rgb, src_alpha, dst_alpha))))
+    {
+      fastuidraw_glBlendFuncSeparate(src_rgb, dst_rgb, src_alpha, dst_alpha);
+    }
+}
@@ -0,0 +1,260 @@
+/*!
+ * \file gl_state_cache.hpp
+ * \brief file gl_state_cache.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/gpu_dirty_state.hpp>
+#include <fastuidraw/gl_backend/ngl_header.hpp>
+
+namespace fastuidraw { namespace gl { namespace detail {
+
+/* A GLStateCache shadows the portion of GL state that
+ * PainterBackendGL sets while drawing and only issues
+ * a GL call if it would change that state. The cache
+ * has no way to see GL calls that do not go through it,
+ * so it must be invalidated whenever something else may
+ * have modified the state:
+ *  - all of it at the start and end of drawing to a surface
+ *  - the portions named by the gpu_dirty_state returned by
+ *    a PainterDrawBreakAction after the action executes
+ *  - the bindings of the active texture unit after anything
+ *    that may lazily create or upload to a texture (for
+ *    example fetching the backing texture of an atlas).
+ */
+class GLStateCache:noncopyable
+{
+public:
+  GLStateCache(void);
+
+  /* Forget the state named by flags so that the next
+   * call affecting that state is issued.
+   */
+  void
+  invalidate(gpu_dirty_state flags);
+
+  /* Forget the texture bindings of the active texture
+   * unit, but not what the active texture unit is.
+   */
+  void
+  invalidate_active_texture_unit(void);
+
+  void
+  use_program(GLuint program);
+
+  void
+  bind_vertex_array(GLuint vao);
+
+  /* Binds an FBO to GL_DRAW_FRAMEBUFFER; the draw buffers
+   * are state of the FBO, so they are only set when the
+   * bound FBO changes.
+   */
+  void
+  bind_draw_framebuffer(GLuint fbo, c_array<const GLenum> draw_buffers);
+
+  void
+  active_texture(unsigned int unit);
+
+  /* Makes unit the active texture unit and binds
+   * texture to target on it.
+   */
+  void
+  bind_texture(unsigned int unit, GLenum target, GLuint texture);
+
+  void
+  bind_sampler(unsigned int unit, GLuint sampler);
+
+  void
+  bind_buffer_base(GLenum target, unsigned int index, GLuint buffer);
+
+  void
+  enable(GLenum cap, bool enabled);
+
+  void
+  depth_func(GLenum func);
+
+  void
+  color_mask(bool r, bool g, bool b, bool a);
+
+  void
+  depth_mask(bool v);
+
+  void
+  viewport(int x, int y, int w, int h);
+
+  void
+  scissor(int x, int y, int w, int h);
+
+  void
+  blend_equation(GLenum rgb, GLenum alpha);
+
+  void
+  blend_func(GLenum src_rgb, GLenum dst_rgb,
+             GLenum src_alpha, GLenum dst_alpha);
+
+  /* Set the counters returned by num_calls_issued()
+   * and num_calls_elided() to zero.
+   */
+  void
+  reset_counters(void)
+  {
+    m_num_calls_issued = 0u;
+    m_num_calls_elided = 0u;
+  }
+
+  /* Number of GL calls made through the cache
+   * since the last call to reset_counters().
+   */
+  unsigned int
+  num_calls_issued(void) const
+  {
+    return m_num_calls_issued;
+  }
+
+  /* Number of GL calls the cache skipped because they would
+   * not have changed GL state since the last call to
+   * reset_counters().
+   */
+  unsigned int
+  num_calls_elided(void) const
+  {
+    return m_num_calls_elided;
+  }
+
+private:
+  template<typename T>
+  class CachedValue
+  {
+  public:
+    CachedValue(void):
+      m_known(false),
+      m_value()
+    {}
+
+    void
+    invalidate(void)
+    {
+      m_known = false;
+    }
+
+    bool
+    known(void) const
+    {
+      return m_known;
+    }
+
+    const T&
+    value(void) const
+    {
+      FASTUIDRAWassert(m_known);
+      return m_value;
+    }
+
+    /* Returns true if the value is different from the
+     * cached value and records the value as the cached
+     * value.
+     */
+    bool
+    update(const T &v)
+    {
+      if (m_known && m_value == v)
+        {
+          return false;
+        }
+      m_known = true;
+      m_value = v;
+      return true;
+    }
+
+  private:
+    bool m_known;
+    T m_value;
+  };
+
+  class TextureUnit
+  {
+  public:
+    void
+    invalidate(void)
+    {
+      m_bindings.clear();
+      m_sampler.invalidate();
+    }
+
+    /* holds only those (target, texture) pairs that are known */
+    std::vector<std::pair<GLenum, GLuint> > m_bindings;
+    CachedValue<GLuint> m_sampler;
+  };
+
+  enum cap_t
+    {
+      cap_blend,
+      cap_depth_test,
+      cap_stencil_test,
+      cap_scissor_test,
+      cap_clip_distance0,
+
+      number_caps = cap_clip_distance0 + 8
+    };
+
+  bool
+  record(bool changed)
+  {
+    if (changed)
+      {
+        ++m_num_calls_issued;
+      }
+    else
+      {
+        ++m_num_calls_elided;
+      }
+    return changed;
+  }
+
+  TextureUnit&
+  texture_unit(unsigned int unit);
+
+  std::vector<CachedValue<GLuint> >&
+  indexed_buffers(GLenum target);
+
+  static
+  int
+  cap_index(GLenum cap);
+
+  CachedValue<GLuint> m_program, m_vao, m_draw_fbo;
+  CachedValue<unsigned int> m_active_texture;
+  std::vector<TextureUnit> m_texture_units;
+  std::vector<CachedValue<GLuint> > m_ubos, m_ssbos;
+  vecN<CachedValue<bool>, number_caps> m_caps;
+  CachedValue<GLenum> m_depth_func;
+  CachedValue<vecN<bool, 4> > m_color_mask;
+  CachedValue<bool> m_depth_mask;
+  CachedValue<ivec4> m_viewport, m_scissor;
+  CachedValue<vecN<GLenum, 2> > m_blend_equation;
+  CachedValue<vecN<GLenum, 4> > m_blend_func;
+
+  unsigned int m_num_calls_issued, m_num_calls_elided;
+};
+
+} //namespace detail
+} //namespace gl
+} //namespace fastuidraw
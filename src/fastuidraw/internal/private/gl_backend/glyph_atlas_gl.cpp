@@ -48,7 +48,8 @@ namespace
 
     static
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasBackingStoreBase>
-    create(const fastuidraw::gl::PainterEngineGL::GlyphAtlasParams &P);
+    create(const fastuidraw::gl::PainterEngineGL::GlyphAtlasParams &P,
+           const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker);
 
     GLenum m_binding_point;
     fastuidraw::ivec2 m_log2_dims;
@@ -124,8 +125,8 @@ namespace
   class StoreGL_Texture:public StoreGL
   {
   public:
-    explicit
-    StoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number);
+    StoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number,
+                    const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker);
 
     ~StoreGL_Texture();
 
@@ -163,26 +164,38 @@ namespace
     fastuidraw::uvec2 m_layer_dims;
     int m_texels_per_layer;
     TextureGL m_backing_store;
-    mutable GLuint m_texture_fp16;
+    fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> m_worker;
+
+    /* view of m_backing_store as GL_RG16F, made on demand
+     * by gl_backing() for the texture m_texture_fp16_source.
+     */
+    mutable GLuint m_texture_fp16, m_texture_fp16_source;
   };
 }
 
 ///////////////////////////////////////////////
 // StoreGL_Texture methods
 StoreGL_Texture::
-StoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number_texels):
+StoreGL_Texture(fastuidraw::ivec2 log2_wh, unsigned int number_texels,
+                const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker):
   StoreGL(number_texels, GL_TEXTURE_2D_ARRAY, log2_wh, true),
   m_layer_dims(1 << log2_wh.x(), 1 << log2_wh.y()),
   m_texels_per_layer(m_layer_dims.x() * m_layer_dims.y()),
-  m_backing_store(texture_size(m_layer_dims, number_texels), true),
-  m_texture_fp16(0)
+  m_backing_store(texture_size(m_layer_dims, number_texels), true, 1, worker),
+  m_worker(worker),
+  m_texture_fp16(0),
+  m_texture_fp16_source(0)
 {
 }
 
 StoreGL_Texture::
 ~StoreGL_Texture()
 {
-  if (m_texture_fp16)
+  if (m_worker)
+    {
+      m_worker->delete_texture(m_texture_fp16);
+    }
+  else if (m_texture_fp16)
     {
       fastuidraw_glDeleteTextures(1, &m_texture_fp16);
     }
@@ -207,12 +220,10 @@ void
 StoreGL_Texture::
 resize_implement(unsigned int new_size)
 {
-  if (m_texture_fp16)
-    {
-      fastuidraw_glDeleteTextures(1, &m_texture_fp16);
-      m_texture_fp16 = 0;
-    }
-    m_backing_store.resize(texture_size(m_layer_dims, new_size));
+  /* the view is remade by gl_backing() once the
+   * resize replaces the texture.
+   */
+  m_backing_store.resize(texture_size(m_layer_dims, new_size));
 }
 
 void
@@ -220,26 +231,39 @@ StoreGL_Texture::
 flush(void)
 {
   m_backing_store.flush();
-  if (m_texture_fp16 == 0)
+}
+
+GLuint
+StoreGL_Texture::
+gl_backing(enum fastuidraw::gl::detail::GlyphAtlasGL::backing_fmt_t fmt) const
+{
+  TextureGL::DimensionType dims;
+  GLuint texture;
+
+  texture = m_backing_store.texture(&dims);
+  if (fmt == fastuidraw::gl::detail::GlyphAtlasGL::backing_uint32_fmt)
     {
+      return texture;
+    }
+
+  if (m_texture_fp16_source != texture)
+    {
+      if (m_texture_fp16)
+        {
+          fastuidraw_glDeleteTextures(1, &m_texture_fp16);
+        }
+
       fastuidraw_glGenTextures(1, &m_texture_fp16);
       FASTUIDRAWassert(m_texture_fp16 != 0);
 
       fastuidraw::gl::detail::texture_view(fastuidraw::gl::detail::compute_texture_view_support(),
                                            m_texture_fp16, GL_TEXTURE_2D_ARRAY,
-                                           m_backing_store.texture(), GL_RG16F,
+                                           texture, GL_RG16F,
                                            0, 1,
-                                           0, m_backing_store.dims().z());
+                                           0, dims.z());
+      m_texture_fp16_source = texture;
     }
-}
-
-GLuint
-StoreGL_Texture::
-gl_backing(enum fastuidraw::gl::detail::GlyphAtlasGL::backing_fmt_t fmt) const
-{
-  return (fmt == fastuidraw::gl::detail::GlyphAtlasGL::backing_uint32_fmt) ?
-    m_backing_store.texture() :
-    m_texture_fp16;
+  return m_texture_fp16;
 }
 
 void
@@ -420,7 +444,8 @@ gl_backing(enum fastuidraw::gl::detail::GlyphAtlasGL::backing_fmt_t) const
 // StoreGL methods
 fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlasBackingStoreBase>
 StoreGL::
-create(const fastuidraw::gl::PainterEngineGL::GlyphAtlasParams &P)
+create(const fastuidraw::gl::PainterEngineGL::GlyphAtlasParams &P,
+       const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker)
 {
   unsigned int number;
   StoreGL *p(nullptr);
@@ -439,7 +464,7 @@ create(const fastuidraw::gl::PainterEngineGL::GlyphAtlasParams &P)
 
     case fastuidraw::glsl::PainterShaderRegistrarGLSL::glyph_data_texture_array:
       p = FASTUIDRAWnew StoreGL_Texture(P.texture_2d_array_store_log2_dims(),
-                                        number);
+                                        number, worker);
       break;
 
     default:
@@ -451,8 +476,9 @@ create(const fastuidraw::gl::PainterEngineGL::GlyphAtlasParams &P)
 //////////////////////////////////////////////////////////////////
 // fastuidraw::gl::detail::GlyphAtlasGL methods
 fastuidraw::gl::detail::GlyphAtlasGL::
-GlyphAtlasGL(const PainterEngineGL::GlyphAtlasParams &P):
-  GlyphAtlas(StoreGL::create(P))
+GlyphAtlasGL(const PainterEngineGL::GlyphAtlasParams &P,
+             const reference_counted_ptr<ContextWorkerGL> &worker):
+  GlyphAtlas(StoreGL::create(P, worker))
 {
 }
 
@@ -23,6 +23,7 @@
 #include <fastuidraw/glsl/painter_shader_registrar_glsl.hpp>
 #include <fastuidraw/gl_backend/painter_engine_gl.hpp>
 #include <fastuidraw/gl_backend/gl_header.hpp>
+#include <private/gl_backend/context_worker_gl.hpp>
 
 namespace fastuidraw
 {
@@ -39,7 +40,10 @@ namespace detail
    * A GlyphAtlasGL on creation, creates an object derived from \ref
    * GlyphAtlasBackingStoreBase.
    *
-   * The method flush() must be called with a GL context current.
+   * The method flush() must be called with a GL context current
+   * unless the GlyphAtlasGL is given a ContextWorkerGL and the
+   * backing store is a texture, in which case flush() hands the
+   * uploads to the worker.
    */
   class GlyphAtlasGL:public GlyphAtlas
   {
@@ -66,9 +70,13 @@ namespace detail
     /*!
      * Ctor.
      * \param P parameters for constrution
+     * \param worker if non-null, worker that performs the GL
+     *               work of a backing store that is a texture
      */
     explicit
-    GlyphAtlasGL(const PainterEngineGL::GlyphAtlasParams &P);
+    GlyphAtlasGL(const PainterEngineGL::GlyphAtlasParams &P,
+                 const reference_counted_ptr<ContextWorkerGL> &worker
+                 = reference_counted_ptr<ContextWorkerGL>());
 
     ~GlyphAtlasGL();
 
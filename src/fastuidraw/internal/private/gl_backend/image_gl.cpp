@@ -68,7 +68,10 @@ namespace
   class ColorBackingStoreGL:public fastuidraw::AtlasColorBackingStoreBase
   {
   public:
-    ColorBackingStoreGL(int log2_tile_size, int log2_num_tiles_per_row_per_col, int number_layers);
+    /* num_channels is 4, 2 or 1 for GL_RGBA8, GL_RG8 or GL_R8 */
+    ColorBackingStoreGL(int log2_tile_size, int log2_num_tiles_per_row_per_col, int number_layers,
+                        unsigned int num_channels,
+                        const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker);
     ~ColorBackingStoreGL() {}
 
     virtual
@@ -84,13 +87,22 @@ namespace
     void
     flush(void)
     {
-      m_backing_store.flush();
+      /* a GL texture cannot have zero layers, the stores
+       * for one and two channel images start empty and
+       * are only backed by a texture once they are used.
+       */
+      if (dimensions().z() > 0)
+        {
+          m_backing_store.flush();
+        }
     }
 
     GLuint
     texture(void) const
     {
-      return m_backing_store.texture();
+      return (dimensions().z() > 0) ?
+        m_backing_store.texture() :
+        0u;
     }
 
     static
@@ -99,7 +111,9 @@ namespace
 
     static
     fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase>
-    create(int log2_tile_size, int log2_num_tiles_per_row_per_col, int num_layers)
+    create(int log2_tile_size, int log2_num_tiles_per_row_per_col, int num_layers,
+           unsigned int num_channels,
+           const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker)
     {
       if (log2_tile_size < 0 || log2_num_tiles_per_row_per_col < 0)
         {
@@ -107,7 +121,8 @@ namespace
         }
 
       ColorBackingStoreGL *p;
-      p = FASTUIDRAWnew ColorBackingStoreGL(log2_tile_size, log2_num_tiles_per_row_per_col, num_layers);
+      p = FASTUIDRAWnew ColorBackingStoreGL(log2_tile_size, log2_num_tiles_per_row_per_col,
+                                           num_layers, num_channels, worker);
       return fastuidraw::reference_counted_ptr<fastuidraw::AtlasColorBackingStoreBase>(p);
     }
 
@@ -122,7 +137,21 @@ namespace
     }
 
   private:
-    typedef Texture<GL_RGBA8, GL_RGBA, GL_LINEAR, GL_LINEAR_MIPMAP_NEAREST>::type TextureGL;
+    typedef fastuidraw::gl::detail::TextureGLGeneric<GL_TEXTURE_2D_ARRAY> TextureGL;
+
+    static
+    GLenum
+    internal_format(unsigned int num_channels);
+
+    static
+    GLenum
+    external_format(unsigned int num_channels);
+
+    void
+    upload(int mipmap_level, fastuidraw::ivec2 dst_xy, int dst_l, unsigned int size,
+           fastuidraw::c_array<const fastuidraw::u8vec4> texels);
+
+    unsigned int m_num_channels;
     TextureGL m_backing_store;
   };
 
@@ -131,7 +160,8 @@ namespace
   public:
     IndexBackingStoreGL(int log2_tile_size,
                         int log2_num_index_tiles_per_row_per_col,
-                        int num_layers);
+                        int num_layers,
+                        const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker);
 
     ~IndexBackingStoreGL()
     {}
@@ -165,7 +195,8 @@ namespace
     fastuidraw::reference_counted_ptr<fastuidraw::AtlasIndexBackingStoreBase>
     create(int log2_tile_size,
            int log2_num_index_tiles_per_row_per_col,
-           int num_layers)
+           int num_layers,
+           const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker)
     {
       if (log2_tile_size < 0 || log2_num_index_tiles_per_row_per_col < 0)
         {
@@ -175,7 +206,7 @@ namespace
       IndexBackingStoreGL *p;
       p = FASTUIDRAWnew IndexBackingStoreGL(log2_tile_size,
                                            log2_num_index_tiles_per_row_per_col,
-                                           num_layers);
+                                           num_layers, worker);
       return fastuidraw::reference_counted_ptr<fastuidraw::AtlasIndexBackingStoreBase>(p);
     }
 
@@ -210,30 +241,60 @@ namespace
 ColorBackingStoreGL::
 ColorBackingStoreGL(int log2_tile_size,
                     int log2_num_tiles_per_row_per_col,
-                    int number_layers):
+                    int number_layers,
+                    unsigned int num_channels,
+                    const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker):
   fastuidraw::AtlasColorBackingStoreBase(store_size(log2_tile_size, log2_num_tiles_per_row_per_col, number_layers),
                                          true),
-  m_backing_store(dimensions(), true, log2_tile_size)
-{}
+  m_num_channels(num_channels),
+  m_backing_store(internal_format(num_channels), external_format(num_channels),
+                  GL_UNSIGNED_BYTE, GL_LINEAR, GL_LINEAR_MIPMAP_NEAREST,
+                  dimensions(), true, log2_tile_size, worker, true)
+{
+  FASTUIDRAWassert(m_num_channels == 4 || m_num_channels == 2 || m_num_channels == 1);
+}
 
-void
+GLenum
 ColorBackingStoreGL::
-set_data(int mipmap_level, fastuidraw::ivec2 dst_xy, int dst_l, fastuidraw::ivec2 src_xy,
-         unsigned int size, const fastuidraw::ImageSourceBase &image_data)
+internal_format(unsigned int num_channels)
 {
-  using namespace fastuidraw;
+  switch (num_channels)
+    {
+    case 1:
+      return GL_R8;
+    case 2:
+      return GL_RG8;
+    default:
+      return GL_RGBA8;
+    }
+}
 
-  if (mipmap_level >= m_backing_store.num_mipmaps())
+GLenum
+ColorBackingStoreGL::
+external_format(unsigned int num_channels)
+{
+  switch (num_channels)
     {
-      return;
+    case 1:
+      return GL_RED;
+    case 2:
+      return GL_RG;
+    default:
+      return GL_RGBA;
     }
+}
+
+void
+ColorBackingStoreGL::
+upload(int mipmap_level, fastuidraw::ivec2 dst_xy, int dst_l, unsigned int size,
+       fastuidraw::c_array<const fastuidraw::u8vec4> texels)
+{
+  using namespace fastuidraw;
 
   TextureGL::EntryLocation V;
-  std::vector<u8vec4> data_storage(size * size);
-  fastuidraw::c_array<u8vec4> data(make_c_array(data_storage));
-  fastuidraw::c_array<const uint8_t> raw_data;
+  std::vector<uint8_t> packed;
+  c_array<const uint8_t> raw_data;
 
-  raw_data = data.reinterpret_pointer<const uint8_t>();
   V.m_mipmap_level = mipmap_level;
   V.m_location.x() = dst_xy.x();
   V.m_location.y() = dst_xy.y();
@@ -242,15 +303,32 @@ set_data(int mipmap_level, fastuidraw::ivec2 dst_xy, int dst_l, fastuidraw::ivec
   V.m_size.y() = size;
   V.m_size.z() = 1;
 
-  image_data.fetch_texels(V.m_mipmap_level, src_xy,
-                          V.m_size.x(), V.m_size.y(), data);
+  if (m_num_channels == 4)
+    {
+      raw_data = texels.reinterpret_pointer<const uint8_t>();
+    }
+  else
+    {
+      /* the stores with fewer channels hold only the
+       * leading channels of the texels.
+       */
+      packed.resize(m_num_channels * texels.size());
+      for (unsigned int i = 0, dst = 0; i < texels.size(); ++i)
+        {
+          for (unsigned int c = 0; c < m_num_channels; ++c, ++dst)
+            {
+              packed[dst] = texels[i][c];
+            }
+        }
+      raw_data = make_c_array(packed);
+    }
   m_backing_store.set_data_c_array(V, raw_data);
 }
 
 void
 ColorBackingStoreGL::
-set_data(int mipmap_level, fastuidraw::ivec2 dst_xy, int dst_l,
-         unsigned int size, fastuidraw::u8vec4 color_value)
+set_data(int mipmap_level, fastuidraw::ivec2 dst_xy, int dst_l, fastuidraw::ivec2 src_xy,
+         unsigned int size, const fastuidraw::ImageSourceBase &image_data)
 {
   using namespace fastuidraw;
 
@@ -259,21 +337,27 @@ set_data(int mipmap_level, fastuidraw::ivec2 dst_xy, int dst_l,
       return;
     }
 
-  TextureGL::EntryLocation V;
-  std::vector<u8vec4> data_storage(size * size, color_value);
+  std::vector<u8vec4> data_storage(size * size);
   fastuidraw::c_array<u8vec4> data(make_c_array(data_storage));
-  fastuidraw::c_array<const uint8_t> raw_data;
 
-  raw_data = data.reinterpret_pointer<const uint8_t>();
-  V.m_mipmap_level = mipmap_level;
-  V.m_location.x() = dst_xy.x();
-  V.m_location.y() = dst_xy.y();
-  V.m_location.z() = dst_l;
-  V.m_size.x() = size;
-  V.m_size.y() = size;
-  V.m_size.z() = 1;
+  image_data.fetch_texels(mipmap_level, src_xy, size, size, data);
+  upload(mipmap_level, dst_xy, dst_l, size, data);
+}
 
-  m_backing_store.set_data_c_array(V, raw_data);
+void
+ColorBackingStoreGL::
+set_data(int mipmap_level, fastuidraw::ivec2 dst_xy, int dst_l,
+         unsigned int size, fastuidraw::u8vec4 color_value)
+{
+  using namespace fastuidraw;
+
+  if (mipmap_level >= m_backing_store.num_mipmaps())
+    {
+      return;
+    }
+
+  std::vector<u8vec4> data_storage(size * size, color_value);
+  upload(mipmap_level, dst_xy, dst_l, size, make_c_array(data_storage));
 }
 
 fastuidraw::ivec3
@@ -293,12 +377,13 @@ store_size(int log2_tile_size, int log2_num_tiles_per_row_per_col, int num_layer
 IndexBackingStoreGL::
 IndexBackingStoreGL(int log2_tile_size,
                     int log2_num_index_tiles_per_row_per_col,
-                    int num_layers):
+                    int num_layers,
+                    const fastuidraw::reference_counted_ptr<fastuidraw::gl::detail::ContextWorkerGL> &worker):
   fastuidraw::AtlasIndexBackingStoreBase(store_size(log2_tile_size,
                                                     log2_num_index_tiles_per_row_per_col,
                                                     num_layers),
                                          true),
-  m_backing_store(dimensions(), true)
+  m_backing_store(dimensions(), true, 1, worker, true)
 {}
 
 void
@@ -348,15 +433,25 @@ store_size(int log2_tile_size, int log2_num_index_tiles_per_row_per_col, int num
 //////////////////////////////////////////////
 // fastuidraw::gl::detail::ImageAtlasGL methods
 fastuidraw::gl::detail::ImageAtlasGL::
-ImageAtlasGL(const PainterEngineGL::ImageAtlasParams &P):
+ImageAtlasGL(const PainterEngineGL::ImageAtlasParams &P,
+             const reference_counted_ptr<ContextWorkerGL> &worker):
   fastuidraw::ImageAtlas(compute_color_tile_size(P),
                          compute_index_tile_size(P),
                          ColorBackingStoreGL::create(P.log2_color_tile_size(),
                                                      P.log2_num_color_tiles_per_row_per_col(),
-                                                     P.num_color_layers()),
+                                                     P.num_color_layers(), 4, worker),
                          IndexBackingStoreGL::create(P.log2_index_tile_size(),
                                                      P.log2_num_index_tiles_per_row_per_col(),
-                                                     P.num_index_layers()))
+                                                     P.num_index_layers(), worker),
+                         /* the one and two channel stores start empty
+                          * and grow as images of those formats are added
+                          */
+                         ColorBackingStoreGL::create(P.log2_color_tile_size(),
+                                                     P.log2_num_color_tiles_per_row_per_col(),
+                                                     0, 1, worker),
+                         ColorBackingStoreGL::create(P.log2_color_tile_size(),
+                                                     P.log2_num_color_tiles_per_row_per_col(),
+                                                     0, 2, worker))
 {
 }
 
@@ -367,12 +462,12 @@ fastuidraw::gl::detail::ImageAtlasGL::
 
 GLuint
 fastuidraw::gl::detail::ImageAtlasGL::
-color_texture(void) const
+color_texture(enum color_store_t C) const
 {
   flush();
   const ColorBackingStoreGL *p;
-  FASTUIDRAWassert(!color_store() || dynamic_cast<const ColorBackingStoreGL*>(color_store().get()));
-  p = static_cast<const ColorBackingStoreGL*>(color_store().get());
+  FASTUIDRAWassert(!color_store(C) || dynamic_cast<const ColorBackingStoreGL*>(color_store(C).get()));
+  p = static_cast<const ColorBackingStoreGL*>(color_store(C).get());
   return (p) ? p->texture() : 0u;
 }
 
@@ -22,6 +22,7 @@
 #include <fastuidraw/image.hpp>
 #include <fastuidraw/gl_backend/gl_header.hpp>
 #include <fastuidraw/gl_backend/painter_engine_gl.hpp>
+#include <private/gl_backend/context_worker_gl.hpp>
 
 
 namespace fastuidraw
@@ -36,13 +37,16 @@ namespace detail
    * An ImageAtlasGL is the GL(and GLES) backend implementation
    * for \ref ImageAtlas.
    *
-   * An ImageAtlasGL on creation, creates an
-   * \ref AtlasColorBackingStoreBase and an \ref AtlasIndexBackingStoreBase
-   * itself that are backed by GL textures. Both of the backing
+   * An ImageAtlasGL on creation, creates the
+   * \ref AtlasColorBackingStoreBase objects (of formats GL_RGBA8,
+   * GL_R8 and GL_RG8) and an \ref AtlasIndexBackingStoreBase
+   * itself that are backed by GL textures. All of the backing
    * stores use GL_TEXTURE_2D_ARRAY textures. On deletion,
    * deletes the backing color and index stores.
    *
-   * The method flush() must be called with a GL context current.
+   * The method flush() must be called with a GL context current
+   * unless the ImageAtlasGL is given a ContextWorkerGL, in which
+   * case flush() hands the uploads to the worker.
    */
   class ImageAtlasGL:public ImageAtlas
   {
@@ -50,20 +54,28 @@ namespace detail
     /*!
      * Ctor.
      * \param P parameters for ImageAtlasGL
+     * \param worker if non-null, worker that performs the
+     *               GL work of the backing stores
      */
     explicit
-    ImageAtlasGL(const PainterEngineGL::ImageAtlasParams &P);
+    ImageAtlasGL(const PainterEngineGL::ImageAtlasParams &P,
+                 const reference_counted_ptr<ContextWorkerGL> &worker
+                 = reference_counted_ptr<ContextWorkerGL>());
 
     ~ImageAtlasGL(void);
 
     /*!
-     * Returns the GL texture ID of the AtlasColorBackingStoreBase
+     * Returns the GL texture ID of an AtlasColorBackingStoreBase
      * derived object used by this ImageAtlasGL. A GL context must
      * be current (and that GL context is the context to which the
-     * texture will belong).
+     * texture will belong). Returns 0 if the store has no layers
+     * yet, which is the case for the \ref ImageAtlas::r8_color_store
+     * and \ref ImageAtlas::rg8_color_store until an image needing
+     * them is added.
+     * \param C which color store
      */
     GLuint
-    color_texture(void) const;
+    color_texture(enum color_store_t C = rgba8_color_store) const;
 
     /*!
      * Returns the GL texture ID of the AtlasIndexBackingStoreBase
@@ -23,6 +23,7 @@
 #include <vector>
 #include <iostream>
 
+#include <fastuidraw/util/trace_events.hpp>
 #include <private/util_private.hpp>
 #include <private/util_private_ostream.hpp>
 #include <private/gl_backend/painter_backend_gl.hpp>
@@ -61,6 +62,21 @@ namespace
     }
   };
 
+  /* Layout of a DrawElementsIndirectCommand, the
+   * values read by glMultiDrawElementsIndirect
+   * for each draw.
+   */
+  enum indirect_command_layout_t
+    {
+      indirect_count,
+      indirect_instance_count,
+      indirect_first_index,
+      indirect_base_vertex,
+      indirect_base_instance,
+
+      indirect_command_size
+    };
+
   class SurfacePropertiesPrivate
   {
   public:
@@ -184,6 +200,13 @@ public:
   void
   add_entry(GLsizei count, const void *offset);
 
+  /* Append the indirect draw commands of this entry to
+   * dst, skipping those draws with no indices, and record
+   * where they start in dst.
+   */
+  void
+  add_indirect_commands(std::vector<GLuint> &dst);
+
   void
   draw(fastuidraw::gl::detail::PainterBackendGL *pr,
        const fastuidraw::gl::detail::painter_vao &vao,
@@ -198,6 +221,8 @@ private:
   std::vector<const GLvoid*> m_indices;
   fastuidraw::gl::Program *m_new_program;
   enum fastuidraw::PainterBlendShader::shader_type m_blend_type;
+
+  unsigned int m_indirect_first, m_indirect_count;
 };
 
 class fastuidraw::gl::detail::PainterBackendGL::DrawCommand:
@@ -258,7 +283,9 @@ DrawEntry(const BlendMode &mode,
   m_set_blend(true),
   m_blend_mode(mode),
   m_new_program(new_program),
-  m_blend_type(blend_type)
+  m_blend_type(blend_type),
+  m_indirect_first(0),
+  m_indirect_count(0)
 {
 }
 
@@ -267,7 +294,9 @@ DrawEntry(const BlendMode &mode):
   m_set_blend(true),
   m_blend_mode(mode),
   m_new_program(nullptr),
-  m_blend_type(PainterBlendShader::number_types)
+  m_blend_type(PainterBlendShader::number_types),
+  m_indirect_first(0),
+  m_indirect_count(0)
 {
 }
 
@@ -276,7 +305,9 @@ DrawEntry(const reference_counted_ptr<const PainterDrawBreakAction> &action):
   m_set_blend(false),
   m_action(action),
   m_new_program(nullptr),
-  m_blend_type(PainterBlendShader::number_types)
+  m_blend_type(PainterBlendShader::number_types),
+  m_indirect_first(0),
+  m_indirect_count(0)
 {
 }
 
@@ -288,6 +319,38 @@ add_entry(GLsizei count, const void *offset)
   m_indices.push_back(offset);
 }
 
+void
+fastuidraw::gl::detail::PainterBackendGL::DrawEntry::
+add_indirect_commands(std::vector<GLuint> &dst)
+{
+  FASTUIDRAWassert(m_counts.size() == m_indices.size());
+  FASTUIDRAWassert(dst.size() % indirect_command_size == 0);
+
+  m_indirect_first = dst.size() / indirect_command_size;
+  m_indirect_count = 0;
+  for (unsigned int i = 0, endi = m_counts.size(); i < endi; ++i)
+    {
+      uintptr_t offset_bytes;
+
+      if (m_counts[i] == 0)
+        {
+          continue;
+        }
+
+      offset_bytes = reinterpret_cast<uintptr_t>(m_indices[i]);
+      FASTUIDRAWassert(offset_bytes % sizeof(PainterIndex) == 0);
+
+      dst.resize(dst.size() + indirect_command_size);
+      c_array<GLuint> cmd(&dst[dst.size() - indirect_command_size], indirect_command_size);
+      cmd[indirect_count] = m_counts[i];
+      cmd[indirect_instance_count] = 1;
+      cmd[indirect_first_index] = offset_bytes / sizeof(PainterIndex);
+      cmd[indirect_base_vertex] = 0;
+      cmd[indirect_base_instance] = 0;
+      ++m_indirect_count;
+    }
+}
+
 void
 fastuidraw::gl::detail::PainterBackendGL::DrawEntry::
 draw(fastuidraw::gl::detail::PainterBackendGL *pr,
@@ -298,13 +361,20 @@ draw(fastuidraw::gl::detail::PainterBackendGL *pr,
 
   if (m_action)
     {
+      gpu_dirty_state action_flags;
+
       /* Rather than having something delicate to restore
        * the currently bound VAO, instead we unbind it
-       * and rebind it after the action.
+       * and rebind it after the action. The action may
+       * change GL state without going through the state
+       * cache, so the cache forgets whatever the action
+       * reports as changed.
        */
-      fastuidraw_glBindVertexArray(0);
-      flags |= m_action->execute(pr);
-      fastuidraw_glBindVertexArray(vao.m_vao);
+      pr->m_gl_state.bind_vertex_array(0);
+      action_flags = m_action->execute(pr);
+      pr->m_gl_state.invalidate(action_flags);
+      pr->m_gl_state.bind_vertex_array(vao.m_vao);
+      flags |= action_flags;
     }
 
   if (m_set_blend)
@@ -334,6 +404,36 @@ draw(fastuidraw::gl::detail::PainterBackendGL *pr,
 
   FASTUIDRAWassert(m_counts.size() == m_indices.size());
 
+  if (vao.m_indirect_bo != 0)
+    {
+      /* the draw commands were written to vao.m_indirect_bo,
+       * which is bound to GL_DRAW_INDIRECT_BUFFER, when the
+       * PainterDraw was unmapped.
+       */
+      const GLvoid *offset;
+
+      if (m_indirect_count == 0)
+        {
+          return;
+        }
+
+      offset = reinterpret_cast<const GLvoid*>(m_indirect_first * indirect_command_size * sizeof(GLuint));
+      #ifndef FASTUIDRAW_GL_USE_GLES
+        {
+          fastuidraw_glMultiDrawElementsIndirect(GL_TRIANGLES,
+                                                 opengl_trait<PainterIndex>::type,
+                                                 offset, m_indirect_count, 0);
+        }
+      #else
+        {
+          fastuidraw_glMultiDrawElementsIndirectEXT(GL_TRIANGLES,
+                                                    opengl_trait<PainterIndex>::type,
+                                                    offset, m_indirect_count, 0);
+        }
+      #endif
+      return;
+    }
+
   #ifndef FASTUIDRAW_GL_USE_GLES
     {
       fastuidraw_glMultiDrawElements(GL_TRIANGLES, &m_counts[0],
@@ -514,25 +614,27 @@ void
 fastuidraw::gl::detail::PainterBackendGL::DrawCommand::
 draw(void) const
 {
-  fastuidraw_glBindVertexArray(m_vao.m_vao);
+  TraceEvents::Scope trace("PainterBackendGL", "draw");
+  GLStateCache &gl_state(m_pr->m_gl_state);
+
+  gl_state.bind_vertex_array(m_vao.m_vao);
   switch(m_vao.m_data_store_backing)
     {
     case PainterEngineGL::data_store_tbo:
       {
-        fastuidraw_glActiveTexture(GL_TEXTURE0 + m_vao.m_data_store_binding_point);
-        fastuidraw_glBindTexture(GL_TEXTURE_BUFFER, m_vao.m_data_tbo);
+        gl_state.bind_texture(m_vao.m_data_store_binding_point, GL_TEXTURE_BUFFER, m_vao.m_data_tbo);
       }
       break;
 
     case PainterEngineGL::data_store_ubo:
       {
-        fastuidraw_glBindBufferBase(GL_UNIFORM_BUFFER, m_vao.m_data_store_binding_point, m_vao.m_data_bo);
+        gl_state.bind_buffer_base(GL_UNIFORM_BUFFER, m_vao.m_data_store_binding_point, m_vao.m_data_bo);
       }
       break;
 
     case PainterEngineGL::data_store_ssbo:
       {
-        fastuidraw_glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_vao.m_data_store_binding_point, m_vao.m_data_bo);
+        gl_state.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, m_vao.m_data_store_binding_point, m_vao.m_data_bo);
       }
       break;
 
@@ -540,11 +642,25 @@ draw(void) const
       FASTUIDRAWassert(!"Bad value for m_vao.m_data_store_backing");
     }
 
+  if (m_vao.m_indirect_bo != 0)
+    {
+      fastuidraw_glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_vao.m_indirect_bo);
+    }
+
   for(const DrawEntry &entry : m_draws)
     {
       entry.draw(m_pr, m_vao, m_pr->m_draw_state);
     }
-  fastuidraw_glBindVertexArray(0);
+
+  if (m_vao.m_indirect_bo != 0)
+    {
+      fastuidraw_glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+  /* unbind the VAO so that mapping the buffers of
+   * PainterDraw objects does not modify it.
+   */
+  gl_state.bind_vertex_array(0);
 }
 
 void
@@ -572,6 +688,31 @@ unmap_implement(unsigned int attributes_written,
   fastuidraw_glBindBuffer(GL_ARRAY_BUFFER, m_vao.m_data_bo);
   fastuidraw_glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, data_store_written * sizeof(generic_data));
   fastuidraw_glUnmapBuffer(GL_ARRAY_BUFFER);
+
+  if (m_vao.m_indirect_bo != 0)
+    {
+      std::vector<GLuint> &commands(m_pr->m_indirect_commands);
+
+      /* The draw list is complete, write all of it to the
+       * indirect buffer with a single upload. Specifying
+       * the store anew with glBufferData lets the driver
+       * orphan the storage of a previous use of the buffer
+       * that may still be in flight.
+       */
+      commands.clear();
+      for (DrawEntry &entry : m_draws)
+        {
+          entry.add_indirect_commands(commands);
+        }
+
+      if (!commands.empty())
+        {
+          fastuidraw_glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_vao.m_indirect_bo);
+          fastuidraw_glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(GLuint),
+                                  &commands[0], GL_STREAM_DRAW);
+          fastuidraw_glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+    }
 }
 
 void
@@ -611,15 +752,20 @@ fastuidraw::gpu_dirty_state
 fastuidraw::gl::detail::PainterBackendGL::TextureImageBindAction::
 execute(fastuidraw::PainterBackend*) const
 {
-  fastuidraw_glActiveTexture(GL_TEXTURE0 + m_texture_unit);
-  fastuidraw_glBindTexture(GL_TEXTURE_2D, m_image->texture());
+  GLuint texture(m_image->texture());
+
+  /* fetching the texture may create it, changing the
+   * binding of the active texture unit.
+   */
+  m_p->m_gl_state.invalidate_active_texture_unit();
+  m_p->m_gl_state.bind_texture(m_texture_unit, GL_TEXTURE_2D, texture);
 
   /* if the user makes an action that affects texture
    * unit m_texture_unit, we need to give the backend
    * the knowledge of what is the external texture
    * so that it an correctly restore its state.
    */
-  m_p->m_current_external_texture[m_slot] = m_image->texture();
+  m_p->m_current_external_texture[m_slot] = texture;
 
   /* we do not regard changing the texture unit
    * as changing the GPU texture state because the
@@ -646,15 +792,17 @@ fastuidraw::gpu_dirty_state
 fastuidraw::gl::detail::PainterBackendGL::CoverageTextureBindAction::
 execute(fastuidraw::PainterBackend*) const
 {
-  fastuidraw_glActiveTexture(GL_TEXTURE0 + m_texture_unit);
-  fastuidraw_glBindTexture(GL_TEXTURE_2D, m_image->texture());
+  GLuint texture(m_image->texture());
+
+  m_p->m_gl_state.invalidate_active_texture_unit();
+  m_p->m_gl_state.bind_texture(m_texture_unit, GL_TEXTURE_2D, texture);
 
   /* if the user makes an action that affects texture
    * unit m_texture_unit, we need to give the backend
    * the knowledge of what is the texture so that it an
    * correctly restore its state.
    */
-  m_p->m_current_coverage_buffer_texture = m_image->texture();
+  m_p->m_current_coverage_buffer_texture = texture;
 
   /* we do not regard changing the texture unit
    * as changing the GPU texture state because the
@@ -688,7 +836,7 @@ on_pre_draw(PainterBackendGL *pr, GLuint current_fbo)
   RenderTargetState R;
   R.m_fbo = current_fbo;
   m_current_render_target_state = pr->set_gl_state(R, m_blend_type, gpu_dirty_state::all);
-  m_current_program->use_program();
+  pr->m_gl_state.use_program(m_current_program->name());
   m_current_blend_mode = nullptr;
 }
 
@@ -698,11 +846,13 @@ restore_gl_state(const fastuidraw::gl::detail::painter_vao &vao,
                  PainterBackendGL *pr,
                  fastuidraw::gpu_dirty_state flags)
 {
+  GLStateCache &gl_state(pr->m_gl_state);
+
   m_current_render_target_state = pr->set_gl_state(m_current_render_target_state, m_blend_type, flags);
   if (flags & gpu_dirty_state::shader)
     {
       FASTUIDRAWassert(m_current_program);
-      m_current_program->use_program();
+      gl_state.use_program(m_current_program->name());
     }
 
   /* If necessary, restore the UBO or TBO assoicated to the data
@@ -713,22 +863,21 @@ restore_gl_state(const fastuidraw::gl::detail::painter_vao &vao,
     case PainterEngineGL::data_store_tbo:
       if (flags & gpu_dirty_state::textures)
         {
-          fastuidraw_glActiveTexture(GL_TEXTURE0 + vao.m_data_store_binding_point);
-          fastuidraw_glBindTexture(GL_TEXTURE_BUFFER, vao.m_data_tbo);
+          gl_state.bind_texture(vao.m_data_store_binding_point, GL_TEXTURE_BUFFER, vao.m_data_tbo);
         }
       break;
 
     case PainterEngineGL::data_store_ubo:
       if (flags & gpu_dirty_state::constant_buffers)
         {
-          fastuidraw_glBindBufferBase(GL_UNIFORM_BUFFER, vao.m_data_store_binding_point, vao.m_data_bo);
+          gl_state.bind_buffer_base(GL_UNIFORM_BUFFER, vao.m_data_store_binding_point, vao.m_data_bo);
         }
       break;
 
     case PainterEngineGL::data_store_ssbo:
       if (flags & gpu_dirty_state::storage_buffers)
         {
-          fastuidraw_glBindBufferBase(GL_SHADER_STORAGE_BUFFER, vao.m_data_store_binding_point, vao.m_data_bo);
+          gl_state.bind_buffer_base(GL_SHADER_STORAGE_BUFFER, vao.m_data_store_binding_point, vao.m_data_bo);
         }
       break;
 
@@ -740,19 +889,15 @@ restore_gl_state(const fastuidraw::gl::detail::painter_vao &vao,
     {
       FASTUIDRAWassert(m_current_blend_mode);
       FASTUIDRAWassert(m_current_blend_mode->is_valid());
+      gl_state.enable(GL_BLEND, m_current_blend_mode->blending_on());
       if (m_current_blend_mode->blending_on())
         {
-          fastuidraw_glEnable(GL_BLEND);
-          fastuidraw_glBlendEquationSeparate(convert_blend_op(m_current_blend_mode->equation_rgb()),
-                                             convert_blend_op(m_current_blend_mode->equation_alpha()));
-          fastuidraw_glBlendFuncSeparate(convert_blend_func(m_current_blend_mode->func_src_rgb()),
-                                         convert_blend_func(m_current_blend_mode->func_dst_rgb()),
-                                         convert_blend_func(m_current_blend_mode->func_src_alpha()),
-                                         convert_blend_func(m_current_blend_mode->func_dst_alpha()));
-        }
-      else
-        {
-          fastuidraw_glDisable(GL_BLEND);
+          gl_state.blend_equation(convert_blend_op(m_current_blend_mode->equation_rgb()),
+                                  convert_blend_op(m_current_blend_mode->equation_alpha()));
+          gl_state.blend_func(convert_blend_func(m_current_blend_mode->func_src_rgb()),
+                              convert_blend_func(m_current_blend_mode->func_dst_rgb()),
+                              convert_blend_func(m_current_blend_mode->func_src_alpha()),
+                              convert_blend_func(m_current_blend_mode->func_dst_alpha()));
         }
     }
 }
@@ -849,6 +994,8 @@ PainterBackendGL(const fastuidraw::gl::PainterEngineGL *f):
   m_binding_points.m_colorstop_atlas_binding = m_reg_gl->uber_shader_builder_params().colorstop_atlas_binding();
   m_binding_points.m_image_atlas_color_tiles_nearest_binding = m_reg_gl->uber_shader_builder_params().image_atlas_color_tiles_nearest_binding();
   m_binding_points.m_image_atlas_color_tiles_linear_binding = m_reg_gl->uber_shader_builder_params().image_atlas_color_tiles_linear_binding();
+  m_binding_points.m_image_atlas_color_tiles_r8_binding = m_reg_gl->uber_shader_builder_params().image_atlas_color_tiles_r8_binding();
+  m_binding_points.m_image_atlas_color_tiles_rg8_binding = m_reg_gl->uber_shader_builder_params().image_atlas_color_tiles_rg8_binding();
   m_binding_points.m_image_atlas_index_tiles_binding = m_reg_gl->uber_shader_builder_params().image_atlas_index_tiles_binding();
   m_binding_points.m_glyph_atlas_store_binding = m_reg_gl->uber_shader_builder_params().glyph_atlas_store_binding();
   m_binding_points.m_glyph_atlas_store_binding_fp16 = m_reg_gl->uber_shader_builder_params().glyph_atlas_store_binding_fp16x2();
@@ -902,8 +1049,7 @@ clear_buffers_of_current_surface(bool clear_depth, bool clear_color_buffer)
 
       fbo = m_surface_gl->fbo(true);
       draw_buffers = m_surface_gl->draw_buffers(true);
-      fastuidraw_glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo);
-      fastuidraw_glDrawBuffers(draw_buffers.size(), draw_buffers.c_ptr());
+      m_gl_state.bind_draw_framebuffer(fbo, draw_buffers);
 
       if (clear_depth)
         {
@@ -974,8 +1120,7 @@ set_gl_state(RenderTargetState prev_state,
       c_array<const GLenum> draw_buffers;
 
       draw_buffers = m_surface_gl->draw_buffers(!return_value.m_color_buffer_as_image);
-      fastuidraw_glBindFramebuffer(GL_DRAW_FRAMEBUFFER, return_value.m_fbo);
-      fastuidraw_glDrawBuffers(draw_buffers.size(), draw_buffers.c_ptr());
+      m_gl_state.bind_draw_framebuffer(return_value.m_fbo, draw_buffers);
       v |= gpu_dirty_state::viewport_scissor;
     }
 
@@ -1007,15 +1152,15 @@ set_gl_state(RenderTargetState prev_state,
 
   if (v & gpu_dirty_state::depth_stencil)
     {
-      fastuidraw_glEnable(GL_DEPTH_TEST);
-      fastuidraw_glDepthFunc(GL_GEQUAL);
-      fastuidraw_glDisable(GL_STENCIL_TEST);
+      m_gl_state.enable(GL_DEPTH_TEST, true);
+      m_gl_state.depth_func(GL_GEQUAL);
+      m_gl_state.enable(GL_STENCIL_TEST, false);
     }
 
   if (v & gpu_dirty_state::buffer_masks)
     {
-      fastuidraw_glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-      fastuidraw_glDepthMask(GL_TRUE);
+      m_gl_state.color_mask(true, true, true, true);
+      m_gl_state.depth_mask(true);
     }
 
   if (v & gpu_dirty_state::viewport_scissor)
@@ -1025,81 +1170,96 @@ set_gl_state(RenderTargetState prev_state,
           || vwp.m_origin.x() != 0
           || vwp.m_origin.y() != 0)
         {
-          fastuidraw_glEnable(GL_SCISSOR_TEST);
-          fastuidraw_glScissor(vwp.m_origin.x(), vwp.m_origin.y(),
-                               vwp.m_dimensions.x(), vwp.m_dimensions.y());
+          m_gl_state.enable(GL_SCISSOR_TEST, true);
+          m_gl_state.scissor(vwp.m_origin.x(), vwp.m_origin.y(),
+                             vwp.m_dimensions.x(), vwp.m_dimensions.y());
         }
       else
         {
-          fastuidraw_glDisable(GL_SCISSOR_TEST);
+          m_gl_state.enable(GL_SCISSOR_TEST, false);
         }
 
-      fastuidraw_glViewport(vwp.m_origin.x(), vwp.m_origin.y(),
-                            vwp.m_dimensions.x(), vwp.m_dimensions.y());
+      m_gl_state.viewport(vwp.m_origin.x(), vwp.m_origin.y(),
+                          vwp.m_dimensions.x(), vwp.m_dimensions.y());
     }
 
   if ((v & gpu_dirty_state::hw_clip) && m_reg_gl->number_clip_planes() > 0)
     {
-      if (m_reg_gl->params().clipping_type() == PainterEngineGL::clipping_via_gl_clip_distance)
+      bool use_clip_distance;
+
+      use_clip_distance = (m_reg_gl->params().clipping_type() == PainterEngineGL::clipping_via_gl_clip_distance);
+      for (int i = 0; i < 4; ++i)
         {
-          for (int i = 0; i < 4; ++i)
-            {
-              fastuidraw_glEnable(GL_CLIP_DISTANCE0 + i);
-            }
-        }
-      else
-        {
-          for (int i = 0; i < 4; ++i)
-            {
-              fastuidraw_glDisable(GL_CLIP_DISTANCE0 + i);
-            }
+          m_gl_state.enable(GL_CLIP_DISTANCE0 + i, use_clip_distance);
         }
 
       for(unsigned int i = 4; i < m_reg_gl->number_clip_planes(); ++i)
         {
-          fastuidraw_glDisable(GL_CLIP_DISTANCE0 + i);
+          m_gl_state.enable(GL_CLIP_DISTANCE0 + i, false);
         }
     }
 
   if (v & gpu_dirty_state::textures)
     {
-      fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_image_atlas_color_tiles_nearest_binding);
-      fastuidraw_glBindSampler(m_binding_points.m_image_atlas_color_tiles_nearest_binding, m_nearest_filter_sampler);
-      fastuidraw_glBindTexture(GL_TEXTURE_2D_ARRAY, m_image_atlas->color_texture());
+      GLuint color_texture, r8_texture, rg8_texture, index_texture;
+      GLuint glyph_texture(0), glyph_texture_fp16(0), colorstop_texture;
 
-      fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_image_atlas_color_tiles_linear_binding);
-      fastuidraw_glBindSampler(m_binding_points.m_image_atlas_color_tiles_linear_binding, 0);
-      fastuidraw_glBindTexture(GL_TEXTURE_2D_ARRAY, m_image_atlas->color_texture());
+      /* Fetching the backing textures of the atlases flushes
+       * their pending uploads which changes the binding of
+       * the active texture unit behind the back of m_gl_state.
+       */
+      color_texture = m_image_atlas->color_texture();
+      r8_texture = m_image_atlas->color_texture(ImageAtlas::r8_color_store);
+      rg8_texture = m_image_atlas->color_texture(ImageAtlas::rg8_color_store);
+      index_texture = m_image_atlas->index_texture();
+      if (m_glyph_atlas->data_binding_point_is_texture_unit())
+        {
+          glyph_texture = m_glyph_atlas->data_backing(GlyphAtlasGL::backing_uint32_fmt);
+          glyph_texture_fp16 = m_glyph_atlas->data_backing(GlyphAtlasGL::backing_fp16x2_fmt);
+        }
+      colorstop_texture = m_colorstop_atlas->texture();
+      m_gl_state.invalidate_active_texture_unit();
 
-      fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_image_atlas_index_tiles_binding);
-      fastuidraw_glBindSampler(m_binding_points.m_image_atlas_index_tiles_binding, 0);
-      fastuidraw_glBindTexture(GL_TEXTURE_2D_ARRAY, m_image_atlas->index_texture());
+      m_gl_state.bind_sampler(m_binding_points.m_image_atlas_color_tiles_nearest_binding, m_nearest_filter_sampler);
+      m_gl_state.bind_texture(m_binding_points.m_image_atlas_color_tiles_nearest_binding, GL_TEXTURE_2D_ARRAY, color_texture);
+
+      m_gl_state.bind_sampler(m_binding_points.m_image_atlas_color_tiles_linear_binding, 0);
+      m_gl_state.bind_texture(m_binding_points.m_image_atlas_color_tiles_linear_binding, GL_TEXTURE_2D_ARRAY, color_texture);
+
+      m_gl_state.bind_sampler(m_binding_points.m_image_atlas_color_tiles_r8_binding, 0);
+      m_gl_state.bind_texture(m_binding_points.m_image_atlas_color_tiles_r8_binding, GL_TEXTURE_2D_ARRAY, r8_texture);
+
+      m_gl_state.bind_sampler(m_binding_points.m_image_atlas_color_tiles_rg8_binding, 0);
+      m_gl_state.bind_texture(m_binding_points.m_image_atlas_color_tiles_rg8_binding, GL_TEXTURE_2D_ARRAY, rg8_texture);
+
+      m_gl_state.bind_sampler(m_binding_points.m_image_atlas_index_tiles_binding, 0);
+      m_gl_state.bind_texture(m_binding_points.m_image_atlas_index_tiles_binding, GL_TEXTURE_2D_ARRAY, index_texture);
 
       if (m_glyph_atlas->data_binding_point_is_texture_unit())
         {
-          fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_glyph_atlas_store_binding);
-          fastuidraw_glBindSampler(m_binding_points.m_glyph_atlas_store_binding, 0);
-          fastuidraw_glBindTexture(m_glyph_atlas->data_binding_point(), m_glyph_atlas->data_backing(GlyphAtlasGL::backing_uint32_fmt));
+          m_gl_state.bind_sampler(m_binding_points.m_glyph_atlas_store_binding, 0);
+          m_gl_state.bind_texture(m_binding_points.m_glyph_atlas_store_binding,
+                                  m_glyph_atlas->data_binding_point(), glyph_texture);
 
-          fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_glyph_atlas_store_binding_fp16);
-          fastuidraw_glBindSampler(m_binding_points.m_glyph_atlas_store_binding_fp16, 0);
-          fastuidraw_glBindTexture(m_glyph_atlas->data_binding_point(), m_glyph_atlas->data_backing(GlyphAtlasGL::backing_fp16x2_fmt));
+          m_gl_state.bind_sampler(m_binding_points.m_glyph_atlas_store_binding_fp16, 0);
+          m_gl_state.bind_texture(m_binding_points.m_glyph_atlas_store_binding_fp16,
+                                  m_glyph_atlas->data_binding_point(), glyph_texture_fp16);
         }
 
-      fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_colorstop_atlas_binding);
-      fastuidraw_glBindSampler(m_binding_points.m_colorstop_atlas_binding, 0);
-      fastuidraw_glBindTexture(ColorStopAtlasGL::texture_bind_target(), m_colorstop_atlas->texture());
+      m_gl_state.bind_sampler(m_binding_points.m_colorstop_atlas_binding, 0);
+      m_gl_state.bind_texture(m_binding_points.m_colorstop_atlas_binding,
+                              ColorStopAtlasGL::texture_bind_target(), colorstop_texture);
 
       for (unsigned int i = 0, endi = m_current_external_texture.size(); i < endi; ++i)
         {
-          fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_external_texture_binding + i);
-          fastuidraw_glBindTexture(GL_TEXTURE_2D, m_current_external_texture[i]);
-          fastuidraw_glBindSampler(m_binding_points.m_external_texture_binding + i, 0);
+          m_gl_state.bind_texture(m_binding_points.m_external_texture_binding + i,
+                                  GL_TEXTURE_2D, m_current_external_texture[i]);
+          m_gl_state.bind_sampler(m_binding_points.m_external_texture_binding + i, 0);
         }
 
-      fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_coverage_buffer_texture_binding);
-      fastuidraw_glBindTexture(GL_TEXTURE_2D, m_current_coverage_buffer_texture);
-      fastuidraw_glBindSampler(m_binding_points.m_coverage_buffer_texture_binding, 0);
+      m_gl_state.bind_texture(m_binding_points.m_coverage_buffer_texture_binding,
+                              GL_TEXTURE_2D, m_current_coverage_buffer_texture);
+      m_gl_state.bind_sampler(m_binding_points.m_coverage_buffer_texture_binding, 0);
 
       /* QUESTION: should we restore the bindings of all of the externals? */
     }
@@ -1130,16 +1290,19 @@ set_gl_state(RenderTargetState prev_state,
           m_uniform_ubo_ready = true;
         }
 
-      fastuidraw_glBindBufferBase(GL_UNIFORM_BUFFER, m_binding_points.m_uniforms_ubo_binding, ubo);
+      m_gl_state.bind_buffer_base(GL_UNIFORM_BUFFER, m_binding_points.m_uniforms_ubo_binding, ubo);
     }
 
   if (v & gpu_dirty_state::storage_buffers)
     {
       if (!m_glyph_atlas->data_binding_point_is_texture_unit())
         {
-          fastuidraw_glBindBufferBase(GL_SHADER_STORAGE_BUFFER,
+          GLuint glyph_buffer;
+
+          glyph_buffer = m_glyph_atlas->data_backing(GlyphAtlasGL::backing_uint32_fmt);
+          m_gl_state.bind_buffer_base(GL_SHADER_STORAGE_BUFFER,
                                       m_binding_points.m_glyph_atlas_store_binding,
-                                      m_glyph_atlas->data_backing(GlyphAtlasGL::backing_uint32_fmt));
+                                      glyph_buffer);
         }
     }
 
@@ -1166,6 +1329,7 @@ on_pre_draw(const reference_counted_ptr<PainterSurface> &surface,
             bool clear_color_buffer,
             bool begin_new_target)
 {
+  TraceEvents::Scope trace("PainterBackendGL", "on_pre_draw");
   m_surface_gl = static_cast<detail::PainterSurfaceGLPrivate*>(detail::PainterSurfaceGLPrivate::surface_gl(surface)->opaque_data());
 
   if (m_nearest_filter_sampler == 0)
@@ -1178,6 +1342,11 @@ on_pre_draw(const reference_counted_ptr<PainterSurface> &surface,
 
   GLuint fbo;
 
+  /* GL state may have been changed arbitrarily since the
+   * last time this backend drew, so nothing in the cache
+   * can be trusted.
+   */
+  m_gl_state.invalidate(gpu_dirty_state::all);
   m_uniform_ubo_ready = false;
   std::fill(m_current_external_texture.begin(), m_current_external_texture.end(), 0);
   m_current_coverage_buffer_texture = 0;
@@ -1189,6 +1358,8 @@ void
 fastuidraw::gl::detail::PainterBackendGL::
 on_post_draw(void)
 {
+  TraceEvents::Scope trace("PainterBackendGL", "on_post_draw");
+
   /* this is somewhat paranoid to make sure that
    * the GL objects do not leak...
    */
@@ -1204,6 +1375,12 @@ on_post_draw(void)
   fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_image_atlas_color_tiles_linear_binding);
   fastuidraw_glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
+  fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_image_atlas_color_tiles_r8_binding);
+  fastuidraw_glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+  fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_image_atlas_color_tiles_rg8_binding);
+  fastuidraw_glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
   fastuidraw_glActiveTexture(GL_TEXTURE0 + m_binding_points.m_image_atlas_index_tiles_binding);
   fastuidraw_glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
@@ -1255,6 +1432,7 @@ on_post_draw(void)
   fastuidraw_glBindBufferBase(GL_UNIFORM_BUFFER, m_binding_points.m_uniforms_ubo_binding, 0);
   fastuidraw_glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
   fastuidraw_glDisable(GL_SCISSOR_TEST);
+  m_gl_state.invalidate(gpu_dirty_state::all);
   m_pool->next_pool();
 }
 
@@ -1298,5 +1476,14 @@ on_painter_begin(void)
     {
       m_cached_item_programs->reset();
     }
+  m_gl_state.reset_counters();
   return m_current_external_texture.size();
 }
+
+void
+fastuidraw::gl::detail::PainterBackendGL::
+state_change_counts(unsigned int *out_issued, unsigned int *out_elided) const
+{
+  *out_issued = m_gl_state.num_calls_issued();
+  *out_elided = m_gl_state.num_calls_elided();
+}
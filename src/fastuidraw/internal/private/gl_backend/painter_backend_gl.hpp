@@ -38,6 +38,7 @@
 #include <private/gl_backend/colorstop_atlas_gl.hpp>
 #include <private/gl_backend/glyph_atlas_gl.hpp>
 #include <private/gl_backend/opengl_trait.hpp>
+#include <private/gl_backend/gl_state_cache.hpp>
 
 namespace fastuidraw
 {
@@ -88,6 +89,11 @@ namespace fastuidraw
         unsigned int
         on_painter_begin(void) override final;
 
+        virtual
+        void
+        state_change_counts(unsigned int *out_issued,
+                            unsigned int *out_elided) const override final;
+
         GLuint
         clear_buffers_of_current_surface(bool clear_depth, bool clear_color);
 
@@ -134,6 +140,8 @@ namespace fastuidraw
         GLuint m_current_coverage_buffer_texture;
         BindingPoints m_binding_points;
         DrawState *m_draw_state;
+        GLStateCache m_gl_state;
+        std::vector<GLuint> m_indirect_commands;
         PainterShaderRegistrarGL::program_set m_cached_programs;
         reference_counted_ptr<PainterShaderRegistrarGL::CachedItemPrograms> m_cached_item_programs;
         fastuidraw::vecN<enum PainterEngineGL::program_type_t, 2> m_choose_uber_program;
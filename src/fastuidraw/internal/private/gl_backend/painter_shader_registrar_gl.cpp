@@ -242,6 +242,10 @@ configure_source_front_matter(void)
                                  m_uber_shader_builder_params.image_atlas_color_tiles_linear_binding())
         .add_sampler_initializer("fastuidraw_imageAtlasNearest",
                                  m_uber_shader_builder_params.image_atlas_color_tiles_nearest_binding())
+        .add_sampler_initializer("fastuidraw_imageAtlasR8",
+                                 m_uber_shader_builder_params.image_atlas_color_tiles_r8_binding())
+        .add_sampler_initializer("fastuidraw_imageAtlasRG8",
+                                 m_uber_shader_builder_params.image_atlas_color_tiles_rg8_binding())
         .add_sampler_initializer("fastuidraw_imageIndexAtlas",
                                  m_uber_shader_builder_params.image_atlas_index_tiles_binding())
         .add_sampler_initializer("fastuidraw_colorStopAtlas",
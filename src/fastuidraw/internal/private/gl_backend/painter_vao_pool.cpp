@@ -33,6 +33,7 @@ painter_vao_pool(const PainterEngineGL::ConfigurationGL &params,
   m_data_store_backing(params.data_store_backing()),
   m_tex_buffer_support(tex_buffer_support),
   m_data_store_binding(data_store_binding),
+  m_use_multi_draw_indirect(params.use_multi_draw_indirect()),
   m_current_pool(0),
   m_free_vaos(params.number_pools()),
   m_ubos(params.number_pools(), 0)
@@ -99,6 +100,15 @@ request_vao(void)
           return_value.m_data_tbo = generate_tbo(return_value.m_data_bo, GL_RGBA32UI,
                                                  return_value.m_data_store_binding_point);
         }
+      if (m_use_multi_draw_indirect)
+        {
+          /* the size of the draw list is not known until the
+           * PainterDraw is unmapped, so the buffer's store is
+           * specified then.
+           */
+          fastuidraw_glGenBuffers(1, &return_value.m_indirect_bo);
+          FASTUIDRAWassert(return_value.m_indirect_bo != 0);
+        }
       return_value.m_pool = m_current_pool;
     }
   else
@@ -161,6 +171,10 @@ release_vao_resources(const painter_vao &V)
   fastuidraw_glDeleteBuffers(1, &V.m_header_bo);
   fastuidraw_glDeleteBuffers(1, &V.m_index_bo);
   fastuidraw_glDeleteBuffers(1, &V.m_data_bo);
+  if (V.m_indirect_bo != 0)
+    {
+      fastuidraw_glDeleteBuffers(1, &V.m_indirect_bo);
+    }
   FASTUIDRAWassert(V.m_vao == 0);
 }
 
@@ -40,12 +40,19 @@ public:
     m_header_bo(0),
     m_index_bo(0),
     m_data_bo(0),
-    m_data_tbo(0)
+    m_data_tbo(0),
+    m_indirect_bo(0)
   {}
 
   GLuint m_vao;
   GLuint m_attribute_bo, m_header_bo, m_index_bo, m_data_bo;
   GLuint m_data_tbo;
+
+  /* buffer holding the indirect draw commands, only
+   * non-zero if ConfigurationGL::use_multi_draw_indirect()
+   * is true.
+   */
+  GLuint m_indirect_bo;
   enum glsl::PainterShaderRegistrarGLSL::data_store_backing_t m_data_store_backing;
   unsigned int m_data_store_binding_point;
   unsigned int m_pool;
@@ -124,6 +131,7 @@ private:
   enum glsl::PainterShaderRegistrarGLSL::data_store_backing_t m_data_store_backing;
   enum tex_buffer_support_t m_tex_buffer_support;
   unsigned int m_data_store_binding;
+  bool m_use_multi_draw_indirect;
 
   unsigned int m_current_pool;
   std::vector<std::vector<painter_vao> > m_free_vaos;
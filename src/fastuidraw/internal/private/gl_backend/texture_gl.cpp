@@ -347,6 +347,140 @@ operator()(GLuint srcName, GLenum srcTarget, GLint srcLevel,
     }
 }
 
+///////////////////////////////////
+// SparseTextureLayers methods
+bool
+fastuidraw::gl::detail::SparseTextureLayers::
+create_storage(GLenum internal_format, ivec3 dims, unsigned int num_levels)
+{
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      FASTUIDRAWunused(internal_format);
+      FASTUIDRAWunused(dims);
+      FASTUIDRAWunused(num_levels);
+      return false;
+    }
+  #else
+    {
+      ContextProperties ctx;
+      GLint num_page_sizes(0), page_x(0), page_y(0), page_z(0);
+      GLint max_layers, num_sparse_levels(0);
+
+      FASTUIDRAWassert(!active());
+      if (!ctx.has_extension("GL_ARB_sparse_texture"))
+        {
+          return false;
+        }
+
+      fastuidraw_glGetInternalformativ(GL_TEXTURE_2D_ARRAY, internal_format,
+                                       GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &num_page_sizes);
+      if (num_page_sizes <= 0)
+        {
+          return false;
+        }
+
+      /* use the page size of index 0, which is the default
+       * value of GL_VIRTUAL_PAGE_SIZE_INDEX_ARB
+       */
+      fastuidraw_glGetInternalformativ(GL_TEXTURE_2D_ARRAY, internal_format,
+                                       GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &page_x);
+      fastuidraw_glGetInternalformativ(GL_TEXTURE_2D_ARRAY, internal_format,
+                                       GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &page_y);
+      fastuidraw_glGetInternalformativ(GL_TEXTURE_2D_ARRAY, internal_format,
+                                       GL_VIRTUAL_PAGE_SIZE_Z_ARB, 1, &page_z);
+      max_layers = context_get<GLint>(GL_MAX_SPARSE_ARRAY_TEXTURE_LAYERS_ARB);
+
+      /* the size of a sparse texture must be a multiple of the page size */
+      if (page_x <= 0 || page_y <= 0 || page_z <= 0)
+        {
+          return false;
+        }
+      max_layers -= max_layers % page_z;
+      if (dims.x() % page_x != 0 || dims.y() % page_y != 0 || max_layers < t_max(1, dims.z()))
+        {
+          return false;
+        }
+
+      fastuidraw_glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+      fastuidraw_glTexStorage3D(GL_TEXTURE_2D_ARRAY, num_levels, internal_format,
+                                dims.x(), dims.y(), max_layers);
+      fastuidraw_glGetTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_NUM_SPARSE_LEVELS_ARB,
+                                     &num_sparse_levels);
+
+      m_dims = ivec2(dims.x(), dims.y());
+      m_virtual_layers = max_layers;
+      m_committed_layers = 0;
+      m_num_levels = num_levels;
+      m_num_sparse_levels = t_min(num_sparse_levels, m_num_levels);
+      m_page_depth = page_z;
+      m_tail_per_layer = context_get<bool>(GL_SPARSE_TEXTURE_FULL_ARRAY_CUBE_MIPMAPS_ARB);
+
+      /* When the mipmap levels too small for a page (the mip tail)
+       * are shared by all layers, the tail is committed once for
+       * the entire texture.
+       */
+      if (!m_tail_per_layer)
+        {
+          commit(0, m_virtual_layers, true);
+        }
+
+      commit_layers(dims.z());
+      return true;
+    }
+  #endif
+}
+
+bool
+fastuidraw::gl::detail::SparseTextureLayers::
+commit_layers(int num_layers)
+{
+  FASTUIDRAWassert(active());
+  if (num_layers > m_virtual_layers)
+    {
+      return false;
+    }
+
+  if (num_layers > m_committed_layers)
+    {
+      int end_layer;
+
+      /* commits must be a multiple of the page depth */
+      end_layer = t_min(m_virtual_layers, m_page_depth * ((num_layers + m_page_depth - 1) / m_page_depth));
+      commit(m_committed_layers, end_layer, false);
+      m_committed_layers = end_layer;
+    }
+  return true;
+}
+
+void
+fastuidraw::gl::detail::SparseTextureLayers::
+commit(int begin_layer, int end_layer, bool tail_only)
+{
+  #ifdef FASTUIDRAW_GL_USE_GLES
+    {
+      FASTUIDRAWunused(begin_layer);
+      FASTUIDRAWunused(end_layer);
+      FASTUIDRAWunused(tail_only);
+    }
+  #else
+    {
+      int begin_level, end_level;
+
+      begin_level = (tail_only) ? m_num_sparse_levels : 0;
+      end_level = (tail_only || m_tail_per_layer) ? m_num_levels : m_num_sparse_levels;
+      for (int level = begin_level; level < end_level; ++level)
+        {
+          fastuidraw_glTexPageCommitmentARB(GL_TEXTURE_2D_ARRAY, level,
+                                            0, 0, begin_layer,
+                                            t_max(1, m_dims.x() >> level),
+                                            t_max(1, m_dims.y() >> level),
+                                            end_layer - begin_layer,
+                                            GL_TRUE);
+        }
+    }
+  #endif
+}
+
 ///////////////////////////////////
 // non-class methods
 enum fastuidraw::gl::detail::texture_type_t
@@ -19,9 +19,12 @@
 
 #pragma once
 
-#include <list>
 #include <vector>
+#include <mutex>
+#include <atomic>
 #include <algorithm>
+#include <cstring>
+#include <stdint.h>
 
 #include <fastuidraw/util/c_array.hpp>
 #include <fastuidraw/gl_backend/gl_get.hpp>
@@ -30,6 +33,7 @@
 #include <fastuidraw/gl_backend/gl_context_properties.hpp>
 
 #include <private/gl_backend/scratch_renderer.hpp>
+#include <private/gl_backend/context_worker_gl.hpp>
 
 namespace fastuidraw { namespace gl { namespace detail {
 
@@ -71,6 +75,59 @@ private:
   mutable enum type_t m_type;
 };
 
+/* Sparse storage (GL_ARB_sparse_texture) for a GL_TEXTURE_2D_ARRAY
+ * whose number of layers only grows. The texture is given the largest
+ * number of layers a sparse array texture may have and only the pages
+ * of the layers in use are committed; growing the number of layers
+ * then commits the pages of the new layers instead of creating a new
+ * texture and copying the old texture to it.
+ */
+class SparseTextureLayers
+{
+public:
+  SparseTextureLayers(void):
+    m_virtual_layers(0),
+    m_committed_layers(0),
+    m_num_levels(0),
+    m_num_sparse_levels(0),
+    m_page_depth(1),
+    m_tail_per_layer(false)
+  {}
+
+  /* To be called with the texture bound to GL_TEXTURE_2D_ARRAY
+   * in place of specifying its storage. If the context supports
+   * sparse textures of the format and size, specifies sparse
+   * storage for the texture, commits the layers [0, dims.z())
+   * and returns true; otherwise does nothing and returns false.
+   */
+  bool
+  create_storage(GLenum internal_format, ivec3 dims, unsigned int num_levels);
+
+  /* Returns true if create_storage() specified sparse storage */
+  bool
+  active(void) const
+  {
+    return m_virtual_layers > 0;
+  }
+
+  /* To be called with the texture bound to GL_TEXTURE_2D_ARRAY;
+   * commits the layers so that at least num_layers are backed.
+   * Returns false if the texture cannot hold num_layers layers.
+   */
+  bool
+  commit_layers(int num_layers);
+
+private:
+  void
+  commit(int begin_layer, int end_layer, bool tail_only);
+
+  ivec2 m_dims;
+  int m_virtual_layers, m_committed_layers;
+  int m_num_levels, m_num_sparse_levels;
+  int m_page_depth;
+  bool m_tail_per_layer;
+};
+
 template<GLenum texture_target>
 class TextureTargetDimension
 {};
@@ -335,12 +392,71 @@ template<size_t N>
 class EntryLocationN
 {
 public:
-  typedef std::pair<EntryLocationN, std::vector<uint8_t> > with_data;
-
   EntryLocationN(void):
     m_mipmap_level(0u)
   {}
 
+  /* If loc is adjacent to this EntryLocationN along one
+   * dimension so that together they form a box, enlarge
+   * this EntryLocationN to that box and return true.
+   */
+  bool
+  append(const EntryLocationN &loc)
+  {
+    int merge_dim(-1);
+
+    if (loc.m_mipmap_level != m_mipmap_level)
+      {
+        return false;
+      }
+
+    for (unsigned int i = 0; i < N; ++i)
+      {
+        if (loc.m_location[i] == m_location[i] && loc.m_size[i] == m_size[i])
+          {
+            continue;
+          }
+
+        if (merge_dim != -1 || loc.m_location[i] != m_location[i] + m_size[i])
+          {
+            return false;
+          }
+        merge_dim = i;
+      }
+
+    if (merge_dim == -1)
+      {
+        return false;
+      }
+
+    m_size[merge_dim] += loc.m_size[merge_dim];
+    return true;
+  }
+
+  /* location padded to 3-dimensions */
+  ivec3
+  location3(void) const
+  {
+    ivec3 R(0, 0, 0);
+    for (unsigned int i = 0; i < N; ++i)
+      {
+        R[i] = m_location[i];
+      }
+    return R;
+  }
+
+  /* size padded to 3-dimensions */
+  ivec3
+  size3(void) const
+  {
+    ivec3 R(1, 1, 1);
+    for (unsigned int i = 0; i < N; ++i)
+      {
+        R[i] = m_size[i];
+      }
+    return R;
+  }
+
   vecN<int, N> m_location;
   vecN<GLsizei, N> m_size;
   unsigned int m_mipmap_level;
@@ -373,20 +489,39 @@ public:
   typedef EntryLocationN<N> EntryLocation;
   typedef vecN<int, N> DimensionType;
 
+  /* If worker is non-null, then delayed must be true and the
+   * GL work of flush() is performed by the worker; in that
+   * case flush() does not require a GL context to be current,
+   * texture() has the GL server of the current context wait
+   * on the uploads and the GL objects are deleted by the worker.
+   *
+   * If sparse_layers is true and texture_target is
+   * GL_TEXTURE_2D_ARRAY, the texture uses SparseTextureLayers
+   * when the context supports it, so that growing only the
+   * number of layers keeps the same GL texture.
+   */
   TextureGLGeneric(GLenum internal_format,
                    GLenum external_format,
                    GLenum external_type,
                    GLenum mag_filter,
                    GLenum min_filter,
                    DimensionType dims, bool delayed,
-                   unsigned int mipmap_levels = 1);
+                   unsigned int mipmap_levels = 1,
+                   const reference_counted_ptr<ContextWorkerGL> &worker
+                   = reference_counted_ptr<ContextWorkerGL>(),
+                   bool sparse_layers = false);
   ~TextureGLGeneric();
 
   void
   delete_texture(void);
 
+  /* Returns the GL texture; if out_dims is non-null, also
+   * writes the dimensions of that texture to out_dims, which
+   * with a worker can lag behind dims() until the worker
+   * performs the resize.
+   */
   GLuint
-  texture(void) const;
+  texture(DimensionType *out_dims = nullptr) const;
 
   void
   flush(void);
@@ -419,15 +554,123 @@ public:
 
 private:
 
+  /* A region of the texture set by set_data_c_array() or
+   * set_data_vector() whose data is in StagedData::m_staging.
+   */
+  class StagedPiece
+  {
+  public:
+    EntryLocation m_loc;
+    size_t m_offset;
+
+    /* index into StagedData::m_uploads of the
+     * upload that includes this piece
+     */
+    unsigned int m_upload;
+  };
+
+  /* A box of the texture made from one or more adjacent
+   * StagedPiece values that is uploaded with a single call
+   * to glTexSubImage.
+   */
+  class StagedUpload
+  {
+  public:
+    EntryLocation m_loc;
+
+    /* offset in bytes of the data of the upload
+     * within the pixel unpack buffer.
+     */
+    size_t m_offset;
+  };
+
+  /* the uploads of set_data_c_array() and set_data_vector()
+   * when m_delayed is true; an upload is appended to the last
+   * upload of the same mipmap level if they form a box. Uploads
+   * to different mipmap levels never overlap, so only merging
+   * with the last upload to the same level keeps the order of
+   * writes to the same texels.
+   */
+  class StagedData
+  {
+  public:
+    bool
+    empty(void) const
+    {
+      return m_uploads.empty();
+    }
+
+    void
+    reset(unsigned int num_mipmaps)
+    {
+      m_staging.clear();
+      m_pieces.clear();
+      m_uploads.clear();
+      m_last_upload.assign(num_mipmaps, -1);
+    }
+
+    std::vector<uint8_t> m_staging;
+    std::vector<StagedPiece> m_pieces;
+    std::vector<StagedUpload> m_uploads;
+    std::vector<int> m_last_upload;
+  };
+
+  /* a flush() handed to m_worker */
+  class UploadJob
+  {
+  public:
+    DimensionType m_dims;
+    StagedData m_data;
+  };
+
+  enum
+    {
+      /* number of pixel unpack buffers used in a round
+       * robin fashion so that writing to the buffer of
+       * a flush does not wait on the GPU reading the
+       * buffer of the previous flush.
+       */
+      number_staging_buffers = 3,
+
+      /* when the data staged reaches this many bytes and
+       * there is a worker, the data is handed to the worker
+       * without waiting for flush().
+       */
+      worker_submit_bytes = 1 << 20
+    };
+
   void
-  create_texture(void) const;
+  create_texture(const DimensionType &dims) const;
 
   void
-  tex_subimage(const EntryLocation &loc,
-               c_array<const uint8_t> data);
+  flush_size_change(const DimensionType &dims);
 
+  /* issue the GL commands to realize the texture at the
+   * named dimensions with the staged data uploaded.
+   */
   void
-  flush_size_change(void);
+  upload(const DimensionType &dims, StagedData &data);
+
+  void
+  stage_data(const EntryLocation &loc,
+             c_array<const uint8_t> data);
+
+  /* write the data of the StagedPiece values to dst
+   * with the layout of the StagedUpload values.
+   */
+  void
+  write_staged_data(const StagedData &data, uint8_t *dst) const;
+
+  void
+  flush_staged_data(StagedData &data);
+
+  /* hand the staged data and the current dimensions to m_worker */
+  void
+  submit_to_worker(void);
+
+  /* executed by m_worker */
+  void
+  execute_jobs(void);
 
   GLenum m_internal_format;
   GLenum m_external_format;
@@ -443,11 +686,38 @@ private:
   mutable bool m_use_tex_storage;
   mutable int m_number_times_create_texture_called;
   CopyImageSubData m_blitter;
-
-  typedef typename EntryLocation::with_data with_data;
-  typedef std::list<with_data> list_type;
-
-  list_type m_unflushed_commands;
+  bool m_sparse_layers;
+  mutable SparseTextureLayers m_sparse;
+
+  StagedData m_staged;
+  unsigned int m_bytes_per_texel;
+
+  /* pixel unpack buffers to which staged data is written at flush */
+  vecN<GLuint, number_staging_buffers> m_staging_buffers;
+  vecN<size_t, number_staging_buffers> m_staging_buffer_sizes;
+  unsigned int m_current_staging_buffer;
+
+  /* used only if mapping the pixel unpack buffer fails */
+  std::vector<uint8_t> m_staging_fallback;
+
+  /* The values below are only used when there is a worker.
+   * The members above that hold GL state are then only
+   * accessed by the worker thread, the textures replaced by
+   * resizes are deleted by the thread calling texture() when
+   * it fetches their replacement.
+   */
+  reference_counted_ptr<ContextWorkerGL> m_worker;
+  std::atomic<uint64_t> m_ticket;
+  bool m_submitted;
+  vecN<int, N> m_submitted_dims;
+  std::vector<GLuint> m_worker_retired_textures;
+
+  /* protects the values below it */
+  mutable std::mutex m_jobs_mutex;
+  std::vector<UploadJob> m_jobs;
+  GLuint m_published_texture;
+  DimensionType m_published_dims;
+  mutable std::vector<GLuint> m_retired_textures;
 };
 
 ///////////////////////////////////////
@@ -460,7 +730,9 @@ TextureGLGeneric(GLenum internal_format,
                  GLenum mag_filter,
                  GLenum min_filter,
                  vecN<int, N> dims, bool delayed,
-                 unsigned int mipmap_levels):
+                 unsigned int mipmap_levels,
+                 const reference_counted_ptr<ContextWorkerGL> &worker,
+                 bool sparse_layers):
   m_internal_format(internal_format),
   m_external_format(external_format),
   m_external_type(external_type),
@@ -470,11 +742,22 @@ TextureGLGeneric(GLenum internal_format,
   m_dims(dims),
   m_num_mipmaps(mipmap_levels),
   m_texture(0),
-  m_number_times_create_texture_called(0)
+  m_number_times_create_texture_called(0),
+  m_sparse_layers(sparse_layers && texture_target == GL_TEXTURE_2D_ARRAY),
+  m_bytes_per_texel(0),
+  m_staging_buffers(0),
+  m_staging_buffer_sizes(0),
+  m_current_staging_buffer(0),
+  m_worker(worker),
+  m_ticket(0),
+  m_submitted(false),
+  m_published_texture(0)
 {
+  FASTUIDRAWassert(!m_worker || m_delayed);
+  m_staged.reset(m_num_mipmaps);
   if (!m_delayed)
     {
-      create_texture();
+      create_texture(m_dims);
     }
   m_texture_dimension = m_dims;
 }
@@ -483,19 +766,63 @@ template<GLenum texture_target>
 TextureGLGeneric<texture_target>::
 ~TextureGLGeneric()
 {
+  if (m_worker)
+    {
+      /* the tasks of m_worker reference this object, and
+       * the worker deletes the GL objects so that a GL
+       * context need not be current.
+       */
+      m_worker->finish_task(m_ticket);
+      m_worker->delete_texture(m_texture);
+      for (GLuint t : m_retired_textures)
+        {
+          m_worker->delete_texture(t);
+        }
+      for (GLuint bo : m_staging_buffers)
+        {
+          m_worker->delete_buffer(bo);
+        }
+      return;
+    }
+
   if (m_texture != 0)
     {
       delete_texture();
     }
+
+  for (GLuint bo : m_staging_buffers)
+    {
+      if (bo != 0)
+        {
+          fastuidraw_glDeleteBuffers(1, &bo);
+        }
+    }
 }
 
 template<GLenum texture_target>
 void
 TextureGLGeneric<texture_target>::
-flush_size_change(void)
+flush_size_change(const DimensionType &dims)
 {
-  if (m_texture_dimension != m_dims)
+  if (m_texture_dimension != dims)
     {
+      ivec3 old_dims3(m_texture_dimension, 1), dims3(dims, 1);
+
+      /* a sparse texture that only gains layers is
+       * grown by committing the pages of the new layers.
+       */
+      if (m_texture != 0 && m_sparse.active()
+          && old_dims3.x() == dims3.x() && old_dims3.y() == dims3.y()
+          && old_dims3.z() <= dims3.z())
+        {
+          fastuidraw_glBindTexture(texture_target, m_texture);
+          if (m_sparse.commit_layers(dims3.z()))
+            {
+              m_texture_dimension = dims;
+              return;
+            }
+        }
+
       /* only need to issue GL commands to resize
        * the underlying GL texture IF we do not have
        * a texture yet.
@@ -508,14 +835,14 @@ flush_size_change(void)
           /* create a new texture for the new size,
            */
           m_texture = 0;
-          create_texture();
+          create_texture(dims);
 
           /* copy the contents of old_texture to m_texture
            */
           vecN<GLint, 3> blit_dims;
           for(unsigned int i = 0; i < N; ++i)
             {
-              blit_dims[i] = std::min(m_dims[i], m_texture_dimension[i]);
+              blit_dims[i] = std::min(dims[i], m_texture_dimension[i]);
             }
           for(unsigned int i = N; i < 3; ++i)
             {
@@ -546,11 +873,20 @@ flush_size_change(void)
                     0, 0, 0, //dst
                     blit_dims[0], blit_dims[1], blit_dims[2]);
 
-          /* now delete old_texture
+          /* now delete old_texture; with a worker, the rendering
+           * thread may still be about to bind old_texture, so it
+           * is deleted once the rendering thread fetches m_texture.
            */
-          fastuidraw_glDeleteTextures(1, &old_texture);
+          if (m_worker)
+            {
+              m_worker_retired_textures.push_back(old_texture);
+            }
+          else
+            {
+              fastuidraw_glDeleteTextures(1, &old_texture);
+            }
         }
-      m_texture_dimension = m_dims;
+      m_texture_dimension = dims;
     }
 }
 
@@ -568,9 +904,32 @@ delete_texture(void)
 template<GLenum texture_target>
 GLuint
 TextureGLGeneric<texture_target>::
-texture(void) const
+texture(DimensionType *out_dims) const
 {
+  if (m_worker)
+    {
+      m_worker->wait_task(m_ticket);
+
+      std::lock_guard<std::mutex> M(m_jobs_mutex);
+      for (GLuint t : m_retired_textures)
+        {
+          fastuidraw_glDeleteTextures(1, &t);
+        }
+      m_retired_textures.clear();
+
+      FASTUIDRAWassert(m_published_texture != 0);
+      if (out_dims)
+        {
+          *out_dims = m_published_dims;
+        }
+      return m_published_texture;
+    }
+
   FASTUIDRAWassert(m_texture != 0);
+  if (out_dims)
+    {
+      *out_dims = m_texture_dimension;
+    }
   return m_texture;
 }
 
@@ -578,7 +937,7 @@ texture(void) const
 template<GLenum texture_target>
 void
 TextureGLGeneric<texture_target>::
-create_texture(void) const
+create_texture(const DimensionType &dims) const
 {
   FASTUIDRAWassert(m_texture == 0);
   fastuidraw_glGenTextures(1, &m_texture);
@@ -590,71 +949,247 @@ create_texture(void) const
       m_use_tex_storage = ctx.is_es() || ctx.version() >= ivec2(4, 2)
         || ctx.has_extension("GL_ARB_texture_storage");
     }
-  tex_storage<texture_target>(m_use_tex_storage, m_internal_format, m_dims, m_num_mipmaps);
+
+  /* a texture created for a resize is not sparse, since
+   * the sparse texture cannot hold the new size.
+   */
+  m_sparse = SparseTextureLayers();
+  if (!m_sparse_layers || m_number_times_create_texture_called != 0
+      || !m_sparse.create_storage(m_internal_format, ivec3(dims, 1), m_num_mipmaps))
+    {
+      tex_storage<texture_target>(m_use_tex_storage, m_internal_format, dims, m_num_mipmaps);
+    }
   fastuidraw_glTexParameteri(texture_target, GL_TEXTURE_MIN_FILTER, m_min_filter);
   fastuidraw_glTexParameteri(texture_target, GL_TEXTURE_MAG_FILTER, m_mag_filter);
   fastuidraw_glTexParameteri(texture_target, GL_TEXTURE_MAX_LEVEL, m_num_mipmaps - 1);
   ++m_number_times_create_texture_called;
 }
 
-
 template<GLenum texture_target>
 void
 TextureGLGeneric<texture_target>::
-flush(void)
+upload(const DimensionType &dims, StagedData &data)
 {
-  flush_size_change();
+  flush_size_change(dims);
   if (m_texture == 0)
     {
-      create_texture();
+      create_texture(dims);
     }
 
-  if (!m_unflushed_commands.empty())
+  if (!data.empty())
     {
       fastuidraw_glBindTexture(texture_target, m_texture);
       fastuidraw_glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-      for(const auto &cmd : m_unflushed_commands)
-        {
-          FASTUIDRAWassert(!cmd.second.empty());
-          tex_sub_image<texture_target>(cmd.first.m_mipmap_level,
-                                        cmd.first.m_location,
-                                        cmd.first.m_size,
-                                        m_external_format, m_external_type,
-                                        &cmd.second[0]);
-        }
-      m_unflushed_commands.clear();
+      flush_staged_data(data);
     }
 }
 
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+flush(void)
+{
+  if (m_worker)
+    {
+      submit_to_worker();
+    }
+  else
+    {
+      upload(m_dims, m_staged);
+      m_staged.reset(m_num_mipmaps);
+    }
+}
 
 template<GLenum texture_target>
 void
 TextureGLGeneric<texture_target>::
-set_data_vector(const EntryLocation &loc,
-                std::vector<uint8_t> &data)
+submit_to_worker(void)
 {
-  if (data.empty())
+  if (m_staged.empty() && m_submitted && m_submitted_dims == m_dims)
     {
       return;
     }
 
-  if (m_delayed)
+  {
+    std::lock_guard<std::mutex> M(m_jobs_mutex);
+    m_jobs.push_back(UploadJob());
+    m_jobs.back().m_dims = m_dims;
+    std::swap(m_jobs.back().m_data, m_staged);
+  }
+
+  m_staged.reset(m_num_mipmaps);
+  m_submitted = true;
+  m_submitted_dims = m_dims;
+  m_ticket = m_worker->add_task([this]() { execute_jobs(); });
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+execute_jobs(void)
+{
+  std::vector<UploadJob> jobs;
+
+  {
+    std::lock_guard<std::mutex> M(m_jobs_mutex);
+    std::swap(jobs, m_jobs);
+  }
+
+  for (UploadJob &job : jobs)
     {
-      m_unflushed_commands.push_back(typename EntryLocation::with_data());
-      typename EntryLocation::with_data &R(m_unflushed_commands.back());
-      R.first = loc;
-      R.second.swap(data);
+      upload(job.m_dims, job.m_data);
     }
-  else
+
+  std::lock_guard<std::mutex> M(m_jobs_mutex);
+  m_published_texture = m_texture;
+  m_published_dims = m_texture_dimension;
+  m_retired_textures.insert(m_retired_textures.end(),
+                            m_worker_retired_textures.begin(),
+                            m_worker_retired_textures.end());
+  m_worker_retired_textures.clear();
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+stage_data(const EntryLocation &loc,
+           c_array<const uint8_t> data)
+{
+  StagedPiece piece;
+  ivec3 sz(loc.size3());
+  unsigned int num_texels(sz.x() * sz.y() * sz.z());
+  int &last(m_staged.m_last_upload[loc.m_mipmap_level]);
+
+  FASTUIDRAWassert(loc.m_mipmap_level < m_staged.m_last_upload.size());
+  FASTUIDRAWassert(num_texels > 0 && data.size() % num_texels == 0);
+  if (m_bytes_per_texel == 0)
     {
-      flush_size_change();
-      fastuidraw_glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-      fastuidraw_glBindTexture(texture_target, m_texture);
-      tex_sub_image<texture_target>(loc.m_mipmap_level,
-                                    loc.m_location,
-                                    loc.m_size,
+      m_bytes_per_texel = data.size() / num_texels;
+    }
+  FASTUIDRAWassert(data.size() == m_bytes_per_texel * num_texels);
+  FASTUIDRAWunused(num_texels);
+
+  piece.m_loc = loc;
+  piece.m_offset = m_staged.m_staging.size();
+  m_staged.m_staging.insert(m_staged.m_staging.end(), data.begin(), data.end());
+
+  if (last == -1 || !m_staged.m_uploads[last].m_loc.append(loc))
+    {
+      last = m_staged.m_uploads.size();
+      m_staged.m_uploads.push_back(StagedUpload());
+      m_staged.m_uploads.back().m_loc = loc;
+    }
+  piece.m_upload = last;
+  m_staged.m_pieces.push_back(piece);
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+write_staged_data(const StagedData &data, uint8_t *dst) const
+{
+  for (const StagedPiece &piece : data.m_pieces)
+    {
+      const StagedUpload &upload(data.m_uploads[piece.m_upload]);
+      ivec3 upload_loc(upload.m_loc.location3()), upload_sz(upload.m_loc.size3());
+      ivec3 loc(piece.m_loc.location3()), sz(piece.m_loc.size3());
+      size_t row_bytes(m_bytes_per_texel * sz.x());
+      const uint8_t *src(&data.m_staging[piece.m_offset]);
+
+      /* the data of upload is row-major (x fastest, then y, then z) */
+      for (int z = 0; z < sz.z(); ++z)
+        {
+          for (int y = 0; y < sz.y(); ++y, src += row_bytes)
+            {
+              size_t texel;
+
+              texel = (z + loc.z() - upload_loc.z()) * upload_sz.y();
+              texel = (texel + y + loc.y() - upload_loc.y()) * upload_sz.x();
+              texel += loc.x() - upload_loc.x();
+              std::memcpy(dst + upload.m_offset + texel * m_bytes_per_texel, src, row_bytes);
+            }
+        }
+    }
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+flush_staged_data(StagedData &data)
+{
+  size_t total_bytes(0);
+  GLuint &bo(m_staging_buffers[m_current_staging_buffer]);
+  size_t &bo_size(m_staging_buffer_sizes[m_current_staging_buffer]);
+  void *mapped;
+  bool use_buffer;
+
+  for (StagedUpload &upload : data.m_uploads)
+    {
+      ivec3 sz(upload.m_loc.size3());
+
+      upload.m_offset = total_bytes;
+      total_bytes += m_bytes_per_texel * sz.x() * sz.y() * sz.z();
+    }
+
+  m_current_staging_buffer = (m_current_staging_buffer + 1) % number_staging_buffers;
+  if (bo == 0)
+    {
+      fastuidraw_glGenBuffers(1, &bo);
+      FASTUIDRAWassert(bo != 0);
+    }
+
+  fastuidraw_glBindBuffer(GL_PIXEL_UNPACK_BUFFER, bo);
+  if (bo_size < total_bytes)
+    {
+      bo_size = t_max(total_bytes, 2 * bo_size);
+      fastuidraw_glBufferData(GL_PIXEL_UNPACK_BUFFER, bo_size, nullptr, GL_STREAM_DRAW);
+    }
+
+  mapped = fastuidraw_glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, total_bytes,
+                                       GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  use_buffer = (mapped != nullptr);
+  if (use_buffer)
+    {
+      write_staged_data(data, static_cast<uint8_t*>(mapped));
+      use_buffer = (fastuidraw_glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE);
+    }
+
+  if (!use_buffer)
+    {
+      /* upload from client memory instead */
+      fastuidraw_glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+      m_staging_fallback.resize(total_bytes);
+      write_staged_data(data, &m_staging_fallback[0]);
+    }
+
+  for (const StagedUpload &upload : data.m_uploads)
+    {
+      const uint8_t *pixels;
+
+      pixels = (use_buffer) ? nullptr : &m_staging_fallback[0];
+      pixels += upload.m_offset;
+      tex_sub_image<texture_target>(upload.m_loc.m_mipmap_level,
+                                    upload.m_loc.m_location,
+                                    upload.m_loc.m_size,
                                     m_external_format, m_external_type,
-                                    &data[0]);
+                                    pixels);
+    }
+
+  if (use_buffer)
+    {
+      fastuidraw_glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+}
+
+template<GLenum texture_target>
+void
+TextureGLGeneric<texture_target>::
+set_data_vector(const EntryLocation &loc,
+                std::vector<uint8_t> &data)
+{
+  if (!data.empty())
+    {
+      set_data_c_array(loc, c_array<const uint8_t>(&data[0], data.size()));
     }
 }
 
@@ -671,14 +1206,15 @@ set_data_c_array(const EntryLocation &loc,
 
   if (m_delayed)
     {
-      std::vector<uint8_t> data_copy;
-      data_copy.resize(data.size());
-      std::copy(data.begin(), data.end(), data_copy.begin());
-      set_data_vector(loc, data_copy);
+      stage_data(loc, data);
+      if (m_worker && m_staged.m_staging.size() >= worker_submit_bytes)
+        {
+          submit_to_worker();
+        }
     }
   else
     {
-      flush_size_change();
+      flush_size_change(m_dims);
       fastuidraw_glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
       fastuidraw_glBindTexture(texture_target, m_texture);
       tex_sub_image<texture_target>(loc.m_mipmap_level,
@@ -700,10 +1236,14 @@ class TextureGL:public TextureGLGeneric<texture_target>
 {
 public:
   TextureGL(typename TextureGLGeneric<texture_target>::DimensionType dims, bool delayed,
-            unsigned int num_mip_map_levels = 1):
+            unsigned int num_mip_map_levels = 1,
+            const reference_counted_ptr<ContextWorkerGL> &worker
+            = reference_counted_ptr<ContextWorkerGL>(),
+            bool sparse_layers = false):
     TextureGLGeneric<texture_target>(internal_format, external_format,
                                      external_type, mag_filter, min_filter,
-                                     dims, delayed, num_mip_map_levels)
+                                     dims, delayed, num_mip_map_levels,
+                                     worker, sparse_layers)
   {}
 };
 
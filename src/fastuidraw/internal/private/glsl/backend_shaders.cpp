@@ -644,6 +644,12 @@ create_glyph_shader(void)
                                      "fastuidraw_painter_glyph_banded_rays.frag.glsl.resource_string",
                                      banded_rays_varyings));
 
+  return_value
+    .shader(multi_channel_distance_field_glyph,
+            create_glyph_item_shader("fastuidraw_painter_glyph_coverage_distance_field.vert.glsl.resource_string",
+                                     "fastuidraw_painter_glyph_multi_channel_distance_field.frag.glsl.resource_string",
+                                     distance_varyings));
+
   return return_value;
 }
 
@@ -697,7 +703,8 @@ create_dashed_stroke_shader_set(void)
   return_value
     .shader(PainterEnums::flat_caps, create_stroke_shader(PainterEnums::flat_caps, se))
     .shader(PainterEnums::rounded_caps, create_stroke_shader(PainterEnums::rounded_caps, se))
-    .shader(PainterEnums::square_caps, create_stroke_shader(PainterEnums::square_caps, se));
+    .shader(PainterEnums::square_caps, create_stroke_shader(PainterEnums::square_caps, se))
+    .cpu_dash_edge_shader(create_stroke_shader(PainterEnums::number_cap_styles, se));
   return return_value;
 }
 
@@ -764,6 +771,25 @@ create_fill_shader(void)
   return fill_shader;
 }
 
+reference_counted_ptr<PainterCustomBrushShader>
+ShaderSetCreator::
+create_blur_brush_shader(void)
+{
+  /* the image is either bindless or bound to the
+   * external texture of slot 0.
+   */
+  return FASTUIDRAWnew PainterCustomBrushShaderGLSL(1,
+                                                    ShaderSource()
+                                                    .add_source("fastuidraw_painter_blur_brush.vert.glsl.resource_string",
+                                                                ShaderSource::from_resource),
+                                                    ShaderSource()
+                                                    .add_source("fastuidraw_painter_blur_brush.frag.glsl.resource_string",
+                                                                ShaderSource::from_resource),
+                                                    varying_list()
+                                                    .add_float("fastuidraw_blur_q_x")
+                                                    .add_float("fastuidraw_blur_q_y"));
+}
+
 PainterShaderSet
 ShaderSetCreator::
 create_shader_set(void)
@@ -779,7 +805,8 @@ create_shader_set(void)
     .stroke_shader(create_stroke_shader(PainterEnums::number_cap_styles, se))
     .dashed_stroke_shader(create_dashed_stroke_shader_set())
     .fill_shader(create_fill_shader())
-    .blend_shaders(create_blend_shaders());
+    .blend_shaders(create_blend_shaders())
+    .blur_brush_shader(create_blur_brush_shader());
   return return_value;
 }
 
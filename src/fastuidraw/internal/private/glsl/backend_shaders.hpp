@@ -20,6 +20,7 @@
 
 #include <fastuidraw/glsl/painter_item_shader_glsl.hpp>
 #include <fastuidraw/glsl/painter_blend_shader_glsl.hpp>
+#include <fastuidraw/glsl/painter_custom_brush_shader_glsl.hpp>
 #include <fastuidraw/glsl/painter_shader_registrar_glsl.hpp>
 
 namespace fastuidraw { namespace glsl { namespace detail {
@@ -151,6 +152,9 @@ private:
   PainterFillShader
   create_fill_shader(void);
 
+  reference_counted_ptr<PainterCustomBrushShader>
+  create_blur_brush_shader(void);
+
   ShaderSource::MacroSet m_fill_macros;
   ShaderSource::MacroSet m_common_glyph_attribute_macros;
 };
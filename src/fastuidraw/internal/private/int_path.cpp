@@ -34,9 +34,11 @@
 
 #include <iterator>
 #include <set>
+#include <limits>
 #include <private/int_path.hpp>
 #include <private/bezier_util.hpp>
 #include <private/util_private_ostream.hpp>
+#include <private/thread_pool.hpp>
 
 namespace
 {
@@ -295,9 +297,14 @@ namespace
                               const IntBezierCurve::transformation<int> &tr,
                               std::vector<solution_pt> *out_value) const;
 
+    /*
+     * Compute the intersections against the lines at step * c
+     * for begin <= c < end, with the intersections against
+     * line c added to (*out_value)[c].
+     */
     void
     compute_lines_intersection(enum coordinate_type line_type,
-                               int step, int count,
+                               int step, int begin, int end,
                                uint32_t solution_types_accepted,
                                const IntBezierCurve::transformation<int> &tr,
                                std::vector<std::vector<solution_pt> > *out_value) const;
@@ -367,7 +374,7 @@ namespace
       };
 
     distance_value(void):
-      m_distance(-1.0f),
+      m_distance(std::numeric_limits<float>::max()),
       m_ray_intersection_counts(0, 0, 0, 0),
       m_winding_numbers(0, 0)
     {}
@@ -376,9 +383,7 @@ namespace
     record_distance_value(float v)
     {
       FASTUIDRAWassert(v >= 0.0f);
-      m_distance = (m_distance >= 0.0f) ?
-        fastuidraw::t_min(v, m_distance) :
-        v;
+      m_distance = fastuidraw::t_min(v, m_distance);
     }
 
     void
@@ -397,9 +402,7 @@ namespace
     float
     distance(float max_distance) const
     {
-      return (m_distance < 0.0f) ?
-        max_distance :
-        fastuidraw::t_min(max_distance, m_distance);
+      return fastuidraw::t_min(max_distance, m_distance);
     }
 
     float
@@ -421,9 +424,10 @@ namespace
     }
 
   private:
-    /* unsigned distance in IntPath coordinates,
-     * a negative value indicates value is not
-     * assigned
+    /* unsigned distance in IntPath coordinates, the
+     * maximum float value indicates value is not assigned;
+     * using that instead of a negative value makes recording
+     * a distance a plain min() which the compiler vectorizes.
      */
     float m_distance;
 
@@ -464,6 +468,16 @@ namespace
                             int radius,
                             fastuidraw::array2d<distance_value> &out_values) const;
 
+    /*
+     * Compute only the winding numbers (as seen by Solver::x_fixed)
+     * of the distance_value for the same domain as of
+     * compute_distance_values().
+     */
+    void
+    compute_winding_numbers(const ivec2 &step, const ivec2 &count,
+                            const IntBezierCurve::transformation<int> &tr,
+                            fastuidraw::array2d<distance_value> &out_values) const;
+
     static
     uint8_t
     pixel_value_from_distance(float dist, bool outside);
@@ -500,6 +514,173 @@ namespace
 
     const std::vector<fastuidraw::detail::IntContour> &m_contours;
   };
+
+  /* Generates the distance values of a multi-channel distance
+   * field as in "Shape Decomposition for Multi-channel Distance
+   * Fields" by V. Chlumsky. The curves of each contour are given
+   * two or three of the channels red, green and blue so that the
+   * two curves meeting at a corner share only one channel. Each
+   * channel records the signed pseudo-distance to the closest
+   * curve having that channel; the median of the channels then
+   * recreates the corner which a single distance value rounds.
+   */
+  class MultiChannelDistanceFieldGenerator
+  {
+  public:
+    typedef fastuidraw::detail::IntBezierCurve IntBezierCurve;
+    typedef fastuidraw::detail::IntContour IntContour;
+    typedef fastuidraw::ivec2 ivec2;
+
+    enum
+      {
+        red_channel = 1,
+        green_channel = 2,
+        blue_channel = 4,
+        all_channels = red_channel | green_channel | blue_channel
+      };
+
+    /*
+     * \param contours contours of the path; curves are to be
+     *                 of degree at most two.
+     * \param tr transformation to apply to the path
+     * \param step size of a texel after tr is applied; the
+     *             distances computed are in units of texels.
+     */
+    MultiChannelDistanceFieldGenerator(const std::vector<IntContour> &contours,
+                                       const IntBezierCurve::transformation<int> &tr,
+                                       const ivec2 &step);
+
+    /*
+     * Compute the pseudo-distances of each channel and the
+     * distance to the path at the points (i, j) for
+     * 0 <= i < count.x() and 0 <= j < count.y(). The values
+     * are signed, with the sign given by the side of the
+     * closest curve on which the point lies.
+     */
+    void
+    compute_distance_values(const ivec2 &count,
+                            fastuidraw::array2d<fastuidraw::vec3> &out_pseudo_distances,
+                            fastuidraw::array2d<float> &out_distances) const;
+
+  private:
+    class Curve
+    {
+    public:
+      /* the end point is stored so that it is bitwise the
+       * start point of the next curve; this is needed for
+       * the tie-break of SignedDistance at shared points.
+       */
+      fastuidraw::vec2
+      eval(float t) const
+      {
+        return (t == 1.0f) ?
+          m_end :
+          m_poly[0] + t * (m_poly[1] + t * m_poly[2]);
+      }
+
+      /* as in msdfgen, the direction at a point where the
+       * derivative vanishes is that of the end points.
+       */
+      fastuidraw::vec2
+      direction(float t) const
+      {
+        fastuidraw::vec2 d(m_poly[1] + (2.0f * t) * m_poly[2]);
+        return (d.x() != 0.0f || d.y() != 0.0f) ?
+          d :
+          m_poly[1] + m_poly[2];
+      }
+
+      /* B(t) = m_poly[0] + t * m_poly[1] + t * t * m_poly[2] */
+      fastuidraw::vecN<fastuidraw::vec2, 3> m_poly;
+      fastuidraw::vec2 m_end, m_min, m_max;
+      uint32_t m_channels;
+    };
+
+    class SignedDistance
+    {
+    public:
+      SignedDistance(void):
+        m_distance(std::numeric_limits<float>::max()),
+        m_dot(1.0f),
+        m_t(0.0f),
+        m_curve(nullptr)
+      {}
+
+      /* when two curves are at the same distance, i.e. at the
+       * point they share, the curve more orthogonal to the
+       * direction to the point is the closer.
+       */
+      bool
+      operator<(const SignedDistance &rhs) const
+      {
+        float a(fastuidraw::t_abs(m_distance));
+        float b(fastuidraw::t_abs(rhs.m_distance));
+        return a < b || (a == b && m_dot < rhs.m_dot);
+      }
+
+      float m_distance;
+      float m_dot;
+      float m_t;
+      const Curve *m_curve;
+    };
+
+    static
+    SignedDistance
+    signed_distance(const Curve &curve, const fastuidraw::vec2 &p);
+
+    static
+    float
+    pseudo_distance(const SignedDistance &d, const fastuidraw::vec2 &p);
+
+    static
+    bool
+    is_corner(fastuidraw::vec2 a, fastuidraw::vec2 b);
+
+    static
+    uint32_t
+    switch_channels(uint32_t channels, uint32_t banned);
+
+    static
+    void
+    assign_channels(fastuidraw::c_array<Curve> curves);
+
+    std::vector<Curve> m_curves;
+  };
+
+  /* Returns true if the channels of the texel a and its
+   * neighbor b are such that bilinear filtering between
+   * them gives a median that does not correspond to either
+   * texel; this is the clash test of msdfgen with the
+   * distances in units of texels.
+   */
+  bool
+  detect_clash(fastuidraw::vec3 a, fastuidraw::vec3 b, float threshold)
+  {
+    using namespace fastuidraw;
+
+    /* sort the channels so that the differences between
+     * a and b are decreasing
+     */
+    if (t_abs(b[1] - a[1]) < t_abs(b[2] - a[2]))
+      {
+        std::swap(a[1], a[2]);
+        std::swap(b[1], b[2]);
+      }
+    if (t_abs(b[0] - a[0]) < t_abs(b[1] - a[1]))
+      {
+        std::swap(a[0], a[1]);
+        std::swap(b[0], b[1]);
+        if (t_abs(b[1] - a[1]) < t_abs(b[2] - a[2]))
+          {
+            std::swap(a[1], a[2]);
+            std::swap(b[1], b[2]);
+          }
+      }
+
+    return t_abs(b[1] - a[1]) >= threshold
+      && !(b[0] == b[1] && b[0] == b[2])
+      && t_abs(a[2]) >= t_abs(b[2]);
+  }
 }
 
 //////////////////////////////////////////////
@@ -914,7 +1095,7 @@ compute_line_intersection(int pt, enum coordinate_type line_type,
 
 void
 Solver::
-compute_lines_intersection(enum coordinate_type tp, int step, int count,
+compute_lines_intersection(enum coordinate_type tp, int step, int begin, int end,
                            uint32_t solution_types_accepted,
                            const IntBezierCurve::transformation<int> &tr,
                            std::vector<std::vector<solution_pt> > *out_value) const
@@ -922,7 +1103,7 @@ compute_lines_intersection(enum coordinate_type tp, int step, int count,
   int cstart, cend;
   int fixed_coord(fixed_coordinate(tp));
 
-  FASTUIDRAWassert(out_value->size() == static_cast<unsigned int>(count));
+  FASTUIDRAWassert(out_value->size() >= static_cast<unsigned int>(end));
 
   if ((solution_types_accepted & outside_0_1) == 0)
     {
@@ -944,13 +1125,13 @@ compute_lines_intersection(enum coordinate_type tp, int step, int count,
        *    bbmin / step <= c <= bbmax / step
        */
 
-      cstart = fastuidraw::t_max(0, bbmin / step);
-      cend = fastuidraw::t_min(count, 2 + bbmax / step);
+      cstart = fastuidraw::t_max(begin, bbmin / step);
+      cend = fastuidraw::t_min(end, 2 + bbmax / step);
     }
   else
     {
-      cstart = 0;
-      cend = count;
+      cstart = begin;
+      cend = end;
     }
 
   for(int c = cstart; c < cend; ++c)
@@ -973,18 +1154,24 @@ record_distance_value_from_canidate(const fastuidraw::vecN<T, 2> &p, int radius,
                                     fastuidraw::array2d<distance_value> &dst)
 {
   ivec2 ip(p);
+  int miny(fastuidraw::t_max(0, ip.y() - radius));
+  int maxy(fastuidraw::t_min(count.y(), ip.y() + radius));
+
+  /* the values of dst(x, y) for a fixed x are contiguous,
+   * so the inner loop is along y with the x-term hoisted.
+   */
   for(int x = fastuidraw::t_max(0, ip.x() - radius),
         maxx = fastuidraw::t_min(count.x(), ip.x() + radius);
       x < maxx; ++x)
     {
-      for(int y = fastuidraw::t_max(0, ip.y() - radius),
-            maxy = fastuidraw::t_min(count.y(), ip.y() + radius);
-          y < maxy; ++y)
+      T dx;
+
+      dx = fastuidraw::t_abs(T(x * step.x()) - p.x());
+      for(int y = miny; y < maxy; ++y)
         {
           T v;
 
-          v = fastuidraw::t_abs(T(x * step.x()) - p.x())
-            + fastuidraw::t_abs(T(y * step.y()) - p.y());
+          v = dx + fastuidraw::t_abs(T(y * step.y()) - p.y());
           dst(x, y).record_distance_value(static_cast<float>(v));
         }
     }
@@ -1090,6 +1277,16 @@ compute_fixed_line_values(const ivec2 &step, const ivec2 &count,
   compute_fixed_line_values(Solver::y_fixed, work_room1, step, count, tr, dst);
 }
 
+void
+DistanceFieldGenerator::
+compute_winding_numbers(const ivec2 &step, const ivec2 &count,
+                        const IntBezierCurve::transformation<int> &tr,
+                        fastuidraw::array2d<distance_value> &dst) const
+{
+  std::vector<std::vector<Solver::solution_pt> > work_room;
+  compute_fixed_line_values(Solver::x_fixed, work_room, step, count, tr, dst);
+}
+
 
 void
 DistanceFieldGenerator::
@@ -1110,94 +1307,433 @@ compute_fixed_line_values(enum Solver::coordinate_type tp,
   const int winding_sgn((tp == Solver::x_fixed) ? 1 : -1);
 
   work_room.resize(count[fixed_coord]);
-  for(int i = 0; i < count[fixed_coord]; ++i)
+
+  /* Each job handles a range of lines: it records the solutions
+   * of every curve against its lines and then does the distance
+   * computation along them; jobs write to disjoint lines of dst.
+   */
+  fastuidraw::detail::SharedThreadPool::get().parallel_for(count[fixed_coord], 8u,
+                                                           [&](unsigned int begin, unsigned int end)
+  {
+    for(unsigned int i = begin; i < end; ++i)
+      {
+        work_room[i].clear();
+      }
+
+    /* record the solutions for each fixed line */
+    for(const IntContour &contour: m_contours)
+      {
+        const std::vector<IntBezierCurve> &curves(contour.curves());
+        for(const IntBezierCurve &curve : curves)
+          {
+            Solver(curve).compute_lines_intersection(tp, step[fixed_coord],
+                                                     begin, end,
+                                                     Solver::within_0_1,
+                                                     tr, &work_room);
+          }
+      }
+
+    /* now for each line, do the distance computation along the line. */
+    for(int c = begin; c < int(end); ++c)
+      {
+        std::vector<Solver::solution_pt> &L(work_room[c]);
+        int total_cnt(0), winding(0);
+
+        /* sort by the value in the varying coordinate
+         */
+        std::sort(L.begin(), L.end(), Solver::CompareSolutions(varying_coord));
+        for(const Solver::solution_pt &S : L)
+          {
+            FASTUIDRAWassert(S.m_multiplicity > 0);
+            FASTUIDRAWassert(S.m_type != Solver::on_1_boundary);
+            FASTUIDRAWassert(S.m_t < 1.0f && S.m_t >= 0.0f);
+            total_cnt += S.m_multiplicity;
+          }
+
+        for(int v = 0, current_cnt = 0, current_idx = 0, sz = L.size();
+            v < count[varying_coord]; ++v)
+          {
+            ivec2 pixel;
+            float p;
+            int prev_idx;
+
+            p = static_cast<float>(step[varying_coord] * v);
+            pixel[fixed_coord] = c;
+            pixel[varying_coord] = v;
+
+            prev_idx = current_idx;
+
+            /* advance to the next along the line L just after p
+             */
+            while(current_idx < sz && L[current_idx].m_p[varying_coord] < p)
+              {
+                FASTUIDRAWassert(L[current_idx].m_multiplicity > 0);
+                current_cnt += L[current_idx].m_multiplicity;
+
+                if (L[current_idx].m_p_t[fixed_coord] > 0.0f)
+                  {
+                    winding += 1;
+                  }
+                else if (L[current_idx].m_p_t[fixed_coord] < 0.0f)
+                  {
+                    winding -= 1;
+                  }
+                ++current_idx;
+              }
+
+            /* update the distance values for all those points between
+             * the point on the line we were at before the loop start
+             * and the point on the line we are at now
+             */
+            for(int idx = fastuidraw::t_max(0, prev_idx - 1),
+                  end_idx = fastuidraw::t_min(sz, current_idx + 1);
+                idx < end_idx; ++idx)
+              {
+                float f;
+                f = fastuidraw::t_abs(p - L[idx].m_p[varying_coord]);
+                dst(pixel.x(), pixel.y()).record_distance_value(f);
+              }
+
+            /* update the ray-intersection counts */
+            dst(pixel.x(), pixel.y()).increment_ray_intersection_count(ray_types[fixed_coord][0], current_cnt);
+            dst(pixel.x(), pixel.y()).increment_ray_intersection_count(ray_types[fixed_coord][1], total_cnt - current_cnt);
+
+            /* set winding number */
+            dst(pixel.x(), pixel.y()).set_winding_number(tp, winding_sgn * winding);
+          }
+      }
+  });
+}
+
+//////////////////////////////////////////////
+// MultiChannelDistanceFieldGenerator methods
+MultiChannelDistanceFieldGenerator::
+MultiChannelDistanceFieldGenerator(const std::vector<IntContour> &contours,
+                                   const IntBezierCurve::transformation<int> &tr,
+                                   const ivec2 &step)
+{
+  fastuidraw::vec2 recip_step(1.0f / static_cast<float>(step.x()),
+                              1.0f / static_cast<float>(step.y()));
+  float sc(static_cast<float>(tr.scale()));
+  fastuidraw::vec2 translate(tr.translate());
+
+  for(const IntContour &contour : contours)
     {
-      work_room[i].clear();
+      unsigned int start(m_curves.size());
+
+      for(const IntBezierCurve &curve : contour.curves())
+        {
+          fastuidraw::vecN<fastuidraw::c_array<const int>, 2> poly(curve.as_polynomial());
+          Curve C;
+
+          FASTUIDRAWassert(curve.degree() <= 2);
+          for (unsigned int i = 0; i < 3; ++i)
+            {
+              for (int coord = 0; coord < 2; ++coord)
+                {
+                  float v;
+
+                  v = (i < poly[coord].size()) ?
+                    sc * static_cast<float>(poly[coord][i]) :
+                    0.0f;
+                  if (i == 0)
+                    {
+                      v += translate[coord];
+                    }
+                  C.m_poly[i][coord] = v * recip_step[coord];
+                }
+            }
+
+          for (int coord = 0; coord < 2; ++coord)
+            {
+              float v;
+
+              v = sc * static_cast<float>(curve.control_pts().back()[coord]) + translate[coord];
+              C.m_end[coord] = v * recip_step[coord];
+            }
+
+          /* skip curves that are just a point */
+          if (C.m_poly[1] == fastuidraw::vec2(0.0f) && C.m_poly[2] == fastuidraw::vec2(0.0f))
+            {
+              continue;
+            }
+
+          /* the control points of the quadratic contain it */
+          fastuidraw::vec2 p0(C.m_poly[0]);
+          fastuidraw::vec2 p1(C.m_poly[0] + 0.5f * C.m_poly[1]);
+          fastuidraw::vec2 p2(C.eval(1.0f));
+
+          C.m_min.x() = fastuidraw::t_min(p0.x(), fastuidraw::t_min(p1.x(), p2.x()));
+          C.m_min.y() = fastuidraw::t_min(p0.y(), fastuidraw::t_min(p1.y(), p2.y()));
+          C.m_max.x() = fastuidraw::t_max(p0.x(), fastuidraw::t_max(p1.x(), p2.x()));
+          C.m_max.y() = fastuidraw::t_max(p0.y(), fastuidraw::t_max(p1.y(), p2.y()));
+          C.m_channels = all_channels;
+          m_curves.push_back(C);
+        }
+
+      fastuidraw::c_array<Curve> curves(fastuidraw::make_c_array(m_curves));
+      assign_channels(curves.sub_array(start));
     }
+}
 
-  /* record the solutions for each fixed line */
-  for(const IntContour &contour: m_contours)
+bool
+MultiChannelDistanceFieldGenerator::
+is_corner(fastuidraw::vec2 a, fastuidraw::vec2 b)
+{
+  /* sin(3), the default angle threshold (in radians) of msdfgen */
+  const float cross_threshold(0.14112001f);
+
+  a.normalize();
+  b.normalize();
+  return fastuidraw::dot(a, b) <= 0.0f
+    || fastuidraw::t_abs(a.x() * b.y() - a.y() * b.x()) > cross_threshold;
+}
+
+uint32_t
+MultiChannelDistanceFieldGenerator::
+switch_channels(uint32_t channels, uint32_t banned)
+{
+  uint32_t combined(channels & banned), shifted;
+
+  if (combined == red_channel || combined == green_channel || combined == blue_channel)
     {
-      const std::vector<IntBezierCurve> &curves(contour.curves());
-      for(const IntBezierCurve &curve : curves)
+      return combined ^ all_channels;
+    }
+
+  if (channels == 0u || channels == all_channels)
+    {
+      return green_channel | blue_channel;
+    }
+
+  /* cycle cyan -> magenta -> yellow -> cyan */
+  shifted = channels << 1u;
+  return (shifted | (shifted >> 3u)) & all_channels;
+}
+
+void
+MultiChannelDistanceFieldGenerator::
+assign_channels(fastuidraw::c_array<Curve> curves)
+{
+  std::vector<unsigned int> corners;
+  unsigned int n(curves.size());
+
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      const Curve &prev(curves[(i + n - 1u) % n]);
+      if (is_corner(prev.direction(1.0f), curves[i].direction(0.0f)))
         {
-          Solver(curve).compute_lines_intersection(tp, step[fixed_coord],
-                                                   count[fixed_coord],
-                                                   Solver::within_0_1,
-                                                   tr, &work_room);
+          corners.push_back(i);
         }
     }
 
-  /* now for each line, do the distance computation along the line. */
-  for(int c = 0; c < count[fixed_coord]; ++c)
+  if (corners.empty())
     {
-      std::vector<Solver::solution_pt> &L(work_room[c]);
-      int total_cnt(0), winding(0);
+      /* smooth contour, all curves in all channels */
+      return;
+    }
 
-      /* sort by the value in the varying coordinate
+  if (corners.size() == 1u)
+    {
+      /* a tear drop; split the contour into three arcs with
+       * the arcs meeting at the corner not sharing channels.
        */
-      std::sort(L.begin(), L.end(), Solver::CompareSolutions(varying_coord));
-      for(const Solver::solution_pt &S : L)
+      fastuidraw::vecN<uint32_t, 3> channels;
+
+      if (n < 3u)
         {
-          FASTUIDRAWassert(S.m_multiplicity > 0);
-          FASTUIDRAWassert(S.m_type != Solver::on_1_boundary);
-          FASTUIDRAWassert(S.m_t < 1.0f && S.m_t >= 0.0f);
-          total_cnt += S.m_multiplicity;
+          return;
         }
 
-      for(int v = 0, current_cnt = 0, current_idx = 0, sz = L.size();
-          v < count[varying_coord]; ++v)
+      channels[0] = switch_channels(all_channels, 0u);
+      channels[1] = all_channels;
+      channels[2] = switch_channels(channels[0], 0u);
+      for (unsigned int i = 0; i < n; ++i)
         {
-          ivec2 pixel;
-          float p;
-          int prev_idx;
-
-          p = static_cast<float>(step[varying_coord] * v);
-          pixel[fixed_coord] = c;
-          pixel[varying_coord] = v;
+          curves[(corners[0] + i) % n].m_channels = channels[(3u * i) / n];
+        }
+      return;
+    }
 
-          prev_idx = current_idx;
+  /* change the channels at each corner, with the last
+   * arc also to differ from the first arc.
+   */
+  unsigned int m(corners.size()), arc(0);
+  uint32_t channels, initial;
 
-          /* advance to the next along the line L just after p
-           */
-          while(current_idx < sz && L[current_idx].m_p[varying_coord] < p)
-            {
-              FASTUIDRAWassert(L[current_idx].m_multiplicity > 0);
-              current_cnt += L[current_idx].m_multiplicity;
+  channels = initial = switch_channels(all_channels, 0u);
+  for (unsigned int i = 0; i < n; ++i)
+    {
+      unsigned int index((corners[0] + i) % n);
+      if (arc + 1u < m && corners[arc + 1u] == index)
+        {
+          ++arc;
+          channels = switch_channels(channels, (arc == m - 1u) ? initial : 0u);
+        }
+      curves[index].m_channels = channels;
+    }
+}
 
-              if (L[current_idx].m_p_t[fixed_coord] > 0.0f)
-                {
-                  winding += 1;
-                }
-              else if (L[current_idx].m_p_t[fixed_coord] < 0.0f)
-                {
-                  winding -= 1;
-                }
-              ++current_idx;
-            }
+MultiChannelDistanceFieldGenerator::SignedDistance
+MultiChannelDistanceFieldGenerator::
+signed_distance(const Curve &curve, const fastuidraw::vec2 &p)
+{
+  using namespace fastuidraw;
 
-          /* update the distance values for all those points between
-           * the point on the line we were at before the loop start
-           * and the point on the line we are at now
-           */
-          for(int idx = fastuidraw::t_max(0, prev_idx - 1),
-                end_idx = fastuidraw::t_min(sz, current_idx + 1);
-              idx < end_idx; ++idx)
-            {
-              float f;
-              f = fastuidraw::t_abs(p - L[idx].m_p[varying_coord]);
-              dst(pixel.x(), pixel.y()).record_distance_value(f);
-            }
+  /* the closest point is at an end point or where the
+   * derivative of |B(t) - p|^2 vanishes, i.e. the roots
+   * of dot(B(t) - p, B'(t)) in (0, 1).
+   */
+  vec2 q0(curve.m_poly[0] - p);
+  const vec2 &a1(curve.m_poly[1]), &a2(curve.m_poly[2]);
+  vecN<float, 4> poly;
+  vecN<Solver::poly_solution, 3> roots;
+  Solver::poly_solutions<Solver::poly_solution*> solutions(roots.c_ptr());
+  float best_t, best_d2;
+  SignedDistance R;
+  vec2 q, dir;
+
+  poly[0] = dot(q0, a1);
+  poly[1] = 2.0f * dot(q0, a2) + dot(a1, a1);
+  poly[2] = 3.0f * dot(a1, a2);
+  poly[3] = 2.0f * dot(a2, a2);
+  Solver::solve_polynomial(c_array<const float>(poly), Solver::within_0_1, &solutions);
+  solutions.finalize();
 
-          /* update the ray-intersection counts */
-          dst(pixel.x(), pixel.y()).increment_ray_intersection_count(ray_types[fixed_coord][0], current_cnt);
-          dst(pixel.x(), pixel.y()).increment_ray_intersection_count(ray_types[fixed_coord][1], total_cnt - current_cnt);
+  best_t = 0.0f;
+  best_d2 = dot(q0, q0);
+  for (unsigned int i = 0, endi = solutions.size() + 1u; i < endi; ++i)
+    {
+      float t, d2;
 
-          /* set winding number */
-          dst(pixel.x(), pixel.y()).set_winding_number(tp, winding_sgn * winding);
+      t = (i < solutions.size()) ? roots[i].m_t : 1.0f;
+      q = curve.eval(t) - p;
+      d2 = dot(q, q);
+      if (d2 < best_d2)
+        {
+          best_d2 = d2;
+          best_t = t;
         }
+    }
+
+  q = curve.eval(best_t) - p;
+  dir = curve.direction(best_t);
+  R.m_distance = t_sqrt(best_d2);
+  if (dir.x() * q.y() - dir.y() * q.x() <= 0.0f)
+    {
+      R.m_distance = -R.m_distance;
+    }
+
+  if ((best_t == 0.0f || best_t == 1.0f) && best_d2 > 0.0f)
+    {
+      R.m_dot = t_abs(dot(dir, q)) / (dir.magnitude() * q.magnitude());
+    }
+  else
+    {
+      R.m_dot = 0.0f;
+    }
+  R.m_t = best_t;
+  R.m_curve = &curve;
 
+  return R;
+}
+
+float
+MultiChannelDistanceFieldGenerator::
+pseudo_distance(const SignedDistance &d, const fastuidraw::vec2 &p)
+{
+  using namespace fastuidraw;
+
+  /* if the closest point is an end point and p is beyond
+   * the end point, the distance is to the line tangent
+   * to the curve at the end point.
+   */
+  if (d.m_t == 0.0f || d.m_t == 1.0f)
+    {
+      vec2 dir(d.m_curve->direction(d.m_t));
+      vec2 q(p - d.m_curve->eval(d.m_t));
+      float ts(dot(q, dir));
+
+      if ((d.m_t == 0.0f && ts < 0.0f) || (d.m_t == 1.0f && ts > 0.0f))
+        {
+          float pd;
+
+          pd = (q.x() * dir.y() - q.y() * dir.x()) / dir.magnitude();
+          if (t_abs(pd) <= t_abs(d.m_distance))
+            {
+              return pd;
+            }
+        }
     }
+  return d.m_distance;
+}
+
+void
+MultiChannelDistanceFieldGenerator::
+compute_distance_values(const ivec2 &count,
+                        fastuidraw::array2d<fastuidraw::vec3> &out_pseudo_distances,
+                        fastuidraw::array2d<float> &out_distances) const
+{
+  fastuidraw::detail::SharedThreadPool::get().parallel_for(count.y(), 4u,
+                                                           [&](unsigned int begin, unsigned int end)
+  {
+    using namespace fastuidraw;
+
+    for (int y = begin; y < int(end); ++y)
+      {
+        for (int x = 0; x < count.x(); ++x)
+          {
+            vec2 p(static_cast<float>(x), static_cast<float>(y));
+            vecN<SignedDistance, 3> closest;
+            SignedDistance overall;
+
+            for (const Curve &C : m_curves)
+              {
+                bool needed(false);
+                vec2 delta;
+                float lower_bound;
+
+                /* the distance to the bounding box of the curve
+                 * bounds from below the distance to the curve.
+                 */
+                delta.x() = t_max(0.0f, t_max(C.m_min.x() - p.x(), p.x() - C.m_max.x()));
+                delta.y() = t_max(0.0f, t_max(C.m_min.y() - p.y(), p.y() - C.m_max.y()));
+                lower_bound = delta.magnitude();
+                for (unsigned int c = 0; c < 3; ++c)
+                  {
+                    needed = needed
+                      || ((C.m_channels & (1u << c)) != 0u
+                          && lower_bound <= t_abs(closest[c].m_distance));
+                  }
+
+                if (!needed)
+                  {
+                    continue;
+                  }
+
+                SignedDistance d(signed_distance(C, p));
+                for (unsigned int c = 0; c < 3; ++c)
+                  {
+                    if ((C.m_channels & (1u << c)) != 0u && d < closest[c])
+                      {
+                        closest[c] = d;
+                      }
+                  }
+                if (d < overall)
+                  {
+                    overall = d;
+                  }
+              }
+
+            for (unsigned int c = 0; c < 3; ++c)
+              {
+                out_pseudo_distances(x, y)[c] = (closest[c].m_curve) ?
+                  pseudo_distance(closest[c], p) :
+                  overall.m_distance;
+              }
+            out_distances(x, y) = overall.m_distance;
+          }
+      }
+  });
 }
 
 //////////////////////////////////////////////
@@ -1694,34 +2230,168 @@ extract_render_data(const ivec2 &step, const ivec2 &image_sz,
   dst->resize(image_sz);
   c_array<uint8_t> texel_data(dst->texel_data());
 
-  std::fill(texel_data.begin(), texel_data.end(), 0);
+  /* evaluate the fill rule once for each winding number
+   * present instead of twice per texel.
+   */
+  int min_winding(0), max_winding(0);
+  for(int x = 0; x < image_sz.x(); ++x)
+    {
+      for(int y = 0; y < image_sz.y(); ++y)
+        {
+          const distance_value &d(dist_values(x, y));
+          min_winding = t_min(min_winding, t_min(d.winding_number(Solver::x_fixed),
+                                                 d.winding_number(Solver::y_fixed)));
+          max_winding = t_max(max_winding, t_max(d.winding_number(Solver::x_fixed),
+                                                 d.winding_number(Solver::y_fixed)));
+        }
+    }
+
+  std::vector<uint8_t> outside(max_winding - min_winding + 1);
+  for(int w = min_winding; w <= max_winding; ++w)
+    {
+      outside[w - min_winding] = fill_rule(w) ? 0u : 1u;
+    }
+
+  fastuidraw::detail::SharedThreadPool::get().parallel_for(image_sz.y(), 16u,
+                                                           [&](unsigned int begin, unsigned int end)
+  {
+    for(int y = begin; y < int(end); ++y)
+      {
+        for(int x = 0; x < image_sz.x(); ++x)
+          {
+            bool outside1, outside2;
+            float dist;
+            uint8_t v;
+            int w1, w2;
+            unsigned int location;
+
+            w1 = dist_values(x, y).winding_number(Solver::x_fixed);
+            w2 = dist_values(x, y).winding_number(Solver::y_fixed);
+
+            outside1 = outside[w1 - min_winding];
+            outside2 = outside[w2 - min_winding];
+
+            dist = dist_values(x, y).distance(max_distance) / max_distance;
+            if (outside1 != outside2)
+              {
+                /* if the fills do not match, then a curve is going through
+                 * the test point of the texel, thus make the distance 0
+                 */
+                dist = 0.0f;
+              }
+            v = DistanceFieldGenerator::pixel_value_from_distance(dist, outside1);
+            location = x + y * image_sz.x();
+            texel_data[location] = v;
+          }
+      }
+  });
+}
+
+void
+fastuidraw::detail::IntPath::
+extract_render_data(const ivec2 &step, const ivec2 &image_sz,
+                    float max_distance,
+                    IntBezierCurve::transformation<int> tr,
+                    const CustomFillRuleBase &fill_rule,
+                    GlyphRenderDataMultiChannelDistanceField *dst) const
+{
+  array2d<distance_value> winding_values(image_sz.x(), image_sz.y());
+  array2d<vec3> pseudo_distances(image_sz.x(), image_sz.y());
+  array2d<float> distances(image_sz.x(), image_sz.y());
+  float sgn, recip_max_distance;
+  int agree(0);
+
+  /* sample at the center of the texels, see the comment
+   * in the single channel extract_render_data().
+   */
+  int tr_scale(tr.scale());
+  ivec2 tr_translate(tr.translate() - step / 2 - ivec2(1, 1));
+  tr = IntBezierCurve::transformation<int>(tr_scale, tr_translate);
+
+  DistanceFieldGenerator(m_contours).compute_winding_numbers(step, image_sz, tr, winding_values);
+  MultiChannelDistanceFieldGenerator(m_contours, tr, step).compute_distance_values(image_sz,
+                                                                                    pseudo_distances,
+                                                                                    distances);
+
+  /* The sign of the distances is from the orientation of the
+   * curves, which is opposite between TrueType and CFF outlines;
+   * take the sign that agrees the most with the fill rule.
+   */
+  for(int x = 0; x < image_sz.x(); ++x)
+    {
+      for(int y = 0; y < image_sz.y(); ++y)
+        {
+          bool inside(fill_rule(winding_values(x, y).winding_number(Solver::x_fixed)));
+          agree += ((distances(x, y) > 0.0f) == inside) ? 1 : -1;
+        }
+    }
+  sgn = (agree >= 0) ? 1.0f : -1.0f;
+
+  for(int y = 0; y < image_sz.y(); ++y)
+    {
+      for(int x = 0; x < image_sz.x(); ++x)
+        {
+          bool inside;
+          vec3 &v(pseudo_distances(x, y));
+          float median;
+
+          inside = fill_rule(winding_values(x, y).winding_number(Solver::x_fixed));
+          v *= sgn;
+          median = t_max(t_min(v[0], v[1]), t_min(t_max(v[0], v[1]), v[2]));
+
+          /* if the median disagrees with the fill rule, the channels
+           * are not usable at the texel and all take the distance
+           */
+          if ((median > 0.0f) != inside)
+            {
+              float d(t_abs(distances(x, y)));
+              v = vec3((inside) ? d : -d);
+            }
+        }
+    }
+
+  /* Bilinear filtering between two neighboring texels whose
+   * channels disagree on which edge is closest gives artifacts
+   * along the line between them; such texels are collapsed to
+   * their median so that all channels agree.
+   */
+  std::vector<bool> clashes(image_sz.x() * image_sz.y(), false);
   for(int y = 0; y < image_sz.y(); ++y)
     {
       for(int x = 0; x < image_sz.x(); ++x)
         {
-          bool outside1, outside2;
-          float dist;
-          uint8_t v;
-          int w1, w2;
-          unsigned int location;
+          const vec3 &v(pseudo_distances(x, y));
+          bool clash(false);
+
+          clash = clash || (x > 0 && detect_clash(v, pseudo_distances(x - 1, y), 1.001f));
+          clash = clash || (x + 1 < image_sz.x() && detect_clash(v, pseudo_distances(x + 1, y), 1.001f));
+          clash = clash || (y > 0 && detect_clash(v, pseudo_distances(x, y - 1), 1.001f));
+          clash = clash || (y + 1 < image_sz.y() && detect_clash(v, pseudo_distances(x, y + 1), 1.001f));
+          clashes[x + y * image_sz.x()] = clash;
+        }
+    }
 
-          w1 = dist_values(x, y).winding_number(Solver::x_fixed);
-          w2 = dist_values(x, y).winding_number(Solver::y_fixed);
+  recip_max_distance = static_cast<float>(step.x()) / max_distance;
+  dst->resize(image_sz);
+  c_array<u8vec3> texel_data(dst->texel_data());
+  for(int y = 0; y < image_sz.y(); ++y)
+    {
+      for(int x = 0; x < image_sz.x(); ++x)
+        {
+          vec3 v(pseudo_distances(x, y));
 
-          outside1 = !fill_rule(w1);
-          outside2 = !fill_rule(w2);
+          if (clashes[x + y * image_sz.x()])
+            {
+              v = vec3(t_max(t_min(v[0], v[1]), t_min(t_max(v[0], v[1]), v[2])));
+            }
 
-          dist = dist_values(x, y).distance(max_distance) / max_distance;
-          if (outside1 != outside2)
+          for (unsigned int c = 0; c < 3; ++c)
             {
-              /* if the fills do not match, then a curve is going through
-               * the test point of the texel, thus make the distance 0
-               */
-              dist = 0.0f;
+              float f;
+
+              f = t_max(-1.0f, t_min(1.0f, v[c] * recip_max_distance));
+              texel_data[x + y * image_sz.x()][c] = static_cast<uint8_t>(255.0f * 0.5f * (f + 1.0f));
             }
-          v = DistanceFieldGenerator::pixel_value_from_distance(dist, outside1);
-          location = x + y * image_sz.x();
-          texel_data[location] = v;
         }
     }
 }
@@ -28,6 +28,7 @@
 #include <fastuidraw/path.hpp>
 #include <fastuidraw/painter/fill_rule.hpp>
 #include <fastuidraw/text/glyph_render_data_texels.hpp>
+#include <fastuidraw/text/glyph_render_data_multi_channel_distance_field.hpp>
 
 #include <private/array2d.hpp>
 #include <private/bounding_box.hpp>
@@ -448,6 +449,21 @@ namespace fastuidraw
                           const CustomFillRuleBase &fill_rule,
                           GlyphRenderDataTexels *dst) const;
 
+      /* Compute multi-channel distance field data, where distance
+       * values are sampled at the center of each texel. All curves
+       * of the IntPath must be of degree at most two.
+       * \param texel_size the size of each texel in coordinates
+       *                   AFTER tr is applied
+       * \param image_sz size of the distance field to make
+       * \param tr transformation to apply to data of path
+       */
+      void
+      extract_render_data(const ivec2 &texel_size, const ivec2 &image_sz,
+                          float max_distance,
+                          IntBezierCurve::transformation<int> tr,
+                          const CustomFillRuleBase &fill_rule,
+                          GlyphRenderDataMultiChannelDistanceField *dst) const;
+
     private:
       IntBezierCurve::ID_t
       computeID(void);
@@ -20,6 +20,7 @@
 #include <vector>
 #include <list>
 #include <cstring>
+#include <fastuidraw/util/trace_events.hpp>
 
 #include <private/painter_backend/painter_packer.hpp>
 #include <private/painter_backend/painter_packed_value_pool_private.hpp>
@@ -172,8 +173,7 @@ namespace
 class fastuidraw::PainterPacker::per_draw_command
 {
 public:
-  explicit
-  per_draw_command(const reference_counted_ptr<PainterDraw> &r);
+  per_draw_command(const reference_counted_ptr<PainterDraw> &r, unsigned int id);
 
   unsigned int
   attribute_room(void) const
@@ -210,13 +210,23 @@ public:
     m_draw_command->unmap(m_attributes_written, m_indices_written, store_written());
   }
 
+  /* reverse the order of the index ranges starting at
+   * the values of m_item_begins; only possible if no
+   * draw break is after the start of the indices.
+   */
+  void
+  reverse_items(std::vector<PainterIndex> &scratch);
+
   void
   pack_painter_state(enum fastuidraw::PainterSurface::render_type_t render_type,
                      const PainterPackerData &state,
                      PainterPacker *p, painter_state_location &out_data);
 
+  /* returns true if a draw break was needed; if so, writes to
+   * out_break_stat the draw-break reason from PainterEnums::query_stats_t
+   */
   template<typename T>
-  bool //returns true if a draw break was needed
+  bool
   pack_header(enum fastuidraw::PainterSurface::render_type_t render_type,
               unsigned int header_size,
               fastuidraw::ivec2 deferred_coverage_buffer_offset,
@@ -227,13 +237,15 @@ public:
               int z,
               const painter_state_location &loc,
               const std::list<reference_counted_ptr<PainterPacker::DataCallBack> > &call_backs,
-              unsigned int *header_location);
+              unsigned int *header_location,
+              enum fastuidraw::PainterEnums::query_stats_t *out_break_stat);
 
   bool
   draw_break(const reference_counted_ptr<const PainterDrawBreakAction> &action)
   {
     if (action)
       {
+        m_has_inner_break = m_has_inner_break || m_indices_written > 0;
         return m_draw_command->draw_break(action, m_indices_written);
       }
     return false;
@@ -242,6 +254,15 @@ public:
   reference_counted_ptr<PainterDraw> m_draw_command;
   unsigned int m_attributes_written, m_indices_written;
 
+  /* value of PainterPacker::m_number_commands when created */
+  unsigned int m_id;
+
+  /* for the opaque stream, the start of the indices of
+   * each draw and if a draw break is after the start
+   */
+  std::vector<unsigned int> m_item_begins;
+  bool m_has_inner_break;
+
 private:
   c_array<generic_data>
   allocate_store(unsigned int num_elements);
@@ -276,10 +297,12 @@ private:
 //////////////////////////////////////////
 // fastuidraw::PainterPacker::per_draw_command methods
 fastuidraw::PainterPacker::per_draw_command::
-per_draw_command(const reference_counted_ptr<PainterDraw> &r):
+per_draw_command(const reference_counted_ptr<PainterDraw> &r, unsigned int id):
   m_draw_command(r),
   m_attributes_written(0),
   m_indices_written(0),
+  m_id(id),
+  m_has_inner_break(false),
   m_store_blocks_written(0)
 {
   m_prev_state.m_item_group = 0;
@@ -289,6 +312,33 @@ per_draw_command(const reference_counted_ptr<PainterDraw> &r):
   m_prev_state.m_blend_shader_type = fastuidraw::PainterBlendShader::number_types;
 }
 
+void
+fastuidraw::PainterPacker::per_draw_command::
+reverse_items(std::vector<PainterIndex> &scratch)
+{
+  c_array<PainterIndex> indices;
+  unsigned int dst;
+
+  if (m_has_inner_break || m_item_begins.size() < 2)
+    {
+      return;
+    }
+
+  indices = m_draw_command->m_indices.sub_array(0, m_indices_written);
+  scratch.assign(indices.begin(), indices.end());
+
+  dst = 0;
+  for (unsigned int i = m_item_begins.size(), end = m_indices_written; i > 0; --i)
+    {
+      unsigned int begin(m_item_begins[i - 1]);
+
+      std::copy(scratch.begin() + begin, scratch.begin() + end, indices.begin() + dst);
+      dst += end - begin;
+      end = begin;
+    }
+  FASTUIDRAWassert(dst == m_indices_written);
+}
+
 fastuidraw::c_array<fastuidraw::generic_data>
 fastuidraw::PainterPacker::per_draw_command::
 allocate_store(unsigned int num_elements)
@@ -349,7 +399,7 @@ pack_state_data(enum fastuidraw::PainterSurface::render_type_t render_type,
                 detail::PackedValuePoolBase::ElementBase *d,
                 uint32_t &location)
 {
-  if (d->m_painter[render_type] == p && d->m_draw_command_id[render_type] == p->m_number_commands)
+  if (d->m_painter[render_type] == p && d->m_draw_command_id[render_type] == m_id)
     {
       location = d->m_offset[render_type];
       return;
@@ -367,7 +417,7 @@ pack_state_data(enum fastuidraw::PainterSurface::render_type_t render_type,
   std::copy(src.begin(), src.end(), dst.begin());
 
   d->m_painter[render_type] = p;
-  d->m_draw_command_id[render_type] = p->m_accumulated_draws.size();
+  d->m_draw_command_id[render_type] = m_id;
   d->m_offset[render_type] = location;
 }
 
@@ -419,7 +469,8 @@ pack_header(enum fastuidraw::PainterSurface::render_type_t render_type,
             int z,
             const painter_state_location &loc,
             const std::list<reference_counted_ptr<PainterPacker::DataCallBack> > &call_backs,
-            unsigned int *header_location)
+            unsigned int *header_location,
+            enum fastuidraw::PainterEnums::query_stats_t *out_break_stat)
 {
   bool return_value(false);
   c_array<generic_data> dst;
@@ -472,16 +523,26 @@ pack_header(enum fastuidraw::PainterSurface::render_type_t render_type,
   header.m_offset_to_deferred_coverage = deferred_coverage_buffer_offset;
   header.pack_data(dst);
 
-  if (current.m_item_group != m_prev_state.m_item_group
-      || current.m_blend_mode != m_prev_state.m_blend_mode
-      || (render_type == PainterSurface::color_buffer_type &&
-          (current.m_blend_group != m_prev_state.m_blend_group
-           || current.m_blend_shader_type != m_prev_state.m_blend_shader_type
-           || current.m_brush_group != m_prev_state.m_brush_group) != 0u))
+  bool shader_change, blend_change;
+
+  shader_change = current.m_item_group != m_prev_state.m_item_group
+    || (render_type == PainterSurface::color_buffer_type
+        && current.m_brush_group != m_prev_state.m_brush_group);
+
+  blend_change = current.m_blend_mode != m_prev_state.m_blend_mode
+    || (render_type == PainterSurface::color_buffer_type &&
+        (current.m_blend_group != m_prev_state.m_blend_group
+         || current.m_blend_shader_type != m_prev_state.m_blend_shader_type));
+
+  if (shader_change || blend_change)
     {
+      m_has_inner_break = m_has_inner_break || m_indices_written > 0;
       return_value = m_draw_command->draw_break(render_type,
                                                 m_prev_state, current,
                                                 m_indices_written);
+      *out_break_stat = (shader_change) ?
+        PainterEnums::num_draw_breaks_shader_change :
+        PainterEnums::num_draw_breaks_blend_change;
     }
 
   m_prev_state = current;
@@ -527,12 +588,15 @@ active(void) const
 fastuidraw::PainterPacker::
 PainterPacker(PainterPackedValuePool &pool,
               vecN<unsigned int, num_stats> &stats,
+              detail::PainterTimers &timers,
               reference_counted_ptr<PainterBackend> backend):
   m_backend(backend),
   m_blend_shader(nullptr),
   m_number_commands(0),
   m_clear_color_buffer(false),
-  m_stats(stats)
+  m_active_draws(&m_accumulated_draws),
+  m_stats(stats),
+  m_timers(timers)
 {
   m_header_size = PainterHeader::data_size();
   m_default_brush.make_packed(pool);
@@ -545,23 +609,33 @@ fastuidraw::PainterPacker::
 
 void
 fastuidraw::PainterPacker::
-start_new_command(void)
+unmap_command(per_draw_command &c, bool reverse_items)
 {
-  if (!m_accumulated_draws.empty())
-    {
-      per_draw_command &c(m_accumulated_draws.back());
+  m_stats[PainterEnums::num_attributes] += c.m_attributes_written;
+  m_stats[PainterEnums::num_indices] += c.m_indices_written;
+  m_stats[PainterEnums::num_generic_datas] += c.store_written();
 
-      m_stats[PainterEnums::num_attributes] += c.m_attributes_written;
-      m_stats[PainterEnums::num_indices] += c.m_indices_written;
-      m_stats[PainterEnums::num_generic_datas] += c.store_written();
+  if (reverse_items)
+    {
+      c.reverse_items(m_work_room.m_indices);
+    }
+  c.unmap();
+}
 
-      c.unmap();
+void
+fastuidraw::PainterPacker::
+start_new_command(void)
+{
+  if (!m_active_draws->empty())
+    {
+      unmap_command(m_active_draws->back(), m_active_draws == &m_opaque_draws);
     }
 
+  TraceEvents::Scope trace("PainterPacker", "map_draw");
   reference_counted_ptr<PainterDraw> r;
   r = m_backend->map_draw();
   ++m_number_commands;
-  m_accumulated_draws.push_back(per_draw_command(r));
+  m_active_draws->push_back(per_draw_command(r, m_number_commands));
 }
 
 template<typename T>
@@ -573,7 +647,7 @@ compute_room_needed_for_packing(const PainterData::value<T> &obj)
     {
       detail::PackedValuePoolBase::ElementBase *d;
       d = static_cast<detail::PackedValuePoolBase::ElementBase*>(obj.m_packed_value.opaque_data());
-      if (d->m_painter[m_render_type] == this && d->m_draw_command_id[m_render_type] == m_number_commands)
+      if (d->m_painter[m_render_type] == this && d->m_draw_command_id[m_render_type] == m_active_draws->back().m_id)
         {
           return 0;
         }
@@ -622,13 +696,14 @@ upload_draw_state(const PainterPackerData &draw_state)
 {
   unsigned int needed_room;
 
-  FASTUIDRAWassert(!m_accumulated_draws.empty());
+  FASTUIDRAWassert(!m_active_draws->empty());
   needed_room = compute_room_needed_for_packing(draw_state);
-  if (needed_room > m_accumulated_draws.back().store_room())
+  if (needed_room > m_active_draws->back().store_room())
     {
+      ++m_stats[PainterEnums::num_draw_breaks_buffer_full];
       start_new_command();
     }
-  m_accumulated_draws.back().pack_painter_state(m_render_type, draw_state,
+  m_active_draws->back().pack_painter_state(m_render_type, draw_state,
                                                 this, m_painter_state_location);
 
   if (m_render_type == PainterSurface::color_buffer_type && draw_state.m_brush.has_data())
@@ -646,9 +721,10 @@ upload_draw_state(const PainterPackerData &draw_state)
 
               m_binded_images[i] = images[i].get();
               action = m_backend->bind_image(i, images[i]);
-              if (m_accumulated_draws.back().draw_break(action))
+              if (m_active_draws->back().draw_break(action))
                 {
                   ++m_stats[PainterEnums::num_draws];
+                  ++m_stats[PainterEnums::num_draw_breaks_action];
                 }
             }
         }
@@ -668,6 +744,7 @@ draw_generic_implement(ivec2 deferred_coverage_buffer_offset,
   unsigned int header_loc;
   const unsigned int NOT_LOADED = ~0u;
   unsigned int number_index_chunks, number_attribute_chunks;
+  unsigned int item_command(~0u);
 
   number_index_chunks = src.number_index_chunks();
   number_attribute_chunks = src.number_attribute_chunks();
@@ -679,6 +756,8 @@ draw_generic_implement(ivec2 deferred_coverage_buffer_offset,
       return;
     }
 
+  detail::PainterScopedTimer timer(m_timers, PainterEnums::time_packing_us);
+
   m_work_room.m_attribs_loaded.clear();
   m_work_room.m_attribs_loaded.resize(number_attribute_chunks, NOT_LOADED);
 
@@ -693,9 +772,9 @@ draw_generic_implement(ivec2 deferred_coverage_buffer_offset,
       unsigned int attrib_src, needed_attrib_room;
       unsigned int num_attribs, num_indices;
 
-      attrib_room = m_accumulated_draws.back().attribute_room();
-      index_room = m_accumulated_draws.back().index_room();
-      data_room = m_accumulated_draws.back().store_room();
+      attrib_room = m_active_draws->back().attribute_room();
+      index_room = m_active_draws->back().index_room();
+      data_room = m_active_draws->back().store_room();
 
       attrib_src = src.attribute_chunk_selection(chunk);
       FASTUIDRAWassert(attrib_src < number_attribute_chunks);
@@ -713,6 +792,7 @@ draw_generic_implement(ivec2 deferred_coverage_buffer_offset,
       if (attrib_room < needed_attrib_room || index_room < num_indices
          || (allocate_header && data_room < m_header_size))
         {
+          ++m_stats[PainterEnums::num_draw_breaks_buffer_full];
           start_new_command();
           upload_draw_state(draw);
 
@@ -721,9 +801,9 @@ draw_generic_implement(ivec2 deferred_coverage_buffer_offset,
           std::fill(m_work_room.m_attribs_loaded.begin(), m_work_room.m_attribs_loaded.end(), NOT_LOADED);
           needed_attrib_room = num_attribs;
 
-          attrib_room = m_accumulated_draws.back().attribute_room();
-          index_room = m_accumulated_draws.back().index_room();
-          data_room = m_accumulated_draws.back().store_room();
+          attrib_room = m_active_draws->back().attribute_room();
+          index_room = m_active_draws->back().index_room();
+          data_room = m_active_draws->back().store_room();
           allocate_header = true;
 
           if (attrib_room < needed_attrib_room || index_room < num_indices)
@@ -735,10 +815,11 @@ draw_generic_implement(ivec2 deferred_coverage_buffer_offset,
           FASTUIDRAWassert(data_room >= m_header_size);
         }
 
-      per_draw_command &cmd(m_accumulated_draws.back());
+      per_draw_command &cmd(m_active_draws->back());
       if (allocate_header)
         {
           bool draw_break_added;
+          enum PainterEnums::query_stats_t break_stat;
 
           ++m_stats[PainterEnums::num_headers];
           allocate_header = false;
@@ -749,10 +830,11 @@ draw_generic_implement(ivec2 deferred_coverage_buffer_offset,
                                              shader.get(),
                                              z, m_painter_state_location,
                                              m_callback_list,
-                                             &header_loc);
+                                             &header_loc, &break_stat);
           if (draw_break_added)
             {
               ++m_stats[PainterEnums::num_draws];
+              ++m_stats[break_stat];
             }
         }
 
@@ -788,6 +870,13 @@ draw_generic_implement(ivec2 deferred_coverage_buffer_offset,
        */
       c_array<PainterIndex> index_dst_ptr;
 
+      if (m_active_draws == &m_opaque_draws && item_command != m_active_draws->size())
+        {
+          /* mark the start of this draw within the command */
+          item_command = m_active_draws->size();
+          cmd.m_item_begins.push_back(cmd.m_indices_written);
+        }
+
       index_dst_ptr = cmd.m_draw_command->m_indices.sub_array(cmd.m_indices_written, num_indices);
       src.write_indices(index_dst_ptr, attrib_offset, chunk);
       cmd.m_indices_written += index_dst_ptr.size();
@@ -842,6 +931,7 @@ begin(unsigned int num_external_textures,
       bool clear_color_buffer)
 {
   FASTUIDRAWassert(m_accumulated_draws.empty());
+  FASTUIDRAWassert(m_opaque_draws.empty());
   FASTUIDRAWassert(surface);
 
   m_binded_images.resize(num_external_textures);
@@ -858,25 +948,48 @@ void
 fastuidraw::PainterPacker::
 flush_implement(void)
 {
+  TraceEvents::Scope trace("PainterPacker", "flush");
+
   if (!m_accumulated_draws.empty())
     {
-      per_draw_command &c(m_accumulated_draws.back());
-      m_stats[PainterEnums::num_attributes] += c.m_attributes_written;
-      m_stats[PainterEnums::num_indices] += c.m_indices_written;
-      m_stats[PainterEnums::num_generic_datas] += c.store_written();
-      c.unmap();
+      unmap_command(m_accumulated_draws.back(), false);
+    }
+
+  if (!m_opaque_draws.empty())
+    {
+      unmap_command(m_opaque_draws.back(), true);
     }
 
-  m_stats[PainterEnums::num_draws] += m_accumulated_draws.size();
+  m_stats[PainterEnums::num_draws] += m_accumulated_draws.size() + m_opaque_draws.size();
   m_stats[PainterEnums::num_ends] += 1u;
 
-  m_backend->on_pre_draw(m_surface, m_clear_color_buffer, m_begin_new_target);
-  for(per_draw_command &cmd : m_accumulated_draws)
+  {
+    detail::PainterScopedTimer timer(m_timers, PainterEnums::time_backend_pre_draw_us);
+
     {
-      FASTUIDRAWassert(cmd.m_draw_command->unmapped());
-      cmd.m_draw_command->draw();
+      TraceEvents::Scope trace_pre_draw("PainterPacker", "on_pre_draw");
+      m_backend->on_pre_draw(m_surface, m_clear_color_buffer, m_begin_new_target);
     }
+
+    TraceEvents::Scope trace_draws("PainterPacker", "submit_draws");
+
+    /* the opaque draws go first and front to back so that
+     * depth testing rejects what they hide
+     */
+    for (auto iter = m_opaque_draws.rbegin(); iter != m_opaque_draws.rend(); ++iter)
+      {
+        FASTUIDRAWassert(iter->m_draw_command->unmapped());
+        iter->m_draw_command->draw();
+      }
+
+    for(per_draw_command &cmd : m_accumulated_draws)
+      {
+        FASTUIDRAWassert(cmd.m_draw_command->unmapped());
+        cmd.m_draw_command->draw();
+      }
+  }
   m_accumulated_draws.clear();
+  m_opaque_draws.clear();
   m_begin_new_target = false;
   m_clear_color_buffer = false;
   std::fill(m_binded_images.begin(), m_binded_images.end(), nullptr);
@@ -888,7 +1001,8 @@ flush(bool clear_z)
 {
   if (m_accumulated_draws.size() > 1
       || m_accumulated_draws.back().m_attributes_written > 0
-      || m_accumulated_draws.back().m_indices_written > 0)
+      || m_accumulated_draws.back().m_indices_written > 0
+      || !m_opaque_draws.empty())
     {
       flush_implement();
       start_new_command();
@@ -901,7 +1015,11 @@ fastuidraw::PainterPacker::
 end(void)
 {
   flush_implement();
-  m_backend->on_post_draw();
+  {
+    detail::PainterScopedTimer timer(m_timers, PainterEnums::time_backend_post_draw_us);
+    TraceEvents::Scope trace("PainterPacker", "on_post_draw");
+    m_backend->on_post_draw();
+  }
   m_surface.clear();
   m_binded_images.clear();
 }
@@ -920,6 +1038,7 @@ draw_break(const reference_counted_ptr<const PainterDrawBreakAction> &action)
   if (m_accumulated_draws.back().draw_break(action))
     {
       ++m_stats[PainterEnums::num_draws];
+      ++m_stats[PainterEnums::num_draw_breaks_action];
     }
 }
 
@@ -935,6 +1054,7 @@ set_coverage_surface(const reference_counted_ptr<PainterSurface> &surface)
       if (m_accumulated_draws.back().draw_break(action))
         {
           ++m_stats[PainterEnums::num_draws];
+          ++m_stats[PainterEnums::num_draw_breaks_action];
         }
       m_last_binded_cvg_image = surface;
     }
@@ -988,6 +1108,43 @@ draw_generic(const reference_counted_ptr<PainterItemCoverageShader> &shader,
   draw_generic_implement(ivec2(0, 0), shader, data, src, 0);
 }
 
+void
+fastuidraw::PainterPacker::
+draw_generic_opaque(const reference_counted_ptr<PainterItemShader> &shader,
+                    const PainterPackerData &draw,
+                    c_array<const c_array<const PainterAttribute> > attrib_chunks,
+                    c_array<const c_array<const PainterIndex> > index_chunks,
+                    c_array<const int> index_adjusts,
+                    c_array<const unsigned int> attrib_chunk_selector,
+                    int z)
+{
+  AttributeIndexSrcFromArray src(attrib_chunks, index_chunks, index_adjusts, attrib_chunk_selector);
+
+  m_active_draws = &m_opaque_draws;
+  if (m_opaque_draws.empty())
+    {
+      start_new_command();
+    }
+  draw_generic_implement(ivec2(0, 0), shader, draw, src, z);
+  m_active_draws = &m_accumulated_draws;
+}
+
+void
+fastuidraw::PainterPacker::
+draw_generic_opaque(const reference_counted_ptr<PainterItemShader> &shader,
+                    const PainterPackerData &data,
+                    const PainterAttributeWriter &src,
+                    int z)
+{
+  m_active_draws = &m_opaque_draws;
+  if (m_opaque_draws.empty())
+    {
+      start_new_command();
+    }
+  draw_generic_implement(ivec2(0, 0), shader, data, src, z);
+  m_active_draws = &m_accumulated_draws;
+}
+
 unsigned int
 fastuidraw::PainterPacker::
 current_indices_written(void) { return m_accumulated_draws.back().m_indices_written; }
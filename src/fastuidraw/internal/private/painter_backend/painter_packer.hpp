@@ -42,6 +42,7 @@
 #include <fastuidraw/painter/backend/painter_header.hpp>
 
 #include <private/painter_backend/painter_packer_data.hpp>
+#include <private/painter_backend/painter_timers.hpp>
 
 namespace fastuidraw
 {
@@ -64,7 +65,7 @@ namespace fastuidraw
          * supported. Sync this with the last enumeration
          * in PainterEnums::query_stats_t
          */
-        num_stats = PainterEnums::num_deferred_coverages + 1
+        num_stats = PainterEnums::num_backend_state_changes_elided + 1
       };
 
     /*!
@@ -113,11 +114,14 @@ namespace fastuidraw
      * \param pool pool with which to make a default brush; this brush
      *             is used when draw_generic() is called and the passed
      *             PainterData object lacks a brush value
+     * \param stats stats to which to add counts
+     * \param timers timers to which to add timings
      * \param backend handle to PainterBackend for the constructed PainterPacker
      */
     explicit
     PainterPacker(PainterPackedValuePool &pool,
                   vecN<unsigned int, num_stats> &stats,
+                  detail::PainterTimers &timers,
                   reference_counted_ptr<PainterBackend> backend);
 
     virtual
@@ -284,6 +288,52 @@ namespace fastuidraw
                  const PainterAttributeWriter &src,
                  int z);
 
+    /*!
+     * Draw generic attribute data that is known to be opaque,
+     * i.e. each fragment it covers has its color completely
+     * replaced. Such draws are packed into a separate stream
+     * of PainterDraw objects that is submitted before all
+     * other draws, in the reverse order of the opaque draws,
+     * so that depth testing rejects the hidden fragments of
+     * both the opaque and other draws. The caller must
+     * guarantee that the z-value of an opaque draw is strictly
+     * greater than that of any draw issued before it and that
+     * the draw does not require any PainterDrawBreakAction.
+     * \param shader shader with which to draw data
+     * \param data data for how to draw
+     * \param attrib_chunks attribute data to draw
+     * \param index_chunks the i'th element is index data into attrib_chunks[K]
+     *                     where K = attrib_chunk_selector[i]
+     * \param index_adjusts if non-empty, the i'th element is the value by which
+     *                      to adjust all of index_chunks[i]; if empty the index
+     *                      values are not adjusted.
+     * \param attrib_chunk_selector selects which attribute chunk to use for
+     *        each index chunk
+     * \param z z-value z value placed into the header
+     */
+    void
+    draw_generic_opaque(const reference_counted_ptr<PainterItemShader> &shader,
+                        const PainterPackerData &data,
+                        c_array<const c_array<const PainterAttribute> > attrib_chunks,
+                        c_array<const c_array<const PainterIndex> > index_chunks,
+                        c_array<const int> index_adjusts,
+                        c_array<const unsigned int> attrib_chunk_selector,
+                        int z);
+
+    /*!
+     * Draw generic attribute data that is known to be opaque,
+     * see draw_generic_opaque().
+     * \param shader shader with which to draw data
+     * \param data data for how to draw
+     * \param src DrawWriter to use to write attribute and index data
+     * \param z z-value z value placed into the header
+     */
+    void
+    draw_generic_opaque(const reference_counted_ptr<PainterItemShader> &shader,
+                        const PainterPackerData &data,
+                        const PainterAttributeWriter &src,
+                        int z);
+
     /*!
      * Draw generic attribute data
      * \param shader shader with which to draw data
@@ -392,11 +442,15 @@ namespace fastuidraw
     {
     public:
       std::vector<unsigned int> m_attribs_loaded;
+      std::vector<PainterIndex> m_indices;
     };
 
     void
     start_new_command(void);
 
+    void
+    unmap_command(per_draw_command &cmd, bool reverse_items);
+
     void
     upload_draw_state(const PainterPackerData &draw_state);
 
@@ -433,10 +487,18 @@ namespace fastuidraw
     bool m_clear_color_buffer;
     bool m_begin_new_target;
     std::vector<per_draw_command> m_accumulated_draws;
+
+    /* draws of draw_generic_opaque() and the stream
+     * (m_accumulated_draws or m_opaque_draws) to which
+     * draw_generic_implement() packs.
+     */
+    std::vector<per_draw_command> m_opaque_draws;
+    std::vector<per_draw_command> *m_active_draws;
     reference_counted_ptr<PainterSurface> m_last_binded_cvg_image;
 
     Workroom m_work_room;
     vecN<unsigned int, num_stats> &m_stats;
+    detail::PainterTimers &m_timers;
 
     std::list<reference_counted_ptr<PainterPacker::DataCallBack> > m_callback_list;
   };
@@ -0,0 +1,124 @@
+/*!
+ * \file painter_timers.hpp
+ * \brief file painter_timers.hpp
+ *
+ * Copyright 2016 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <chrono>
+#include <algorithm>
+#include <stdint.h>
+
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/painter/painter_enums.hpp>
+
+namespace fastuidraw
+{
+  namespace detail
+  {
+    /*!
+     * A PainterTimers accumulates the CPU time spent in the
+     * portions of a frame named by the time_xxx_us values of
+     * PainterEnums::query_stats_t. Time is only accumulated
+     * when \ref m_enabled is true.
+     */
+    class PainterTimers:noncopyable
+    {
+    public:
+      enum
+        {
+          first_timer = PainterEnums::time_select_subsets_us,
+          last_timer = PainterEnums::time_backend_post_draw_us,
+          number_timers = last_timer - first_timer + 1
+        };
+
+      PainterTimers(void):
+        m_enabled(false),
+        m_ns(0u),
+        m_depth(0)
+      {}
+
+      void
+      reset(void)
+      {
+        std::fill(m_ns.begin(), m_ns.end(), 0u);
+        std::fill(m_depth.begin(), m_depth.end(), 0);
+      }
+
+      /*!
+       * Write the accumulated times, in microseconds,
+       * to the time_xxx_us elements of an array of stats.
+       */
+      template<size_t N>
+      void
+      write_stats(vecN<unsigned int, N> &stats) const
+      {
+        for (unsigned int i = 0; i < number_timers; ++i)
+          {
+            stats[first_timer + i] = static_cast<unsigned int>(m_ns[i] / 1000u);
+          }
+      }
+
+      bool m_enabled;
+
+    private:
+      friend class PainterScopedTimer;
+
+      vecN<uint64_t, number_timers> m_ns;
+      vecN<int, number_timers> m_depth;
+    };
+
+    /*!
+     * A PainterScopedTimer adds the time between its ctor and
+     * dtor to a PainterTimers. A timer nested within a timer
+     * of the same stat does not add time so that recursive
+     * calls are not counted twice.
+     */
+    class PainterScopedTimer:noncopyable
+    {
+    public:
+      PainterScopedTimer(PainterTimers &timers,
+                         enum PainterEnums::query_stats_t st):
+        m_timers(timers.m_enabled ? &timers : nullptr),
+        m_idx(st - PainterTimers::first_timer)
+      {
+        FASTUIDRAWassert(st >= PainterTimers::first_timer);
+        FASTUIDRAWassert(st <= PainterTimers::last_timer);
+        if (m_timers && m_timers->m_depth[m_idx]++ == 0)
+          {
+            m_start = std::chrono::steady_clock::now();
+          }
+      }
+
+      ~PainterScopedTimer()
+      {
+        if (m_timers && --m_timers->m_depth[m_idx] == 0)
+          {
+            std::chrono::steady_clock::duration d;
+
+            d = std::chrono::steady_clock::now() - m_start;
+            m_timers->m_ns[m_idx] += std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+          }
+      }
+
+    private:
+      PainterTimers *m_timers;
+      unsigned int m_idx;
+      std::chrono::steady_clock::time_point m_start;
+    };
+  }
+}
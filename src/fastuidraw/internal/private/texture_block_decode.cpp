@@ -0,0 +1,416 @@
+/*!
+ * \file texture_block_decode.cpp
+ * \brief file texture_block_decode.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <algorithm>
+#include <private/texture_block_decode.hpp>
+
+namespace
+{
+  inline
+  uint8_t
+  clamp_u8(int v)
+  {
+    return static_cast<uint8_t>(fastuidraw::t_max(0, fastuidraw::t_min(255, v)));
+  }
+
+  inline
+  uint8_t
+  expand_bits(unsigned int v, unsigned int num_bits)
+  {
+    /* replicate the high bits into the low bits */
+    v <<= (8u - num_bits);
+    return static_cast<uint8_t>(v | (v >> num_bits));
+  }
+
+  fastuidraw::u8vec4
+  unpack_565(unsigned int v)
+  {
+    return fastuidraw::u8vec4(expand_bits((v >> 11u) & 0x1Fu, 5),
+                              expand_bits((v >> 5u) & 0x3Fu, 6),
+                              expand_bits(v & 0x1Fu, 5),
+                              255u);
+  }
+
+  /* Decode the 8-byte color block of BC1, BC2 and BC3; the
+   * alpha of the texels is 255 except for the transparent
+   * texels of the BC1 three color mode.
+   */
+  void
+  decode_bc1_color(const uint8_t *block, bool allow_three_color_mode,
+                   fastuidraw::c_array<fastuidraw::u8vec4> dst)
+  {
+    unsigned int c0, c1;
+    uint32_t indices;
+    fastuidraw::vecN<fastuidraw::u8vec4, 4> palette;
+
+    c0 = block[0] | (block[1] << 8u);
+    c1 = block[2] | (block[3] << 8u);
+    indices = uint32_t(block[4]) | (uint32_t(block[5]) << 8u)
+      | (uint32_t(block[6]) << 16u) | (uint32_t(block[7]) << 24u);
+
+    palette[0] = unpack_565(c0);
+    palette[1] = unpack_565(c1);
+    if (c0 > c1 || !allow_three_color_mode)
+      {
+        for (unsigned int i = 0; i < 3; ++i)
+          {
+            palette[2][i] = (2u * palette[0][i] + palette[1][i]) / 3u;
+            palette[3][i] = (palette[0][i] + 2u * palette[1][i]) / 3u;
+          }
+        palette[2].w() = palette[3].w() = 255u;
+      }
+    else
+      {
+        for (unsigned int i = 0; i < 3; ++i)
+          {
+            palette[2][i] = (palette[0][i] + palette[1][i]) / 2u;
+          }
+        palette[2].w() = 255u;
+        palette[3] = fastuidraw::u8vec4(0u, 0u, 0u, 0u);
+      }
+
+    for (unsigned int i = 0; i < 16; ++i, indices >>= 2u)
+      {
+        dst[i] = palette[indices & 3u];
+      }
+  }
+
+  void
+  decode_bc2_alpha(const uint8_t *block,
+                   fastuidraw::c_array<fastuidraw::u8vec4> dst)
+  {
+    for (unsigned int i = 0; i < 16; ++i)
+      {
+        unsigned int a;
+
+        a = (block[i / 2] >> (4u * (i & 1u))) & 0xFu;
+        dst[i].w() = static_cast<uint8_t>(a | (a << 4u));
+      }
+  }
+
+  void
+  decode_bc3_alpha(const uint8_t *block,
+                   fastuidraw::c_array<fastuidraw::u8vec4> dst)
+  {
+    unsigned int a0(block[0]), a1(block[1]);
+    uint64_t indices(0);
+    fastuidraw::vecN<uint8_t, 8> palette;
+
+    for (unsigned int i = 0; i < 6; ++i)
+      {
+        indices |= uint64_t(block[2 + i]) << (8u * i);
+      }
+
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1)
+      {
+        for (unsigned int i = 1; i < 7; ++i)
+          {
+            palette[i + 1] = static_cast<uint8_t>(((7u - i) * a0 + i * a1) / 7u);
+          }
+      }
+    else
+      {
+        for (unsigned int i = 1; i < 5; ++i)
+          {
+            palette[i + 1] = static_cast<uint8_t>(((5u - i) * a0 + i * a1) / 5u);
+          }
+        palette[6] = 0u;
+        palette[7] = 255u;
+      }
+
+    for (unsigned int i = 0; i < 16; ++i, indices >>= 3u)
+      {
+        dst[i].w() = palette[indices & 7u];
+      }
+  }
+
+  /* ETC2 blocks store their pixel indices in column-major
+   * order: pixel (x, y) is at index 4 * x + y.
+   */
+  inline
+  unsigned int
+  etc2_pixel_index(uint32_t bits, unsigned int x, unsigned int y)
+  {
+    unsigned int i(4u * x + y);
+    return (((bits >> (i + 16u)) & 1u) << 1u) | ((bits >> i) & 1u);
+  }
+
+  fastuidraw::u8vec4
+  add_clamped(fastuidraw::u8vec4 c, int d)
+  {
+    return fastuidraw::u8vec4(clamp_u8(c.x() + d),
+                              clamp_u8(c.y() + d),
+                              clamp_u8(c.z() + d),
+                              255u);
+  }
+
+  void
+  decode_etc2_color(const uint8_t *block,
+                    fastuidraw::c_array<fastuidraw::u8vec4> dst)
+  {
+    static const int modifiers[8][4] =
+      {
+        {2, 8, -2, -8},
+        {5, 17, -5, -17},
+        {9, 29, -9, -29},
+        {13, 42, -13, -42},
+        {18, 60, -18, -60},
+        {24, 80, -24, -80},
+        {33, 106, -33, -106},
+        {47, 183, -47, -183},
+      };
+    static const int distances[8] =
+      {
+        3, 6, 11, 16, 23, 32, 41, 64
+      };
+
+    uint32_t bits;
+    bool diff, flip;
+    fastuidraw::vecN<fastuidraw::u8vec4, 2> base;
+    fastuidraw::uvec2 table;
+
+    bits = (uint32_t(block[4]) << 24u) | (uint32_t(block[5]) << 16u)
+      | (uint32_t(block[6]) << 8u) | uint32_t(block[7]);
+    diff = (block[3] & 2u) != 0u;
+    flip = (block[3] & 1u) != 0u;
+
+    if (!diff)
+      {
+        for (unsigned int i = 0; i < 3; ++i)
+          {
+            base[0][i] = expand_bits(block[i] >> 4u, 4);
+            base[1][i] = expand_bits(block[i] & 0xFu, 4);
+          }
+      }
+    else
+      {
+        fastuidraw::ivec3 c1, c2;
+
+        for (unsigned int i = 0; i < 3; ++i)
+          {
+            int d;
+
+            c1[i] = block[i] >> 3u;
+            d = block[i] & 7u;
+            d = (d >= 4) ? d - 8 : d;
+            c2[i] = c1[i] + d;
+          }
+
+        if (c2.x() < 0 || c2.x() > 31)
+          {
+            /* T-mode */
+            fastuidraw::vecN<fastuidraw::u8vec4, 4> paint;
+            fastuidraw::u8vec4 color1, color2;
+            int d;
+
+            color1 = fastuidraw::u8vec4(expand_bits((((block[0] >> 3u) & 3u) << 2u) | (block[0] & 3u), 4),
+                                        expand_bits(block[1] >> 4u, 4),
+                                        expand_bits(block[1] & 0xFu, 4),
+                                        255u);
+            color2 = fastuidraw::u8vec4(expand_bits(block[2] >> 4u, 4),
+                                        expand_bits(block[2] & 0xFu, 4),
+                                        expand_bits(block[3] >> 4u, 4),
+                                        255u);
+            d = distances[(((block[3] >> 2u) & 3u) << 1u) | (block[3] & 1u)];
+            paint[0] = color1;
+            paint[1] = add_clamped(color2, d);
+            paint[2] = color2;
+            paint[3] = add_clamped(color2, -d);
+            for (unsigned int y = 0; y < 4; ++y)
+              {
+                for (unsigned int x = 0; x < 4; ++x)
+                  {
+                    dst[x + 4 * y] = paint[etc2_pixel_index(bits, x, y)];
+                  }
+              }
+            return;
+          }
+
+        if (c2.y() < 0 || c2.y() > 31)
+          {
+            /* H-mode */
+            fastuidraw::vecN<fastuidraw::u8vec4, 4> paint;
+            fastuidraw::u8vec4 color1, color2;
+            uint32_t v1, v2;
+            int d;
+
+            color1 = fastuidraw::u8vec4(expand_bits((block[0] >> 3u) & 0xFu, 4),
+                                        expand_bits(((block[0] & 7u) << 1u) | ((block[1] >> 4u) & 1u), 4),
+                                        expand_bits((block[1] & 8u) | ((block[1] & 3u) << 1u) | (block[2] >> 7u), 4),
+                                        255u);
+            color2 = fastuidraw::u8vec4(expand_bits((block[2] >> 3u) & 0xFu, 4),
+                                        expand_bits(((block[2] & 7u) << 1u) | (block[3] >> 7u), 4),
+                                        expand_bits((block[3] >> 3u) & 0xFu, 4),
+                                        255u);
+            v1 = (uint32_t(color1.x()) << 16u) | (uint32_t(color1.y()) << 8u) | color1.z();
+            v2 = (uint32_t(color2.x()) << 16u) | (uint32_t(color2.y()) << 8u) | color2.z();
+            d = distances[(block[3] & 4u) | ((block[3] & 1u) << 1u) | ((v1 >= v2) ? 1u : 0u)];
+            paint[0] = add_clamped(color1, d);
+            paint[1] = add_clamped(color1, -d);
+            paint[2] = add_clamped(color2, d);
+            paint[3] = add_clamped(color2, -d);
+            for (unsigned int y = 0; y < 4; ++y)
+              {
+                for (unsigned int x = 0; x < 4; ++x)
+                  {
+                    dst[x + 4 * y] = paint[etc2_pixel_index(bits, x, y)];
+                  }
+              }
+            return;
+          }
+
+        if (c2.z() < 0 || c2.z() > 31)
+          {
+            /* planar mode */
+            fastuidraw::ivec3 O, H, V;
+
+            O.x() = expand_bits((block[0] >> 1u) & 0x3Fu, 6);
+            O.y() = expand_bits(((block[0] & 1u) << 6u) | ((block[1] >> 1u) & 0x3Fu), 7);
+            O.z() = expand_bits(((block[1] & 1u) << 5u) | (((block[2] >> 3u) & 3u) << 3u)
+                                | ((block[2] & 3u) << 1u) | (block[3] >> 7u), 6);
+            H.x() = expand_bits((((block[3] >> 2u) & 0x1Fu) << 1u) | (block[3] & 1u), 6);
+            H.y() = expand_bits(block[4] >> 1u, 7);
+            H.z() = expand_bits(((block[4] & 1u) << 5u) | (block[5] >> 3u), 6);
+            V.x() = expand_bits(((block[5] & 7u) << 3u) | (block[6] >> 5u), 6);
+            V.y() = expand_bits(((block[6] & 0x1Fu) << 2u) | (block[7] >> 6u), 7);
+            V.z() = expand_bits(block[7] & 0x3Fu, 6);
+            for (int y = 0; y < 4; ++y)
+              {
+                for (int x = 0; x < 4; ++x)
+                  {
+                    fastuidraw::u8vec4 &c(dst[x + 4 * y]);
+                    for (unsigned int i = 0; i < 3; ++i)
+                      {
+                        c[i] = clamp_u8((x * (H[i] - O[i]) + y * (V[i] - O[i]) + 4 * O[i] + 2) >> 2);
+                      }
+                    c.w() = 255u;
+                  }
+              }
+            return;
+          }
+
+        for (unsigned int i = 0; i < 3; ++i)
+          {
+            base[0][i] = expand_bits(c1[i], 5);
+            base[1][i] = expand_bits(c2[i], 5);
+          }
+      }
+
+    /* individual and differential modes */
+    table[0] = (block[3] >> 5u) & 7u;
+    table[1] = (block[3] >> 2u) & 7u;
+    for (unsigned int y = 0; y < 4; ++y)
+      {
+        for (unsigned int x = 0; x < 4; ++x)
+          {
+            unsigned int sub_block;
+
+            sub_block = (flip) ? (y >> 1u) : (x >> 1u);
+            dst[x + 4 * y] = add_clamped(base[sub_block],
+                                         modifiers[table[sub_block]][etc2_pixel_index(bits, x, y)]);
+          }
+      }
+  }
+
+  void
+  decode_etc2_eac_alpha(const uint8_t *block,
+                        fastuidraw::c_array<fastuidraw::u8vec4> dst)
+  {
+    static const int modifiers[16][8] =
+      {
+        {-3, -6, -9, -15, 2, 5, 8, 14},
+        {-3, -7, -10, -13, 2, 6, 9, 12},
+        {-2, -5, -8, -13, 1, 4, 7, 12},
+        {-2, -4, -6, -13, 1, 3, 5, 12},
+        {-3, -6, -8, -12, 2, 5, 7, 11},
+        {-3, -7, -9, -11, 2, 6, 8, 10},
+        {-4, -7, -8, -11, 3, 6, 7, 10},
+        {-3, -5, -8, -11, 2, 4, 7, 10},
+        {-2, -6, -8, -10, 1, 5, 7, 9},
+        {-2, -5, -8, -10, 1, 4, 7, 9},
+        {-2, -4, -8, -10, 1, 3, 7, 9},
+        {-2, -5, -7, -10, 1, 4, 6, 9},
+        {-3, -4, -7, -10, 2, 3, 6, 9},
+        {-1, -2, -3, -10, 0, 1, 2, 9},
+        {-4, -6, -8, -9, 3, 5, 7, 8},
+        {-3, -5, -7, -9, 2, 4, 6, 8},
+      };
+
+    int base, multiplier;
+    const int *table;
+    uint64_t indices(0);
+
+    base = block[0];
+    multiplier = block[1] >> 4u;
+    table = modifiers[block[1] & 0xFu];
+    for (unsigned int i = 2; i < 8; ++i)
+      {
+        indices = (indices << 8u) | block[i];
+      }
+
+    for (unsigned int x = 0; x < 4; ++x)
+      {
+        for (unsigned int y = 0; y < 4; ++y)
+          {
+            unsigned int i(4u * x + y), idx;
+
+            idx = (indices >> (45u - 3u * i)) & 7u;
+            dst[x + 4 * y].w() = clamp_u8(base + table[idx] * multiplier);
+          }
+      }
+  }
+}
+
+void
+fastuidraw::detail::
+decode_compressed_block(enum ImageSourceBase::compression_t compression,
+                        const uint8_t *block, c_array<u8vec4> dst)
+{
+  FASTUIDRAWassert(dst.size() >= 16);
+  switch (compression)
+    {
+    case ImageSourceBase::bc1_compression:
+      decode_bc1_color(block, true, dst);
+      break;
+
+    case ImageSourceBase::bc2_compression:
+      decode_bc1_color(block + 8, false, dst);
+      decode_bc2_alpha(block, dst);
+      break;
+
+    case ImageSourceBase::bc3_compression:
+      decode_bc1_color(block + 8, false, dst);
+      decode_bc3_alpha(block, dst);
+      break;
+
+    case ImageSourceBase::etc2_rgb8_compression:
+      decode_etc2_color(block, dst);
+      break;
+
+    case ImageSourceBase::etc2_rgba8_compression:
+      decode_etc2_color(block + 8, dst);
+      decode_etc2_eac_alpha(block, dst);
+      break;
+
+    default:
+      FASTUIDRAWassert(!"Bad compression_t value");
+      std::fill(dst.begin(), dst.begin() + 16, u8vec4(255u, 255u, 0u, 255u));
+    }
+}
@@ -0,0 +1,43 @@
+/*!
+ * \file texture_block_decode.hpp
+ * \brief file texture_block_decode.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/c_array.hpp>
+#include <fastuidraw/util/vecN.hpp>
+#include <fastuidraw/image.hpp>
+
+namespace fastuidraw
+{
+  namespace detail
+  {
+    /*!
+     * Decode a single 4x4 block of block-compressed texel
+     * data, writing texel (x, y) of the block to dst[x + 4 * y].
+     * \param compression compression of the block, must not
+     *                    be ImageSourceBase::uncompressed
+     * \param block the ImageSourceBase::compressed_block_size()
+     *              bytes of the block
+     * \param dst location to which to write the 16 texels
+     */
+    void
+    decode_compressed_block(enum ImageSourceBase::compression_t compression,
+                            const uint8_t *block, c_array<u8vec4> dst);
+  }
+}
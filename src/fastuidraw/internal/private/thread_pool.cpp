@@ -0,0 +1,128 @@
+/*!
+ * \file thread_pool.cpp
+ * \brief file thread_pool.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <fastuidraw/util/math.hpp>
+#include <private/thread_pool.hpp>
+
+fastuidraw::detail::ThreadPool::
+ThreadPool(unsigned int number_threads):
+  m_function(nullptr),
+  m_number_jobs(0),
+  m_next_job(0),
+  m_generation(0),
+  m_number_active(0),
+  m_quit(false)
+{
+  if (number_threads == 0)
+    {
+      number_threads = t_max(1u, std::thread::hardware_concurrency());
+    }
+
+  /* the thread calling run() is thread 0 */
+  for (unsigned int i = 1; i < number_threads; ++i)
+    {
+      m_workers.push_back(std::thread(&ThreadPool::worker_main, this, i));
+    }
+}
+
+fastuidraw::detail::ThreadPool::
+~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = true;
+  }
+  m_start_condition.notify_all();
+  for (std::thread &t : m_workers)
+    {
+      t.join();
+    }
+}
+
+void
+fastuidraw::detail::ThreadPool::
+execute_jobs(unsigned int thread_id)
+{
+  for (unsigned int job = m_next_job++; job < m_number_jobs; job = m_next_job++)
+    {
+      (*m_function)(job, thread_id);
+    }
+}
+
+void
+fastuidraw::detail::ThreadPool::
+worker_main(unsigned int thread_id)
+{
+  unsigned int generation(0);
+
+  for (;;)
+    {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_start_condition.wait(lock, [&]() { return m_quit || m_generation != generation; });
+        if (m_quit)
+          {
+            return;
+          }
+        generation = m_generation;
+      }
+
+      execute_jobs(thread_id);
+
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_number_active;
+      }
+      m_done_condition.notify_one();
+    }
+}
+
+void
+fastuidraw::detail::ThreadPool::
+run(unsigned int number_jobs, const job_function &f)
+{
+  if (number_jobs == 0)
+    {
+      return;
+    }
+
+  if (m_workers.empty() || number_jobs == 1)
+    {
+      for (unsigned int job = 0; job < number_jobs; ++job)
+        {
+          f(job, 0);
+        }
+      return;
+    }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_function = &f;
+    m_number_jobs = number_jobs;
+    m_next_job = 0;
+    m_number_active = m_workers.size();
+    ++m_generation;
+  }
+  m_start_condition.notify_all();
+
+  execute_jobs(0);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done_condition.wait(lock, [&]() { return m_number_active == 0; });
+  m_function = nullptr;
+}
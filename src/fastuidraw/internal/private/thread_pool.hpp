@@ -0,0 +1,137 @@
+/*!
+ * \file thread_pool.hpp
+ * \brief file thread_pool.hpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include <fastuidraw/util/util.hpp>
+#include <fastuidraw/util/math.hpp>
+
+namespace fastuidraw { namespace detail {
+
+/* A ThreadPool holds a fixed set of worker threads that
+ * execute the jobs of a parallel-for issued by run(). The
+ * thread calling run() also executes jobs and run() only
+ * returns once every job has completed.
+ */
+class ThreadPool:noncopyable
+{
+public:
+  /* function executed for each job; the first argument
+   * is the job index and the second is the index of the
+   * thread running the job, which is in the range
+   * [0, number_threads()).
+   */
+  typedef std::function<void (unsigned int, unsigned int)> job_function;
+
+  /* \param number_threads number of threads including the
+   *                       calling thread; a value of 0
+   *                       indicates hardware concurrency.
+   */
+  explicit
+  ThreadPool(unsigned int number_threads);
+
+  ~ThreadPool();
+
+  unsigned int
+  number_threads(void) const
+  {
+    return m_workers.size() + 1u;
+  }
+
+  /* Run the jobs [0, number_jobs) across the threads of
+   * the pool, returning when all jobs have completed.
+   */
+  void
+  run(unsigned int number_jobs, const job_function &f);
+
+private:
+  void
+  worker_main(unsigned int thread_id);
+
+  void
+  execute_jobs(unsigned int thread_id);
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_start_condition, m_done_condition;
+
+  /* state of the current call to run() */
+  const job_function *m_function;
+  unsigned int m_number_jobs;
+  std::atomic<unsigned int> m_next_job;
+  unsigned int m_generation;
+  unsigned int m_number_active;
+  bool m_quit;
+};
+
+/* ThreadPool shared by the parallel loops of the library
+ * (distance field and mipmap generation); the pool runs
+ * one parallel-for at a time, so a thread that finds the
+ * pool in use does its work serially.
+ */
+class SharedThreadPool:noncopyable
+{
+public:
+  static
+  SharedThreadPool&
+  get(void)
+  {
+    static SharedThreadPool R;
+    return R;
+  }
+
+  /* Calls f(begin, end) over a partition of [0, n) into
+   * ranges of at least min_per_job elements.
+   */
+  template<typename F>
+  void
+  parallel_for(unsigned int n, unsigned int min_per_job, const F &f)
+  {
+    unsigned int num_jobs;
+
+    num_jobs = t_min(n / t_max(1u, min_per_job),
+                     4u * m_pool.number_threads());
+    if (num_jobs < 2u || !m_mutex.try_lock())
+      {
+        f(0u, n);
+        return;
+      }
+
+    std::lock_guard<std::mutex> lock(m_mutex, std::adopt_lock);
+    m_pool.run(num_jobs, [&](unsigned int job, unsigned int)
+               {
+                 f((n * job) / num_jobs, (n * (job + 1u)) / num_jobs);
+               });
+  }
+
+private:
+  SharedThreadPool(void):
+    m_pool(0)
+  {}
+
+  std::mutex m_mutex;
+  ThreadPool m_pool;
+};
+
+}}
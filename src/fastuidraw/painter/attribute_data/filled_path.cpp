@@ -30,6 +30,7 @@
 #include <fastuidraw/path.hpp>
 #include <fastuidraw/painter/attribute_data/filled_path.hpp>
 #include <fastuidraw/painter/attribute_data/painter_attribute_data.hpp>
+#include <fastuidraw/util/trace_events.hpp>
 
 #include <private/util_private.hpp>
 #include <private/util_private_ostream.hpp>
@@ -3295,6 +3296,7 @@ make_ready_from_sub_path(void)
   FASTUIDRAWassert(m_painter_data == nullptr);
   FASTUIDRAWassert(!m_sizes_ready);
 
+  fastuidraw::TraceEvents::Scope trace("FilledPath", "triangulate");
   FillAttributeDataFiller filler;
   builder B(*m_sub_path, filler.m_points);
   unsigned int even_non_zero_start, zero_start;
@@ -3484,6 +3486,7 @@ aa_fuzz_chunk_from_winding_number(int w)
 fastuidraw::FilledPath::
 FilledPath(const TessellatedPath &P)
 {
+  TraceEvents::Scope trace("FilledPath", "create");
   m_d = FASTUIDRAWnew FilledPathPrivate(P);
 }
 
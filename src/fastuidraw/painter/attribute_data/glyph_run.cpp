@@ -29,12 +29,47 @@ namespace
   class PerGlyphRender
   {
   public:
+    PerGlyphRender(void):
+      m_cache(nullptr)
+    {}
+
+    PerGlyphRender(const PerGlyphRender &obj):
+      m_cache(nullptr)
+    {
+      FASTUIDRAWunused(obj);
+      FASTUIDRAWassert(!obj.m_cache);
+    }
+
+    ~PerGlyphRender()
+    {
+      if (m_cache)
+        {
+          m_cache->unpin_glyphs(fastuidraw::make_c_array(m_glyphs));
+        }
+    }
+
+    /* replace the data of the glyphs [begin, begin + remove_count)
+     * with data for the glyphs [begin, begin + insert_count) of p.
+     */
+    void
+    splice(GlyphRunPrivate *p, fastuidraw::GlyphRenderer renderer,
+           unsigned int begin, unsigned int remove_count,
+           unsigned int insert_count);
+
+    /* repack the atlas dependent fields of the attributes,
+     * the glyphs must have been uploaded to the atlas.
+     */
     void
-    set_values(GlyphRunPrivate *p,
-               fastuidraw::GlyphRenderer renderer);
+    repack_glyph_attributes(void);
 
     std::vector<fastuidraw::PainterAttribute> m_attribs;
     std::vector<fastuidraw::PainterIndex> m_indices;
+
+    /* the glyphs of the attribute data are pinned in
+     * the GlyphCache so they are not evicted.
+     */
+    fastuidraw::GlyphCache *m_cache;
+    std::vector<fastuidraw::Glyph> m_glyphs;
   };
 
   class SubSequence:public fastuidraw::PainterAttributeWriter
@@ -77,6 +112,11 @@ namespace
   private:
     fastuidraw::c_array<const fastuidraw::PainterIndex> m_indices;
     fastuidraw::c_array<const fastuidraw::PainterAttribute> m_attributes;
+
+    /* the index values of PerGlyphRender are relative to
+     * the start of its m_attribs, not of m_attributes.
+     */
+    unsigned int m_index_bias;
   };
 
   class GlyphLocation
@@ -138,13 +178,41 @@ namespace
 
     template<typename T>
     void
-    add_glyphs(const fastuidraw::FontBase *font,
-               fastuidraw::c_array<const T> sources,
-               fastuidraw::c_array<const fastuidraw::vec2> positions);
+    insert_glyphs(unsigned int I, const fastuidraw::FontBase *font,
+                  fastuidraw::c_array<const T> sources,
+                  fastuidraw::c_array<const fastuidraw::vec2> positions);
+
+    template<typename T>
+    void
+    replace_glyphs(unsigned int begin, const fastuidraw::FontBase *font,
+                   fastuidraw::c_array<const T> sources,
+                   fastuidraw::c_array<const fastuidraw::vec2> positions);
+
+    void
+    remove_glyphs(unsigned int begin, unsigned int count);
+
+    void
+    translate_glyphs(unsigned int begin, unsigned int count,
+                     const fastuidraw::vec2 &delta);
 
     const PerGlyphRender*
     fetch_render_data(const fastuidraw::GlyphRenderer &renderer);
 
+    void
+    set_locations(unsigned int begin,
+                  fastuidraw::c_array<const fastuidraw::vec2> positions);
+
+    void
+    check_atlas_cleared(void);
+
+    /* update the data of each entry of m_data for the glyphs
+     * [begin, begin + remove_count) having been replaced by
+     * the glyphs [begin, begin + insert_count).
+     */
+    void
+    update_render_data(unsigned int begin, unsigned int remove_count,
+                       unsigned int insert_count);
+
     float m_format_size;
     enum fastuidraw::PainterEnums::screen_orientation m_orientation;
     enum fastuidraw::PainterEnums::glyph_layout_type m_layout;
@@ -167,6 +235,7 @@ set_src(const PerGlyphRender *data, unsigned int begin, unsigned int cnt)
 {
   m_indices = fastuidraw::make_c_array(data->m_indices).sub_array(6 * begin, 6 * cnt);
   m_attributes = fastuidraw::make_c_array(data->m_attribs).sub_array(4 * begin, 4 * cnt);
+  m_index_bias = 4 * begin;
 }
 
 unsigned int
@@ -212,7 +281,7 @@ write_indices(fastuidraw::c_array<fastuidraw::PainterIndex> dst,
 {
   for (unsigned int i = 0; i < dst.size(); ++i)
     {
-      dst[i] = index_offset_value + m_indices[i];
+      dst[i] = index_offset_value + m_indices[i] - m_index_bias;
     }
 }
 
@@ -228,85 +297,258 @@ write_attributes(fastuidraw::c_array<fastuidraw::PainterAttribute> dst,
 // PerGlyphRender methods
 void
 PerGlyphRender::
-set_values(GlyphRunPrivate *p,
-           fastuidraw::GlyphRenderer renderer)
+splice(GlyphRunPrivate *p, fastuidraw::GlyphRenderer renderer,
+       unsigned int begin, unsigned int remove_count,
+       unsigned int insert_count)
 {
   using namespace fastuidraw;
 
-  unsigned int num(p->m_glyph_locations.size());
-  std::vector<Glyph> tmp_glyphs(num);
-  c_array<const GlyphMetrics> glyph_metrics(make_c_array(p->m_glyphs));
-  c_array<Glyph> glyphs(make_c_array(tmp_glyphs));
+  c_array<const GlyphMetrics> glyph_metrics;
+  c_array<Glyph> glyphs;
+  int attrib_delta;
 
-  m_attribs.resize(4 * num);
-  m_indices.resize(6 * num);
+  if (m_cache)
+    {
+      m_cache->unpin_glyphs(make_c_array(m_glyphs).sub_array(begin, remove_count));
+    }
+  m_cache = p->m_cache.get();
+
+  /* the first min(remove_count, insert_count) elements
+   * are overwritten, only the difference is inserted or
+   * erased.
+   */
+  if (insert_count > remove_count)
+    {
+      unsigned int g(begin + remove_count), n(insert_count - remove_count);
+      PainterAttribute zero_attrib;
+
+      zero_attrib.m_attrib0 = uvec4(0u);
+      zero_attrib.m_attrib1 = uvec4(0u);
+      zero_attrib.m_attrib2 = uvec4(0u);
+      m_glyphs.insert(m_glyphs.begin() + g, n, Glyph());
+      m_attribs.insert(m_attribs.begin() + 4 * g, 4 * n, zero_attrib);
+      m_indices.insert(m_indices.begin() + 6 * g, 6 * n, 0u);
+    }
+  else if (insert_count < remove_count)
+    {
+      unsigned int g(begin + insert_count), e(begin + remove_count);
+
+      m_glyphs.erase(m_glyphs.begin() + g, m_glyphs.begin() + e);
+      m_attribs.erase(m_attribs.begin() + 4 * g, m_attribs.begin() + 4 * e);
+      m_indices.erase(m_indices.begin() + 6 * g, m_indices.begin() + 6 * e);
+    }
+
+  /* the index values are absolute within m_attribs */
+  attrib_delta = 4 * (int(insert_count) - int(remove_count));
+  if (attrib_delta != 0)
+    {
+      for (unsigned int i = 6 * (begin + insert_count), endi = m_indices.size(); i < endi; ++i)
+        {
+          m_indices[i] += attrib_delta;
+        }
+    }
+
+  glyph_metrics = make_c_array(p->m_glyphs).sub_array(begin, insert_count);
+  glyphs = make_c_array(m_glyphs).sub_array(begin, insert_count);
   p->m_cache->fetch_glyphs(renderer, glyph_metrics, glyphs, true);
+  m_cache->pin_glyphs(glyphs);
 
-  for (unsigned int g = 0; g < num; ++g)
+  for (unsigned int g = begin, endg = begin + insert_count; g < endg; ++g)
     {
-      glyphs[g].pack_glyph(4 * g, fastuidraw::make_c_array(m_attribs),
-                           6 * g, fastuidraw::make_c_array(m_indices),
-                           p->m_glyph_locations[g].m_position,
-                           p->m_glyph_locations[g].m_scale,
-                           p->m_orientation,
-                           p->m_layout);
+      m_glyphs[g].pack_glyph(4 * g, make_c_array(m_attribs),
+                             6 * g, make_c_array(m_indices),
+                             p->m_glyph_locations[g].m_position,
+                             p->m_glyph_locations[g].m_scale,
+                             p->m_orientation,
+                             p->m_layout);
+    }
+}
+
+void
+PerGlyphRender::
+repack_glyph_attributes(void)
+{
+  for (unsigned int g = 0, endg = m_glyphs.size(); g < endg; ++g)
+    {
+      m_glyphs[g].repack_glyph_attributes(4 * g, fastuidraw::make_c_array(m_attribs));
     }
 }
 
 ////////////////////////////////////////
 // GlyphRunPrivate methods
-template<typename T>
 void
 GlyphRunPrivate::
-add_glyphs(const fastuidraw::FontBase *font,
-           fastuidraw::c_array<const T> sources,
-           fastuidraw::c_array<const fastuidraw::vec2> positions)
+set_locations(unsigned int begin,
+              fastuidraw::c_array<const fastuidraw::vec2> positions)
 {
-  unsigned int old_sz;
-  fastuidraw::c_array<fastuidraw::GlyphMetrics> dst_glyphs;
-
-  old_sz = m_glyphs.size();
-  m_glyphs.resize(sources.size() + old_sz);
-  m_glyph_locations.reserve(sources.size() + old_sz);
-  dst_glyphs = fastuidraw::make_c_array(m_glyphs).sub_array(old_sz);
-  this->grab_metrics(font, sources, dst_glyphs);
-
   for (unsigned int i = 0; i < positions.size(); ++i)
     {
-      GlyphLocation L;
+      GlyphLocation &L(m_glyph_locations[begin + i]);
 
       L.m_position = positions[i];
-      if (dst_glyphs[i].valid())
+      if (m_glyphs[begin + i].valid())
         {
-          L.m_scale = m_format_size / dst_glyphs[i].units_per_EM();
+          L.m_scale = m_format_size / m_glyphs[begin + i].units_per_EM();
         }
       else
         {
-              L.m_scale = 1.0f;
+          L.m_scale = 1.0f;
         }
-      m_glyph_locations.push_back(L);
     }
-  m_data.clear();
 }
 
-const PerGlyphRender*
+template<typename T>
+void
 GlyphRunPrivate::
-fetch_render_data(const fastuidraw::GlyphRenderer &renderer)
+insert_glyphs(unsigned int I, const fastuidraw::FontBase *font,
+              fastuidraw::c_array<const T> sources,
+              fastuidraw::c_array<const fastuidraw::vec2> positions)
 {
-  const PerGlyphRender *data;
-  std::map<fastuidraw::GlyphRenderer, PerGlyphRender>::const_iterator iter;
+  FASTUIDRAWassert(sources.size() == positions.size());
+  FASTUIDRAWassert(I <= m_glyphs.size());
 
-  if (!m_data.empty() && m_atlas_clear_count != m_cache->number_times_atlas_cleared())
+  if (sources.empty())
+    {
+      return;
+    }
+
+  fastuidraw::c_array<fastuidraw::GlyphMetrics> dst_glyphs;
+
+  m_glyphs.insert(m_glyphs.begin() + I, sources.size(), fastuidraw::GlyphMetrics());
+  m_glyph_locations.insert(m_glyph_locations.begin() + I, sources.size(), GlyphLocation());
+  dst_glyphs = fastuidraw::make_c_array(m_glyphs).sub_array(I, sources.size());
+  this->grab_metrics(font, sources, dst_glyphs);
+  set_locations(I, positions);
+  update_render_data(I, 0, sources.size());
+}
+
+template<typename T>
+void
+GlyphRunPrivate::
+replace_glyphs(unsigned int begin, const fastuidraw::FontBase *font,
+               fastuidraw::c_array<const T> sources,
+               fastuidraw::c_array<const fastuidraw::vec2> positions)
+{
+  FASTUIDRAWassert(sources.size() == positions.size());
+  FASTUIDRAWassert(begin + sources.size() <= m_glyphs.size());
+
+  if (sources.empty())
+    {
+      return;
+    }
+
+  fastuidraw::c_array<fastuidraw::GlyphMetrics> dst_glyphs;
+
+  dst_glyphs = fastuidraw::make_c_array(m_glyphs).sub_array(begin, sources.size());
+  this->grab_metrics(font, sources, dst_glyphs);
+  set_locations(begin, positions);
+  update_render_data(begin, sources.size(), sources.size());
+}
+
+void
+GlyphRunPrivate::
+remove_glyphs(unsigned int begin, unsigned int count)
+{
+  begin = fastuidraw::t_min(begin, static_cast<unsigned int>(m_glyphs.size()));
+  count = fastuidraw::t_min(count, static_cast<unsigned int>(m_glyphs.size()) - begin);
+  if (count == 0)
+    {
+      return;
+    }
+
+  m_glyphs.erase(m_glyphs.begin() + begin, m_glyphs.begin() + begin + count);
+  m_glyph_locations.erase(m_glyph_locations.begin() + begin,
+                          m_glyph_locations.begin() + begin + count);
+  update_render_data(begin, count, 0);
+}
+
+void
+GlyphRunPrivate::
+translate_glyphs(unsigned int begin, unsigned int count,
+                 const fastuidraw::vec2 &delta)
+{
+  begin = fastuidraw::t_min(begin, static_cast<unsigned int>(m_glyphs.size()));
+  count = fastuidraw::t_min(count, static_cast<unsigned int>(m_glyphs.size()) - begin);
+  if (count == 0)
+    {
+      return;
+    }
+
+  for (unsigned int i = begin; i < begin + count; ++i)
+    {
+      m_glyph_locations[i].m_position += delta;
+    }
+  update_render_data(begin, count, count);
+}
+
+void
+GlyphRunPrivate::
+check_atlas_cleared(void)
+{
+  using namespace fastuidraw;
+
+  unsigned int clear_count(m_cache->number_times_atlas_cleared());
+  if (m_atlas_clear_count == clear_count)
+    {
+      return;
+    }
+
+  m_atlas_clear_count = clear_count;
+  if (m_data.empty())
+    {
+      return;
+    }
+
+  /* The glyphs of the render data are pinned and thus still
+   * in the cache; the attribute and index layout stays the
+   * same and only the fields coming from the atlas need to
+   * be updated after the glyphs are uploaded again, which
+   * is done for all the glyphs with a single call.
+   */
+  std::vector<Glyph> glyphs;
+  for (const auto &e : m_data)
+    {
+      glyphs.insert(glyphs.end(), e.second.m_glyphs.begin(), e.second.m_glyphs.end());
+    }
+
+  if (m_cache->upload_to_atlas(make_c_array(glyphs)) == routine_success)
+    {
+      for (auto &e : m_data)
+        {
+          e.second.repack_glyph_attributes();
+        }
+    }
+  else
     {
-      m_atlas_clear_count = m_cache->number_times_atlas_cleared();
       m_data.clear();
     }
+}
+
+void
+GlyphRunPrivate::
+update_render_data(unsigned int begin, unsigned int remove_count,
+                   unsigned int insert_count)
+{
+  check_atlas_cleared();
+  for (auto &e : m_data)
+    {
+      e.second.splice(this, e.first, begin, remove_count, insert_count);
+    }
+}
 
+const PerGlyphRender*
+GlyphRunPrivate::
+fetch_render_data(const fastuidraw::GlyphRenderer &renderer)
+{
+  const PerGlyphRender *data;
+  std::map<fastuidraw::GlyphRenderer, PerGlyphRender>::const_iterator iter;
+
+  check_atlas_cleared();
   iter = m_data.find(renderer);
   if (iter == m_data.end())
     {
       PerGlyphRender &p(m_data[renderer]);
-      p.set_values(this, renderer);
+      p.splice(this, renderer, 0, 0, m_glyphs.size());
       data = &p;
     }
   else
@@ -379,7 +621,7 @@ add_glyphs(c_array<const GlyphSource> sources,
   GlyphRunPrivate *d;
 
   d = static_cast<GlyphRunPrivate*>(m_d);
-  d->add_glyphs<GlyphSource>(nullptr, sources, positions);
+  d->insert_glyphs<GlyphSource>(d->m_glyphs.size(), nullptr, sources, positions);
 }
 
 void
@@ -390,7 +632,7 @@ add_glyphs(c_array<const GlyphMetrics> glyph_metrics,
   GlyphRunPrivate *d;
 
   d = static_cast<GlyphRunPrivate*>(m_d);
-  d->add_glyphs<GlyphMetrics>(nullptr, glyph_metrics, positions);
+  d->insert_glyphs<GlyphMetrics>(d->m_glyphs.size(), nullptr, glyph_metrics, positions);
 }
 
 void
@@ -402,7 +644,52 @@ add_glyphs(const FontBase *font,
   GlyphRunPrivate *d;
 
   d = static_cast<GlyphRunPrivate*>(m_d);
-  d->add_glyphs<uint32_t>(font, glyph_codes, positions);
+  d->insert_glyphs<uint32_t>(d->m_glyphs.size(), font, glyph_codes, positions);
+}
+
+void
+fastuidraw::GlyphRun::
+insert_glyphs(unsigned int I,
+              c_array<const GlyphSource> sources,
+              c_array<const vec2> positions)
+{
+  GlyphRunPrivate *d;
+
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  d->insert_glyphs<GlyphSource>(I, nullptr, sources, positions);
+}
+
+void
+fastuidraw::GlyphRun::
+remove_glyphs(unsigned int begin, unsigned int count)
+{
+  GlyphRunPrivate *d;
+
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  d->remove_glyphs(begin, count);
+}
+
+void
+fastuidraw::GlyphRun::
+replace_glyphs(unsigned int begin,
+               c_array<const GlyphSource> sources,
+               c_array<const vec2> positions)
+{
+  GlyphRunPrivate *d;
+
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  d->replace_glyphs<GlyphSource>(begin, nullptr, sources, positions);
+}
+
+void
+fastuidraw::GlyphRun::
+translate_glyphs(unsigned int begin, unsigned int count,
+                 const vec2 &delta)
+{
+  GlyphRunPrivate *d;
+
+  d = static_cast<GlyphRunPrivate*>(m_d);
+  d->translate_glyphs(begin, count, delta);
 }
 
 unsigned int
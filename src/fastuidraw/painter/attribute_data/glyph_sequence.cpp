@@ -45,18 +45,29 @@ namespace
   class GlyphAttributesIndices
   {
   public:
-    GlyphAttributesIndices(void)
+    GlyphAttributesIndices(void):
+      m_cache(nullptr)
     {}
 
-    GlyphAttributesIndices(const GlyphAttributesIndices &obj)
+    GlyphAttributesIndices(const GlyphAttributesIndices &obj):
+      m_cache(nullptr)
     {
       FASTUIDRAWunused(obj);
-      FASTUIDRAWassert(m_attribs.empty());
-      FASTUIDRAWassert(m_indices.empty());
+      FASTUIDRAWassert(obj.m_attribs.empty());
+      FASTUIDRAWassert(obj.m_indices.empty());
+    }
+
+    ~GlyphAttributesIndices()
+    {
+      if (m_cache)
+        {
+          m_cache->unpin_glyphs(fastuidraw::make_c_array(m_glyphs));
+        }
     }
 
     void
-    set_values(fastuidraw::c_array<const fastuidraw::Glyph> glyphs,
+    set_values(fastuidraw::GlyphCache *cache,
+               fastuidraw::c_array<const fastuidraw::Glyph> glyphs,
                fastuidraw::c_array<const fastuidraw::vec2> positions,
                float render_format_size,
                enum fastuidraw::PainterEnums::screen_orientation orientation,
@@ -74,14 +85,37 @@ namespace
       return fastuidraw::make_c_array(m_indices);
     }
 
+    fastuidraw::c_array<const fastuidraw::Glyph>
+    glyphs(void) const
+    {
+      return fastuidraw::make_c_array(m_glyphs);
+    }
+
+    /* repack the atlas dependent fields of the attributes,
+     * the glyphs must have been uploaded to the atlas.
+     */
+    void
+    repack_glyph_attributes(void);
+
   private:
     std::vector<fastuidraw::PainterAttribute> m_attribs;
     std::vector<fastuidraw::PainterIndex> m_indices;
+
+    /* the glyphs of the attribute data are pinned in
+     * the GlyphCache so they are not evicted.
+     */
+    fastuidraw::GlyphCache *m_cache;
+    std::vector<fastuidraw::Glyph> m_glyphs;
   };
 
   class PerAddedGlyph
   {
   public:
+    PerAddedGlyph(void):
+      m_position(0.0f, 0.0f),
+      m_index(0u)
+    {}
+
     fastuidraw::BoundingBox<float> m_bounding_box;
     fastuidraw::GlyphMetrics m_metrics;
     fastuidraw::vec2 m_position;
@@ -154,6 +188,19 @@ namespace
     void
     add_glyph(const PerAddedGlyph &G);
 
+    /* G must have been added with add_glyph() and its
+     * bounding box must not have changed since.
+     */
+    void
+    remove_glyph(const PerAddedGlyph &G);
+
+    /* increment by delta those glyph indices that are
+     * no less than begin; does not affect m_data since
+     * the attribute data does not depend on the indices.
+     */
+    void
+    shift_glyph_indices(unsigned int begin, int delta);
+
     unsigned int
     select(ScratchSpacePrivate &scratch,
        fastuidraw::c_array<const fastuidraw::vec3> clip_equations,
@@ -167,6 +214,10 @@ namespace
     const GlyphAttributesIndices&
     attributes_indices(fastuidraw::GlyphRenderer R);
 
+    /* append the glyphs of the attribute data of the subset */
+    void
+    append_glyphs(std::vector<fastuidraw::Glyph> *dst) const;
+
     fastuidraw::c_array<const unsigned int>
     glyph_elements(void) const
     {
@@ -195,6 +246,9 @@ namespace
     void
     add_glyph_when_not_split(const PerAddedGlyph &G);
 
+    void
+    insert_into_glyph_list(unsigned int I);
+
     void
     select_implement(ScratchSpacePrivate &scratch,
              fastuidraw::c_array<unsigned int> dst,
@@ -224,7 +278,9 @@ namespace
       m_orientation(orientation),
       m_layout(layout),
       m_cache(cache),
-      m_root(nullptr)
+      m_root(nullptr),
+      m_upload_clear_count(0),
+      m_upload_success(false)
     {
       FASTUIDRAWassert(cache);
     }
@@ -276,8 +332,21 @@ namespace
     }
 
     void
-    add_glyphs(fastuidraw::c_array<const fastuidraw::GlyphSource> sources,
-               fastuidraw::c_array<const fastuidraw::vec2> positions);
+    insert_glyphs(unsigned int I,
+                  fastuidraw::c_array<const fastuidraw::GlyphSource> sources,
+                  fastuidraw::c_array<const fastuidraw::vec2> positions);
+
+    void
+    remove_glyphs(unsigned int begin, unsigned int count);
+
+    void
+    replace_glyphs(unsigned int begin,
+                   fastuidraw::c_array<const fastuidraw::GlyphSource> sources,
+                   fastuidraw::c_array<const fastuidraw::vec2> positions);
+
+    void
+    translate_glyphs(unsigned int begin, unsigned int count,
+                     const fastuidraw::vec2 &delta);
 
     unsigned int
     give_subset_ID(GlyphSubsetPrivate *p)
@@ -316,10 +385,22 @@ namespace
       return m_root;
     }
 
+    /* upload again to the atlas the glyphs of the attribute
+     * data of all subsets with a single call to the cache;
+     * done only once for each clear of the atlas. Returns
+     * true if all the glyphs were uploaded.
+     */
+    bool
+    upload_glyphs_after_atlas_clear(void);
+
   private:
     void
     make_subsets_ready(void);
 
+    void
+    set_glyph(unsigned int I, const fastuidraw::GlyphMetrics &M,
+              const fastuidraw::vec2 &position);
+
     float m_format_size;
     enum fastuidraw::PainterEnums::screen_orientation m_orientation;
     enum fastuidraw::PainterEnums::glyph_layout_type m_layout;
@@ -328,6 +409,9 @@ namespace
     std::vector<PerAddedGlyph> m_added_glyphs;
     GlyphSubsetPrivate *m_root;
     std::vector<GlyphSubsetPrivate*> m_subsets;
+
+    unsigned int m_upload_clear_count;
+    bool m_upload_success;
   };
 }
 
@@ -335,7 +419,8 @@ namespace
 // GlyphAttributesIndices methods
 void
 GlyphAttributesIndices::
-set_values(fastuidraw::c_array<const fastuidraw::Glyph> glyphs,
+set_values(fastuidraw::GlyphCache *cache,
+           fastuidraw::c_array<const fastuidraw::Glyph> glyphs,
            fastuidraw::c_array<const fastuidraw::vec2> positions,
            float render_format_size,
            enum fastuidraw::PainterEnums::screen_orientation orientation,
@@ -345,6 +430,11 @@ set_values(fastuidraw::c_array<const fastuidraw::Glyph> glyphs,
 
   unsigned int num_attrs(0), num_indices(0);
 
+  FASTUIDRAWassert(!m_cache);
+  m_cache = cache;
+  m_glyphs.assign(glyphs.begin(), glyphs.end());
+  m_cache->pin_glyphs(glyphs);
+
   for (Glyph G : glyphs)
     {
       if (G.valid()
@@ -381,6 +471,27 @@ set_values(fastuidraw::c_array<const fastuidraw::Glyph> glyphs,
     }
 }
 
+void
+GlyphAttributesIndices::
+repack_glyph_attributes(void)
+{
+  using namespace fastuidraw;
+
+  /* the same glyphs as in set_values() received attributes */
+  unsigned int attr(0);
+  for (const Glyph &G : m_glyphs)
+    {
+      if (G.valid()
+          && G.render_size().x() > 0
+          && G.render_size().y() > 0)
+        {
+          G.repack_glyph_attributes(attr, make_c_array(m_attribs));
+          attr += 4;
+        }
+    }
+  FASTUIDRAWassert(attr == m_attribs.size());
+}
+
 //////////////////////////////////
 // Splitter methods
 enum Splitter::place_element_t
@@ -581,9 +692,10 @@ add_glyph(const PerAddedGlyph &G)
       return;
     }
 
-  if (m_bounding_box.union_box(G.m_bounding_box) && !m_path)
+  if (m_bounding_box.union_box(G.m_bounding_box) && m_path)
     {
       FASTUIDRAWdelete(m_path);
+      m_path = nullptr;
     }
   if (is_split())
     {
@@ -605,8 +717,7 @@ add_glyph_when_split(const PerAddedGlyph &G)
   P = m_splitter.place_element(G);
   if (P == Splitter::place_in_parent)
     {
-      m_data.clear();
-      m_glyph_list.push_back(G.m_index);
+      insert_into_glyph_list(G.m_index);
     }
   else
     {
@@ -620,14 +731,82 @@ add_glyph_when_not_split(const PerAddedGlyph &G)
 {
   FASTUIDRAWassert(!is_split());
 
-  m_data.clear();
-  m_glyph_list.push_back(G.m_index);
+  insert_into_glyph_list(G.m_index);
   if (m_gen < MaxDepth && m_glyph_list.size() > SplittingSize)
     {
       split();
     }
 }
 
+void
+GlyphSubsetPrivate::
+insert_into_glyph_list(unsigned int I)
+{
+  std::vector<unsigned int>::iterator iter;
+
+  /* keep m_glyph_list sorted; when glyphs are appended
+   * this is the same as push_back().
+   */
+  iter = std::lower_bound(m_glyph_list.begin(), m_glyph_list.end(), I);
+  FASTUIDRAWassert(iter == m_glyph_list.end() || *iter != I);
+  m_glyph_list.insert(iter, I);
+  m_data.clear();
+}
+
+void
+GlyphSubsetPrivate::
+remove_glyph(const PerAddedGlyph &G)
+{
+  std::vector<unsigned int>::iterator iter;
+
+  if (G.m_bounding_box.empty())
+    {
+      return;
+    }
+
+  /* the placement of G is a function only of its bounding
+   * box and the Splitter values, thus G is found by walking
+   * the same path that add_glyph() took. The bounding box
+   * of this subset is not shrunk; it is only used for
+   * culling and remains a valid (though looser) bound.
+   */
+  if (is_split())
+    {
+      enum Splitter::place_element_t P;
+
+      P = m_splitter.place_element(G);
+      if (P != Splitter::place_in_parent)
+        {
+          m_child[P]->remove_glyph(G);
+          return;
+        }
+    }
+
+  iter = std::lower_bound(m_glyph_list.begin(), m_glyph_list.end(), G.m_index);
+  FASTUIDRAWassert(iter != m_glyph_list.end() && *iter == G.m_index);
+  m_glyph_list.erase(iter);
+  m_data.clear();
+}
+
+void
+GlyphSubsetPrivate::
+shift_glyph_indices(unsigned int begin, int delta)
+{
+  std::vector<unsigned int>::iterator iter;
+
+  iter = std::lower_bound(m_glyph_list.begin(), m_glyph_list.end(), begin);
+  for (; iter != m_glyph_list.end(); ++iter)
+    {
+      *iter += delta;
+    }
+
+  if (is_split())
+    {
+      m_child[0]->shift_glyph_indices(begin, delta);
+      m_child[1]->shift_glyph_indices(begin, delta);
+    }
+}
+
 void
 GlyphSubsetPrivate::
 split(void)
@@ -760,10 +939,26 @@ attributes_indices(fastuidraw::GlyphRenderer R)
   using namespace fastuidraw;
 
   std::map<GlyphRenderer, GlyphAttributesIndices>::const_iterator iter;
-  if (!m_data.empty() && m_glyph_atlas_clear_count != m_owner->cache()->number_times_atlas_cleared())
+  unsigned int clear_count(m_owner->cache()->number_times_atlas_cleared());
+
+  if (m_glyph_atlas_clear_count != clear_count)
     {
-      m_glyph_atlas_clear_count = m_owner->cache()->number_times_atlas_cleared();
-      m_data.clear();
+      m_glyph_atlas_clear_count = clear_count;
+      if (!m_data.empty() && m_owner->upload_glyphs_after_atlas_clear())
+        {
+          /* the glyphs are pinned, thus still in the cache, and
+           * the layout of the attribute and index data does not
+           * change; only the fields from the atlas need updating.
+           */
+          for (auto &e : m_data)
+            {
+              e.second.repack_glyph_attributes();
+            }
+        }
+      else
+        {
+          m_data.clear();
+        }
     }
 
   iter = m_data.find(R);
@@ -792,7 +987,8 @@ attributes_indices(fastuidraw::GlyphRenderer R)
   c_array<Glyph> tmp_glyphs(make_c_array(tmp_glyphs_store));
   m_owner->cache()->fetch_glyphs(R, c_array<const GlyphMetrics>(tmp_metrics), tmp_glyphs, true);
 
-  dst.set_values(tmp_glyphs,
+  dst.set_values(m_owner->cache().get(),
+                 tmp_glyphs,
                  tmp_positions,
                  m_owner->format_size(),
                  m_owner->orientation(),
@@ -801,14 +997,89 @@ attributes_indices(fastuidraw::GlyphRenderer R)
   return dst;
 }
 
+void
+GlyphSubsetPrivate::
+append_glyphs(std::vector<fastuidraw::Glyph> *dst) const
+{
+  for (const auto &e : m_data)
+    {
+      fastuidraw::c_array<const fastuidraw::Glyph> glyphs(e.second.glyphs());
+      dst->insert(dst->end(), glyphs.begin(), glyphs.end());
+    }
+}
+
 /////////////////////////////////
 // GlyphSequencePrivate methods
+bool
+GlyphSequencePrivate::
+upload_glyphs_after_atlas_clear(void)
+{
+  unsigned int clear_count(m_cache->number_times_atlas_cleared());
+
+  if (m_upload_clear_count != clear_count)
+    {
+      std::vector<fastuidraw::Glyph> glyphs;
+
+      m_upload_clear_count = clear_count;
+      for (const GlyphSubsetPrivate *p : m_subsets)
+        {
+          p->append_glyphs(&glyphs);
+        }
+      m_upload_success = (fastuidraw::routine_success
+                          == m_cache->upload_to_atlas(fastuidraw::make_c_array(glyphs)));
+    }
+  return m_upload_success;
+}
+
 void
 GlyphSequencePrivate::
-add_glyphs(fastuidraw::c_array<const fastuidraw::GlyphSource> sources,
-           fastuidraw::c_array<const fastuidraw::vec2> positions)
+set_glyph(unsigned int I, const fastuidraw::GlyphMetrics &M,
+          const fastuidraw::vec2 &position)
+{
+  PerAddedGlyph &G(m_added_glyphs[I]);
+
+  G.m_index = I;
+  G.m_metrics = M;
+  G.m_position = position;
+  G.m_bounding_box.clear();
+
+  if (M.valid())
+    {
+      float scale;
+      fastuidraw::vec2 p_bl, p_tr, lo, glyph_size;
+
+      scale = m_format_size / M.units_per_EM();
+      glyph_size = scale * M.size();
+      lo = (m_layout == fastuidraw::PainterEnums::glyph_layout_horizontal) ?
+        M.horizontal_layout_offset() :
+        M.vertical_layout_offset();
+
+      if (m_orientation == fastuidraw::PainterEnums::y_increases_downwards)
+        {
+          p_bl.x() = scale * lo.x();
+          p_tr.x() = p_bl.x() + glyph_size.x();
+
+          p_bl.y() = -scale * lo.y();
+          p_tr.y() = p_bl.y() - glyph_size.y();
+        }
+      else
+        {
+          p_bl = scale * lo;
+          p_tr = p_bl + glyph_size;
+        }
+      G.m_bounding_box.union_point(position + p_bl);
+      G.m_bounding_box.union_point(position + p_tr);
+    }
+}
+
+void
+GlyphSequencePrivate::
+insert_glyphs(unsigned int I,
+              fastuidraw::c_array<const fastuidraw::GlyphSource> sources,
+              fastuidraw::c_array<const fastuidraw::vec2> positions)
 {
   FASTUIDRAWassert(sources.size() == positions.size());
+  FASTUIDRAWassert(I <= m_added_glyphs.size());
 
   if (sources.empty())
     {
@@ -816,50 +1087,116 @@ add_glyphs(fastuidraw::c_array<const fastuidraw::GlyphSource> sources,
     }
 
   std::vector<fastuidraw::GlyphMetrics> tmp(sources.size());
-  unsigned int old_sz;
+  unsigned int cnt(sources.size());
 
-  old_sz = m_added_glyphs.size();
-  m_added_glyphs.resize(old_sz + sources.size());
   m_cache->fetch_glyph_metrics(sources, fastuidraw::make_c_array(tmp));
+  if (m_root && I < m_added_glyphs.size())
+    {
+      m_root->shift_glyph_indices(I, cnt);
+    }
 
-  for (unsigned int i = 0; i < sources.size(); ++i)
+  m_added_glyphs.insert(m_added_glyphs.begin() + I, cnt, PerAddedGlyph());
+  for (unsigned int i = I + cnt, endi = m_added_glyphs.size(); i < endi; ++i)
     {
-      fastuidraw::GlyphMetrics M(tmp[i]);
+      m_added_glyphs[i].m_index = i;
+    }
 
-      m_added_glyphs[i + old_sz].m_index = i + old_sz;
-      m_added_glyphs[i + old_sz].m_metrics = M;
-      m_added_glyphs[i + old_sz].m_position = positions[i];
+  for (unsigned int i = 0; i < cnt; ++i)
+    {
+      set_glyph(I + i, tmp[i], positions[i]);
+      if (m_root)
+        {
+          m_root->add_glyph(m_added_glyphs[I + i]);
+        }
+    }
+}
 
-      if (M.valid())
+void
+GlyphSequencePrivate::
+remove_glyphs(unsigned int begin, unsigned int count)
+{
+  unsigned int end;
+
+  begin = fastuidraw::t_min(begin, number_added_glyphs());
+  end = begin + fastuidraw::t_min(count, number_added_glyphs() - begin);
+  if (begin == end)
+    {
+      return;
+    }
+
+  if (m_root)
+    {
+      for (unsigned int i = begin; i < end; ++i)
         {
-          float scale;
-          fastuidraw::vec2 p_bl, p_tr, lo, glyph_size;
+          m_root->remove_glyph(m_added_glyphs[i]);
+        }
+      m_root->shift_glyph_indices(end, -int(end - begin));
+    }
 
-          scale = m_format_size / M.units_per_EM();
-          glyph_size = scale * M.size();
-          lo = (m_layout == fastuidraw::PainterEnums::glyph_layout_horizontal) ?
-            M.horizontal_layout_offset() :
-            M.vertical_layout_offset();
+  m_added_glyphs.erase(m_added_glyphs.begin() + begin,
+                       m_added_glyphs.begin() + end);
+  for (unsigned int i = begin, endi = m_added_glyphs.size(); i < endi; ++i)
+    {
+      m_added_glyphs[i].m_index = i;
+    }
+}
 
-          if (m_orientation == fastuidraw::PainterEnums::y_increases_downwards)
-            {
-              p_bl.x() = scale * lo.x();
-              p_tr.x() = p_bl.x() + glyph_size.x();
+void
+GlyphSequencePrivate::
+replace_glyphs(unsigned int begin,
+               fastuidraw::c_array<const fastuidraw::GlyphSource> sources,
+               fastuidraw::c_array<const fastuidraw::vec2> positions)
+{
+  FASTUIDRAWassert(sources.size() == positions.size());
+  FASTUIDRAWassert(begin + sources.size() <= m_added_glyphs.size());
 
-              p_bl.y() = -scale * lo.y();
-              p_tr.y() = p_bl.y() - glyph_size.y();
-            }
-          else
-            {
-              p_bl = scale * lo;
-              p_tr = p_bl + glyph_size;
-            }
-          m_added_glyphs[i + old_sz].m_bounding_box.union_point(positions[i] + p_bl);
-          m_added_glyphs[i + old_sz].m_bounding_box.union_point(positions[i] + p_tr);
-          if (m_root)
-            {
-              m_root->add_glyph(m_added_glyphs[i + old_sz]);
-            }
+  if (sources.empty())
+    {
+      return;
+    }
+
+  std::vector<fastuidraw::GlyphMetrics> tmp(sources.size());
+
+  m_cache->fetch_glyph_metrics(sources, fastuidraw::make_c_array(tmp));
+  for (unsigned int i = 0; i < sources.size(); ++i)
+    {
+      if (m_root)
+        {
+          m_root->remove_glyph(m_added_glyphs[begin + i]);
+        }
+
+      set_glyph(begin + i, tmp[i], positions[i]);
+      if (m_root)
+        {
+          m_root->add_glyph(m_added_glyphs[begin + i]);
+        }
+    }
+}
+
+void
+GlyphSequencePrivate::
+translate_glyphs(unsigned int begin, unsigned int count,
+                 const fastuidraw::vec2 &delta)
+{
+  unsigned int end;
+
+  begin = fastuidraw::t_min(begin, number_added_glyphs());
+  end = begin + fastuidraw::t_min(count, number_added_glyphs() - begin);
+  for (unsigned int i = begin; i < end; ++i)
+    {
+      PerAddedGlyph &G(m_added_glyphs[i]);
+
+      if (m_root)
+        {
+          m_root->remove_glyph(G);
+        }
+
+      G.m_position += delta;
+      G.m_bounding_box.translate(delta);
+
+      if (m_root)
+        {
+          m_root->add_glyph(G);
         }
     }
 }
@@ -1017,7 +1354,48 @@ add_glyphs(c_array<const GlyphSource> sources,
 {
   GlyphSequencePrivate *d;
   d = static_cast<GlyphSequencePrivate*>(m_d);
-  d->add_glyphs(sources, positions);
+  d->insert_glyphs(d->number_added_glyphs(), sources, positions);
+}
+
+void
+fastuidraw::GlyphSequence::
+insert_glyphs(unsigned int I,
+              c_array<const GlyphSource> sources,
+              c_array<const vec2> positions)
+{
+  GlyphSequencePrivate *d;
+  d = static_cast<GlyphSequencePrivate*>(m_d);
+  d->insert_glyphs(I, sources, positions);
+}
+
+void
+fastuidraw::GlyphSequence::
+remove_glyphs(unsigned int begin, unsigned int count)
+{
+  GlyphSequencePrivate *d;
+  d = static_cast<GlyphSequencePrivate*>(m_d);
+  d->remove_glyphs(begin, count);
+}
+
+void
+fastuidraw::GlyphSequence::
+replace_glyphs(unsigned int begin,
+               c_array<const GlyphSource> sources,
+               c_array<const vec2> positions)
+{
+  GlyphSequencePrivate *d;
+  d = static_cast<GlyphSequencePrivate*>(m_d);
+  d->replace_glyphs(begin, sources, positions);
+}
+
+void
+fastuidraw::GlyphSequence::
+translate_glyphs(unsigned int begin, unsigned int count,
+                 const vec2 &delta)
+{
+  GlyphSequencePrivate *d;
+  d = static_cast<GlyphSequencePrivate*>(m_d);
+  d->translate_glyphs(begin, count, delta);
 }
 
 unsigned int
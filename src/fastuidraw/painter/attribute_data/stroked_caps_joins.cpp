@@ -22,6 +22,7 @@
 
 #include <fastuidraw/tessellated_path.hpp>
 #include <fastuidraw/path.hpp>
+#include <fastuidraw/util/mutex.hpp>
 #include <fastuidraw/painter/attribute_data/stroked_point.hpp>
 #include <fastuidraw/painter/attribute_data/arc_stroked_point.hpp>
 #include <fastuidraw/painter/attribute_data/stroked_caps_joins.hpp>
@@ -1028,35 +1029,114 @@ namespace
   };
 
   template<typename T>
-  class PreparedAttributeData
+  class PreparedAttributeData:fastuidraw::noncopyable
   {
   public:
     PreparedAttributeData(void):
-      m_ready(false)
+      m_data(nullptr),
+      m_empty(false),
+      m_used(false)
     {}
 
+    ~PreparedAttributeData()
+    {
+      if (m_data)
+        {
+          FASTUIDRAWdelete(m_data);
+        }
+    }
+
     /* must be called before the first call to data().
      */
     void
     mark_as_empty(void)
     {
-      m_ready = true;
+      m_empty = true;
     }
 
+    /* the data is only generated on the first call
+     * to data() after ctor or after the data was
+     * released by release_if_unused(); the caller
+     * must hold the lock of the owning StrokedCapsJoins.
+     */
     const fastuidraw::PainterAttributeData&
-    data(const PathData &P, const SubsetPrivate *st)
+    data(const PathData &P, const SubsetPrivate *st,
+         const fastuidraw::PainterAttributeData &empty_data)
+    {
+      m_used = true;
+      if (m_empty)
+        {
+          return empty_data;
+        }
+
+      if (!m_data)
+        {
+          m_data = FASTUIDRAWnew fastuidraw::PainterAttributeData();
+          m_data->set_data(T(P, st));
+        }
+      return *m_data;
+    }
+
+    /* releases the data if data() was not called since
+     * the last call to release_if_unused(), returns true
+     * if data was released.
+     */
+    bool
+    release_if_unused(void)
     {
-      if (!m_ready)
+      bool return_value(!m_used && m_data);
+
+      if (return_value)
         {
-          m_data.set_data(T(P, st));
-          m_ready = true;
+          FASTUIDRAWdelete(m_data);
+          m_data = nullptr;
         }
-      return m_data;
+      m_used = false;
+      return return_value;
     }
 
   private:
-    fastuidraw::PainterAttributeData m_data;
-    bool m_ready;
+    fastuidraw::PainterAttributeData *m_data;
+    bool m_empty, m_used;
+  };
+
+  class ThreshCache:fastuidraw::noncopyable
+  {
+  public:
+    ThreshCache(void):
+      m_used(false)
+    {}
+
+    ~ThreshCache()
+    {
+      clear();
+    }
+
+    void
+    clear(void)
+    {
+      for(unsigned int i = 0, endi = m_values.size(); i < endi; ++i)
+        {
+          FASTUIDRAWdelete(m_values[i].m_data);
+        }
+      m_values.clear();
+    }
+
+    bool
+    release_if_unused(void)
+    {
+      bool return_value(!m_used && !m_values.empty());
+
+      if (return_value)
+        {
+          clear();
+        }
+      m_used = false;
+      return return_value;
+    }
+
+    std::vector<ThreshWithData> m_values;
+    bool m_used;
   };
 
   class StrokedCapsJoinsPrivate:fastuidraw::noncopyable
@@ -1071,8 +1151,18 @@ namespace
 
     template<typename T>
     const fastuidraw::PainterAttributeData&
-    fetch_create(float thresh,
-                 std::vector<ThreshWithData> &values);
+    fetch_create(float thresh, ThreshCache &cache);
+
+    template<typename T>
+    const fastuidraw::PainterAttributeData&
+    fetch(PreparedAttributeData<T> &v)
+    {
+      fastuidraw::Mutex::Guard m(m_mutex);
+      return v.data(m_path_data, m_subset, m_empty_data);
+    }
+
+    unsigned int
+    release_unused_data(void);
 
     SubsetPrivate* m_subset;
 
@@ -1089,11 +1179,12 @@ namespace
     unsigned int m_chunk_of_joins;
     unsigned int m_chunk_of_caps;
 
-    std::vector<ThreshWithData> m_rounded_joins;
-    std::vector<ThreshWithData> m_rounded_caps;
+    ThreshCache m_rounded_joins;
+    ThreshCache m_rounded_caps;
 
     bool m_empty_path;
     fastuidraw::PainterAttributeData m_empty_data;
+    fastuidraw::Mutex m_mutex;
   };
 
 }
@@ -2761,8 +2852,10 @@ StrokedCapsJoinsPrivate(const ContourData &P):
       m_miter_clip_joins.mark_as_empty();
       m_miter_joins.mark_as_empty();
       m_miter_bevel_joins.mark_as_empty();
+      m_arc_rounded_joins.mark_as_empty();
       m_square_caps.mark_as_empty();
       m_adjustable_caps.mark_as_empty();
+      m_arc_rounded_caps.mark_as_empty();
       m_chunk_of_joins = 0;
       m_chunk_of_caps = 0;
     }
@@ -2771,16 +2864,6 @@ StrokedCapsJoinsPrivate(const ContourData &P):
 StrokedCapsJoinsPrivate::
 ~StrokedCapsJoinsPrivate()
 {
-  for(unsigned int i = 0, endi = m_rounded_joins.size(); i < endi; ++i)
-    {
-      FASTUIDRAWdelete(m_rounded_joins[i].m_data);
-    }
-
-  for(unsigned int i = 0, endi = m_rounded_caps.size(); i < endi; ++i)
-    {
-      FASTUIDRAWdelete(m_rounded_caps[i].m_data);
-    }
-
   if (!m_empty_path)
     {
       FASTUIDRAWdelete(m_subset);
@@ -2811,8 +2894,12 @@ create_joins_caps(const ContourData &P)
 template<typename T>
 const fastuidraw::PainterAttributeData&
 StrokedCapsJoinsPrivate::
-fetch_create(float thresh, std::vector<ThreshWithData> &values)
+fetch_create(float thresh, ThreshCache &cache)
 {
+  fastuidraw::Mutex::Guard m(m_mutex);
+  std::vector<ThreshWithData> &values(cache.m_values);
+
+  cache.m_used = true;
   if (values.empty())
     {
       fastuidraw::PainterAttributeData *newD;
@@ -2853,6 +2940,27 @@ fetch_create(float thresh, std::vector<ThreshWithData> &values)
     }
 }
 
+unsigned int
+StrokedCapsJoinsPrivate::
+release_unused_data(void)
+{
+  fastuidraw::Mutex::Guard m(m_mutex);
+  unsigned int return_value(0);
+
+  return_value += m_bevel_joins.release_if_unused();
+  return_value += m_miter_clip_joins.release_if_unused();
+  return_value += m_miter_joins.release_if_unused();
+  return_value += m_miter_bevel_joins.release_if_unused();
+  return_value += m_arc_rounded_joins.release_if_unused();
+  return_value += m_square_caps.release_if_unused();
+  return_value += m_adjustable_caps.release_if_unused();
+  return_value += m_arc_rounded_caps.release_if_unused();
+  return_value += m_rounded_joins.release_if_unused();
+  return_value += m_rounded_caps.release_if_unused();
+
+  return return_value;
+}
+
 //////////////////////////////////////////////
 // fastuidraw::StrokedCapsJoins::ScratchSpace methods
 fastuidraw::StrokedCapsJoins::ScratchSpace::
@@ -3152,7 +3260,7 @@ square_caps(void) const
 {
   StrokedCapsJoinsPrivate *d;
   d = static_cast<StrokedCapsJoinsPrivate*>(m_d);
-  return d->m_square_caps.data(d->m_path_data, d->m_subset);
+  return d->fetch(d->m_square_caps);
 }
 
 const fastuidraw::PainterAttributeData&
@@ -3161,7 +3269,7 @@ adjustable_caps(void) const
 {
   StrokedCapsJoinsPrivate *d;
   d = static_cast<StrokedCapsJoinsPrivate*>(m_d);
-  return d->m_adjustable_caps.data(d->m_path_data, d->m_subset);
+  return d->fetch(d->m_adjustable_caps);
 }
 
 const fastuidraw::PainterAttributeData&
@@ -3170,7 +3278,7 @@ bevel_joins(void) const
 {
   StrokedCapsJoinsPrivate *d;
   d = static_cast<StrokedCapsJoinsPrivate*>(m_d);
-  return d->m_bevel_joins.data(d->m_path_data, d->m_subset);
+  return d->fetch(d->m_bevel_joins);
 }
 
 const fastuidraw::PainterAttributeData&
@@ -3179,7 +3287,7 @@ miter_clip_joins(void) const
 {
   StrokedCapsJoinsPrivate *d;
   d = static_cast<StrokedCapsJoinsPrivate*>(m_d);
-  return d->m_miter_clip_joins.data(d->m_path_data, d->m_subset);
+  return d->fetch(d->m_miter_clip_joins);
 }
 
 const fastuidraw::PainterAttributeData&
@@ -3188,7 +3296,7 @@ miter_bevel_joins(void) const
 {
   StrokedCapsJoinsPrivate *d;
   d = static_cast<StrokedCapsJoinsPrivate*>(m_d);
-  return d->m_miter_bevel_joins.data(d->m_path_data, d->m_subset);
+  return d->fetch(d->m_miter_bevel_joins);
 }
 
 const fastuidraw::PainterAttributeData&
@@ -3197,7 +3305,7 @@ miter_joins(void) const
 {
   StrokedCapsJoinsPrivate *d;
   d = static_cast<StrokedCapsJoinsPrivate*>(m_d);
-  return d->m_miter_joins.data(d->m_path_data, d->m_subset);
+  return d->fetch(d->m_miter_joins);
 }
 
 const fastuidraw::PainterAttributeData&
@@ -3206,7 +3314,7 @@ arc_rounded_joins(void) const
 {
   StrokedCapsJoinsPrivate *d;
   d = static_cast<StrokedCapsJoinsPrivate*>(m_d);
-  return d->m_arc_rounded_joins.data(d->m_path_data, d->m_subset);
+  return d->fetch(d->m_arc_rounded_joins);
 }
 
 const fastuidraw::PainterAttributeData&
@@ -3215,7 +3323,7 @@ arc_rounded_caps(void) const
 {
   StrokedCapsJoinsPrivate *d;
   d = static_cast<StrokedCapsJoinsPrivate*>(m_d);
-  return d->m_arc_rounded_caps.data(d->m_path_data, d->m_subset);
+  return d->fetch(d->m_arc_rounded_caps);
 }
 
 const fastuidraw::PainterAttributeData&
@@ -3240,3 +3348,12 @@ rounded_caps(float thresh) const
     d->fetch_create<RoundedCapCreator>(thresh, d->m_rounded_caps) :
     d->m_empty_data;
 }
+
+unsigned int
+fastuidraw::StrokedCapsJoins::
+release_unused_data(void) const
+{
+  StrokedCapsJoinsPrivate *d;
+  d = static_cast<StrokedCapsJoinsPrivate*>(m_d);
+  return d->release_unused_data();
+}
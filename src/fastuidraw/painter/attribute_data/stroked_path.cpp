@@ -17,6 +17,7 @@
  */
 
 #include <vector>
+#include <cmath>
 #include <complex>
 #include <algorithm>
 
@@ -29,6 +30,8 @@
 #include <fastuidraw/painter/attribute_data/stroked_point.hpp>
 #include <fastuidraw/painter/attribute_data/arc_stroked_point.hpp>
 #include <fastuidraw/painter/shader/painter_stroke_shader.hpp>
+#include <fastuidraw/util/trace_events.hpp>
+#include <fastuidraw/util/mutex.hpp>
 #include <private/util_private.hpp>
 #include <private/util_private_ostream.hpp>
 #include <private/bounding_box.hpp>
@@ -66,6 +69,13 @@ namespace
                   StrokedPoint::depth_num_bits, depth);
   }
 
+  template<typename T>
+  T
+  interpolate(const T &a, const T &b, float t)
+  {
+    return a + t * (b - a);
+  }
+
   class SingleSubEdge
   {
   public:
@@ -437,6 +447,131 @@ namespace
                         std::vector<fastuidraw::PainterIndex> &index_data) const;
   };
 
+  class DashedEdgeKey
+  {
+  public:
+    DashedEdgeKey(fastuidraw::c_array<const fastuidraw::PainterDashedStrokeParams::DashPatternElement> dash_pattern,
+                  float dash_offset, enum fastuidraw::PainterEnums::cap_style cp,
+                  float thresh);
+
+    bool
+    operator==(const DashedEdgeKey &rhs) const;
+
+    /* dash pattern realized as intervals [m_begin, m_end)
+     * of where the pattern is on within [0, m_total_length)
+     */
+    std::vector<fastuidraw::range_type<float> > m_intervals;
+    float m_total_length;
+    float m_dash_offset;
+    enum fastuidraw::PainterEnums::cap_style m_cap_style;
+    float m_thresh;
+  };
+
+  class DashedEdgeFiller:public fastuidraw::PainterAttributeDataFiller
+  {
+  public:
+    DashedEdgeFiller(const DashedEdgeKey &key,
+                     const fastuidraw::PainterAttributeData &src);
+
+    /* returns false if the source data was not a sequence
+     * of bevels and line segments as made by
+     * LineEdgeAttributeFiller, in which case the filler
+     * holds no data.
+     */
+    bool
+    valid(void) const
+    {
+      return m_valid;
+    }
+
+    virtual
+    void
+    compute_sizes(unsigned int &num_attributes,
+                  unsigned int &num_indices,
+                  unsigned int &num_attribute_chunks,
+                  unsigned int &num_index_chunks,
+                  unsigned int &number_z_ranges) const
+    {
+      num_attributes = m_attributes.size();
+      num_indices = m_indices.size();
+      num_attribute_chunks = num_index_chunks = number_z_ranges = 1;
+    }
+
+    virtual
+    void
+    fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+              fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
+              fastuidraw::c_array<fastuidraw::c_array<const fastuidraw::PainterAttribute> > attribute_chunks,
+              fastuidraw::c_array<fastuidraw::c_array<const fastuidraw::PainterIndex> > index_chunks,
+              fastuidraw::c_array<fastuidraw::range_type<int> > zranges,
+              fastuidraw::c_array<int> index_adjusts) const;
+
+  private:
+    bool
+    point_covered(float distance_from_contour_start) const;
+
+    static
+    bool
+    is_bevel(fastuidraw::c_array<const fastuidraw::StrokedPoint> pts);
+
+    static
+    bool
+    is_segment(fastuidraw::c_array<const fastuidraw::StrokedPoint> pts);
+
+    void
+    process_bevel(fastuidraw::c_array<const fastuidraw::PainterAttribute> src,
+                  const fastuidraw::StrokedPoint &pt);
+
+    void
+    process_segment(fastuidraw::c_array<const fastuidraw::StrokedPoint> pts);
+
+    void
+    add_piece(fastuidraw::c_array<const fastuidraw::StrokedPoint> pts,
+              float t0, float t1);
+
+    void
+    add_cap(const fastuidraw::StrokedPoint &src,
+            const fastuidraw::vec2 &tangent_into_cap);
+
+    const DashedEdgeKey &m_key;
+    bool m_valid;
+    fastuidraw::range_type<int> m_zrange;
+    unsigned int m_num_arc_points_per_cap;
+    float m_delta_theta;
+    std::vector<fastuidraw::PainterAttribute> m_attributes;
+    std::vector<fastuidraw::PainterIndex> m_indices;
+  };
+
+  class DashedEdgesPrivate:fastuidraw::noncopyable
+  {
+  public:
+    DashedEdgesPrivate(const DashedEdgeKey &key,
+                       const fastuidraw::StrokedPath *path):
+      m_key(key),
+      m_path(path),
+      m_data(path->number_subsets(), nullptr),
+      m_ready(path->number_subsets(), false),
+      m_last_used(0u)
+    {}
+
+    ~DashedEdgesPrivate();
+
+    DashedEdgeKey m_key;
+    const fastuidraw::StrokedPath *m_path;
+
+    /* m_mutex guards the lazy creation of m_data; an entry
+     * whose m_ready is true and whose m_data is nullptr
+     * is for a Subset whose data the DashedEdgeFiller
+     * rejected.
+     */
+    fastuidraw::Mutex m_mutex;
+    std::vector<fastuidraw::PainterAttributeData*> m_data;
+    std::vector<bool> m_ready;
+
+    /* guarded by the m_dashed_edges_mutex of the StrokedPath */
+    uint64_t m_last_used;
+  };
+
   class StrokedPathPrivate:fastuidraw::noncopyable
   {
   public:
@@ -463,6 +598,15 @@ namespace
     fastuidraw::StrokedCapsJoins m_caps_joins;
     SubsetPrivate* m_root;
     std::vector<SubsetPrivate*> m_subsets;
+
+    /* dashed_edges() is const and may be called from several
+     * threads, m_dashed_edges_mutex guards the LRU cache; the
+     * entries are reference counted so that an evicted entry
+     * lives on while a caller still uses it.
+     */
+    fastuidraw::Mutex m_dashed_edges_mutex;
+    uint64_t m_dashed_edges_use_count;
+    std::vector<fastuidraw::reference_counted_ptr<const fastuidraw::StrokedPath::DashedEdges> > m_dashed_edges;
   };
 
 }
@@ -1973,6 +2117,509 @@ build_line_segment(const SingleSubEdge &sub_edge, unsigned int &depth,
   ++depth;
 }
 
+////////////////////////////////////////////
+// DashedEdgeKey methods
+DashedEdgeKey::
+DashedEdgeKey(fastuidraw::c_array<const fastuidraw::PainterDashedStrokeParams::DashPatternElement> dash_pattern,
+              float dash_offset, enum fastuidraw::PainterEnums::cap_style cp,
+              float thresh):
+  m_total_length(0.0f),
+  m_cap_style(cp),
+  m_thresh(thresh)
+{
+  using namespace fastuidraw;
+
+  for (const PainterDashedStrokeParams::DashPatternElement &E : dash_pattern)
+    {
+      float draw_length, space_length;
+
+      draw_length = t_max(0.0f, E.m_draw_length);
+      space_length = t_max(0.0f, E.m_space_length);
+      m_intervals.push_back(range_type<float>(m_total_length, m_total_length + draw_length));
+      m_total_length += draw_length + space_length;
+    }
+
+  if (m_total_length > 0.0f)
+    {
+      /* normalize the dash offset so that dash offsets that
+       * differ by a multiple of the pattern length share
+       * the same cache entry.
+       */
+      m_dash_offset = std::fmod(dash_offset, m_total_length);
+      if (m_dash_offset < 0.0f)
+        {
+          m_dash_offset += m_total_length;
+        }
+    }
+  else
+    {
+      m_dash_offset = 0.0f;
+      m_intervals.clear();
+    }
+
+  if (m_cap_style != PainterEnums::square_caps
+      && m_cap_style != PainterEnums::rounded_caps)
+    {
+      m_cap_style = PainterEnums::flat_caps;
+    }
+
+  if (m_cap_style != PainterEnums::rounded_caps)
+    {
+      /* thresh only affects the rounded caps */
+      m_thresh = 0.0f;
+    }
+}
+
+bool
+DashedEdgeKey::
+operator==(const DashedEdgeKey &rhs) const
+{
+  if (m_total_length != rhs.m_total_length
+      || m_dash_offset != rhs.m_dash_offset
+      || m_cap_style != rhs.m_cap_style
+      || m_thresh != rhs.m_thresh
+      || m_intervals.size() != rhs.m_intervals.size())
+    {
+      return false;
+    }
+
+  for (unsigned int i = 0, endi = m_intervals.size(); i < endi; ++i)
+    {
+      if (m_intervals[i].m_begin != rhs.m_intervals[i].m_begin
+          || m_intervals[i].m_end != rhs.m_intervals[i].m_end)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+/////////////////////////////////////////
+// DashedEdgeFiller methods
+DashedEdgeFiller::
+DashedEdgeFiller(const DashedEdgeKey &key,
+                 const fastuidraw::PainterAttributeData &src):
+  m_key(key),
+  m_valid(true),
+  m_zrange(src.z_range(0)),
+  m_num_arc_points_per_cap(0),
+  m_delta_theta(0.0f)
+{
+  using namespace fastuidraw;
+
+  c_array<const PainterAttribute> attribs(src.attribute_data_chunk(0));
+
+  if (m_key.m_cap_style == PainterEnums::rounded_caps)
+    {
+      m_num_arc_points_per_cap = detail::number_segments_for_tessellation(FASTUIDRAW_PI, m_key.m_thresh);
+      m_delta_theta = static_cast<float>(FASTUIDRAW_PI) / static_cast<float>(m_num_arc_points_per_cap - 1);
+    }
+
+  /* The edge data of a StrokedPath without arcs is a sequence
+   * of bevels (3 points, tagged with StrokedPoint::bevel_edge_mask)
+   * and of line segments (6 points) as made by
+   * LineEdgeAttributeFiller; the merging of children only
+   * concatenates that data, so the sequence should be intact
+   * for every Subset. Should it not be, the data is rejected
+   * rather than split at the wrong points.
+   */
+  for (unsigned int i = 0, endi = attribs.size(); i < endi;)
+    {
+      vecN<StrokedPoint, 6> pts;
+      c_array<const StrokedPoint> pts_array;
+      unsigned int cnt;
+
+      StrokedPoint::unpack_point(&pts[0], attribs[i]);
+      cnt = (pts[0].m_packed_data & StrokedPoint::bevel_edge_mask) ? 3u : 6u;
+      if (i + cnt > endi)
+        {
+          m_valid = false;
+          break;
+        }
+
+      for (unsigned int k = 1; k < cnt; ++k)
+        {
+          StrokedPoint::unpack_point(&pts[k], attribs[i + k]);
+        }
+
+      pts_array = c_array<const StrokedPoint>(pts).sub_array(0, cnt);
+      if (cnt == 3u && is_bevel(pts_array))
+        {
+          process_bevel(attribs.sub_array(i, 3), pts[0]);
+        }
+      else if (cnt == 6u && is_segment(pts_array))
+        {
+          process_segment(pts_array);
+        }
+      else
+        {
+          m_valid = false;
+          break;
+        }
+      i += cnt;
+    }
+
+  if (!m_valid)
+    {
+      m_attributes.clear();
+      m_indices.clear();
+      return;
+    }
+
+  /* same as EdgeAttributeFillerBase, reverse the triangles so that
+   * depth values are in non-increasing order.
+   */
+  std::reverse(m_indices.begin(), m_indices.end());
+}
+
+bool
+DashedEdgeFiller::
+point_covered(float d) const
+{
+  using namespace fastuidraw;
+
+  if (m_key.m_total_length <= 0.0f)
+    {
+      return true;
+    }
+
+  d = std::fmod(d + m_key.m_dash_offset, m_key.m_total_length);
+  if (d < 0.0f)
+    {
+      d += m_key.m_total_length;
+    }
+
+  for (const range_type<float> &R : m_key.m_intervals)
+    {
+      if (R.m_begin <= d && d <= R.m_end)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+bool
+DashedEdgeFiller::
+is_bevel(fastuidraw::c_array<const fastuidraw::StrokedPoint> pts)
+{
+  using namespace fastuidraw;
+
+  for (const StrokedPoint &pt : pts)
+    {
+      if (pt.offset_type() != StrokedPoint::offset_sub_edge
+          || (pt.m_packed_data & StrokedPoint::bevel_edge_mask) == 0u)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+DashedEdgeFiller::
+is_segment(fastuidraw::c_array<const fastuidraw::StrokedPoint> pts)
+{
+  using namespace fastuidraw;
+
+  /* the first three points are at the start of the
+   * segment and the last three at its end.
+   */
+  for (unsigned int k = 0; k < 6; ++k)
+    {
+      uint32_t expected_end_bit;
+
+      expected_end_bit = (k < 3) ? 0u : uint32_t(StrokedPoint::end_sub_edge_mask);
+      if (pts[k].offset_type() != StrokedPoint::offset_sub_edge
+          || (pts[k].m_packed_data & StrokedPoint::bevel_edge_mask) != 0u
+          || (pts[k].m_packed_data & StrokedPoint::end_sub_edge_mask) != expected_end_bit)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+DashedEdgeFiller::
+process_bevel(fastuidraw::c_array<const fastuidraw::PainterAttribute> src,
+              const fastuidraw::StrokedPoint &pt)
+{
+  using namespace fastuidraw;
+
+  unsigned int vert_offset(m_attributes.size());
+
+  if (!point_covered(pt.m_distance_from_contour_start))
+    {
+      return;
+    }
+
+  for (unsigned int k = 0; k < 3; ++k)
+    {
+      m_attributes.push_back(src[k]);
+      m_indices.push_back(vert_offset + k);
+    }
+}
+
+void
+DashedEdgeFiller::
+process_segment(fastuidraw::c_array<const fastuidraw::StrokedPoint> pts)
+{
+  using namespace fastuidraw;
+
+  float s0, s1, len, period_start;
+  vec2 v;
+
+  /* tangent of the segment from the normal as in
+   * SingleSubEdge::unit_vector_into_segment().
+   */
+  v = vec2(pts[0].m_pre_offset.y(), -pts[0].m_pre_offset.x());
+  s0 = pts[0].m_distance_from_contour_start;
+  s1 = pts[3].m_distance_from_contour_start;
+  len = s1 - s0;
+
+  if (m_key.m_total_length <= 0.0f)
+    {
+      add_piece(pts, 0.0f, 1.0f);
+      return;
+    }
+
+  if (len <= 0.0f)
+    {
+      if (point_covered(s0))
+        {
+          add_piece(pts, 0.0f, 1.0f);
+        }
+      return;
+    }
+
+  /* walk the dash intervals, in the coordinate d + dash_offset,
+   * that intersect [s0 + dash_offset, s1 + dash_offset].
+   */
+  s0 += m_key.m_dash_offset;
+  s1 += m_key.m_dash_offset;
+  period_start = m_key.m_total_length * std::floor(s0 / m_key.m_total_length);
+  for (; period_start <= s1; period_start += m_key.m_total_length)
+    {
+      for (const range_type<float> &R : m_key.m_intervals)
+        {
+          float A, B, a, b, ca, cb;
+
+          A = period_start + R.m_begin;
+          B = period_start + R.m_end;
+
+          /* An interval boundary that lands exactly on the
+           * start of the segment belongs to the segment; one
+           * that lands exactly on its end belongs to the
+           * segment that follows.
+           */
+          if (A >= s1 || B < s0 || (B == s0 && A < B))
+            {
+              continue;
+            }
+
+          a = t_max(A, s0);
+          b = t_min(B, s1);
+          if (b > a)
+            {
+              add_piece(pts, (a - s0) / len, (b - s0) / len);
+            }
+
+          /* caps are added at the ends of a dash, but not
+           * at the start or end of the contour; those are
+           * handled by the caps of StrokedCapsJoins.
+           */
+          ca = a - m_key.m_dash_offset;
+          cb = b - m_key.m_dash_offset;
+          if (m_key.m_cap_style != PainterEnums::flat_caps)
+            {
+              if (A >= s0 && ca > 0.0f)
+                {
+                  StrokedPoint pt(pts[0]);
+                  float t((a - s0) / len);
+
+                  pt.m_position = interpolate(pts[0].m_position, pts[3].m_position, t);
+                  pt.m_distance_from_contour_start = ca;
+                  pt.m_distance_from_edge_start = interpolate(pts[0].m_distance_from_edge_start,
+                                                      pts[3].m_distance_from_edge_start, t);
+                  add_cap(pt, -v);
+                }
+
+              if (B <= s1 && cb < pts[0].m_contour_length)
+                {
+                  StrokedPoint pt(pts[0]);
+                  float t((b - s0) / len);
+
+                  pt.m_position = interpolate(pts[0].m_position, pts[3].m_position, t);
+                  pt.m_distance_from_contour_start = cb;
+                  pt.m_distance_from_edge_start = interpolate(pts[0].m_distance_from_edge_start,
+                                                      pts[3].m_distance_from_edge_start, t);
+                  add_cap(pt, v);
+                }
+            }
+        }
+    }
+}
+
+void
+DashedEdgeFiller::
+add_piece(fastuidraw::c_array<const fastuidraw::StrokedPoint> pts,
+          float t0, float t1)
+{
+  using namespace fastuidraw;
+
+  const PainterIndex tris[12] =
+    {
+      0, 2, 5,
+      0, 5, 3,
+      2, 1, 4,
+      2, 4, 5
+    };
+  vecN<StrokedPoint, 6> dst;
+  vec2 p0, p1;
+  float d0, d1, e0, e1;
+  unsigned int vert_offset(m_attributes.size());
+
+  p0 = interpolate(pts[0].m_position, pts[3].m_position, t0);
+  p1 = interpolate(pts[0].m_position, pts[3].m_position, t1);
+  d0 = interpolate(pts[0].m_distance_from_contour_start, pts[3].m_distance_from_contour_start, t0);
+  d1 = interpolate(pts[0].m_distance_from_contour_start, pts[3].m_distance_from_contour_start, t1);
+  e0 = interpolate(pts[0].m_distance_from_edge_start, pts[3].m_distance_from_edge_start, t0);
+  e1 = interpolate(pts[0].m_distance_from_edge_start, pts[3].m_distance_from_edge_start, t1);
+
+  for (unsigned int k = 0; k < 3; ++k)
+    {
+      dst[k] = pts[k];
+      dst[k].m_position = p0;
+      dst[k].m_distance_from_contour_start = d0;
+      dst[k].m_distance_from_edge_start = e0;
+      dst[k].m_auxiliary_offset = p1 - p0;
+
+      dst[k + 3] = pts[k + 3];
+      dst[k + 3].m_position = p1;
+      dst[k + 3].m_distance_from_contour_start = d1;
+      dst[k + 3].m_distance_from_edge_start = e1;
+      dst[k + 3].m_auxiliary_offset = p0 - p1;
+    }
+
+  for (unsigned int i = 0; i < 6; ++i)
+    {
+      PainterAttribute A;
+
+      dst[i].pack_point(&A);
+      m_attributes.push_back(A);
+    }
+
+  for (unsigned int i = 0; i < 12; ++i)
+    {
+      m_indices.push_back(vert_offset + tris[i]);
+    }
+}
+
+void
+DashedEdgeFiller::
+add_cap(const fastuidraw::StrokedPoint &src,
+        const fastuidraw::vec2 &v)
+{
+  using namespace fastuidraw;
+
+  unsigned int first(m_attributes.size()), depth;
+  StrokedPoint pt(src);
+  PainterAttribute A;
+  vec2 n(-v.y(), v.x());
+
+  depth = unpack_bits(StrokedPoint::depth_bit0, StrokedPoint::depth_num_bits, src.m_packed_data);
+
+  /* Same triangle fans as SquareCapCreator and RoundedCapCreator
+   * of StrokedCapsJoins.
+   */
+  pt.m_pre_offset = vec2(0.0f, 0.0f);
+  pt.m_auxiliary_offset = vec2(0.0f, 0.0f);
+  pt.m_packed_data = pack_data(0, StrokedPoint::offset_shared_with_edge, depth);
+  pt.pack_point(&A);
+  m_attributes.push_back(A);
+
+  pt.m_pre_offset = n;
+  pt.m_auxiliary_offset = vec2(0.0f, 0.0f);
+  pt.m_packed_data = pack_data(1, StrokedPoint::offset_shared_with_edge, depth);
+  pt.pack_point(&A);
+  m_attributes.push_back(A);
+
+  if (m_key.m_cap_style == PainterEnums::square_caps)
+    {
+      pt.m_pre_offset = n;
+      pt.m_auxiliary_offset = v;
+      pt.m_packed_data = pack_data(1, StrokedPoint::offset_square_cap, depth);
+      pt.pack_point(&A);
+      m_attributes.push_back(A);
+
+      pt.m_pre_offset = -n;
+      pt.m_auxiliary_offset = v;
+      pt.m_packed_data = pack_data(1, StrokedPoint::offset_square_cap, depth);
+      pt.pack_point(&A);
+      m_attributes.push_back(A);
+    }
+  else
+    {
+      float theta;
+      unsigned int i;
+
+      for(i = 1, theta = m_delta_theta; i < m_num_arc_points_per_cap - 1; ++i, theta += m_delta_theta)
+        {
+          pt.m_pre_offset = n;
+          pt.m_auxiliary_offset = vec2(t_sin(theta), t_cos(theta));
+          pt.m_packed_data = pack_data(1, StrokedPoint::offset_rounded_cap, depth);
+          pt.pack_point(&A);
+          m_attributes.push_back(A);
+        }
+    }
+
+  pt.m_pre_offset = -n;
+  pt.m_auxiliary_offset = vec2(0.0f, 0.0f);
+  pt.m_packed_data = pack_data(1, StrokedPoint::offset_shared_with_edge, depth);
+  pt.pack_point(&A);
+  m_attributes.push_back(A);
+
+  for (unsigned int i = first + 1, endi = m_attributes.size() - 1; i < endi; ++i)
+    {
+      m_indices.push_back(first);
+      m_indices.push_back(i);
+      m_indices.push_back(i + 1);
+    }
+}
+
+void
+DashedEdgeFiller::
+fill_data(fastuidraw::c_array<fastuidraw::PainterAttribute> attribute_data,
+          fastuidraw::c_array<fastuidraw::PainterIndex> index_data,
+          fastuidraw::c_array<fastuidraw::c_array<const fastuidraw::PainterAttribute> > attribute_chunks,
+          fastuidraw::c_array<fastuidraw::c_array<const fastuidraw::PainterIndex> > index_chunks,
+          fastuidraw::c_array<fastuidraw::range_type<int> > zranges,
+          fastuidraw::c_array<int> index_adjusts) const
+{
+  index_adjusts[0] = 0;
+  zranges[0] = m_zrange;
+  attribute_chunks[0] = attribute_data;
+  index_chunks[0] = index_data;
+
+  std::copy(m_attributes.begin(), m_attributes.end(), attribute_data.begin());
+  std::copy(m_indices.begin(), m_indices.end(), index_data.begin());
+}
+
+//////////////////////////////////////////
+// DashedEdgesPrivate methods
+DashedEdgesPrivate::
+~DashedEdgesPrivate()
+{
+  for (fastuidraw::PainterAttributeData *p : m_data)
+    {
+      if (p)
+        {
+          FASTUIDRAWdelete(p);
+        }
+    }
+}
+
 /////////////////////////////////////////////
 // StrokedPathPrivate methods
 StrokedPathPrivate::
@@ -1980,7 +2627,8 @@ StrokedPathPrivate(const fastuidraw::TessellatedPath &P,
                    const fastuidraw::StrokedCapsJoins::Builder &b):
   m_has_arcs(P.has_arcs()),
   m_caps_joins(b),
-  m_root(nullptr)
+  m_root(nullptr),
+  m_dashed_edges_use_count(0u)
 {
   if (!P.segment_data().empty())
     {
@@ -2109,11 +2757,52 @@ bounding_box(void) const
   return d->bounding_box();
 }
 
+//////////////////////////////////////
+// fastuidraw::StrokedPath::DashedEdges methods
+fastuidraw::StrokedPath::DashedEdges::
+DashedEdges(void *d):
+  m_d(d)
+{}
+
+fastuidraw::StrokedPath::DashedEdges::
+~DashedEdges()
+{
+  DashedEdgesPrivate *d;
+  d = static_cast<DashedEdgesPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+const fastuidraw::PainterAttributeData*
+fastuidraw::StrokedPath::DashedEdges::
+subset_data(unsigned int subset_id) const
+{
+  DashedEdgesPrivate *d;
+  d = static_cast<DashedEdgesPrivate*>(m_d);
+
+  FASTUIDRAWassert(subset_id < d->m_data.size());
+
+  Mutex::Guard m(d->m_mutex);
+  if (!d->m_ready[subset_id])
+    {
+      DashedEdgeFiller filler(d->m_key, d->m_path->subset(subset_id).painter_data());
+
+      if (filler.valid())
+        {
+          d->m_data[subset_id] = FASTUIDRAWnew PainterAttributeData();
+          d->m_data[subset_id]->set_data(filler);
+        }
+      d->m_ready[subset_id] = true;
+    }
+  return d->m_data[subset_id];
+}
+
 //////////////////////////////////////////////////////////////
 // fastuidraw::StrokedPath methods
 fastuidraw::StrokedPath::
 StrokedPath(const fastuidraw::TessellatedPath &P)
 {
+  TraceEvents::Scope trace("StrokedPath", "create");
   StrokedCapsJoins::Builder b;
   StrokedPathPrivate::ready_builder(&P, b);
   m_d = FASTUIDRAWnew StrokedPathPrivate(P, b);
@@ -2242,3 +2931,55 @@ caps_joins(void) const
   d = static_cast<StrokedPathPrivate*>(m_d);
   return d->m_caps_joins;
 }
+
+fastuidraw::reference_counted_ptr<const fastuidraw::StrokedPath::DashedEdges>
+fastuidraw::StrokedPath::
+dashed_edges(c_array<const PainterDashedStrokeParams::DashPatternElement> dash_pattern,
+             float dash_offset, enum PainterEnums::cap_style cp,
+             float thresh) const
+{
+  StrokedPathPrivate *d;
+  d = static_cast<StrokedPathPrivate*>(m_d);
+
+  FASTUIDRAWassert(!d->m_has_arcs);
+
+  DashedEdgeKey key(dash_pattern, dash_offset, cp, thresh);
+  reference_counted_ptr<const DashedEdges> return_value;
+  Mutex::Guard m(d->m_dashed_edges_mutex);
+
+  ++d->m_dashed_edges_use_count;
+  for (const auto &q : d->m_dashed_edges)
+    {
+      if (static_cast<DashedEdgesPrivate*>(q->m_d)->m_key == key)
+        {
+          return_value = q;
+          break;
+        }
+    }
+
+  if (!return_value)
+    {
+      if (d->m_dashed_edges.size() >= max_number_cached_dash_patterns)
+        {
+          std::vector<reference_counted_ptr<const DashedEdges> >::iterator iter;
+
+          /* evicting only drops the reference of the cache,
+           * a caller still holding the entry keeps it alive.
+           */
+          iter = std::min_element(d->m_dashed_edges.begin(), d->m_dashed_edges.end(),
+                                  [](const reference_counted_ptr<const DashedEdges> &a,
+                                     const reference_counted_ptr<const DashedEdges> &b)
+                                  {
+                                    return static_cast<DashedEdgesPrivate*>(a->m_d)->m_last_used
+                                      < static_cast<DashedEdgesPrivate*>(b->m_d)->m_last_used;
+                                  });
+          d->m_dashed_edges.erase(iter);
+        }
+
+      return_value = FASTUIDRAWnew DashedEdges(FASTUIDRAWnew DashedEdgesPrivate(key, this));
+      d->m_dashed_edges.push_back(return_value);
+    }
+
+  static_cast<DashedEdgesPrivate*>(return_value->m_d)->m_last_used = d->m_dashed_edges_use_count;
+  return return_value;
+}
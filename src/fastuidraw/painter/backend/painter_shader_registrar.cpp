@@ -228,6 +228,7 @@ register_shader(const PainterShaderSet &shaders)
   register_shader(shaders.fill_shader());
   register_shader(shaders.glyph_shader());
   register_shader(shaders.blend_shaders());
+  register_shader(shaders.blur_brush_shader());
 }
 
 void
@@ -265,4 +266,5 @@ register_shader(const PainterDashedStrokeShaderSet &p)
       c = static_cast<enum PainterEnums::cap_style>(i);
       register_shader(p.shader(c));
     }
+  register_shader(p.cpu_dash_edge_shader());
 }
@@ -6,6 +6,8 @@ d		:= $(dir)
 
 FASTUIDRAW_SOURCES += $(call filelist, \
 	painter_effect.cpp \
+	painter_blur_brush_shader_data.cpp \
+	painter_effect_blur.cpp \
 	painter_effect_color_modulate.cpp)
 
 # Begin standard footer
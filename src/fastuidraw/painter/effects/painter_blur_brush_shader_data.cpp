@@ -0,0 +1,182 @@
+/*!
+ * \file painter_blur_brush_shader_data.cpp
+ * \brief file painter_blur_brush_shader_data.cpp
+ *
+ * Copyright 2019 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <vector>
+#include <algorithm>
+#include <fastuidraw/util/fastuidraw_memory.hpp>
+#include <fastuidraw/painter/effects/painter_blur_brush_shader_data.hpp>
+#include <private/util_private.hpp>
+
+namespace
+{
+  class PainterBlurBrushShaderDataData:public fastuidraw::PainterCustomBrushShaderData::DataBase
+  {
+  public:
+    PainterBlurBrushShaderDataData(void):
+      m_scale(1.0f, 1.0f),
+      m_translate(0.0f, 0.0f),
+      m_axis(1.0f, 0.0f),
+      m_clamp_min(0.0f, 0.0f),
+      m_clamp_max(0.0f, 0.0f),
+      m_shadow_color(0.0f, 0.0f, 0.0f, 0.0f),
+      m_taps(1, fastuidraw::vec2(0.0f, 1.0f))
+    {}
+
+    virtual
+    fastuidraw::PainterCustomBrushShaderData::DataBase*
+    copy(void) const override
+    {
+      return FASTUIDRAWnew PainterBlurBrushShaderDataData(*this);
+    }
+
+    virtual
+    fastuidraw::c_array<const fastuidraw::reference_counted_ptr<const fastuidraw::Image> >
+    bind_images(void) const override
+    {
+      using namespace fastuidraw;
+      return c_array<const reference_counted_ptr<const Image> >(&m_image, 1);
+    }
+
+    virtual
+    unsigned int
+    data_size(void) const override
+    {
+      using namespace fastuidraw;
+      return PainterBlurBrushShaderData::taps_offset
+        + FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(2u * m_taps.size());
+    }
+
+    virtual
+    void
+    pack_data(fastuidraw::c_array<fastuidraw::generic_data> dst) const override
+    {
+      using namespace fastuidraw;
+
+      uint64_t handle(0u);
+      unsigned int t;
+
+      if (m_image && m_image->type() == Image::bindless_texture2d)
+        {
+          handle = m_image->bindless_handle();
+        }
+
+      dst[PainterBlurBrushShaderData::transformation_scale_x_offset].f = m_scale.x();
+      dst[PainterBlurBrushShaderData::transformation_scale_y_offset].f = m_scale.y();
+      dst[PainterBlurBrushShaderData::transformation_translate_x_offset].f = m_translate.x();
+      dst[PainterBlurBrushShaderData::transformation_translate_y_offset].f = m_translate.y();
+      dst[PainterBlurBrushShaderData::axis_x_offset].f = m_axis.x();
+      dst[PainterBlurBrushShaderData::axis_y_offset].f = m_axis.y();
+      dst[PainterBlurBrushShaderData::image_bindless_handle_low_offset].u = uint32_t(handle & 0xFFFFFFFFu);
+      dst[PainterBlurBrushShaderData::image_bindless_handle_hi_offset].u = uint32_t(handle >> 32u);
+      dst[PainterBlurBrushShaderData::clamp_min_x_offset].f = m_clamp_min.x();
+      dst[PainterBlurBrushShaderData::clamp_min_y_offset].f = m_clamp_min.y();
+      dst[PainterBlurBrushShaderData::clamp_max_x_offset].f = m_clamp_max.x();
+      dst[PainterBlurBrushShaderData::clamp_max_y_offset].f = m_clamp_max.y();
+      dst[PainterBlurBrushShaderData::shadow_color_red_offset].f = m_shadow_color.x();
+      dst[PainterBlurBrushShaderData::shadow_color_green_offset].f = m_shadow_color.y();
+      dst[PainterBlurBrushShaderData::shadow_color_blue_offset].f = m_shadow_color.z();
+      dst[PainterBlurBrushShaderData::shadow_color_alpha_offset].f = m_shadow_color.w();
+      dst[PainterBlurBrushShaderData::number_taps_offset].u = m_taps.size();
+      for (t = PainterBlurBrushShaderData::number_taps_offset + 1;
+           t < PainterBlurBrushShaderData::taps_offset; ++t)
+        {
+          dst[t].u = 0u;
+        }
+
+      t = PainterBlurBrushShaderData::taps_offset;
+      for (const vec2 &tap : m_taps)
+        {
+          dst[t++].f = tap.x();
+          dst[t++].f = tap.y();
+        }
+
+      /* zero the padding so that the shader can read
+       * the taps two at a time.
+       */
+      for (; t < dst.size(); ++t)
+        {
+          dst[t].f = 0.0f;
+        }
+    }
+
+    fastuidraw::reference_counted_ptr<const fastuidraw::Image> m_image;
+    fastuidraw::vec2 m_scale, m_translate, m_axis;
+    fastuidraw::vec2 m_clamp_min, m_clamp_max;
+    fastuidraw::vec4 m_shadow_color;
+    std::vector<fastuidraw::vec2> m_taps;
+  };
+}
+
+#define blur_setget_implement(type, name, member)                      \
+  type                                                                  \
+  fastuidraw::PainterBlurBrushShaderData::                              \
+  name(void) const                                                      \
+  {                                                                     \
+    PainterBlurBrushShaderDataData *d;                                  \
+    FASTUIDRAWassert(dynamic_cast<PainterBlurBrushShaderDataData*>(m_data) != nullptr); \
+    d = static_cast<PainterBlurBrushShaderDataData*>(m_data);          \
+    return d->member;                                                   \
+  }                                                                     \
+  fastuidraw::PainterBlurBrushShaderData&                               \
+  fastuidraw::PainterBlurBrushShaderData::                              \
+  name(type v)                                                          \
+  {                                                                     \
+    PainterBlurBrushShaderDataData *d;                                  \
+    FASTUIDRAWassert(dynamic_cast<PainterBlurBrushShaderDataData*>(m_data) != nullptr); \
+    d = static_cast<PainterBlurBrushShaderDataData*>(m_data);          \
+    d->member = v;                                                      \
+    return *this;                                                       \
+  }
+
+///////////////////////////////////////////////
+// fastuidraw::PainterBlurBrushShaderData methods
+fastuidraw::PainterBlurBrushShaderData::
+PainterBlurBrushShaderData(void)
+{
+  m_data = FASTUIDRAWnew PainterBlurBrushShaderDataData();
+}
+
+blur_setget_implement(const fastuidraw::reference_counted_ptr<const fastuidraw::Image>&, image, m_image)
+blur_setget_implement(const fastuidraw::vec2&, transformation_scale, m_scale)
+blur_setget_implement(const fastuidraw::vec2&, transformation_translate, m_translate)
+blur_setget_implement(const fastuidraw::vec2&, axis, m_axis)
+blur_setget_implement(const fastuidraw::vec2&, clamp_min, m_clamp_min)
+blur_setget_implement(const fastuidraw::vec2&, clamp_max, m_clamp_max)
+blur_setget_implement(const fastuidraw::vec4&, shadow_color, m_shadow_color)
+
+fastuidraw::c_array<const fastuidraw::vec2>
+fastuidraw::PainterBlurBrushShaderData::
+taps(void) const
+{
+  PainterBlurBrushShaderDataData *d;
+  FASTUIDRAWassert(dynamic_cast<PainterBlurBrushShaderDataData*>(m_data) != nullptr);
+  d = static_cast<PainterBlurBrushShaderDataData*>(m_data);
+  return make_c_array(d->m_taps);
+}
+
+fastuidraw::PainterBlurBrushShaderData&
+fastuidraw::PainterBlurBrushShaderData::
+taps(c_array<const vec2> v)
+{
+  PainterBlurBrushShaderDataData *d;
+  FASTUIDRAWassert(dynamic_cast<PainterBlurBrushShaderDataData*>(m_data) != nullptr);
+  d = static_cast<PainterBlurBrushShaderDataData*>(m_data);
+  d->m_taps.resize(v.size());
+  std::copy(v.begin(), v.end(), d->m_taps.begin());
+  return *this;
+}
@@ -17,6 +17,7 @@
  */
 
 #include <fastuidraw/painter/effects/painter_effect.hpp>
+#include <fastuidraw/painter/painter.hpp>
 #include <private/util_private.hpp>
 #include <vector>
 
@@ -29,6 +30,17 @@ namespace
   };
 }
 
+///////////////////////////////////////
+// fastuidraw::PainterEffectPass methods
+void
+fastuidraw::PainterEffectPass::
+draw(Painter &painter,
+     const reference_counted_ptr<const Image> &image,
+     const Rect &brush_rect)
+{
+  painter.fill_rect(PainterData(brush(image, brush_rect)), brush_rect, false);
+}
+
 ///////////////////////////////////////
 // fastuidraw::PainterEffect methods
 fastuidraw::PainterEffect::
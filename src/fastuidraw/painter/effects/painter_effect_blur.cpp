@@ -0,0 +1,482 @@
+/*!
+ * \file painter_effect_blur.cpp
+ * \brief file painter_effect_blur.cpp
+ *
+ * Copyright 2019 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <vector>
+#include <cmath>
+#include <fastuidraw/util/math.hpp>
+#include <fastuidraw/painter/effects/painter_effect_blur.hpp>
+#include <fastuidraw/painter/effects/painter_blur_brush_shader_data.hpp>
+#include <fastuidraw/painter/painter_brush.hpp>
+#include <fastuidraw/painter/painter.hpp>
+#include <private/util_private.hpp>
+
+namespace
+{
+  /* Values shared by the passes of a PainterEffectBlur */
+  class BlurParams:
+    public fastuidraw::reference_counted<BlurParams>::concurrent
+  {
+  public:
+    BlurParams(void):
+      m_sigma(4.0f),
+      m_downsample(0),
+      m_color(1.0f, 1.0f, 1.0f, 1.0f),
+      m_offset(0.0f, 0.0f),
+      m_shadow(false),
+      m_dirty(true)
+    {}
+
+    /* the factor by which resolution is reduced */
+    unsigned int
+    factor(void) const
+    {
+      if (m_downsample != 0)
+        {
+          return m_downsample;
+        }
+
+      /* only downsample once sigma is large enough that
+       * the reduced resolution does not show.
+       */
+      return (m_sigma < 3.0f) ? 1u :
+        (m_sigma < 8.0f) ? 2u : 4u;
+    }
+
+    void
+    update(void);
+
+    float m_sigma;
+    unsigned int m_downsample;
+    fastuidraw::vec4 m_color;
+    fastuidraw::vec2 m_offset;
+    bool m_shadow;
+
+    bool m_dirty;
+    unsigned int m_factor;
+
+    /* taps of both passes in texels of the layer; the
+     * x-coordinate of a tap is its offset along the axis
+     * of the blur and the y-coordinate its weight.
+     */
+    std::vector<fastuidraw::vec2> m_taps;
+  };
+
+  /* A BlurPass sums the taps along one axis and reduces
+   * the resolution only along that axis, so that the blur
+   * of the pass filters the texels the reduction skips.
+   * The horizontal pass reads the region brush_rect and
+   * writes a region reduced in width at the min-corner of
+   * brush_rect; the vertical pass reads that region and
+   * writes a region reduced in both width and height.
+   * The taps are summed by PainterShaderSet::blur_brush_shader()
+   * so that a pass is a single draw.
+   */
+  class BlurPass:public fastuidraw::PainterEffectPass
+  {
+  public:
+    BlurPass(const fastuidraw::reference_counted_ptr<BlurParams> &params,
+             bool horizontal):
+      m_params(params),
+      m_horizontal(horizontal),
+      m_shader(nullptr)
+    {}
+
+    virtual
+    fastuidraw::PainterData::brush_value
+    brush(const fastuidraw::reference_counted_ptr<const fastuidraw::Image> &image,
+          const fastuidraw::Rect &brush_rect) override;
+
+    virtual
+    void
+    draw(fastuidraw::Painter &painter,
+         const fastuidraw::reference_counted_ptr<const fastuidraw::Image> &image,
+         const fastuidraw::Rect &brush_rect) override;
+
+  private:
+    fastuidraw::reference_counted_ptr<BlurParams> m_params;
+    bool m_horizontal;
+
+    /* the blur brush shader of the Painter of the last
+     * call to draw()
+     */
+    const fastuidraw::PainterCustomBrushShader *m_shader;
+    fastuidraw::PainterBlurBrushShaderData m_data;
+  };
+
+  /* The CompositePass scales the reduced resolution result
+   * back to the full region of the layer.
+   */
+  class CompositePass:public fastuidraw::PainterEffectPass
+  {
+  public:
+    explicit
+    CompositePass(const fastuidraw::reference_counted_ptr<BlurParams> &params):
+      m_params(params)
+    {}
+
+    virtual
+    fastuidraw::PainterData::brush_value
+    brush(const fastuidraw::reference_counted_ptr<const fastuidraw::Image> &image,
+          const fastuidraw::Rect &brush_rect) override;
+
+    BlurParams&
+    params(void)
+    {
+      return *m_params;
+    }
+
+  private:
+    fastuidraw::reference_counted_ptr<BlurParams> m_params;
+    fastuidraw::PainterBrush m_brush;
+  };
+
+  void
+  compute_taps(float sigma, std::vector<fastuidraw::vec2> *out_taps)
+  {
+    using namespace fastuidraw;
+
+    std::vector<float> weights;
+    float total(0.0f);
+    int radius;
+
+    out_taps->clear();
+    if (sigma <= 0.0f)
+      {
+        out_taps->push_back(vec2(0.0f, 1.0f));
+        return;
+      }
+
+    radius = static_cast<int>(std::ceil(3.0f * sigma));
+    weights.resize(radius + 2, 0.0f);
+    for (int i = 0; i <= radius; ++i)
+      {
+        weights[i] = std::exp(-0.5f * float(i * i) / (sigma * sigma));
+        total += (i == 0) ? weights[i] : 2.0f * weights[i];
+      }
+
+    /* merge the taps at i and i + 1 into a single tap placed
+     * between them so that linear filtering gives the weighted
+     * sum of the two texels.
+     */
+    out_taps->push_back(vec2(0.0f, weights[0] / total));
+    for (int i = 1; i <= radius; i += 2)
+      {
+        float w, offset;
+
+        w = weights[i] + weights[i + 1];
+        offset = (float(i) * weights[i] + float(i + 1) * weights[i + 1]) / w;
+        out_taps->push_back(vec2(offset, w / total));
+        out_taps->push_back(vec2(-offset, w / total));
+      }
+  }
+
+  fastuidraw::vec2
+  reduced_size(const fastuidraw::Rect &brush_rect, unsigned int factor)
+  {
+    fastuidraw::vec2 sz(brush_rect.size());
+
+    sz.x() = std::ceil(sz.x() / float(factor));
+    sz.y() = std::ceil(sz.y() / float(factor));
+    return sz;
+  }
+
+  /* the size of the region written by the horizontal pass,
+   * reduced in width only.
+   */
+  fastuidraw::vec2
+  reduced_width_size(const fastuidraw::Rect &brush_rect, unsigned int factor)
+  {
+    fastuidraw::vec2 sz(brush_rect.size());
+
+    sz.x() = std::ceil(sz.x() / float(factor));
+    return sz;
+  }
+
+  fastuidraw::float2x2
+  scale_matrix(float sc)
+  {
+    fastuidraw::float2x2 m;
+
+    m(0, 0) = m(1, 1) = sc;
+    m(0, 1) = m(1, 0) = 0.0f;
+    return m;
+  }
+
+  BlurParams&
+  params_of(fastuidraw::c_array<const fastuidraw::reference_counted_ptr<fastuidraw::PainterEffectPass> > p)
+  {
+    FASTUIDRAWassert(p.size() == 3 && p[2].dynamic_cast_ptr<CompositePass>());
+    return static_cast<CompositePass*>(p[2].get())->params();
+  }
+
+  /* Set a clamping repeat window to the named region so that
+   * linear filtering never reads texels outside of it.
+   */
+  void
+  clamp_to_region(fastuidraw::vec2 min_pt, fastuidraw::vec2 size,
+                  fastuidraw::PainterBrush *brush)
+  {
+    using namespace fastuidraw;
+
+    brush->repeat_window(min_pt + vec2(0.5f, 0.5f),
+                         vec2(t_max(size.x() - 1.0f, 0.0f),
+                              t_max(size.y() - 1.0f, 0.0f)),
+                         PainterBrush::spread_clamp,
+                         PainterBrush::spread_clamp);
+  }
+}
+
+//////////////////////////////////////
+// BlurParams methods
+void
+BlurParams::
+update(void)
+{
+  if (!m_dirty)
+    {
+      return;
+    }
+
+  m_factor = factor();
+  compute_taps(m_sigma, &m_taps);
+  m_dirty = false;
+}
+
+//////////////////////////////////////
+// BlurPass methods
+fastuidraw::PainterData::brush_value
+BlurPass::
+brush(const fastuidraw::reference_counted_ptr<const fastuidraw::Image> &image,
+      const fastuidraw::Rect &brush_rect)
+{
+  using namespace fastuidraw;
+
+  vec2 sc, src_size;
+
+  m_params->update();
+  if (m_horizontal)
+    {
+      sc = vec2(float(m_params->m_factor), 1.0f);
+      src_size = brush_rect.size();
+    }
+  else
+    {
+      sc = vec2(1.0f, float(m_params->m_factor));
+      src_size = reduced_width_size(brush_rect, m_params->m_factor);
+    }
+
+  /* a point p in the reduced region reads from the source
+   * at m + sc * (p - m) where m is the min-corner of brush_rect;
+   * the window to which reads are clamped keeps linear filtering
+   * from reading texels outside of the source region.
+   */
+  m_data
+    .image(image)
+    .transformation_scale(sc)
+    .transformation_translate((vec2(1.0f, 1.0f) - sc) * brush_rect.m_min_point)
+    .axis((m_horizontal) ? vec2(1.0f, 0.0f) : vec2(0.0f, 1.0f))
+    .clamp_min(brush_rect.m_min_point + vec2(0.5f, 0.5f))
+    .clamp_max(brush_rect.m_min_point + vec2(t_max(src_size.x() - 0.5f, 0.5f),
+                                              t_max(src_size.y() - 0.5f, 0.5f)))
+    .taps(make_c_array(m_params->m_taps));
+
+  /* with shadow() set, the vertical pass replaces the
+   * color by the color of the shadow keeping the
+   * (blurred) coverage.
+   */
+  if (!m_horizontal && m_params->m_shadow)
+    {
+      m_data.shadow_color(vec4(m_params->m_color.x(), m_params->m_color.y(), m_params->m_color.z(), 1.0f));
+    }
+  else
+    {
+      m_data.shadow_color(vec4(0.0f, 0.0f, 0.0f, 0.0f));
+    }
+
+  return PainterData::brush_value(PainterCustomBrush(m_shader, &m_data));
+}
+
+void
+BlurPass::
+draw(fastuidraw::Painter &painter,
+     const fastuidraw::reference_counted_ptr<const fastuidraw::Image> &image,
+     const fastuidraw::Rect &brush_rect)
+{
+  using namespace fastuidraw;
+
+  PainterData::brush_value br;
+  vec2 dst_size;
+  Rect dst;
+
+  m_shader = painter.default_shaders().blur_brush_shader().get();
+  br = brush(image, brush_rect);
+
+  dst_size = (m_horizontal) ?
+    reduced_width_size(brush_rect, m_params->m_factor) :
+    reduced_size(brush_rect, m_params->m_factor);
+  dst
+    .min_point(brush_rect.m_min_point)
+    .max_point(brush_rect.m_min_point + dst_size);
+
+  /* the taps are all summed by the brush, so a pass
+   * is a single draw that replaces the destination.
+   */
+  painter.blend_shader(Painter::blend_porter_duff_src);
+  painter.fill_rect(PainterData(br), dst, false);
+}
+
+//////////////////////////////////////
+// CompositePass methods
+fastuidraw::PainterData::brush_value
+CompositePass::
+brush(const fastuidraw::reference_counted_ptr<const fastuidraw::Image> &image,
+      const fastuidraw::Rect &brush_rect)
+{
+  using namespace fastuidraw;
+
+  float sc;
+
+  m_params->update();
+  sc = 1.0f / float(m_params->m_factor);
+
+  /* a point p of the layer reads from the reduced region
+   * at m + sc * (p - m - offset).
+   */
+  m_brush
+    .reset()
+    .image(image, PainterBrush::image_filter_linear, PainterBrush::dont_apply_mipmapping)
+    .transformation_matrix(scale_matrix(sc))
+    .transformation_translate((1.0f - sc) * brush_rect.m_min_point - sc * m_params->m_offset);
+  clamp_to_region(brush_rect.m_min_point,
+                  reduced_size(brush_rect, m_params->m_factor),
+                  &m_brush);
+
+  if (m_params->m_shadow)
+    {
+      /* the color was applied by the vertical pass */
+      m_brush.color(1.0f, 1.0f, 1.0f, m_params->m_color.w());
+    }
+  else
+    {
+      m_brush.color(m_params->m_color);
+    }
+
+  return PainterData::brush_value(&m_brush);
+}
+
+////////////////////////////////////////////////
+// fastuidraw::PainterEffectBlur methods
+fastuidraw::PainterEffectBlur::
+PainterEffectBlur(void)
+{
+  reference_counted_ptr<BlurParams> params;
+
+  params = FASTUIDRAWnew BlurParams();
+  add_pass(FASTUIDRAWnew BlurPass(params, true));
+  add_pass(FASTUIDRAWnew BlurPass(params, false));
+  add_pass(FASTUIDRAWnew CompositePass(params));
+}
+
+fastuidraw::reference_counted_ptr<fastuidraw::PainterEffect>
+fastuidraw::PainterEffectBlur::
+copy(void) const
+{
+  PainterEffectBlur *p;
+
+  p = FASTUIDRAWnew PainterEffectBlur();
+  p->sigma(sigma());
+  p->downsample(downsample());
+  p->color(color());
+  p->offset(offset());
+  p->shadow(shadow());
+  return p;
+}
+
+void
+fastuidraw::PainterEffectBlur::
+sigma(float v)
+{
+  BlurParams &P(params_of(passes()));
+  P.m_sigma = v;
+  P.m_dirty = true;
+}
+
+float
+fastuidraw::PainterEffectBlur::
+sigma(void) const
+{
+  return params_of(passes()).m_sigma;
+}
+
+void
+fastuidraw::PainterEffectBlur::
+downsample(unsigned int v)
+{
+  BlurParams &P(params_of(passes()));
+  P.m_downsample = v;
+  P.m_dirty = true;
+}
+
+unsigned int
+fastuidraw::PainterEffectBlur::
+downsample(void) const
+{
+  return params_of(passes()).m_downsample;
+}
+
+void
+fastuidraw::PainterEffectBlur::
+color(const vec4 &v)
+{
+  params_of(passes()).m_color = v;
+}
+
+const fastuidraw::vec4&
+fastuidraw::PainterEffectBlur::
+color(void) const
+{
+  return params_of(passes()).m_color;
+}
+
+void
+fastuidraw::PainterEffectBlur::
+offset(const vec2 &v)
+{
+  params_of(passes()).m_offset = v;
+}
+
+const fastuidraw::vec2&
+fastuidraw::PainterEffectBlur::
+offset(void) const
+{
+  return params_of(passes()).m_offset;
+}
+
+void
+fastuidraw::PainterEffectBlur::
+shadow(bool v)
+{
+  params_of(passes()).m_shadow = v;
+}
+
+bool
+fastuidraw::PainterEffectBlur::
+shadow(void) const
+{
+  return params_of(passes()).m_shadow;
+}
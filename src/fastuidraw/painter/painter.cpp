@@ -18,10 +18,13 @@
 
 
 #include <vector>
+#include <list>
+#include <map>
 #include <bitset>
 #include <algorithm>
 
 #include <fastuidraw/util/math.hpp>
+#include <fastuidraw/util/trace_events.hpp>
 #include <fastuidraw/text/glyph_generate_params.hpp>
 #include <fastuidraw/painter/backend/painter_header.hpp>
 #include <fastuidraw/painter/effects/painter_effect_color_modulate.hpp>
@@ -34,12 +37,14 @@
 #include <private/bounding_box.hpp>
 #include <private/rect_atlas.hpp>
 #include <private/painter_backend/painter_packer.hpp>
+#include <private/painter_backend/painter_timers.hpp>
 
 namespace
 {
   class ZDelayedAction;
   class ZDataCallBack;
   class PainterPrivate;
+  class CachedLayer;
 
   /* A WindingSet is way to cache values from a
    * fastuidraw::CustomFillRuleBase.
@@ -642,7 +647,8 @@ namespace
       m_packer(packer),
       m_surface(surface),
       m_image(image),
-      m_rect_atlas(useable_size)
+      m_rect_atlas(useable_size),
+      m_retained(false)
     {}
 
     /* the PainterPacker used */
@@ -659,6 +665,11 @@ namespace
 
     /* the atlas to track what regions are free */
     fastuidraw::detail::RectAtlas m_rect_atlas;
+
+    /* if true, the EffectsBuffer is owned by a CachedLayer
+     * and is not to be recycled by EffectsLayerFactory::begin()
+     */
+    bool m_retained;
   };
 
   class EffectsLayer
@@ -719,6 +730,16 @@ namespace
           const fastuidraw::Rect &normalized_rect,
           PainterPrivate *d);
 
+    /* creates a EffectsLayer value that renders to the
+     * surface of a CachedLayer, (re)creating the surface
+     * of the CachedLayer as needed.
+     */
+    EffectsLayer
+    fetch_cached(unsigned int depth,
+                 const BufferRect &buffer_rect,
+                 CachedLayer *layer,
+                 PainterPrivate *d);
+
     /* issues PainterPacker::end() in the correct order
      * on all elements that were fetched within the
      * begin/end pair.
@@ -726,6 +747,21 @@ namespace
     void
     end(void);
 
+    fastuidraw::ivec2
+    current_backing_useable_size(void) const
+    {
+      return m_current_backing_useable_size;
+    }
+
+    /* computes the values of an EffectsLayer for a
+     * rect placed at the location rect of the surface
+     */
+    void
+    set_layer_location(const BufferRect &buffer_rect,
+                       fastuidraw::ivec2 rect,
+                       PainterPrivate *d,
+                       EffectsLayer *out_layer) const;
+
   private:
     typedef std::vector<fastuidraw::reference_counted_ptr<EffectsBuffer> > PerActiveDepth;
 
@@ -735,6 +771,96 @@ namespace
     std::vector<PerActiveDepth> m_per_active_depth;
   };
 
+  /* A CachedLayer holds the retained content of a layer
+   * started with Painter::begin_cached_layer().
+   */
+  class CachedLayer:
+    public fastuidraw::reference_counted<CachedLayer>::non_concurrent
+  {
+  public:
+    explicit
+    CachedLayer(uint64_t key):
+      m_key(key),
+      m_content_valid(false),
+      m_last_frame(0),
+      m_content_frame(0)
+    {}
+
+    /* returns true if the retained content can be used
+     * for a layer covering the named pixel rect
+     */
+    bool
+    matches(const BufferRect &buffer_rect,
+            const fastuidraw::float3x3 &transformation,
+            fastuidraw::ivec2 viewport_dims) const;
+
+    uint64_t m_key;
+
+    /* surface, image and PainterPacker to which
+     * the content is rendered
+     */
+    fastuidraw::reference_counted_ptr<EffectsBuffer> m_buffer;
+
+    /* if true, m_buffer holds the content as described
+     * by the values below
+     */
+    bool m_content_valid;
+    fastuidraw::ivec2 m_bl, m_tr, m_viewport_dims;
+    fastuidraw::float3x3 m_transformation;
+
+    /* values needed by EffectsLayer::blit_rect() */
+    fastuidraw::Rect m_normalized_rect;
+    fastuidraw::vec2 m_brush_translate;
+
+    /* the frame in which the layer was last used and
+     * the frame in which the content was last rendered
+     */
+    uint64_t m_last_frame, m_content_frame;
+  };
+
+  /* LRU of CachedLayer values keyed by the content key */
+  class LayerCache
+  {
+  public:
+    LayerCache(void):
+      m_max_entries(16),
+      m_current_frame(0)
+    {}
+
+    /* marks the start of a frame and drops the least
+     * recently used entries beyond m_max_entries.
+     */
+    void
+    begin_frame(void);
+
+    /* fetch (or create) the entry for the named key and
+     * mark it as the most recently used
+     */
+    CachedLayer*
+    fetch(uint64_t key);
+
+    void
+    invalidate(uint64_t key);
+
+    void
+    clear(void)
+    {
+      m_entries.clear();
+      m_lookup.clear();
+    }
+
+    unsigned int m_max_entries;
+    uint64_t m_current_frame;
+
+  private:
+    typedef fastuidraw::reference_counted_ptr<CachedLayer> Entry;
+    typedef std::list<Entry>::iterator iterator;
+
+    /* front is the most recently used */
+    std::list<Entry> m_entries;
+    std::map<uint64_t, iterator> m_lookup;
+  };
+
   class DeferredCoverageBuffer:
     public fastuidraw::reference_counted<DeferredCoverageBuffer>::non_concurrent
   {
@@ -1285,6 +1411,25 @@ namespace
     int m_fuzz_increment_z;
   };
 
+  /* Values for dashed stroking where the edges are split against
+   * the dash pattern on the CPU, see StrokingStyle::m_cpu_dash_segmentation
+   */
+  class CPUDashSegmentation
+  {
+  public:
+    const fastuidraw::PainterStrokeShader *m_edge_shader;
+    fastuidraw::c_array<const fastuidraw::PainterDashedStrokeParams::DashPatternElement> m_dash_pattern;
+    float m_dash_offset;
+    enum fastuidraw::Painter::cap_style m_cap_style;
+
+    /* filled by stroke_path_common(), the data from
+     * StrokedPath::dashed_edges() for each subset; the
+     * data is valid for as long as m_dashed_edges holds it.
+     */
+    fastuidraw::reference_counted_ptr<const fastuidraw::StrokedPath::DashedEdges> m_dashed_edges;
+    fastuidraw::c_array<const fastuidraw::PainterAttributeData* const> m_edge_data;
+  };
+
   class StrokingWorkRoom:fastuidraw::noncopyable
   {
   public:
@@ -1295,6 +1440,7 @@ namespace
     std::vector<int> m_index_adjusts;
     std::vector<const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader>* > m_shaders;
     std::vector<unsigned int> m_subsets;
+    std::vector<const fastuidraw::PainterAttributeData*> m_dashed_edges;
     fastuidraw::StrokedPath::ScratchSpace m_path_scratch;
     fastuidraw::StrokedCapsJoins::ChunkSet m_caps_joins_chunk_set;
     fastuidraw::StrokedCapsJoins::ScratchSpace m_caps_joins_scratch;
@@ -1329,6 +1475,106 @@ namespace
     std::vector<unsigned int> m_subsets;
   };
 
+  /* The key of a ClipPathCache entry; the values are exactly
+   * those that determine the output of fill_path_compute_opaque_chunks().
+   */
+  class ClipPathKey
+  {
+  public:
+    ClipPathKey(void):
+      m_path(nullptr),
+      m_fill_rule(0)
+    {}
+
+    void
+    set(const fastuidraw::FilledPath &path,
+        enum fastuidraw::Painter::fill_rule_t fill_rule,
+        const fastuidraw::float3x3 &item_matrix,
+        fastuidraw::c_array<const fastuidraw::vec3> clip)
+    {
+      m_path = &path;
+      m_fill_rule = fill_rule;
+      m_item_matrix = item_matrix.raw_data();
+      m_clip.assign(clip.begin(), clip.end());
+    }
+
+    bool
+    operator<(const ClipPathKey &rhs) const
+    {
+      if (m_path != rhs.m_path)
+        {
+          return m_path < rhs.m_path;
+        }
+      if (m_fill_rule != rhs.m_fill_rule)
+        {
+          return m_fill_rule < rhs.m_fill_rule;
+        }
+      if (m_item_matrix != rhs.m_item_matrix)
+        {
+          return m_item_matrix < rhs.m_item_matrix;
+        }
+      return m_clip < rhs.m_clip;
+    }
+
+    const fastuidraw::FilledPath *m_path;
+    int m_fill_rule;
+    fastuidraw::vecN<float, 9> m_item_matrix;
+    std::vector<fastuidraw::vec3> m_clip;
+  };
+
+  /* A CachedClipPath holds the chunks of a FilledPath that
+   * are drawn to realize the occluder of a clip_out_path();
+   * it also holds the reference to the FilledPath given by
+   * the caller because the chunks point into its data.
+   */
+  class CachedClipPath:
+    public fastuidraw::reference_counted<CachedClipPath>::non_concurrent
+  {
+  public:
+    ClipPathKey m_key;
+    fastuidraw::reference_counted_ptr<const fastuidraw::FilledPath> m_path;
+    OpaqueFillWorkRoom m_chunks;
+  };
+
+  /* LRU of CachedClipPath values, keyed by ClipPathKey */
+  class ClipPathCache
+  {
+  public:
+    ClipPathCache(void):
+      m_max_entries(64)
+    {}
+
+    /* drops the least recently used entries
+     * beyond m_max_entries.
+     */
+    void
+    begin_frame(void);
+
+    /* fetch (or create) the entry for the named key and
+     * mark it as the most recently used; a created
+     * entry has its m_path as nullptr.
+     */
+    CachedClipPath*
+    fetch(const ClipPathKey &key);
+
+    void
+    clear(void)
+    {
+      m_lookup.clear();
+      m_entries.clear();
+    }
+
+    unsigned int m_max_entries;
+
+  private:
+    typedef fastuidraw::reference_counted_ptr<CachedClipPath> Entry;
+    typedef std::list<Entry>::iterator iterator;
+
+    /* front is the most recently used */
+    std::list<Entry> m_entries;
+    std::map<ClipPathKey, iterator> m_lookup;
+  };
+
   class GlyphSequenceWorkRoom:fastuidraw::noncopyable
   {
   public:
@@ -1424,6 +1670,16 @@ namespace
                                 float additional_pixel_slack,
                                 float additional_logical_slack);
 
+    /* implements Painter::begin_layer() and Painter::begin_cached_layer();
+     * if cached_layer is non-null, the innermost layer renders to, or
+     * takes its content from, cached_layer. Returns false exactly when
+     * the retained content of cached_layer is used.
+     */
+    bool
+    begin_layer(fastuidraw::Painter *p,
+                fastuidraw::c_array<const fastuidraw::reference_counted_ptr<fastuidraw::PainterEffectPass> > passes,
+                CachedLayer *cached_layer);
+
     void
     begin_coverage_buffer(void);
 
@@ -1464,6 +1720,14 @@ namespace
                  const fastuidraw::PainterAttributeWriter &src,
                  int z);
 
+    /* returns true if the draw is to go to the opaque stream
+     * of the PainterPacker, in which case z is incremented to
+     * be greater than the z of any draw so far
+     */
+    bool
+    route_opaque(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+                 const fastuidraw::PainterData &draw, int *z);
+
     void
     draw_generic_z_layered(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
                            const fastuidraw::PainterData &draw,
@@ -1494,7 +1758,8 @@ namespace
                     fastuidraw::c_array<const unsigned int> cap_chunks,
                     const fastuidraw::PainterAttributeData* join_data,
                     fastuidraw::c_array<const unsigned int> join_chunks,
-                    bool apply_anti_aliasing);
+                    bool apply_anti_aliasing,
+                    const CPUDashSegmentation *cpu_dash = nullptr);
 
     void
     stroke_path_common(const fastuidraw::PainterStrokeShader &shader,
@@ -1502,7 +1767,8 @@ namespace
                        const fastuidraw::StrokedPath &path, float thresh,
                        enum fastuidraw::Painter::cap_style cp,
                        enum fastuidraw::Painter::join_style js,
-                       bool apply_anti_aliasing);
+                       bool apply_anti_aliasing,
+                       CPUDashSegmentation *cpu_dash = nullptr);
 
     fastuidraw::BoundingBox<float>
     compute_bounding_box_of_path(const fastuidraw::StrokedPath &stroked_path,
@@ -1532,14 +1798,6 @@ namespace
                          const AntiAliasFillWorkRoom &data,
                          int z);
 
-    void
-    draw_anti_alias_fuzz(const fastuidraw::PainterFillShader &shader,
-                         const fastuidraw::PainterData &draw,
-                         const AntiAliasFillWorkRoom &data)
-    {
-      draw_anti_alias_fuzz(shader, draw, data, m_current_z);
-    }
-
     template<typename T>
     void
     fill_path(const fastuidraw::PainterFillShader &shader,
@@ -1554,6 +1812,24 @@ namespace
                                     FillSubsetWorkRoom &workroom,
                                     OpaqueFillWorkRoom *output);
 
+    /* Draws the occluder of clip_out_path() without anti-aliasing.
+     * If cache_handle is non-null, it must own filled_path and
+     * m_clip_path_cache is used (and filled) for the chunks to draw;
+     * the cache entry holds cache_handle to keep the FilledPath alive.
+     */
+    void
+    fill_clip_occluder(const fastuidraw::FilledPath &filled_path,
+                       const fastuidraw::reference_counted_ptr<const fastuidraw::FilledPath> &cache_handle,
+                       enum fastuidraw::Painter::fill_rule_t fill_rule);
+
+    /* Implements Painter::clip_out_path(const FilledPath&, enum fill_rule_t),
+     * passing cache_handle to fill_clip_occluder().
+     */
+    void
+    clip_out_filled_path(const fastuidraw::FilledPath &filled_path,
+                         const fastuidraw::reference_counted_ptr<const fastuidraw::FilledPath> &cache_handle,
+                         enum fastuidraw::Painter::fill_rule_t fill_rule);
+
     void
     fill_path_compute_opaque_chunks(const fastuidraw::FilledPath &filled_path,
                                     const fastuidraw::CustomFillRuleBase &fill_rule,
@@ -1715,6 +1991,9 @@ namespace
     const fastuidraw::FilledPath&
     select_filled_path(const fastuidraw::Path &path);
 
+    const fastuidraw::reference_counted_ptr<const fastuidraw::FilledPath>&
+    select_filled_path_handle(const fastuidraw::Path &path);
+
     fastuidraw::PainterPacker*
     packer(void)
     {
@@ -1747,6 +2026,7 @@ namespace
     fastuidraw::reference_counted_ptr<fastuidraw::PainterPacker> m_root_packer;
     fastuidraw::PainterPackedValue<fastuidraw::PainterItemMatrix> m_root_identity_matrix;
     fastuidraw::vecN<unsigned int, fastuidraw::PainterPacker::num_stats> m_stats;
+    fastuidraw::detail::PainterTimers m_timers;
     fastuidraw::PainterSurface::Viewport m_viewport;
     fastuidraw::vec2 m_viewport_dimensions;
     fastuidraw::vec2 m_one_pixel_width;
@@ -1756,6 +2036,10 @@ namespace
     std::vector<occluder_stack_entry> m_occluder_stack;
     std::vector<state_stack_entry> m_state_stack;
     EffectsLayerFactory m_effects_layer_factory;
+    LayerCache m_layer_cache;
+    ClipPathCache m_clip_path_cache;
+    bool m_front_to_back_opaque;
+    ClipPathKey m_clip_path_key;
     std::vector<EffectsLayer> m_effects_layer_stack;
     std::vector<EffectsStackEntry> m_effects_stack;
     DeferredCoverageBufferStackEntryFactory m_deferred_coverage_stack_entry_factory;
@@ -1852,11 +2136,16 @@ DefaultGlyphRendererChooser(void)
   /* Somewhat guessing:
    *  - using distance field up to a factor 3/8 zoom out still looks ok
    *  - using distance field up to a factor 2.0 zoom in still looks ok
+   *  - a multi-channel distance field keeps the corners sharp and
+   *    still looks ok up to a factor 4.0 zoom in; it covers the
+   *    same range as the distance field with a quarter of the
+   *    texels and is much cheaper to render than the rays glyphs.
    */
-  float distance_field_size;
+  float distance_field_size, multi_channel_distance_field_size;
   distance_field_size = fastuidraw::GlyphGenerateParams::distance_field_pixel_size();
+  multi_channel_distance_field_size = fastuidraw::GlyphGenerateParams::multi_channel_distance_field_pixel_size();
   m_coverage_text_cut_off = (distance_field_size * 3.0f) / 8.0f;
-  m_distance_text_cut_off = 2.0f * distance_field_size;
+  m_distance_text_cut_off = 4.0f * multi_channel_distance_field_size;
 }
 
 
@@ -1881,7 +2170,7 @@ choose_glyph_render(float logical_pixel_size,
     }
   else if (effective_pixel_width <= m_distance_text_cut_off)
     {
-      return fastuidraw::GlyphRenderer(fastuidraw::distance_field_glyph);
+      return fastuidraw::GlyphRenderer(fastuidraw::multi_channel_distance_field_glyph);
     }
   else
     {
@@ -2378,9 +2667,7 @@ blit_rect(const fastuidraw::reference_counted_ptr<fastuidraw::PainterEffectPass>
   p->transformation(float_orthogonal_projection_params(0, dims.x(), 0, dims.y()));
   p->translate(-m_brush_translate);
 
-  p->fill_rect(PainterData(fx_pass->brush(m_image, brush_rect)),
-               brush_rect,
-               false);
+  fx_pass->draw(*p, m_image, brush_rect);
 
   p->restore();
 }
@@ -2424,8 +2711,11 @@ begin(fastuidraw::PainterSurface &surface)
         {
           for (const auto &r : v)
             {
-              r->m_rect_atlas.clear(m_current_backing_useable_size);
-              m_unused_buffers.push_back(r);
+              if (!r->m_retained)
+                {
+                  r->m_rect_atlas.clear(m_current_backing_useable_size);
+                  m_unused_buffers.push_back(r);
+                }
             }
           v.clear();
         }
@@ -2470,7 +2760,7 @@ fetch(unsigned int effects_depth,
           reference_counted_ptr<PainterSurface> surface;
           reference_counted_ptr<const Image> image;
 
-          packer = FASTUIDRAWnew PainterPacker(d->m_pool, d->m_stats, d->m_backend);
+          packer = FASTUIDRAWnew PainterPacker(d->m_pool, d->m_stats, d->m_timers, d->m_backend);
           surface = d->m_backend_factory->create_surface(m_current_backing_size,
                                                          PainterSurface::color_buffer_type);
           surface->clear_color(vec4(0.0f, 0.0f, 0.0f, 0.0f));
@@ -2499,6 +2789,70 @@ fetch(unsigned int effects_depth,
   FASTUIDRAWassert(return_value.m_packer);
   FASTUIDRAWassert(rect.x() >= 0 && rect.y() >= 0);
 
+  set_layer_location(buffer_rect, rect, d, &return_value);
+  return return_value;
+}
+
+EffectsLayer
+EffectsLayerFactory::
+fetch_cached(unsigned int effects_depth,
+             const BufferRect &buffer_rect,
+             CachedLayer *layer,
+             PainterPrivate *d)
+{
+  using namespace fastuidraw;
+
+  EffectsLayer return_value;
+  reference_counted_ptr<EffectsBuffer> &TB(layer->m_buffer);
+
+  /* The surface of a CachedLayer is sized to the layer
+   * and the layer is always placed at its corner.
+   */
+  if (!TB || TB->m_surface->dimensions() != buffer_rect.m_dims)
+    {
+      reference_counted_ptr<PainterPacker> packer;
+      reference_counted_ptr<PainterSurface> surface;
+      reference_counted_ptr<const Image> image;
+
+      packer = FASTUIDRAWnew PainterPacker(d->m_pool, d->m_stats, d->m_timers, d->m_backend);
+      surface = d->m_backend_factory->create_surface(buffer_rect.m_dims,
+                                                     PainterSurface::color_buffer_type);
+      surface->clear_color(vec4(0.0f, 0.0f, 0.0f, 0.0f));
+      image = surface->image(d->m_backend_factory->image_atlas());
+      TB = FASTUIDRAWnew EffectsBuffer(packer, surface, image, buffer_rect.m_dims);
+      TB->m_retained = true;
+    }
+
+  if (effects_depth >= m_per_active_depth.size())
+    {
+      m_per_active_depth.resize(effects_depth + 1);
+    }
+
+  ++d->m_stats[Painter::num_render_targets];
+  TB->m_depth = effects_depth;
+  TB->m_surface->viewport(m_effects_buffer_viewport);
+  m_per_active_depth[effects_depth].push_back(TB);
+  d->m_active_surfaces.push_back(TB->m_surface.get());
+
+  return_value.m_image = TB->m_image.get();
+  return_value.m_packer = TB->m_packer.get();
+  return_value.m_packer->begin(d->m_number_external_textures, TB->m_surface, true);
+  set_layer_location(buffer_rect, ivec2(0, 0), d, &return_value);
+
+  return return_value;
+}
+
+void
+EffectsLayerFactory::
+set_layer_location(const BufferRect &buffer_rect,
+                   fastuidraw::ivec2 rect,
+                   PainterPrivate *d,
+                   EffectsLayer *out_layer) const
+{
+  using namespace fastuidraw;
+
+  EffectsLayer &return_value(*out_layer);
+
   return_value.m_normalized_rect = buffer_rect.m_normalized_rect;
   return_value.m_pixel_rect
     .min_point(buffer_rect.m_bl)
@@ -2526,8 +2880,115 @@ fetch(unsigned int effects_depth,
   PainterItemMatrix M;
   M.m_normalized_translate = return_value.m_normalized_translate;
   return_value.m_identity_matrix = d->m_pool.create_packed_value(M);
+}
 
-  return return_value;
+/////////////////////////////////////
+// CachedLayer methods
+bool
+CachedLayer::
+matches(const BufferRect &buffer_rect,
+        const fastuidraw::float3x3 &transformation,
+        fastuidraw::ivec2 viewport_dims) const
+{
+  if (!m_content_valid
+      || m_bl != buffer_rect.m_bl
+      || m_tr != buffer_rect.m_tr
+      || m_viewport_dims != viewport_dims)
+    {
+      return false;
+    }
+
+  for (unsigned int i = 0; i < 3; ++i)
+    {
+      for (unsigned int j = 0; j < 3; ++j)
+        {
+          if (m_transformation(i, j) != transformation(i, j))
+            {
+              return false;
+            }
+        }
+    }
+  return true;
+}
+
+/////////////////////////////////////
+// LayerCache methods
+void
+LayerCache::
+begin_frame(void)
+{
+  ++m_current_frame;
+  while (m_entries.size() > m_max_entries)
+    {
+      m_lookup.erase(m_entries.back()->m_key);
+      m_entries.pop_back();
+    }
+}
+
+CachedLayer*
+LayerCache::
+fetch(uint64_t key)
+{
+  std::map<uint64_t, iterator>::iterator iter;
+
+  iter = m_lookup.find(key);
+  if (iter != m_lookup.end())
+    {
+      m_entries.splice(m_entries.begin(), m_entries, iter->second);
+    }
+  else
+    {
+      m_entries.push_front(FASTUIDRAWnew CachedLayer(key));
+      m_lookup[key] = m_entries.begin();
+    }
+  return m_entries.front().get();
+}
+
+void
+LayerCache::
+invalidate(uint64_t key)
+{
+  std::map<uint64_t, iterator>::iterator iter;
+
+  iter = m_lookup.find(key);
+  if (iter != m_lookup.end())
+    {
+      m_entries.erase(iter->second);
+      m_lookup.erase(iter);
+    }
+}
+
+/////////////////////////////////
+// ClipPathCache methods
+void
+ClipPathCache::
+begin_frame(void)
+{
+  while (m_entries.size() > m_max_entries)
+    {
+      m_lookup.erase(m_entries.back()->m_key);
+      m_entries.pop_back();
+    }
+}
+
+CachedClipPath*
+ClipPathCache::
+fetch(const ClipPathKey &key)
+{
+  std::map<ClipPathKey, iterator>::iterator iter;
+
+  iter = m_lookup.find(key);
+  if (iter != m_lookup.end())
+    {
+      m_entries.splice(m_entries.begin(), m_entries, iter->second);
+    }
+  else
+    {
+      m_entries.push_front(FASTUIDRAWnew CachedClipPath());
+      m_entries.front()->m_key = key;
+      m_lookup[key] = m_entries.begin();
+    }
+  return m_entries.front().get();
 }
 
 void
@@ -2653,7 +3114,7 @@ fetch(const fastuidraw::Rect &normalized_rect, PainterPrivate *d)
           reference_counted_ptr<PainterPacker> packer;
           reference_counted_ptr<PainterSurface> surface;
 
-          packer = FASTUIDRAWnew PainterPacker(d->m_pool, d->m_stats, d->m_backend);
+          packer = FASTUIDRAWnew PainterPacker(d->m_pool, d->m_stats, d->m_timers, d->m_backend);
           surface = d->m_backend_factory->create_surface(m_current_backing_size,
                                                          PainterSurface::deferred_coverage_buffer_type);
           surface->clear_color(vec4(0.0f, 0.0f, 0.0f, 0.0f));
@@ -2706,6 +3167,7 @@ PainterPrivate(const fastuidraw::reference_counted_ptr<fastuidraw::PainterEngine
   m_viewport_dimensions(1.0f, 1.0f),
   m_one_pixel_width(1.0f, 1.0f),
   m_curve_flatness(0.5f),
+  m_front_to_back_opaque(false),
   m_number_external_textures(0),
   m_backend_factory(backend_factory),
   m_backend(backend_factory->create_backend()),
@@ -2719,7 +3181,7 @@ PainterPrivate(const fastuidraw::reference_counted_ptr<fastuidraw::PainterEngine
   // the shaders as well.
   m_default_shaders = m_backend_factory->default_shaders();
   m_color_modulate_fx = FASTUIDRAWnew fastuidraw::PainterEffectColorModulate();
-  m_root_packer = FASTUIDRAWnew fastuidraw::PainterPacker(m_pool, m_stats, m_backend);
+  m_root_packer = FASTUIDRAWnew fastuidraw::PainterPacker(m_pool, m_stats, m_timers, m_backend);
   m_reset_brush = m_pool.create_packed_value(fastuidraw::PainterBrush());
   m_black_brush = m_pool.create_packed_value(fastuidraw::PainterBrush()
                                              .color(0.0f, 0.0f, 0.0f, 0.0f));
@@ -2930,42 +3392,212 @@ begin_coverage_buffer_normalized_rect(const fastuidraw::Rect &normalized_rect,
   ++m_stats[fastuidraw::Painter::num_deferred_coverages];
 }
 
-void
+bool
 PainterPrivate::
-begin_coverage_buffer(void)
+begin_layer(fastuidraw::Painter *p,
+            fastuidraw::c_array<const fastuidraw::reference_counted_ptr<fastuidraw::PainterEffectPass> > passes,
+            CachedLayer *cached_layer)
 {
-  bool non_empty;
+  using namespace fastuidraw;
 
-  non_empty = !m_clip_rect_state.m_all_content_culled
-    && !m_clip_store.current_poly().empty()
-    && !m_clip_store.current_bb().empty();
-  begin_coverage_buffer_normalized_rect(m_clip_store.current_bb().as_rect(), non_empty);
-}
+  Rect clip_region_rect;
+  bool non_empty, use_retained(false);
 
-void
-PainterPrivate::
-end_coverage_buffer(void)
-{
-  FASTUIDRAWassert(!m_deferred_coverage_stack.empty());
-  FASTUIDRAWassert(m_state_stack.empty() || m_state_stack.back().m_deferred_coverage_buffer_depth < m_deferred_coverage_stack.size());
+  non_empty = p->clip_region_bounds(&clip_region_rect.m_min_point,
+                                    &clip_region_rect.m_max_point);
 
-  m_deferred_coverage_stack.pop_back();
-  if (!m_deferred_coverage_stack.empty() && m_deferred_coverage_stack.back().packer())
+  BufferRect buffer_rect(clip_region_rect,
+                         m_effects_layer_factory.current_backing_useable_size(),
+                         this);
+
+  if (cached_layer)
     {
-      m_deferred_coverage_stack.back().update_coverage_buffer_offset(this);
-      m_clip_rect_state.coverage_buffer_normalized_translate(m_deferred_coverage_stack.back().normalized_translate());
-    }
-}
+      uint64_t frame(m_layer_cache.m_current_frame);
+      bool matches;
 
-float
-PainterPrivate::
-compute_magnification(const fastuidraw::Path &path)
-{
-  fastuidraw::Rect R;
+      matches = cached_layer->matches(buffer_rect, m_clip_rect_state.item_matrix(),
+                                      m_viewport.m_dimensions);
+      if (!non_empty || buffer_rect.m_dims.x() <= 0 || buffer_rect.m_dims.y() <= 0)
+        {
+          /* nothing to retain */
+          cached_layer = nullptr;
+        }
+      else if (cached_layer->m_last_frame == frame)
+        {
+          /* The layer was already used in this frame; the retained
+           * content can only be used again if it was not rendered in
+           * this frame (because the order in which layers are ended
+           * would not guarantee it is ready) and it cannot be
+           * re-rendered because an earlier blit of this frame
+           * reads from it. When neither holds, fall back to
+           * an uncached layer.
+           */
+          use_retained = matches && cached_layer->m_content_frame != frame;
+          if (!use_retained)
+            {
+              cached_layer = nullptr;
+            }
+        }
+      else
+        {
+          use_retained = matches;
+        }
 
-  /* TODO: for stroking, it might be that although the
-   * original path is completely clipped, the stroke of
-   * is not. It might be wise to inflate the geometry
+      if (cached_layer)
+        {
+          cached_layer->m_last_frame = frame;
+        }
+    }
+
+  /* This save() is to save the current clipping state because it
+   * will get set to just clip the rect giving by clip_region_rect
+   */
+  p->save();
+
+  EffectsStackEntry fx_entry;
+
+  fx_entry.m_effects_layer_stack_size = m_effects_layer_stack.size();
+  fx_entry.m_state_stack_size = m_state_stack.size();;
+  m_effects_stack.push_back(fx_entry);
+
+  fastuidraw::PainterBlendShader* old_blend(packer()->blend_shader());
+  fastuidraw::PainterBlendShader* copy_blend(m_default_shaders.blend_shaders().shader(Painter::blend_porter_duff_src).get());
+  BlendMode old_blend_mode(packer()->blend_mode());
+  BlendMode copy_blend_mode(m_default_shaders.blend_shaders().blend_mode(Painter::blend_porter_duff_src));
+
+  for (auto ibegin = passes.rbegin(), iend = passes.rend(), i = ibegin;
+       i != iend; ++i)
+    {
+      /* get the EffectsLayer that gives the PainterPacker and what to blit
+       * when the layer is done
+       */
+      EffectsLayer R;
+      bool innermost_cached(cached_layer && i + 1 == iend);
+
+      if (!innermost_cached)
+        {
+          R = m_effects_layer_factory.fetch(m_effects_layer_stack.size(), clip_region_rect, this);
+        }
+      else if (use_retained)
+        {
+          R.m_image = cached_layer->m_buffer->m_image.get();
+          R.m_normalized_rect = cached_layer->m_normalized_rect;
+          R.m_brush_translate = cached_layer->m_brush_translate;
+        }
+      else
+        {
+          R = m_effects_layer_factory.fetch_cached(m_effects_layer_stack.size(), buffer_rect, cached_layer, this);
+          cached_layer->m_content_valid = true;
+          cached_layer->m_content_frame = m_layer_cache.m_current_frame;
+          cached_layer->m_bl = buffer_rect.m_bl;
+          cached_layer->m_tr = buffer_rect.m_tr;
+          cached_layer->m_viewport_dims = m_viewport.m_dimensions;
+          cached_layer->m_transformation = m_clip_rect_state.item_matrix();
+          cached_layer->m_normalized_rect = R.m_normalized_rect;
+          cached_layer->m_brush_translate = R.m_brush_translate;
+        }
+
+      /* Set the blend mode to copy for those rects that fed to the next
+       * effect; the last blit has the blend mode set to what it was before.
+       */
+      if (i != ibegin)
+        {
+          packer()->blend_shader(copy_blend, copy_blend_mode);
+        }
+      else
+        {
+          packer()->blend_shader(old_blend, old_blend_mode);
+        }
+
+      /* We *add* the command to the current packer() to blit the rect of R
+       * now. Recall that the PainterPacker used for the layer will have its
+       * commands executed before the current packer(), regardless in what
+       * order we add them.
+       */
+      R.blit_rect(*i, m_viewport_dimensions, p);
+
+      /* the retained content is blitted, there is no layer to render to */
+      if (innermost_cached && use_retained)
+        {
+          break;
+        }
+
+      /* after issuing the blit command, then add R to m_effects_layer_stack */
+      m_effects_layer_stack.push_back(R);
+      ++m_stats[Painter::num_layers];
+
+      /* Set the clipping equations to the equations coming from clip_region_rect */
+      m_clip_rect_state.m_clip_rect = clip_rect(clip_region_rect);
+      m_clip_rect_state.set_clip_equations_to_clip_rect(ClipRectState::rect_in_normalized_device_coordinates);
+
+      /* update m_clip_rect_state.m_clip_rect to local coordinates */
+      m_clip_rect_state.update_rect_to_transformation();
+
+      /* change m_clip_store so that the current value is just from clip_region_rect */
+      m_clip_store.reset_current_to_rect(clip_region_rect);
+
+      /* set the normalized translation of m_clip_rect_state */
+      m_clip_rect_state.set_normalized_device_translate(m_effects_layer_stack.back().m_normalized_translate);
+
+      if (!m_deferred_coverage_stack.empty()
+          && m_deferred_coverage_stack.back().packer())
+        {
+          m_deferred_coverage_stack.back().update_coverage_buffer_offset(this);
+        }
+    }
+
+  if (use_retained)
+    {
+      /* cull whatever is drawn until the matching end_layer() */
+      m_clip_rect_state.m_all_content_culled = true;
+      ++m_stats[Painter::num_cached_layer_hits];
+    }
+
+  /* Set the packer's blend shader, mode and blend shader to
+   * Painter default values
+   */
+  p->blend_shader(Painter::blend_porter_duff_src_over);
+  p->save();
+
+  return !use_retained;
+}
+
+void
+PainterPrivate::
+begin_coverage_buffer(void)
+{
+  bool non_empty;
+
+  non_empty = !m_clip_rect_state.m_all_content_culled
+    && !m_clip_store.current_poly().empty()
+    && !m_clip_store.current_bb().empty();
+  begin_coverage_buffer_normalized_rect(m_clip_store.current_bb().as_rect(), non_empty);
+}
+
+void
+PainterPrivate::
+end_coverage_buffer(void)
+{
+  FASTUIDRAWassert(!m_deferred_coverage_stack.empty());
+  FASTUIDRAWassert(m_state_stack.empty() || m_state_stack.back().m_deferred_coverage_buffer_depth < m_deferred_coverage_stack.size());
+
+  m_deferred_coverage_stack.pop_back();
+  if (!m_deferred_coverage_stack.empty() && m_deferred_coverage_stack.back().packer())
+    {
+      m_deferred_coverage_stack.back().update_coverage_buffer_offset(this);
+      m_clip_rect_state.coverage_buffer_normalized_translate(m_deferred_coverage_stack.back().normalized_translate());
+    }
+}
+
+float
+PainterPrivate::
+compute_magnification(const fastuidraw::Path &path)
+{
+  fastuidraw::Rect R;
+
+  /* TODO: for stroking, it might be that although the
+   * original path is completely clipped, the stroke of
+   * is not. It might be wise to inflate the geometry
    * of the path by how much slack the stroking parameters
    * require.
    */
@@ -3166,6 +3798,7 @@ select_stroked_path(const fastuidraw::Path &path,
 {
   using namespace fastuidraw;
 
+  TraceEvents::Scope trace("Painter", "select_stroked_path");
   float t;
   const PainterShaderData::DataBase *data(draw.m_item_shader_data.data().data_base());
   const reference_counted_ptr<const StrokingDataSelectorBase> &selector(shader.stroking_data_selector());
@@ -3191,6 +3824,7 @@ select_stroked_path(const fastuidraw::Path &path,
   tess = path.tessellation(t).get();
 
   if (stroking_method != Painter::stroking_method_arc
+      || !*stroke_shader(shader, true, apply_anti_aliasing)
       || !shader.stroking_data_selector()->arc_stroking_possible(data))
     {
       tess = tess->linearization(t);
@@ -3220,6 +3854,7 @@ select_subsets(const fastuidraw::FilledPath &path,
       return 0u;
     }
 
+  fastuidraw::detail::PainterScopedTimer timer(m_timers, fastuidraw::PainterEnums::time_select_subsets_us);
   return path.select_subsets(m_work_room.m_fill_subset.m_scratch,
                              m_clip_store.current(),
                              m_clip_rect_state.item_matrix(),
@@ -3241,6 +3876,7 @@ select_subsets(const fastuidraw::StrokedPath &path,
     }
 
   FASTUIDRAWassert(dst.size() >= path.number_subsets());
+  fastuidraw::detail::PainterScopedTimer timer(m_timers, fastuidraw::PainterEnums::time_select_subsets_us);
   return path.select_subsets(m_work_room.m_stroke.m_path_scratch,
                              m_clip_store.current(),
                              m_clip_rect_state.item_matrix(),
@@ -3266,6 +3902,7 @@ select_chunks(const fastuidraw::StrokedCapsJoins &caps_joins,
       return;
     }
 
+  fastuidraw::detail::PainterScopedTimer timer(m_timers, fastuidraw::PainterEnums::time_select_subsets_us);
   caps_joins.compute_chunks(m_work_room.m_stroke.m_caps_joins_scratch,
                             m_clip_store.current(),
                             m_clip_rect_state.item_matrix(),
@@ -3278,12 +3915,20 @@ select_chunks(const fastuidraw::StrokedCapsJoins &caps_joins,
 const fastuidraw::FilledPath&
 PainterPrivate::
 select_filled_path(const fastuidraw::Path &path)
+{
+  return *select_filled_path_handle(path);
+}
+
+const fastuidraw::reference_counted_ptr<const fastuidraw::FilledPath>&
+PainterPrivate::
+select_filled_path_handle(const fastuidraw::Path &path)
 {
   using namespace fastuidraw;
+  TraceEvents::Scope trace("Painter", "select_filled_path");
   float thresh;
 
   thresh = compute_path_thresh(path);
-  return *path.tessellation(thresh)->filled(thresh);
+  return path.tessellation(thresh)->filled(thresh);
 }
 
 void
@@ -3328,9 +3973,18 @@ draw_generic(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShad
       FASTUIDRAWassert(p.m_brush_adjust.m_packed_value);
     }
 
-  packer()->draw_generic(coverage_buffer_offset, shader, p,
-                         attrib_chunks, index_chunks, index_adjusts,
-                         attrib_chunk_selector, z);
+  if (route_opaque(shader, draw, &z))
+    {
+      packer()->draw_generic_opaque(shader, p,
+                                    attrib_chunks, index_chunks, index_adjusts,
+                                    attrib_chunk_selector, z);
+    }
+  else
+    {
+      packer()->draw_generic(coverage_buffer_offset, shader, p,
+                             attrib_chunks, index_chunks, index_adjusts,
+                             attrib_chunk_selector, z);
+    }
   ++m_draw_data_added_count;
 }
 
@@ -3371,10 +4025,97 @@ draw_generic(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShad
       p.m_brush_adjust = *m_current_brush_adjust;
       FASTUIDRAWassert(p.m_brush_adjust.m_packed_value);
     }
-  packer()->draw_generic(coverage_buffer_offset, shader, p, src, z);
+  if (route_opaque(shader, draw, &z))
+    {
+      packer()->draw_generic_opaque(shader, p, src, z);
+    }
+  else
+    {
+      packer()->draw_generic(coverage_buffer_offset, shader, p, src, z);
+    }
   ++m_draw_data_added_count;
 }
 
+bool
+PainterPrivate::
+route_opaque(const fastuidraw::reference_counted_ptr<fastuidraw::PainterItemShader> &shader,
+             const fastuidraw::PainterData &draw, int *z)
+{
+  using namespace fastuidraw;
+
+  /* An occluder is drawn in the regular stream and thus after
+   * the opaque stream; a draw that an occluder hides must then
+   * also be in the regular stream to be hidden.
+   */
+  if (!m_front_to_back_opaque || !m_occluder_stack.empty())
+    {
+      return false;
+    }
+
+  /* only the item shader of the default fill shader is known
+   * to give full coverage to each fragment it does not discard.
+   */
+  if (shader != m_default_shaders.fill_shader().item_shader()
+      || shader->coverage_shader())
+    {
+      return false;
+    }
+
+  const PainterBlendShaderSet &blend_shaders(m_default_shaders.blend_shaders());
+  if (packer()->blend_shader() == blend_shaders.shader(Painter::blend_porter_duff_src_over).get())
+    {
+      if (packer()->blend_mode() != blend_shaders.blend_mode(Painter::blend_porter_duff_src_over))
+        {
+          return false;
+        }
+    }
+  else if (packer()->blend_shader() == blend_shaders.shader(Painter::blend_porter_duff_src).get())
+    {
+      if (packer()->blend_mode() != blend_shaders.blend_mode(Painter::blend_porter_duff_src))
+        {
+          return false;
+        }
+    }
+  else
+    {
+      return false;
+    }
+
+  /* the brush must be an opaque constant color; images and
+   * gradients can have transparent texels and an image
+   * that needs to be bound would need a draw break.
+   */
+  if (draw.m_brush.custom_shader_brush())
+    {
+      return false;
+    }
+
+  const PainterData::value<PainterBrush> &brush(draw.m_brush.fixed_function_brush());
+  const PainterBrush *br(nullptr);
+
+  if (brush.m_value)
+    {
+      br = brush.m_value;
+    }
+  else if (brush.m_packed_value)
+    {
+      br = &brush.m_packed_value.value();
+    }
+
+  if (br && (br->color().w() < 1.0f
+             || (br->shader() & (PainterBrush::image_mask | PainterBrush::gradient_type_mask)) != 0u))
+    {
+      return false;
+    }
+
+  /* the draw must be in front of all that came before */
+  m_current_z = t_max(m_current_z, *z) + 1;
+  *z = m_current_z;
+  ++m_stats[Painter::num_opaque_draws];
+
+  return true;
+}
+
 void
 PainterPrivate::
 pre_draw_anti_alias_fuzz(const fastuidraw::FilledPath &filled_path,
@@ -3623,7 +4364,8 @@ stroke_path_common(const fastuidraw::PainterStrokeShader &shader,
                    const fastuidraw::StrokedPath &path, float thresh,
                    enum fastuidraw::Painter::cap_style cp,
                    enum fastuidraw::Painter::join_style js,
-                   bool apply_anti_aliasing)
+                   bool apply_anti_aliasing,
+                   CPUDashSegmentation *cpu_dash)
 {
   using namespace fastuidraw;
 
@@ -3632,12 +4374,20 @@ stroke_path_common(const fastuidraw::PainterStrokeShader &shader,
       return;
     }
 
+  TraceEvents::Scope trace("Painter", "stroke_path");
+
   const PainterAttributeData *cap_data(nullptr), *join_data(nullptr);
   const PainterShaderData::DataBase *raw_data;
   const StrokedCapsJoins &caps_joins(path.caps_joins());
   bool edge_arc_shader(path.has_arcs()), cap_arc_shader(false), join_arc_shader(false);
   bool requires_coverage_buffer(false);
 
+  if (edge_arc_shader && !*stroke_shader(shader, true, apply_anti_aliasing))
+    {
+      FASTUIDRAWwarning(!"Stroke shader has no arc shader to stroke a StrokedPath with arcs");
+      return;
+    }
+
   raw_data = draw.m_item_shader_data.data().data_base();
 
   switch(cp)
@@ -3707,25 +4457,65 @@ stroke_path_common(const fastuidraw::PainterStrokeShader &shader,
   unsigned int subset_count;
   m_work_room.m_stroke.m_subsets.resize(path.number_subsets());
 
-  subset_count = path.select_subsets(m_work_room.m_stroke.m_path_scratch,
-                                     m_clip_store.current(),
-                                     m_clip_rect_state.item_matrix(),
-                                     m_one_pixel_width,
-                                     additional_room,
-                                     m_max_attribs_per_block,
-                                     m_max_indices_per_block,
-                                     make_c_array(m_work_room.m_stroke.m_subsets));
+  {
+    detail::PainterScopedTimer timer(m_timers, PainterEnums::time_select_subsets_us);
+    subset_count = path.select_subsets(m_work_room.m_stroke.m_path_scratch,
+                                       m_clip_store.current(),
+                                       m_clip_rect_state.item_matrix(),
+                                       m_one_pixel_width,
+                                       additional_room,
+                                       m_max_attribs_per_block,
+                                       m_max_indices_per_block,
+                                       make_c_array(m_work_room.m_stroke.m_subsets));
+  }
 
   FASTUIDRAWassert(subset_count <= m_work_room.m_stroke.m_subsets.size());
   m_work_room.m_stroke.m_subsets.resize(subset_count);
 
-  caps_joins.compute_chunks(m_work_room.m_stroke.m_caps_joins_scratch,
-                            m_clip_store.current(),
-                            m_clip_rect_state.item_matrix(),
-                            m_one_pixel_width,
-                            additional_room,
-                            js, cp,
-                            m_work_room.m_stroke.m_caps_joins_chunk_set);
+  if (cpu_dash)
+    {
+      FASTUIDRAWassert(!edge_arc_shader);
+      m_work_room.m_stroke.m_dashed_edges.clear();
+      cpu_dash->m_dashed_edges = path.dashed_edges(cpu_dash->m_dash_pattern,
+                                                   cpu_dash->m_dash_offset,
+                                                   cpu_dash->m_cap_style, thresh);
+      for (unsigned int s : m_work_room.m_stroke.m_subsets)
+        {
+          const PainterAttributeData *p;
+
+          p = cpu_dash->m_dashed_edges->subset_data(s);
+
+          /* the caps added between dashes can make the data of a subset
+           * larger than what fits in a single draw; the subsets were
+           * selected to fit, so fall back to dashing in the shader.
+           * The same is done if the edge data could not be split.
+           */
+          if (!p
+              || p->attribute_data_chunk(0).size() > m_max_attribs_per_block
+              || p->index_data_chunk(0).size() > m_max_indices_per_block)
+            {
+              cpu_dash = nullptr;
+              break;
+            }
+          m_work_room.m_stroke.m_dashed_edges.push_back(p);
+        }
+
+      if (cpu_dash)
+        {
+          cpu_dash->m_edge_data = make_c_array(m_work_room.m_stroke.m_dashed_edges);
+        }
+    }
+
+  {
+    detail::PainterScopedTimer timer(m_timers, PainterEnums::time_select_subsets_us);
+    caps_joins.compute_chunks(m_work_room.m_stroke.m_caps_joins_scratch,
+                              m_clip_store.current(),
+                              m_clip_rect_state.item_matrix(),
+                              m_one_pixel_width,
+                              additional_room,
+                              js, cp,
+                              m_work_room.m_stroke.m_caps_joins_chunk_set);
+  }
 
   if (m_work_room.m_stroke.m_caps_joins_chunk_set.join_chunks().empty())
     {
@@ -3738,7 +4528,8 @@ stroke_path_common(const fastuidraw::PainterStrokeShader &shader,
     }
 
   requires_coverage_buffer =
-    (subset_count > 0 && (*stroke_shader(shader, edge_arc_shader, apply_anti_aliasing))->coverage_shader())
+    (subset_count > 0 && (*stroke_shader(cpu_dash ? *cpu_dash->m_edge_shader : shader,
+                                         edge_arc_shader, apply_anti_aliasing))->coverage_shader())
     || (join_data && (*stroke_shader(shader, join_arc_shader, apply_anti_aliasing))->coverage_shader())
     || (cap_data && (*stroke_shader(shader, cap_arc_shader, apply_anti_aliasing))->coverage_shader());
 
@@ -3760,7 +4551,7 @@ stroke_path_common(const fastuidraw::PainterStrokeShader &shader,
                   &path, make_c_array(m_work_room.m_stroke.m_subsets),
                   cap_data, m_work_room.m_stroke.m_caps_joins_chunk_set.cap_chunks(),
                   join_data, m_work_room.m_stroke.m_caps_joins_chunk_set.join_chunks(),
-                  apply_anti_aliasing);
+                  apply_anti_aliasing, cpu_dash);
 
   if (requires_coverage_buffer)
     {
@@ -3781,7 +4572,8 @@ stroke_path_raw(const fastuidraw::PainterStrokeShader &shader,
                 fastuidraw::c_array<const unsigned int> cap_chunks,
                 const fastuidraw::PainterAttributeData* join_data,
                 fastuidraw::c_array<const unsigned int> join_chunks,
-                bool apply_anti_aliasing)
+                bool apply_anti_aliasing,
+                const CPUDashSegmentation *cpu_dash)
 {
   using namespace fastuidraw;
   const unsigned int stroked_path_chunk = 0;
@@ -3846,16 +4638,29 @@ stroke_path_raw(const fastuidraw::PainterStrokeShader &shader,
     {
       const reference_counted_ptr<PainterItemShader> *edge_shader;
 
-      edge_shader = stroke_shader(shader, edge_use_arc_shaders, apply_anti_aliasing);
+      if (cpu_dash)
+        {
+          FASTUIDRAWassert(cpu_dash->m_edge_data.size() == stroked_subset_ids.size());
+          edge_shader = stroke_shader(*cpu_dash->m_edge_shader, edge_use_arc_shaders, apply_anti_aliasing);
+        }
+      else
+        {
+          edge_shader = stroke_shader(shader, edge_use_arc_shaders, apply_anti_aliasing);
+        }
+
       for(unsigned int E = 0; E < stroked_subset_ids.size(); ++E, ++current)
         {
-          StrokedPath::Subset S(stroked_path->subset(stroked_subset_ids[E]));
+          const PainterAttributeData *data;
+
+          data = (cpu_dash) ?
+            cpu_dash->m_edge_data[E] :
+            &stroked_path->subset(stroked_subset_ids[E]).painter_data();
 
-          attrib_chunks[current] = S.painter_data().attribute_data_chunk(stroked_path_chunk);
-          index_chunks[current] = S.painter_data().index_data_chunk(stroked_path_chunk);
-          index_adjusts[current] = S.painter_data().index_adjust_chunk(stroked_path_chunk);
-          z_increments[current] = S.painter_data().z_range(stroked_path_chunk).difference();
-          start_zs[current] = S.painter_data().z_range(stroked_path_chunk).m_begin;
+          attrib_chunks[current] = data->attribute_data_chunk(stroked_path_chunk);
+          index_chunks[current] = data->index_data_chunk(stroked_path_chunk);
+          index_adjusts[current] = data->index_adjust_chunk(stroked_path_chunk);
+          z_increments[current] = data->z_range(stroked_path_chunk).difference();
+          start_zs[current] = data->z_range(stroked_path_chunk).m_begin;
           shaders[current] = edge_shader;
           zinc_sum += z_increments[current];
         }
@@ -3949,6 +4754,93 @@ fill_path_compute_opaque_chunks(const fastuidraw::FilledPath &filled_path,
     }
 }
 
+void
+PainterPrivate::
+fill_clip_occluder(const fastuidraw::FilledPath &filled_path,
+                   const fastuidraw::reference_counted_ptr<const fastuidraw::FilledPath> &cache_handle,
+                   enum fastuidraw::Painter::fill_rule_t fill_rule)
+{
+  using namespace fastuidraw;
+
+  const PainterFillShader &shader(m_default_shaders.fill_shader());
+  PainterData draw(m_black_brush);
+  CachedClipPath *entry;
+
+  FASTUIDRAWassert(!cache_handle || cache_handle.get() == &filled_path);
+  if (m_clip_path_cache.m_max_entries == 0 || !cache_handle)
+    {
+      fill_path(shader, draw, filled_path, fill_rule, false);
+      return;
+    }
+
+  m_clip_path_key.set(filled_path, fill_rule,
+                      m_clip_rect_state.item_matrix(),
+                      m_clip_store.current());
+  entry = m_clip_path_cache.fetch(m_clip_path_key);
+  if (entry->m_path)
+    {
+      ++m_stats[Painter::num_clip_path_cache_hits];
+    }
+  else
+    {
+      entry->m_path = cache_handle;
+      fill_path_compute_opaque_chunks(filled_path, fill_rule,
+                                      m_work_room.m_fill_subset,
+                                      &entry->m_chunks);
+    }
+
+  if (entry->m_chunks.m_index_chunks.empty())
+    {
+      return;
+    }
+
+  draw_generic(shader.item_shader(), draw,
+               make_c_array(entry->m_chunks.m_attrib_chunks),
+               make_c_array(entry->m_chunks.m_index_chunks),
+               make_c_array(entry->m_chunks.m_index_adjusts),
+               make_c_array(entry->m_chunks.m_chunk_selector),
+               m_current_z);
+}
+
+void
+PainterPrivate::
+clip_out_filled_path(const fastuidraw::FilledPath &filled_path,
+                     const fastuidraw::reference_counted_ptr<const fastuidraw::FilledPath> &cache_handle,
+                     enum fastuidraw::Painter::fill_rule_t fill_rule)
+{
+  using namespace fastuidraw;
+
+  if (m_clip_rect_state.m_all_content_culled)
+    {
+      /* everything is clipped anyways, adding more clipping does not matter
+       */
+      return;
+    }
+
+  const PainterBlendShaderSet &blend_shaders(m_default_shaders.blend_shaders());
+  PainterBlendShader* old_blend;
+  BlendMode old_blend_mode;
+  reference_counted_ptr<ZDataCallBack> zdatacallback;
+
+  /* zdatacallback generates a list of PainterDraw::DelayedAction
+   * objects (held in m_actions) who's action is to write the correct
+   * z-value to occlude elements drawn after clipOut but not after
+   * the next time m_occluder_stack is popped.
+   */
+  zdatacallback = FASTUIDRAWnew ZDataCallBack();
+  old_blend = packer()->blend_shader();
+  old_blend_mode = packer()->blend_mode();
+
+  packer()->blend_shader(blend_shaders.shader(Painter::blend_porter_duff_dst).get(),
+                         blend_shaders.blend_mode(Painter::blend_porter_duff_dst));
+  packer()->add_callback(zdatacallback);
+  fill_clip_occluder(filled_path, cache_handle, fill_rule);
+  packer()->remove_callback(zdatacallback);
+  packer()->blend_shader(old_blend, old_blend_mode);
+
+  m_occluder_stack.push_back(occluder_stack_entry(zdatacallback->m_actions));
+}
+
 void
 PainterPrivate::
 fill_path_compute_opaque_chunks(const fastuidraw::FilledPath &filled_path,
@@ -4022,6 +4914,7 @@ fill_path(const fastuidraw::PainterFillShader &shader,
 {
   using namespace fastuidraw;
 
+  TraceEvents::Scope trace("Painter", "fill_path");
   fill_path_compute_opaque_chunks(filled_path, fill_rule,
                                   m_work_room.m_fill_subset,
                                   &m_work_room.m_fill_opaque);
@@ -4043,19 +4936,25 @@ fill_path(const fastuidraw::PainterFillShader &shader,
       m_work_room.m_fill_aa_fuzz.m_total_increment_z = 0;
     }
 
+  /* The anti-alias fuzz takes the z-range starting at startz
+   * so that it is below the fill; route_opaque() can move
+   * m_current_z past the z of the fill, so the fuzz cannot
+   * read m_current_z after the fill is drawn.
+   */
+  int startz(m_current_z);
   draw_generic(shader.item_shader(), draw,
                make_c_array(m_work_room.m_fill_opaque.m_attrib_chunks),
                make_c_array(m_work_room.m_fill_opaque.m_index_chunks),
                make_c_array(m_work_room.m_fill_opaque.m_index_adjusts),
                make_c_array(m_work_room.m_fill_opaque.m_chunk_selector),
-               m_current_z + m_work_room.m_fill_aa_fuzz.m_total_increment_z);
+               startz + m_work_room.m_fill_aa_fuzz.m_total_increment_z);
 
   if (apply_anti_aliasing)
     {
-      draw_anti_alias_fuzz(shader, draw, m_work_room.m_fill_aa_fuzz);
+      draw_anti_alias_fuzz(shader, draw, m_work_room.m_fill_aa_fuzz, startz);
     }
 
-  m_current_z += m_work_room.m_fill_aa_fuzz.m_total_increment_z;
+  m_current_z = t_max(m_current_z, startz + m_work_room.m_fill_aa_fuzz.m_total_increment_z);
 }
 
 void
@@ -4071,6 +4970,11 @@ fill_rounded_rect(const fastuidraw::PainterFillShader &shader,
   ClipRectState m(m_clip_rect_state);
   RoundedRectTransformations rect_transforms(R, &m_pool);
   int total_incr_z(0);
+  /* The opaque pieces may be placed higher than requested by
+   * route_opaque(), which moves m_current_z; the anti-alias fuzz
+   * uses the z-range from startz so that it stays below them.
+   */
+  int startz(m_current_z);
   RectWithSidePoints interior_rect, r_min, r_max, r_min_extra, r_max_extra;
   float wedge_miny, wedge_maxy;
   vecN<PackedAntiAliasEdgeData, 4> per_line;
@@ -4162,7 +5066,7 @@ fill_rounded_rect(const fastuidraw::PainterFillShader &shader,
       r.m_min_point.y() = R.m_min_point.y() + R.m_corner_radii[Rect::maxx_miny_corner].y();
       r.m_max_point.x() = R.m_max_point.x();
       r.m_max_point.y() = r_min.m_max_point.y();
-      fill_rect(shader, draw, r, false, m_current_z + total_incr_z);
+      fill_rect(shader, draw, r, false, startz + total_incr_z);
 
       r_min.m_max_x.insert(r.min_y());
     }
@@ -4174,7 +5078,7 @@ fill_rounded_rect(const fastuidraw::PainterFillShader &shader,
       r.m_min_point.y() = R.m_min_point.y() + R.m_corner_radii[Rect::minx_miny_corner].y();
       r.m_max_point.x() = R.m_min_point.x() + R.m_corner_radii[Rect::minx_miny_corner].x();
       r.m_max_point.y() = r_min.m_max_point.y();
-      fill_rect(shader, draw, r, false, m_current_z + total_incr_z);
+      fill_rect(shader, draw, r, false, startz + total_incr_z);
 
       r_min.m_min_x.insert(r.min_y());
     }
@@ -4187,7 +5091,7 @@ fill_rounded_rect(const fastuidraw::PainterFillShader &shader,
       r.m_min_point.y() = r_max.m_min_point.y();
       r.m_max_point.x() = R.m_max_point.x();
       r.m_max_point.y() = R.m_max_point.y() - R.m_corner_radii[Rect::maxx_maxy_corner].y();
-      fill_rect(shader, draw, r, false, m_current_z + total_incr_z);
+      fill_rect(shader, draw, r, false, startz + total_incr_z);
 
       r_max.m_min_x.insert(r.max_y());
     }
@@ -4199,14 +5103,14 @@ fill_rounded_rect(const fastuidraw::PainterFillShader &shader,
       r.m_min_point.y() = r_max.m_min_point.y();
       r.m_max_point.x() = R.m_min_point.x() + R.m_corner_radii[Rect::minx_maxy_corner].x();
       r.m_max_point.y() = R.m_max_point.y() - R.m_corner_radii[Rect::minx_maxy_corner].y();
-      fill_rect(shader, draw, r, false, m_current_z + total_incr_z);
+      fill_rect(shader, draw, r, false, startz + total_incr_z);
 
       r_max.m_max_x.insert(r.max_y());
     }
 
-  fill_rect_with_side_points(shader, draw, interior_rect, false, m_current_z + total_incr_z);
-  fill_rect_with_side_points(shader, draw, r_min, false, m_current_z + total_incr_z);
-  fill_rect_with_side_points(shader, draw, r_max, false, m_current_z + total_incr_z);
+  fill_rect_with_side_points(shader, draw, interior_rect, false, startz + total_incr_z);
+  fill_rect_with_side_points(shader, draw, r_min, false, startz + total_incr_z);
+  fill_rect_with_side_points(shader, draw, r_max, false, startz + total_incr_z);
 
   for (int i = 0; i < 4; ++i)
     {
@@ -4220,7 +5124,7 @@ fill_rounded_rect(const fastuidraw::PainterFillShader &shader,
                    make_c_array(m_work_room.m_rounded_rect.m_per_corner[i].m_opaque_fill.m_index_chunks),
                    make_c_array(m_work_room.m_rounded_rect.m_per_corner[i].m_opaque_fill.m_index_adjusts),
                    make_c_array(m_work_room.m_rounded_rect.m_per_corner[i].m_opaque_fill.m_chunk_selector),
-                   m_current_z + total_incr_z);
+                   startz + total_incr_z);
       m_clip_rect_state = m;
 
       m_current_brush_adjust = nullptr;
@@ -4248,7 +5152,7 @@ fill_rounded_rect(const fastuidraw::PainterFillShader &shader,
                            attribs.sub_array(per_line[i].m_attrib_range),
                            indices.sub_array(per_line[i].m_index_range),
                            -per_line[i].m_attrib_range.m_begin,
-                           m_current_z + incr_z);
+                           startz + incr_z);
               end_coverage_buffer();
             }
         }
@@ -4263,13 +5167,13 @@ fill_rounded_rect(const fastuidraw::PainterFillShader &shader,
                 rect_transforms.m_adjusts[i].m_shear.y());
           draw_anti_alias_fuzz(shader, draw,
                                m_work_room.m_rounded_rect.m_per_corner[i].m_aa_fuzz,
-                               m_current_z + incr_z);
+                               startz + incr_z);
           m_clip_rect_state = m;
 
           m_current_brush_adjust = nullptr;
         }
     }
-  m_current_z += total_incr_z;
+  m_current_z = t_max(m_current_z, startz + total_incr_z);
 }
 
 void
@@ -4587,6 +5491,8 @@ begin(const reference_counted_ptr<PainterSurface> &surface,
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
+  TraceEvents::Scope trace("Painter", "begin");
+  glyph_cache().begin_frame();
   image_atlas().lock_resources();
   colorstop_atlas().lock_resources();
   glyph_atlas().lock_resources();
@@ -4594,11 +5500,14 @@ begin(const reference_counted_ptr<PainterSurface> &surface,
   d->m_number_external_textures = d->m_backend->on_painter_begin();
   d->m_viewport = surface->viewport();
   d->m_effects_layer_factory.begin(*surface);
+  d->m_layer_cache.begin_frame();
+  d->m_clip_path_cache.begin_frame();
   d->m_deferred_coverage_stack_entry_factory.begin(*surface);
   d->m_root_packer->begin(d->m_number_external_textures, surface, clear_color_buffer);
   d->m_active_surfaces.clear();
   std::fill(d->m_stats.begin(), d->m_stats.end(), 0u);
   d->m_stats[Painter::num_render_targets] = 1;
+  d->m_timers.reset();
   d->m_viewport_dimensions = vec2(d->m_viewport.m_dimensions);
   d->m_viewport_dimensions.x() = t_max(1.0f, d->m_viewport_dimensions.x());
   d->m_viewport_dimensions.y() = t_max(1.0f, d->m_viewport_dimensions.y());
@@ -4650,6 +5559,8 @@ end(void)
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
 
+  TraceEvents::Scope trace("Painter", "end");
+
   /* pop the effects stack until it is empty */
   while (!d->m_effects_layer_stack.empty())
     {
@@ -4684,6 +5595,9 @@ end(void)
   d->m_deferred_coverage_stack_entry_factory.end();
   d->m_effects_layer_factory.end();
   d->m_root_packer->end();
+  d->m_timers.write_stats(d->m_stats);
+  d->m_backend->state_change_counts(&d->m_stats[Painter::num_backend_state_changes],
+                                    &d->m_stats[Painter::num_backend_state_changes_elided]);
 
   /* unlock resources after the commands are sent to the GPU */
   image_atlas().unlock_resources();
@@ -5151,11 +6065,31 @@ stroke_dashed_path(const PainterDashedStrokeShaderSet &shader, const PainterData
 
   FASTUIDRAWassert(0 <= stroke_style.m_cap_style && stroke_style.m_cap_style < number_cap_styles);
   FASTUIDRAWassert(0 <= stroke_style.m_join_style && stroke_style.m_join_style < number_join_styles);
+
+  CPUDashSegmentation cpu_dash;
+  bool use_cpu_dash;
+
+  /* The edges split on the CPU are drawn with the non-dashed
+   * stroke shader of the shader set; it consumes the
+   * PainterDashedStrokeParams data of the draw directly.
+   */
+  cpu_dash.m_edge_shader = &shader.cpu_dash_edge_shader();
+  use_cpu_dash = stroke_style.m_cpu_dash_segmentation
+    && !path.has_arcs()
+    && cpu_dash.m_edge_shader->shader(stroking_method_linear, PainterStrokeShader::non_aa_shader)
+    && cpu_dash.m_edge_shader->shader(stroking_method_linear, PainterStrokeShader::aa_shader)
+    && draw.m_item_shader_data.has_data()
+    && PainterDashedStrokeParams::dash_pattern_from_data(draw.m_item_shader_data.data().data_base(),
+                                                         &cpu_dash.m_dash_offset,
+                                                         &cpu_dash.m_dash_pattern);
+  cpu_dash.m_cap_style = stroke_style.m_cap_style;
+
   d->stroke_path_common(shader.shader(stroke_style.m_cap_style), draw,
                         path, thresh,
                         number_cap_styles,
                         stroke_style.m_join_style,
-                        apply_shader_anti_aliasing);
+                        apply_shader_anti_aliasing,
+                        (use_cpu_dash) ? &cpu_dash : nullptr);
 }
 
 void
@@ -5318,22 +6252,29 @@ draw_glyphs(const PainterGlyphShader &shader, const PainterData &draw,
       return renderer;
     }
 
+  TraceEvents::Scope trace("Painter", "draw_glyphs");
   unsigned int num;
   d->m_work_room.m_glyph.m_subsets.resize(glyph_sequence.number_subsets());
-  num = glyph_sequence.select_subsets(d->m_work_room.m_glyph.m_scratch,
-                                      d->m_clip_store.current(),
-                                      d->m_clip_rect_state.item_matrix(),
-                                      make_c_array(d->m_work_room.m_glyph.m_subsets));
+  {
+    detail::PainterScopedTimer timer(d->m_timers, time_select_subsets_us);
+    num = glyph_sequence.select_subsets(d->m_work_room.m_glyph.m_scratch,
+                                        d->m_clip_store.current(),
+                                        d->m_clip_rect_state.item_matrix(),
+                                        make_c_array(d->m_work_room.m_glyph.m_subsets));
+  }
   d->m_work_room.m_glyph.m_attribs.resize(num);
   d->m_work_room.m_glyph.m_indices.resize(num);
-  for (unsigned int k = 0; k < num; ++k)
-    {
-      unsigned int I(d->m_work_room.m_glyph.m_subsets[k]);
-      GlyphSequence::Subset S(glyph_sequence.subset(I));
-      S.attributes_and_indices(renderer,
-                   &d->m_work_room.m_glyph.m_attribs[k],
-                   &d->m_work_room.m_glyph.m_indices[k]);
-    }
+  {
+    detail::PainterScopedTimer timer(d->m_timers, time_glyph_fetch_us);
+    for (unsigned int k = 0; k < num; ++k)
+      {
+        unsigned int I(d->m_work_room.m_glyph.m_subsets[k]);
+        GlyphSequence::Subset S(glyph_sequence.subset(I));
+        S.attributes_and_indices(renderer,
+                                 &d->m_work_room.m_glyph.m_attribs[k],
+                                 &d->m_work_room.m_glyph.m_indices[k]);
+      }
+  }
   d->draw_generic(shader.shader(renderer.m_type),
                   draw,
                   make_c_array(d->m_work_room.m_glyph.m_attribs),
@@ -5374,10 +6315,15 @@ draw_glyphs(const PainterGlyphShader &shader, const PainterData &draw,
       return renderer;
     }
 
+  TraceEvents::Scope trace("Painter", "draw_glyphs");
+  const PainterAttributeWriter *writer;
+  {
+    detail::PainterScopedTimer timer(d->m_timers, time_glyph_fetch_us);
+    writer = &glyph_run.subsequence(renderer, begin, count);
+  }
+
   d->draw_generic(shader.shader(renderer.m_type),
-                  draw,
-                  glyph_run.subsequence(renderer, begin, count),
-                  d->m_current_z);
+                  draw, *writer, d->m_current_z);
 
   return renderer;
 }
@@ -5625,6 +6571,24 @@ curve_flatness(void)
   return d->m_curve_flatness;
 }
 
+void
+fastuidraw::Painter::
+profiling(bool v)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_timers.m_enabled = v;
+}
+
+bool
+fastuidraw::Painter::
+profiling(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_timers.m_enabled;
+}
+
 void
 fastuidraw::Painter::
 save(void)
@@ -5689,87 +6653,115 @@ fastuidraw::Painter::
 begin_layer(c_array<const reference_counted_ptr<PainterEffectPass> > passes)
 {
   PainterPrivate *d;
-  Rect clip_region_rect;
-
   d = static_cast<PainterPrivate*>(m_d);
+  d->begin_layer(this, passes, nullptr);
+}
 
-  clip_region_bounds(&clip_region_rect.m_min_point,
-                     &clip_region_rect.m_max_point);
-
-  /* This save() is to save the current clipping state because it
-   * will get set to just clip the rect giving by clip_region_rect
-   */
-  save();
-
-  EffectsStackEntry fx_entry;
-
-  fx_entry.m_effects_layer_stack_size = d->m_effects_layer_stack.size();
-  fx_entry.m_state_stack_size = d->m_state_stack.size();;
-  d->m_effects_stack.push_back(fx_entry);
-
-  fastuidraw::PainterBlendShader* old_blend(d->packer()->blend_shader());
-  fastuidraw::PainterBlendShader* copy_blend(d->m_default_shaders.blend_shaders().shader(blend_porter_duff_src).get());
-  BlendMode old_blend_mode(d->packer()->blend_mode());
-  BlendMode copy_blend_mode(d->m_default_shaders.blend_shaders().blend_mode(blend_porter_duff_src));
-
-  for (auto ibegin = passes.rbegin(), iend = passes.rend(), i = ibegin;
-       i != iend; ++i)
-    {
-      /* get the EffectsLayer that gives the PainterPacker and what to blit
-       * when the layer is done
-       */
-      EffectsLayer R;
+bool
+fastuidraw::Painter::
+begin_cached_layer(uint64_t content_key, const vec4 &color_modulate)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_color_modulate_fx->color(color_modulate);
+  return begin_cached_layer(content_key, d->m_color_modulate_fx);
+}
 
-      R = d->m_effects_layer_factory.fetch(d->m_effects_layer_stack.size(), clip_region_rect, d);
+bool
+fastuidraw::Painter::
+begin_cached_layer(uint64_t content_key,
+                   const reference_counted_ptr<PainterEffect> &effect)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->begin_layer(this, effect->passes(), d->m_layer_cache.fetch(content_key));
+}
 
-      /* Set the blend mode to copy for those rects that fed to the next
-       * effect; the last blit has the blend mode set to what it was before.
-       */
-      if (i != ibegin)
-        {
-          d->packer()->blend_shader(copy_blend, copy_blend_mode);
-        }
-      else
-        {
-          d->packer()->blend_shader(old_blend, old_blend_mode);
-        }
+void
+fastuidraw::Painter::
+invalidate_layer_cache(uint64_t content_key)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  FASTUIDRAWassert(!d->m_root_packer->surface());
+  d->m_layer_cache.invalidate(content_key);
+}
 
-      /* We *add* the command to the current packer() to blit the rect of R
-       * now. Recall that the PainterPacker used for the layer will have its
-       * commands executed before the current packer(), regardless in what
-       * order we add them.
-       */
-      R.blit_rect(*i, d->m_viewport_dimensions, this);
+void
+fastuidraw::Painter::
+invalidate_layer_cache(void)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  FASTUIDRAWassert(!d->m_root_packer->surface());
+  d->m_layer_cache.clear();
+}
 
-      /* after issuing the blit command, then add R to m_effects_layer_stack */
-      d->m_effects_layer_stack.push_back(R);
-      ++d->m_stats[num_layers];
+unsigned int
+fastuidraw::Painter::
+max_cached_layers(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_layer_cache.m_max_entries;
+}
 
-      /* Set the clipping equations to the equations coming from clip_region_rect */
-      d->m_clip_rect_state.m_clip_rect = clip_rect(clip_region_rect);
-      d->m_clip_rect_state.set_clip_equations_to_clip_rect(ClipRectState::rect_in_normalized_device_coordinates);
+void
+fastuidraw::Painter::
+max_cached_layers(unsigned int v)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_layer_cache.m_max_entries = v;
+}
 
-      /* update d->m_clip_rect_state.m_clip_rect to local coordinates */
-      d->m_clip_rect_state.update_rect_to_transformation();
+bool
+fastuidraw::Painter::
+front_to_back_opaque(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_front_to_back_opaque;
+}
 
-      /* change m_clip_store so that the current value is just from clip_region_rect */
-      d->m_clip_store.reset_current_to_rect(clip_region_rect);
+void
+fastuidraw::Painter::
+front_to_back_opaque(bool v)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_front_to_back_opaque = v;
+}
 
-      /* set the normalized translation of d->m_clip_rect_state */
-      d->m_clip_rect_state.set_normalized_device_translate(d->m_effects_layer_stack.back().m_normalized_translate);
+unsigned int
+fastuidraw::Painter::
+max_cached_clip_paths(void) const
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  return d->m_clip_path_cache.m_max_entries;
+}
 
-      if (!d->m_deferred_coverage_stack.empty()
-          && d->m_deferred_coverage_stack.back().packer())
-        {
-          d->m_deferred_coverage_stack.back().update_coverage_buffer_offset(d);
-        }
+void
+fastuidraw::Painter::
+max_cached_clip_paths(unsigned int v)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_clip_path_cache.m_max_entries = v;
+  if (v == 0)
+    {
+      d->m_clip_path_cache.clear();
     }
+}
 
-  /* Set the packer's blend shader, mode and blend shader to
-   * Painter default values
-   */
-  blend_shader(blend_porter_duff_src_over);
-  save();
+void
+fastuidraw::Painter::
+invalidate_clip_path_cache(void)
+{
+  PainterPrivate *d;
+  d = static_cast<PainterPrivate*>(m_d);
+  d->m_clip_path_cache.clear();
 }
 
 void
@@ -5867,8 +6859,10 @@ clip_out_path(const Path &path, enum fill_rule_t fill_rule)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
-  clip_out_path(d->select_filled_path(path), fill_rule);
+  const reference_counted_ptr<const FilledPath> &filled_path(d->select_filled_path_handle(path));
+  d->clip_out_filled_path(*filled_path, filled_path, fill_rule);
 }
 
 void
@@ -5877,6 +6871,7 @@ clip_out_path(const Path &path, const CustomFillRuleBase &fill_rule)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
   clip_out_path(d->select_filled_path(path), fill_rule);
 }
@@ -5887,8 +6882,18 @@ clip_in_path(const Path &path, enum fill_rule_t fill_rule)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
-  clip_in_path(d->select_filled_path(path), fill_rule);
+  if (d->m_clip_rect_state.m_all_content_culled)
+    {
+      /* everything is clipped anyways, adding more clipping does not matter
+       */
+      return;
+    }
+
+  const reference_counted_ptr<const FilledPath> &filled_path(d->select_filled_path_handle(path));
+  clip_in_rect(filled_path->bounding_box());
+  d->clip_out_filled_path(*filled_path, filled_path, complement_fill_rule(fill_rule));
 }
 
 void
@@ -5897,6 +6902,7 @@ clip_in_path(const Path &path, const CustomFillRuleBase &fill_rule)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
   clip_in_path(d->select_filled_path(path), fill_rule);
 }
@@ -5907,36 +6913,12 @@ clip_out_path(const FilledPath &path, enum fill_rule_t fill_rule)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
-  if (d->m_clip_rect_state.m_all_content_culled)
-    {
-      /* everything is clipped anyways, adding more clipping does not matter
-       */
-      return;
-    }
-
-  PainterBlendShader* old_blend;
-  BlendMode old_blend_mode;
-  reference_counted_ptr<ZDataCallBack> zdatacallback;
-
-  /* zdatacallback generates a list of PainterDraw::DelayedAction
-   * objects (held in m_actions) who's action is to write the correct
-   * z-value to occlude elements drawn after clipOut but not after
-   * the next time m_occluder_stack is popped.
+  /* there is no ownership contract on path, so the
+   * occluder is not cached.
    */
-  zdatacallback = FASTUIDRAWnew ZDataCallBack();
-  old_blend = d->packer()->blend_shader();
-  old_blend_mode = d->packer()->blend_mode();
-
-  blend_shader(blend_porter_duff_dst);
-  d->packer()->add_callback(zdatacallback);
-  d->fill_path(default_shaders().fill_shader(),
-               PainterData(d->m_black_brush),
-               path, fill_rule, false);
-  d->packer()->remove_callback(zdatacallback);
-  d->packer()->blend_shader(old_blend, old_blend_mode);
-
-  d->m_occluder_stack.push_back(occluder_stack_entry(zdatacallback->m_actions));
+  d->clip_out_filled_path(path, reference_counted_ptr<const FilledPath>(), fill_rule);
 }
 
 void
@@ -5945,6 +6927,7 @@ clip_out_path(const FilledPath &path, const CustomFillRuleBase &fill_rule)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
   if (d->m_clip_rect_state.m_all_content_culled)
     {
@@ -5988,6 +6971,7 @@ clip_out_custom(const reference_counted_ptr<PainterItemShader> &shader,
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
   if (d->m_clip_rect_state.m_all_content_culled)
     {
@@ -6040,6 +7024,7 @@ clip_out_rounded_rect(const RoundedRect &R)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
   if (d->m_clip_rect_state.m_all_content_culled)
     {
@@ -6078,6 +7063,7 @@ clip_out_convex_polygon(c_array<const vec2> poly)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
   if (d->m_clip_rect_state.m_all_content_culled)
     {
@@ -6099,6 +7085,7 @@ clip_in_path(const FilledPath &path, enum fill_rule_t fill_rule)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
   if (d->m_clip_rect_state.m_all_content_culled)
     {
@@ -6117,6 +7104,7 @@ clip_in_path(const FilledPath &path, const CustomFillRuleBase &fill_rule)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
   if (d->m_clip_rect_state.m_all_content_culled)
     {
@@ -6135,6 +7123,7 @@ clip_in_rounded_rect(const RoundedRect &R)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
   if (d->m_clip_rect_state.m_all_content_culled)
     {
@@ -6189,6 +7178,7 @@ clip_in_rect(const Rect &rect)
 {
   PainterPrivate *d;
   d = static_cast<PainterPrivate*>(m_d);
+  detail::PainterScopedTimer timer(d->m_timers, time_clipping_us);
 
   d->m_clip_rect_state.m_all_content_culled = d->m_clip_rect_state.m_all_content_culled
     || rect.m_min_point.x() >= rect.m_max_point.x()
@@ -6464,6 +7454,21 @@ label(enum query_stats_t st)
       EASY(num_ends);
       EASY(num_layers);
       EASY(num_deferred_coverages);
+      EASY(num_draw_breaks_buffer_full);
+      EASY(num_draw_breaks_shader_change);
+      EASY(num_draw_breaks_blend_change);
+      EASY(num_draw_breaks_action);
+      EASY(time_select_subsets_us);
+      EASY(time_clipping_us);
+      EASY(time_packing_us);
+      EASY(time_glyph_fetch_us);
+      EASY(time_backend_pre_draw_us);
+      EASY(time_backend_post_draw_us);
+      EASY(num_cached_layer_hits);
+      EASY(num_clip_path_cache_hits);
+      EASY(num_opaque_draws);
+      EASY(num_backend_state_changes);
+      EASY(num_backend_state_changes_elided);
     default:
       return "unknown";
     }
@@ -20,6 +20,46 @@
 #include <fastuidraw/painter/painter_brush.hpp>
 #include <fastuidraw/painter/backend/painter_header.hpp>
 
+namespace
+{
+  unsigned int
+  packed_color_stops_data_size(unsigned int number_stops)
+  {
+    /* places followed by colors, each padded to a multiple of 4 */
+    return 2u * FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(number_stops);
+  }
+
+  void
+  pack_color_stops(fastuidraw::c_array<const fastuidraw::ColorStop> stops,
+                   fastuidraw::c_array<fastuidraw::generic_data> dst)
+  {
+    using namespace fastuidraw;
+
+    FASTUIDRAWassert(!stops.empty());
+
+    unsigned int last(stops.size() - 1u);
+    unsigned int padded_size(FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(stops.size()));
+    c_array<generic_data> places(dst.sub_array(0, padded_size));
+    c_array<generic_data> colors(dst.sub_array(padded_size, padded_size));
+
+    for (unsigned int i = 0; i < padded_size; ++i)
+      {
+        const ColorStop &stop(stops[t_min(i, last)]);
+
+        places[i].f = stop.m_place;
+        colors[i].u =
+          pack_bits(PainterBrush::packed_color_stop_red_bit0,
+                    PainterBrush::packed_color_stop_channel_num_bits, stop.m_color.x())
+          | pack_bits(PainterBrush::packed_color_stop_green_bit0,
+                      PainterBrush::packed_color_stop_channel_num_bits, stop.m_color.y())
+          | pack_bits(PainterBrush::packed_color_stop_blue_bit0,
+                      PainterBrush::packed_color_stop_channel_num_bits, stop.m_color.z())
+          | pack_bits(PainterBrush::packed_color_stop_alpha_bit0,
+                      PainterBrush::packed_color_stop_channel_num_bits, stop.m_color.w());
+      }
+  }
+}
+
 ////////////////////////////////////
 // fastuidraw::PainterBrush methods
 unsigned int
@@ -69,6 +109,12 @@ data_size(void) const
       return_value += FASTUIDRAW_ROUND_UP_MULTIPLE_OF4(transformation_matrix_data_size);
     }
 
+  if (pshader & gradient_packed_color_stops_mask)
+    {
+      FASTUIDRAWassert(m_data.m_cs_array);
+      return_value += packed_color_stops_data_size(m_data.m_cs_array->values().size());
+    }
+
   return return_value;
 }
 
@@ -149,19 +195,28 @@ pack_data(c_array<generic_data> dst) const
       sub_dest = dst.sub_array(current, sz);
       current += sz;
 
-      FASTUIDRAWassert(m_data.m_cs);
-      FASTUIDRAWassert(m_data.m_cs->texel_location().x() >= 0);
-      FASTUIDRAWassert(m_data.m_cs->texel_location().y() >= 0);
+      if (pshader & gradient_packed_color_stops_mask)
+        {
+          FASTUIDRAWassert(m_data.m_cs_array);
+          sub_dest[gradient_color_stop_xy_offset].u = 0u;
+          sub_dest[gradient_color_stop_length_offset].u = m_data.m_cs_array->values().size();
+        }
+      else
+        {
+          FASTUIDRAWassert(m_data.m_cs);
+          FASTUIDRAWassert(m_data.m_cs->texel_location().x() >= 0);
+          FASTUIDRAWassert(m_data.m_cs->texel_location().y() >= 0);
 
-      uint32_t x, y;
-      x = static_cast<uint32_t>(m_data.m_cs->texel_location().x());
-      y = static_cast<uint32_t>(m_data.m_cs->texel_location().y());
+          uint32_t x, y;
+          x = static_cast<uint32_t>(m_data.m_cs->texel_location().x());
+          y = static_cast<uint32_t>(m_data.m_cs->texel_location().y());
 
-      sub_dest[gradient_color_stop_xy_offset].u =
-        pack_bits(gradient_color_stop_x_bit0, gradient_color_stop_x_num_bits, x)
-        | pack_bits(gradient_color_stop_y_bit0, gradient_color_stop_y_num_bits, y);
+          sub_dest[gradient_color_stop_xy_offset].u =
+            pack_bits(gradient_color_stop_x_bit0, gradient_color_stop_x_num_bits, x)
+            | pack_bits(gradient_color_stop_y_bit0, gradient_color_stop_y_num_bits, y);
 
-      sub_dest[gradient_color_stop_length_offset].u = m_data.m_cs->width();
+          sub_dest[gradient_color_stop_length_offset].u = m_data.m_cs->width();
+        }
 
       sub_dest[gradient_p0_x_offset].f = m_data.m_grad_start.x();
       sub_dest[gradient_p0_y_offset].f = m_data.m_grad_start.y();
@@ -209,6 +264,17 @@ pack_data(c_array<generic_data> dst) const
       sub_dest[transformation_translation_y_offset].f = m_data.m_transformation_p.y();
     }
 
+  if (pshader & gradient_packed_color_stops_mask)
+    {
+      c_array<const ColorStop> stops(m_data.m_cs_array->values());
+
+      sz = packed_color_stops_data_size(stops.size());
+      sub_dest = dst.sub_array(current, sz);
+      current += sz;
+
+      pack_color_stops(stops, sub_dest);
+    }
+
   FASTUIDRAWassert(current == dst.size());
 }
 
@@ -270,7 +336,7 @@ shader(void) const
   FASTUIDRAWstatic_assert(number_shader_bits <= 32u);
 
   return_value = m_data.m_shader_raw;
-  if (!m_data.m_image && !m_data.m_cs)
+  if (!m_data.m_image && !m_data.m_cs && !m_data.m_cs_array)
     {
       /* lacking an image or gradient means the brush does
        * nothing and so all bits should be down.
@@ -288,6 +354,7 @@ reset(void)
   m_data.m_shader_raw = 0u;
   m_data.m_image = nullptr;
   m_data.m_cs = nullptr;
+  m_data.m_cs_array = nullptr;
   m_data.m_transformation_p = vec2(0.0f, 0.0f);
   m_data.m_transformation_matrix = float2x2();
   return *this;
@@ -345,3 +345,22 @@ stroking_data_selector(bool pixel_arc_stroking_possible)
 {
   return FASTUIDRAWnew detail::StrokingDataSelectorT<PainterDashedStrokeParamsData>(pixel_arc_stroking_possible);
 }
+
+bool
+fastuidraw::PainterDashedStrokeParams::
+dash_pattern_from_data(const PainterShaderData::DataBase *data,
+                       float *out_dash_offset,
+                       c_array<const DashPatternElement> *out_dash_pattern)
+{
+  const PainterDashedStrokeParamsData *d;
+
+  d = dynamic_cast<const PainterDashedStrokeParamsData*>(data);
+  if (!d)
+    {
+      return false;
+    }
+
+  *out_dash_offset = d->m_dash_offset;
+  *out_dash_pattern = make_c_array(d->m_dash_pattern);
+  return true;
+}
@@ -29,6 +29,7 @@ namespace
     enum { count = fastuidraw::PainterEnums::number_cap_styles };
 
     fastuidraw::vecN<PainterStrokeShader, count> m_shaders;
+    PainterStrokeShader m_cpu_dash_edge_shader;
   };
 }
 
@@ -78,3 +79,22 @@ shader(enum PainterEnums::cap_style st,
   d->m_shaders[st] = sh;
   return *this;
 }
+
+const fastuidraw::PainterStrokeShader&
+fastuidraw::PainterDashedStrokeShaderSet::
+cpu_dash_edge_shader(void) const
+{
+  PainterDashedStrokeShaderSetPrivate *d;
+  d = static_cast<PainterDashedStrokeShaderSetPrivate*>(m_d);
+  return d->m_cpu_dash_edge_shader;
+}
+
+fastuidraw::PainterDashedStrokeShaderSet&
+fastuidraw::PainterDashedStrokeShaderSet::
+cpu_dash_edge_shader(const PainterStrokeShader &sh)
+{
+  PainterDashedStrokeShaderSetPrivate *d;
+  d = static_cast<PainterDashedStrokeShaderSetPrivate*>(m_d);
+  d->m_cpu_dash_edge_shader = sh;
+  return *this;
+}
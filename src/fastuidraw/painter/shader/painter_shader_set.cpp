@@ -30,6 +30,7 @@ namespace
     fastuidraw::PainterDashedStrokeShaderSet m_dashed_stroke_shader;
     fastuidraw::PainterFillShader m_fill_shader;
     fastuidraw::PainterBlendShaderSet m_blend_shaders;
+    fastuidraw::reference_counted_ptr<fastuidraw::PainterCustomBrushShader> m_blur_brush_shader;
   };
 }
 
@@ -73,3 +74,7 @@ setget_implement(fastuidraw::PainterShaderSet, PainterShaderSetPrivate,
 
 setget_implement(fastuidraw::PainterShaderSet, PainterShaderSetPrivate,
                  const fastuidraw::PainterBlendShaderSet&, blend_shaders)
+
+setget_implement(fastuidraw::PainterShaderSet, PainterShaderSetPrivate,
+                 const fastuidraw::reference_counted_ptr<fastuidraw::PainterCustomBrushShader>&,
+                 blur_brush_shader)
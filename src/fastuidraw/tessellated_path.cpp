@@ -24,6 +24,7 @@
 #include <fastuidraw/path.hpp>
 #include <fastuidraw/painter/attribute_data/stroked_path.hpp>
 #include <fastuidraw/painter/attribute_data/filled_path.hpp>
+#include <fastuidraw/util/trace_events.hpp>
 #include <private/util_private.hpp>
 #include <private/bounding_box.hpp>
 #include <private/path_util_private.hpp>
@@ -711,6 +712,7 @@ TessellatedPath(const Path &input,
                 fastuidraw::TessellatedPath::TessellationParams TP,
                 reference_counted_ptr<Refiner> *ref)
 {
+  TraceEvents::Scope trace("TessellatedPath", "tessellate");
   TessellatedPathPrivate *d;
   m_d = d = FASTUIDRAWnew TessellatedPathPrivate(input.number_contours(), TP);
 
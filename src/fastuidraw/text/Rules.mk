@@ -10,6 +10,7 @@ FASTUIDRAW_SOURCES += $(call filelist, glyph_atlas.cpp \
 	glyph_render_data_restricted_rays.cpp \
 	glyph_render_data_banded_rays.cpp \
 	glyph_render_data_texels.cpp \
+	glyph_render_data_multi_channel_distance_field.cpp \
 	glyph_cache.cpp glyph.cpp \
 	freetype_face.cpp freetype_lib.cpp \
 	font_freetype.cpp font_properties.cpp \
@@ -36,6 +36,7 @@ namespace
 
     unsigned int m_distance_field_pixel_size;
     float m_distance_field_max_distance;
+    unsigned int m_multi_channel_distance_field_pixel_size;
     float m_restricted_rays_minimum_render_size;
     int m_restricted_rays_split_thresh;
     int m_restricted_rays_max_recursion;
@@ -50,6 +51,7 @@ namespace
     GlyphGenerateParamValues(void):
       m_distance_field_pixel_size(48),
       m_distance_field_max_distance(1.5f),
+      m_multi_channel_distance_field_pixel_size(24),
       m_restricted_rays_minimum_render_size(32.0f),
       m_restricted_rays_split_thresh(4),
       m_restricted_rays_max_recursion(12),
@@ -111,6 +113,7 @@ namespace
 
 IMPLEMENT(unsigned int, distance_field_pixel_size)
 IMPLEMENT(float, distance_field_max_distance)
+IMPLEMENT(unsigned int, multi_channel_distance_field_pixel_size)
 IMPLEMENT(float, restricted_rays_minimum_render_size)
 IMPLEMENT(int, restricted_rays_split_thresh)
 IMPLEMENT(int, restricted_rays_max_recursion)
@@ -20,6 +20,7 @@
 #include <fastuidraw/text/glyph_generate_params.hpp>
 #include <fastuidraw/text/glyph_render_data.hpp>
 #include <fastuidraw/text/glyph_render_data_texels.hpp>
+#include <fastuidraw/text/glyph_render_data_multi_channel_distance_field.hpp>
 #include <fastuidraw/text/glyph_render_data_restricted_rays.hpp>
 #include <fastuidraw/text/glyph_render_data_banded_rays.hpp>
 
@@ -70,11 +71,13 @@ namespace
   public:
     GenerateParams(void):
       m_distance_field_pixel_size(fastuidraw::GlyphGenerateParams::distance_field_pixel_size()),
-      m_distance_field_max_distance(fastuidraw::GlyphGenerateParams::distance_field_max_distance())
+      m_distance_field_max_distance(fastuidraw::GlyphGenerateParams::distance_field_max_distance()),
+      m_multi_channel_distance_field_pixel_size(fastuidraw::GlyphGenerateParams::multi_channel_distance_field_pixel_size())
     {}
 
     unsigned int m_distance_field_pixel_size;
     float m_distance_field_max_distance;
+    unsigned int m_multi_channel_distance_field_pixel_size;
   };
 
   class ComputeOutlineDegree
@@ -270,9 +273,11 @@ namespace
                                     fastuidraw::Path &path,
                                     fastuidraw::vec2 &render_size);
 
+    template<typename T>
     void
-    compute_rendering_data_distance_field(fastuidraw::GlyphMetrics glyph_metrics,
-                                          fastuidraw::GlyphRenderDataTexels &output,
+    compute_rendering_data_distance_field(unsigned int pixel_size,
+                                          fastuidraw::GlyphMetrics glyph_metrics,
+                                          T &output,
                                           fastuidraw::Path &path,
                                           fastuidraw::vec2 &render_size);
 
@@ -454,10 +459,12 @@ compute_rendering_data_coverage(int pixel_size,
     }
 }
 
+template<typename T>
 void
 FontFreeTypePrivate::
-compute_rendering_data_distance_field(fastuidraw::GlyphMetrics glyph_metrics,
-                                      fastuidraw::GlyphRenderDataTexels &output,
+compute_rendering_data_distance_field(unsigned int pixel_size,
+                                      fastuidraw::GlyphMetrics glyph_metrics,
+                                      T &output,
                                       fastuidraw::Path &path,
                                       fastuidraw::vec2 &render_size)
 {
@@ -488,9 +495,7 @@ compute_rendering_data_distance_field(fastuidraw::GlyphMetrics glyph_metrics,
     IntPathCreator::decompose_to_path(&face->glyph->outline, int_path_ecm, 1);
   }
 
-  /* TODO: adjust for the discretization to pixels */
   render_size = glyph_metrics.size();
-
   if (int_path_ecm.empty())
     {
       return;
@@ -508,7 +513,6 @@ compute_rendering_data_distance_field(fastuidraw::GlyphMetrics glyph_metrics,
     fastuidraw::PainterEnums::nonzero_fill_rule;
 
   /* compute the step value needed to create the distance field value*/
-  int pixel_size(m_generate_params.m_distance_field_pixel_size);
   float scale_factor(static_cast<float>(pixel_size) / static_cast<float>(units_per_EM));
 
   /* compute how many pixels we need to store the glyph. */
@@ -521,6 +525,13 @@ compute_rendering_data_distance_field(fastuidraw::GlyphMetrics glyph_metrics,
       return;
     }
 
+  /* the texels cover a region that is larger than the glyph
+   * because the image size is rounded up; the glyph is to be
+   * drawn at the size of that region so that each texel maps
+   * to the same region in the glyph as it was computed from.
+   */
+  render_size = fastuidraw::vec2(image_sz) / scale_factor;
+
   /* we translate by -layout_offset to make the points of
    * the IntPath match correctly with that of the texel
    * data (this also gaurantees that the box of the glyph
@@ -529,7 +540,7 @@ compute_rendering_data_distance_field(fastuidraw::GlyphMetrics glyph_metrics,
    * is then just 2 * units_per_EM.
    */
   int tr_scale(2 * pixel_size);
-  fastuidraw::ivec2 tr_translate(-2 * pixel_size * layout_offset);
+  fastuidraw::ivec2 tr_translate(-2 * static_cast<int>(pixel_size) * layout_offset);
   fastuidraw::detail::IntBezierCurve::transformation<int> tr(tr_scale, tr_translate);
   fastuidraw::ivec2 texel_distance(2 * units_per_EM);
   float max_distance = (m_generate_params.m_distance_field_max_distance)
@@ -725,7 +736,8 @@ can_create_rendering_data(enum glyph_type tp) const
   return tp == coverage_glyph
     || tp == distance_field_glyph
     || tp == restricted_rays_glyph
-    || tp == banded_rays_glyph;
+    || tp == banded_rays_glyph
+    || tp == multi_channel_distance_field_glyph;
 }
 
 unsigned int
@@ -787,7 +799,18 @@ compute_rendering_data(GlyphRenderer render, GlyphMetrics glyph_metrics,
       {
         GlyphRenderDataTexels *data;
         data = FASTUIDRAWnew GlyphRenderDataTexels();
-        d->compute_rendering_data_distance_field(glyph_metrics, *data, path, render_size);
+        d->compute_rendering_data_distance_field(d->m_generate_params.m_distance_field_pixel_size,
+                                                 glyph_metrics, *data, path, render_size);
+        return data;
+      }
+      break;
+
+    case multi_channel_distance_field_glyph:
+      {
+        GlyphRenderDataMultiChannelDistanceField *data;
+        data = FASTUIDRAWnew GlyphRenderDataMultiChannelDistanceField();
+        d->compute_rendering_data_distance_field(d->m_generate_params.m_multi_channel_distance_field_pixel_size,
+                                                 glyph_metrics, *data, path, render_size);
         return data;
       }
       break;
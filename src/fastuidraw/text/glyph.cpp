@@ -150,6 +150,36 @@ pack_raw(c_array<const GlyphAttribute> glyph_attributes,
     }
 }
 
+void
+fastuidraw::Glyph::
+repack_glyph_attributes(unsigned int attrib_loc,
+                        c_array<PainterAttribute> dst) const
+{
+  if (!valid())
+    {
+      /* pack_glyph() packed zeros which are still correct */
+      return;
+    }
+
+  c_array<const GlyphAttribute> glyph_attributes(attributes());
+
+  dst = dst.sub_array(attrib_loc, 4);
+  for (unsigned int corner_enum = 0; corner_enum < 4; ++corner_enum)
+    {
+      unsigned int srcI, dstI;
+
+      for (srcI = 0, dstI = 0; dstI < 4; ++dstI, ++srcI)
+        {
+          dst[corner_enum].m_attrib1[dstI] = pack_single_attribute(srcI, glyph_attributes, corner_enum);
+        }
+
+      for (dstI = 0; dstI < 4; ++dstI, ++srcI)
+        {
+          dst[corner_enum].m_attrib2[dstI] = pack_single_attribute(srcI, glyph_attributes, corner_enum);
+        }
+    }
+}
+
 void
 fastuidraw::Glyph::
 glyph_attribute_dst_write(int glyph_attribute_index,
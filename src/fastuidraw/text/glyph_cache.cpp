@@ -20,8 +20,10 @@
 #include <map>
 #include <vector>
 #include <mutex>
+#include <algorithm>
 #include <fastuidraw/text/glyph_cache.hpp>
 #include <fastuidraw/text/glyph_render_data.hpp>
+#include <fastuidraw/util/trace_events.hpp>
 #include <private/util_private.hpp>
 
 namespace
@@ -82,6 +84,14 @@ namespace
     clear(void)
     {}
 
+    /* see GlyphDataPrivate::retire() */
+    bool
+    retire(void)
+    {
+      clear();
+      return true;
+    }
+
     /* owner */
     GlyphCachePrivate *m_cache;
 
@@ -109,6 +119,17 @@ namespace
     void
     clear(void);
 
+    /* clear the glyph when it is removed from its Store;
+     * returns false if the glyph is pinned in which case
+     * the slot is marked as retired and is only put back
+     * on the free list of the Store once the last pin is
+     * released. This keeps a pin (or an unpin) from a Glyph
+     * value of the removed glyph from landing on a different
+     * glyph that would otherwise reuse the slot.
+     */
+    bool
+    retire(void);
+
     void
     remove_from_atlas(void);
 
@@ -117,9 +138,32 @@ namespace
                     fastuidraw::GlyphAtlasProxy &S,
                     fastuidraw::GlyphAttribute::Array &T);
 
+    /* to be called after the glyph is generated or taken
+     * by a GlyphCache, adds the estimate of the memory
+     * used on the host to the GlyphCache.
+     */
+    void
+    record_host_usage(void);
+
+    /* mark the glyph as used in the current frame of the cache */
+    void
+    touch(void);
+
     /* location into m_cache->m_glyphs  */
     unsigned int m_cache_location;
 
+    /* number of pins from GlyphCache::pin_glyphs() */
+    unsigned int m_pin_count;
+
+    /* true if the glyph was removed while pinned, see retire() */
+    bool m_retired;
+
+    /* last frame of the GlyphCache in which the glyph was used */
+    unsigned int m_last_frame;
+
+    /* estimate of the memory used on the host by the glyph */
+    unsigned int m_host_usage;
+
     fastuidraw::GlyphRenderer m_render;
     GlyphMetricsPrivate *m_metrics;
 
@@ -201,8 +245,7 @@ namespace
       iter = m_map.find(key);
       FASTUIDRAWassert(iter != m_map.end());
 
-      m_data[iter->second]->clear();
-      m_free_slots.push_back(iter->second);
+      retire_slot(iter->second);
       m_map.erase(iter);
     }
 
@@ -211,16 +254,34 @@ namespace
     {
       for (const auto &m : m_map)
         {
-          m_data[m.second]->clear();
-          m_free_slots.push_back(m.second);
           FASTUIDRAWassert(m.second == m_data[m.second]->m_cache_location);
+          retire_slot(m.second);
         }
       m_map.clear();
     }
 
+    /* put back on the free list a slot whose value
+     * refused to be retired by T::retire().
+     */
+    void
+    release_slot(unsigned int slot)
+    {
+      FASTUIDRAWassert(slot < m_data.size());
+      m_free_slots.push_back(slot);
+    }
+
   private:
     typedef std::map<K, unsigned int> map;
 
+    void
+    retire_slot(unsigned int slot)
+    {
+      if (m_data[slot]->retire())
+        {
+          m_free_slots.push_back(slot);
+        }
+    }
+
     map m_map;
     std::vector<T*> m_data;
     std::vector<unsigned int> m_free_slots;
@@ -306,11 +367,30 @@ namespace
      *  not have to regenerate data either.
      */
 
+    /* evict the least recently used glyphs not pinned and
+     * not used in the frame m_frame until the usage is
+     * within the budgets; m_glyphs_mutex must be locked.
+     */
+    void
+    evict_glyphs(void);
+
+    bool
+    over_budget(void) const
+    {
+      return (m_atlas_budget != 0u && m_atlas_usage > m_atlas_budget)
+        || (m_host_budget != 0u && m_host_usage > m_host_budget);
+    }
+
     std::mutex m_glyphs_mutex, m_glyphs_metrics_mutex;
     fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlas> m_atlas;
     Store<glyph_key, GlyphDataPrivate> m_glyphs;
     Store<glyph_metrics_key, GlyphMetricsPrivate> m_glyph_metrics;
     fastuidraw::GlyphCache *m_p;
+
+    /* budgets and usage, both protected by m_glyphs_mutex */
+    unsigned int m_atlas_budget, m_host_budget;
+    unsigned int m_atlas_usage, m_host_usage;
+    unsigned int m_frame;
   };
 }
 
@@ -320,6 +400,10 @@ GlyphDataPrivate::
 GlyphDataPrivate(GlyphCachePrivate *c, unsigned int I):
   GlyphAtlasProxyPrivate(c),
   m_cache_location(I),
+  m_pin_count(0),
+  m_retired(false),
+  m_last_frame(0),
+  m_host_usage(0),
   m_metrics(nullptr),
   m_uploaded_to_atlas(false),
   m_glyph_data(nullptr)
@@ -329,6 +413,10 @@ GlyphDataPrivate::
 GlyphDataPrivate(void):
   GlyphAtlasProxyPrivate(nullptr),
   m_cache_location(~0u),
+  m_pin_count(0),
+  m_retired(false),
+  m_last_frame(0),
+  m_host_usage(0),
   m_metrics(nullptr),
   m_uploaded_to_atlas(false),
   m_glyph_data(nullptr)
@@ -354,10 +442,55 @@ remove_from_atlas(void)
           m_cache->m_atlas->deallocate_data(g.m_location, g.m_size);
         }
       m_data_locations.clear();
+      FASTUIDRAWassert(m_cache->m_atlas_usage >= m_total_allocated);
+      m_cache->m_atlas_usage -= m_total_allocated;
     }
+  m_total_allocated = 0;
   m_uploaded_to_atlas = false;
 }
 
+void
+GlyphDataPrivate::
+record_host_usage(void)
+{
+  /* a rough estimate of the bytes for each interpolator of
+   * the Path which includes the data the Path generates
+   * lazily, such as its tessellation
+   */
+  const unsigned int bytes_per_interpolator(256u);
+
+  FASTUIDRAWassert(m_cache);
+  FASTUIDRAWassert(m_host_usage == 0u);
+
+  m_host_usage = sizeof(GlyphDataPrivate);
+  for (unsigned int c = 0, endc = m_path.number_contours(); c < endc; ++c)
+    {
+      m_host_usage += bytes_per_interpolator * m_path.contour(c)->number_interpolators();
+    }
+  m_cache->m_host_usage += m_host_usage;
+}
+
+void
+GlyphDataPrivate::
+touch(void)
+{
+  FASTUIDRAWassert(m_cache);
+  m_last_frame = m_cache->m_frame;
+}
+
+bool
+GlyphDataPrivate::
+retire(void)
+{
+  clear();
+  if (m_pin_count > 0u)
+    {
+      m_retired = true;
+      return false;
+    }
+  return true;
+}
+
 void
 GlyphDataPrivate::
 clear(void)
@@ -366,6 +499,13 @@ clear(void)
   FASTUIDRAWassert(!m_render.valid());
 
   remove_from_atlas();
+  if (m_cache)
+    {
+      FASTUIDRAWassert(m_cache->m_host_usage >= m_host_usage);
+      m_cache->m_host_usage -= m_host_usage;
+    }
+  m_host_usage = 0;
+
   if (m_glyph_data)
     {
       FASTUIDRAWdelete(m_glyph_data);
@@ -401,9 +541,18 @@ upload_to_atlas(fastuidraw::GlyphMetrics metrics,
   FASTUIDRAWassert(m_glyph_data);
   FASTUIDRAWassert(m_attributes.empty());
 
+  fastuidraw::TraceEvents::Scope trace("GlyphCache", "upload_glyph");
+
   if (!m_glyph_data)
     {
-      m_glyph_data = m_metrics->m_font->compute_rendering_data(m_render, metrics, m_path, m_render_size);
+      /* m_path and m_render_size were set when the glyph was
+       * generated; the generation appends to the path passed,
+       * so pass a scratch path to not add the contours again.
+       */
+      fastuidraw::Path path;
+      fastuidraw::vec2 render_size;
+
+      m_glyph_data = m_metrics->m_font->compute_rendering_data(m_render, metrics, path, render_size);
     }
 
   fastuidraw::c_array<const fastuidraw::c_string> render_cost_labels(m_glyph_data->render_info_labels());
@@ -439,7 +588,12 @@ GlyphCachePrivate::
 GlyphCachePrivate(fastuidraw::reference_counted_ptr<fastuidraw::GlyphAtlas> patlas,
                   fastuidraw::GlyphCache *p):
   m_atlas(patlas),
-  m_p(p)
+  m_p(p),
+  m_atlas_budget(0),
+  m_host_budget(0),
+  m_atlas_usage(0),
+  m_host_usage(0),
+  m_frame(0)
 {}
 
 GlyphCachePrivate::
@@ -457,6 +611,44 @@ GlyphCachePrivate::
     }
 }
 
+void
+GlyphCachePrivate::
+evict_glyphs(void)
+{
+  std::vector<GlyphDataPrivate*> candidates;
+
+  if (!over_budget())
+    {
+      return;
+    }
+
+  fastuidraw::TraceEvents::Scope trace("GlyphCache", "evict_glyphs");
+  for (GlyphDataPrivate *g : m_glyphs.data())
+    {
+      if (g->m_render.valid()
+          && g->m_pin_count == 0u
+          && g->m_last_frame != m_frame)
+        {
+          candidates.push_back(g);
+        }
+    }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const GlyphDataPrivate *a, const GlyphDataPrivate *b)
+            {
+              return a->m_last_frame < b->m_last_frame;
+            });
+
+  for (unsigned int i = 0, endi = candidates.size(); i < endi && over_budget(); ++i)
+    {
+      GlyphDataPrivate *g(candidates[i]);
+      glyph_key K(g->m_metrics->m_font.get(),
+                  g->m_metrics->m_glyph_code,
+                  g->m_render);
+      m_glyphs.remove_value(K);
+    }
+}
+
 //////////////////////////////////////////////
 // fastuidraw::GlyphAtlasProxy methods
 int
@@ -474,6 +666,7 @@ allocate_data(c_array<const generic_data> pdata)
       A.m_location = L;
       A.m_size = pdata.size();
       d->m_total_allocated += A.m_size;
+      d->m_cache->m_atlas_usage += A.m_size;
       d->m_data_locations.push_back(A);
     }
   return L;
@@ -623,6 +816,7 @@ upload_to_atlas(void) const
   std::lock_guard<std::mutex> m(p->m_cache->m_glyphs_mutex);
   GlyphAtlasProxy S(p);
   GlyphAttribute::Array T(&p->m_attributes);
+  p->touch();
   return p->upload_to_atlas(metrics(), S, T);
 }
 
@@ -870,6 +1064,7 @@ fetch_glyph(GlyphRenderer render, const FontBase *font,
   if (!q->m_render.valid())
     {
       GlyphMetrics m;
+      TraceEvents::Scope trace("GlyphCache", "generate_glyph");
 
       q->m_render = render;
       FASTUIDRAWassert(!q->m_glyph_data);
@@ -877,8 +1072,11 @@ fetch_glyph(GlyphRenderer render, const FontBase *font,
       q->m_metrics = static_cast<GlyphMetricsPrivate*>(m.m_d);
       q->m_glyph_data = font->compute_rendering_data(q->m_render, m,
                                                      q->m_path, q->m_render_size);
+      q->record_host_usage();
     }
 
+  q->touch();
+
   if (upload_to_atlas)
     {
       GlyphAtlasProxy S(q);
@@ -929,6 +1127,7 @@ fetch_glyphs(GlyphRenderer render,
   GlyphCachePrivate *d;
   d = static_cast<GlyphCachePrivate*>(m_d);
 
+  TraceEvents::Scope trace("GlyphCache", "fetch_glyphs");
   std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
   for(unsigned int i = 0; i < glyph_metrics.size(); ++i)
     {
@@ -943,14 +1142,18 @@ fetch_glyphs(GlyphRenderer render,
           if (!q->m_render.valid())
             {
               GlyphMetrics m(glyph_metrics[i]);
+              TraceEvents::Scope trace("GlyphCache", "generate_glyph");
 
               q->m_render = render;
               FASTUIDRAWassert(!q->m_glyph_data);
               q->m_metrics = static_cast<GlyphMetricsPrivate*>(m.m_d);
               q->m_glyph_data = src.m_font->compute_rendering_data(q->m_render, m,
                                                                    q->m_path, q->m_render_size);
+              q->record_host_usage();
             }
 
+          q->touch();
+
           if (upload_to_atlas)
             {
               GlyphAtlasProxy S(q);
@@ -967,6 +1170,48 @@ fetch_glyphs(GlyphRenderer render,
     }
 }
 
+enum fastuidraw::return_code
+fastuidraw::GlyphCache::
+upload_to_atlas(c_array<const Glyph> glyphs)
+{
+  GlyphCachePrivate *d;
+  enum return_code return_value(routine_success);
+
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  TraceEvents::Scope trace("GlyphCache", "upload_to_atlas");
+  std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
+  for (const Glyph &G : glyphs)
+    {
+      GlyphDataPrivate *g;
+
+      g = static_cast<GlyphDataPrivate*>(G.m_opaque);
+      if (!g)
+        {
+          continue;
+        }
+
+      if (g->m_cache != d || !g->m_render.valid())
+        {
+          return_value = routine_fail;
+          continue;
+        }
+
+      g->touch();
+      if (!g->m_uploaded_to_atlas)
+        {
+          GlyphAtlasProxy S(g);
+          GlyphAttribute::Array T(&g->m_attributes);
+
+          if (g->upload_to_atlas(GlyphMetrics(g->m_metrics), S, T) == routine_fail)
+            {
+              return_value = routine_fail;
+            }
+        }
+    }
+  return return_value;
+}
+
 enum fastuidraw::return_code
 fastuidraw::GlyphCache::
 add_glyph(Glyph glyph, bool upload_to_atlas)
@@ -991,6 +1236,7 @@ add_glyph(Glyph glyph, bool upload_to_atlas)
   if (g->m_cache)
     {
       /* already part of this cache, upload if necessary */
+      g->touch();
       if (upload_to_atlas)
         {
           GlyphAtlasProxy S(g);
@@ -1016,6 +1262,8 @@ add_glyph(Glyph glyph, bool upload_to_atlas)
     {
       return routine_fail;
     }
+  g->record_host_usage();
+  g->touch();
 
   if (upload_to_atlas)
     {
@@ -1054,6 +1302,7 @@ clear_atlas(void)
   GlyphCachePrivate *d;
   d = static_cast<GlyphCachePrivate*>(m_d);
 
+  TraceEvents::Scope trace("GlyphCache", "clear_atlas");
   d->m_atlas->clear();
   std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
   for(GlyphDataPrivate *g : d->m_glyphs.data())
@@ -1064,7 +1313,10 @@ clear_atlas(void)
        */
       g->m_uploaded_to_atlas = false;
       g->m_data_locations.clear();
+      g->m_attributes.clear();
+      g->m_total_allocated = 0;
     }
+  d->m_atlas_usage = 0;
 }
 
 void
@@ -1125,3 +1377,130 @@ deallocate_data(AllocationHandle h)
       d->m_atlas->deallocate_data(h.m_location, h.m_size);
     }
 }
+
+void
+fastuidraw::GlyphCache::
+atlas_budget(unsigned int v)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
+  d->m_atlas_budget = v;
+}
+
+unsigned int
+fastuidraw::GlyphCache::
+atlas_budget(void) const
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
+  return d->m_atlas_budget;
+}
+
+void
+fastuidraw::GlyphCache::
+host_budget(unsigned int v)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
+  d->m_host_budget = v;
+}
+
+unsigned int
+fastuidraw::GlyphCache::
+host_budget(void) const
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
+  return d->m_host_budget;
+}
+
+unsigned int
+fastuidraw::GlyphCache::
+atlas_usage(void) const
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
+  return d->m_atlas_usage;
+}
+
+unsigned int
+fastuidraw::GlyphCache::
+host_usage(void) const
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
+  return d->m_host_usage;
+}
+
+void
+fastuidraw::GlyphCache::
+begin_frame(void)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  /* evict before incrementing the frame so that the
+   * glyphs used in the frame that just ended are kept.
+   */
+  std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
+  d->evict_glyphs();
+  ++d->m_frame;
+}
+
+void
+fastuidraw::GlyphCache::
+pin_glyphs(c_array<const Glyph> glyphs)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
+  for (const Glyph &G : glyphs)
+    {
+      GlyphDataPrivate *g;
+
+      g = static_cast<GlyphDataPrivate*>(G.m_opaque);
+      if (g && g->m_cache == d)
+        {
+          ++g->m_pin_count;
+        }
+    }
+}
+
+void
+fastuidraw::GlyphCache::
+unpin_glyphs(c_array<const Glyph> glyphs)
+{
+  GlyphCachePrivate *d;
+  d = static_cast<GlyphCachePrivate*>(m_d);
+
+  std::lock_guard<std::mutex> m(d->m_glyphs_mutex);
+  for (const Glyph &G : glyphs)
+    {
+      GlyphDataPrivate *g;
+
+      g = static_cast<GlyphDataPrivate*>(G.m_opaque);
+      if (g && g->m_cache == d)
+        {
+          FASTUIDRAWassert(g->m_pin_count > 0u);
+          --g->m_pin_count;
+          if (g->m_pin_count == 0u && g->m_retired)
+            {
+              g->m_retired = false;
+              d->m_glyphs.release_slot(g->m_cache_location);
+            }
+        }
+    }
+}
@@ -0,0 +1,148 @@
+/*!
+ * \file glyph_render_data_multi_channel_distance_field.cpp
+ * \brief file glyph_render_data_multi_channel_distance_field.cpp
+ *
+ * Copyright 2019 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+
+#include <vector>
+#include <fastuidraw/text/glyph_render_data_multi_channel_distance_field.hpp>
+#include <private/util_private.hpp>
+
+namespace
+{
+  class GlyphDataPrivate
+  {
+  public:
+    GlyphDataPrivate(void):
+      m_resolution(0, 0)
+    {}
+
+    void
+    resize(fastuidraw::ivec2 sz)
+    {
+      FASTUIDRAWassert(sz.x() >= 0);
+      FASTUIDRAWassert(sz.y() >= 0);
+      m_texels.resize(sz.x() * sz.y());
+      m_resolution = sz;
+    }
+
+    fastuidraw::ivec2 m_resolution;
+    std::vector<fastuidraw::u8vec3> m_texels;
+  };
+}
+
+///////////////////////////////////////////////////////////
+// fastuidraw::GlyphRenderDataMultiChannelDistanceField methods
+fastuidraw::GlyphRenderDataMultiChannelDistanceField::
+GlyphRenderDataMultiChannelDistanceField(void)
+{
+  m_d = FASTUIDRAWnew GlyphDataPrivate();
+}
+
+fastuidraw::GlyphRenderDataMultiChannelDistanceField::
+~GlyphRenderDataMultiChannelDistanceField(void)
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+  FASTUIDRAWdelete(d);
+  m_d = nullptr;
+}
+
+fastuidraw::ivec2
+fastuidraw::GlyphRenderDataMultiChannelDistanceField::
+resolution(void) const
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+  return d->m_resolution;
+}
+
+fastuidraw::c_array<const fastuidraw::u8vec3>
+fastuidraw::GlyphRenderDataMultiChannelDistanceField::
+texel_data(void) const
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+  return make_c_array(d->m_texels);
+}
+
+fastuidraw::c_array<fastuidraw::u8vec3>
+fastuidraw::GlyphRenderDataMultiChannelDistanceField::
+texel_data(void)
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+  return make_c_array(d->m_texels);
+}
+
+void
+fastuidraw::GlyphRenderDataMultiChannelDistanceField::
+resize(fastuidraw::ivec2 sz)
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+  d->resize(sz);
+}
+
+fastuidraw::c_array<const fastuidraw::c_string>
+fastuidraw::GlyphRenderDataMultiChannelDistanceField::
+render_info_labels(void) const
+{
+  return c_array<const c_string>();
+}
+
+enum fastuidraw::return_code
+fastuidraw::GlyphRenderDataMultiChannelDistanceField::
+upload_to_atlas(GlyphAtlasProxy &atlas_proxy,
+                GlyphAttribute::Array &attributes,
+                c_array<float> /* render_costs */) const
+{
+  GlyphDataPrivate *d;
+  d = static_cast<GlyphDataPrivate*>(m_d);
+
+  attributes.resize(2);
+  attributes[0].pack_texel_rect(d->m_resolution.x(),
+                                d->m_resolution.y());
+
+  if (d->m_texels.empty())
+    {
+      attributes[1].m_data = vecN<uint32_t, 4>(0u);
+      return routine_success;
+    }
+
+  /* one 32-bit value per texel so that a texel is read
+   * with a single fetch from the GlyphAtlas
+   */
+  std::vector<generic_data> data(d->m_texels.size());
+  int location;
+
+  for (unsigned int i = 0, endi = d->m_texels.size(); i < endi; ++i)
+    {
+      const u8vec3 &t(d->m_texels[i]);
+      data[i].u = pack_bits(0u, 8u, t[0])
+        | pack_bits(8u, 8u, t[1])
+        | pack_bits(16u, 8u, t[2]);
+    }
+
+  location = atlas_proxy.allocate_data(make_c_array(data));
+  if (location == -1)
+    {
+      return routine_fail;
+    }
+  attributes[1].m_data = vecN<uint32_t, 4>(location);
+
+  return routine_success;
+}
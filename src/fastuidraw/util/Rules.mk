@@ -8,7 +8,8 @@ FASTUIDRAW_SOURCES += $(call filelist, static_resource.cpp \
 	fastuidraw_memory.cpp util.cpp \
 	reference_count_atomic.cpp \
 	pixel_distance_math.cpp data_buffer.cpp api_callback.cpp \
-	string_array.cpp mutex.cpp blend_mode.cpp)
+	string_array.cpp mutex.cpp blend_mode.cpp \
+	trace_events.cpp)
 
 # Begin standard footer
 d		:= $(dirstack_$(sp))
@@ -0,0 +1,358 @@
+/*!
+ * \file trace_events.cpp
+ * \brief file trace_events.cpp
+ *
+ * Copyright 2018 by Intel.
+ *
+ * Contact: kevin.rogovin@intel.com
+ *
+ * This Source Code Form is subject to the
+ * terms of the Mozilla Public License, v. 2.0.
+ * If a copy of the MPL was not distributed with
+ * this file, You can obtain one at
+ * http://mozilla.org/MPL/2.0/.
+ *
+ * \author Kevin Rogovin <kevin.rogovin@intel.com>
+ *
+ */
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <iomanip>
+
+#include <fastuidraw/util/trace_events.hpp>
+#include <fastuidraw/util/fastuidraw_memory.hpp>
+
+namespace
+{
+  /* An event slot of a ring buffer; m_seq works as a
+   * sequence lock so that a reader on another thread can
+   * detect that the slot was (over)written while it read it:
+   * it is odd while the slot is written and 2 * (I + 1) once
+   * the I'th event of the thread is written to the slot.
+   * The payload fields are atomics as well, accessed with
+   * relaxed loads and stores, so that a reader racing with
+   * the writer reads possibly torn values (which it then
+   * discards) instead of having a data race.
+   */
+  class Event:fastuidraw::noncopyable
+  {
+  public:
+    Event(void):
+      m_seq(0u),
+      m_category(nullptr),
+      m_name(nullptr),
+      m_start(0u),
+      m_duration(0u)
+    {}
+
+    std::atomic<uint64_t> m_seq;
+    std::atomic<fastuidraw::c_string> m_category, m_name;
+    std::atomic<uint64_t> m_start, m_duration;
+  };
+
+  class ThreadBuffer:fastuidraw::noncopyable
+  {
+  public:
+    explicit
+    ThreadBuffer(unsigned int tid):
+      m_events(fastuidraw::TraceEvents::events_per_thread),
+      m_head(0u),
+      m_in_use(true),
+      m_tid(tid)
+    {}
+
+    /* only called from the thread that owns the buffer */
+    void
+    add(fastuidraw::c_string category, fastuidraw::c_string name,
+        uint64_t start, uint64_t duration);
+
+    /* may be called from any thread */
+    template<typename F>
+    void
+    for_each(const F &f) const;
+
+    std::vector<Event> m_events;
+    std::atomic<uint64_t> m_head;
+    std::atomic<bool> m_in_use;
+    unsigned int m_tid;
+  };
+
+  class TraceEventsPrivate:fastuidraw::noncopyable
+  {
+  public:
+    TraceEventsPrivate(void):
+      m_enabled(false),
+      m_epoch(std::chrono::steady_clock::now())
+    {}
+
+    ~TraceEventsPrivate()
+    {
+      for (ThreadBuffer *p : m_buffers)
+        {
+          FASTUIDRAWdelete(p);
+        }
+    }
+
+    uint64_t
+    now(void) const
+    {
+      std::chrono::steady_clock::duration d;
+
+      d = std::chrono::steady_clock::now() - m_epoch;
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    }
+
+    ThreadBuffer*
+    acquire_buffer(void);
+
+    std::atomic<bool> m_enabled;
+    std::chrono::steady_clock::time_point m_epoch;
+    std::mutex m_mutex;
+    std::vector<ThreadBuffer*> m_buffers;
+  };
+
+  /* A thread gets a ThreadBuffer the first time it records an
+   * event; when the thread exits, the buffer is marked as free
+   * for another thread to take so that the recorded events of
+   * the exited thread are still available to write.
+   */
+  class ThreadHandle:fastuidraw::noncopyable
+  {
+  public:
+    ThreadHandle(void):
+      m_buffer(nullptr)
+    {}
+
+    ~ThreadHandle()
+    {
+      if (m_buffer)
+        {
+          m_buffer->m_in_use.store(false, std::memory_order_release);
+        }
+    }
+
+    ThreadBuffer*
+    buffer(void);
+
+  private:
+    ThreadBuffer *m_buffer;
+  };
+
+  TraceEventsPrivate&
+  trace_events(void)
+  {
+    static TraceEventsPrivate R;
+    return R;
+  }
+
+  thread_local ThreadHandle this_thread_handle;
+
+  void
+  write_json_string(std::ostream &dst, fastuidraw::c_string str)
+  {
+    dst << '"';
+    for (; str && *str; ++str)
+      {
+        if (*str == '"' || *str == '\\')
+          {
+            dst << '\\' << *str;
+          }
+        else if (static_cast<unsigned char>(*str) >= 0x20)
+          {
+            dst << *str;
+          }
+      }
+    dst << '"';
+  }
+}
+
+////////////////////////////////
+// ThreadBuffer methods
+void
+ThreadBuffer::
+add(fastuidraw::c_string category, fastuidraw::c_string name,
+    uint64_t start, uint64_t duration)
+{
+  uint64_t idx;
+
+  idx = m_head.load(std::memory_order_relaxed);
+  Event &e(m_events[idx % m_events.size()]);
+
+  e.m_seq.store(2u * idx + 1u, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  e.m_category.store(category, std::memory_order_relaxed);
+  e.m_name.store(name, std::memory_order_relaxed);
+  e.m_start.store(start, std::memory_order_relaxed);
+  e.m_duration.store(duration, std::memory_order_relaxed);
+  e.m_seq.store(2u * idx + 2u, std::memory_order_release);
+  m_head.store(idx + 1u, std::memory_order_release);
+}
+
+template<typename F>
+void
+ThreadBuffer::
+for_each(const F &f) const
+{
+  uint64_t head, begin;
+
+  head = m_head.load(std::memory_order_acquire);
+  begin = (head > m_events.size()) ? head - m_events.size() : 0u;
+  for (uint64_t idx = begin; idx < head; ++idx)
+    {
+      const Event &e(m_events[idx % m_events.size()]);
+      fastuidraw::c_string category, name;
+      uint64_t seq, start, duration;
+
+      seq = e.m_seq.load(std::memory_order_acquire);
+      if (seq != 2u * idx + 2u)
+        {
+          continue;
+        }
+
+      category = e.m_category.load(std::memory_order_relaxed);
+      name = e.m_name.load(std::memory_order_relaxed);
+      start = e.m_start.load(std::memory_order_relaxed);
+      duration = e.m_duration.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (e.m_seq.load(std::memory_order_relaxed) != seq)
+        {
+          continue;
+        }
+
+      f(category, name, start, duration);
+    }
+}
+
+////////////////////////////////
+// TraceEventsPrivate methods
+ThreadBuffer*
+TraceEventsPrivate::
+acquire_buffer(void)
+{
+  std::lock_guard<std::mutex> M(m_mutex);
+  for (ThreadBuffer *p : m_buffers)
+    {
+      bool expected(false);
+      if (p->m_in_use.compare_exchange_strong(expected, true))
+        {
+          return p;
+        }
+    }
+
+  ThreadBuffer *p;
+  p = FASTUIDRAWnew ThreadBuffer(m_buffers.size());
+  m_buffers.push_back(p);
+  return p;
+}
+
+////////////////////////////////
+// ThreadHandle methods
+ThreadBuffer*
+ThreadHandle::
+buffer(void)
+{
+  if (!m_buffer)
+    {
+      m_buffer = trace_events().acquire_buffer();
+    }
+  return m_buffer;
+}
+
+////////////////////////////////////////
+// fastuidraw::TraceEvents::Scope methods
+fastuidraw::TraceEvents::Scope::
+Scope(c_string category, c_string name):
+  m_category(category),
+  m_name(name),
+  m_start(0u),
+  m_active(trace_events().m_enabled.load(std::memory_order_relaxed))
+{
+  if (m_active)
+    {
+      m_start = trace_events().now();
+    }
+}
+
+fastuidraw::TraceEvents::Scope::
+~Scope()
+{
+  if (m_active)
+    {
+      uint64_t end;
+
+      end = trace_events().now();
+      this_thread_handle.buffer()->add(m_category, m_name, m_start, end - m_start);
+    }
+}
+
+////////////////////////////////////////
+// fastuidraw::TraceEvents methods
+void
+fastuidraw::TraceEvents::
+enabled(bool v)
+{
+  trace_events().m_enabled.store(v, std::memory_order_relaxed);
+}
+
+bool
+fastuidraw::TraceEvents::
+enabled(void)
+{
+  return trace_events().m_enabled.load(std::memory_order_relaxed);
+}
+
+void
+fastuidraw::TraceEvents::
+clear(void)
+{
+  TraceEventsPrivate &d(trace_events());
+  std::lock_guard<std::mutex> M(d.m_mutex);
+
+  for (ThreadBuffer *p : d.m_buffers)
+    {
+      p->m_head.store(0u, std::memory_order_release);
+      for (Event &e : p->m_events)
+        {
+          e.m_seq.store(0u, std::memory_order_relaxed);
+        }
+    }
+}
+
+void
+fastuidraw::TraceEvents::
+write_chrome_trace(std::ostream &dst)
+{
+  TraceEventsPrivate &d(trace_events());
+  std::lock_guard<std::mutex> M(d.m_mutex);
+  std::ios_base::fmtflags old_flags(dst.flags());
+  std::streamsize old_precision(dst.precision());
+  bool first(true);
+
+  dst << std::fixed << std::setprecision(3)
+      << "{\"traceEvents\":[";
+  for (const ThreadBuffer *p : d.m_buffers)
+    {
+      unsigned int tid(p->m_tid);
+      p->for_each([&](c_string category, c_string name,
+                      uint64_t start, uint64_t duration)
+                  {
+                    /* Chrome trace timestamps are in microseconds */
+                    dst << (first ? "\n" : ",\n") << "{\"name\":";
+                    write_json_string(dst, name);
+                    dst << ",\"cat\":";
+                    write_json_string(dst, category);
+                    dst << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                        << ",\"ts\":" << static_cast<double>(start) / 1000.0
+                        << ",\"dur\":" << static_cast<double>(duration) / 1000.0
+                        << "}";
+                    first = false;
+                  });
+    }
+  dst << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  dst.flags(old_flags);
+  dst.precision(old_precision);
+}